@@ -23,11 +23,15 @@
 file(GLOB donut_core_src
     include/donut/core/chunk/*.h
     include/donut/core/math/*.h
+    include/donut/core/vfs/Compression.h
+    include/donut/core/vfs/IOScheduler.h
     include/donut/core/vfs/TarFile.h
     include/donut/core/vfs/VFS.h
     include/donut/core/*.h
     src/core/chunk/*.cpp
     src/core/math/*.cpp
+    src/core/vfs/Compression.cpp
+    src/core/vfs/IOScheduler.cpp
     src/core/vfs/TarFile.cpp
     src/core/vfs/VFS.cpp
     src/core/*.cpp
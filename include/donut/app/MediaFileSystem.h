@@ -40,7 +40,8 @@ namespace donut::app
 	//   * on creation, the MediaFileSystem scans the media directory for all
 	//     package files at the media directory root (in parent file system), and,
 	//     where possible, opens them with an appropriate virtual file system 
-	//     (ex. vfs::TarFile)
+	//     (ex. vfs::TarFile for .tar files, vfs::CompressionLayer over vfs::TarFile
+	//     for .pkz files made by the donut_pack tool)
 	//
 	//   * all file paths relative to the MediaFileSystem are resolved uniquely
 	//     in the following order:
@@ -69,6 +70,9 @@ namespace donut::app
 		bool folderExists(const std::filesystem::path& name) override;
 		bool fileExists(const std::filesystem::path& name) override;
 		std::shared_ptr<vfs::IBlob> readFile(const std::filesystem::path& name) override;
+		std::shared_ptr<vfs::IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+		bool getFileLocation(const std::filesystem::path& name, vfs::FileLocation& location) override;
+		bool getFileAttributes(const std::filesystem::path& name, vfs::FileAttributes& attributes) override;
 		bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
 		int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, vfs::enumerate_callback_t callback, bool allowDuplicates = false) override;
 		int enumerateDirectories(const std::filesystem::path& path, vfs::enumerate_callback_t callback, bool allowDuplicates = false) override;
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "simd.h"
+
+namespace donut::math
+{
+
+    // Axis-aligned boxes stored as a structure of arrays, which is the input of the batch culling functions.
+    struct box3_array
+    {
+        std::vector<float> minX, minY, minZ;
+        std::vector<float> maxX, maxY, maxZ;
+
+        size_t size() const { return minX.size(); }
+        bool empty() const { return minX.empty(); }
+
+        void clear();
+        void reserve(size_t count);
+
+        void push_back(const box3& box);
+
+        // Adds the world space bounds of an object space box, same as (localBox * transform).
+        void push_back(const box3& localBox, const affine3& transform);
+
+        box3 get(size_t index) const;
+        void set(size_t index, const box3& box);
+    };
+
+    // Returns the fastest instruction set supported by the CPU.
+    simd_level getBestCullingSimdLevel();
+
+    // Selects the instruction set used by the batch culling functions, for example to compare the results
+    // with the scalar code. Levels that are not supported by the CPU are replaced with the best supported one.
+    void setCullingSimdLevel(simd_level level);
+    simd_level getCullingSimdLevel();
+
+    // Tests the boxes against the frustum, with the same results as calling frustum::intersectsWith for each box.
+    // Writes the indices of the visible boxes into 'visibleIndices', which must have space for all boxes,
+    // and returns the number of visible boxes.
+    size_t cullBoxes(const frustum& f, const box3_array& boxes, uint32_t* visibleIndices);
+
+    // Tests the boxes against the frustum and writes one bit per box into 'visibilityMask', set if the box is visible.
+    // The mask must have space for (boxes.size() + 63) / 64 words. Unused bits of the last word are cleared.
+    void cullBoxesMask(const frustum& f, const box3_array& boxes, uint64_t* visibilityMask);
+
+    // Tests the boxes against up to 64 frustums and writes a mask of the frustums that each box intersects with
+    // into 'frustumMasks', which must have space for all boxes.
+    void cullBoxesMultiFrustum(const frustum* frustums, uint32_t numFrustums, const box3_array& boxes, uint64_t* frustumMasks);
+
+}
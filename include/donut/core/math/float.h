@@ -22,9 +22,11 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <limits>
 #include "vector.h"
+#include "simd.h"
 
 namespace donut::math
 {
@@ -130,6 +132,24 @@ namespace donut::math
     float8e5m2_t4 Float32ToFloat8E5M2x4(float4 x);
     float Float8E5M2ToFloat32(float8e5m2_t x);
     float4 Float8E5M2ToFloat32x4(float8e5m2_t4 x);
+
+    // Bulk conversions of 'count' values, with the same results as calling the scalar functions above for each value.
+    // The FP16 conversions use F16C when it's enabled, see EnableF16C, and SIMD integer code otherwise.
+    // The FP8 to FP32 conversions use a lookup table. The source and destination arrays must not overlap.
+    void Float32ToFloat16(const float* src, float16_t* dst, size_t count);
+    void Float16ToFloat32(const float16_t* src, float* dst, size_t count);
+    void Float32ToFloat8E4M3(const float* src, float8e4m3_t* dst, size_t count);
+    void Float8E4M3ToFloat32(const float8e4m3_t* src, float* dst, size_t count);
+    void Float32ToFloat8E5M2(const float* src, float8e5m2_t* dst, size_t count);
+    void Float8E5M2ToFloat32(const float8e5m2_t* src, float* dst, size_t count);
+
+    // Returns the fastest instruction set that the bulk conversions can use on this CPU.
+    simd_level GetBestFloatConversionSimdLevel();
+
+    // Selects the instruction set used by the bulk conversions, for example to compare the results
+    // with the scalar code. Levels that are not supported by the CPU are replaced with the best supported one.
+    void SetFloatConversionSimdLevel(simd_level level);
+    simd_level GetFloatConversionSimdLevel();
 }
 
 namespace std
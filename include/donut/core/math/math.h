@@ -34,4 +34,6 @@ namespace dm = donut::math;
 #include "quat.h"
 #include "sphere.h"
 #include "frustum.h"
+#include "simd.h"
+#include "culling.h"
 #include "float.h"
@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace donut::math
+{
+    // Instruction sets that the batch math functions can use, see culling.h and float.h.
+    enum class simd_level : uint8_t
+    {
+        scalar,
+        sse,    // SSE2, x64 only
+        avx2,   // x64 only, selected at runtime if the CPU supports it
+        neon,   // ARM64 only
+        avx512  // AVX-512F, x64 only, selected at runtime if the CPU supports it
+    };
+
+    // Runtime CPU feature detection for the x64 kernels, including the check that the OS saves the wider registers.
+    // AVX2 support also requires F16C, which every AVX2 CPU has. Both return false on other architectures.
+    bool isAVX2Supported();
+    bool isAVX512Supported();
+}
+
+// Enables AVX2 or AVX-512 code generation for a single function, for kernels that are selected at runtime
+// with isAVX2Supported or isAVX512Supported. MSVC compiles these intrinsics without any flags.
+#ifdef _MSC_VER
+    #define DONUT_TARGET_AVX2
+    #define DONUT_TARGET_AVX512
+#else
+    #define DONUT_TARGET_AVX2 __attribute__((target("avx2,f16c")))
+    #define DONUT_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
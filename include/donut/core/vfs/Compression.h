@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/core/vfs/VFS.h>
+#include <cstdint>
+#include <functional>
+
+namespace donut::vfs
+{
+    /*
+    Block compression used for packaged assets.
+
+    A compressed file starts with a CompressedFileHeader, followed by a table with the compressed size of every block,
+    followed by the block data. Each block holds up to 'blockSize' bytes of the original file and is compressed
+    independently with an LZ4 compatible block codec, so large files can be decompressed on multiple threads.
+    Blocks that don't shrink are stored as-is, which is marked with the high bit of the block size.
+    */
+    namespace compression
+    {
+        constexpr uint32_t FileSignature = 0x315a4244; // 'DBZ1'
+        constexpr uint32_t CodecLZ4 = 1;
+        constexpr uint32_t StoredBlockFlag = 0x80000000u;
+        constexpr uint32_t DefaultBlockSize = 256 * 1024;
+        constexpr uint32_t MaxBlockSize = 16 * 1024 * 1024;
+
+        struct CompressedFileHeader
+        {
+            uint32_t signature;
+            uint32_t codec;
+            uint64_t uncompressedSize;
+            uint32_t blockSize;
+            uint32_t numBlocks;
+        };
+
+        // Runs func(index) for every index in [0, count) and returns when all calls have completed, e.g. as tasks
+        // of the application's thread pool. Used to process the blocks of large files in parallel.
+        typedef std::function<void(uint32_t count, const std::function<void(uint32_t index)>& func)> parallel_for_t;
+
+        // Returns the worst case size of a compressed block with 'size' input bytes.
+        [[nodiscard]] size_t compressBlockBound(size_t size);
+
+        // Compresses one block into 'dst'. Returns the compressed size, or 0 if it doesn't fit into 'dstCapacity' bytes.
+        size_t compressBlock(const void* src, size_t srcSize, void* dst, size_t dstCapacity);
+
+        // Decompresses one block that must expand to exactly 'dstSize' bytes.
+        // Returns false if the block data is malformed.
+        bool decompressBlock(const void* src, size_t srcSize, void* dst, size_t dstSize);
+
+        // Compresses a whole file into the format described above, using up to 'maxThreads' threads
+        // (0 means one thread per hardware core). Returns an empty vector if the blockSize is invalid.
+        std::vector<uint8_t> compressFile(const void* data, size_t size, uint32_t blockSize = DefaultBlockSize, uint32_t maxThreads = 0);
+
+        // Same as above, with the blocks distributed by 'parallelFor' instead of new threads.
+        // If 'parallelFor' is empty, the file is compressed on the calling thread.
+        std::vector<uint8_t> compressFile(const void* data, size_t size, uint32_t blockSize, const parallel_for_t& parallelFor);
+
+        // Tests if the data starts with a valid compressed file header.
+        [[nodiscard]] bool isCompressedFile(const void* data, size_t size);
+
+        // Decompresses a file produced by compressFile, using up to 'maxThreads' threads for large files,
+        // or the 'parallelFor' executor. Returns nullptr if the data is not a valid compressed file.
+        std::shared_ptr<IBlob> decompressFile(const void* data, size_t size, uint32_t maxThreads = 0);
+        std::shared_ptr<IBlob> decompressFile(const void* data, size_t size, const parallel_for_t& parallelFor);
+
+        // Decompresses the part of a file that starts at 'offset' and is 'rangeSize' bytes long, or shorter if the range
+        // extends past the end of the file. Only the blocks overlapping the range are decompressed.
+        // Returns nullptr if the data is not a valid compressed file or 'offset' is past the end of the file.
+        std::shared_ptr<IBlob> decompressFileRange(const void* data, size_t size, uint64_t offset, size_t rangeSize, uint32_t maxThreads = 0);
+        std::shared_ptr<IBlob> decompressFileRange(const void* data, size_t size, uint64_t offset, size_t rangeSize, const parallel_for_t& parallelFor);
+    }
+
+    // A layer that transparently decompresses files stored in the compression::CompressedFileHeader format
+    // and passes other files through unchanged. Typically used on top of a TarFile with compressed entries,
+    // which is what the donut_pack tool produces. Files written through the layer are compressed
+    // if that makes them smaller.
+    class CompressionLayer : public IFileSystem
+    {
+    private:
+        std::shared_ptr<IFileSystem> m_UnderlyingFS;
+        compression::parallel_for_t m_ParallelFor;
+
+    public:
+        // Large files are decompressed and compressed in parallel with 'parallelFor', e.g. on the application's
+        // thread pool. Without it, files are processed on the calling thread, which is usually a loader thread
+        // that shouldn't start more threads on its own.
+        CompressionLayer(std::shared_ptr<IFileSystem> fs, compression::parallel_for_t parallelFor = nullptr);
+
+        [[nodiscard]] std::shared_ptr<IFileSystem> const& GetUnderlyingFS() const { return m_UnderlyingFS; }
+
+        bool folderExists(const std::filesystem::path& name) override;
+        bool fileExists(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+        bool getFileLocation(const std::filesystem::path& name, FileLocation& location) override;
+        bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
+        int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates = false) override;
+        int enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates = false) override;
+    };
+}
@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/core/vfs/VFS.h>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace donut::vfs
+{
+    enum class IOPriority : uint8_t
+    {
+        High = 0,
+        Normal,
+        Low,
+
+        Count
+    };
+
+    struct IORequest
+    {
+        // Pass as the request size to read until the end of the file.
+        static constexpr size_t WholeFile = SIZE_MAX;
+
+        std::shared_ptr<IFileSystem> fs;
+        std::filesystem::path name;
+        uint64_t offset = 0;
+        size_t size = WholeFile;
+        IOPriority priority = IOPriority::Normal;
+
+        // Optional function that is called on the IO thread with the result of the read, or nullptr if it failed
+        // or threw, before the future returned by IOScheduler::submit becomes ready. If the callback throws,
+        // the exception is stored in the future.
+        std::function<void(std::shared_ptr<IBlob> const&)> callback;
+    };
+
+    /*
+    Performs file reads on dedicated IO threads, so that the threads that decode the data don't block on IO.
+
+    Requests are served in priority order. Each IO thread takes a batch of up to 'maxBatchSize' requests
+    with the same priority and reads them in storage order, as reported by IFileSystem::getFileLocation,
+    so that files in one archive are read front to back and ranges of one file are read in increasing order.
+    When requests with a higher priority arrive, the rest of the batch is put back into the queue.
+    Requests with the same priority are batched in submission order, and lower priority requests wait
+    for as long as there are higher priority ones.
+    */
+    class IOScheduler
+    {
+    public:
+        IOScheduler(uint32_t numThreads = 1, uint32_t maxBatchSize = 64);
+
+        // Pending requests that haven't started yet are completed with nullptr results.
+        ~IOScheduler();
+
+        // Queues a read of the entire file or a range of it, see IFileSystem::readFileRange.
+        // The future receives the data, or nullptr if the file cannot be read.
+        std::future<std::shared_ptr<IBlob>> submit(IORequest request);
+
+        // Blocks until all submitted requests are completed.
+        void waitForIdle();
+
+        [[nodiscard]] size_t getNumPendingRequests() const;
+
+        IOScheduler(const IOScheduler&) = delete;
+        IOScheduler& operator=(const IOScheduler&) = delete;
+
+    private:
+        struct PendingRequest
+        {
+            IORequest request;
+            std::promise<std::shared_ptr<IBlob>> promise;
+        };
+
+        std::vector<std::thread> m_Threads;
+        std::deque<PendingRequest> m_Queues[size_t(IOPriority::Count)];
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_Idle;
+        uint32_t m_MaxBatchSize;
+        size_t m_NumPending = 0;
+        size_t m_NumActive = 0;
+        bool m_Terminate = false;
+
+        void threadProc();
+        bool hasHigherPriorityRequests(IOPriority priority) const;
+        static void complete(PendingRequest& pending);
+    };
+}
@@ -34,11 +34,15 @@ namespace donut::vfs
     The archive is partially read to enumerate the files when TarFile is created.
     TarFile can only operate on real files, i.e. underlying virtual file systems are not supported.
     Designed to work in combination with CompressionLayer to store packaged assets.
+    The archive is mapped into memory, and readFile returns MappedBlob objects that reference the archive data
+    without copying it, so reads from multiple threads don't block each other. If the archive cannot be mapped,
+    the files are read with regular file I/O, one at a time.
     */
     class TarFile : public IFileSystem
     {
     private:
         std::string m_ArchivePath;
+        std::shared_ptr<MappedFile> m_ArchiveMapping;
         std::mutex m_Mutex;
         FILE* m_ArchiveFile = nullptr;
 
@@ -50,6 +54,8 @@ namespace donut::vfs
 
         std::unordered_map<std::string, FileEntry> m_Files;
         std::unordered_set<std::string> m_Directories;
+
+        std::shared_ptr<IBlob> readArchiveRange(const std::string& name, size_t offset, size_t size);
         
     public:
         TarFile(const std::filesystem::path& archivePath);
@@ -60,6 +66,8 @@ namespace donut::vfs
         bool folderExists(const std::filesystem::path& name) override;
         bool fileExists(const std::filesystem::path& name) override;
         std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+        bool getFileLocation(const std::filesystem::path& name, FileLocation& location) override;
         bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
         int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates = false) override;
         int enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates = false) override;
@@ -27,6 +27,7 @@
 #include <filesystem>
 #include <functional>
 #include <vector>
+#include <cstdint>
 
 /* 
 Donut Virtual File System (VFS) main classes.
@@ -83,6 +84,86 @@ namespace donut::vfs
         [[nodiscard]] size_t size() const override;
     };
 
+    // A file, or a range of a file, mapped into memory, read-only as far as the file is concerned.
+    // The pages are mapped copy-on-write, so code that modifies the blob data in place doesn't change the file.
+    // The file should not be truncated or overwritten while it is mapped.
+    class MappedFile
+    {
+    private:
+        void* m_data = nullptr;
+        size_t m_size = 0;
+        // The mapping starts at a page boundary at or before m_data
+        void* m_mappedData = nullptr;
+        size_t m_mappedSize = 0;
+
+        MappedFile() = default;
+
+    public:
+        ~MappedFile();
+
+        // Maps the file into memory.
+        // Returns nullptr if the file cannot be opened or mapped, for example if it's empty or not a regular file.
+        static std::shared_ptr<MappedFile> open(const std::filesystem::path& name);
+
+        // Maps the pages of the file that contain the range of 'size' bytes starting at 'offset', with the range
+        // clamped to the end of the file. data() points to the first byte of the range.
+        // Returns nullptr if the file cannot be mapped or if the range is empty.
+        static std::shared_ptr<MappedFile> open(const std::filesystem::path& name, uint64_t offset, size_t size);
+
+        [[nodiscard]] const void* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+    };
+
+    // Blob implementation that references a range of a mapped file without copying the data.
+    // The file stays mapped until all blobs referencing it are deleted.
+    class MappedBlob : public IBlob
+    {
+    private:
+        std::shared_ptr<MappedFile> m_file;
+        const void* m_data;
+        size_t m_size;
+
+    public:
+        MappedBlob(std::shared_ptr<MappedFile> file, size_t offset, size_t size);
+        [[nodiscard]] const void* data() const override;
+        [[nodiscard]] size_t size() const override;
+    };
+
+    // Blob implementation that references a range of another blob without copying the data.
+    class BlobView : public IBlob
+    {
+    private:
+        std::shared_ptr<IBlob> m_parent;
+        const void* m_data;
+        size_t m_size;
+
+    public:
+        BlobView(std::shared_ptr<IBlob> parent, size_t offset, size_t size);
+        [[nodiscard]] const void* data() const override;
+        [[nodiscard]] size_t size() const override;
+    };
+
+    // Where a file is physically stored, used to order IO requests. Files in the same container,
+    // such as an archive, can be read front to back by sorting the requests by offset.
+    // Files with a null container are stored individually and only ordered by offset within the file.
+    struct FileLocation
+    {
+        const void* container = nullptr;
+        uint64_t offset = 0;
+    };
+
+    // Size and last modification time of a file, used to detect changes without reading the file.
+    // The modification time is an opaque value that is only meaningful when compared with another value
+    // obtained from the same file system.
+    struct FileAttributes
+    {
+        uint64_t size = 0;
+        uint64_t modificationTime = 0;
+    };
+
     // Basic interface for the virtual file system.
     class IFileSystem
     {
@@ -99,6 +180,19 @@ namespace donut::vfs
         // Returns nullptr if the file cannot be read.
         virtual std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) = 0;
 
+        // Read 'size' bytes of the file starting at 'offset', or fewer if the range extends past the end of the file.
+        // Returns nullptr if the file cannot be read or if 'offset' is past the end of the file.
+        // The default implementation reads the entire file and returns a view of the requested range.
+        virtual std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size);
+
+        // Find where the file is stored, to schedule reads in storage order.
+        // Returns false if the file doesn't exist or its location is unknown.
+        virtual bool getFileLocation(const std::filesystem::path& name, FileLocation& location);
+
+        // Query the size and modification time of the file.
+        // Returns false if the file doesn't exist or its attributes are unknown.
+        virtual bool getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes);
+
         // Write the entire file.
         // Returns false if the file cannot be written.
         virtual bool writeFile(const std::filesystem::path& name, const void* data, size_t size) = 0;
@@ -116,12 +210,16 @@ namespace donut::vfs
     };
 
     // An implementation of virtual file system that directly maps to the OS files.
+    // Files larger than a few pages are returned as MappedBlob objects, smaller files are read into memory.
     class NativeFileSystem : public IFileSystem
     {
     public:
 		bool folderExists(const std::filesystem::path& name) override;
         bool fileExists(const std::filesystem::path& name) override;
         std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+        bool getFileLocation(const std::filesystem::path& name, FileLocation& location) override;
+        bool getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes) override;
         bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
         int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates = false) override;
         int enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates = false) override;
@@ -143,6 +241,9 @@ namespace donut::vfs
         bool folderExists(const std::filesystem::path& name) override;
         bool fileExists(const std::filesystem::path& name) override;
         std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+        bool getFileLocation(const std::filesystem::path& name, FileLocation& location) override;
+        bool getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes) override;
         bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
         int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates = false) override;
         int enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates = false) override;
@@ -164,6 +265,9 @@ namespace donut::vfs
 		bool folderExists(const std::filesystem::path& name) override;
         bool fileExists(const std::filesystem::path& name) override;
         std::shared_ptr<IBlob> readFile(const std::filesystem::path& name) override;
+        std::shared_ptr<IBlob> readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size) override;
+        bool getFileLocation(const std::filesystem::path& name, FileLocation& location) override;
+        bool getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes) override;
         bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override;
         int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates = false) override;
         int enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates = false) override;
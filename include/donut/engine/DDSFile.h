@@ -38,6 +38,14 @@ namespace donut::engine
     // Initialized the TextureInfo from the 'data' array, which must be populated with DDS data
     bool LoadDDSTextureFromMemory(TextureData& textureInfo);
 
+    // The largest size of the DDS headers, i.e. the magic number, DDS_HEADER and DDS_HEADER_DXT10.
+    constexpr size_t DDSMaxHeaderSize = 4 + 124 + 20;
+
+    // Initializes the TextureInfo from the DDS headers only, without the texture data. The 'headerData' should
+    // contain the first DDSMaxHeaderSize bytes of the file, or the whole file if it's smaller.
+    // The offsets in textureInfo.dataLayout are relative to the start of the file and are not validated.
+    bool LoadDDSTextureHeader(TextureData& textureInfo, const void* headerData, size_t headerSize);
+
     // Creates a texture based on DDS data in memory
     nvrhi::TextureHandle CreateDDSTextureFromMemory(nvrhi::IDevice* device, nvrhi::ICommandList* commandList, std::shared_ptr<vfs::IBlob> data, const char* debugName = nullptr, bool forceSRGB = false);
 
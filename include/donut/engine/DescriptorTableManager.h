@@ -107,6 +107,10 @@ namespace donut::engine
         DescriptorIndex CreateDescriptor(nvrhi::BindingSetItem item);
         DescriptorHandle CreateDescriptorHandle(nvrhi::BindingSetItem item);
         nvrhi::BindingSetItem GetDescriptor(DescriptorIndex index);
+
+        // Points an allocated descriptor to a different resource, keeping its index. Used when a resource is
+        // recreated, for example with a different number of mip levels, while shaders keep referencing the index.
+        void ReplaceDescriptor(DescriptorIndex index, nvrhi::BindingSetItem item);
         void ReleaseDescriptor(DescriptorIndex index);
     };
 }
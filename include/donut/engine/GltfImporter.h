@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <donut/engine/MeshletBuilder.h>
+#include <donut/engine/MeshOptimizer.h>
 #include <memory>
 #include <filesystem>
 
@@ -49,15 +51,30 @@ namespace donut::engine
     protected:
         std::shared_ptr<vfs::IFileSystem> m_fs;
         std::shared_ptr<SceneTypeFactory> m_SceneTypeFactory;
+        bool m_OptimizeMeshes = false;
+        MeshOptimizationParams m_MeshOptimizationParams;
+        bool m_BuildMeshlets = false;
+        MeshletBuildParams m_MeshletParams;
         
     public:
         explicit GltfImporter(std::shared_ptr<vfs::IFileSystem> fs, std::shared_ptr<SceneTypeFactory> sceneTypeFactory);
         
+        // Loads a glTF model. If a thread pool is provided, the textures are loaded asynchronously,
+        // and the vertex and index data of the meshes is converted in parallel on the pool.
+        // The time spent in the mesh import phases is added to the stats.
         bool Load(
             const std::filesystem::path& fileName,
             TextureCache& textureCache,
             SceneLoadingStats& stats,
             ThreadPool* threadPool,
             SceneImportResult& result) const;
+
+        // Enables reordering the indices and vertices of the imported meshes for the vertex cache and vertex fetch,
+        // and optionally merging duplicate vertices, see OptimizeMeshes. The ACMR and ATVR before and after are logged.
+        void SetOptimizeMeshes(bool enable, const MeshOptimizationParams& params = MeshOptimizationParams());
+
+        // Enables building the meshlets of the triangle geometries after the vertex and index data is imported.
+        // The meshlets are stored in the buffer groups, see BufferGroup::meshletData.
+        void SetBuildMeshlets(bool enable, const MeshletBuildParams& params = MeshletBuildParams());
     };
 }
@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/core/math/math.h>
+#include <cstdint>
+#include <vector>
+
+namespace donut::engine
+{
+    // A dynamic bounding volume hierarchy over a set of boxes, such as the world space bounds of the mesh instances
+    // in a scene, for culling independently of the scene graph hierarchy.
+    // Each leaf is identified by its index, which is the position of its box in the array passed to Build.
+    // The tree stores enlarged ("fat") leaf boxes, so that objects moving by small amounts don't require any changes.
+    // Leaves that move out of their fat boxes are either reinserted, or, when many leaves move at once, the whole tree
+    // is refitted. The tree is rebuilt from scratch when refitting has degraded its quality too much.
+    class InstanceBVH
+    {
+    public:
+        struct Settings
+        {
+            // Leaf boxes are enlarged by this fraction of their size on each side.
+            float fatMargin = 0.1f;
+
+            // If more than this fraction of the leaves moves out of their fat boxes in one Commit,
+            // the tree is refitted instead of reinserting the leaves one by one.
+            float refitFraction = 0.05f;
+
+            // The tree is rebuilt when its cost, see ComputeCost, exceeds the cost after the last rebuild
+            // multiplied by this factor.
+            float rebuildCostRatio = 1.5f;
+        };
+
+        struct Stats
+        {
+            uint32_t leaves = 0;
+            uint32_t nodes = 0;
+            uint32_t rebuilds = 0;
+            uint32_t refits = 0;
+            uint32_t reinsertions = 0;
+            float cost = 0.f;
+        };
+
+        struct QueryStats
+        {
+            uint32_t nodesVisited = 0;
+            uint32_t leavesTested = 0;
+            uint32_t leavesVisible = 0;
+        };
+
+    private:
+        struct Node
+        {
+            dm::box3 bounds = dm::box3::empty();
+            int parent = -1;
+            int children[2] = { -1, -1 };
+            int leaf = -1; // leaf index for leaf nodes, -1 for internal nodes
+        };
+
+        Settings m_Settings;
+        std::vector<Node> m_Nodes;
+        std::vector<int> m_FreeNodes;
+        int m_Root = -1;
+
+        std::vector<dm::box3> m_LeafBounds; // exact bounds of each leaf
+        std::vector<int> m_LeafNodes; // node index of each leaf, -1 if the leaf is empty and not in the tree
+        std::vector<uint32_t> m_PendingLeaves;
+        std::vector<bool> m_LeafPending;
+
+        float m_BuildCost = 0.f;
+        uint32_t m_ReinsertionsSinceCheck = 0;
+        uint32_t m_Rebuilds = 0;
+        uint32_t m_Refits = 0;
+        uint32_t m_Reinsertions = 0;
+
+        [[nodiscard]] dm::box3 GetFatBounds(const dm::box3& bounds) const;
+        int AllocateNode();
+        void FreeNode(int node);
+        void InsertLeafNode(int node);
+        void RemoveLeafNode(int node);
+        int BuildSubtree(uint32_t* leaves, size_t count, int parent);
+        void Refit();
+        void Rebuild();
+
+    public:
+        void SetSettings(const Settings& settings) { m_Settings = settings; }
+        [[nodiscard]] const Settings& GetSettings() const { return m_Settings; }
+
+        // Replaces the contents of the tree with one leaf per box. Empty boxes make leaves that are never visible.
+        void Build(const std::vector<dm::box3>& leafBounds);
+
+        void Clear();
+
+        // Sets new bounds for a leaf. The tree is updated by the next call to Commit.
+        void UpdateLeaf(uint32_t leafIndex, const dm::box3& bounds);
+
+        // Updates the tree after UpdateLeaf calls, see the class description.
+        void Commit();
+
+        // Appends the indices of the leaves intersecting the frustum to 'visibleLeaves', in no particular order.
+        // Fat boxes are only used to skip subtrees: the result is the same as testing every leaf's exact bounds.
+        void Query(const dm::frustum& frustum, std::vector<uint32_t>& visibleLeaves, QueryStats* stats = nullptr) const;
+
+        [[nodiscard]] uint32_t GetNumLeaves() const { return uint32_t(m_LeafBounds.size()); }
+        [[nodiscard]] const dm::box3& GetLeafBounds(uint32_t leafIndex) const { return m_LeafBounds[leafIndex]; }
+
+        // Returns the sum of the surface areas of the internal nodes relative to the area of the root,
+        // which is proportional to the expected number of nodes visited by a query.
+        [[nodiscard]] float ComputeCost() const;
+
+        [[nodiscard]] Stats GetStats() const;
+
+        // Checks that the node links are consistent and that every node contains its children.
+        [[nodiscard]] bool Validate() const;
+    };
+}
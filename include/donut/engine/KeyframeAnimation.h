@@ -57,20 +57,130 @@ namespace donut::engine::animation
         const Keyframe& a, const Keyframe& b,
         const Keyframe& c, const Keyframe& d, float t, float dt);
 
+    // Playback state of a sampler: the keyframe segment found by the last evaluation.
+    // When the time moves forward by small steps, the next evaluation finds its segment in constant time.
+    struct SamplerCursor
+    {
+        size_t segment = 0;
+    };
+
+    // Settings for Sampler::Compress.
+    struct CompressionSettings
+    {
+        // Largest allowed difference between the values of the original and the compressed sampler,
+        // per vector component. Quaternions of slerp samplers are compared up to their sign.
+        float maxError = 1e-3f;
+
+        // Removes the keyframes that the remaining ones interpolate within the error bound.
+        // Only applies to the step, linear and slerp modes: the spline shapes depend on all keyframes.
+        bool reduceKeyframes = true;
+
+        // Stores the values and tangents as 16-bit integers relative to their range in the sampler,
+        // and the unit quaternions of slerp samplers as their three smallest components.
+        bool quantize = true;
+
+        // Largest distance of the keyframe times from a uniform grid, relative to the grid step,
+        // for the times to be stored implicitly as a start time and a step.
+        float uniformTimeTolerance = 1e-4f;
+    };
+
+    // Memory and accuracy of one compressed sampler, or the sum over several samplers.
+    // The sizes only include the keyframe data. The errors are measured at the original keyframe times
+    // and halfway between them.
+    struct CompressionReport
+    {
+        uint32_t samplers = 0;
+        uint32_t uniformSamplers = 0;
+        uint32_t quantizedSamplers = 0;
+        uint64_t originalKeyframes = 0;
+        uint64_t compressedKeyframes = 0;
+        uint64_t originalBytes = 0;
+        uint64_t compressedBytes = 0;
+        float maxError = 0.f;
+        double errorSum = 0.0;
+        uint64_t errorSamples = 0;
+
+        [[nodiscard]] float GetMeanError() const { return errorSamples ? float(errorSum / double(errorSamples)) : 0.f; }
+        CompressionReport& operator+=(const CompressionReport& other);
+    };
+
+    // Keyframes of a sampler in the form created by Sampler::Compress.
+    // The keyframe values are stored with 'components' vector components, the remaining components are zero.
+    // Hermite samplers store the in and out tangents after the value of each keyframe.
+    struct CompressedKeyframes
+    {
+        enum class Encoding : uint8_t
+        {
+            Float,          // 32-bit floats
+            Quantized,      // 16-bit integers q, decoded as (offset + q * scale) per component
+            SmallestThree   // unit quaternions: the three smallest components as 15-bit integers,
+                            // the index of the largest component and the sign of the quaternion
+        };
+
+        Encoding encoding = Encoding::Float;
+        uint32_t count = 0;
+        uint32_t components = 0;
+        bool tangents = false;
+
+        // The keyframe times are either uniform, (startTime + index * timeStep), or listed in 'times'
+        float startTime = 0.f;
+        float timeStep = 0.f;
+        std::vector<float> times;
+
+        dm::float4 valueOffset = 0.f;
+        dm::float4 valueScale = 0.f;
+        dm::float4 tangentOffset = 0.f;
+        dm::float4 tangentScale = 0.f;
+
+        std::vector<uint16_t> quantized;
+        std::vector<float> floats;
+
+        [[nodiscard]] bool IsUniform() const { return times.empty(); }
+        [[nodiscard]] float GetTime(size_t index) const { return IsUniform() ? startTime + float(index) * timeStep : times[index]; }
+        [[nodiscard]] size_t GetStride() const;
+        [[nodiscard]] size_t GetSizeInBytes() const;
+        void Decode(size_t index, Keyframe& keyframe) const;
+    };
+
     class Sampler
     {
     protected:
         std::vector<Keyframe> m_Keyframes;
+        CompressedKeyframes m_Compressed;
         InterpolationMode m_Mode = InterpolationMode::Step;
 
+        // Returns the index of the keyframe (b) such that (b.time <= time < c.time), starting the search at 'hint'.
+        // The time must be inside the keyframe range.
+        [[nodiscard]] size_t FindSegment(float time, size_t hint) const;
+
+        // Evaluate for compressed keyframes, decodes the keyframes around the time only.
+        std::optional<dm::float4> EvaluateCompressed(const CompressedKeyframes& track, float time,
+            bool extrapolateLastValues, SamplerCursor& cursor) const;
+
+        friend class SamplerBatch;
+
     public:
         Sampler() = default;
         virtual ~Sampler() = default;
 
         std::optional<dm::float4> Evaluate(float time, bool extrapolateLastValues = false) const;
 
-        [[nodiscard]] std::vector<Keyframe>& GetKeyframes() { return m_Keyframes; }
+        // Same as Evaluate above, but starts the keyframe search at the cursor and updates it.
+        std::optional<dm::float4> Evaluate(float time, bool extrapolateLastValues, SamplerCursor& cursor) const;
+
+        // Accessing or adding the keyframes of a compressed sampler decompresses it.
+        [[nodiscard]] std::vector<Keyframe>& GetKeyframes();
         void AddKeyframe(const Keyframe keyframe);
+        [[nodiscard]] size_t GetNumKeyframes() const { return IsCompressed() ? m_Compressed.count : m_Keyframes.size(); }
+
+        // Replaces the keyframes with a compressed representation that Evaluate decodes on the fly.
+        // Tries the keyframe reduction, quantization and implicit times enabled in the settings, and falls back
+        // to the less compressed representations until the measured error is within settings.maxError.
+        // Compressing an empty or already compressed sampler has no effect and returns an empty report.
+        CompressionReport Compress(const CompressionSettings& settings = CompressionSettings());
+        void Decompress();
+        [[nodiscard]] bool IsCompressed() const { return m_Compressed.count != 0; }
+        [[nodiscard]] const CompressedKeyframes& GetCompressedKeyframes() const { return m_Compressed; }
 
         [[nodiscard]] InterpolationMode GetMode() const { return m_Mode; }
         void SetInterpolationMode(InterpolationMode mode) { m_Mode = mode; }
@@ -81,6 +191,61 @@ namespace donut::engine::animation
         void Load(Json::Value& node);
     };
 
+    // Evaluates many samplers at the same time, for example all channels of an animation, with the same results
+    // as Sampler::Evaluate. Each sampler keeps a cursor, so playing the animation forward doesn't search the keyframes.
+    // The keyframes around the time are gathered into structure-of-arrays buffers per interpolation mode,
+    // and the interpolation runs over these buffers in loops that the compiler can vectorize.
+    // Compressed samplers are evaluated one at a time, with their cursors.
+    class SamplerBatch
+    {
+    public:
+        // Keyframe data of the samplers that use one interpolation mode, one lane per sampler.
+        // The arrays are allocated for all samplers of the batch, and the first 'count' lanes are used.
+        // The spline modes also use the outer keyframes 'a' and 'd', the Hermite mode stores the tangents there:
+        // the outgoing tangent of b in 'a', and the incoming tangent of c in 'd'.
+        struct Lanes
+        {
+            size_t count = 0;
+            std::vector<uint32_t> samplers;
+            std::vector<float> t;
+            std::vector<float> dt;
+            std::vector<float> a[4], b[4], c[4], d[4];
+            std::vector<float> result[4];
+            std::vector<float> wa, wb; // Slerp weights
+
+            void Resize(size_t capacity);
+            void Add(uint32_t sampler, const dm::float4& kb, const dm::float4& kc, float t, float dt);
+            void Add(uint32_t sampler, const dm::float4& ka, const dm::float4& kb, const dm::float4& kc,
+                const dm::float4& kd, float t, float dt);
+            [[nodiscard]] size_t Size() const { return count; }
+        };
+
+    private:
+        std::vector<std::shared_ptr<Sampler>> m_Samplers;
+        std::vector<SamplerCursor> m_Cursors;
+        std::vector<dm::float4> m_Values;
+        std::vector<uint8_t> m_HasValue;
+        Lanes m_Linear;
+        Lanes m_Slerp;
+        Lanes m_CatmullRom;
+        Lanes m_Hermite;
+
+    public:
+        // Adds a sampler and returns the index of its value.
+        size_t AddSampler(std::shared_ptr<Sampler> sampler);
+        void Clear();
+
+        [[nodiscard]] size_t GetNumSamplers() const { return m_Samplers.size(); }
+        [[nodiscard]] const std::shared_ptr<Sampler>& GetSampler(size_t index) const { return m_Samplers[index]; }
+
+        // Evaluates all samplers at the specified time.
+        void Evaluate(float time, bool extrapolateLastValues = false);
+
+        // Results of the last Evaluate call.
+        [[nodiscard]] bool HasValue(size_t index) const { return m_HasValue[index] != 0; }
+        [[nodiscard]] const dm::float4& GetValue(size_t index) const { return m_Values[index]; }
+    };
+
     class Sequence
     {
     protected:
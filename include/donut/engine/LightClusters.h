@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <donut/core/math/math.h>
+#include <cstdint>
+#include <vector>
+
+namespace donut::engine
+{
+    class Light;
+
+    // The volume of influence of a point or spot light, used for binning lights into clusters.
+    struct ClusterLight
+    {
+        dm::float3 position = 0.f;
+        float range = 0.f;              // radius of the sphere of influence
+        dm::float3 direction = 0.f;     // normalized, spot lights only
+        float cosOuterAngle = -1.f;     // cosine of the outer cone angle of spot lights, -1 for point lights
+        float sinOuterAngle = 0.f;
+
+        // Fills the volume of a point or spot light with a finite range. Returns false for other lights,
+        // which affect the entire view and cannot be binned.
+        static bool FromLight(const Light& light, ClusterLight& result);
+    };
+
+    // A froxel grid that bins lights into clusters of the view frustum, for clustered shading.
+    // The view is divided into tiles on screen and into slices along the view depth, with the slice
+    // boundaries spaced exponentially between nearZ and farZ; the first slice extends to the camera.
+    // Each light is tested against the view space bounding boxes of the clusters that its bounding box
+    // projects to, and spot lights are also tested against the bounding spheres of the clusters.
+    // The result is a compact list of light indices and an (offset, count) range into the list for each cluster,
+    // with the indices of each cluster in increasing order.
+    // The last slice also covers the surfaces beyond farZ, and the lights that reach past farZ are added to all
+    // clusters of the last slice that they project to, so farZ should be close to the view distance to keep
+    // the culling in that slice effective.
+    //
+    // Usage: Setup with the view matrices, then BinLights, then read the ranges and indices.
+    class LightClusterGrid
+    {
+    public:
+        struct Desc
+        {
+            uint32_t tilesX = 16;
+            uint32_t tilesY = 8;
+            uint32_t slices = 24;
+            float nearZ = 0.5f;     // view depth where the exponential slicing starts
+            float farZ = 500.f;     // view depth of the end of the last slice
+
+            bool operator==(const Desc& other) const;
+            bool operator!=(const Desc& other) const { return !(*this == other); }
+        };
+
+    private:
+        Desc m_Desc;
+        dm::affine3 m_WorldToView = dm::affine3::identity();
+        dm::float4x4 m_ViewToClip = dm::float4x4::identity();
+        bool m_IsSetup = false;
+
+        // Cluster bounds in view space, padded to a multiple of 4 for the SIMD tests
+        std::vector<float> m_MinX, m_MinY, m_MinZ;
+        std::vector<float> m_MaxX, m_MaxY, m_MaxZ;
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ, m_Radius;
+        std::vector<float> m_SliceDepths; // slices + 1 boundaries
+
+        std::vector<uint32_t> m_HitClusters;
+        std::vector<uint32_t> m_HitLights;
+        std::vector<dm::uint2> m_ClusterRanges;
+        std::vector<uint32_t> m_LightIndices;
+
+        void BuildClusterBounds();
+        void BinLight(const ClusterLight& light, uint32_t lightIndex);
+
+    public:
+        // Prepares the cluster bounds for a view. 'viewToClip' must be a D3D style projection with a [0, 1] or
+        // [1, 0] depth range, such as IView::GetProjectionMatrix. The bounds are only rebuilt when the projection
+        // or the description changes.
+        void Setup(const dm::affine3& worldToView, const dm::float4x4& viewToClip, const Desc& desc);
+
+        // Bins the lights, which are in world space, replacing the result of the previous call.
+        void BinLights(const ClusterLight* lights, uint32_t numLights);
+
+        [[nodiscard]] const Desc& GetDesc() const { return m_Desc; }
+        [[nodiscard]] uint32_t GetNumClusters() const { return m_Desc.tilesX * m_Desc.tilesY * m_Desc.slices; }
+        [[nodiscard]] uint32_t GetClusterIndex(uint32_t tileX, uint32_t tileY, uint32_t slice) const
+            { return (slice * m_Desc.tilesY + tileY) * m_Desc.tilesX + tileX; }
+
+        // Returns the slice that contains a view space depth, matching the shader function GetLightClusterIndex.
+        [[nodiscard]] uint32_t GetSliceIndex(float viewDepth) const;
+
+        // Returns the scale and bias that map log2(viewDepth) to the slice index.
+        [[nodiscard]] dm::float2 GetSliceScaleBias() const;
+
+        [[nodiscard]] dm::box3 GetClusterBounds(uint32_t clusterIndex) const;
+
+        // Returns (offset, count) into the light index list for each cluster.
+        [[nodiscard]] const std::vector<dm::uint2>& GetClusterRanges() const { return m_ClusterRanges; }
+        [[nodiscard]] const std::vector<uint32_t>& GetLightIndices() const { return m_LightIndices; }
+    };
+}
@@ -51,9 +51,16 @@ namespace donut::engine
     class MaterialBindingCache
     {
     private:
+        struct CachedBindingSet
+        {
+            nvrhi::BindingSetHandle bindingSet;
+            // Sum of the generations of the textures in the binding set, see LoadedTexture::generation
+            uint64_t textureGeneration = 0;
+        };
+
         nvrhi::DeviceHandle m_Device;
         nvrhi::BindingLayoutHandle m_BindingLayout;
-        std::unordered_map<const Material*, nvrhi::BindingSetHandle> m_BindingSets;
+        std::unordered_map<const Material*, CachedBindingSet> m_BindingSets;
         std::vector<MaterialResourceBinding> m_BindingDesc;
         nvrhi::TextureHandle m_FallbackTexture;
         nvrhi::SamplerHandle m_Sampler;
@@ -62,6 +69,7 @@ namespace donut::engine
 
         nvrhi::BindingSetHandle CreateMaterialBindingSet(const Material* material);
         nvrhi::BindingSetItem GetTextureBindingSetItem(uint32_t slot, const std::shared_ptr<LoadedTexture>& texture) const;
+        uint64_t GetTextureGeneration(const Material* material) const;
 
     public:
         MaterialBindingCache(
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/engine/SceneTypes.h>
+#include <memory>
+#include <vector>
+
+namespace donut::engine
+{
+    class ThreadPool;
+
+    // Post-transform vertex cache efficiency of an index buffer, simulated with a FIFO cache.
+    struct VertexCacheStatistics
+    {
+        uint64_t triangles = 0;
+        uint64_t vertices = 0;      // number of distinct vertices referenced by the triangles
+        uint64_t transforms = 0;    // number of cache misses, i.e. vertex shader invocations
+
+        // Average cache miss ratio: transforms per triangle. Approaches 0.5 for well ordered regular meshes, 3 is the worst case.
+        [[nodiscard]] float GetACMR() const { return triangles ? float(transforms) / float(triangles) : 0.f; }
+        // Average transform to vertex ratio: transforms per vertex. 1 is optimal.
+        [[nodiscard]] float GetATVR() const { return vertices ? float(transforms) / float(vertices) : 0.f; }
+
+        VertexCacheStatistics& operator+=(const VertexCacheStatistics& other)
+        {
+            triangles += other.triangles;
+            vertices += other.vertices;
+            transforms += other.transforms;
+            return *this;
+        }
+    };
+
+    struct MeshOptimizationParams
+    {
+        // Reorders the triangles of each geometry for the post-transform vertex cache, see OptimizeVertexCache.
+        bool optimizeVertexCache = true;
+        // Reorders the vertices of each geometry in the order of their first use, see OptimizeVertexFetch.
+        // Vertices that are not used by any triangle are removed.
+        bool optimizeVertexFetch = true;
+        // Merges the vertices of a geometry that are identical in all vertex streams, including morph targets.
+        bool deduplicateVertices = false;
+        // Size of the FIFO cache used for the statistics.
+        uint32_t statisticsCacheSize = 16;
+    };
+
+    struct MeshOptimizationResult
+    {
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+    };
+
+    // Simulates a FIFO post-transform cache of 'cacheSize' vertices over a triangle list.
+    [[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(
+        const uint32_t* indices,
+        size_t numIndices,
+        size_t numVertices,
+        uint32_t cacheSize = 16);
+
+    // Reorders the triangles of a triangle list to improve the post-transform vertex cache hit rate,
+    // using Forsyth's linear-speed algorithm with an LRU cache model. The winding of the triangles is preserved.
+    // 'destination' may be the same array as 'indices'.
+    void OptimizeVertexCache(
+        uint32_t* destination,
+        const uint32_t* indices,
+        size_t numIndices,
+        size_t numVertices);
+
+    // Renumbers the vertices of a triangle list in the order of their first use, so that the vertex fetches
+    // walk through the vertex buffer mostly linearly. Rewrites 'indices' and stores the old index of every new
+    // vertex in 'vertexOrder'. Unused vertices are dropped. Returns the number of vertices that remain.
+    uint32_t OptimizeVertexFetch(
+        uint32_t* indices,
+        size_t numIndices,
+        size_t numVertices,
+        std::vector<uint32_t>& vertexOrder);
+
+    // Optimizes the index and vertex order of the triangle geometries of the meshes, and compacts the vertex streams
+    // of their buffer groups, which stay consistent: positions, normals, tangents, texture coordinates, joints, weights,
+    // curve radii, morph targets and meshlets are all remapped. The vertex ranges of curve geometries are kept as they are.
+    // All meshes that use the buffer groups of the given meshes must be included, and the function must run
+    // before skinned instances are created from the meshes. Meshes of skinned instances are skipped.
+    // If a thread pool is provided, the geometries are processed in parallel.
+    MeshOptimizationResult OptimizeMeshes(
+        const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+        const MeshOptimizationParams& params,
+        ThreadPool* threadPool = nullptr);
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <filesystem>
+
+namespace donut::vfs
+{
+    class IBlob;
+    class IFileSystem;
+}
+
+namespace donut::chunk
+{
+    struct MeshSetBase;
+}
+
+namespace donut::engine
+{
+    struct SceneImportResult;
+    class SceneTypeFactory;
+
+    // Loads and stores models in the donut::chunk mesh set format, see chunk::MeshSet and chunk::MeshletSet.
+    // Mesh sets only contain geometry: the vertex streams, the node hierarchy and the mesh instances.
+    // Every chunk::MeshInfo becomes a MeshInfo with a single geometry, and one default Material is created
+    // per material id, named after the material name in the file. Textures are not referenced.
+    //
+    // Meshlet sets store the meshlets of each geometry instead of an index buffer, and the index buffer is
+    // rebuilt from the meshlets on load. The meshlet headers in the file are Meshlet structures whose vertex offsets
+    // point into the indices32 stream and whose primitive offsets count triangles in the indices8 stream;
+    // the indices32 entries are absolute vertex indices.
+    class MeshSetImporter
+    {
+    protected:
+        std::shared_ptr<vfs::IFileSystem> m_fs;
+        std::shared_ptr<SceneTypeFactory> m_SceneTypeFactory;
+
+    public:
+        MeshSetImporter(std::shared_ptr<vfs::IFileSystem> fs, std::shared_ptr<SceneTypeFactory> sceneTypeFactory);
+
+        // Reads a mesh set file and builds the meshes and the node hierarchy from it.
+        bool Load(const std::filesystem::path& fileName, SceneImportResult& result) const;
+
+        // Builds the meshes and the node hierarchy from a deserialized mesh set.
+        bool LoadMeshSet(const chunk::MeshSetBase& meshSet, SceneImportResult& result) const;
+
+        // Serializes the triangle meshes and the node hierarchy of a model. Skinned instances and curves are skipped.
+        // Produces a chunk::MeshletSet if every serialized geometry has meshlets, or a chunk::MeshSet otherwise.
+        // Returns nullptr if the model has no mesh instances to serialize.
+        [[nodiscard]] static std::shared_ptr<vfs::IBlob const> Serialize(const SceneImportResult& result);
+
+        // Serializes a model and writes it into a file.
+        bool Store(const std::filesystem::path& fileName, const SceneImportResult& result) const;
+    };
+}
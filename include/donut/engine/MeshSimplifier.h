@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/engine/SceneTypes.h>
+#include <memory>
+#include <vector>
+
+namespace donut::engine
+{
+    class ThreadPool;
+
+    struct MeshLodParams
+    {
+        // Number of levels including the full detail one, so at most numLods - 1 entries in MeshInfo::lods.
+        uint32_t numLods = 4;
+        // Target triangle count of each level relative to the previous one.
+        float reductionRatio = 0.5f;
+        // Largest error of a level, relative to the diagonal of the mesh bounds.
+        // The levels stop at this error even if they didn't reach the target triangle count.
+        float maxError = 0.02f;
+        // Levels that remove less than this fraction of the triangles of the previous level are not kept.
+        float minReduction = 0.1f;
+    };
+
+    // Statistics of a GenerateMeshLods call, summed over the meshes.
+    struct MeshLodStatistics
+    {
+        uint32_t meshes = 0;            // meshes that got at least one level
+        uint32_t lods = 0;
+        uint64_t baseTriangles = 0;     // triangles of the full detail meshes that got levels
+        uint64_t lodTriangles = 0;      // triangles of all generated levels
+    };
+
+    // Simplifies a triangle list by collapsing edges in the order of their quadric error, without adding or moving
+    // vertices. Vertices on open borders and vertices that share their position with other vertices (attribute seams)
+    // are kept, so that the result stays watertight where the input was, and collapses that would flip a triangle are
+    // rejected. Stops when the triangle count reaches 'targetIndexCount' / 3 or when the next collapse would exceed
+    // 'targetError', which is an object space distance. Writes the indices to 'destination', which may be the same
+    // array as 'indices', and returns their number. The error of the result is stored in 'resultError' if provided.
+    size_t SimplifyMesh(
+        uint32_t* destination,
+        const uint32_t* indices,
+        size_t numIndices,
+        const dm::float3* positions,
+        size_t numVertices,
+        size_t targetIndexCount,
+        float targetError,
+        float* resultError = nullptr);
+
+    // Fills MeshInfo::lods of the triangle meshes with progressively simplified geometries. The index data of the
+    // levels is appended to the index data of the buffer groups, which must still be on the CPU, i.e. the function
+    // must run before Scene::FinishedLoading. Meshes that already have levels, curves and meshes of skinned instances
+    // are skipped. If a thread pool is provided, the meshes are processed in parallel.
+    MeshLodStatistics GenerateMeshLods(
+        const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+        const MeshLodParams& params,
+        ThreadPool* threadPool = nullptr);
+
+    // Selects the level of detail of a mesh whose error, projected to the screen, stays below 'maxScreenError' pixels.
+    // 'pixelsPerUnit' converts object space distances to pixels at the instance, i.e. it includes the instance scale,
+    // the distance from the view and the projection. Starting from 'currentLod', a finer level is selected as soon as
+    // the error of the current one is too large, but a coarser level only once its error is below
+    // (1 - hysteresis) * maxScreenError, so that instances near a threshold don't switch back and forth.
+    // Returns 0 for the full detail geometries, or 1 + the index in MeshInfo::lods.
+    uint32_t SelectMeshLod(
+        const MeshInfo& mesh,
+        float pixelsPerUnit,
+        float maxScreenError,
+        float hysteresis,
+        uint32_t currentLod);
+}
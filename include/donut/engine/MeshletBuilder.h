@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/engine/SceneTypes.h>
+#include <memory>
+#include <vector>
+
+namespace donut::engine
+{
+    class ThreadPool;
+
+    struct MeshletBuildParams
+    {
+        // Limits of each meshlet. The vertex limit is at most 256 because the triangles store 8-bit local indices.
+        // The defaults fit the common mesh shader output limits.
+        uint32_t maxVertices = 64;
+        uint32_t maxPrimitives = 124;
+    };
+
+    // Splits an indexed triangle list into meshlets and appends them to the output arrays.
+    // The offsets in the new meshlets point into the output arrays, and the vertex indices are copied from 'indices'.
+    // Meshlets are grown from a seed triangle by adding the adjacent triangles that add the fewest new vertices,
+    // and new seeds are taken in Morton order of the triangle centers, so that consecutive meshlets are close in space.
+    // The vertices of each meshlet are stored in the order of their first use.
+    // Returns the number of meshlets added.
+    uint32_t BuildMeshlets(
+        const uint32_t* indices,
+        size_t numIndices,
+        const dm::float3* positions,
+        size_t numVertices,
+        const MeshletBuildParams& params,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& meshletVertices,
+        std::vector<uint8_t>& meshletPrimitives);
+
+    // Computes the bounding sphere and the normal cone of a meshlet, see Meshlet.
+    void ComputeMeshletBounds(
+        Meshlet& meshlet,
+        const uint32_t* meshletVertices,
+        const uint8_t* meshletPrimitives,
+        const dm::float3* positions);
+
+    // Builds the meshlets of the triangle geometries of the meshes that don't have meshlets yet,
+    // and stores them in the buffer groups of the meshes. Curves and skinned instances are skipped.
+    // If a thread pool is provided, the geometries are processed in parallel.
+    void BuildMeshlets(
+        const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+        const MeshletBuildParams& params,
+        ThreadPool* threadPool = nullptr);
+}
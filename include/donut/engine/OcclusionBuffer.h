@@ -0,0 +1,166 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <donut/core/math/math.h>
+#include <filesystem>
+#include <cstdint>
+#include <vector>
+
+namespace donut::engine
+{
+    class ThreadPool;
+    class SceneGraph;
+
+    // A low resolution depth buffer rendered on the CPU for occlusion culling.
+    // A few large occluders are rasterized into the buffer, and then bounding boxes are tested against it:
+    // a box is occluded when all pixels that its screen rectangle covers contain occluders closer than the box.
+    // The test uses a min-depth pyramid so that it touches at most 2x2 texels per box.
+    // The buffer doesn't depend on the GPU and can be used on headless machines.
+    //
+    // Usage: BeginFrame with the view-projection matrix, then AddOccluder for each occluder,
+    // then Rasterize, and then IsVisible for the boxes to test.
+    // Occluders are rasterized double-sided with pixel center coverage, and boxes are tested against all pixels
+    // that their screen rectangle touches. Objects that are only visible through gaps between occluders
+    // that are narrower than a pixel of the buffer may be reported as occluded.
+    class OcclusionBuffer
+    {
+    public:
+        // The buffer is processed in tiles of this many pixels; the width and height are rounded up to whole tiles.
+        static constexpr uint32_t TileWidth = 32;
+        static constexpr uint32_t TileHeight = 16;
+
+        struct Stats
+        {
+            uint32_t occluders = 0;
+            uint32_t triangles = 0; // occluder triangles after clipping, excluding degenerate ones
+            uint32_t binnedTriangles = 0; // sum over tiles of the triangles binned to each tile
+        };
+
+    private:
+        struct Occluder
+        {
+            const dm::float3* positions;
+            const uint32_t* indices;
+            uint32_t numIndices;
+            dm::affine3 objectToWorld;
+        };
+
+        // Screen space triangle with edge and depth plane equations, evaluated at pixel centers.
+        struct Triangle
+        {
+            float edgeA[3];
+            float edgeB[3];
+            float edgeC[3];
+            float depthA, depthB, depthC;
+            int minX, minY, maxX, maxY;
+        };
+
+        // Triangles set up by one binning job, and the indices of the triangles that overlap each tile.
+        struct Bin
+        {
+            std::vector<Triangle> triangles;
+            std::vector<std::vector<uint32_t>> tileTriangles;
+        };
+
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_TilesX = 0;
+        uint32_t m_TilesY = 0;
+        dm::float4x4 m_ViewProjection = dm::float4x4::identity();
+        bool m_ReverseDepth = false;
+
+        std::vector<Occluder> m_Occluders;
+        std::vector<Bin> m_Bins;
+
+        // Depth is stored as a normalized value that grows towards the viewer: 1 at the near plane and 0 at
+        // the far plane or where nothing was rasterized. Level 0 is the full resolution buffer, and each
+        // following level stores the minimum (farthest) depth of 2x2 texels of the previous level.
+        std::vector<std::vector<float>> m_DepthLevels;
+        std::vector<dm::uint2> m_LevelSizes;
+
+        Stats m_Stats;
+
+        void SetupTriangles(uint32_t firstOccluder, uint32_t lastOccluder, Bin& bin) const;
+        void AddTriangle(const dm::float4& v0, const dm::float4& v1, const dm::float4& v2, Bin& bin) const;
+        [[nodiscard]] bool ProjectBox(const dm::box3& worldBox, dm::float2& screenMin, dm::float2& screenMax, float& maxDepth) const;
+        void RasterizeTile(uint32_t tileIndex);
+        void BuildDepthPyramid();
+
+    public:
+        OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+
+        void Resize(uint32_t width, uint32_t height);
+
+        [[nodiscard]] uint32_t GetWidth() const { return m_Width; }
+        [[nodiscard]] uint32_t GetHeight() const { return m_Height; }
+
+        // Clears the buffer and the occluder list. The view-projection matrix must be a D3D style projection
+        // whose depth range is [0, 1], or [1, 0] when reverseDepth is true, such as IView::GetViewProjectionMatrix.
+        void BeginFrame(const dm::float4x4& viewProjection, bool reverseDepth);
+
+        // Adds an indexed triangle list as an occluder. The indices refer to 'positions'.
+        // The arrays must stay valid until Rasterize returns.
+        void AddOccluder(const dm::float3* positions, const uint32_t* indices, uint32_t numIndices, const dm::affine3& objectToWorld);
+
+        // Rasterizes the occluders added since BeginFrame. If a thread pool is provided, triangle setup and binning
+        // are split across groups of occluders and the tiles are rasterized in parallel; the result is the same.
+        void Rasterize(ThreadPool* threadPool = nullptr);
+
+        // Returns false if the box is completely hidden behind the occluders.
+        // Boxes that cross the near plane or leave the screen are always visible.
+        [[nodiscard]] bool IsVisible(const dm::box3& worldBox) const;
+
+        // Returns the fraction of the screen covered by the screen rectangle of the box, clamped to 1,
+        // which can be used to select occluders. Boxes that cross the near plane return 1.
+        [[nodiscard]] float GetScreenCoverage(const dm::box3& worldBox) const;
+
+        [[nodiscard]] const Stats& GetStats() const { return m_Stats; }
+
+        // Returns the depth values of a pyramid level, row by row. Level 0 is the full resolution buffer.
+        [[nodiscard]] const std::vector<float>& GetDepthLevel(uint32_t level) const { return m_DepthLevels[level]; }
+        [[nodiscard]] dm::uint2 GetLevelSize(uint32_t level) const { return m_LevelSizes[level]; }
+        [[nodiscard]] uint32_t GetNumLevels() const { return uint32_t(m_DepthLevels.size()); }
+
+        // Converts the full resolution buffer into an 8-bit grayscale image, brighter pixels being closer.
+        void GetDebugImage(std::vector<uint8_t>& pixels) const;
+
+        // Writes the debug image into a PNG file.
+        bool WriteDebugImage(const std::filesystem::path& fileName) const;
+    };
+
+    struct OccluderSelectionParams
+    {
+        // Minimum diagonal of the world space bounds of an instance, relative to the diagonal of the bounds
+        // of all mesh instances in the scene.
+        float minRelativeSize = 0.1f;
+        // Meshes with more triangles are not selected, which limits the rasterization cost and the memory
+        // used by the CPU copies of their geometry.
+        uint32_t maxTriangles = 65536;
+    };
+
+    // Sets MeshInfo::isOccluder on the meshes that are good occluders: meshes made of opaque triangles only,
+    // not skinned, with at most maxTriangles, and with at least one instance that is large relative to the scene.
+    // The scene graph must be refreshed so that the instance transforms are current. Meshes that are already
+    // flagged stay flagged. Returns the number of meshes flagged by this call.
+    uint32_t SelectOccluders(const SceneGraph& sceneGraph, const OccluderSelectionParams& params = OccluderSelectionParams());
+}
@@ -23,6 +23,10 @@
 #pragma once
 
 #include <donut/engine/SceneGraph.h>
+#include <donut/engine/MeshletBuilder.h>
+#include <donut/engine/MeshOptimizer.h>
+#include <donut/engine/MeshSimplifier.h>
+#include <donut/engine/OcclusionBuffer.h>
 #include <nvrhi/nvrhi.h>
 #include <vector>
 #include <memory>
@@ -49,6 +53,8 @@ namespace donut::engine
     class ThreadPool;
     class DescriptorTableManager;
     class GltfImporter;
+    class MeshSetImporter;
+    class SceneCache;
     
     class Scene
     {
@@ -59,6 +65,17 @@ namespace donut::engine
         std::shared_ptr<DescriptorTableManager> m_DescriptorTable;
         std::shared_ptr<SceneGraph> m_SceneGraph;
         std::shared_ptr<GltfImporter> m_GltfImporter;
+        std::shared_ptr<MeshSetImporter> m_MeshSetImporter;
+        std::shared_ptr<SceneCache> m_SceneCache;
+        bool m_BuildMeshlets = false;
+        MeshletBuildParams m_MeshletParams;
+        bool m_GenerateLods = false;
+        MeshLodParams m_LodParams;
+        bool m_SelectOccluders = false;
+        OccluderSelectionParams m_OccluderParams;
+        bool m_CompressAnimations = false;
+        animation::CompressionSettings m_AnimationCompression;
+        VertexLayout m_VertexLayout = VertexLayout::Full;
         std::vector<SceneImportResult> m_Models;
         bool m_EnableBindlessResources = false;
         bool m_UseResourceDescriptorHeapBindless = false;
@@ -79,6 +96,11 @@ namespace donut::engine
         struct Resources; // Hide the implementation to avoid including <material_cb.h> and <bindless.h> here
         std::shared_ptr<Resources> m_Resources;
 
+        bool LoadModel(
+            const std::filesystem::path& fileName,
+            ThreadPool* threadPool,
+            SceneImportResult& result);
+
         void LoadModelAsync(
             uint32_t index,
             const std::filesystem::path& fileName,
@@ -123,7 +145,8 @@ namespace donut::engine
         void FinishedLoading(uint32_t frameIndex);
 
         // Processes animations, transforms, bounding boxes etc.
-        void RefreshSceneGraph(uint32_t frameIndex);
+        // If a thread pool is provided, the scene graph is refreshed in parallel, see SceneGraph::RefreshWithThreadPool.
+        void RefreshSceneGraph(uint32_t frameIndex, ThreadPool* threadPool = nullptr);
 
         // Creates missing buffers, uploads vertex buffers, instance data, materials, etc.
         void RefreshBuffers(nvrhi::ICommandList* commandList, uint32_t frameIndex);
@@ -135,6 +158,41 @@ namespace donut::engine
 
         virtual bool LoadWithThreadPool(const std::filesystem::path& sceneFileName, ThreadPool* threadPool);
 
+        // Sets the cache used to load models without parsing the glTF files, see SceneCache.
+        // Models that are not in the cache yet, or whose cache files are outdated, are imported and then stored in the cache.
+        // Caching is disabled by default; pass nullptr to disable it again.
+        void SetSceneCache(std::shared_ptr<SceneCache> sceneCache) { m_SceneCache = std::move(sceneCache); }
+
+        // Enables the vertex cache and vertex fetch optimization of the glTF models, see GltfImporter::SetOptimizeMeshes.
+        // Models loaded from the scene cache keep the vertex order they were stored with.
+        void SetOptimizeMeshes(bool enable, const MeshOptimizationParams& params = MeshOptimizationParams());
+
+        // Enables building meshlets for the triangle geometries of the glTF models, see GltfImporter::SetBuildMeshlets.
+        // Models loaded from the scene cache without meshlets get them built after loading.
+        // Mesh set files (.meshset) are loaded with the meshlets they contain, see MeshSetImporter.
+        void SetBuildMeshlets(bool enable, const MeshletBuildParams& params = MeshletBuildParams());
+
+        // Enables generating levels of detail for the triangle meshes of all loaded models, see GenerateMeshLods.
+        // The levels are selected per instance by LodSelectionDrawStrategy.
+        void SetGenerateLods(bool enable, const MeshLodParams& params = MeshLodParams());
+
+        // Enables flagging the meshes that are good occluders with MeshInfo::isOccluder when the mesh buffers are created,
+        // see SelectOccluders. The CPU copies of the positions and indices of these meshes are kept after uploading,
+        // which OcclusionCullingDrawStrategy needs to rasterize them. Must be called before FinishedLoading.
+        void SetSelectOccluders(bool enable, const OccluderSelectionParams& params = OccluderSelectionParams());
+
+        // Enables compressing the keyframes of the animations in the loaded models and the scene file,
+        // see animation::Sampler::Compress. The memory saved is reported in SceneLoadingStats::AnimationBytesSaved.
+        void SetCompressAnimations(bool enable, const animation::CompressionSettings& settings = animation::CompressionSettings());
+
+        // Selects the encoding of the vertex buffers created for the loaded meshes, including the skinned ones.
+        // Must be called before FinishedLoading, and the geometry passes rendering the scene must be created
+        // with the same layout. With the compact layout, the buffer groups whose positions FP16 cannot represent
+        // keep the full layout, see QuantizePositions and BufferGroup::vertexLayout.
+        // The memory saved by the compact layout is reported in SceneLoadingStats::VertexBytesSaved.
+        void SetVertexLayout(VertexLayout layout) { m_VertexLayout = layout; }
+        [[nodiscard]] VertexLayout GetVertexLayout() const { return m_VertexLayout; }
+
         static const SceneLoadingStats& GetLoadingStats();
 
         [[nodiscard]] std::shared_ptr<SceneGraph> GetSceneGraph() const { return m_SceneGraph; }
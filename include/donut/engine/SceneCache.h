@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <filesystem>
+
+namespace donut::vfs
+{
+    class IFileSystem;
+}
+
+namespace donut::engine
+{
+    struct SceneImportResult;
+    class SceneTypeFactory;
+    class TextureCache;
+    class ThreadPool;
+
+    // Stores fully imported models in a binary cache file next to the source model, so that subsequent loads
+    // can rebuild the scene graph without parsing the glTF file or recomputing the vertex streams.
+    // The cache file is a donut::chunk::ChunkFile that contains the mesh buffers, materials, node hierarchy
+    // and animations of one model, and the sizes, modification times and content hashes of the files the importer has read.
+    // A cache file is only used when all of those source files are unchanged. Files are only hashed on load
+    // when the file system doesn't report their modification time or it differs from the recorded one.
+    // Textures are not baked: they are loaded from their original files through the TextureCache.
+    // Models that use textures embedded in the glTF file or swizzled textures are not cached.
+    class SceneCache
+    {
+    protected:
+        std::shared_ptr<vfs::IFileSystem> m_fs;
+        std::shared_ptr<SceneTypeFactory> m_SceneTypeFactory;
+
+    public:
+        SceneCache(std::shared_ptr<vfs::IFileSystem> fs, std::shared_ptr<SceneTypeFactory> sceneTypeFactory);
+
+        // Returns the name of the cache file for a model, which is the model file name with an extra extension.
+        [[nodiscard]] static std::filesystem::path GetCacheFileName(const std::filesystem::path& fileName);
+
+        // Loads a model from its cache file. Returns false if there is no cache file for the model,
+        // or if the cache file is outdated or invalid; the model needs to be imported in that case.
+        // If a thread pool is provided, the textures are loaded asynchronously.
+        bool Load(
+            const std::filesystem::path& fileName,
+            TextureCache& textureCache,
+            ThreadPool* threadPool,
+            SceneImportResult& result) const;
+
+        // Writes the cache file for a model that has been imported from 'fileName'.
+        // Returns false if the model cannot be cached or the file cannot be written.
+        bool Store(const std::filesystem::path& fileName, const SceneImportResult& result) const;
+    };
+}
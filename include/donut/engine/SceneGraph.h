@@ -24,7 +24,9 @@
 
 #include <donut/engine/SceneTypes.h>
 #include <donut/engine/KeyframeAnimation.h>
+#include <donut/engine/InstanceBVH.h>
 #include <donut/core/math/math.h>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -37,6 +39,7 @@ namespace donut::engine
     class SceneGraph;
     class SceneGraphNode;
     class SceneTypeFactory;
+    class ThreadPool;
 
     enum struct SceneContentFlags : uint32_t
     {
@@ -113,7 +116,7 @@ namespace donut::engine
     protected:
         friend class SceneGraph;
         std::shared_ptr<MeshInfo> m_PrototypeMesh;
-        uint32_t m_LastUpdateFrameIndex = 0;
+        std::atomic<uint32_t> m_LastUpdateFrameIndex = 0; // written concurrently by SceneGraph::RefreshWithThreadPool
         std::shared_ptr<SceneTypeFactory> m_SceneTypeFactory;
 
     public:
@@ -125,7 +128,7 @@ namespace donut::engine
         explicit SkinnedMeshInstance(std::shared_ptr<SceneTypeFactory> sceneTypeFactory, std::shared_ptr<MeshInfo> prototypeMesh);
 
         [[nodiscard]] const std::shared_ptr<MeshInfo>& GetPrototypeMesh() const { return m_PrototypeMesh; }
-        [[nodiscard]] uint32_t GetLastUpdateFrameIndex() const { return m_LastUpdateFrameIndex; }
+        [[nodiscard]] uint32_t GetLastUpdateFrameIndex() const { return m_LastUpdateFrameIndex.load(std::memory_order_relaxed); }
         [[nodiscard]] std::shared_ptr<SceneGraphLeaf> Clone() override;
     };
 
@@ -247,6 +250,27 @@ namespace donut::engine
         bool SetProperty(const std::string& name, const dm::float4& value) override;
     };
     
+    // Structure-of-arrays storage for the transforms of all nodes in a scene graph.
+    // The nodes are stored in depth-first order, so every parent comes before its children,
+    // and the subgraph of any node occupies a contiguous range [index, subgraphEnds[index]).
+    // Owned by SceneGraph and rebuilt by SceneGraph::Refresh after the hierarchy changes.
+    // When the store is disabled, see SceneGraph::SetTransformStoreEnabled, only the node order arrays are filled
+    // and the transform arrays are empty.
+    struct SceneGraphTransformStore
+    {
+        std::vector<SceneGraphNode*> nodes;
+        std::vector<int> parentIndices; // -1 for the root node
+        std::vector<uint32_t> subgraphEnds;
+        std::vector<dm::daffine3> localTransforms;
+        std::vector<dm::daffine3> globalTransforms;
+        std::vector<dm::affine3> globalTransformsFloat;
+        std::vector<dm::daffine3> prevLocalTransforms;
+        std::vector<dm::daffine3> prevGlobalTransforms;
+        std::vector<dm::affine3> prevGlobalTransformsFloat;
+
+        [[nodiscard]] size_t size() const { return nodes.size(); }
+    };
+
     class SceneGraphNode final : public std::enable_shared_from_this<SceneGraphNode>
     {
     public:
@@ -271,12 +295,8 @@ namespace donut::engine
         std::shared_ptr<SceneGraphLeaf> m_Leaf;
 
         std::string m_Name;
-        dm::daffine3 m_LocalTransform = dm::daffine3::identity();
-        dm::daffine3 m_GlobalTransform = dm::daffine3::identity();
-        dm::affine3 m_GlobalTransformFloat = dm::affine3::identity();
-        dm::daffine3 m_PrevLocalTransform = dm::daffine3::identity();
-        dm::daffine3 m_PrevGlobalTransform = dm::daffine3::identity();
-        dm::affine3 m_PrevGlobalTransformFloat = dm::affine3::identity();
+        const SceneGraphTransformStore* m_TransformStore = nullptr;
+        uint32_t m_TransformIndex = 0;
         dm::dquat m_Rotation = dm::dquat::identity();
         dm::double3 m_Scaling = 1.0;
         dm::double3 m_Translation = 0.0;
@@ -286,7 +306,25 @@ namespace donut::engine
         SceneContentFlags m_LeafContent = SceneContentFlags::None;
         SceneContentFlags m_SubgraphContent = SceneContentFlags::None;
 
-        void UpdateLocalTransform();
+        // The transforms of a node that is not in a transform store, because the store of its graph is disabled,
+        // the node is detached, or the graph has not been refreshed since the node was attached.
+        // A node has either a store or these transforms, never both.
+        struct Transforms
+        {
+            dm::daffine3 localTransform = dm::daffine3::identity();
+            dm::daffine3 globalTransform = dm::daffine3::identity();
+            dm::affine3 globalTransformFloat = dm::affine3::identity();
+            dm::daffine3 prevLocalTransform = dm::daffine3::identity();
+            dm::daffine3 prevGlobalTransform = dm::daffine3::identity();
+            dm::affine3 prevGlobalTransformFloat = dm::affine3::identity();
+        };
+        std::unique_ptr<Transforms> m_Transforms;
+
+        static const dm::daffine3 s_IdentityTransform;
+        static const dm::affine3 s_IdentityTransformFloat;
+
+        [[nodiscard]] dm::daffine3 ComputeLocalTransform() const;
+        void LeaveTransformStore();
         void PropagateDirtyFlags(SceneGraphNode::DirtyFlags flags);
 
     public:
@@ -297,12 +335,15 @@ namespace donut::engine
         [[nodiscard]] const dm::double3& GetScaling() const { return m_Scaling; }
         [[nodiscard]] const dm::double3& GetTranslation() const { return m_Translation; }
 
-        [[nodiscard]] const dm::daffine3& GetLocalToParentTransform() const { return m_LocalTransform; }
-        [[nodiscard]] const dm::daffine3& GetLocalToWorldTransform() const { return m_GlobalTransform; }
-        [[nodiscard]] const dm::affine3& GetLocalToWorldTransformFloat() const { return m_GlobalTransformFloat; }
-        [[nodiscard]] const dm::daffine3& GetPrevLocalToParentTransform() const { return m_PrevLocalTransform; }
-        [[nodiscard]] const dm::daffine3& GetPrevLocalToWorldTransform() const { return m_PrevGlobalTransform; }
-        [[nodiscard]] const dm::affine3& GetPrevLocalToWorldTransformFloat() const { return m_PrevGlobalTransformFloat; }
+        // The transforms are stored in the transform store of the graph if it's enabled, or in the node otherwise.
+        // Detached nodes keep the transforms from the last refresh of their graph until they are attached again.
+        // Nodes that have never been refreshed return identity transforms.
+        [[nodiscard]] const dm::daffine3& GetLocalToParentTransform() const;
+        [[nodiscard]] const dm::daffine3& GetLocalToWorldTransform() const;
+        [[nodiscard]] const dm::affine3& GetLocalToWorldTransformFloat() const;
+        [[nodiscard]] const dm::daffine3& GetPrevLocalToParentTransform() const;
+        [[nodiscard]] const dm::daffine3& GetPrevLocalToWorldTransform() const;
+        [[nodiscard]] const dm::affine3& GetPrevLocalToWorldTransformFloat() const;
         [[nodiscard]] const dm::box3& GetGlobalBoundingBox() const { return m_GlobalBoundingBox; }
         [[nodiscard]] DirtyFlags GetDirtyFlags() const { return m_Dirty; }
         [[nodiscard]] SceneContentFlags GetLeafContentFlags() const { return m_LeafContent; }
@@ -407,6 +448,7 @@ namespace donut::engine
         std::weak_ptr<Material> m_TargetMaterial;
         AnimationAttribute m_Attribute;
         std::string m_LeafPropertyName;
+        animation::SamplerCursor m_Cursor;
 
     public:
         SceneGraphAnimationChannel(std::shared_ptr<animation::Sampler> sampler, const std::shared_ptr<SceneGraphNode>& targetNode, AnimationAttribute attribute)
@@ -427,13 +469,18 @@ namespace donut::engine
         [[nodiscard]] const std::string& GetLeafPropertyName() const { return m_LeafPropertyName; }
         void SetTargetNode(const std::shared_ptr<SceneGraphNode>& node) { m_TargetNode = node; }
         void SetLeafProperyName(const std::string& name) { m_LeafPropertyName = name; }
-        bool Apply(float time) const;  // NOLINT(modernize-use-nodiscard)
+        // Updates the cursor of the channel, so the same channel must not be applied from multiple threads at once.
+        bool Apply(float time);  // NOLINT(modernize-use-nodiscard)
+        // Applies a value evaluated from the sampler elsewhere, for example by SceneGraphAnimation.
+        bool ApplyValue(const dm::float4& value) const;  // NOLINT(modernize-use-nodiscard)
     };
 
     class SceneGraphAnimation : public SceneGraphLeaf
     {
     private:
         std::vector<std::shared_ptr<SceneGraphAnimationChannel>> m_Channels;
+        // Evaluates the samplers of all channels in one pass, the sampler indices match the channel indices
+        animation::SamplerBatch m_Samplers;
         float m_Duration = 0.f;
 
     public:
@@ -444,8 +491,12 @@ namespace donut::engine
         [[nodiscard]] const std::vector<std::shared_ptr<SceneGraphAnimationChannel>>& GetChannels() const { return m_Channels; }
         [[nodiscard]] float GetDuration() const { return m_Duration; }
         [[nodiscard]] bool IsVald() const;
-        bool Apply(float time) const;  // NOLINT(modernize-use-nodiscard)
+        // Updates the sampler cursors of the animation, so the same animation must not be applied from multiple threads at once.
+        bool Apply(float time);  // NOLINT(modernize-use-nodiscard)
         void AddChannel(const std::shared_ptr<SceneGraphAnimationChannel>& channel);
+
+        // Compresses the samplers of all channels, see animation::Sampler::Compress.
+        animation::CompressionReport Compress(const animation::CompressionSettings& settings);  // NOLINT(modernize-use-nodiscard)
     };
 
     // A container that tracks unique resources of the same type used by some entity, for example unique meshes used in a scene graph.
@@ -530,6 +581,24 @@ namespace donut::engine
         std::vector<std::shared_ptr<SceneGraphAnimation>> m_Animations;
         std::vector<std::shared_ptr<SceneCamera>> m_Cameras;
         std::vector<std::shared_ptr<Light>> m_Lights;
+
+        SceneGraphTransformStore m_TransformStore;
+        bool m_TransformStoreEnabled = false;
+        bool m_TransformStoreDirty = true;
+        std::vector<uint8_t> m_RefreshFlags; // per-node scratch for Refresh, parallel to m_TransformStore
+        std::vector<uint32_t> m_RefreshedNodes;
+        std::unique_ptr<InstanceBVH> m_InstanceBVH;
+        uint64_t m_StructureVersion = 0;
+        uint64_t m_ContentVersion = 0;
+        uint64_t m_TransformVersion = 0;
+
+        void UpdateVersions();
+        void RebuildTransformStore();
+        uint8_t RefreshNode(uint32_t index, uint8_t context, uint32_t frameIndex);
+        static void MergeSubgraph(dm::box3& boundingBox, SceneGraphNode::DirtyFlags& dirty, SceneContentFlags& content, const SceneGraphNode* child);
+        void RefreshSubgraph(uint32_t scopeIndex, uint8_t scopeContext, uint32_t frameIndex, bool updateScopeParent, std::vector<uint32_t>& refreshedNodes);
+        void UpdateIndices();
+        void UpdateInstanceBVH(bool rebuild, const std::vector<uint32_t>& refreshedNodes);
         
     protected:
         virtual void RegisterLeaf(const std::shared_ptr<SceneGraphLeaf>& leaf);
@@ -537,7 +606,7 @@ namespace donut::engine
 
     public:
         SceneGraph() = default;
-        virtual ~SceneGraph() = default;
+        virtual ~SceneGraph();
 
         SceneResourceCallback<MeshInfo> OnMeshAdded;
         SceneResourceCallback<MeshInfo> OnMeshRemoved;
@@ -555,9 +624,17 @@ namespace donut::engine
         [[nodiscard]] const std::vector<std::shared_ptr<SceneGraphAnimation>>& GetAnimations() const { return m_Animations; }
         [[nodiscard]] const std::vector<std::shared_ptr<SceneCamera>>& GetCameras() const { return m_Cameras; }
         [[nodiscard]] const std::vector<std::shared_ptr<Light>>& GetLights() const { return m_Lights; }
+        [[nodiscard]] const SceneGraphTransformStore& GetTransformStore() const { return m_TransformStore; } // valid after Refresh
         [[nodiscard]] bool HasPendingStructureChanges() const { return m_Root && (m_Root->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphStructure) != 0; }
         [[nodiscard]] bool HasPendingTransformChanges() const { return m_Root && (m_Root->m_Dirty & (SceneGraphNode::DirtyFlags::SubgraphTransforms | SceneGraphNode::DirtyFlags::SubgraphPrevTransforms)) != 0; }
 
+        // Change counters for caches of data derived from the graph, such as retained draw lists.
+        // Refresh increments them when it processes structure changes (nodes or leaves attached or detached),
+        // content changes (SceneGraphNode::InvalidateContent), or transform changes, respectively.
+        [[nodiscard]] uint64_t GetStructureVersion() const { return m_StructureVersion; }
+        [[nodiscard]] uint64_t GetContentVersion() const { return m_ContentVersion; }
+        [[nodiscard]] uint64_t GetTransformVersion() const { return m_TransformVersion; }
+
         // Replaces the current root node of the graph with the new one.
         std::shared_ptr<SceneGraphNode> SetRootNode(const std::shared_ptr<SceneGraphNode>& root);
         
@@ -580,11 +657,36 @@ namespace donut::engine
         [[nodiscard]] std::shared_ptr<SceneGraphNode> FindNode(const std::filesystem::path& path, SceneGraphNode* context = nullptr) const;
         
         void Refresh(uint32_t frameIndex);
+
+        // Same as Refresh, but distributes the dirty subgraphs across the thread pool workers and
+        // reduces the bounding boxes and dirty flags bottom-up. The results are identical to Refresh.
+        // Leaf implementations of GetLocalBoundingBox and GetContentFlags must be safe to call concurrently.
+        // If threadPool is NULL, falls back to the serial Refresh.
+        void RefreshWithThreadPool(uint32_t frameIndex, ThreadPool* threadPool);
+
+        // Enables a BVH over the world space bounds of the mesh instances, which is maintained by Refresh and used
+        // by the BVH draw strategies to cull instances independently of the node hierarchy. The leaf index of an
+        // instance in the BVH is its instance index. The BVH is rebuilt when the graph structure changes,
+        // and updated incrementally when instances move.
+        void SetInstanceBVHEnabled(bool enabled);
+
+        // Enables storing the transforms of all nodes in the SoA transform store of the graph instead of the nodes,
+        // which makes Refresh scan contiguous arrays. The transforms move between the nodes and the store on the next Refresh.
+        void SetTransformStoreEnabled(bool enabled);
+        [[nodiscard]] bool IsTransformStoreEnabled() const { return m_TransformStoreEnabled; }
+
+        // Returns the instance BVH, or NULL if it's not enabled. Valid after Refresh.
+        [[nodiscard]] const InstanceBVH* GetInstanceBVH() const { return m_InstanceBVH.get(); }
+        [[nodiscard]] InstanceBVH* GetInstanceBVH() { return m_InstanceBVH.get(); }
     };
 
     struct SceneImportResult
     {
         std::shared_ptr<SceneGraphNode> rootNode;
+
+        // The files that were read to import the model, i.e. the glTF file and its external buffers.
+        // Texture files are not included. Used by SceneCache to detect outdated cache files.
+        std::vector<std::string> sourceFiles;
     };
 
     class SceneTypeFactory
@@ -127,6 +127,10 @@ namespace donut::engine
         std::string path;
         std::string mimeType;
 
+        // Incremented when 'texture' is replaced with a new object, e.g. when mip streaming changes the resident
+        // mips. Binding sets that reference 'texture' directly must be recreated when the generation changes.
+        uint32_t generation = 0;
+
         // Options to construct the texture from a multichannel image, as provided by the glTF asset
         // through the NV_texture_swizzle extension. Applications should choose one of the options that
         // they're compatible with, or fallback to the regular texture.
@@ -150,13 +154,61 @@ namespace donut::engine
         Count
     };
 
-    nvrhi::VertexAttributeDesc GetVertexAttributeDesc(VertexAttribute attribute, const char* name, uint32_t bufferIndex);
+    // Encoding of the vertex streams in BufferGroup::vertexBuffer, see Scene::SetVertexLayout.
+    // The CPU-side streams of a BufferGroup (positionData etc.) always use the full precision types,
+    // the compact encoding is only applied when the data is uploaded to the GPU.
+    enum class VertexLayout : uint8_t
+    {
+        // Positions are RGB32_FLOAT, texture coordinates RG32_FLOAT, joint weights RGBA32_FLOAT.
+        Full,
+
+        // Positions are RGBA16_FLOAT with W=1, texture coordinates RG16_FLOAT, joint weights RGBA8_UNORM.
+        // Normals, tangents, joint indices and curve radii use the same encoding as the full layout.
+        // FP16 positions have ~11 bits of precision, so buffer groups whose positions FP16 cannot represent
+        // precisely enough relative to their bounds keep the full layout, see QuantizePositions.
+        Compact
+    };
+
+    // Returns the size of one element of the vertex stream for the attribute, in bytes.
+    uint32_t GetVertexAttributeStride(VertexAttribute attribute, VertexLayout layout = VertexLayout::Full);
+
+    nvrhi::VertexAttributeDesc GetVertexAttributeDesc(VertexAttribute attribute, const char* name, uint32_t bufferIndex,
+        VertexLayout layout = VertexLayout::Full);
+
+    // Conversion of the CPU-side vertex streams into the compact layout.
+    // Returns false if the FP16 rounding error of any position exceeds 1/1024 of the largest dimension of the bounds
+    // of the positions, which happens with large coordinates or meshes far from the origin. 'result' is undefined then.
+    bool QuantizePositions(const dm::float3* positions, size_t count, std::vector<dm::float16_t4>& result);
+    std::vector<dm::float16_t2> QuantizeTexCoords(const dm::float2* texCoords, size_t count);
+    // Weights are normalized and rounded so that the 4 unorm8 values of each vertex sum up to 255.
+    std::vector<uint32_t> QuantizeJointWeights(const dm::float4* weights, size_t count);
 
 
     struct SceneLoadingStats
     {
         std::atomic<uint32_t> ObjectsTotal;
         std::atomic<uint32_t> ObjectsLoaded;
+        std::atomic<uint32_t> ObjectsLoadedFromCache; // models loaded through the SceneCache instead of the glTF importer
+
+        // Time spent in the two phases of the glTF mesh import, summed over all loaded models:
+        // computing the buffer layout, and filling the vertex and index streams.
+        std::atomic<uint64_t> MeshLayoutMicroseconds;
+        std::atomic<uint64_t> MeshDataMicroseconds;
+
+        // Time spent optimizing the index and vertex order of the loaded models, see GltfImporter::SetOptimizeMeshes.
+        std::atomic<uint64_t> MeshOptimizationMicroseconds;
+
+        // Time spent building meshlets for the loaded models, see GltfImporter::SetBuildMeshlets.
+        std::atomic<uint64_t> MeshletMicroseconds;
+
+        // Time spent generating levels of detail for the loaded models, see Scene::SetGenerateLods.
+        std::atomic<uint64_t> MeshLodMicroseconds;
+
+        // Vertex buffer memory saved by the compact vertex layout, see Scene::SetVertexLayout.
+        std::atomic<uint64_t> VertexBytesSaved;
+
+        // Keyframe memory saved by compressing the animations, see Scene::SetCompressAnimations.
+        std::atomic<uint64_t> AnimationBytesSaved;
     };
 
     // NOTE regarding MaterialDomain and transparency. It may seem that the Transparent attribute
@@ -267,6 +319,28 @@ namespace donut::engine
         uint32_t numVertexBuffers;
     };
 
+    // A small cluster of triangles of a geometry, for cluster culling and mesh shaders, see MeshletBuilder.h.
+    // This is also the layout of the meshlet headers in donut::chunk::MeshletSet files.
+    struct Meshlet
+    {
+        uint32_t vertexOffset = 0;      // first entry of the meshlet in BufferGroup::meshletVertexData
+        uint32_t vertexCount = 0;
+        uint32_t primitiveOffset = 0;   // first triangle of the meshlet, its local indices start at meshletPrimitiveData[primitiveOffset * 3]
+        uint32_t primitiveCount = 0;
+
+        // Bounding sphere of the meshlet in object space
+        dm::float3 center = 0.f;
+        float radius = 0.f;
+
+        // Normal cone: all triangles of the meshlet face away from a viewer at 'eye' if
+        // dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius.
+        // Meshlets that cannot be culled this way have coneCutoff = 1.
+        dm::float3 coneAxis = 0.f;
+        float coneCutoff = 1.f;
+    };
+
+    static_assert(sizeof(Meshlet) == 48);
+
     struct BufferGroup
     {
         nvrhi::BufferHandle indexBuffer;
@@ -287,10 +361,18 @@ namespace donut::engine
         std::vector<dm::float4> weightData;
         std::vector<float> radiusData;
         std::vector<dm::float4> morphTargetData;
+        // Optional meshlets of the geometries, see MeshGeometry::meshletOffset and MeshletBuilder.h.
+        // The vertex indices are relative to the first vertex of the geometry, like indexData.
+        std::vector<Meshlet> meshletData;
+        std::vector<uint32_t> meshletVertexData;
+        std::vector<uint8_t> meshletPrimitiveData;  // 3 indices into the meshlet vertices per triangle
+        VertexLayout vertexLayout = VertexLayout::Full; // encoding of vertexBuffer, assigned by Scene::CreateMeshBuffers
+        int globalBufferGroupIndex = 0; // assigned by SceneGraph, used for sorting
 
         [[nodiscard]] bool hasAttribute(VertexAttribute attr) const { return vertexBufferRanges[int(attr)].byteSize != 0; }
         nvrhi::BufferRange& getVertexBufferRange(VertexAttribute attr) { return vertexBufferRanges[int(attr)]; }
         [[nodiscard]] const nvrhi::BufferRange& getVertexBufferRange(VertexAttribute attr) const { return vertexBufferRanges[int(attr)]; }
+        [[nodiscard]] uint32_t getVertexStride(VertexAttribute attr) const { return GetVertexAttributeStride(attr, vertexLayout); }
     };
 
     enum class MeshGeometryPrimitiveType : uint8_t
@@ -310,6 +392,8 @@ namespace donut::engine
         uint32_t vertexOffsetInMesh = 0;
         uint32_t numIndices = 0;
         uint32_t numVertices = 0;
+        uint32_t meshletOffset = 0;     // first meshlet of the geometry in BufferGroup::meshletData
+        uint32_t numMeshlets = 0;
         int globalGeometryIndex = 0;
 
         MeshGeometryPrimitiveType type = MeshGeometryPrimitiveType::Triangles;
@@ -327,6 +411,17 @@ namespace donut::engine
         Count
     };
 
+    // A simplified version of the geometries of a mesh, see MeshInfo::lods and GenerateMeshLods.
+    struct MeshLod
+    {
+        // One geometry per geometry of the mesh, in the same order. They share the material and the vertex range
+        // of the original geometries, and reference simplified triangle lists that are appended to the index data
+        // of the buffer group. A geometry has no indices if it was simplified away entirely.
+        std::vector<std::shared_ptr<MeshGeometry>> geometries;
+        float error = 0.f;          // object space distance between this level and the full detail mesh
+        uint32_t numTriangles = 0;  // in all geometries
+    };
+
     struct MeshInfo
     {
         std::string name;
@@ -343,6 +438,12 @@ namespace donut::engine
         bool isMorphTargetAnimationMesh = false;
         nvrhi::rt::AccelStructHandle accelStruct; // for use by applications
         bool isSkinPrototype = false;
+        // Occluder hint for CPU occlusion culling. Scene keeps the CPU copies of the positions and indices
+        // of the buffer groups used by such meshes after uploading them.
+        bool isOccluder = false;
+        // Levels of detail with increasing error, LOD 0 is 'geometries' and not stored here.
+        // Meshes of skinned instances use the levels of their prototype.
+        std::vector<MeshLod> lods;
 
         virtual ~MeshInfo() = default;
         bool IsCurve() const
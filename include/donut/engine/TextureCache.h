@@ -52,6 +52,30 @@ namespace donut::engine
         size_t dataSize = 0;
     };
 
+    // Mip streaming state of a DDS texture, see TextureCache::SetMipStreaming.
+    struct TextureStreamingState
+    {
+        // Size and mip count of the complete texture in the file
+        uint32_t width = 1;
+        uint32_t height = 1;
+        uint32_t mipLevels = 1;
+
+        // Layout of the complete texture, with offsets relative to the start of the file
+        std::vector<std::vector<TextureSubresourceData>> fileLayout;
+
+        // The coarsest mip level that is kept resident, i.e. the first mip of the mip tail
+        uint32_t tailMip = 0;
+
+        // The finest mip level of the file that is resident in the GPU texture, which is mip 0 of that texture
+        uint32_t residentMip = 0;
+
+        // The finest mip level requested by the application
+        std::atomic<uint32_t> desiredMip = 0;
+
+        // Set while the data for a residency change is being read or waiting for upload
+        std::atomic<bool> updatePending = false;
+    };
+
     struct TextureData : public LoadedTexture
     {
         std::shared_ptr<vfs::IBlob> data;
@@ -68,6 +92,37 @@ namespace donut::engine
 
         // ArraySlice -> MipLevel -> TextureSubresourceData
         std::vector<std::vector<TextureSubresourceData>> dataLayout;
+
+        // Not null for DDS textures loaded with mip streaming, in which case the fields above describe
+        // the mips currently resident on the GPU rather than the complete texture.
+        std::shared_ptr<TextureStreamingState> streaming;
+
+        // Set by FinalizeTexture after 'texture' has been created. The loading threads write 'texture' and 'streaming'
+        // without holding a lock, so the streaming functions only access textures that have this flag set.
+        std::atomic<bool> finalized = false;
+
+        // Residency tracking for cached textures, protected by the TextureCache mutex.
+        uint64_t residentBytes = 0;
+        uint64_t lastAccess = 0;
+        uint32_t accessCount = 0;
+    };
+
+    enum class TextureEvictionPolicy : uint8_t
+    {
+        // Evict the textures that haven't been requested for the longest time first.
+        LeastRecentlyUsed,
+        // Evict the textures that have been requested the fewest times first, oldest first among equals.
+        LeastFrequentlyUsed
+    };
+
+    struct TextureCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t residentBytes = 0;
+        uint64_t memoryBudget = 0;
+        uint32_t residentTextures = 0;
     };
 
     class TextureCache
@@ -82,6 +137,19 @@ namespace donut::engine
         std::shared_ptr<DescriptorTableManager> m_DescriptorTable;
         std::mutex m_TexturesToFinalizeMutex;
 
+        // Mips read for a streaming texture: all mips from 'firstMip' to the end of the chain, to replace the GPU texture.
+        struct TextureMipUpload
+        {
+            std::shared_ptr<TextureData> texture;
+            uint32_t firstMip = 0;
+            std::shared_ptr<vfs::IBlob> data;
+            std::vector<std::vector<TextureSubresourceData>> dataLayout;
+        };
+
+        std::queue<TextureMipUpload> m_MipUploads; // protected by m_TexturesToFinalizeMutex
+        bool m_MipStreaming = false;
+        uint32_t m_MipTailSize = 256;
+
         std::shared_ptr<vfs::IFileSystem> m_fs;
 
         uint32_t m_MaxTextureSize = 0;
@@ -95,9 +163,46 @@ namespace donut::engine
         std::atomic<uint32_t> m_TexturesLoaded = 0;
         uint32_t m_TexturesFinalized = 0;
 
+        // Residency state, protected by m_LoadedTexturesMutex
+        uint64_t m_MemoryBudget = 0;
+        TextureEvictionPolicy m_EvictionPolicy = TextureEvictionPolicy::LeastRecentlyUsed;
+        uint64_t m_ResidentBytes = 0;
+        uint64_t m_AccessCounter = 0;
+        uint64_t m_CacheHits = 0;
+        uint64_t m_CacheMisses = 0;
+        uint64_t m_Evictions = 0;
+
+        // Textures removed from the cache but not destroyed yet. Destroying a texture releases its bindless
+        // descriptor, and the descriptor table is not thread-safe, so eviction can happen on the loader threads
+        // but the textures are only released in ProcessRenderingThreadCommands.
+        std::vector<std::shared_ptr<TextureData>> m_EvictedTextures;
+
         bool FindTextureInCache(const std::filesystem::path& path, std::shared_ptr<TextureData>& texture);
+
+        // Recomputes the memory used by a cached texture after its data has been loaded or uploaded.
+        void UpdateTextureResidency(const std::shared_ptr<TextureData>& texture);
+
+        // Evicts unreferenced textures until the resident size fits into 'targetBytes'.
+        // Must be called with m_LoadedTexturesMutex locked.
+        uint32_t EvictTexturesLocked(uint64_t targetBytes);
         std::shared_ptr<vfs::IBlob> ReadTextureFile(const std::filesystem::path& path) const;
 
+        // Reads and decodes a texture file, or only the mip tail of a DDS file when mip streaming is enabled.
+        bool LoadTextureFileData(const std::filesystem::path& path, const std::shared_ptr<TextureData>& texture);
+
+        // Loads the header and mip tail of a DDS file for streaming. Sets 'streamable' to false
+        // if the texture doesn't support streaming and should be loaded in its entirety.
+        bool LoadDDSMipTail(const std::filesystem::path& path, const std::shared_ptr<TextureData>& texture, bool& streamable) const;
+
+        // Reads mips from 'firstMip' to the end of the chain of every array slice from the texture file.
+        std::shared_ptr<vfs::IBlob> ReadTextureMips(
+            const std::filesystem::path& path,
+            const TextureStreamingState& streaming,
+            uint32_t firstMip,
+            std::vector<std::vector<TextureSubresourceData>>& dataLayout) const;
+
+        void UploadTextureMips(TextureMipUpload& upload, nvrhi::ICommandList* commandList);
+
         bool FillTextureData(
             const std::shared_ptr<vfs::IBlob>& fileData,
             const std::shared_ptr<TextureData>& texture,
@@ -136,6 +241,7 @@ namespace donut::engine
             bool sRGB);
 
         // Asynchronous read and decode, deferred upload and mip generation (in the ProcessRenderingThreadCommands queue).
+        // The decoding runs at low priority in the thread pool, after any pending geometry loading tasks.
         virtual std::shared_ptr<LoadedTexture> LoadTextureFromFileAsync(
             const std::filesystem::path& path,
             bool sRGB,
@@ -194,12 +300,61 @@ namespace donut::engine
         // Enables or disables automatic mip generation for loaded textures.
         void SetGenerateMipmaps(bool generateMipmaps);
 
+        // Enables loading DDS textures with only the mip tail resident, which is the mips with both dimensions
+        // not exceeding 'mipTailSize'. Finer mips are loaded when requested with SetDesiredMipLevel.
+        // Only applies to 2D textures, arrays and cube maps with power-of-two dimensions that are loaded from files.
+        // Streaming replaces the GPU texture object when the resident mips change. Bindless descriptors are updated
+        // in place, but binding sets created with the old texture, e.g. by MaterialBindingCache, must be recreated.
+        void SetMipStreaming(bool enable, uint32_t mipTailSize = 256);
+
+        // Sets the finest mip level that should be resident for a streaming texture, relative to the complete texture.
+        // Has no effect on textures that are not streaming or not finalized yet.
+        void SetDesiredMipLevel(const std::shared_ptr<LoadedTexture>& texture, uint32_t mipLevel);
+
+        // Requests the mip level that matches the texture being displayed with 'screenSizeInPixels' texels
+        // along its larger dimension, such as the projected size of the objects using it.
+        void RequestMipForScreenSize(const std::shared_ptr<LoadedTexture>& texture, float screenSizeInPixels);
+
+        // Returns the finest mip level of the complete texture that is resident on the GPU.
+        // Returns 0 for textures that are not streaming or not finalized yet.
+        [[nodiscard]] static uint32_t GetResidentMipLevel(const std::shared_ptr<LoadedTexture>& texture);
+
+        // Starts reading the mips that have been requested for streaming textures on the thread pool. The data is
+        // uploaded by ProcessRenderingThreadCommands. Textures with fewer mips requested than resident are trimmed
+        // when the cache is over its memory budget.
+        void UpdateMipStreaming(ThreadPool& threadPool);
+
         // Sets the Severity of log messages about textures being loaded.
         void SetInfoLogSeverity(log::Severity value) { m_InfoLogSeverity = value; }
 
         // Sets the Severity of log messages about textures that couldn't be loaded.
         void SetErrorLogSeverity(log::Severity value) { m_ErrorLogSeverity = value; }
 
+        // Sets the amount of memory that the cached textures may occupy, counting both the decoded data
+        // waiting for upload and the GPU textures. 0 means no limit, which is the default.
+        // When the budget is exceeded, textures that are only referenced by the cache are evicted
+        // according to the eviction policy, and they are loaded again from the file system when requested.
+        // Textures referenced by materials or other objects are never evicted, so they may keep the cache
+        // over budget until they are released.
+        void SetMemoryBudget(uint64_t bytes);
+        [[nodiscard]] uint64_t GetMemoryBudget() const;
+
+        void SetEvictionPolicy(TextureEvictionPolicy policy);
+
+        // Evicts the textures over budget now. The budget is also enforced when new textures are requested
+        // or uploaded, but textures become evictable when a scene releases them, which the cache doesn't see.
+        // Returns the number of textures evicted. Evicted textures are removed from the cache immediately,
+        // but their resources are released by the next ProcessRenderingThreadCommands call.
+        uint32_t EnforceMemoryBudget();
+
+        // Evicts all textures that are only referenced by the cache. Returns the number of textures evicted.
+        uint32_t EvictUnusedTextures();
+
+        [[nodiscard]] TextureCacheStats GetStats() const;
+
+        // Resets the hit, miss and eviction counters.
+        void ResetStats();
+
         uint32_t GetNumberOfLoadedTextures() { return m_TexturesLoaded.load(); }
         uint32_t GetNumberOfRequestedTextures() { return m_TexturesRequested.load(); }
         uint32_t GetNumberOfFinalizedTextures() { return m_TexturesFinalized; }
@@ -24,11 +24,16 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 using namespace std::chrono;
@@ -43,6 +48,130 @@ public:
     virtual void Run() = 0;
 };
 
+// Priority lanes of the thread pool. Queued tasks with a higher priority always start before tasks
+// with a lower priority, e.g. texture decoding can be queued as Low to let geometry import finish first.
+enum class ThreadPoolPriority : uint8_t
+{
+    High = 0,
+    Normal,
+    Low,
+
+    Count
+};
+
+// A set of tasks that can be waited on independently from the other tasks in the pool.
+// The group must outlive all tasks added to it, i.e. wait on it before destroying it.
+class ThreadPoolTaskGroup
+{
+public:
+    ThreadPoolTaskGroup() = default;
+    ThreadPoolTaskGroup(const ThreadPoolTaskGroup&) = delete;
+    ThreadPoolTaskGroup& operator=(const ThreadPoolTaskGroup&) = delete;
+
+    // Returns true when all tasks added to the group so far have completed.
+    [[nodiscard]] bool IsDone() const { return m_pendingTasks.load() == 0; }
+
+private:
+    friend class ThreadPool;
+    std::atomic<uint32_t> m_pendingTasks = 0;
+};
+
+// Move-only type-erased function object used for the queued tasks.
+// Small function objects are stored inline, larger ones are allocated on the heap.
+class ThreadPoolJob
+{
+public:
+    static constexpr size_t c_InlineSize = 48;
+
+    ThreadPoolJob() = default;
+
+    template<typename F>
+    ThreadPoolJob(F&& func, ThreadPoolTaskGroup* group)
+        : m_group(group)
+    {
+        using Func = std::decay_t<F>;
+        if constexpr (sizeof(Func) <= c_InlineSize && alignof(Func) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Func>)
+        {
+            new (m_storage) Func(std::forward<F>(func));
+            m_ops = &s_InlineOps<Func>;
+        }
+        else
+        {
+            *reinterpret_cast<Func**>(m_storage) = new Func(std::forward<F>(func));
+            m_ops = &s_HeapOps<Func>;
+        }
+    }
+
+    ThreadPoolJob(ThreadPoolJob&& other) noexcept
+        : m_ops(other.m_ops)
+        , m_group(other.m_group)
+    {
+        if (m_ops)
+            m_ops->move(m_storage, other.m_storage);
+        other.m_ops = nullptr;
+    }
+
+    ThreadPoolJob& operator=(ThreadPoolJob&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_ops = other.m_ops;
+            m_group = other.m_group;
+            if (m_ops)
+                m_ops->move(m_storage, other.m_storage);
+            other.m_ops = nullptr;
+        }
+        return *this;
+    }
+
+    ThreadPoolJob(const ThreadPoolJob&) = delete;
+    ThreadPoolJob& operator=(const ThreadPoolJob&) = delete;
+
+    ~ThreadPoolJob() { Reset(); }
+
+    void operator()() { m_ops->invoke(m_storage); }
+
+    [[nodiscard]] explicit operator bool() const { return m_ops != nullptr; }
+    [[nodiscard]] ThreadPoolTaskGroup* GetGroup() const { return m_group; }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src); // move-constructs dst from src and destroys src
+        void (*destroy)(void* storage);
+    };
+
+    template<typename Func>
+    static constexpr Ops s_InlineOps = {
+        [](void* storage) { (*static_cast<Func*>(storage))(); },
+        [](void* dst, void* src) { new (dst) Func(std::move(*static_cast<Func*>(src))); static_cast<Func*>(src)->~Func(); },
+        [](void* storage) { static_cast<Func*>(storage)->~Func(); }
+    };
+
+    template<typename Func>
+    static constexpr Ops s_HeapOps = {
+        [](void* storage) { (**static_cast<Func**>(storage))(); },
+        [](void* dst, void* src) { *static_cast<Func**>(dst) = *static_cast<Func**>(src); },
+        [](void* storage) { delete *static_cast<Func**>(storage); }
+    };
+
+    void Reset()
+    {
+        if (m_ops)
+            m_ops->destroy(m_storage);
+        m_ops = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[c_InlineSize];
+    const Ops* m_ops = nullptr;
+    ThreadPoolTaskGroup* m_group = nullptr;
+};
+
+// A thread pool with a task queue per worker thread and work stealing.
+// Tasks added from a worker thread go to that worker's queue, other tasks are distributed over all queues.
+// The waiting functions run queued tasks on the calling thread and block when there is nothing to run.
 class ThreadPool
 {
 public:
@@ -51,25 +180,85 @@ public:
 
     // Enqueues a task for execution in the thread pool.
     // If any thread is available, the task immediately starts executing.
-    void AddTask(std::shared_ptr<ThreadPoolTask> const& task);
+    void AddTask(std::shared_ptr<ThreadPoolTask> const& task, ThreadPoolPriority priority = ThreadPoolPriority::Normal);
 
     // Enqueues a function for execution in the thread pool.
     // If any thread is available, the function immediately starts executing.
-    void AddTask(std::function<void()> func);
+    // Exceptions thrown by the function are ignored.
+    template<typename F, typename = std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>>>
+    void AddTask(F&& func, ThreadPoolPriority priority = ThreadPoolPriority::Normal)
+    {
+        Enqueue(ThreadPoolJob(std::forward<F>(func), nullptr), priority);
+    }
+
+    // Enqueues a function as part of a task group, see Wait(ThreadPoolTaskGroup&).
+    template<typename F>
+    void AddTask(ThreadPoolTaskGroup& group, F&& func, ThreadPoolPriority priority = ThreadPoolPriority::Normal)
+    {
+        group.m_pendingTasks.fetch_add(1);
+        Enqueue(ThreadPoolJob(std::forward<F>(func), &group), priority);
+    }
+
+    // Enqueues a function and returns a future for its result, or for the exception that it throws.
+    // Use Wait(future) to help the pool instead of blocking in future.get().
+    template<typename F>
+    [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<F>&>> Submit(F&& func, ThreadPoolPriority priority = ThreadPoolPriority::Normal)
+    {
+        std::packaged_task<std::invoke_result_t<std::decay_t<F>&>()> task(std::forward<F>(func));
+        auto future = task.get_future();
+        Enqueue(ThreadPoolJob([this, task = std::move(task)]() mutable
+        {
+            task();
+            NotifyWaiters();
+        }, nullptr), priority);
+        return future;
+    }
 
     // Waits for all previously added tasks to complete or fail.
     void WaitForTasks();
 
+    // Waits for all tasks in the group to complete or fail.
+    void Wait(ThreadPoolTaskGroup& group);
+
+    // Waits until the future returned by Submit is ready.
+    template<typename T>
+    void Wait(const std::future<T>& future)
+    {
+        WaitUntil([&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+    }
+
+    // Returns the number of worker threads in the pool.
+    [[nodiscard]] uint32_t GetNumThreads() const { return uint32_t(m_threads.size()); }
+
 private:
-    static void StaticThreadProc(ThreadPool* self);
+    static constexpr size_t c_NumPriorities = size_t(ThreadPoolPriority::Count);
+
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<ThreadPoolJob> lanes[c_NumPriorities];
+    };
+
+    static void StaticThreadProc(ThreadPool* self, uint32_t workerIndex);
     void ThreadProc();
 
+    void Enqueue(ThreadPoolJob&& job, ThreadPoolPriority priority);
+    bool TryPopJob(ThreadPoolJob& job);
+    bool RunPendingJob();
+    bool HasQueuedTasks() const;
+    void WaitUntil(std::function<bool()> const& isDone);
+    void NotifyWaiters();
+
     std::vector<std::thread> m_threads;
-    std::queue<std::shared_ptr<ThreadPoolTask>> m_tasks;
+    std::unique_ptr<WorkerQueue[]> m_queues;
+    uint32_t m_numQueues = 0;
+    std::atomic<uint32_t> m_nextQueue = 0;
+    std::atomic<int> m_queuedTasks[c_NumPriorities] = {};
     std::mutex m_mutex;
     std::condition_variable m_forward;
     std::atomic<bool> m_terminate = false;
     std::atomic<int> m_pendingTasks = 0;
+    std::atomic<int> m_sleepingThreads = 0;
 };
 
-}
\ No newline at end of file
+}
@@ -42,6 +42,7 @@ namespace donut::engine
 namespace donut::render
 {
     class GBufferRenderTargets;
+    class LightClusterBuffers;
     
     class DeferredLightingPass
     {
@@ -58,6 +59,7 @@ namespace donut::render
         engine::BindingCache m_BindingSets;
 
         std::shared_ptr<engine::CommonRenderPasses> m_CommonPasses;
+        std::shared_ptr<LightClusterBuffers> m_LightClusters;
 
     protected:
 
@@ -101,5 +103,8 @@ namespace donut::render
             dm::float2 randomOffset = dm::float2::zero());
 
         void ResetBindingCache();
+
+        // Point and spot lights without shadows are shaded through view space clusters, see LightClusterBuffers.
+        [[nodiscard]] LightClusterBuffers& GetLightClusters() const { return *m_LightClusters; }
     };
 }
@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace donut::render
+{
+    struct DrawItem;
+
+    enum class SortKeyField : uint8_t
+    {
+        Material,           // Material::materialID
+        BufferGroup,        // BufferGroup::globalBufferGroupIndex
+        Mesh,               // MeshInfo::globalMeshIndex
+        Instance,           // MeshInstance::GetInstanceIndex
+        Geometry,           // MeshGeometry::globalGeometryIndex
+        CullMode,           // front faces first, then back faces, then double-sided
+        DepthFrontToBack,   // DrawItem::distanceToCamera, increasing
+        DepthBackToFront    // DrawItem::distanceToCamera, decreasing
+    };
+
+    // Describes how the 64-bit sort keys of draw items are built: a list of fields, packed from the most significant
+    // bits down. IDs that don't fit into their fields are truncated to the low bits, which only affects the order
+    // of the items whose truncated IDs collide. Depth fields store the upper bits of the distance as a float,
+    // which is monotonic for positive values, so they don't need a depth range; they can be up to 32 bits wide.
+    class SortKeyLayout
+    {
+    public:
+        static constexpr uint32_t MaxFields = 8;
+
+        struct Field
+        {
+            SortKeyField field;
+            uint8_t bits;
+        };
+
+    private:
+        Field m_Fields[MaxFields] = {};
+        uint32_t m_NumFields = 0;
+        uint32_t m_TotalBits = 0;
+
+    public:
+        // Appends a field below the previous ones. Fields that don't fit into the 64 bits are ignored.
+        SortKeyLayout& Add(SortKeyField field, uint32_t bits);
+
+        [[nodiscard]] uint64_t MakeKey(const DrawItem& item) const;
+
+        // Returns true if the layout contains a depth field, which requires DrawItem::distanceToCamera to be set.
+        [[nodiscard]] bool UsesDepth() const;
+
+        [[nodiscard]] uint32_t GetNumFields() const { return m_NumFields; }
+        [[nodiscard]] const Field& GetField(uint32_t index) const { return m_Fields[index]; }
+
+        bool operator==(const SortKeyLayout& other) const;
+        bool operator!=(const SortKeyLayout& other) const { return !(*this == other); }
+
+        // Minimizes state changes: material, buffer group, mesh, instance.
+        static SortKeyLayout Opaque();
+
+        // Front-to-back for early depth rejection, then the state of Opaque.
+        static SortKeyLayout OpaqueFrontToBack();
+
+        // Back-to-front for blending, with the front faces of double-sided geometry before the back faces.
+        static SortKeyLayout Transparent();
+    };
+
+    // Sorts 64-bit keys with a stable LSD radix sort, 8 bits per pass, and writes the sorted order into 'indices',
+    // as indices into the original key array. Passes where all keys have the same digit are skipped.
+    // The keys are sorted in place; the scratch arrays are resized as needed.
+    void RadixSortKeys(
+        std::vector<uint64_t>& keys,
+        std::vector<uint32_t>& indices,
+        std::vector<uint64_t>& scratchKeys,
+        std::vector<uint32_t>& scratchIndices);
+
+    // Sorts arrays of draw item pointers by their keys. Keeps the scratch memory between calls.
+    class DrawItemSorter
+    {
+    private:
+        std::vector<uint64_t> m_Keys;
+        std::vector<uint64_t> m_ScratchKeys;
+        std::vector<uint32_t> m_Indices;
+        std::vector<uint32_t> m_ScratchIndices;
+        std::vector<const DrawItem*> m_ScratchItems;
+
+    public:
+        // Items with equal keys keep their relative order.
+        void Sort(const DrawItem** items, size_t count, const SortKeyLayout& layout);
+    };
+}
@@ -23,12 +23,17 @@
 #pragma once
 
 #include <donut/engine/SceneGraph.h>
+#include <donut/render/DrawItemSort.h>
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace donut::engine
 {
     class IView;
+    class OcclusionBuffer;
+    class ThreadPool;
 }
 
 namespace donut::render
@@ -44,9 +49,89 @@ namespace donut::render
 
         virtual const DrawItem* GetNextItem() = 0;
 
+        // Prepares the draw items for several views, such as the children of a composite view, in one traversal
+        // of the scene graph. Returns false if the strategy doesn't support that, in which case the caller should
+        // use PrepareForView for each view. After a successful call, use SelectView to choose the view whose
+        // items are returned by GetNextItem.
+        virtual bool PrepareForViews(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView* const* views,
+            uint32_t numViews) { return false; }
+
+        virtual void SelectView(uint32_t viewIndex) { }
+
         virtual ~IDrawStrategy() = default;
     };
 
+    // Retains the draw items of scene subgraphs between frames, so that the draw strategies using it only need to
+    // cull the items instead of walking the graph and sorting them every frame. The lists don't depend on the view
+    // and are shared by all strategies and views that use the same cache, root node and list type.
+    // A list is rebuilt when the structure or content version of its graph changes, or when the domain or the
+    // double-sidedness of one of its materials changes; its instance bounds are updated when the transforms change.
+    // The lists and their items stay valid until the next SceneGraph::Refresh. The lists of destroyed root nodes
+    // are dropped the next time a list is rebuilt.
+    class DrawListCache
+    {
+    public:
+        enum class ListType : uint8_t
+        {
+            Opaque,                         // opaque and alpha-tested geometry, sorted with SortKeyLayout::Opaque
+            Transparent,                    // other geometry, one item per geometry
+            TransparentSeparateDoubleSided  // like Transparent, with two items for double-sided materials
+        };
+
+        struct List
+        {
+            std::vector<DrawItem> items;
+            std::vector<uint32_t> itemInstances; // index of each item's instance in 'instanceNodes'
+            std::vector<dm::box3> itemBounds; // object space bounds of the geometries that are culled individually, empty otherwise
+            std::vector<const engine::SceneGraphNode*> instanceNodes;
+            dm::box3_array instanceBounds; // global bounding boxes of the instance nodes
+
+        private:
+            friend class DrawListCache;
+            struct MaterialState
+            {
+                const engine::Material* material;
+                engine::MaterialDomain domain;
+                bool doubleSided;
+            };
+
+            std::weak_ptr<engine::SceneGraphNode> rootNode;
+            std::vector<MaterialState> materials;
+            uint64_t structureVersion = 0;
+            uint64_t contentVersion = 0;
+            uint64_t transformVersion = 0;
+            bool hasGraph = false;
+        };
+
+        struct Stats
+        {
+            uint32_t rebuilds = 0;
+            uint32_t reuses = 0;
+            uint32_t boundsUpdates = 0;
+        };
+
+    private:
+        std::map<std::pair<const engine::SceneGraphNode*, ListType>, List> m_Lists;
+        Stats m_Stats;
+
+        [[nodiscard]] static bool IsValid(const List& list, const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::SceneGraph* graph);
+        static void Build(List& list, const std::shared_ptr<engine::SceneGraphNode>& rootNode, ListType type);
+        static void UpdateBounds(List& list);
+
+    public:
+        // Returns the list for the subgraph, building or updating it if necessary.
+        const List& GetList(const std::shared_ptr<engine::SceneGraphNode>& rootNode, ListType type);
+
+        void Clear() { m_Lists.clear(); }
+
+        [[nodiscard]] size_t GetListCount() const { return m_Lists.size(); }
+
+        [[nodiscard]] const Stats& GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats = Stats(); }
+    };
+
     class PassthroughDrawStrategy : public IDrawStrategy
     {
     private:
@@ -73,9 +158,27 @@ namespace donut::render
         size_t m_ReadPtr = 0;
         size_t m_ChunkSize = 128;
 
+        // Multi-view mode: complete draw lists for each view, see PrepareForViews
+        bool m_MultiView = false;
+        std::vector<dm::frustum> m_ViewFrustums;
+        std::vector<std::vector<DrawItem>> m_ViewItems;
+        std::vector<std::vector<const DrawItem*>> m_ViewItemPtrs;
+        uint32_t m_CurrentView = 0;
+
+        // Retained mode: m_InstancePtrChunk holds all visible items of the cached list
+        std::shared_ptr<DrawListCache> m_DrawListCache;
+        bool m_Retained = false;
+        std::vector<uint64_t> m_InstanceMask;
+
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Opaque();
+        DrawItemSorter m_Sorter;
+        dm::float3 m_ViewOrigin = 0.f;
+
         void FillChunk();
 
     public:
+        // The largest number of views that PrepareForViews can process in one traversal.
+        static constexpr uint32_t MaxViews = 64;
 
         void PrepareForView(
             const std::shared_ptr<engine::SceneGraphNode>& rootNode,
@@ -83,8 +186,28 @@ namespace donut::render
 
         const DrawItem* GetNextItem() override;
 
+        // Culls the scene graph against all views at once, keeping a mask of the views that each node is visible in,
+        // so that subgraphs are only tested against the views that contain their parent.
+        bool PrepareForViews(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView* const* views,
+            uint32_t numViews) override;
+
+        void SelectView(uint32_t viewIndex) override;
+
+        // Makes the strategy cull the retained lists of the cache instead of walking the scene graph, see DrawListCache.
+        // The same items are visible, but their order differs: the retained list is sorted as a whole, while the walk
+        // only sorts the items within each chunk. Pass NULL to go back to walking the graph.
+        void SetDrawListCache(std::shared_ptr<DrawListCache> cache) { m_DrawListCache = std::move(cache); }
+        [[nodiscard]] const std::shared_ptr<DrawListCache>& GetDrawListCache() const { return m_DrawListCache; }
+
         [[nodiscard]] size_t GetChunkSize() const { return m_ChunkSize; }
         void SetChunkSize(size_t size) { m_ChunkSize = std::max<size_t>(size, 1u); }
+
+        // Sets the order of the items within each chunk, SortKeyLayout::Opaque by default.
+        // Layouts with depth fields use the distance from the view origin to the instance bounding box.
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
     };
 
     class TransparentDrawStrategy : public IDrawStrategy
@@ -93,6 +216,10 @@ namespace donut::render
         std::vector<DrawItem> m_InstancesToDraw;
         std::vector<const DrawItem*> m_InstancePtrsToDraw;
         size_t m_ReadPtr = 0;
+        std::shared_ptr<DrawListCache> m_DrawListCache;
+        std::vector<uint64_t> m_InstanceMask;
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Transparent();
+        DrawItemSorter m_Sorter;
 
     public:
         bool DrawDoubleSidedMaterialsSeparately = true;
@@ -102,5 +229,222 @@ namespace donut::render
             const engine::IView& view) override;
 
         const DrawItem* GetNextItem() override;
+
+        // See InstancedOpaqueDrawStrategy::SetDrawListCache. The visible items are still sorted by distance every time.
+        void SetDrawListCache(std::shared_ptr<DrawListCache> cache) { m_DrawListCache = std::move(cache); }
+        [[nodiscard]] const std::shared_ptr<DrawListCache>& GetDrawListCache() const { return m_DrawListCache; }
+
+        // Sets the order of the items, SortKeyLayout::Transparent by default.
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
+    };
+
+    // Draws the opaque and alpha-tested geometry like InstancedOpaqueDrawStrategy, but culls the mesh instances
+    // with the instance BVH of the scene graph instead of walking the node hierarchy, which works better for
+    // flat or poorly grouped scenes. Falls back to InstancedOpaqueDrawStrategy when the graph has no instance BVH
+    // or when the root node is not the root of the graph.
+    class BVHOpaqueDrawStrategy : public IDrawStrategy
+    {
+    private:
+        InstancedOpaqueDrawStrategy m_Fallback;
+        bool m_UseFallback = false;
+        std::vector<uint32_t> m_VisibleInstances;
+        std::vector<DrawItem> m_InstancesToDraw;
+        std::vector<const DrawItem*> m_InstancePtrsToDraw;
+        size_t m_ReadPtr = 0;
+        engine::InstanceBVH::QueryStats m_QueryStats;
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Opaque();
+        DrawItemSorter m_Sorter;
+
+    public:
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        // Returns the BVH traversal statistics of the last PrepareForView call, or zeros if it used the fallback.
+        [[nodiscard]] const engine::InstanceBVH::QueryStats& GetQueryStats() const { return m_QueryStats; }
+
+        // See InstancedOpaqueDrawStrategy::SetSortKeyLayout. Unlike that strategy, the items are sorted as a whole.
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
+    };
+
+    // The instance BVH version of TransparentDrawStrategy, see BVHOpaqueDrawStrategy.
+    class BVHTransparentDrawStrategy : public IDrawStrategy
+    {
+    private:
+        TransparentDrawStrategy m_Fallback;
+        bool m_UseFallback = false;
+        std::vector<uint32_t> m_VisibleInstances;
+        std::vector<DrawItem> m_InstancesToDraw;
+        std::vector<const DrawItem*> m_InstancePtrsToDraw;
+        size_t m_ReadPtr = 0;
+        engine::InstanceBVH::QueryStats m_QueryStats;
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Transparent();
+        DrawItemSorter m_Sorter;
+
+    public:
+        bool DrawDoubleSidedMaterialsSeparately = true;
+
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        [[nodiscard]] const engine::InstanceBVH::QueryStats& GetQueryStats() const { return m_QueryStats; }
+
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
+    };
+
+    // Draws the opaque and alpha-tested geometry like BVHOpaqueDrawStrategy, but culls the mesh instances of the graph
+    // on the thread pool: the instances are split into fixed ranges of InstancesPerJob, and each job writes the items
+    // of its range into a separate array. The arrays are concatenated in range order and sorted with a stable sort,
+    // so the output only depends on the scene and the view, not on the number of threads or their scheduling.
+    // Falls back to InstancedOpaqueDrawStrategy when the root node is not the root of the graph.
+    class ParallelOpaqueDrawStrategy : public IDrawStrategy
+    {
+    private:
+        engine::ThreadPool* m_ThreadPool = nullptr;
+        InstancedOpaqueDrawStrategy m_Fallback;
+        bool m_UseFallback = false;
+        std::vector<std::vector<DrawItem>> m_JobItems;
+        std::vector<const DrawItem*> m_InstancePtrsToDraw;
+        size_t m_ReadPtr = 0;
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Opaque();
+        DrawItemSorter m_Sorter;
+
+    public:
+        uint32_t InstancesPerJob = 256;
+
+        // If the thread pool is NULL, all ranges are processed on the calling thread.
+        explicit ParallelOpaqueDrawStrategy(engine::ThreadPool* threadPool);
+
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
+    };
+
+    // The parallel version of TransparentDrawStrategy, see ParallelOpaqueDrawStrategy.
+    class ParallelTransparentDrawStrategy : public IDrawStrategy
+    {
+    private:
+        engine::ThreadPool* m_ThreadPool = nullptr;
+        TransparentDrawStrategy m_Fallback;
+        bool m_UseFallback = false;
+        std::vector<std::vector<DrawItem>> m_JobItems;
+        std::vector<const DrawItem*> m_InstancePtrsToDraw;
+        size_t m_ReadPtr = 0;
+        SortKeyLayout m_SortKeyLayout = SortKeyLayout::Transparent();
+        DrawItemSorter m_Sorter;
+
+    public:
+        bool DrawDoubleSidedMaterialsSeparately = true;
+        uint32_t InstancesPerJob = 256;
+
+        explicit ParallelTransparentDrawStrategy(engine::ThreadPool* threadPool);
+
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        void SetSortKeyLayout(const SortKeyLayout& layout) { m_SortKeyLayout = layout; }
+        [[nodiscard]] const SortKeyLayout& GetSortKeyLayout() const { return m_SortKeyLayout; }
+    };
+
+    // Wraps another draw strategy and removes the items that are hidden behind occluders, using an occlusion buffer
+    // that is rasterized on the CPU. The occluders are selected from the opaque items of the wrapped strategy:
+    // items whose meshes have MeshInfo::isOccluder set, and items covering at least OccluderMinScreenCoverage
+    // of the screen. Occluders need CPU side positions and indices, which Scene only keeps for flagged meshes,
+    // see Scene::SetSelectOccluders. The remaining items are returned in the order of the wrapped strategy.
+    class OcclusionCullingDrawStrategy : public IDrawStrategy
+    {
+    private:
+        std::shared_ptr<IDrawStrategy> m_Inner;
+        std::shared_ptr<engine::OcclusionBuffer> m_OcclusionBuffer;
+        engine::ThreadPool* m_ThreadPool = nullptr;
+        std::vector<DrawItem> m_Items;
+        std::vector<dm::box3> m_ItemBounds;
+        std::vector<const DrawItem*> m_VisibleItems;
+        size_t m_ReadPtr = 0;
+        uint32_t m_NumOccluders = 0;
+        uint32_t m_NumCulledItems = 0;
+
+    public:
+        bool Enabled = true;
+        float OccluderMinScreenCoverage = 0.05f;
+        uint32_t MaxOccluders = 64;
+
+        // If a thread pool is provided, it's used to rasterize the occlusion buffer.
+        OcclusionCullingDrawStrategy(std::shared_ptr<IDrawStrategy> inner, engine::ThreadPool* threadPool = nullptr);
+
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        [[nodiscard]] const std::shared_ptr<engine::OcclusionBuffer>& GetOcclusionBuffer() const { return m_OcclusionBuffer; }
+        [[nodiscard]] uint32_t GetNumOccluders() const { return m_NumOccluders; }
+        [[nodiscard]] uint32_t GetNumCulledItems() const { return m_NumCulledItems; }
+    };
+
+    // Wraps another draw strategy and replaces the geometries of the items with the levels of detail of their meshes,
+    // see MeshInfo::lods and GenerateMeshLods. The level of every instance is the coarsest one whose error, projected
+    // to the screen at the distance of the instance bounds, stays below MaxScreenSpaceError pixels. The levels are
+    // remembered per instance and only coarsened with some margin, see SelectMeshLod, so one strategy object
+    // should be used per view. Items whose level geometry was simplified away are dropped.
+    // The remaining items are returned in the order of the wrapped strategy.
+    class LodSelectionDrawStrategy : public IDrawStrategy
+    {
+    public:
+        struct Stats
+        {
+            uint32_t items = 0;
+            uint32_t itemsWithLods = 0;         // items whose meshes have levels of detail
+            uint64_t baseTriangles = 0;         // triangles of the full detail geometries of all items
+            uint64_t drawnTriangles = 0;        // triangles of the selected levels
+            uint32_t instancesPerLod[4] = {};   // the last entry counts all coarser levels too
+        };
+
+    private:
+        struct InstanceState
+        {
+            uint32_t lod = 0;
+            uint32_t lastFrame = 0;
+        };
+
+        std::shared_ptr<IDrawStrategy> m_Inner;
+        std::vector<DrawItem> m_Items;
+        size_t m_ReadPtr = 0;
+        std::unordered_map<const engine::MeshInstance*, InstanceState> m_Instances;
+        uint32_t m_Frame = 0;
+        Stats m_Stats;
+
+    public:
+        bool Enabled = true;
+        float MaxScreenSpaceError = 1.f;
+        float Hysteresis = 0.25f;
+
+        explicit LodSelectionDrawStrategy(std::shared_ptr<IDrawStrategy> inner);
+
+        void PrepareForView(
+            const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+            const engine::IView& view) override;
+
+        const DrawItem* GetNextItem() override;
+
+        // Returns the statistics of the last PrepareForView call.
+        [[nodiscard]] const Stats& GetStats() const { return m_Stats; }
     };
 }
\ No newline at end of file
@@ -42,12 +42,15 @@ namespace donut::engine
 
 namespace donut::render
 {
+    class LightClusterBuffers;
+
     struct ForwardShadingPassPipelineKey
     {
         engine::MaterialDomain domain = engine::MaterialDomain::Opaque;
         nvrhi::RasterCullMode cullMode = nvrhi::RasterCullMode::Back;
         bool frontCounterClockwise = false;
         bool reverseDepth = false;
+        bool compactVertices = false;
         nvrhi::VariableRateShadingState shadingRateState{};
 
         bool operator==(const ForwardShadingPassPipelineKey& other) const
@@ -56,6 +59,7 @@ namespace donut::render
                     cullMode == other.cullMode &&
                     frontCounterClockwise == other.frontCounterClockwise &&
                     reverseDepth == other.reverseDepth &&
+                    compactVertices == other.compactVertices &&
                     shadingRateState == other.shadingRateState;
         }
 
@@ -87,6 +91,7 @@ namespace std
             nvrhi::hash_combine(hash, key.cullMode);
             nvrhi::hash_combine(hash, key.frontCounterClockwise);
             nvrhi::hash_combine(hash, key.reverseDepth);
+            nvrhi::hash_combine(hash, key.compactVertices);
             nvrhi::hash_combine(hash, key.shadingRateState);
             return hash;
         }
@@ -122,6 +127,10 @@ namespace donut::render
             // Using Buffer SRVs is often faster.
             bool useInputAssembler = false;
 
+            // Encoding of the vertex buffers that will be rendered, must match Scene::GetVertexLayout.
+            // Passes created with the compact layout also render the buffer groups that use the full layout.
+            engine::VertexLayout vertexLayout = engine::VertexLayout::Full;
+
             uint32_t numConstantBufferVersions = 16;
         };
 
@@ -130,6 +139,8 @@ namespace donut::render
         nvrhi::DeviceHandle m_Device;
         nvrhi::InputLayoutHandle m_InputLayout;
         nvrhi::ShaderHandle m_VertexShader;
+        nvrhi::InputLayoutHandle m_CompactInputLayout; // only created for the compact vertex layout
+        nvrhi::ShaderHandle m_CompactVertexShader;
         nvrhi::ShaderHandle m_PixelShader;
         nvrhi::ShaderHandle m_PixelShaderTransmissive;
         nvrhi::ShaderHandle m_GeometryShader;
@@ -144,6 +155,7 @@ namespace donut::render
         bool m_TrackLiveness = true;
         bool m_IsDX11 = false;
         bool m_UseInputAssembler = false;
+        engine::VertexLayout m_VertexLayout = engine::VertexLayout::Full;
         std::mutex m_Mutex;
 
         std::unordered_map<ForwardShadingPassPipelineKey, nvrhi::GraphicsPipelineHandle> m_Pipelines;
@@ -152,6 +164,8 @@ namespace donut::render
         
         std::shared_ptr<engine::CommonRenderPasses> m_CommonPasses;
         std::shared_ptr<engine::MaterialBindingCache> m_MaterialBindings;
+        std::shared_ptr<LightClusterBuffers> m_LightClusters;
+        uint32_t m_LightClusterBufferVersion = 0;
         
         virtual nvrhi::ShaderHandle CreateVertexShader(engine::ShaderFactory& shaderFactory, const CreateParameters& params);
         virtual nvrhi::ShaderHandle CreateGeometryShader(engine::ShaderFactory& shaderFactory, const CreateParameters& params);
@@ -177,6 +191,9 @@ namespace donut::render
             const CreateParameters& params);
 
         void ResetBindingCache();
+
+        // Point and spot lights without shadows are shaded through view space clusters, see LightClusterBuffers.
+        [[nodiscard]] LightClusterBuffers& GetLightClusters() const { return *m_LightClusters; }
         
         virtual void PrepareLights(
             Context& context,
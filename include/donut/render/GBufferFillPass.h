@@ -50,10 +50,11 @@ namespace donut::render
                 bool alphaTested : 1;
                 bool frontCounterClockwise : 1;
                 bool reverseDepth : 1;
+                bool compactVertices : 1;
             } bits;
             uint32_t value;
 
-            static constexpr size_t Count = 1 << 5;
+            static constexpr size_t Count = 1 << 6;
         };
 
         class Context : public GeometryPassContext
@@ -86,6 +87,10 @@ namespace donut::render
             // Using Buffer SRVs is often faster.
             bool useInputAssembler = false;
 
+            // Encoding of the vertex buffers that will be rendered, must match Scene::GetVertexLayout.
+            // Passes created with the compact layout also render the buffer groups that use the full layout.
+            engine::VertexLayout vertexLayout = engine::VertexLayout::Full;
+
             uint32_t stencilWriteMask = 0;
             uint32_t numConstantBufferVersions = 16;
         };
@@ -94,6 +99,8 @@ namespace donut::render
         nvrhi::DeviceHandle m_Device;
         nvrhi::InputLayoutHandle m_InputLayout;
         nvrhi::ShaderHandle m_VertexShader;
+        nvrhi::InputLayoutHandle m_CompactInputLayout; // only created for the compact vertex layout
+        nvrhi::ShaderHandle m_CompactVertexShader;
         nvrhi::ShaderHandle m_PixelShader;
         nvrhi::ShaderHandle m_PixelShaderAlphaTested;
         nvrhi::ShaderHandle m_GeometryShader;
@@ -114,6 +121,7 @@ namespace donut::render
         bool m_EnableMotionVectors = false;
         bool m_IsDX11 = false;
         bool m_UseInputAssembler = false;
+        engine::VertexLayout m_VertexLayout = engine::VertexLayout::Full;
         uint32_t m_StencilWriteMask = 0;
         
         virtual nvrhi::ShaderHandle CreateVertexShader(engine::ShaderFactory& shaderFactory, const CreateParameters& params);
@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <donut/engine/LightClusters.h>
+#include <nvrhi/nvrhi.h>
+#include <memory>
+#include <vector>
+
+struct LightClusterConstants;
+
+namespace donut::engine
+{
+    class IView;
+    class Light;
+}
+
+namespace donut::render
+{
+    // Owns the GPU buffers for clustered shading of point and spot lights, which lifts the limit on the number
+    // of lights in ForwardShadingPass and DeferredLightingPass. The clustered lights are stored in a structured
+    // buffer, and their lists for each cluster of the current view are built by engine::LightClusterGrid.
+    // Lights with shadows or with an infinite range are not clustered; the passes keep shading them through
+    // their constant buffers.
+    class LightClusterBuffers
+    {
+    private:
+        nvrhi::DeviceHandle m_Device;
+        engine::LightClusterGrid m_Grid;
+        std::vector<engine::ClusterLight> m_Lights;
+
+        nvrhi::BufferHandle m_LightBuffer;
+        nvrhi::BufferHandle m_ClusterBuffer;
+        nvrhi::BufferHandle m_IndexBuffer;
+        uint32_t m_BufferVersion = 0;
+
+        void ReserveBuffer(nvrhi::BufferHandle& buffer, size_t count, uint32_t stride, const char* debugName);
+
+    public:
+        engine::LightClusterGrid::Desc gridDesc;
+
+        explicit LightClusterBuffers(nvrhi::IDevice* device);
+
+        // Tests if a light is shaded through the clusters rather than through the constant buffer of a pass.
+        [[nodiscard]] static bool IsClusteredLight(const engine::Light& light);
+
+        // Same as above, and fills 'clusterLight' with the bounds of the light if it is clustered.
+        [[nodiscard]] static bool IsClusteredLight(const engine::Light& light, engine::ClusterLight& clusterLight);
+
+        // Uploads the constants of the clustered lights in 'lights', in the order they appear there.
+        // Returns the number of clustered lights.
+        uint32_t SetLights(nvrhi::ICommandList* commandList, const std::vector<std::shared_ptr<engine::Light>>& lights);
+
+        // Bins the clustered lights for a planar view, uploads the cluster light lists and fills the shader constants.
+        void BinLights(nvrhi::ICommandList* commandList, const engine::IView& view, LightClusterConstants& constants);
+
+        // Fills the shader constants for views that are not binned, such as cube maps:
+        // the shaders then loop over all clustered lights.
+        void FillUnbinnedConstants(LightClusterConstants& constants) const;
+
+        [[nodiscard]] uint32_t GetNumLights() const { return uint32_t(m_Lights.size()); }
+        [[nodiscard]] const engine::LightClusterGrid& GetGrid() const { return m_Grid; }
+        [[nodiscard]] nvrhi::IBuffer* GetLightBuffer() const { return m_LightBuffer; }
+        [[nodiscard]] nvrhi::IBuffer* GetClusterBuffer() const { return m_ClusterBuffer; }
+        [[nodiscard]] nvrhi::IBuffer* GetIndexBuffer() const { return m_IndexBuffer; }
+
+        // Incremented when any of the buffers is recreated, binding sets that use them must be recreated as well.
+        [[nodiscard]] uint32_t GetBufferVersion() const { return m_BufferVersion; }
+    };
+}
@@ -25,6 +25,9 @@
 
 #include "material_cb.h"
 
+// Positions, texture coordinates and joint weights use the compact vertex layout, see donut::engine::VertexLayout.
+static const uint GeometryFlags_CompactVertices = 0x00000001u;
+
 struct GeometryData
 {
     uint numIndices;
@@ -43,7 +46,7 @@ struct GeometryData
     uint curveRadiusOffset;
 
     uint materialIndex;
-    uint pad0;
+    uint flags;
     uint pad1;
     uint pad2;
 };
@@ -78,6 +81,9 @@ static const uint c_SizeOfNormal = 4;
 static const uint c_SizeOfJointIndices = 8;
 static const uint c_SizeOfJointWeights = 16;
 static const uint c_SizeOfCurveRadius = 4;
+static const uint c_SizeOfCompactPosition = 8;
+static const uint c_SizeOfCompactTexcoord = 4;
+static const uint c_SizeOfCompactJointWeights = 4;
 
 // Define the sizes of these structures because FXC doesn't support sizeof(x)
 static const uint c_SizeOfGeometryData = 4*16;
@@ -105,7 +111,7 @@ GeometryData LoadGeometryData(ByteAddressBuffer buffer, uint offset)
     ret.tangentOffset = c.z;
     ret.curveRadiusOffset = c.w;
     ret.materialIndex = d.x;
-    ret.pad0 = d.y;
+    ret.flags = d.y;
     ret.pad1 = d.z;
     ret.pad2 = d.w;
     return ret;
@@ -131,6 +137,28 @@ InstanceData LoadInstanceData(ByteAddressBuffer buffer, uint offset)
     return ret;
 }
 
+// Vertex stream loads for both vertex layouts, see GeometryFlags_CompactVertices.
+// 'offset' points at the first vertex of the stream.
+float3 LoadVertexPosition(ByteAddressBuffer buffer, uint offset, uint index, bool compact)
+{
+    if (compact)
+    {
+        uint2 packed = buffer.Load2(offset + index * c_SizeOfCompactPosition);
+        return f16tof32(uint3(packed.x, packed.x >> 16, packed.y));
+    }
+    return asfloat(buffer.Load3(offset + index * c_SizeOfPosition));
+}
+
+float2 LoadVertexTexCoord(ByteAddressBuffer buffer, uint offset, uint index, bool compact)
+{
+    if (compact)
+    {
+        uint packed = buffer.Load(offset + index * c_SizeOfCompactTexcoord);
+        return f16tof32(uint2(packed, packed >> 16));
+    }
+    return asfloat(buffer.Load2(offset + index * c_SizeOfTexcoord));
+}
+
 MaterialConstants LoadMaterialConstants(ByteAddressBuffer buffer, uint offset)
 {
     uint4 a = buffer.Load4(offset + 16 * 0);
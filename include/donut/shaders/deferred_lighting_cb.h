@@ -24,6 +24,7 @@
 #define DEFERRED_LIGHTING_CB_H
 
 #include "light_cb.h"
+#include "light_cluster_cb.h"
 #include "view_cb.h"
 
 #define DEFERRED_MAX_LIGHTS 16
@@ -51,6 +52,8 @@ struct DeferredLightingConstants
 
     float4      noisePattern[4];
 
+    LightClusterConstants lightClusters;
+
     LightConstants lights[DEFERRED_MAX_LIGHTS];
     ShadowConstants shadows[DEFERRED_MAX_SHADOWS];
     LightProbeConstants lightProbes[DEFERRED_MAX_LIGHT_PROBES];
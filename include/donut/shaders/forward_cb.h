@@ -24,6 +24,7 @@
 #define FORWARD_CB_H
 
 #include "light_cb.h"
+#include "light_cluster_cb.h"
 #include "view_cb.h"
 
 #define FORWARD_MAX_LIGHTS 16
@@ -47,6 +48,9 @@
 
 #define FORWARD_SPACE_VIEW 2
 #define FORWARD_BINDING_VIEW_CONSTANTS 2
+#define FORWARD_BINDING_LIGHT_CLUSTERS 24
+#define FORWARD_BINDING_LIGHT_INDICES 25
+#define FORWARD_BINDING_CLUSTERED_LIGHTS 26
 
 #define FORWARD_SPACE_SHADING 3
 #define FORWARD_BINDING_LIGHT_CONSTANTS 3
@@ -63,6 +67,7 @@
 struct ForwardShadingViewConstants
 {
     PlanarViewConstants view;
+    LightClusterConstants lightClusters;
 };
 
 struct ForwardShadingLightConstants
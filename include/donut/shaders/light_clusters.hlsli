@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef LIGHT_CLUSTERS_HLSLI
+#define LIGHT_CLUSTERS_HLSLI
+
+#include "light_cluster_cb.h"
+#include "lighting.hlsli"
+
+// Returns the index of the cluster that contains a surface, given its window position and view space depth.
+// Matches engine::LightClusterGrid::GetClusterIndex and GetSliceIndex.
+uint GetLightClusterIndex(LightClusterConstants clusters, float2 windowPosition, float viewDepth)
+{
+    float2 tile = clamp(windowPosition * clusters.tileScale + clusters.tileBias, 0, float2(clusters.gridSize.xy - 1));
+    float slice = floor(log2(max(viewDepth, 1e-6)) * clusters.sliceScale + clusters.sliceBias);
+    uint sliceIndex = uint(clamp(slice, 0, float(clusters.gridSize.z - 1)));
+
+    return (sliceIndex * clusters.gridSize.y + uint(tile.y)) * clusters.gridSize.x + uint(tile.x);
+}
+
+// Accumulates the radiance from the clustered point and spot lights that reach a surface.
+// Clustered lights have no shadows, see render::LightClusterBuffers::IsClusteredLight.
+void ShadeClusteredLights(
+    LightClusterConstants clusters,
+    StructuredBuffer<uint2> lightClusters,
+    StructuredBuffer<uint> lightIndices,
+    StructuredBuffer<LightConstants> lights,
+    float2 windowPosition,
+    float viewDepth,
+    MaterialSample surfaceMaterial,
+    float3 surfaceWorldPos,
+    float3 viewIncident,
+    inout float3 diffuseTerm,
+    inout float3 specularTerm)
+{
+    bool binned = clusters.gridSize.x != 0;
+
+    // x = offset into the light index buffer, y = number of lights
+    uint2 clusterLights = uint2(0, clusters.numClusteredLights);
+    if (binned)
+        clusterLights = lightClusters[GetLightClusterIndex(clusters, windowPosition, viewDepth)];
+
+    [loop]
+    for (uint nLight = 0; nLight < clusterLights.y; nLight++)
+    {
+        uint lightIndex = binned ? lightIndices[clusterLights.x + nLight] : nLight;
+        LightConstants light = lights[lightIndex];
+
+        float3 diffuseRadiance, specularRadiance;
+        ShadeSurface(light, surfaceMaterial, surfaceWorldPos, viewIncident, diffuseRadiance, specularRadiance);
+
+        diffuseTerm += diffuseRadiance * light.color;
+        specularTerm += specularRadiance * light.color;
+    }
+}
+
+#endif // LIGHT_CLUSTERS_HLSLI
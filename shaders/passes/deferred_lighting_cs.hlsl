@@ -24,6 +24,7 @@
 
 #include <donut/shaders/gbuffer.hlsli>
 #include <donut/shaders/lighting.hlsli>
+#include <donut/shaders/light_clusters.hlsli>
 #include <donut/shaders/shadows.hlsli>
 #include <donut/shaders/deferred_lighting_cb.h>
 #include <donut/shaders/binding_helpers.hlsli>
@@ -37,6 +38,9 @@ Texture2DArray t_ShadowMapArray : register(t0);
 TextureCubeArray t_DiffuseLightProbe : register(t1);
 TextureCubeArray t_SpecularLightProbe : register(t2);
 Texture2D t_EnvironmentBrdf : register(t3);
+StructuredBuffer<uint2> t_LightClusters : register(t4);
+StructuredBuffer<uint> t_LightIndices : register(t5);
+StructuredBuffer<LightConstants> t_ClusteredLights : register(t6);
 
 SamplerState s_ShadowSampler : register(s0);
 SamplerComparisonState s_ShadowSamplerComparison : register(s1);
@@ -144,6 +148,10 @@ void main(int2 i_globalIdx : SV_DispatchThreadID)
         specularTerm += (shadow.x * specularRadiance) * light.color;
     }
 
+    float viewDepth = mul(float4(surfaceWorldPos, 1), g_Deferred.view.matWorldToView).z;
+    ShadeClusteredLights(g_Deferred.lightClusters, t_LightClusters, t_LightIndices, t_ClusteredLights,
+        float2(pixelPosition) + 0.5, viewDepth, surfaceMaterial, surfaceWorldPos, viewIncident, diffuseTerm, specularTerm);
+
     float ambientOcclusion = 1;
     if (g_Deferred.enableAmbientOcclusion != 0)
     {
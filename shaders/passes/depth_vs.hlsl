@@ -74,8 +74,8 @@ void buffer_loads(
     const InstanceData instance = t_Instances[i_instance];
 #endif
 
-    float3 pos = asfloat(t_Vertices.Load3(g_Push.positionOffset + i_vertex * c_SizeOfPosition));
-    float2 texCoord = asfloat(t_Vertices.Load2(g_Push.texCoordOffset + i_vertex * c_SizeOfTexcoord));
+    float3 pos = LoadVertexPosition(t_Vertices, g_Push.positionOffset, i_vertex, COMPACT_VERTICES);
+    float2 texCoord = LoadVertexTexCoord(t_Vertices, g_Push.texCoordOffset, i_vertex, COMPACT_VERTICES);
  
     float3 worldPos = mul(instance.transform, float4(pos, 1.0));
     o_texCoord = texCoord;
@@ -44,6 +44,7 @@
 #include <donut/shaders/material_bindings.hlsli>
 #include <donut/shaders/forward_vertex.hlsli>
 #include <donut/shaders/lighting.hlsli>
+#include <donut/shaders/light_clusters.hlsli>
 #include <donut/shaders/shadows.hlsli>
 #include <donut/shaders/binding_helpers.hlsli>
 
@@ -55,6 +56,10 @@ TextureCubeArray t_DiffuseLightProbe  : REGISTER_SRV(FORWARD_BINDING_DIFFUSE_LIG
 TextureCubeArray t_SpecularLightProbe : REGISTER_SRV(FORWARD_BINDING_SPECULAR_LIGHT_PROBE_TEXTURE,  FORWARD_SPACE_SHADING);
 Texture2D t_EnvironmentBrdf           : REGISTER_SRV(FORWARD_BINDING_ENVIRONMENT_BRDF_TEXTURE,      FORWARD_SPACE_SHADING);
 
+StructuredBuffer<uint2> t_LightClusters          : REGISTER_SRV(FORWARD_BINDING_LIGHT_CLUSTERS,    FORWARD_SPACE_VIEW);
+StructuredBuffer<uint> t_LightIndices            : REGISTER_SRV(FORWARD_BINDING_LIGHT_INDICES,     FORWARD_SPACE_VIEW);
+StructuredBuffer<LightConstants> t_ClusteredLights : REGISTER_SRV(FORWARD_BINDING_CLUSTERED_LIGHTS, FORWARD_SPACE_VIEW);
+
 SamplerState s_ShadowSampler          : REGISTER_SAMPLER(FORWARD_BINDING_SHADOW_MAP_SAMPLER,        FORWARD_SPACE_SHADING);
 SamplerState s_LightProbeSampler      : REGISTER_SAMPLER(FORWARD_BINDING_LIGHT_PROBE_SAMPLER,       FORWARD_SPACE_SHADING);
 SamplerState s_BrdfSampler            : REGISTER_SAMPLER(FORWARD_BINDING_ENVIRONMENT_BRDF_SAMPLER,  FORWARD_SPACE_SHADING);
@@ -138,6 +143,10 @@ void main(
         specularTerm += (shadow.x * specularRadiance) * light.color;
     }
 
+    float viewDepth = mul(float4(surfaceWorldPos, 1), g_ForwardView.view.matWorldToView).z;
+    ShadeClusteredLights(g_ForwardView.lightClusters, t_LightClusters, t_LightIndices, t_ClusteredLights,
+        i_position.xy, viewDepth, surfaceMaterial, surfaceWorldPos, viewIncident, diffuseTerm, specularTerm);
+
     float NdotV = saturate(-dot(surfaceMaterial.shadingNormal, viewIncident));
 
     if(g_ForwardLight.numLightProbes > 0)
@@ -82,8 +82,8 @@ void buffer_loads(
     const InstanceData instance = t_Instances[i_instance];
 #endif
 
-    float3 pos = asfloat(t_Vertices.Load3(g_Push.positionOffset + i_vertex * c_SizeOfPosition));
-    float2 texCoord = asfloat(t_Vertices.Load2(g_Push.texCoordOffset + i_vertex * c_SizeOfTexcoord));
+    float3 pos = LoadVertexPosition(t_Vertices, g_Push.positionOffset, i_vertex, COMPACT_VERTICES);
+    float2 texCoord = LoadVertexTexCoord(t_Vertices, g_Push.texCoordOffset, i_vertex, COMPACT_VERTICES);
     uint packedNormal = t_Vertices.Load(g_Push.normalOffset + i_vertex * c_SizeOfNormal);
     uint packedTangent = t_Vertices.Load(g_Push.tangentOffset + i_vertex * c_SizeOfNormal);
     float3 normal = Unpack_RGB8_SNORM(packedNormal);
@@ -34,13 +34,31 @@ RWByteAddressBuffer u_VertexBuffer : register(u0);
 
 DECLARE_PUSH_CONSTANTS(SkinningConstants, g_Const, 0, 0);
 
+void StorePosition(uint offset, uint index, bool compact, float3 position)
+{
+	if (compact)
+		u_VertexBuffer.Store2(index * c_SizeOfCompactPosition + offset, Pack_R16G16B16A16_FLOAT(float4(position, 1.0)));
+	else
+		u_VertexBuffer.Store3(index * c_SizeOfPosition + offset, asuint(position));
+}
+
+void StoreTexCoord(uint offset, uint index, bool compact, float2 texCoord)
+{
+	if (compact)
+		u_VertexBuffer.Store(index * c_SizeOfCompactTexcoord + offset, Pack_R16G16_FLOAT(texCoord));
+	else
+		u_VertexBuffer.Store2(index * c_SizeOfTexcoord + offset, asuint(texCoord));
+}
+
 [numthreads(256, 1, 1)]
 void main(in uint i_globalIdx : SV_DispatchThreadID)
 {
 	if (i_globalIdx >= g_Const.numVertices)
 		return;
 
-	float3 position = asfloat(t_VertexBuffer.Load3(i_globalIdx * c_SizeOfPosition + g_Const.inputPositionOffset));
+	const bool compact = (g_Const.flags & SkinningFlag_CompactVertices) != 0;
+
+	float3 position = LoadVertexPosition(t_VertexBuffer, g_Const.inputPositionOffset, i_globalIdx, compact);
 	float4 normal = 0;
 	float4 tangent = 0;
 	float2 texCoord1 = 0;
@@ -53,16 +71,20 @@ void main(in uint i_globalIdx : SV_DispatchThreadID)
 		tangent = Unpack_RGBA8_SNORM(t_VertexBuffer.Load(i_globalIdx * c_SizeOfNormal + g_Const.inputTangentOffset));
 
 	if (g_Const.flags & SkinningFlag_TexCoord1)
-		texCoord1 = asfloat(t_VertexBuffer.Load2(i_globalIdx * c_SizeOfTexcoord + g_Const.inputTexCoord1Offset));
+		texCoord1 = LoadVertexTexCoord(t_VertexBuffer, g_Const.inputTexCoord1Offset, i_globalIdx, compact);
 
 	if (g_Const.flags & SkinningFlag_TexCoord2)
-		texCoord2 = asfloat(t_VertexBuffer.Load2(i_globalIdx * c_SizeOfTexcoord + g_Const.inputTexCoord2Offset));
+		texCoord2 = LoadVertexTexCoord(t_VertexBuffer, g_Const.inputTexCoord2Offset, i_globalIdx, compact);
 
 	uint2 jointIndicesPacked = t_VertexBuffer.Load2(i_globalIdx * c_SizeOfJointIndices + g_Const.inputJointIndexOffset);
 	uint4 jointIndices = uint4(
 		jointIndicesPacked.x & 0xffff, jointIndicesPacked.x >> 16,
 		jointIndicesPacked.y & 0xffff, jointIndicesPacked.y >> 16);
-	float4 jointWeights = asfloat(t_VertexBuffer.Load4(i_globalIdx * c_SizeOfJointWeights + g_Const.inputJointWeightOffset));
+	float4 jointWeights;
+	if (compact)
+		jointWeights = Unpack_R8G8B8A8_UFLOAT(t_VertexBuffer.Load(i_globalIdx * c_SizeOfCompactJointWeights + g_Const.inputJointWeightOffset));
+	else
+		jointWeights = asfloat(t_VertexBuffer.Load4(i_globalIdx * c_SizeOfJointWeights + g_Const.inputJointWeightOffset));
 
 	float4x4 jointMatrix = 0;
 	[unroll]
@@ -87,11 +109,13 @@ void main(in uint i_globalIdx : SV_DispatchThreadID)
 	float3 prevPosition;
 	if (g_Const.flags & SkinningFlag_FirstFrame) 
 		prevPosition = position;
+	else if (compact)
+		prevPosition = Unpack_R16G16B16A16_FLOAT(u_VertexBuffer.Load2(i_globalIdx * c_SizeOfCompactPosition + g_Const.outputPositionOffset)).xyz;
 	else
 		prevPosition = asfloat(u_VertexBuffer.Load3(i_globalIdx * c_SizeOfPosition + g_Const.outputPositionOffset));
-	u_VertexBuffer.Store3(i_globalIdx * c_SizeOfPosition + g_Const.outputPrevPositionOffset, asuint(prevPosition));
+	StorePosition(g_Const.outputPrevPositionOffset, i_globalIdx, compact, prevPosition);
 
-	u_VertexBuffer.Store3(i_globalIdx * c_SizeOfPosition + g_Const.outputPositionOffset, asuint(position));
+	StorePosition(g_Const.outputPositionOffset, i_globalIdx, compact, position);
 	
 	if (g_Const.flags & SkinningFlag_Normals)
 		u_VertexBuffer.Store(i_globalIdx * c_SizeOfNormal + g_Const.outputNormalOffset, Pack_RGBA8_SNORM(normal));
@@ -100,8 +124,8 @@ void main(in uint i_globalIdx : SV_DispatchThreadID)
 		u_VertexBuffer.Store(i_globalIdx * c_SizeOfNormal + g_Const.outputTangentOffset, Pack_RGBA8_SNORM(tangent));
 	
 	if (g_Const.flags & SkinningFlag_TexCoord1)
-		u_VertexBuffer.Store2(i_globalIdx * c_SizeOfTexcoord + g_Const.outputTexCoord1Offset, asuint(texCoord1));
+		StoreTexCoord(g_Const.outputTexCoord1Offset, i_globalIdx, compact, texCoord1);
 
 	if (g_Const.flags & SkinningFlag_TexCoord2)
-		u_VertexBuffer.Store2(i_globalIdx * c_SizeOfTexcoord + g_Const.outputTexCoord2Offset, asuint(texCoord2));
+		StoreTexCoord(g_Const.outputTexCoord2Offset, i_globalIdx, compact, texCoord2);
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <donut/app/ApplicationBase.h>
 #include <donut/core/log.h>
 #include <donut/core/string_utils.h>
+#include <donut/core/vfs/Compression.h>
 #include <donut/core/vfs/TarFile.h>
 
 #include <unordered_set>
@@ -43,7 +44,7 @@ MediaFileSystem::MediaFileSystem(
 	if (nativeFS)
 	{
 		std::vector<std::string> packs;
-		if (mediafs->enumerateFiles("", { ".tar" }, vfs::enumerate_to_vector(packs)) > 0)
+		if (mediafs->enumerateFiles("", { ".tar", ".pkz" }, vfs::enumerate_to_vector(packs)) > 0)
 		{
 			// sort the packs in reverse because want to search
 			// from 'highest revision' of a pack file down (ex: pack2.pkz is
@@ -63,6 +64,15 @@ MediaFileSystem::MediaFileSystem(
 						mounted = true;
 					}
 				}
+				else if (string_utils::ends_with(fileName, ".pkz"))
+				{
+					// compressed packages are tar archives with entries compressed by the donut_pack tool
+					if (auto packfs = std::make_shared<TarFile>(filePath); packfs->isOpen())
+					{
+						m_FileSystems.push_back(std::make_shared<CompressionLayer>(packfs));
+						mounted = true;
+					}
+				}
 				else
 				{
 					log::warning("Cannot mount '%s': unsupported format. Skipping.", filePath.string().c_str());
@@ -118,6 +128,31 @@ std::shared_ptr<IBlob> MediaFileSystem::readFile(const std::filesystem::path & n
 	return nullptr;
 }
 
+std::shared_ptr<IBlob> MediaFileSystem::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+	// the range is read from the first file system that has the file, even if the range is outside of that file
+	for (const auto& fs : m_FileSystems)
+		if (fs->fileExists(name))
+			return fs->readFileRange(name, offset, size);
+	return nullptr;
+}
+
+bool MediaFileSystem::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+	for (const auto& fs : m_FileSystems)
+		if (fs->fileExists(name))
+			return fs->getFileLocation(name, location);
+	return false;
+}
+
+bool MediaFileSystem::getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes)
+{
+	for (const auto& fs : m_FileSystems)
+		if (fs->fileExists(name))
+			return fs->getFileAttributes(name, attributes);
+	return false;
+}
+
 bool MediaFileSystem::writeFile(const std::filesystem::path & name, const void* data, size_t size)
 {
 	for (const auto& fs : m_FileSystems)
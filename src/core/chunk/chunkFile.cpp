@@ -133,6 +133,7 @@ std::shared_ptr<ChunkFile const> ChunkFile::deserialize(
         if (!header.isValid())
         {
             log::error("ChunkFile '%s' : invalid chunkfile signature", filepath);
+            return nullptr;
         }
 
         uint32_t nchunks = header.chunkCount;
@@ -361,6 +361,9 @@ std::shared_ptr<MeshSetBase> ChunkReader::loadMeshSetChunk_0x100(Chunk const * c
 
         set->meshInfos=nullptr;
 
+        set->maxVerts = desc.meshletMaxVerts;
+        set->maxPrims = desc.meshletMaxPrims;
+
         handle = {"Indices32", UINT32, VARY_NONE, INDEX, 0, sizeof(uint32_t), nullptr};
         if (loadStreamChunk_0x100(desc.streamChunkIds[Desc::MESHLET_INDICES32], &handle))
         {
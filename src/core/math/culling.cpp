@@ -0,0 +1,369 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/core/math/math.h>
+#include <algorithm>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define CULLING_X64 1
+
+    #ifdef _MSC_VER
+    #include <intrin.h>
+    #endif
+    #include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define CULLING_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace donut::math
+{
+    void box3_array::clear()
+    {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+    }
+
+    void box3_array::reserve(size_t count)
+    {
+        minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+        maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+    }
+
+    void box3_array::push_back(const box3& box)
+    {
+        minX.push_back(box.m_mins.x); minY.push_back(box.m_mins.y); minZ.push_back(box.m_mins.z);
+        maxX.push_back(box.m_maxs.x); maxY.push_back(box.m_maxs.y); maxZ.push_back(box.m_maxs.z);
+    }
+
+    void box3_array::push_back(const box3& localBox, const affine3& transform)
+    {
+        push_back(localBox * transform);
+    }
+
+    box3 box3_array::get(size_t index) const
+    {
+        return box3(
+            float3(minX[index], minY[index], minZ[index]),
+            float3(maxX[index], maxY[index], maxZ[index]));
+    }
+
+    void box3_array::set(size_t index, const box3& box)
+    {
+        minX[index] = box.m_mins.x; minY[index] = box.m_mins.y; minZ[index] = box.m_mins.z;
+        maxX[index] = box.m_maxs.x; maxY[index] = box.m_maxs.y; maxZ[index] = box.m_maxs.z;
+    }
+
+    // A frustum plane with the box coordinate arrays that give the box corner closest to the inside of the plane,
+    // which is the corner that frustum::intersectsWith tests.
+    struct culling_plane
+    {
+        float nx, ny, nz, d;
+        const float* x;
+        const float* y;
+        const float* z;
+    };
+
+    static void setupCullingPlanes(const frustum& f, const box3_array& boxes, culling_plane* planes)
+    {
+        for (int i = 0; i < frustum::PLANES_COUNT; i++)
+        {
+            const plane& p = f.planes[i];
+            culling_plane& cp = planes[i];
+            cp.nx = p.normal.x;
+            cp.ny = p.normal.y;
+            cp.nz = p.normal.z;
+            cp.d = p.distance;
+            cp.x = p.normal.x > 0 ? boxes.minX.data() : boxes.maxX.data();
+            cp.y = p.normal.y > 0 ? boxes.minY.data() : boxes.maxY.data();
+            cp.z = p.normal.z > 0 ? boxes.minZ.data() : boxes.maxZ.data();
+        }
+    }
+
+    // The kernels test up to 64 boxes starting at 'first' and return a mask of the visible ones.
+    // The plane distance is computed in the same order as frustum::intersectsWith, so the results are identical.
+    typedef uint64_t (*culling_kernel)(const culling_plane* planes, size_t first, size_t count);
+
+    static uint64_t cullKernelScalar(const culling_plane* planes, size_t first, size_t count)
+    {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t b = first + i;
+            bool visible = true;
+            for (int p = 0; p < frustum::PLANES_COUNT; p++)
+            {
+                const culling_plane& cp = planes[p];
+                float distance = cp.nx * cp.x[b] + cp.ny * cp.y[b] + cp.nz * cp.z[b] - cp.d;
+                if (distance > 0.f)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                mask |= uint64_t(1) << i;
+        }
+        return mask;
+    }
+
+#if CULLING_X64
+    static uint64_t cullKernelSSE(const culling_plane* planes, size_t first, size_t count)
+    {
+        const __m128 zero = _mm_setzero_ps();
+
+        uint64_t mask = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            size_t b = first + i;
+            __m128 outside = zero;
+            for (int p = 0; p < frustum::PLANES_COUNT; p++)
+            {
+                const culling_plane& cp = planes[p];
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(cp.nx), _mm_loadu_ps(cp.x + b)),
+                        _mm_mul_ps(_mm_set1_ps(cp.ny), _mm_loadu_ps(cp.y + b))),
+                    _mm_mul_ps(_mm_set1_ps(cp.nz), _mm_loadu_ps(cp.z + b)));
+                distance = _mm_sub_ps(distance, _mm_set1_ps(cp.d));
+                outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, zero));
+
+                if (_mm_movemask_ps(outside) == 0xf)
+                    break;
+            }
+
+            mask |= uint64_t(~_mm_movemask_ps(outside) & 0xf) << i;
+        }
+
+        if (i < count)
+            mask |= cullKernelScalar(planes, first + i, count - i) << i;
+
+        return mask;
+    }
+
+    DONUT_TARGET_AVX2 static uint64_t cullKernelAVX2(const culling_plane* planes, size_t first, size_t count)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+
+        uint64_t mask = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            size_t b = first + i;
+            __m256 outside = zero;
+            for (int p = 0; p < frustum::PLANES_COUNT; p++)
+            {
+                const culling_plane& cp = planes[p];
+                __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(
+                        _mm256_mul_ps(_mm256_set1_ps(cp.nx), _mm256_loadu_ps(cp.x + b)),
+                        _mm256_mul_ps(_mm256_set1_ps(cp.ny), _mm256_loadu_ps(cp.y + b))),
+                    _mm256_mul_ps(_mm256_set1_ps(cp.nz), _mm256_loadu_ps(cp.z + b)));
+                distance = _mm256_sub_ps(distance, _mm256_set1_ps(cp.d));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, zero, _CMP_GT_OQ));
+
+                if (_mm256_movemask_ps(outside) == 0xff)
+                    break;
+            }
+
+            mask |= uint64_t(~_mm256_movemask_ps(outside) & 0xff) << i;
+        }
+
+        if (i < count)
+            mask |= cullKernelSSE(planes, first + i, count - i) << i;
+
+        return mask;
+    }
+#endif // CULLING_X64
+
+#if CULLING_NEON
+    static uint64_t cullKernelNEON(const culling_plane* planes, size_t first, size_t count)
+    {
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        const uint32_t laneBitsData[4] = { 1, 2, 4, 8 };
+        const uint32x4_t laneBits = vld1q_u32(laneBitsData);
+
+        uint64_t mask = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            size_t b = first + i;
+            uint32x4_t outside = vdupq_n_u32(0);
+            for (int p = 0; p < frustum::PLANES_COUNT; p++)
+            {
+                const culling_plane& cp = planes[p];
+                float32x4_t distance = vaddq_f32(
+                    vaddq_f32(
+                        vmulq_n_f32(vld1q_f32(cp.x + b), cp.nx),
+                        vmulq_n_f32(vld1q_f32(cp.y + b), cp.ny)),
+                    vmulq_n_f32(vld1q_f32(cp.z + b), cp.nz));
+                distance = vsubq_f32(distance, vdupq_n_f32(cp.d));
+                outside = vorrq_u32(outside, vcgtq_f32(distance, zero));
+
+                if (vminvq_u32(outside) != 0)
+                    break;
+            }
+
+            uint32_t outsideBits = vaddvq_u32(vandq_u32(outside, laneBits));
+            mask |= uint64_t(~outsideBits & 0xf) << i;
+        }
+
+        if (i < count)
+            mask |= cullKernelScalar(planes, first + i, count - i) << i;
+
+        return mask;
+    }
+#endif // CULLING_NEON
+
+    static bool isCullingSimdLevelSupported(simd_level level)
+    {
+        switch (level)
+        {
+        case simd_level::scalar:
+            return true;
+#if CULLING_X64
+        case simd_level::sse:
+            return true;
+        case simd_level::avx2:
+            return isAVX2Supported();
+#endif
+#if CULLING_NEON
+        case simd_level::neon:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    simd_level getBestCullingSimdLevel()
+    {
+#if CULLING_X64
+        return isAVX2Supported() ? simd_level::avx2 : simd_level::sse;
+#elif CULLING_NEON
+        return simd_level::neon;
+#else
+        return simd_level::scalar;
+#endif
+    }
+
+    static simd_level g_CullingSimdLevel = getBestCullingSimdLevel();
+
+    void setCullingSimdLevel(simd_level level)
+    {
+        g_CullingSimdLevel = isCullingSimdLevelSupported(level) ? level : getBestCullingSimdLevel();
+    }
+
+    simd_level getCullingSimdLevel()
+    {
+        return g_CullingSimdLevel;
+    }
+
+    static culling_kernel getCullingKernel()
+    {
+        switch (g_CullingSimdLevel)
+        {
+#if CULLING_X64
+        case simd_level::sse:
+            return cullKernelSSE;
+        case simd_level::avx2:
+            return cullKernelAVX2;
+#endif
+#if CULLING_NEON
+        case simd_level::neon:
+            return cullKernelNEON;
+#endif
+        default:
+            return cullKernelScalar;
+        }
+    }
+
+    static uint32_t lowestBitIndex(uint64_t x)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return uint32_t(index);
+#else
+        return uint32_t(__builtin_ctzll(x));
+#endif
+    }
+
+    size_t cullBoxes(const frustum& f, const box3_array& boxes, uint32_t* visibleIndices)
+    {
+        culling_plane planes[frustum::PLANES_COUNT];
+        setupCullingPlanes(f, boxes, planes);
+        culling_kernel kernel = getCullingKernel();
+
+        size_t numVisible = 0;
+        for (size_t first = 0; first < boxes.size(); first += 64)
+        {
+            uint64_t mask = kernel(planes, first, std::min<size_t>(64, boxes.size() - first));
+            while (mask)
+            {
+                visibleIndices[numVisible++] = uint32_t(first + lowestBitIndex(mask));
+                mask &= mask - 1;
+            }
+        }
+
+        return numVisible;
+    }
+
+    void cullBoxesMask(const frustum& f, const box3_array& boxes, uint64_t* visibilityMask)
+    {
+        culling_plane planes[frustum::PLANES_COUNT];
+        setupCullingPlanes(f, boxes, planes);
+        culling_kernel kernel = getCullingKernel();
+
+        for (size_t first = 0; first < boxes.size(); first += 64)
+            visibilityMask[first / 64] = kernel(planes, first, std::min<size_t>(64, boxes.size() - first));
+    }
+
+    void cullBoxesMultiFrustum(const frustum* frustums, uint32_t numFrustums, const box3_array& boxes, uint64_t* frustumMasks)
+    {
+        assert(numFrustums <= 64);
+
+        std::fill(frustumMasks, frustumMasks + boxes.size(), 0);
+
+        culling_kernel kernel = getCullingKernel();
+
+        for (uint32_t frustumIndex = 0; frustumIndex < numFrustums; frustumIndex++)
+        {
+            culling_plane planes[frustum::PLANES_COUNT];
+            setupCullingPlanes(frustums[frustumIndex], boxes, planes);
+
+            const uint64_t frustumBit = uint64_t(1) << frustumIndex;
+            for (size_t first = 0; first < boxes.size(); first += 64)
+            {
+                uint64_t mask = kernel(planes, first, std::min<size_t>(64, boxes.size() - first));
+                while (mask)
+                {
+                    frustumMasks[first + lowestBitIndex(mask)] |= frustumBit;
+                    mask &= mask - 1;
+                }
+            }
+        }
+    }
+}
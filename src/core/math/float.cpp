@@ -21,7 +21,9 @@
 */
 
 #include <donut/core/math/float.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #if defined(_M_X64) || defined(__x86_64__)
     #define USE_F16C 1
@@ -36,6 +38,13 @@
     #define USE_F16C 0
 #endif
 
+#if defined(_M_ARM64) || defined(__aarch64__)
+    #define USE_NEON 1
+    #include <arm_neon.h>
+#else
+    #define USE_NEON 0
+#endif
+
 namespace donut::math
 {
     struct FLOAT32
@@ -93,8 +102,9 @@ namespace donut::math
         __cpuid(cpuInfo, 1); // Request CPUID with EAX=1
         bool supported = (cpuInfo[2] >> F16C_BIT) & 1;
     #else
-        uint32_t eax, ebx, ecx, edx;
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+        uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
         bool supported = (ecx >> F16C_BIT) & 1;
     #endif
         return supported;
@@ -115,12 +125,16 @@ namespace donut::math
 
     uint32_t asuint(float x)
     {
-        return reinterpret_cast<uint32_t&>(x);
+        uint32_t result;
+        memcpy(&result, &x, sizeof(result));
+        return result;
     }
 
     float asfloat(uint32_t x)
     {
-        return reinterpret_cast<float&>(x);
+        float result;
+        memcpy(&result, &x, sizeof(result));
+        return result;
     }
 
     template<typename IN_FORMAT, typename IN_TYPE>
@@ -317,7 +331,7 @@ namespace donut::math
             if constexpr (OUT_FORMAT::SUPPORTS_INF)
             {
                 // The number turned into Inf, clear the mantissa to make sure it's not a NaN
-                if (adjustedExponent >= OUT_FORMAT::MAX_EXPONENT)
+                if (adjustedExponent >= int(OUT_FORMAT::MAX_EXPONENT))
                 {
                     adjustedExponent = OUT_FORMAT::MAX_EXPONENT;
                     mantissa = 0;
@@ -326,7 +340,7 @@ namespace donut::math
             else
             {
                 // Inf not supported - turn any numbers with out-of-range exponents into NaN
-                if (adjustedExponent > OUT_FORMAT::MAX_EXPONENT)
+                if (adjustedExponent > int(OUT_FORMAT::MAX_EXPONENT))
                 {
                     adjustedExponent = OUT_FORMAT::MAX_EXPONENT;
                     mantissa = OUT_FORMAT::MANTISSA_MASK;
@@ -558,4 +572,625 @@ namespace donut::math
         v.w = UpConvert<HELPER<FLOAT8E5M2>, uint8_t>(uint8_t((x.bits >> 24) & 0xff));
         return v;
     }
-}
\ No newline at end of file
+
+    // Branchless version of DownConvert that produces the same results and maps well to SIMD instructions.
+    // Rounding of the output denormals is done by the FP32 adder, which assumes the default rounding mode.
+    template<typename OUT_FORMAT>
+    struct BULK_DOWN_CONVERT
+    {
+        using IN_FORMAT = HELPER<FLOAT32>;
+
+        static constexpr uint32_t SHIFT = IN_FORMAT::MANTISSA_WIDTH - OUT_FORMAT::MANTISSA_WIDTH;
+        static constexpr uint32_t SIGN_SHIFT = IN_FORMAT::SIGN_BIT_SHIFT - OUT_FORMAT::SIGN_BIT_SHIFT;
+        static constexpr uint32_t EXPONENT_ADJUST = (IN_FORMAT::EXPONENT_BIAS - OUT_FORMAT::EXPONENT_BIAS) << IN_FORMAT::EXPONENT_SHIFT;
+        static constexpr uint32_t ROUNDING_BIAS = (1u << (SHIFT - 1u)) - 1u;
+        // Inputs below this are denormals or zero in the output format
+        static constexpr uint32_t MIN_NORMAL = (IN_FORMAT::EXPONENT_BIAS - OUT_FORMAT::EXPONENT_BIAS + 1u) << IN_FORMAT::EXPONENT_SHIFT;
+        // Adding this number to a denormal shifts and rounds its mantissa to the output precision
+        static constexpr uint32_t DENORMAL_MAGIC = (IN_FORMAT::EXPONENT_BIAS - OUT_FORMAT::EXPONENT_BIAS + SHIFT + 1u) << IN_FORMAT::EXPONENT_SHIFT;
+        // Inputs at or above this turn into Inf, or NaN if the format has no Inf and uses the top exponent for numbers
+        static constexpr uint32_t OVERFLOW_THRESHOLD = (IN_FORMAT::EXPONENT_BIAS - OUT_FORMAT::EXPONENT_BIAS
+            + OUT_FORMAT::MAX_EXPONENT + (OUT_FORMAT::SUPPORTS_INF ? 0u : 1u)) << IN_FORMAT::EXPONENT_SHIFT;
+        static constexpr uint32_t OVERFLOW_BITS = OUT_FORMAT::SUPPORTS_INF ? OUT_FORMAT::EXPONENT_MASK : OUT_FORMAT::EXPONENT_MANTISSA_MASK;
+        // NaN inputs produce a NaN with all mantissa bits set, same as DownConvert
+        static constexpr uint32_t NAN_BITS = OUT_FORMAT::EXPONENT_MANTISSA_MASK;
+        // Rounding up numbers with the largest exponent can overflow into the sign bit in formats without Inf
+        static constexpr uint32_t MAX_BITS = OUT_FORMAT::EXPONENT_MANTISSA_MASK;
+
+        static uint32_t Convert(uint32_t const inBits)
+        {
+            uint32_t const sign = inBits & IN_FORMAT::SIGN_BIT;
+            uint32_t const abs = inBits ^ sign;
+
+            uint32_t out;
+            if (abs > IN_FORMAT::EXPONENT_MASK)
+                out = NAN_BITS;
+            else if (abs >= OVERFLOW_THRESHOLD)
+                out = OVERFLOW_BITS;
+            else if (abs < MIN_NORMAL)
+                out = asuint(asfloat(abs) + asfloat(DENORMAL_MAGIC)) - DENORMAL_MAGIC;
+            else
+                out = std::min((abs - EXPONENT_ADJUST + ROUNDING_BIAS + ((abs >> SHIFT) & 1u)) >> SHIFT, MAX_BITS);
+
+            return out | (sign >> SIGN_SHIFT);
+        }
+    };
+
+    // Branchless version of UpConvert for FP16, the FP8 formats use lookup tables instead.
+    static uint32_t BulkFloat16ToFloat32(uint32_t const bits)
+    {
+        using IN_FORMAT = HELPER<FLOAT16>;
+        using OUT_FORMAT = HELPER<FLOAT32>;
+        constexpr uint32_t SHIFT = OUT_FORMAT::MANTISSA_WIDTH - IN_FORMAT::MANTISSA_WIDTH;
+        constexpr uint32_t EXPONENT_MASK = IN_FORMAT::EXPONENT_MASK << SHIFT;
+        constexpr uint32_t EXPONENT_ADJUST = (OUT_FORMAT::EXPONENT_BIAS - IN_FORMAT::EXPONENT_BIAS) << OUT_FORMAT::EXPONENT_SHIFT;
+        // Denormals are converted as normals with the smallest exponent, then this number is subtracted
+        constexpr uint32_t DENORMAL_MAGIC = EXPONENT_ADJUST + (1u << OUT_FORMAT::EXPONENT_SHIFT);
+
+        uint32_t out = (bits & IN_FORMAT::EXPONENT_MANTISSA_MASK) << SHIFT;
+        uint32_t const exponent = out & EXPONENT_MASK;
+        out += EXPONENT_ADJUST;
+        if (exponent == EXPONENT_MASK) // Inf or NaN
+            out += EXPONENT_ADJUST;
+        else if (exponent == 0) // Zero or denormal
+            out = asuint(asfloat(out + (1u << OUT_FORMAT::EXPONENT_SHIFT)) - asfloat(DENORMAL_MAGIC));
+
+        return out | ((bits & IN_FORMAT::SIGN_BIT) << (OUT_FORMAT::SIGN_BIT_SHIFT - IN_FORMAT::SIGN_BIT_SHIFT));
+    }
+
+#if USE_F16C
+    // The SIMD kernels below convert as many values as they can in full vectors and return the number of converted values.
+    // The remaining values are converted with the scalar code.
+
+    static __m128i Select(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    template<typename OUT_FORMAT>
+    static __m128i DownConvertSSE(__m128i const inBits)
+    {
+        using C = BULK_DOWN_CONVERT<OUT_FORMAT>;
+
+        // The absolute values fit into 31 bits, so signed comparisons work for them
+        __m128i const sign = _mm_and_si128(inBits, _mm_set1_epi32(int(HELPER<FLOAT32>::SIGN_BIT)));
+        __m128i const abs = _mm_xor_si128(inBits, sign);
+
+        __m128i const odd = _mm_and_si128(_mm_srli_epi32(abs, C::SHIFT), _mm_set1_epi32(1));
+        __m128i normal = _mm_add_epi32(abs, _mm_set1_epi32(int(C::ROUNDING_BIAS - C::EXPONENT_ADJUST)));
+        normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), C::SHIFT);
+        __m128i const maxBits = _mm_set1_epi32(int(C::MAX_BITS));
+        normal = Select(_mm_cmpgt_epi32(normal, maxBits), maxBits, normal);
+
+        __m128i const magic = _mm_set1_epi32(int(C::DENORMAL_MAGIC));
+        __m128i const denormal = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(abs), _mm_castsi128_ps(magic))), magic);
+
+        __m128i out = Select(_mm_cmplt_epi32(abs, _mm_set1_epi32(int(C::MIN_NORMAL))), denormal, normal);
+        out = Select(_mm_cmpgt_epi32(abs, _mm_set1_epi32(int(C::OVERFLOW_THRESHOLD - 1))), _mm_set1_epi32(int(C::OVERFLOW_BITS)), out);
+        out = Select(_mm_cmpgt_epi32(abs, _mm_set1_epi32(int(HELPER<FLOAT32>::EXPONENT_MASK))), _mm_set1_epi32(int(C::NAN_BITS)), out);
+
+        return _mm_or_si128(out, _mm_srli_epi32(sign, C::SIGN_SHIFT));
+    }
+
+    static size_t Float32ToFloat16SSE(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i a = DownConvertSSE<HELPER<FLOAT16>>(_mm_loadu_si128((const __m128i*)(src + i)));
+            __m128i b = DownConvertSSE<HELPER<FLOAT16>>(_mm_loadu_si128((const __m128i*)(src + i + 4)));
+            // Sign-extend the 16-bit results so that the saturating pack keeps them intact
+            a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+            b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+        }
+        return i;
+    }
+
+    template<typename OUT_FORMAT>
+    static size_t Float32ToFloat8SSE(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a = DownConvertSSE<OUT_FORMAT>(_mm_loadu_si128((const __m128i*)(src + i)));
+            __m128i b = DownConvertSSE<OUT_FORMAT>(_mm_loadu_si128((const __m128i*)(src + i + 4)));
+            __m128i c = DownConvertSSE<OUT_FORMAT>(_mm_loadu_si128((const __m128i*)(src + i + 8)));
+            __m128i d = DownConvertSSE<OUT_FORMAT>(_mm_loadu_si128((const __m128i*)(src + i + 12)));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+        return i;
+    }
+
+    static __m128 Float16ToFloat32SSE(__m128i const bits)
+    {
+        using IN_FORMAT = HELPER<FLOAT16>;
+        using OUT_FORMAT = HELPER<FLOAT32>;
+        constexpr uint32_t SHIFT = OUT_FORMAT::MANTISSA_WIDTH - IN_FORMAT::MANTISSA_WIDTH;
+        constexpr uint32_t EXPONENT_MASK = IN_FORMAT::EXPONENT_MASK << SHIFT;
+        constexpr uint32_t EXPONENT_ADJUST = (OUT_FORMAT::EXPONENT_BIAS - IN_FORMAT::EXPONENT_BIAS) << OUT_FORMAT::EXPONENT_SHIFT;
+        constexpr uint32_t DENORMAL_MAGIC = EXPONENT_ADJUST + (1u << OUT_FORMAT::EXPONENT_SHIFT);
+
+        __m128i out = _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(IN_FORMAT::EXPONENT_MANTISSA_MASK))), SHIFT);
+        __m128i const exponent = _mm_and_si128(out, _mm_set1_epi32(int(EXPONENT_MASK)));
+        __m128i const adjust = _mm_set1_epi32(int(EXPONENT_ADJUST));
+        out = _mm_add_epi32(out, adjust);
+
+        __m128i const infOrNaN = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(int(EXPONENT_MASK)));
+        out = _mm_add_epi32(out, _mm_and_si128(infOrNaN, adjust));
+
+        __m128i const denormal = _mm_castps_si128(_mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(out, _mm_set1_epi32(1 << OUT_FORMAT::EXPONENT_SHIFT))),
+            _mm_castsi128_ps(_mm_set1_epi32(int(DENORMAL_MAGIC)))));
+        out = Select(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), denormal, out);
+
+        __m128i const sign = _mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(IN_FORMAT::SIGN_BIT))),
+            OUT_FORMAT::SIGN_BIT_SHIFT - IN_FORMAT::SIGN_BIT_SHIFT);
+        return _mm_castsi128_ps(_mm_or_si128(out, sign));
+    }
+
+    static size_t Float16ToFloat32SSE(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i const bits = _mm_loadu_si128((const __m128i*)(src + i));
+            _mm_storeu_ps(dst + i, Float16ToFloat32SSE(_mm_unpacklo_epi16(bits, _mm_setzero_si128())));
+            _mm_storeu_ps(dst + i + 4, Float16ToFloat32SSE(_mm_unpackhi_epi16(bits, _mm_setzero_si128())));
+        }
+        return i;
+    }
+
+    DONUT_TARGET_AVX2 static __m256i Select(__m256i mask, __m256i a, __m256i b)
+    {
+        return _mm256_blendv_epi8(b, a, mask);
+    }
+
+    template<typename OUT_FORMAT>
+    DONUT_TARGET_AVX2 static __m256i DownConvertAVX2(__m256i const inBits)
+    {
+        using C = BULK_DOWN_CONVERT<OUT_FORMAT>;
+
+        __m256i const sign = _mm256_and_si256(inBits, _mm256_set1_epi32(int(HELPER<FLOAT32>::SIGN_BIT)));
+        __m256i const abs = _mm256_xor_si256(inBits, sign);
+
+        __m256i const odd = _mm256_and_si256(_mm256_srli_epi32(abs, C::SHIFT), _mm256_set1_epi32(1));
+        __m256i normal = _mm256_add_epi32(abs, _mm256_set1_epi32(int(C::ROUNDING_BIAS - C::EXPONENT_ADJUST)));
+        normal = _mm256_srli_epi32(_mm256_add_epi32(normal, odd), C::SHIFT);
+        normal = _mm256_min_epu32(normal, _mm256_set1_epi32(int(C::MAX_BITS)));
+
+        __m256i const magic = _mm256_set1_epi32(int(C::DENORMAL_MAGIC));
+        __m256i const denormal = _mm256_sub_epi32(
+            _mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(abs), _mm256_castsi256_ps(magic))), magic);
+
+        __m256i out = Select(_mm256_cmpgt_epi32(_mm256_set1_epi32(int(C::MIN_NORMAL)), abs), denormal, normal);
+        out = Select(_mm256_cmpgt_epi32(abs, _mm256_set1_epi32(int(C::OVERFLOW_THRESHOLD - 1))), _mm256_set1_epi32(int(C::OVERFLOW_BITS)), out);
+        out = Select(_mm256_cmpgt_epi32(abs, _mm256_set1_epi32(int(HELPER<FLOAT32>::EXPONENT_MASK))), _mm256_set1_epi32(int(C::NAN_BITS)), out);
+
+        return _mm256_or_si256(out, _mm256_srli_epi32(sign, C::SIGN_SHIFT));
+    }
+
+    DONUT_TARGET_AVX2 static size_t Float32ToFloat16AVX2(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i const a = DownConvertAVX2<HELPER<FLOAT16>>(_mm256_loadu_si256((const __m256i*)(src + i)));
+            __m256i const b = DownConvertAVX2<HELPER<FLOAT16>>(_mm256_loadu_si256((const __m256i*)(src + i + 8)));
+            // The pack works within 128-bit lanes, put the 64-bit groups back in order
+            __m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xd8);
+            _mm256_storeu_si256((__m256i*)(dst + i), packed);
+        }
+        return i;
+    }
+
+    template<typename OUT_FORMAT>
+    DONUT_TARGET_AVX2 static size_t Float32ToFloat8AVX2(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+        __m256i const order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i const a = DownConvertAVX2<OUT_FORMAT>(_mm256_loadu_si256((const __m256i*)(src + i)));
+            __m256i const b = DownConvertAVX2<OUT_FORMAT>(_mm256_loadu_si256((const __m256i*)(src + i + 8)));
+            __m256i const c = DownConvertAVX2<OUT_FORMAT>(_mm256_loadu_si256((const __m256i*)(src + i + 16)));
+            __m256i const d = DownConvertAVX2<OUT_FORMAT>(_mm256_loadu_si256((const __m256i*)(src + i + 24)));
+            __m256i const packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permutevar8x32_epi32(packed, order));
+        }
+        return i;
+    }
+
+    DONUT_TARGET_AVX2 static size_t Float32ToFloat16F16C(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i const packed = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128((__m128i*)(dst + i), packed);
+        }
+        return i;
+    }
+
+    DONUT_TARGET_AVX2 static size_t Float16ToFloat32F16C(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+        return i;
+    }
+
+    // GCC 12 reports the undefined vectors that its AVX-512 intrinsics use internally as uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    template<typename OUT_FORMAT>
+    DONUT_TARGET_AVX512 static __m512i DownConvertAVX512(__m512i const inBits)
+    {
+        using C = BULK_DOWN_CONVERT<OUT_FORMAT>;
+
+        __m512i const sign = _mm512_and_si512(inBits, _mm512_set1_epi32(int(HELPER<FLOAT32>::SIGN_BIT)));
+        __m512i const abs = _mm512_xor_si512(inBits, sign);
+
+        __m512i const odd = _mm512_and_si512(_mm512_srli_epi32(abs, C::SHIFT), _mm512_set1_epi32(1));
+        __m512i normal = _mm512_add_epi32(abs, _mm512_set1_epi32(int(C::ROUNDING_BIAS - C::EXPONENT_ADJUST)));
+        normal = _mm512_srli_epi32(_mm512_add_epi32(normal, odd), C::SHIFT);
+        normal = _mm512_min_epu32(normal, _mm512_set1_epi32(int(C::MAX_BITS)));
+
+        __m512i const magic = _mm512_set1_epi32(int(C::DENORMAL_MAGIC));
+        __m512i const denormal = _mm512_sub_epi32(
+            _mm512_castps_si512(_mm512_add_ps(_mm512_castsi512_ps(abs), _mm512_castsi512_ps(magic))), magic);
+
+        __m512i out = _mm512_mask_mov_epi32(normal, _mm512_cmplt_epu32_mask(abs, _mm512_set1_epi32(int(C::MIN_NORMAL))), denormal);
+        out = _mm512_mask_mov_epi32(out, _mm512_cmpge_epu32_mask(abs, _mm512_set1_epi32(int(C::OVERFLOW_THRESHOLD))),
+            _mm512_set1_epi32(int(C::OVERFLOW_BITS)));
+        out = _mm512_mask_mov_epi32(out, _mm512_cmpgt_epu32_mask(abs, _mm512_set1_epi32(int(HELPER<FLOAT32>::EXPONENT_MASK))),
+            _mm512_set1_epi32(int(C::NAN_BITS)));
+
+        return _mm512_or_si512(out, _mm512_srli_epi32(sign, C::SIGN_SHIFT));
+    }
+
+    DONUT_TARGET_AVX512 static size_t Float32ToFloat16AVX512(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m512i const out = DownConvertAVX512<HELPER<FLOAT16>>(_mm512_loadu_si512(src + i));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtepi32_epi16(out));
+        }
+        return i;
+    }
+
+    template<typename OUT_FORMAT>
+    DONUT_TARGET_AVX512 static size_t Float32ToFloat8AVX512(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m512i const out = DownConvertAVX512<OUT_FORMAT>(_mm512_loadu_si512(src + i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm512_cvtepi32_epi8(out));
+        }
+        return i;
+    }
+
+    DONUT_TARGET_AVX512 static size_t Float32ToFloat16F16CAVX512(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i const packed = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm256_storeu_si256((__m256i*)(dst + i), packed);
+        }
+        return i;
+    }
+
+    DONUT_TARGET_AVX512 static size_t Float16ToFloat32F16CAVX512(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+            _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(src + i))));
+        return i;
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+#endif // USE_F16C
+
+#if USE_NEON
+    template<typename OUT_FORMAT>
+    static uint32x4_t DownConvertNEON(uint32x4_t const inBits)
+    {
+        using C = BULK_DOWN_CONVERT<OUT_FORMAT>;
+
+        uint32x4_t const sign = vandq_u32(inBits, vdupq_n_u32(HELPER<FLOAT32>::SIGN_BIT));
+        uint32x4_t const abs = veorq_u32(inBits, sign);
+
+        uint32x4_t const odd = vandq_u32(vshrq_n_u32(abs, C::SHIFT), vdupq_n_u32(1));
+        uint32x4_t normal = vaddq_u32(abs, vdupq_n_u32(C::ROUNDING_BIAS - C::EXPONENT_ADJUST));
+        normal = vshrq_n_u32(vaddq_u32(normal, odd), C::SHIFT);
+        normal = vminq_u32(normal, vdupq_n_u32(C::MAX_BITS));
+
+        uint32x4_t const magic = vdupq_n_u32(C::DENORMAL_MAGIC);
+        uint32x4_t const denormal = vsubq_u32(
+            vreinterpretq_u32_f32(vaddq_f32(vreinterpretq_f32_u32(abs), vreinterpretq_f32_u32(magic))), magic);
+
+        uint32x4_t out = vbslq_u32(vcltq_u32(abs, vdupq_n_u32(C::MIN_NORMAL)), denormal, normal);
+        out = vbslq_u32(vcgeq_u32(abs, vdupq_n_u32(C::OVERFLOW_THRESHOLD)), vdupq_n_u32(C::OVERFLOW_BITS), out);
+        out = vbslq_u32(vcgtq_u32(abs, vdupq_n_u32(HELPER<FLOAT32>::EXPONENT_MASK)), vdupq_n_u32(C::NAN_BITS), out);
+
+        return vorrq_u32(out, vshrq_n_u32(sign, C::SIGN_SHIFT));
+    }
+
+    static size_t Float32ToFloat16NEON(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint32x4_t const a = DownConvertNEON<HELPER<FLOAT16>>(vld1q_u32((const uint32_t*)(src + i)));
+            uint32x4_t const b = DownConvertNEON<HELPER<FLOAT16>>(vld1q_u32((const uint32_t*)(src + i + 4)));
+            vst1q_u16(dst + i, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+        }
+        return i;
+    }
+
+    template<typename OUT_FORMAT>
+    static size_t Float32ToFloat8NEON(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint32x4_t const a = DownConvertNEON<OUT_FORMAT>(vld1q_u32((const uint32_t*)(src + i)));
+            uint32x4_t const b = DownConvertNEON<OUT_FORMAT>(vld1q_u32((const uint32_t*)(src + i + 4)));
+            vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))));
+        }
+        return i;
+    }
+
+    static uint32x4_t Float16ToFloat32NEON(uint32x4_t const bits)
+    {
+        using IN_FORMAT = HELPER<FLOAT16>;
+        using OUT_FORMAT = HELPER<FLOAT32>;
+        constexpr uint32_t SHIFT = OUT_FORMAT::MANTISSA_WIDTH - IN_FORMAT::MANTISSA_WIDTH;
+        constexpr uint32_t EXPONENT_MASK = IN_FORMAT::EXPONENT_MASK << SHIFT;
+        constexpr uint32_t EXPONENT_ADJUST = (OUT_FORMAT::EXPONENT_BIAS - IN_FORMAT::EXPONENT_BIAS) << OUT_FORMAT::EXPONENT_SHIFT;
+        constexpr uint32_t DENORMAL_MAGIC = EXPONENT_ADJUST + (1u << OUT_FORMAT::EXPONENT_SHIFT);
+
+        uint32x4_t out = vshlq_n_u32(vandq_u32(bits, vdupq_n_u32(IN_FORMAT::EXPONENT_MANTISSA_MASK)), SHIFT);
+        uint32x4_t const exponent = vandq_u32(out, vdupq_n_u32(EXPONENT_MASK));
+        uint32x4_t const adjust = vdupq_n_u32(EXPONENT_ADJUST);
+        out = vaddq_u32(out, adjust);
+        out = vaddq_u32(out, vandq_u32(vceqq_u32(exponent, vdupq_n_u32(EXPONENT_MASK)), adjust));
+
+        uint32x4_t const denormal = vreinterpretq_u32_f32(vsubq_f32(
+            vreinterpretq_f32_u32(vaddq_u32(out, vdupq_n_u32(1u << OUT_FORMAT::EXPONENT_SHIFT))),
+            vreinterpretq_f32_u32(vdupq_n_u32(DENORMAL_MAGIC))));
+        out = vbslq_u32(vceqq_u32(exponent, vdupq_n_u32(0)), denormal, out);
+
+        uint32x4_t const sign = vshlq_n_u32(vandq_u32(bits, vdupq_n_u32(IN_FORMAT::SIGN_BIT)),
+            OUT_FORMAT::SIGN_BIT_SHIFT - IN_FORMAT::SIGN_BIT_SHIFT);
+        return vorrq_u32(out, sign);
+    }
+
+    static size_t Float16ToFloat32NEON(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint16x8_t const bits = vld1q_u16(src + i);
+            vst1q_u32((uint32_t*)(dst + i), Float16ToFloat32NEON(vmovl_u16(vget_low_u16(bits))));
+            vst1q_u32((uint32_t*)(dst + i + 4), Float16ToFloat32NEON(vmovl_u16(vget_high_u16(bits))));
+        }
+        return i;
+    }
+#endif // USE_NEON
+
+    static bool IsFloatConversionSimdLevelSupported(simd_level level)
+    {
+        switch (level)
+        {
+        case simd_level::scalar:
+            return true;
+#if USE_F16C
+        case simd_level::sse:
+            return true;
+        case simd_level::avx2:
+            return isAVX2Supported();
+        case simd_level::avx512:
+            return isAVX512Supported();
+#endif
+#if USE_NEON
+        case simd_level::neon:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    simd_level GetBestFloatConversionSimdLevel()
+    {
+#if USE_F16C
+        if (isAVX512Supported())
+            return simd_level::avx512;
+        return isAVX2Supported() ? simd_level::avx2 : simd_level::sse;
+#elif USE_NEON
+        return simd_level::neon;
+#else
+        return simd_level::scalar;
+#endif
+    }
+
+    static simd_level g_FloatConversionSimdLevel = GetBestFloatConversionSimdLevel();
+
+    void SetFloatConversionSimdLevel(simd_level level)
+    {
+        g_FloatConversionSimdLevel = IsFloatConversionSimdLevelSupported(level) ? level : GetBestFloatConversionSimdLevel();
+    }
+
+    simd_level GetFloatConversionSimdLevel()
+    {
+        return g_FloatConversionSimdLevel;
+    }
+
+    template<typename OUT_FORMAT>
+    static void Float32ToFloat8(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+        switch (g_FloatConversionSimdLevel)
+        {
+#if USE_F16C
+        case simd_level::sse:
+            i = Float32ToFloat8SSE<OUT_FORMAT>(src, dst, count);
+            break;
+        case simd_level::avx2:
+            i = Float32ToFloat8AVX2<OUT_FORMAT>(src, dst, count);
+            break;
+        case simd_level::avx512:
+            i = Float32ToFloat8AVX512<OUT_FORMAT>(src, dst, count);
+            break;
+#endif
+#if USE_NEON
+        case simd_level::neon:
+            i = Float32ToFloat8NEON<OUT_FORMAT>(src, dst, count);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < count; ++i)
+            dst[i] = uint8_t(BULK_DOWN_CONVERT<OUT_FORMAT>::Convert(asuint(src[i])));
+    }
+
+    // FP8 to FP32 conversion table with all 256 results of UpConvert.
+    template<typename IN_FORMAT>
+    struct FLOAT8_TABLE
+    {
+        float values[256];
+
+        FLOAT8_TABLE()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+                values[i] = UpConvert<IN_FORMAT, uint8_t>(uint8_t(i));
+        }
+    };
+
+    template<typename IN_FORMAT>
+    static void Float8ToFloat32(const uint8_t* src, float* dst, size_t count)
+    {
+        static const FLOAT8_TABLE<IN_FORMAT> table;
+
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = table.values[src[i]];
+    }
+
+    void Float32ToFloat16(const float* src, float16_t* dst, size_t count)
+    {
+        uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+        size_t i = 0;
+
+#if USE_F16C
+        if (g_SupportsF16C)
+        {
+            i = g_FloatConversionSimdLevel == simd_level::avx512
+                ? Float32ToFloat16F16CAVX512(src, out, count)
+                : Float32ToFloat16F16C(src, out, count);
+
+            // Convert the remaining values one by one to keep the results identical
+            for (; i < count; ++i)
+                dst[i] = Float32ToFloat16(src[i]);
+            return;
+        }
+#endif
+
+        switch (g_FloatConversionSimdLevel)
+        {
+#if USE_F16C
+        case simd_level::sse:
+            i = Float32ToFloat16SSE(src, out, count);
+            break;
+        case simd_level::avx2:
+            i = Float32ToFloat16AVX2(src, out, count);
+            break;
+        case simd_level::avx512:
+            i = Float32ToFloat16AVX512(src, out, count);
+            break;
+#endif
+#if USE_NEON
+        case simd_level::neon:
+            i = Float32ToFloat16NEON(src, out, count);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < count; ++i)
+            out[i] = uint16_t(BULK_DOWN_CONVERT<HELPER<FLOAT16>>::Convert(asuint(src[i])));
+    }
+
+    void Float16ToFloat32(const float16_t* src, float* dst, size_t count)
+    {
+        const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+        size_t i = 0;
+
+#if USE_F16C
+        if (g_SupportsF16C)
+        {
+            i = g_FloatConversionSimdLevel == simd_level::avx512
+                ? Float16ToFloat32F16CAVX512(in, dst, count)
+                : Float16ToFloat32F16C(in, dst, count);
+
+            for (; i < count; ++i)
+                dst[i] = Float16ToFloat32(src[i]);
+            return;
+        }
+#endif
+
+        switch (g_FloatConversionSimdLevel)
+        {
+#if USE_F16C
+        // Only CPUs without F16C need this path, and none of them have AVX2, so there are no wider versions
+        case simd_level::sse:
+        case simd_level::avx2:
+        case simd_level::avx512:
+            i = Float16ToFloat32SSE(in, dst, count);
+            break;
+#endif
+#if USE_NEON
+        case simd_level::neon:
+            i = Float16ToFloat32NEON(in, dst, count);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < count; ++i)
+            dst[i] = asfloat(BulkFloat16ToFloat32(in[i]));
+    }
+
+    void Float32ToFloat8E4M3(const float* src, float8e4m3_t* dst, size_t count)
+    {
+        Float32ToFloat8<HELPER<FLOAT8E4M3>>(src, reinterpret_cast<uint8_t*>(dst), count);
+    }
+
+    void Float8E4M3ToFloat32(const float8e4m3_t* src, float* dst, size_t count)
+    {
+        Float8ToFloat32<HELPER<FLOAT8E4M3>>(reinterpret_cast<const uint8_t*>(src), dst, count);
+    }
+
+    void Float32ToFloat8E5M2(const float* src, float8e5m2_t* dst, size_t count)
+    {
+        Float32ToFloat8<HELPER<FLOAT8E5M2>>(src, reinterpret_cast<uint8_t*>(dst), count);
+    }
+
+    void Float8E5M2ToFloat32(const float8e5m2_t* src, float* dst, size_t count)
+    {
+        Float8ToFloat32<HELPER<FLOAT8E5M2>>(reinterpret_cast<const uint8_t*>(src), dst, count);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <donut/core/math/simd.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define SIMD_X64 1
+
+    #ifdef _MSC_VER
+    #include <intrin.h>
+    #else
+    #include <cpuid.h>
+    #endif
+#endif
+
+namespace donut::math
+{
+    bool isAVX2Supported()
+    {
+#if SIMD_X64
+        constexpr int F16C_BIT = 29;
+        constexpr int OSXSAVE_BIT = 27;
+        constexpr int AVX_BIT = 28;
+        constexpr int AVX2_BIT = 5;
+    #ifdef _MSC_VER
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        bool avx = ((cpuInfo[2] >> OSXSAVE_BIT) & 1) && ((cpuInfo[2] >> AVX_BIT) & 1);
+        bool f16c = (cpuInfo[2] >> F16C_BIT) & 1;
+        if (!avx || !f16c)
+            return false;
+        __cpuidex(cpuInfo, 7, 0);
+        bool avx2 = (cpuInfo[1] >> AVX2_BIT) & 1;
+        // The OS must save the YMM registers on context switches
+        bool ymmEnabled = (_xgetbv(0) & 6) == 6;
+    #else
+        uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        bool avx = ((ecx >> OSXSAVE_BIT) & 1) && ((ecx >> AVX_BIT) & 1);
+        bool f16c = (ecx >> F16C_BIT) & 1;
+        if (!avx || !f16c)
+            return false;
+        // Leaf 7 is not available on older CPUs
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        bool avx2 = (ebx >> AVX2_BIT) & 1;
+        uint32_t xcr0, xcr0High;
+        __asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+        bool ymmEnabled = (xcr0 & 6) == 6;
+    #endif
+        return avx2 && ymmEnabled;
+#else
+        return false;
+#endif
+    }
+
+    bool isAVX512Supported()
+    {
+#if SIMD_X64
+        constexpr int AVX512F_BIT = 16;
+        // XMM, YMM, opmask and both halves of the ZMM registers
+        constexpr uint32_t ZMM_STATE = 0xe6;
+        if (!isAVX2Supported())
+            return false;
+    #ifdef _MSC_VER
+        int cpuInfo[4];
+        __cpuidex(cpuInfo, 7, 0);
+        bool avx512 = (cpuInfo[1] >> AVX512F_BIT) & 1;
+        bool zmmEnabled = (_xgetbv(0) & ZMM_STATE) == ZMM_STATE;
+    #else
+        uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        bool avx512 = (ebx >> AVX512F_BIT) & 1;
+        uint32_t xcr0, xcr0High;
+        __asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+        bool zmmEnabled = (xcr0 & ZMM_STATE) == ZMM_STATE;
+    #endif
+        return avx512 && zmmEnabled;
+#else
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,587 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/core/vfs/Compression.h>
+#include <donut/core/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace donut::vfs;
+using namespace donut::vfs::compression;
+
+static_assert(sizeof(CompressedFileHeader) == 24);
+
+// Files with fewer blocks than this are compressed and decompressed on the calling thread.
+static constexpr uint32_t c_MinBlocksForThreading = 4;
+
+// LZ4 block format constants
+static constexpr size_t c_MinMatch = 4;
+static constexpr size_t c_LastLiterals = 5;   // the last 5 bytes of a block are always literals
+static constexpr size_t c_MatchFindLimit = 12; // the last match must start at least 12 bytes before the end
+static constexpr size_t c_MaxOffset = 65535;
+static constexpr int c_HashLog = 16;
+static constexpr uint32_t c_SkipTrigger = 6;
+
+static uint32_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hashPosition(const uint8_t* p)
+{
+    return (read32(p) * 2654435761u) >> (32 - c_HashLog);
+}
+
+// Writes the extra bytes of a literal or match length that doesn't fit into the 4-bit token field.
+static uint8_t* writeLength(uint8_t* op, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        *op++ = 255;
+    *op++ = uint8_t(length);
+    return op;
+}
+
+static uint8_t* writeSequence(uint8_t* op, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+    uint8_t* token = op++;
+
+    if (numLiterals >= 15)
+    {
+        *token = 15 << 4;
+        op = writeLength(op, numLiterals - 15);
+    }
+    else
+        *token = uint8_t(numLiterals << 4);
+
+    memcpy(op, literals, numLiterals);
+    op += numLiterals;
+
+    // the last sequence of a block has literals only
+    if (matchLength == 0)
+        return op;
+
+    *op++ = uint8_t(offset);
+    *op++ = uint8_t(offset >> 8);
+
+    matchLength -= c_MinMatch;
+    if (matchLength >= 15)
+    {
+        *token |= 15;
+        op = writeLength(op, matchLength - 15);
+    }
+    else
+        *token |= uint8_t(matchLength);
+
+    return op;
+}
+
+static size_t sequenceBound(size_t numLiterals, size_t matchLength)
+{
+    return 1 + numLiterals + numLiterals / 255 + 1 + 2 + matchLength / 255 + 1;
+}
+
+size_t compression::compressBlockBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t compression::compressBlock(const void* src, size_t srcSize, void* dst, size_t dstCapacity)
+{
+    const uint8_t* const base = static_cast<const uint8_t*>(src);
+    const uint8_t* const iend = base + srcSize;
+    uint8_t* op = static_cast<uint8_t*>(dst);
+    uint8_t* const oend = op + dstCapacity;
+
+    const uint8_t* ip = base;
+    const uint8_t* anchor = base;
+
+    if (srcSize > c_MatchFindLimit)
+    {
+        const uint8_t* const matchFindLimit = iend - c_MatchFindLimit;
+        const uint8_t* const matchLimit = iend - c_LastLiterals;
+
+        // positions of the last occurrence of each hashed 4-byte sequence
+        std::vector<uint32_t> hashTable(size_t(1) << c_HashLog, 0);
+
+        ++ip;
+        while (ip <= matchFindLimit)
+        {
+            // find a match, skipping faster through data that doesn't compress
+            const uint8_t* match = nullptr;
+            uint32_t searchCount = 1 << c_SkipTrigger;
+            while (true)
+            {
+                uint32_t hash = hashPosition(ip);
+                match = base + hashTable[hash];
+                hashTable[hash] = uint32_t(ip - base);
+
+                if (match < ip && size_t(ip - match) <= c_MaxOffset && read32(match) == read32(ip))
+                    break;
+
+                ip += searchCount++ >> c_SkipTrigger;
+                if (ip > matchFindLimit)
+                    goto lastLiterals;
+            }
+
+            // extend the match backwards over the pending literals
+            while (ip > anchor && match > base && ip[-1] == match[-1])
+            {
+                --ip;
+                --match;
+            }
+
+            // and forwards
+            const uint8_t* matchEnd = ip + c_MinMatch;
+            const uint8_t* matchSource = match + c_MinMatch;
+            while (matchEnd < matchLimit && *matchEnd == *matchSource)
+            {
+                ++matchEnd;
+                ++matchSource;
+            }
+
+            size_t numLiterals = size_t(ip - anchor);
+            size_t matchLength = size_t(matchEnd - ip);
+            if (sequenceBound(numLiterals, matchLength) > size_t(oend - op))
+                return 0;
+
+            op = writeSequence(op, anchor, numLiterals, size_t(ip - match), matchLength);
+
+            ip = matchEnd;
+            anchor = ip;
+
+            if (ip <= matchFindLimit)
+                hashTable[hashPosition(ip - 2)] = uint32_t(ip - 2 - base);
+        }
+    }
+
+lastLiterals:
+    size_t numLiterals = size_t(iend - anchor);
+    if (sequenceBound(numLiterals, 0) > size_t(oend - op))
+        return 0;
+
+    op = writeSequence(op, anchor, numLiterals, 0, 0);
+
+    return size_t(op - static_cast<uint8_t*>(dst));
+}
+
+// Reads the extra bytes of a literal or match length. Returns false if the input ends prematurely.
+static bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length)
+{
+    uint8_t value;
+    do
+    {
+        if (ip >= iend)
+            return false;
+        value = *ip++;
+        length += value;
+    } while (value == 255);
+
+    return true;
+}
+
+bool compression::decompressBlock(const void* src, size_t srcSize, void* dst, size_t dstSize)
+{
+    const uint8_t* ip = static_cast<const uint8_t*>(src);
+    const uint8_t* const iend = ip + srcSize;
+    uint8_t* const obase = static_cast<uint8_t*>(dst);
+    uint8_t* op = obase;
+    uint8_t* const oend = op + dstSize;
+
+    while (ip < iend)
+    {
+        uint8_t token = *ip++;
+
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !readLength(ip, iend, numLiterals))
+            return false;
+
+        if (numLiterals > size_t(iend - ip) || numLiterals > size_t(oend - op))
+            return false;
+
+        memcpy(op, ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+
+        // the last sequence has no match
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+
+        size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > size_t(op - obase))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, iend, matchLength))
+            return false;
+        matchLength += c_MinMatch;
+
+        if (matchLength > size_t(oend - op))
+            return false;
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            // overlapping copy, repeats the last 'offset' bytes
+            for (size_t i = 0; i < matchLength; ++i)
+                *op++ = *match++;
+        }
+    }
+
+    return op == oend;
+}
+
+// Runs func(index) for every index in [0, count), on up to 'maxThreads' threads including the calling thread.
+static void parallelForOnThreads(uint32_t count, uint32_t maxThreads, const std::function<void(uint32_t)>& func)
+{
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    uint32_t numThreads = std::min(maxThreads, count);
+    if (count < c_MinBlocksForThreading || numThreads <= 1)
+    {
+        for (uint32_t index = 0; index < count; ++index)
+            func(index);
+        return;
+    }
+
+    std::atomic<uint32_t> nextIndex = 0;
+    auto worker = [&nextIndex, count, &func]()
+    {
+        for (uint32_t index = nextIndex++; index < count; index = nextIndex++)
+            func(index);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (uint32_t i = 1; i < numThreads; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Runs func(index) for every index in [0, count) with the executor, or on the calling thread for small counts.
+static void parallelFor(uint32_t count, const parallel_for_t& executor, const std::function<void(uint32_t)>& func)
+{
+    if (!executor || count < c_MinBlocksForThreading)
+    {
+        for (uint32_t index = 0; index < count; ++index)
+            func(index);
+        return;
+    }
+
+    executor(count, func);
+}
+
+static parallel_for_t threadsParallelFor(uint32_t maxThreads)
+{
+    return [maxThreads](uint32_t count, const std::function<void(uint32_t)>& func)
+    {
+        parallelForOnThreads(count, maxThreads, func);
+    };
+}
+
+std::vector<uint8_t> compression::compressFile(const void* data, size_t size, uint32_t blockSize, uint32_t maxThreads)
+{
+    return compressFile(data, size, blockSize, threadsParallelFor(maxThreads));
+}
+
+std::vector<uint8_t> compression::compressFile(const void* data, size_t size, uint32_t blockSize, const parallel_for_t& executor)
+{
+    if (blockSize == 0 || blockSize > MaxBlockSize)
+        return std::vector<uint8_t>();
+
+    const uint64_t numBlocks64 = (uint64_t(size) + blockSize - 1) / blockSize;
+    if (numBlocks64 > UINT32_MAX)
+        return std::vector<uint8_t>();
+
+    const uint32_t numBlocks = uint32_t(numBlocks64);
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+
+    // compress the blocks into separate buffers first, then concatenate them
+    std::vector<std::vector<uint8_t>> blocks(numBlocks);
+    std::vector<uint32_t> blockSizes(numBlocks);
+
+    parallelFor(numBlocks, executor, [&](uint32_t index)
+    {
+        size_t offset = size_t(index) * blockSize;
+        size_t inputSize = std::min(size - offset, size_t(blockSize));
+
+        std::vector<uint8_t>& block = blocks[index];
+        block.resize(compressBlockBound(inputSize));
+        size_t compressedSize = compressBlock(input + offset, inputSize, block.data(), block.size());
+
+        if (compressedSize == 0 || compressedSize >= inputSize)
+        {
+            block.assign(input + offset, input + offset + inputSize);
+            blockSizes[index] = uint32_t(inputSize) | StoredBlockFlag;
+        }
+        else
+        {
+            block.resize(compressedSize);
+            blockSizes[index] = uint32_t(compressedSize);
+        }
+    });
+
+    CompressedFileHeader header;
+    header.signature = FileSignature;
+    header.codec = CodecLZ4;
+    header.uncompressedSize = size;
+    header.blockSize = blockSize;
+    header.numBlocks = numBlocks;
+
+    size_t totalSize = sizeof(header) + sizeof(uint32_t) * numBlocks;
+    for (const auto& block : blocks)
+        totalSize += block.size();
+
+    std::vector<uint8_t> result(totalSize);
+    uint8_t* op = result.data();
+    memcpy(op, &header, sizeof(header));
+    op += sizeof(header);
+    memcpy(op, blockSizes.data(), sizeof(uint32_t) * numBlocks);
+    op += sizeof(uint32_t) * numBlocks;
+    for (const auto& block : blocks)
+    {
+        memcpy(op, block.data(), block.size());
+        op += block.size();
+    }
+
+    return result;
+}
+
+static bool isValidHeader(const void* data, size_t size, CompressedFileHeader& header)
+{
+    if (!data || size < sizeof(CompressedFileHeader))
+        return false;
+
+    memcpy(&header, data, sizeof(header));
+
+    return header.signature == FileSignature
+        && header.codec == CodecLZ4
+        && header.blockSize != 0
+        && header.blockSize <= MaxBlockSize
+        && header.numBlocks == header.uncompressedSize / header.blockSize + (header.uncompressedSize % header.blockSize != 0);
+}
+
+bool compression::isCompressedFile(const void* data, size_t size)
+{
+    CompressedFileHeader header;
+    return isValidHeader(data, size, header)
+        && (size - sizeof(header)) / sizeof(uint32_t) >= header.numBlocks;
+}
+
+std::shared_ptr<IBlob> compression::decompressFile(const void* data, size_t size, uint32_t maxThreads)
+{
+    return decompressFileRange(data, size, 0, SIZE_MAX, threadsParallelFor(maxThreads));
+}
+
+std::shared_ptr<IBlob> compression::decompressFile(const void* data, size_t size, const parallel_for_t& executor)
+{
+    return decompressFileRange(data, size, 0, SIZE_MAX, executor);
+}
+
+std::shared_ptr<IBlob> compression::decompressFileRange(const void* data, size_t size, uint64_t rangeOffset, size_t rangeSize, uint32_t maxThreads)
+{
+    return decompressFileRange(data, size, rangeOffset, rangeSize, threadsParallelFor(maxThreads));
+}
+
+std::shared_ptr<IBlob> compression::decompressFileRange(const void* data, size_t size, uint64_t rangeOffset, size_t rangeSize, const parallel_for_t& executor)
+{
+    if (!isCompressedFile(data, size))
+        return nullptr;
+
+    CompressedFileHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (header.uncompressedSize > SIZE_MAX || rangeOffset > header.uncompressedSize)
+        return nullptr;
+
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    const uint8_t* blockSizeTable = input + sizeof(header);
+
+    // locate the blocks and validate their sizes before doing any work
+    std::vector<size_t> blockOffsets(header.numBlocks);
+    size_t offset = sizeof(header) + sizeof(uint32_t) * size_t(header.numBlocks);
+    for (uint32_t index = 0; index < header.numBlocks; ++index)
+    {
+        uint32_t blockSize;
+        memcpy(&blockSize, blockSizeTable + sizeof(uint32_t) * index, sizeof(blockSize));
+        blockSize &= ~StoredBlockFlag;
+
+        if (blockSize > size - offset)
+            return nullptr;
+
+        blockOffsets[index] = offset;
+        offset += blockSize;
+    }
+
+    // find the blocks that overlap the requested range
+    const size_t uncompressedSize = size_t(header.uncompressedSize);
+    rangeSize = std::min(rangeSize, uncompressedSize - size_t(rangeOffset));
+    const uint32_t firstBlock = rangeSize ? uint32_t(rangeOffset / header.blockSize) : 0;
+    const uint32_t endBlock = rangeSize ? uint32_t((rangeOffset + rangeSize - 1) / header.blockSize) + 1 : 0;
+    const size_t firstBlockOffset = size_t(firstBlock) * header.blockSize;
+    const size_t outputSize = std::min(size_t(endBlock) * header.blockSize, uncompressedSize) - firstBlockOffset;
+
+    uint8_t* output = static_cast<uint8_t*>(malloc(std::max(outputSize, size_t(1))));
+    if (!output)
+        return nullptr;
+
+    std::atomic<bool> failed = false;
+    parallelFor(endBlock - firstBlock, executor, [&](uint32_t rangeIndex)
+    {
+        const uint32_t index = firstBlock + rangeIndex;
+
+        uint32_t blockSize;
+        memcpy(&blockSize, blockSizeTable + sizeof(uint32_t) * index, sizeof(blockSize));
+
+        size_t blockOutputOffset = size_t(index) * header.blockSize;
+        size_t blockOutputSize = std::min(uncompressedSize - blockOutputOffset, size_t(header.blockSize));
+        uint8_t* blockOutput = output + blockOutputOffset - firstBlockOffset;
+        const uint8_t* block = input + blockOffsets[index];
+
+        if (blockSize & StoredBlockFlag)
+        {
+            if ((blockSize & ~StoredBlockFlag) != blockOutputSize)
+                failed = true;
+            else
+                memcpy(blockOutput, block, blockOutputSize);
+        }
+        else if (!decompressBlock(block, blockSize, blockOutput, blockOutputSize))
+            failed = true;
+    });
+
+    if (failed)
+    {
+        free(output);
+        return nullptr;
+    }
+
+    auto blob = std::make_shared<Blob>(output, outputSize);
+
+    // trim the partial blocks at the ends of the range
+    if (rangeSize == outputSize)
+        return blob;
+
+    return std::make_shared<BlobView>(std::move(blob), size_t(rangeOffset) - firstBlockOffset, rangeSize);
+}
+
+CompressionLayer::CompressionLayer(std::shared_ptr<IFileSystem> fs, parallel_for_t parallelFor)
+    : m_UnderlyingFS(std::move(fs))
+    , m_ParallelFor(std::move(parallelFor))
+{
+}
+
+bool CompressionLayer::folderExists(const std::filesystem::path& name)
+{
+    return m_UnderlyingFS->folderExists(name);
+}
+
+bool CompressionLayer::fileExists(const std::filesystem::path& name)
+{
+    return m_UnderlyingFS->fileExists(name);
+}
+
+std::shared_ptr<IBlob> CompressionLayer::readFile(const std::filesystem::path& name)
+{
+    std::shared_ptr<IBlob> blob = m_UnderlyingFS->readFile(name);
+
+    if (!blob || !compression::isCompressedFile(blob->data(), blob->size()))
+        return blob;
+
+    std::shared_ptr<IBlob> decompressed = compression::decompressFile(blob->data(), blob->size(), m_ParallelFor);
+
+    if (!decompressed)
+        log::warning("Failed to decompress file '%s': the compressed data is corrupt", name.generic_string().c_str());
+
+    return decompressed;
+}
+
+std::shared_ptr<IBlob> CompressionLayer::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    // Read the small header first to find out if the file is compressed, and pass the request through if it's not.
+    std::shared_ptr<IBlob> headerBlob = m_UnderlyingFS->readFileRange(name, 0, sizeof(CompressedFileHeader));
+
+    CompressedFileHeader header;
+    if (!headerBlob || !isValidHeader(headerBlob->data(), headerBlob->size(), header))
+        return headerBlob ? m_UnderlyingFS->readFileRange(name, offset, size) : nullptr;
+
+    if (offset > header.uncompressedSize)
+        return nullptr;
+
+    // Only the blocks that overlap the range are decompressed. The compressed data is read in its entirety,
+    // which is cheap for mapped files and archives.
+    std::shared_ptr<IBlob> blob = m_UnderlyingFS->readFile(name);
+
+    if (!blob)
+        return nullptr;
+
+    std::shared_ptr<IBlob> decompressed = compression::decompressFileRange(blob->data(), blob->size(), offset, size, m_ParallelFor);
+
+    if (!decompressed)
+        log::warning("Failed to decompress file '%s': the compressed data is corrupt", name.generic_string().c_str());
+
+    return decompressed;
+}
+
+bool CompressionLayer::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+    return m_UnderlyingFS->getFileLocation(name, location);
+}
+
+bool CompressionLayer::writeFile(const std::filesystem::path& name, const void* data, size_t size)
+{
+    std::vector<uint8_t> compressed = compression::compressFile(data, size, DefaultBlockSize, m_ParallelFor);
+
+    // keep the file uncompressed unless that makes it smaller, and unless it could be mistaken for a compressed file
+    if (compressed.empty() || (compressed.size() >= size && !compression::isCompressedFile(data, size)))
+        return m_UnderlyingFS->writeFile(name, data, size);
+
+    return m_UnderlyingFS->writeFile(name, compressed.data(), compressed.size());
+}
+
+int CompressionLayer::enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, enumerate_callback_t callback, bool allowDuplicates)
+{
+    return m_UnderlyingFS->enumerateFiles(path, extensions, callback, allowDuplicates);
+}
+
+int CompressionLayer::enumerateDirectories(const std::filesystem::path& path, enumerate_callback_t callback, bool allowDuplicates)
+{
+    return m_UnderlyingFS->enumerateDirectories(path, callback, allowDuplicates);
+}
@@ -0,0 +1,238 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/core/vfs/IOScheduler.h>
+#include <donut/core/log.h>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace donut::vfs;
+
+IOScheduler::IOScheduler(uint32_t numThreads, uint32_t maxBatchSize)
+    : m_MaxBatchSize(std::max(maxBatchSize, 1u))
+{
+    numThreads = std::max(numThreads, 1u);
+    m_Threads.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; ++i)
+        m_Threads.emplace_back(&IOScheduler::threadProc, this);
+}
+
+IOScheduler::~IOScheduler()
+{
+    std::deque<PendingRequest> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Terminate = true;
+        for (auto& queue : m_Queues)
+        {
+            std::move(queue.begin(), queue.end(), std::back_inserter(cancelled));
+            queue.clear();
+        }
+        m_NumPending = 0;
+    }
+    m_WorkAvailable.notify_all();
+
+    for (auto& thread : m_Threads)
+        thread.join();
+
+    for (auto& pending : cancelled)
+    {
+        if (pending.request.callback)
+            pending.request.callback(nullptr);
+        pending.promise.set_value(nullptr);
+    }
+}
+
+std::future<std::shared_ptr<IBlob>> IOScheduler::submit(IORequest request)
+{
+    PendingRequest pending;
+    pending.request = std::move(request);
+    std::future<std::shared_ptr<IBlob>> future = pending.promise.get_future();
+
+    size_t priority = std::min(size_t(pending.request.priority), size_t(IOPriority::Count) - 1);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Queues[priority].push_back(std::move(pending));
+        ++m_NumPending;
+    }
+    m_WorkAvailable.notify_one();
+
+    return future;
+}
+
+void IOScheduler::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Idle.wait(lock, [this]() { return m_NumPending == 0 && m_NumActive == 0; });
+}
+
+size_t IOScheduler::getNumPendingRequests() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_NumPending + m_NumActive;
+}
+
+bool IOScheduler::hasHigherPriorityRequests(IOPriority priority) const
+{
+    for (size_t index = 0; index < size_t(priority); ++index)
+    {
+        if (!m_Queues[index].empty())
+            return true;
+    }
+    return false;
+}
+
+void IOScheduler::complete(PendingRequest& pending)
+{
+    IORequest const& request = pending.request;
+
+    // A read that throws is reported as a failed read, so that the callback still runs.
+    std::shared_ptr<IBlob> blob;
+    if (request.fs)
+    {
+        try
+        {
+            blob = (request.offset == 0 && request.size == IORequest::WholeFile)
+                ? request.fs->readFile(request.name)
+                : request.fs->readFileRange(request.name, request.offset, request.size);
+        }
+        catch (std::exception const& e)
+        {
+            log::warning("Failed to read file '%s': %s", request.name.generic_string().c_str(), e.what());
+            blob = nullptr;
+        }
+        catch (...)
+        {
+            log::warning("Failed to read file '%s'", request.name.generic_string().c_str());
+            blob = nullptr;
+        }
+    }
+
+    // An exception thrown by the callback is passed to the future instead of terminating the IO thread.
+    try
+    {
+        if (request.callback)
+            request.callback(blob);
+    }
+    catch (...)
+    {
+        pending.promise.set_exception(std::current_exception());
+        return;
+    }
+
+    pending.promise.set_value(std::move(blob));
+}
+
+void IOScheduler::threadProc()
+{
+    struct BatchItem
+    {
+        PendingRequest pending;
+        uintptr_t container = 0;
+        std::string fileName; // only used to group reads from individually stored files
+        uint64_t offset = 0;
+    };
+
+    std::vector<BatchItem> batch;
+
+    while (true)
+    {
+        IOPriority priority = IOPriority::Normal;
+        batch.clear();
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [this]() { return m_Terminate || m_NumPending != 0; });
+
+            if (m_Terminate)
+                return;
+
+            // take a batch of requests from the highest priority queue that has any
+            for (size_t index = 0; index < size_t(IOPriority::Count); ++index)
+            {
+                auto& queue = m_Queues[index];
+                if (queue.empty())
+                    continue;
+
+                priority = IOPriority(index);
+                size_t batchSize = std::min(queue.size(), size_t(m_MaxBatchSize));
+                for (size_t i = 0; i < batchSize; ++i)
+                {
+                    batch.push_back(BatchItem{ std::move(queue.front()), 0, std::string(), 0 });
+                    queue.pop_front();
+                }
+                break;
+            }
+
+            m_NumPending -= batch.size();
+            m_NumActive += batch.size();
+        }
+
+        // sort the batch in storage order
+        for (BatchItem& item : batch)
+        {
+            IORequest const& request = item.pending.request;
+            FileLocation location;
+            if (request.fs && request.fs->getFileLocation(request.name, location))
+                item.container = reinterpret_cast<uintptr_t>(location.container);
+            if (!item.container)
+                item.fileName = request.name.generic_string();
+            item.offset = location.offset + request.offset;
+        }
+
+        std::stable_sort(batch.begin(), batch.end(), [](BatchItem const& a, BatchItem const& b)
+        {
+            if (a.container != b.container)
+                return a.container < b.container;
+            if (a.fileName != b.fileName)
+                return a.fileName < b.fileName;
+            return a.offset < b.offset;
+        });
+
+        for (size_t index = 0; index < batch.size(); ++index)
+        {
+            complete(batch[index].pending);
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            --m_NumActive;
+
+            // put the rest of the batch back if more urgent requests have arrived, preserving the order
+            if (index + 1 < batch.size() && !m_Terminate && hasHigherPriorityRequests(priority))
+            {
+                auto& queue = m_Queues[size_t(priority)];
+                for (size_t rest = batch.size() - 1; rest > index; --rest)
+                    queue.push_front(std::move(batch[rest].pending));
+
+                size_t numReturned = batch.size() - index - 1;
+                m_NumActive -= numReturned;
+                m_NumPending += numReturned;
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_NumPending == 0 && m_NumActive == 0)
+                m_Idle.notify_all();
+        }
+    }
+}
@@ -22,6 +22,7 @@
 
 #include <donut/core/vfs/TarFile.h>
 #include <donut/core/log.h>
+#include <algorithm>
 #include <sstream>
 #include <regex>
 #include <cstring>
@@ -146,6 +147,18 @@ TarFile::TarFile(const std::filesystem::path& archivePath)
             m_Files.clear();
             m_Directories.clear();
         }
+        else
+        {
+            // Map the archive for lock-free reads. Keep the file open for the fallback path if that fails.
+            m_ArchiveMapping = MappedFile::open(m_ArchivePath);
+            if (m_ArchiveMapping && m_ArchiveMapping->size() == archiveSize)
+            {
+                fclose(m_ArchiveFile);
+                m_ArchiveFile = nullptr;
+            }
+            else
+                m_ArchiveMapping.reset();
+        }
     }
 }
 
@@ -163,7 +176,7 @@ TarFile::~TarFile()
 
 bool TarFile::isOpen() const
 {
-    return m_ArchiveFile != nullptr;
+    return m_ArchiveMapping || m_ArchiveFile;
 }
 
 bool TarFile::folderExists(const std::filesystem::path& name)
@@ -180,48 +193,84 @@ bool TarFile::fileExists(const std::filesystem::path& name)
     return m_Files.find(normalizedName) != m_Files.end();
 }
 
-std::shared_ptr<IBlob> TarFile::readFile(const std::filesystem::path& name)
+std::shared_ptr<IBlob> TarFile::readArchiveRange(const std::string& name, size_t offset, size_t size)
 {
-    std::string normalizedName = name.lexically_normal().relative_path().generic_string();
-    
-    if (normalizedName.empty())
-        return nullptr;
-    
-    auto entry = m_Files.find(normalizedName);
-
-    if (entry == m_Files.end())
-        return nullptr;
+    if (m_ArchiveMapping)
+        return std::make_shared<MappedBlob>(m_ArchiveMapping, offset, size);
 
     // prevent concurrent file operations from multiple threads from this point on
     std::lock_guard<std::mutex> lockGuard(m_Mutex);
     
-    if (fseeko(m_ArchiveFile, entry->second.offset, SEEK_SET) != 0)
+    if (fseeko(m_ArchiveFile, offset, SEEK_SET) != 0)
     {
         log::warning("Error seeking to offset %ull for file '%s' in tar archive '%s'",
-            entry->second.offset, normalizedName.c_str(), m_ArchivePath.c_str());
+            offset, name.c_str(), m_ArchivePath.c_str());
         return nullptr;
     }
 
-    void* data = malloc(entry->second.size);
+    void* data = malloc(std::max(size, size_t(1)));
 
     if (!data)
         return nullptr;
 
-    size_t sizeRead = fread(data, 1, entry->second.size, m_ArchiveFile);
+    size_t sizeRead = fread(data, 1, size, m_ArchiveFile);
 
-    if (sizeRead != entry->second.size)
+    if (sizeRead != size)
     {
         log::warning("Error reading file '%s' (%ull bytes) from tar archive '%s'", 
-            entry->second.size, normalizedName.c_str(), m_ArchivePath.c_str());
+            size, name.c_str(), m_ArchivePath.c_str());
         free(data);
         return nullptr;
     }
 
-    std::shared_ptr<Blob> blob = std::make_shared<Blob>(data, entry->second.size);
+    std::shared_ptr<Blob> blob = std::make_shared<Blob>(data, size);
 
     return std::static_pointer_cast<IBlob>(blob);
 }
 
+std::shared_ptr<IBlob> TarFile::readFile(const std::filesystem::path& name)
+{
+    std::string normalizedName = name.lexically_normal().relative_path().generic_string();
+    
+    if (normalizedName.empty())
+        return nullptr;
+    
+    auto entry = m_Files.find(normalizedName);
+
+    if (entry == m_Files.end())
+        return nullptr;
+
+    return readArchiveRange(normalizedName, entry->second.offset, entry->second.size);
+}
+
+std::shared_ptr<IBlob> TarFile::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    std::string normalizedName = name.lexically_normal().relative_path().generic_string();
+
+    auto entry = m_Files.find(normalizedName);
+
+    if (entry == m_Files.end() || offset > entry->second.size)
+        return nullptr;
+
+    size = std::min(size, entry->second.size - size_t(offset));
+
+    return readArchiveRange(normalizedName, entry->second.offset + size_t(offset), size);
+}
+
+bool TarFile::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+    std::string normalizedName = name.lexically_normal().relative_path().generic_string();
+
+    auto entry = m_Files.find(normalizedName);
+
+    if (entry == m_Files.end())
+        return false;
+
+    location.container = this;
+    location.offset = entry->second.offset;
+    return true;
+}
+
 bool TarFile::writeFile(const std::filesystem::path&, const void*, size_t)
 {
     // tar files are mounted read-only
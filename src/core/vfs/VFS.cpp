@@ -26,19 +26,28 @@
 #include <fstream>
 #include <cassert>
 #include <algorithm>
+#include <limits>
 #include <utility>
 #include <sstream>
 
 #ifdef WIN32
+#include <Windows.h>
 #include <Shlwapi.h>
 #else
 extern "C" {
 #include <glob.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 }
 #endif // _WIN32
 
 using namespace donut::vfs;
 
+// Files smaller than this are read into memory by NativeFileSystem: mapping them is more expensive than copying.
+static constexpr size_t c_MinMappedFileSize = 64 * 1024;
+
 Blob::Blob(void* data, size_t size)
     : m_data(data)
     , m_size(size)
@@ -67,6 +76,164 @@ Blob::~Blob()
     m_size = 0;
 }
 
+MappedFile::~MappedFile()
+{
+    if (!m_mappedData)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(m_mappedData);
+#else
+    munmap(m_mappedData, m_mappedSize);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path& name)
+{
+    return open(name, 0, std::numeric_limits<size_t>::max());
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+#ifdef WIN32
+    HANDLE file = CreateFileW(name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || offset >= static_cast<uint64_t>(fileSize.QuadPart))
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // Views must start at a multiple of the allocation granularity
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const uint64_t rangeSize = std::min(static_cast<uint64_t>(size), static_cast<uint64_t>(fileSize.QuadPart) - offset);
+    const uint64_t mappedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+    const uint64_t mappedSize = offset - mappedOffset + rangeSize;
+    if (mappedSize > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // PAGE_WRITECOPY + FILE_MAP_COPY: writes go to private pages, see the comment on MappedFile
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return nullptr;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, static_cast<DWORD>(mappedOffset >> 32), static_cast<DWORD>(mappedOffset),
+        static_cast<SIZE_T>(mappedSize));
+    CloseHandle(mapping); // the view keeps the mapping object alive
+    if (!data)
+        return nullptr;
+#else
+    int fd = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || offset >= static_cast<uint64_t>(fileStat.st_size))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // Mappings must start at a page boundary
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t rangeSize = std::min(static_cast<uint64_t>(size), static_cast<uint64_t>(fileStat.st_size) - offset);
+    const uint64_t mappedOffset = offset - offset % pageSize;
+    const uint64_t mappedSize = offset - mappedOffset + rangeSize;
+    if (mappedSize > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // MAP_PRIVATE with write access: writes go to private pages, see the comment on MappedFile
+    void* data = mmap(nullptr, static_cast<size_t>(mappedSize), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(mappedOffset));
+    close(fd); // the mapping keeps the file referenced
+    if (data == MAP_FAILED)
+        return nullptr;
+#endif
+
+    std::shared_ptr<MappedFile> result(new MappedFile());
+    result->m_mappedData = data;
+    result->m_mappedSize = static_cast<size_t>(mappedSize);
+    result->m_data = static_cast<uint8_t*>(data) + (offset - mappedOffset);
+    result->m_size = static_cast<size_t>(rangeSize);
+    return result;
+}
+
+MappedBlob::MappedBlob(std::shared_ptr<MappedFile> file, size_t offset, size_t size)
+    : m_file(std::move(file))
+    , m_data(static_cast<const uint8_t*>(m_file->data()) + offset)
+    , m_size(size)
+{
+    assert(offset + size <= m_file->size());
+}
+
+const void* MappedBlob::data() const
+{
+    return m_data;
+}
+
+size_t MappedBlob::size() const
+{
+    return m_size;
+}
+
+BlobView::BlobView(std::shared_ptr<IBlob> parent, size_t offset, size_t size)
+    : m_parent(std::move(parent))
+    , m_data(static_cast<const uint8_t*>(m_parent->data()) + offset)
+    , m_size(size)
+{
+    assert(offset + size <= m_parent->size());
+}
+
+const void* BlobView::data() const
+{
+    return m_data;
+}
+
+size_t BlobView::size() const
+{
+    return m_size;
+}
+
+std::shared_ptr<IBlob> IFileSystem::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    std::shared_ptr<IBlob> blob = readFile(name);
+
+    if (!blob || offset > blob->size())
+        return nullptr;
+
+    size = std::min(size, blob->size() - size_t(offset));
+
+    if (offset == 0 && size == blob->size())
+        return blob;
+
+    return std::make_shared<BlobView>(std::move(blob), size_t(offset), size);
+}
+
+bool IFileSystem::getFileLocation(const std::filesystem::path&, FileLocation&)
+{
+    return false;
+}
+
+bool IFileSystem::getFileAttributes(const std::filesystem::path&, FileAttributes&)
+{
+    return false;
+}
+
 bool NativeFileSystem::folderExists(const std::filesystem::path& name)
 {
 	return std::filesystem::exists(name) && std::filesystem::is_directory(name);
@@ -81,6 +248,18 @@ std::shared_ptr<IBlob> NativeFileSystem::readFile(const std::filesystem::path& n
 {
     // TODO: better error reporting
 
+    // Map large files instead of copying them. If the file cannot be mapped, fall back to reading it.
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(name, error);
+    if (!error && fileSize >= c_MinMappedFileSize)
+    {
+        if (std::shared_ptr<MappedFile> mappedFile = MappedFile::open(name))
+        {
+            const size_t mappedSize = mappedFile->size();
+            return std::make_shared<MappedBlob>(std::move(mappedFile), 0, mappedSize);
+        }
+    }
+
     std::ifstream file(name, std::ios::binary);
 
     if (!file.is_open())
@@ -122,6 +301,73 @@ std::shared_ptr<IBlob> NativeFileSystem::readFile(const std::filesystem::path& n
     return std::make_shared<Blob>(data, size);
 }
 
+std::shared_ptr<IBlob> NativeFileSystem::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(name, error);
+    if (error || offset > fileSize)
+        return nullptr;
+
+    size = size_t(std::min(uintmax_t(size), fileSize - offset));
+
+    // Large ranges are views into the mapped file, like whole files in readFile.
+    if (size >= c_MinMappedFileSize)
+    {
+        if (std::shared_ptr<MappedFile> mappedFile = MappedFile::open(name, offset, size))
+        {
+            if (mappedFile->size() == size)
+                return std::make_shared<MappedBlob>(std::move(mappedFile), 0, size);
+        }
+    }
+
+    std::ifstream file(name, std::ios::binary);
+
+    if (!file.is_open())
+        return nullptr;
+
+    char* data = static_cast<char*>(malloc(std::max(size, size_t(1))));
+
+    if (data == nullptr)
+        return nullptr;
+
+    file.seekg(std::streamoff(offset), std::ios::beg);
+    file.read(data, std::streamsize(size));
+
+    if (!file.good())
+    {
+        free(data);
+        return nullptr;
+    }
+
+    return std::make_shared<Blob>(data, size);
+}
+
+bool NativeFileSystem::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+    if (!fileExists(name))
+        return false;
+
+    // every native file is its own container
+    location = FileLocation();
+    return true;
+}
+
+bool NativeFileSystem::getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes)
+{
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(name, error);
+    if (error)
+        return false;
+
+    const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(name, error);
+    if (error)
+        return false;
+
+    attributes.size = uint64_t(fileSize);
+    attributes.modificationTime = uint64_t(lastWriteTime.time_since_epoch().count());
+    return true;
+}
+
 bool NativeFileSystem::writeFile(const std::filesystem::path& name, const void* data, size_t size)
 {
     // TODO: better error reporting
@@ -272,6 +518,21 @@ std::shared_ptr<IBlob> RelativeFileSystem::readFile(const std::filesystem::path&
     return m_UnderlyingFS->readFile(m_BasePath / name.relative_path());
 }
 
+std::shared_ptr<IBlob> RelativeFileSystem::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    return m_UnderlyingFS->readFileRange(m_BasePath / name.relative_path(), offset, size);
+}
+
+bool RelativeFileSystem::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+    return m_UnderlyingFS->getFileLocation(m_BasePath / name.relative_path(), location);
+}
+
+bool RelativeFileSystem::getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes)
+{
+    return m_UnderlyingFS->getFileAttributes(m_BasePath / name.relative_path(), attributes);
+}
+
 bool RelativeFileSystem::writeFile(const std::filesystem::path& name, const void* data, size_t size)
 {
     return m_UnderlyingFS->writeFile(m_BasePath / name.relative_path(), data, size);
@@ -384,6 +645,45 @@ std::shared_ptr<IBlob> RootFileSystem::readFile(const std::filesystem::path& nam
     return nullptr;
 }
 
+std::shared_ptr<IBlob> RootFileSystem::readFileRange(const std::filesystem::path& name, uint64_t offset, size_t size)
+{
+    std::filesystem::path relativePath;
+    IFileSystem* fs = nullptr;
+
+    if (findMountPoint(name, &relativePath, &fs))
+    {
+        return fs->readFileRange(relativePath, offset, size);
+    }
+
+    return nullptr;
+}
+
+bool RootFileSystem::getFileLocation(const std::filesystem::path& name, FileLocation& location)
+{
+    std::filesystem::path relativePath;
+    IFileSystem* fs = nullptr;
+
+    if (findMountPoint(name, &relativePath, &fs))
+    {
+        return fs->getFileLocation(relativePath, location);
+    }
+
+    return false;
+}
+
+bool RootFileSystem::getFileAttributes(const std::filesystem::path& name, FileAttributes& attributes)
+{
+    std::filesystem::path relativePath;
+    IFileSystem* fs = nullptr;
+
+    if (findMountPoint(name, &relativePath, &fs))
+    {
+        return fs->getFileAttributes(relativePath, attributes);
+    }
+
+    return false;
+}
+
 bool RootFileSystem::writeFile(const std::filesystem::path& name, const void* data, size_t size)
 {
     std::filesystem::path relativePath;
@@ -564,20 +564,22 @@ namespace donut::engine
         return dataOffset;
     }
 
-    bool LoadDDSTextureFromMemory(TextureData& textureInfo)
+    // Fills the texture description and data layout from the DDS headers in 'data'.
+    // If 'fileSize' is nonzero, the layout is validated against it.
+    static bool ParseDDSHeader(TextureData& textureInfo, const void* data, size_t dataSize, size_t fileSize)
     {
-        if (textureInfo.data->size() < sizeof(uint32_t) + sizeof(DDS_HEADER))
+        if (dataSize < sizeof(uint32_t) + sizeof(DDS_HEADER))
         {
             return false;
         }
 
-        auto dwMagicNumber = *reinterpret_cast<const uint32_t*>(textureInfo.data->data());
+        auto dwMagicNumber = *reinterpret_cast<const uint32_t*>(data);
         if (dwMagicNumber != DDS_MAGIC)
         {
             return false;
         }
 
-        auto header = reinterpret_cast<const DDS_HEADER*>(static_cast<const char*>(textureInfo.data->data()) + sizeof(uint32_t));
+        auto header = reinterpret_cast<const DDS_HEADER*>(static_cast<const char*>(data) + sizeof(uint32_t));
 
         // Verify header to validate DDS file
         if (header->size != sizeof(DDS_HEADER) ||
@@ -592,7 +594,7 @@ namespace donut::engine
             (MAKEFOURCC('D', 'X', '1', '0') == header->ddspf.fourCC))
         {
             // Must be long enough for both headers and magic value
-            if (textureInfo.data->size() < (sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10)))
+            if (dataSize < (sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10)))
             {
                 return false;
             }
@@ -746,12 +748,24 @@ namespace donut::engine
             }
         }
 
-        if (FillTextureInfoOffsets(textureInfo, textureInfo.data->size(), dataOffset) == 0)
+        if (FillTextureInfoOffsets(textureInfo, fileSize, dataOffset) == 0)
             return false;
 
         return true;
     }
 
+    bool LoadDDSTextureFromMemory(TextureData& textureInfo)
+    {
+        return ParseDDSHeader(textureInfo, textureInfo.data->data(), textureInfo.data->size(), textureInfo.data->size());
+    }
+
+    static_assert(DDSMaxHeaderSize == sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10));
+
+    bool LoadDDSTextureHeader(TextureData& textureInfo, const void* headerData, size_t headerSize)
+    {
+        return ParseDDSHeader(textureInfo, headerData, headerSize, 0);
+    }
+
     static nvrhi::TextureHandle CreateDDSTextureInternal(nvrhi::IDevice* device, nvrhi::ICommandList* commandList, TextureData& info, const char* debugName)
     {
         if (!LoadDDSTextureFromMemory(info))
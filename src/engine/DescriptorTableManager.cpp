@@ -127,6 +127,29 @@ nvrhi::BindingSetItem donut::engine::DescriptorTableManager::GetDescriptor(Descr
     return m_Descriptors[index];
 }
 
+void donut::engine::DescriptorTableManager::ReplaceDescriptor(DescriptorIndex index, nvrhi::BindingSetItem item)
+{
+    if (size_t(index) >= m_Descriptors.size() || !m_AllocatedDescriptors[index])
+        return;
+
+    nvrhi::BindingSetItem& descriptor = m_Descriptors[index];
+
+    const auto indexMapEntry = m_DescriptorIndexMap.find(descriptor);
+    if (indexMapEntry != m_DescriptorIndexMap.end() && indexMapEntry->second == index)
+        m_DescriptorIndexMap.erase(indexMapEntry);
+
+    if (item.resourceHandle)
+        item.resourceHandle->AddRef();
+
+    if (descriptor.resourceHandle)
+        descriptor.resourceHandle->Release();
+
+    item.slot = index;
+    descriptor = item;
+    m_DescriptorIndexMap[item] = index;
+    m_Device->writeDescriptorTable(m_DescriptorTable, item);
+}
+
 void donut::engine::DescriptorTableManager::ReleaseDescriptor(DescriptorIndex index)
 {
     nvrhi::BindingSetItem& descriptor = m_Descriptors[index];
@@ -26,11 +26,14 @@
 #include <donut/engine/GltfImporter.h>
 #include <donut/engine/TextureCache.h>
 #include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
 #include <donut/core/vfs/VFS.h>
 #include <donut/core/log.h>
 
 #include "nvrhi/common/misc.h"
 
+#include <chrono>
+
 using namespace donut::math;
 using namespace donut::vfs;
 using namespace donut::engine;
@@ -70,11 +73,24 @@ GltfImporter::GltfImporter(std::shared_ptr<vfs::IFileSystem> fs, std::shared_ptr
 {
 }
 
+void GltfImporter::SetOptimizeMeshes(bool enable, const MeshOptimizationParams& params)
+{
+    m_OptimizeMeshes = enable;
+    m_MeshOptimizationParams = params;
+}
+
+void GltfImporter::SetBuildMeshlets(bool enable, const MeshletBuildParams& params)
+{
+    m_BuildMeshlets = enable;
+    m_MeshletParams = params;
+}
+
 
 struct cgltf_vfs_context
 {
     std::shared_ptr<donut::vfs::IFileSystem> fs;
     std::vector<std::shared_ptr<IBlob>> blobs;
+    std::vector<std::string> fileNames;
 };
 
 static cgltf_result cgltf_read_file_vfs(const struct cgltf_memory_options* memory_options,
@@ -88,6 +104,7 @@ static cgltf_result cgltf_read_file_vfs(const struct cgltf_memory_options* memor
         return cgltf_result_file_not_found;
 
     context->blobs.push_back(blob);
+    context->fileNames.push_back(path);
 
     if (size) *size = blob->size();
     if (data) *data = (void*)blob->data();  // NOLINT(clang-diagnostic-cast-qual)
@@ -638,6 +655,437 @@ static std::pair<const uint8_t*, size_t> cgltf_buffer_iterator(const cgltf_acces
     return std::make_pair(data, stride);
 }
 
+namespace
+{
+    // Describes where the data of one glTF primitive goes in the shared BufferGroup.
+    // Built by the first, serial phase of the mesh import and consumed by the second, parallel phase.
+    struct PrimitiveImportDesc
+    {
+        const cgltf_primitive* prim = nullptr;
+        const cgltf_accessor* positions = nullptr;
+        const cgltf_accessor* normals = nullptr;
+        const cgltf_accessor* tangents = nullptr;
+        const cgltf_accessor* texcoords = nullptr;
+        const cgltf_accessor* jointWeights = nullptr;
+        const cgltf_accessor* jointIndices = nullptr;
+        const cgltf_accessor* radius = nullptr;
+
+        MeshInfo* mesh = nullptr;
+        MeshGeometry* geometry = nullptr;
+
+        size_t indexOffset = 0;  // in BufferGroup::indexData
+        size_t vertexOffset = 0; // in the per-vertex arrays of BufferGroup
+        size_t indexCount = 0;
+
+        // Offsets of the mesh's morph target frames in BufferGroup::morphTargetData, and the number
+        // of leading targets of this primitive that are stored there. A later primitive of the same mesh
+        // with fewer targets discards the data of the remaining targets.
+        const size_t* morphTargetOffsets = nullptr;
+        size_t morphTargetCount = 0;
+    };
+
+    // Phase two of the mesh import: copies and converts the vertex and index streams of one primitive
+    // into the ranges reserved for it in phase one. Primitives write disjoint ranges, so this function
+    // can run concurrently for different primitives. Returns the object space bounds of the primitive.
+    dm::box3 ImportPrimitiveData(
+        const PrimitiveImportDesc& desc,
+        BufferGroup& buffers,
+        bool writeRadius,
+        bool forceRebuildTangents,
+        std::vector<float3>& computedTangents,
+        std::vector<float3>& computedBitangents)
+    {
+        const cgltf_primitive& prim = *desc.prim;
+        const cgltf_accessor* positions = desc.positions;
+        const cgltf_accessor* normals = desc.normals;
+        const cgltf_accessor* tangents = desc.tangents;
+        const cgltf_accessor* texcoords = desc.texcoords;
+        const cgltf_accessor* joint_weights = desc.jointWeights;
+        const cgltf_accessor* joint_indices = desc.jointIndices;
+        const cgltf_accessor* radius = desc.radius;
+        const size_t indexCount = desc.indexCount;
+
+        if (prim.indices)
+        {
+            // copy the indices
+            auto [indexSrc, indexStride] = cgltf_buffer_iterator(prim.indices, 0);
+
+            uint32_t* indexDst = buffers.indexData.data() + desc.indexOffset;
+
+            switch(prim.indices->component_type)
+            {
+            case cgltf_component_type_r_8u:
+                if (!indexStride) indexStride = sizeof(uint8_t);
+                for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
+                {
+                    *indexDst = *(const uint8_t*)indexSrc;
+
+                    indexSrc += indexStride;
+                    indexDst++;
+                }
+                break;
+            case cgltf_component_type_r_16u:
+                if (!indexStride) indexStride = sizeof(uint16_t);
+                for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
+                {
+                    *indexDst = *(const uint16_t*)indexSrc;
+
+                    indexSrc += indexStride;
+                    indexDst++;
+                }
+                break;
+            case cgltf_component_type_r_32u:
+                if (!indexStride) indexStride = sizeof(uint32_t);
+                for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
+                {
+                    *indexDst = *(const uint32_t*)indexSrc;
+
+                    indexSrc += indexStride;
+                    indexDst++;
+                }
+                break;
+            default: 
+                assert(false);
+            }
+        }
+        else
+        {
+            // generate the indices
+            uint32_t* indexDst = buffers.indexData.data() + desc.indexOffset;
+            for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
+            {
+                *indexDst = (uint32_t)i_idx;
+                indexDst++;
+            }
+        }
+
+        dm::box3 bounds = dm::box3::empty();
+
+        if (positions)
+        {
+            auto [positionSrc, positionStride] = cgltf_buffer_iterator(positions, sizeof(float) * 3);
+            float3* positionDst = buffers.positionData.data() + desc.vertexOffset;
+
+            for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
+            {
+                *positionDst = (const float*)positionSrc;
+
+                bounds |= *positionDst;
+
+                positionSrc += positionStride;
+                ++positionDst;
+            }
+        }
+
+        if (radius)
+        {
+            auto [radiusSrc, radiusStride] = cgltf_buffer_iterator(radius, sizeof(float));
+            for (size_t v_idx = 0; v_idx < radius->count; v_idx++)
+            {
+                float radiusValue = *(const float*)radiusSrc;
+
+                // the radius stream is dropped if any primitive doesn't have it, but still contributes to the bounds
+                if (writeRadius)
+                    buffers.radiusData[desc.vertexOffset + v_idx] = radiusValue;
+
+                bounds |= radiusValue;
+
+                radiusSrc += radiusStride;
+            }
+        }
+
+        if (normals)
+        {
+            assert(normals->count == positions->count);
+
+            auto [normalSrc, normalStride] = cgltf_buffer_iterator(normals, sizeof(float) * 3);
+            uint32_t* normalDst = buffers.normalData.data() + desc.vertexOffset;
+
+            for (size_t v_idx = 0; v_idx < normals->count; v_idx++)
+            {
+                float3 normal = (const float*)normalSrc;
+                *normalDst = vectorToSnorm8(normal);
+
+                normalSrc += normalStride;
+                ++normalDst;
+            }
+        }
+
+        if (tangents)
+        {
+            assert(tangents->count == positions->count);
+
+            auto [tangentSrc, tangentStride] = cgltf_buffer_iterator(tangents, sizeof(float) * 4);
+            uint32_t* tangentDst = buffers.tangentData.data() + desc.vertexOffset;
+            
+            for (size_t v_idx = 0; v_idx < tangents->count; v_idx++)
+            {
+                float4 tangent = (const float*)tangentSrc;
+                *tangentDst = vectorToSnorm8(tangent);
+
+                tangentSrc += tangentStride;
+                ++tangentDst;
+            }
+        }
+
+        if (texcoords)
+        {
+            assert(texcoords->count == positions->count);
+
+            auto [texcoordSrc, texcoordStride] = cgltf_buffer_iterator(texcoords, sizeof(float) * 2);
+            float2* texcoordDst = buffers.texcoord1Data.data() + desc.vertexOffset;
+
+            for (size_t v_idx = 0; v_idx < texcoords->count; v_idx++)
+            {
+                *texcoordDst = (const float*)texcoordSrc;
+
+                texcoordSrc += texcoordStride;
+                ++texcoordDst;
+            }
+        }
+        else
+        {
+            float2* texcoordDst = buffers.texcoord1Data.data() + desc.vertexOffset;
+            for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
+            {
+                *texcoordDst = float2(0.f);
+                ++texcoordDst;
+            }
+        }
+
+        if (normals && texcoords && (!tangents || forceRebuildTangents))
+        {
+            auto [positionSrc, positionStride] = cgltf_buffer_iterator(positions, sizeof(float) * 3);
+            auto [texcoordSrc, texcoordStride] = cgltf_buffer_iterator(texcoords, sizeof(float) * 2);
+            auto [normalSrc, normalStride] = cgltf_buffer_iterator(normals, sizeof(float) * 3);
+            const uint32_t* indexSrc = buffers.indexData.data() + desc.indexOffset;
+
+            computedTangents.resize(positions->count);
+            std::fill(computedTangents.begin(), computedTangents.end(), float3(0.f));
+
+            computedBitangents.resize(positions->count);
+            std::fill(computedBitangents.begin(), computedBitangents.end(), float3(0.f));
+
+            for (size_t t_idx = 0; t_idx < indexCount / 3; t_idx++)
+            {
+                uint3 tri = indexSrc;
+                indexSrc += 3;
+
+                float3 p0 = (const float*)(positionSrc + positionStride * tri.x);
+                float3 p1 = (const float*)(positionSrc + positionStride * tri.y);
+                float3 p2 = (const float*)(positionSrc + positionStride * tri.z);
+
+                float2 t0 = (const float*)(texcoordSrc + texcoordStride * tri.x);
+                float2 t1 = (const float*)(texcoordSrc + texcoordStride * tri.y);
+                float2 t2 = (const float*)(texcoordSrc + texcoordStride * tri.z);
+
+                float3 dPds = p1 - p0;
+                float3 dPdt = p2 - p0;
+
+                float2 dTds = t1 - t0;
+                float2 dTdt = t2 - t0;
+                float r = 1.0f / (dTds.x * dTdt.y - dTds.y * dTdt.x);
+                float3 tangent = r * (dPds * dTdt.y - dPdt * dTds.y);
+                float3 bitangent = r * (dPdt * dTds.x - dPds * dTdt.x);
+
+                float tangentLength = length(tangent);
+                float bitangentLength = length(bitangent);
+                if (tangentLength > 0 && bitangentLength > 0)
+                {
+                    tangent /= tangentLength;
+                    bitangent /= bitangentLength;
+
+                    computedTangents[tri.x] += tangent;
+                    computedTangents[tri.y] += tangent;
+                    computedTangents[tri.z] += tangent;
+                    computedBitangents[tri.x] += bitangent;
+                    computedBitangents[tri.y] += bitangent;
+                    computedBitangents[tri.z] += bitangent;
+                }
+            }
+
+            uint8_t* tangentSrc = nullptr;
+            size_t tangentStride = 0;
+            if (tangents)
+            {
+                auto pair = cgltf_buffer_iterator(tangents, sizeof(float) * 4);
+                tangentSrc = const_cast<uint8_t*>(pair.first);
+                tangentStride = pair.second;
+            }
+
+            uint32_t* tangentDst = buffers.tangentData.data() + desc.vertexOffset;
+
+            for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
+            {
+                float3 normal = (const float*)normalSrc;
+                float3 tangent = computedTangents[v_idx];
+                float3 bitangent = computedBitangents[v_idx];
+
+                float sign = 0;
+                float tangentLength = length(tangent);
+                float bitangentLength = length(bitangent);
+                if (tangentLength > 0 && bitangentLength > 0)
+                {
+                    tangent /= tangentLength;
+                    bitangent /= bitangentLength;
+                    float3 cross_b = cross(normal, tangent);
+                    sign = (dot(cross_b, bitangent) > 0) ? -1.f : 1.f;
+                }
+
+                *tangentDst = vectorToSnorm8(float4(tangent, sign));
+
+                if (forceRebuildTangents && tangents)
+                {
+                    *(float4*)tangentSrc = float4(tangent, sign);
+                    tangentSrc += tangentStride;
+                }
+                
+                normalSrc += normalStride;
+                ++tangentDst;
+            }
+        }
+
+        if (joint_indices)
+        {
+            assert(joint_indices->count == positions->count);
+
+            auto [jointSrc, jointStride] = cgltf_buffer_iterator(joint_indices, 0);
+            vector<uint16_t, 4>* jointDst = buffers.jointData.data() + desc.vertexOffset;
+
+            if (joint_indices->component_type == cgltf_component_type_r_8u)
+            {
+                if (!jointStride) jointStride = sizeof(uint8_t) * 4;
+
+                for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
+                {
+                    *jointDst = dm::vector<uint16_t, 4>(jointSrc[0], jointSrc[1], jointSrc[2], jointSrc[3]);
+
+                    jointSrc += jointStride;
+                    ++jointDst;
+                }
+            }
+            else
+            {
+                assert(joint_indices->component_type == cgltf_component_type_r_16u);
+
+                if (!jointStride) jointStride = sizeof(uint16_t) * 4;
+
+                for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
+                {
+                    const uint16_t* jointSrcUshort = (const uint16_t*)jointSrc;
+                    *jointDst = dm::vector<uint16_t, 4>(jointSrcUshort[0], jointSrcUshort[1], jointSrcUshort[2], jointSrcUshort[3]);
+
+                    jointSrc += jointStride;
+                    ++jointDst;
+                }
+            }
+        }
+
+        if (joint_weights)
+        {
+            assert(joint_weights->count == positions->count);
+
+            auto [weightSrc, weightStride] = cgltf_buffer_iterator(joint_weights, 0);
+            float4* weightDst = buffers.weightData.data() + desc.vertexOffset;
+
+            if (joint_weights->component_type == cgltf_component_type_r_8u)
+            {
+                if (!weightStride) weightStride = sizeof(uint8_t) * 4;
+
+                for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
+                {
+                    *weightDst = dm::float4(
+                        float(weightSrc[0]) / 255.f,
+                        float(weightSrc[1]) / 255.f,
+                        float(weightSrc[2]) / 255.f,
+                        float(weightSrc[3]) / 255.f);
+
+                    weightSrc += weightStride;
+                    ++weightDst;
+                }
+            }
+            else if (joint_weights->component_type == cgltf_component_type_r_16u)
+            {
+                if (!weightStride) weightStride = sizeof(uint16_t) * 4;
+
+                for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
+                {
+                    const uint16_t* weightSrcUshort = (const uint16_t*)weightSrc;
+                    *weightDst = dm::float4(
+                        float(weightSrcUshort[0]) / 65535.f,
+                        float(weightSrcUshort[1]) / 65535.f,
+                        float(weightSrcUshort[2]) / 65535.f,
+                        float(weightSrcUshort[3]) / 65535.f);
+                    
+                    weightSrc += weightStride;
+                    ++weightDst;
+                }
+            }
+            else
+            {
+                assert(joint_weights->component_type == cgltf_component_type_r_32f);
+
+                if (!weightStride) weightStride = sizeof(float) * 4;
+
+                for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
+                {
+                    *weightDst = (const float*)weightSrc;
+
+                    weightSrc += weightStride;
+                    ++weightDst;
+                }
+            }
+        }
+
+        for (uint32_t target_idx = 0; target_idx < prim.targets_count; target_idx++)
+        {
+            const cgltf_morph_target& target = prim.targets[target_idx];
+            const cgltf_accessor* target_positions = nullptr;
+
+            for (size_t attr_idx = 0; attr_idx < target.attributes_count; attr_idx++)
+            {
+                const cgltf_attribute& attr = target.attributes[attr_idx];
+                switch (attr.type)
+                {
+                case cgltf_attribute_type_position:
+                    assert(attr.data->type == cgltf_type_vec3);
+                    assert(attr.data->component_type == cgltf_component_type_r_32f);
+                    target_positions = attr.data;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            if (target_positions)
+            {
+                auto [morphTargetPositionSrc, morphTargetPositionStride] = cgltf_buffer_iterator(target_positions, sizeof(float) * 3);
+
+                float4* morphTargetDst = (target_idx < desc.morphTargetCount)
+                    ? buffers.morphTargetData.data() + desc.morphTargetOffsets[target_idx] + desc.vertexOffset
+                    : nullptr;
+
+                for (size_t v_idx = 0; v_idx < target_positions->count; v_idx++)
+                {
+                    float3 morphTargetPosition = *(const float3*)morphTargetPositionSrc;
+
+                    bounds |= morphTargetPosition;
+
+                    if (morphTargetDst)
+                    {
+                        *morphTargetDst = float4(morphTargetPosition, 0.0f);
+                        ++morphTargetDst;
+                    }
+
+                    morphTargetPositionSrc += morphTargetPositionStride;
+                }
+            }
+        }
+
+        return bounds;
+    }
+}
+
 bool GltfImporter::Load(
     const std::filesystem::path& fileName,
     TextureCache& textureCache,
@@ -654,6 +1102,7 @@ bool GltfImporter::Load(
     constexpr bool c_SearchForDds = true;
 
     result.rootNode.reset();
+    result.sourceFiles.clear();
 
     cgltf_vfs_context vfsContext;
     vfsContext.fs = m_fs;
@@ -1065,11 +1514,18 @@ bool GltfImporter::Load(
 
     std::unordered_map<const cgltf_mesh*, std::shared_ptr<MeshInfo>> meshMap;
 
-    std::vector<float3> computedTangents;
-    std::vector<float3> computedBitangents;
     std::vector<std::shared_ptr<MeshInfo>> meshes;
     std::shared_ptr<Material> emptyMaterial;
 
+    // Mesh import, phase one: create the meshes and geometries, and assign every primitive
+    // its ranges in the shared buffers. This is cheap and runs serially.
+    auto meshLayoutStartTime = std::chrono::steady_clock::now();
+
+    std::vector<PrimitiveImportDesc> primitives;
+    std::vector<std::vector<size_t>> morphTargetOffsets(objects->meshes_count);
+    size_t morphTargetDataSize = 0;
+    bool allPrimitivesHaveRadius = true;
+
     for (size_t mesh_idx = 0; mesh_idx < objects->meshes_count; mesh_idx++)
     {
         const cgltf_mesh& mesh = objects->meshes[mesh_idx];
@@ -1083,8 +1539,11 @@ bool GltfImporter::Load(
 
         meshMap[&mesh] = minfo;
 
-        size_t morphTargetDataCount = 0;
-        std::vector<std::vector<dm::float3>> morphTargetData;
+        const size_t firstPrimitive = primitives.size();
+
+        // Number of vertices in each morph target frame of the mesh: either all vertices in the model or zero.
+        // The frames are sized by the last primitive of the mesh that has morph targets.
+        std::vector<size_t> morphTargetFrameSizes;
 
         for (size_t prim_idx = 0; prim_idx < mesh.primitives_count; prim_idx++)
         {
@@ -1112,13 +1571,9 @@ bool GltfImporter::Load(
                 assert(prim.indices->type == cgltf_type_scalar);
             }
 
-            const cgltf_accessor* positions = nullptr;
-            const cgltf_accessor* normals = nullptr;
-            const cgltf_accessor* tangents = nullptr;
-            const cgltf_accessor* texcoords = nullptr;
-            const cgltf_accessor* joint_weights = nullptr;
-            const cgltf_accessor* joint_indices = nullptr;
-            const cgltf_accessor* radius = nullptr;
+            PrimitiveImportDesc desc;
+            desc.prim = &prim;
+            desc.mesh = minfo.get();
             
             for (size_t attr_idx = 0; attr_idx < prim.attributes_count; attr_idx++)
             {
@@ -1129,40 +1584,40 @@ bool GltfImporter::Load(
                 case cgltf_attribute_type_position:
                     assert(attr.data->type == cgltf_type_vec3);
                     assert(attr.data->component_type == cgltf_component_type_r_32f);
-                    positions = attr.data;
+                    desc.positions = attr.data;
                     break;
                 case cgltf_attribute_type_normal:
                     assert(attr.data->type == cgltf_type_vec3);
                     assert(attr.data->component_type == cgltf_component_type_r_32f);
-                    normals = attr.data;
+                    desc.normals = attr.data;
                     break;
                 case cgltf_attribute_type_tangent:
                     assert(attr.data->type == cgltf_type_vec4);
                     assert(attr.data->component_type == cgltf_component_type_r_32f);
-                    tangents = attr.data;
+                    desc.tangents = attr.data;
                     break;
                 case cgltf_attribute_type_texcoord:
                     assert(attr.data->type == cgltf_type_vec2);
                     assert(attr.data->component_type == cgltf_component_type_r_32f);
                     if (attr.index == 0)
-                        texcoords = attr.data;
+                        desc.texcoords = attr.data;
                     break;
                 case cgltf_attribute_type_joints:
                     assert(attr.data->type == cgltf_type_vec4);
                     assert(attr.data->component_type == cgltf_component_type_r_8u || attr.data->component_type == cgltf_component_type_r_16u);
-                    joint_indices = attr.data;
+                    desc.jointIndices = attr.data;
                     break;
                 case cgltf_attribute_type_weights:
                     assert(attr.data->type == cgltf_type_vec4);
                     assert(attr.data->component_type == cgltf_component_type_r_8u || attr.data->component_type == cgltf_component_type_r_16u || attr.data->component_type == cgltf_component_type_r_32f);
-                    joint_weights = attr.data;
+                    desc.jointWeights = attr.data;
                     break;
                 case cgltf_attribute_type_custom:
                     if (strncmp(attr.name, "_RADIUS", 7) == 0)
                     {
                         assert(attr.data->type == cgltf_type_scalar);
                         assert(attr.data->component_type == cgltf_component_type_r_32f);
-                        radius = attr.data;
+                        desc.radius = attr.data;
                     }
                     break;
                 default:
@@ -1170,352 +1625,16 @@ bool GltfImporter::Load(
                 }
             }
 
-            assert(positions);
-
-            size_t indexCount = 0;
-
-            if (prim.indices)
-            {
-                indexCount = prim.indices->count;
-
-                // copy the indices
-                auto [indexSrc, indexStride] = cgltf_buffer_iterator(prim.indices, 0);
-
-                uint32_t* indexDst = buffers->indexData.data() + totalIndices;
-
-                switch(prim.indices->component_type)
-                {
-                case cgltf_component_type_r_8u:
-                    if (!indexStride) indexStride = sizeof(uint8_t);
-                    for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
-                    {
-                        *indexDst = *(const uint8_t*)indexSrc;
-
-                        indexSrc += indexStride;
-                        indexDst++;
-                    }
-                    break;
-                case cgltf_component_type_r_16u:
-                    if (!indexStride) indexStride = sizeof(uint16_t);
-                    for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
-                    {
-                        *indexDst = *(const uint16_t*)indexSrc;
-
-                        indexSrc += indexStride;
-                        indexDst++;
-                    }
-                    break;
-                case cgltf_component_type_r_32u:
-                    if (!indexStride) indexStride = sizeof(uint32_t);
-                    for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
-                    {
-                        *indexDst = *(const uint32_t*)indexSrc;
-
-                        indexSrc += indexStride;
-                        indexDst++;
-                    }
-                    break;
-                default: 
-                    assert(false);
-                }
-            }
-            else
-            {
-                indexCount = positions->count;
-
-                // generate the indices
-                uint32_t* indexDst = buffers->indexData.data() + totalIndices;
-                for (size_t i_idx = 0; i_idx < indexCount; i_idx++)
-                {
-                    *indexDst = (uint32_t)i_idx;
-                    indexDst++;
-                }
-            }
-
-            dm::box3 bounds = dm::box3::empty();
-
-            if (positions)
-            {
-                auto [positionSrc, positionStride] = cgltf_buffer_iterator(positions, sizeof(float) * 3);
-                float3* positionDst = buffers->positionData.data() + totalVertices;
-
-                for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
-                {
-                    *positionDst = (const float*)positionSrc;
-
-                    bounds |= *positionDst;
-
-                    positionSrc += positionStride;
-                    ++positionDst;
-                }
-            }
-
-            if (radius)
-            {
-                auto [radiusSrc, radiusStride] = cgltf_buffer_iterator(radius, sizeof(float));
-                float* radiusDst = buffers->radiusData.data() + totalVertices;
-                for (size_t v_idx = 0; v_idx < radius->count; v_idx++)
-                {
-                    *radiusDst = *(const float*)radiusSrc;
-
-                    bounds |= *radiusDst;
-
-                    radiusSrc += radiusStride;
-                    ++radiusDst;
-                }
-            }
-            else
-            {
-                buffers->radiusData.clear();
-            }
-
-            if (normals)
-            {
-                assert(normals->count == positions->count);
-
-                auto [normalSrc, normalStride] = cgltf_buffer_iterator(normals, sizeof(float) * 3);
-                uint32_t* normalDst = buffers->normalData.data() + totalVertices;
-
-                for (size_t v_idx = 0; v_idx < normals->count; v_idx++)
-                {
-                    float3 normal = (const float*)normalSrc;
-                    *normalDst = vectorToSnorm8(normal);
-
-                    normalSrc += normalStride;
-                    ++normalDst;
-                }
-            }
-
-            if (tangents)
-            {
-                assert(tangents->count == positions->count);
+            assert(desc.positions);
 
-                auto [tangentSrc, tangentStride] = cgltf_buffer_iterator(tangents, sizeof(float) * 4);
-                uint32_t* tangentDst = buffers->tangentData.data() + totalVertices;
-                
-                for (size_t v_idx = 0; v_idx < tangents->count; v_idx++)
-                {
-                    float4 tangent = (const float*)tangentSrc;
-                    *tangentDst = vectorToSnorm8(tangent);
-
-                    tangentSrc += tangentStride;
-                    ++tangentDst;
-                }
-            }
-
-            if (texcoords)
-            {
-                assert(texcoords->count == positions->count);
-
-                auto [texcoordSrc, texcoordStride] = cgltf_buffer_iterator(texcoords, sizeof(float) * 2);
-                float2* texcoordDst = buffers->texcoord1Data.data() + totalVertices;
+            desc.indexCount = prim.indices ? prim.indices->count : desc.positions->count;
 
-                for (size_t v_idx = 0; v_idx < texcoords->count; v_idx++)
-                {
-                    *texcoordDst = (const float*)texcoordSrc;
+            if (!desc.radius)
+                allPrimitivesHaveRadius = false;
 
-                    texcoordSrc += texcoordStride;
-                    ++texcoordDst;
-                }
-            }
-            else
-            {
-                float2* texcoordDst = buffers->texcoord1Data.data() + totalVertices;
-                for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
-                {
-                    *texcoordDst = float2(0.f);
-                    ++texcoordDst;
-                }
-            }
-
-            if (normals && texcoords && (!tangents || c_ForceRebuildTangents))
-            {
-                auto [positionSrc, positionStride] = cgltf_buffer_iterator(positions, sizeof(float) * 3);
-                auto [texcoordSrc, texcoordStride] = cgltf_buffer_iterator(texcoords, sizeof(float) * 2);
-                auto [normalSrc, normalStride] = cgltf_buffer_iterator(normals, sizeof(float) * 3);
-                const uint32_t* indexSrc = buffers->indexData.data() + totalIndices;
-
-                computedTangents.resize(positions->count);
-                std::fill(computedTangents.begin(), computedTangents.end(), float3(0.f));
-
-                computedBitangents.resize(positions->count);
-                std::fill(computedBitangents.begin(), computedBitangents.end(), float3(0.f));
-
-                for (size_t t_idx = 0; t_idx < indexCount / 3; t_idx++)
-                {
-                    uint3 tri = indexSrc;
-                    indexSrc += 3;
-
-                    float3 p0 = (const float*)(positionSrc + positionStride * tri.x);
-                    float3 p1 = (const float*)(positionSrc + positionStride * tri.y);
-                    float3 p2 = (const float*)(positionSrc + positionStride * tri.z);
-
-                    float2 t0 = (const float*)(texcoordSrc + texcoordStride * tri.x);
-                    float2 t1 = (const float*)(texcoordSrc + texcoordStride * tri.y);
-                    float2 t2 = (const float*)(texcoordSrc + texcoordStride * tri.z);
-
-                    float3 dPds = p1 - p0;
-                    float3 dPdt = p2 - p0;
-
-                    float2 dTds = t1 - t0;
-                    float2 dTdt = t2 - t0;
-                    float r = 1.0f / (dTds.x * dTdt.y - dTds.y * dTdt.x);
-                    float3 tangent = r * (dPds * dTdt.y - dPdt * dTds.y);
-                    float3 bitangent = r * (dPdt * dTds.x - dPds * dTdt.x);
-
-                    float tangentLength = length(tangent);
-                    float bitangentLength = length(bitangent);
-                    if (tangentLength > 0 && bitangentLength > 0)
-                    {
-                        tangent /= tangentLength;
-                        bitangent /= bitangentLength;
-
-                        computedTangents[tri.x] += tangent;
-                        computedTangents[tri.y] += tangent;
-                        computedTangents[tri.z] += tangent;
-                        computedBitangents[tri.x] += bitangent;
-                        computedBitangents[tri.y] += bitangent;
-                        computedBitangents[tri.z] += bitangent;
-                    }
-                }
-
-                uint8_t* tangentSrc = nullptr;
-                size_t tangentStride = 0;
-                if (tangents)
-                {
-                    auto pair = cgltf_buffer_iterator(tangents, sizeof(float) * 4);
-                    tangentSrc = const_cast<uint8_t*>(pair.first);
-                    tangentStride = pair.second;
-                }
-
-                uint32_t* tangentDst = buffers->tangentData.data() + totalVertices;
-
-                for (size_t v_idx = 0; v_idx < positions->count; v_idx++)
-                {
-                    float3 normal = (const float*)normalSrc;
-                    float3 tangent = computedTangents[v_idx];
-                    float3 bitangent = computedBitangents[v_idx];
-
-                    float sign = 0;
-                    float tangentLength = length(tangent);
-                    float bitangentLength = length(bitangent);
-                    if (tangentLength > 0 && bitangentLength > 0)
-                    {
-                        tangent /= tangentLength;
-                        bitangent /= bitangentLength;
-                        float3 cross_b = cross(normal, tangent);
-                        sign = (dot(cross_b, bitangent) > 0) ? -1.f : 1.f;
-                    }
-
-                    *tangentDst = vectorToSnorm8(float4(tangent, sign));
-
-                    if (c_ForceRebuildTangents && tangents)
-                    {
-                        *(float4*)tangentSrc = float4(tangent, sign);
-                        tangentSrc += tangentStride;
-                    }
-                    
-                    normalSrc += normalStride;
-                    ++tangentDst;
-                }
-            }
-
-            if (joint_indices)
-            {
+            if (desc.jointIndices || desc.jointWeights)
                 minfo->isSkinPrototype = true;
 
-                assert(joint_indices->count == positions->count);
-
-                auto [jointSrc, jointStride] = cgltf_buffer_iterator(joint_indices, 0);
-                vector<uint16_t, 4>* jointDst = buffers->jointData.data() + totalVertices;
-
-                if (joint_indices->component_type == cgltf_component_type_r_8u)
-                {
-                    if (!jointStride) jointStride = sizeof(uint8_t) * 4;
-
-                    for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
-                    {
-                        *jointDst = dm::vector<uint16_t, 4>(jointSrc[0], jointSrc[1], jointSrc[2], jointSrc[3]);
-
-                        jointSrc += jointStride;
-                        ++jointDst;
-                    }
-                }
-                else
-                {
-                    assert(joint_indices->component_type == cgltf_component_type_r_16u);
-
-                    if (!jointStride) jointStride = sizeof(uint16_t) * 4;
-
-                    for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
-                    {
-                        const uint16_t* jointSrcUshort = (const uint16_t*)jointSrc;
-                        *jointDst = dm::vector<uint16_t, 4>(jointSrcUshort[0], jointSrcUshort[1], jointSrcUshort[2], jointSrcUshort[3]);
-
-                        jointSrc += jointStride;
-                        ++jointDst;
-                    }
-                }
-            }
-
-            if (joint_weights)
-            {
-                minfo->isSkinPrototype = true;
-
-                assert(joint_weights->count == positions->count);
-
-                auto [weightSrc, weightStride] = cgltf_buffer_iterator(joint_weights, 0);
-                float4* weightDst = buffers->weightData.data() + totalVertices;
-
-                if (joint_weights->component_type == cgltf_component_type_r_8u)
-                {
-                    if (!weightStride) weightStride = sizeof(uint8_t) * 4;
-
-                    for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
-                    {
-                        *weightDst = dm::float4(
-                            float(weightSrc[0]) / 255.f,
-                            float(weightSrc[1]) / 255.f,
-                            float(weightSrc[2]) / 255.f,
-                            float(weightSrc[3]) / 255.f);
-
-                        weightSrc += weightStride;
-                        ++weightDst;
-                    }
-                }
-                else if (joint_weights->component_type == cgltf_component_type_r_16u)
-                {
-                    if (!weightStride) weightStride = sizeof(uint16_t) * 4;
-
-                    for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
-                    {
-                        const uint16_t* weightSrcUshort = (const uint16_t*)weightSrc;
-                        *weightDst = dm::float4(
-                            float(weightSrcUshort[0]) / 65535.f,
-                            float(weightSrcUshort[1]) / 65535.f,
-                            float(weightSrcUshort[2]) / 65535.f,
-                            float(weightSrcUshort[3]) / 65535.f);
-                        
-                        weightSrc += weightStride;
-                        ++weightDst;
-                    }
-                }
-                else
-                {
-                    assert(joint_weights->component_type == cgltf_component_type_r_32f);
-
-                    if (!weightStride) weightStride = sizeof(float) * 4;
-
-                    for (size_t v_idx = 0; v_idx < joint_indices->count; v_idx++)
-                    {
-                        *weightDst = (const float*)weightSrc;
-
-                        weightSrc += weightStride;
-                        ++weightDst;
-                    }
-                }
-            }
-
             auto geometry = m_SceneTypeFactory->CreateMeshGeometry();
             if (prim.material)
             {
@@ -1535,56 +1654,23 @@ bool GltfImporter::Load(
             if (prim.targets_count > 0)
             {
                 minfo->isMorphTargetAnimationMesh = true;
-                morphTargetData.resize(prim.targets_count);
+                morphTargetFrameSizes.resize(prim.targets_count);
 
                 for (uint32_t target_idx = 0; target_idx < prim.targets_count; target_idx++)
                 {
                     const cgltf_morph_target& target = prim.targets[target_idx];
-                    const cgltf_accessor* target_positions = nullptr;
-
                     for (size_t attr_idx = 0; attr_idx < target.attributes_count; attr_idx++)
                     {
-                        const cgltf_attribute& attr = target.attributes[attr_idx];
-                        switch (attr.type)
-                        {
-                        case cgltf_attribute_type_position:
-                            assert(attr.data->type == cgltf_type_vec3);
-                            assert(attr.data->component_type == cgltf_component_type_r_32f);
-                            target_positions = attr.data;
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-
-                    if (target_positions)
-                    {
-                        auto [morphTargetPositionSrc, morphTargetPositionStride] = cgltf_buffer_iterator(target_positions, sizeof(float) * 3);
-
-                        auto& morphTargetCurrentFrameData = morphTargetData[target_idx];
-                        morphTargetCurrentFrameData.resize(morphTargetTotalVertices);
-
-                        float3* morphTargetCurrentData = morphTargetCurrentFrameData.data() + totalVertices;
-                        for (size_t v_idx = 0; v_idx < target_positions->count; v_idx++)
-                        {
-                            *morphTargetCurrentData = *(const float3*)morphTargetPositionSrc;
-
-                            bounds |= *morphTargetCurrentData;
-
-                            morphTargetPositionSrc += morphTargetPositionStride;
-                            ++morphTargetCurrentData;
-                        }
-
-                        morphTargetDataCount += target_positions->count;
+                        if (target.attributes[attr_idx].type == cgltf_attribute_type_position)
+                            morphTargetFrameSizes[target_idx] = morphTargetTotalVertices;
                     }
                 }
             }
 
             geometry->indexOffsetInMesh = minfo->totalIndices;
             geometry->vertexOffsetInMesh = minfo->totalVertices;
-            geometry->numIndices = (uint32_t)indexCount;
-            geometry->numVertices = (uint32_t)positions->count;
-            geometry->objectSpaceBounds = bounds;
+            geometry->numIndices = (uint32_t)desc.indexCount;
+            geometry->numVertices = (uint32_t)desc.positions->count;
             switch (prim.type)
             {
                 case cgltf_primitive_type_triangles:
@@ -1600,38 +1686,141 @@ bool GltfImporter::Load(
                     break;
             }
 
-            minfo->objectSpaceBounds |= bounds;
             minfo->totalIndices += geometry->numIndices;
             minfo->totalVertices += geometry->numVertices;
             minfo->geometries.push_back(geometry);
 
+            desc.geometry = geometry.get();
+            desc.indexOffset = totalIndices;
+            desc.vertexOffset = totalVertices;
+            primitives.push_back(desc);
+
             totalIndices += geometry->numIndices;
             totalVertices += geometry->numVertices;
         }
 
-        if (morphTargetData.size() > 0)
+        if (!morphTargetFrameSizes.empty())
         {
-            const size_t morphTargetFrameBufferSize = morphTargetData[0].size() * sizeof(float4);
-            buffers->morphTargetData.reserve(morphTargetDataCount);
-            buffers->morphTargetBufferRange.reserve(morphTargetData.size());
+            // Lay out the morph target frames of this mesh one after another in BufferGroup::morphTargetData.
+            // Note: the buffer ranges are relative to the first frame of the mesh.
+            const size_t morphTargetFrameBufferSize = morphTargetFrameSizes[0] * sizeof(float4);
+            std::vector<size_t>& offsets = morphTargetOffsets[mesh_idx];
 
             size_t morphTargetDataOffsetCounter = 0;
-            for (const auto& morphTargetCurrentFrameData : morphTargetData)
+            for (size_t frameSize : morphTargetFrameSizes)
             {
                 nvrhi::BufferRange range = {};
                 range.byteOffset = morphTargetDataOffsetCounter * sizeof(float4);
                 range.byteSize = morphTargetFrameBufferSize;
                 buffers->morphTargetBufferRange.push_back(range);
 
-                for (const auto& morphTargetCurrentData : morphTargetCurrentFrameData)
+                offsets.push_back(morphTargetDataSize);
+                morphTargetDataSize += frameSize;
+                morphTargetDataOffsetCounter += frameSize;
+            }
+        }
+
+        // Only the targets that are not discarded by a later primitive with fewer targets are stored
+        size_t morphTargetLimit = morphTargetFrameSizes.size();
+        for (size_t index = primitives.size(); index-- > firstPrimitive; )
+        {
+            PrimitiveImportDesc& desc = primitives[index];
+            desc.morphTargetOffsets = morphTargetOffsets[mesh_idx].data();
+            desc.morphTargetCount = std::min(desc.prim->targets_count, morphTargetLimit);
+            if (desc.prim->targets_count > 0)
+                morphTargetLimit = std::min(desc.prim->targets_count, morphTargetLimit);
+        }
+    }
+
+    if (!allPrimitivesHaveRadius)
+        buffers->radiusData.clear();
+
+    buffers->morphTargetData.resize(morphTargetDataSize, float4(0.f));
+
+    auto meshDataStartTime = std::chrono::steady_clock::now();
+
+    // Mesh import, phase two: fill the vertex and index streams. The primitives are imported in batches
+    // of roughly c_MinVerticesPerImportTask vertices on the thread pool. Rebuilding tangents writes
+    // into the source buffers, which can be shared between primitives, so that mode stays serial.
+    constexpr size_t c_MinVerticesPerImportTask = 16384;
+
+    auto importPrimitives = [&primitives, &buffers, allPrimitivesHaveRadius](size_t begin, size_t end)
+    {
+        std::vector<float3> computedTangents;
+        std::vector<float3> computedBitangents;
+        for (size_t index = begin; index < end; ++index)
+        {
+            PrimitiveImportDesc& desc = primitives[index];
+            desc.geometry->objectSpaceBounds = ImportPrimitiveData(desc, *buffers, allPrimitivesHaveRadius,
+                c_ForceRebuildTangents, computedTangents, computedBitangents);
+        }
+    };
+
+    if (threadPool && !c_ForceRebuildTangents && primitives.size() > 1)
+    {
+        ThreadPoolTaskGroup taskGroup;
+        size_t batchBegin = 0;
+        size_t batchVertices = 0;
+        for (size_t index = 0; index < primitives.size(); ++index)
+        {
+            batchVertices += primitives[index].positions->count;
+            if (batchVertices >= c_MinVerticesPerImportTask || index + 1 == primitives.size())
+            {
+                threadPool->AddTask(taskGroup, [&importPrimitives, batchBegin, batchEnd = index + 1]()
                 {
-                    buffers->morphTargetData.push_back(float4(morphTargetCurrentData, 0.0f));
-                    ++morphTargetDataOffsetCounter;
-                }
+                    importPrimitives(batchBegin, batchEnd);
+                });
+                batchBegin = index + 1;
+                batchVertices = 0;
             }
         }
+        threadPool->Wait(taskGroup);
+    }
+    else
+    {
+        importPrimitives(0, primitives.size());
+    }
+
+    for (const PrimitiveImportDesc& desc : primitives)
+        desc.mesh->objectSpaceBounds |= desc.geometry->objectSpaceBounds;
+
+    auto meshDataEndTime = std::chrono::steady_clock::now();
+
+    const auto meshLayoutTime = std::chrono::duration_cast<std::chrono::microseconds>(meshDataStartTime - meshLayoutStartTime);
+    const auto meshDataTime = std::chrono::duration_cast<std::chrono::microseconds>(meshDataEndTime - meshDataStartTime);
+    stats.MeshLayoutMicroseconds += uint64_t(meshLayoutTime.count());
+    stats.MeshDataMicroseconds += uint64_t(meshDataTime.count());
+
+    // The optimization has to run before the skinned instances copy the geometry ranges of their prototypes
+    if (m_OptimizeMeshes)
+    {
+        const MeshOptimizationResult optimization = OptimizeMeshes(meshes, m_MeshOptimizationParams, threadPool);
+
+        log::info("Optimized the meshes of '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %llu -> %llu vertices",
+            fileName.generic_string().c_str(),
+            optimization.before.GetACMR(), optimization.after.GetACMR(),
+            optimization.before.GetATVR(), optimization.after.GetATVR(),
+            (unsigned long long)optimization.before.vertices, (unsigned long long)optimization.after.vertices);
     }
 
+    auto meshOptimizationEndTime = std::chrono::steady_clock::now();
+    const auto meshOptimizationTime = std::chrono::duration_cast<std::chrono::microseconds>(meshOptimizationEndTime - meshDataEndTime);
+    if (m_OptimizeMeshes)
+        stats.MeshOptimizationMicroseconds += uint64_t(meshOptimizationTime.count());
+
+    // Meshlets are built per geometry on the pool, after the index data is final
+    if (m_BuildMeshlets)
+        BuildMeshlets(meshes, m_MeshletParams, threadPool);
+
+    const auto meshletTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - meshOptimizationEndTime);
+    if (m_BuildMeshlets)
+        stats.MeshletMicroseconds += uint64_t(meshletTime.count());
+
+    log::debug("Imported %d primitives from '%s': mesh layout %.2f ms, mesh data %.2f ms, meshlets %.2f ms",
+        int(primitives.size()), fileName.generic_string().c_str(),
+        float(meshLayoutTime.count()) * 1e-3f, float(meshDataTime.count()) * 1e-3f,
+        m_BuildMeshlets ? float(meshletTime.count()) * 1e-3f : 0.f);
+
     std::unordered_map<const cgltf_camera*, std::shared_ptr<SceneCamera>> cameraMap;
     for (size_t camera_idx = 0; camera_idx < objects->cameras_count; camera_idx++)
     {
@@ -1891,6 +2080,7 @@ bool GltfImporter::Load(
     }
 
     result.rootNode = root;
+    result.sourceFiles = vfsContext.fileNames;
 
     auto animationContainer = root;
     if (objects->animations_count > 1)
@@ -0,0 +1,586 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/InstanceBVH.h>
+#include <algorithm>
+#include <cassert>
+
+using namespace donut::math;
+using namespace donut::engine;
+
+static float SurfaceArea(const box3& box)
+{
+    if (box.isempty())
+        return 0.f;
+
+    float3 d = box.diagonal();
+    return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+enum class FrustumTestResult
+{
+    Outside,
+    Intersects,
+    Inside
+};
+
+// Same test as frustum::intersectsWith, but also tells if the box is completely inside of the frustum.
+static FrustumTestResult TestBoxAgainstFrustum(const frustum& f, const box3& box)
+{
+    FrustumTestResult result = FrustumTestResult::Inside;
+
+    for (const plane& p : f.planes)
+    {
+        // The corner closest to the inside of the plane
+        float3 nearCorner(
+            p.normal.x > 0 ? box.m_mins.x : box.m_maxs.x,
+            p.normal.y > 0 ? box.m_mins.y : box.m_maxs.y,
+            p.normal.z > 0 ? box.m_mins.z : box.m_maxs.z);
+
+        if (p.normal.x * nearCorner.x + p.normal.y * nearCorner.y + p.normal.z * nearCorner.z - p.distance > 0.f)
+            return FrustumTestResult::Outside;
+
+        // The corner farthest from the inside of the plane
+        float3 farCorner(
+            p.normal.x > 0 ? box.m_maxs.x : box.m_mins.x,
+            p.normal.y > 0 ? box.m_maxs.y : box.m_mins.y,
+            p.normal.z > 0 ? box.m_maxs.z : box.m_mins.z);
+
+        if (dot(p.normal, farCorner) - p.distance > 0.f)
+            result = FrustumTestResult::Intersects;
+    }
+
+    return result;
+}
+
+box3 InstanceBVH::GetFatBounds(const box3& bounds) const
+{
+    return bounds.grow(bounds.diagonal() * m_Settings.fatMargin);
+}
+
+int InstanceBVH::AllocateNode()
+{
+    if (!m_FreeNodes.empty())
+    {
+        int node = m_FreeNodes.back();
+        m_FreeNodes.pop_back();
+        m_Nodes[node] = Node();
+        return node;
+    }
+
+    m_Nodes.emplace_back();
+    return int(m_Nodes.size() - 1);
+}
+
+void InstanceBVH::FreeNode(int node)
+{
+    m_Nodes[node] = Node();
+    m_FreeNodes.push_back(node);
+}
+
+// Inserts a leaf node into the tree, looking for the sibling that increases the total surface area the least.
+void InstanceBVH::InsertLeafNode(int leafNode)
+{
+    if (m_Root < 0)
+    {
+        m_Root = leafNode;
+        m_Nodes[leafNode].parent = -1;
+        return;
+    }
+
+    const box3 leafBounds = m_Nodes[leafNode].bounds;
+
+    int index = m_Root;
+    while (m_Nodes[index].leaf < 0)
+    {
+        const Node& node = m_Nodes[index];
+        float area = SurfaceArea(node.bounds);
+        float combinedArea = SurfaceArea(node.bounds | leafBounds);
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.f * (combinedArea - area);
+
+        float childCosts[2];
+        for (int i = 0; i < 2; i++)
+        {
+            const Node& child = m_Nodes[node.children[i]];
+            float newArea = SurfaceArea(child.bounds | leafBounds);
+            childCosts[i] = (child.leaf >= 0 ? newArea : newArea - SurfaceArea(child.bounds)) + inheritanceCost;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+            break;
+
+        index = node.children[childCosts[0] <= childCosts[1] ? 0 : 1];
+    }
+
+    int sibling = index;
+    int oldParent = m_Nodes[sibling].parent;
+    int newParent = AllocateNode();
+
+    Node& parentNode = m_Nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.bounds = leafBounds | m_Nodes[sibling].bounds;
+    parentNode.children[0] = sibling;
+    parentNode.children[1] = leafNode;
+    m_Nodes[sibling].parent = newParent;
+    m_Nodes[leafNode].parent = newParent;
+
+    if (oldParent >= 0)
+    {
+        Node& oldParentNode = m_Nodes[oldParent];
+        oldParentNode.children[oldParentNode.children[0] == sibling ? 0 : 1] = newParent;
+    }
+    else
+    {
+        m_Root = newParent;
+    }
+
+    for (int ancestor = oldParent; ancestor >= 0; ancestor = m_Nodes[ancestor].parent)
+    {
+        Node& node = m_Nodes[ancestor];
+        box3 bounds = m_Nodes[node.children[0]].bounds | m_Nodes[node.children[1]].bounds;
+        if (bounds == node.bounds)
+            break;
+        node.bounds = bounds;
+    }
+}
+
+// Removes a leaf node from the tree without freeing it, and frees its parent.
+void InstanceBVH::RemoveLeafNode(int leafNode)
+{
+    if (leafNode == m_Root)
+    {
+        m_Root = -1;
+        return;
+    }
+
+    int parent = m_Nodes[leafNode].parent;
+    int grandParent = m_Nodes[parent].parent;
+    int sibling = m_Nodes[parent].children[m_Nodes[parent].children[0] == leafNode ? 1 : 0];
+
+    if (grandParent >= 0)
+    {
+        Node& grandParentNode = m_Nodes[grandParent];
+        grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+        m_Nodes[sibling].parent = grandParent;
+
+        for (int ancestor = grandParent; ancestor >= 0; ancestor = m_Nodes[ancestor].parent)
+        {
+            Node& node = m_Nodes[ancestor];
+            node.bounds = m_Nodes[node.children[0]].bounds | m_Nodes[node.children[1]].bounds;
+        }
+    }
+    else
+    {
+        m_Root = sibling;
+        m_Nodes[sibling].parent = -1;
+    }
+
+    FreeNode(parent);
+    m_Nodes[leafNode].parent = -1;
+}
+
+// Builds a subtree over the leaves by splitting them at the median of their centers along the longest axis.
+int InstanceBVH::BuildSubtree(uint32_t* leaves, size_t count, int parent)
+{
+    if (count == 1)
+    {
+        int node = m_LeafNodes[leaves[0]];
+        m_Nodes[node].parent = parent;
+        return node;
+    }
+
+    box3 centerBounds = box3::empty();
+    for (size_t i = 0; i < count; i++)
+        centerBounds |= m_Nodes[m_LeafNodes[leaves[i]]].bounds.center();
+
+    float3 extent = centerBounds.diagonal();
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    size_t middle = count / 2;
+    std::nth_element(leaves, leaves + middle, leaves + count, [this, axis](uint32_t a, uint32_t b)
+    {
+        return m_Nodes[m_LeafNodes[a]].bounds.center()[axis] < m_Nodes[m_LeafNodes[b]].bounds.center()[axis];
+    });
+
+    int node = AllocateNode();
+    m_Nodes[node].parent = parent;
+
+    int left = BuildSubtree(leaves, middle, node);
+    int right = BuildSubtree(leaves + middle, count - middle, node);
+
+    Node& newNode = m_Nodes[node];
+    newNode.children[0] = left;
+    newNode.children[1] = right;
+    newNode.bounds = m_Nodes[left].bounds | m_Nodes[right].bounds;
+
+    return node;
+}
+
+// Recomputes the bounds of all internal nodes from their children.
+void InstanceBVH::Refit()
+{
+    if (m_Root < 0)
+        return;
+
+    // Collect the internal nodes so that parents come before their children, then process them in reverse.
+    std::vector<int> internalNodes;
+    internalNodes.push_back(m_Root);
+    for (size_t i = 0; i < internalNodes.size(); i++)
+    {
+        const Node& node = m_Nodes[internalNodes[i]];
+        if (node.leaf >= 0)
+            continue;
+
+        for (int child : node.children)
+        {
+            if (m_Nodes[child].leaf < 0)
+                internalNodes.push_back(child);
+        }
+    }
+
+    for (auto it = internalNodes.rbegin(); it != internalNodes.rend(); ++it)
+    {
+        Node& node = m_Nodes[*it];
+        if (node.leaf < 0)
+            node.bounds = m_Nodes[node.children[0]].bounds | m_Nodes[node.children[1]].bounds;
+    }
+}
+
+void InstanceBVH::Rebuild()
+{
+    // Keep the leaf nodes, discard the internal ones
+    std::vector<uint32_t> leaves;
+    leaves.reserve(m_LeafNodes.size());
+
+    std::vector<Node> leafNodes;
+    leafNodes.reserve(m_LeafNodes.size());
+
+    for (uint32_t leafIndex = 0; leafIndex < uint32_t(m_LeafNodes.size()); leafIndex++)
+    {
+        if (m_LeafNodes[leafIndex] < 0)
+            continue;
+
+        leafNodes.push_back(m_Nodes[m_LeafNodes[leafIndex]]);
+        m_LeafNodes[leafIndex] = int(leafNodes.size() - 1);
+        leaves.push_back(leafIndex);
+    }
+
+    m_Nodes = std::move(leafNodes);
+    m_FreeNodes.clear();
+    m_Root = leaves.empty() ? -1 : BuildSubtree(leaves.data(), leaves.size(), -1);
+
+    m_BuildCost = ComputeCost();
+    m_ReinsertionsSinceCheck = 0;
+    ++m_Rebuilds;
+}
+
+void InstanceBVH::Build(const std::vector<box3>& leafBounds)
+{
+    m_Nodes.clear();
+    m_FreeNodes.clear();
+    m_Root = -1;
+    m_LeafBounds = leafBounds;
+    m_LeafNodes.assign(leafBounds.size(), -1);
+    m_PendingLeaves.clear();
+    m_LeafPending.assign(leafBounds.size(), false);
+
+    for (uint32_t leafIndex = 0; leafIndex < uint32_t(leafBounds.size()); leafIndex++)
+    {
+        if (leafBounds[leafIndex].isempty())
+            continue;
+
+        int node = AllocateNode();
+        m_Nodes[node].bounds = GetFatBounds(leafBounds[leafIndex]);
+        m_Nodes[node].leaf = int(leafIndex);
+        m_LeafNodes[leafIndex] = node;
+    }
+
+    Rebuild();
+}
+
+void InstanceBVH::Clear()
+{
+    Build({});
+}
+
+void InstanceBVH::UpdateLeaf(uint32_t leafIndex, const box3& bounds)
+{
+    assert(leafIndex < m_LeafBounds.size());
+
+    m_LeafBounds[leafIndex] = bounds;
+
+    if (!m_LeafPending[leafIndex])
+    {
+        m_LeafPending[leafIndex] = true;
+        m_PendingLeaves.push_back(leafIndex);
+    }
+}
+
+void InstanceBVH::Commit()
+{
+    if (m_PendingLeaves.empty())
+        return;
+
+    // Find the leaves that moved out of their fat boxes, remove the ones that became empty.
+    std::vector<uint32_t> movedLeaves;
+    for (uint32_t leafIndex : m_PendingLeaves)
+    {
+        m_LeafPending[leafIndex] = false;
+
+        const box3& bounds = m_LeafBounds[leafIndex];
+        int node = m_LeafNodes[leafIndex];
+
+        if (bounds.isempty())
+        {
+            if (node >= 0)
+            {
+                RemoveLeafNode(node);
+                FreeNode(node);
+                m_LeafNodes[leafIndex] = -1;
+            }
+            continue;
+        }
+
+        if (node >= 0 && m_Nodes[node].bounds.contains(bounds))
+            continue;
+
+        movedLeaves.push_back(leafIndex);
+    }
+    m_PendingLeaves.clear();
+
+    if (movedLeaves.empty())
+        return;
+
+    const uint32_t numLeaves = GetNumLeaves();
+
+    if (float(movedLeaves.size()) <= m_Settings.refitFraction * float(numLeaves))
+    {
+        for (uint32_t leafIndex : movedLeaves)
+        {
+            int node = m_LeafNodes[leafIndex];
+            if (node >= 0)
+            {
+                RemoveLeafNode(node);
+            }
+            else
+            {
+                node = AllocateNode();
+                m_Nodes[node].leaf = int(leafIndex);
+                m_LeafNodes[leafIndex] = node;
+            }
+
+            m_Nodes[node].bounds = GetFatBounds(m_LeafBounds[leafIndex]);
+            InsertLeafNode(node);
+        }
+
+        m_Reinsertions += uint32_t(movedLeaves.size());
+        m_ReinsertionsSinceCheck += uint32_t(movedLeaves.size());
+
+        // Reinsertion keeps the tree in a reasonable shape, but check its cost once in a while
+        if (m_ReinsertionsSinceCheck < numLeaves / 4)
+            return;
+    }
+    else
+    {
+        bool needsRebuild = false;
+        for (uint32_t leafIndex : movedLeaves)
+        {
+            int node = m_LeafNodes[leafIndex];
+            if (node < 0)
+            {
+                // Leaves that were empty before are not in the tree, it has to be rebuilt to include them
+                node = AllocateNode();
+                m_Nodes[node].leaf = int(leafIndex);
+                m_LeafNodes[leafIndex] = node;
+                needsRebuild = true;
+            }
+
+            m_Nodes[node].bounds = GetFatBounds(m_LeafBounds[leafIndex]);
+        }
+
+        if (needsRebuild)
+        {
+            Rebuild();
+            return;
+        }
+
+        Refit();
+        ++m_Refits;
+    }
+
+    m_ReinsertionsSinceCheck = 0;
+    if (ComputeCost() > m_BuildCost * m_Settings.rebuildCostRatio)
+        Rebuild();
+}
+
+void InstanceBVH::Query(const frustum& frustum, std::vector<uint32_t>& visibleLeaves, QueryStats* stats) const
+{
+    QueryStats localStats;
+
+    if (m_Root >= 0)
+    {
+        std::vector<int> stack;
+        stack.push_back(m_Root);
+
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            ++localStats.nodesVisited;
+
+            const Node& node = m_Nodes[index];
+            FrustumTestResult result = TestBoxAgainstFrustum(frustum, node.bounds);
+            if (result == FrustumTestResult::Outside)
+                continue;
+
+            if (node.leaf >= 0)
+            {
+                // The fat box may intersect the frustum when the exact box doesn't
+                if (result == FrustumTestResult::Intersects)
+                {
+                    ++localStats.leavesTested;
+                    if (!frustum.intersectsWith(m_LeafBounds[node.leaf]))
+                        continue;
+                }
+
+                visibleLeaves.push_back(uint32_t(node.leaf));
+                ++localStats.leavesVisible;
+                continue;
+            }
+
+            if (result == FrustumTestResult::Inside)
+            {
+                // The whole subtree is visible, collect its leaves without testing them
+                size_t subtreeBase = stack.size();
+                stack.push_back(node.children[0]);
+                stack.push_back(node.children[1]);
+
+                while (stack.size() > subtreeBase)
+                {
+                    const Node& subtreeNode = m_Nodes[stack.back()];
+                    stack.pop_back();
+                    ++localStats.nodesVisited;
+
+                    if (subtreeNode.leaf >= 0)
+                    {
+                        visibleLeaves.push_back(uint32_t(subtreeNode.leaf));
+                        ++localStats.leavesVisible;
+                    }
+                    else
+                    {
+                        stack.push_back(subtreeNode.children[0]);
+                        stack.push_back(subtreeNode.children[1]);
+                    }
+                }
+                continue;
+            }
+
+            stack.push_back(node.children[0]);
+            stack.push_back(node.children[1]);
+        }
+    }
+
+    if (stats)
+        *stats = localStats;
+}
+
+float InstanceBVH::ComputeCost() const
+{
+    if (m_Root < 0)
+        return 0.f;
+
+    float rootArea = SurfaceArea(m_Nodes[m_Root].bounds);
+    if (rootArea <= 0.f)
+        return 0.f;
+
+    float totalArea = 0.f;
+    std::vector<int> stack;
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.leaf >= 0)
+            continue;
+
+        totalArea += SurfaceArea(node.bounds);
+        stack.push_back(node.children[0]);
+        stack.push_back(node.children[1]);
+    }
+
+    return totalArea / rootArea;
+}
+
+InstanceBVH::Stats InstanceBVH::GetStats() const
+{
+    Stats stats;
+    stats.leaves = GetNumLeaves();
+    stats.nodes = uint32_t(m_Nodes.size() - m_FreeNodes.size());
+    stats.rebuilds = m_Rebuilds;
+    stats.refits = m_Refits;
+    stats.reinsertions = m_Reinsertions;
+    stats.cost = ComputeCost();
+    return stats;
+}
+
+bool InstanceBVH::Validate() const
+{
+    if (m_Root < 0)
+        return std::all_of(m_LeafNodes.begin(), m_LeafNodes.end(), [](int node) { return node < 0; });
+
+    if (m_Nodes[m_Root].parent != -1)
+        return false;
+
+    uint32_t leavesInTree = 0;
+    std::vector<int> stack;
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = m_Nodes[index];
+
+        if (node.leaf >= 0)
+        {
+            if (m_LeafNodes[node.leaf] != index || !node.bounds.contains(m_LeafBounds[node.leaf]))
+                return false;
+            ++leavesInTree;
+            continue;
+        }
+
+        for (int child : node.children)
+        {
+            if (child < 0 || m_Nodes[child].parent != index || !node.bounds.contains(m_Nodes[child].bounds))
+                return false;
+            stack.push_back(child);
+        }
+    }
+
+    uint32_t expectedLeaves = uint32_t(std::count_if(m_LeafNodes.begin(), m_LeafNodes.end(), [](int node) { return node >= 0; }));
+    return leavesInTree == expectedLeaves;
+}
@@ -38,7 +38,11 @@ this software is released into the Public Domain.
 #include <donut/core/json.h>
 #include <donut/core/log.h>
 #include <json/json-forwards.h>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 using namespace donut::math;
 using namespace donut::engine;
@@ -87,24 +91,26 @@ float4 donut::engine::animation::Interpolate(const InterpolationMode mode,
     }
 }
 
-std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValues) const
+// Returns the index of the keyframe (b) such that (b.time <= time < c.time), see Sampler::FindSegment.
+// The keyframe times are provided by 'getTime', so that the search works for the plain and compressed keyframes.
+template<typename GetTime>
+static size_t FindSegmentInTimes(size_t count, float time, size_t hint, GetTime getTime)
 {
-    const size_t count = m_Keyframes.size();
-
-    if (count == 0)
-        return std::optional<float4>();
+    assert(count >= 2);
 
-    if (time <= m_Keyframes[0].time)
-        return std::optional(m_Keyframes[0].value);
-
-    if (count == 1 || time >= m_Keyframes[count - 1].time)
+    // Playback usually stays in the same segment or moves to one of the next few, check those first.
+    // The time is below the last keyframe time, so this never moves past the last segment.
+    constexpr int c_LinearSearchSteps = 4;
+    size_t segment = std::min(hint, count - 2);
+    if (getTime(segment) <= time)
     {
-        if (extrapolateLastValues)
-            return std::optional(m_Keyframes[count - 1].value);
-        else
-            return std::optional<float4>();
+        for (int step = 0; step < c_LinearSearchSteps; ++step, ++segment)
+        {
+            if (time < getTime(segment + 1))
+                return segment;
+        }
     }
-    
+
     // Use binary search to locate the pair of keyframes (b, c) so that (b.time <= time < c.time).
     // Assume that the keyframe vector is sorted by time.
     // Right limit starts at (count - 2) because we're always looking at consecutive pairs of items, not single items.
@@ -114,8 +120,8 @@ std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValu
     {
         size_t const middle = (left + right) / 2;
 
-        const float tb = m_Keyframes[middle].time;
-        const float tc = m_Keyframes[middle + 1].time;
+        const float tb = getTime(middle);
+        const float tc = getTime(middle + 1);
 
         if (time < tb)
             right = middle - 1;
@@ -129,9 +135,46 @@ std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValu
         }
     }
 
+    return left;
+}
+
+size_t Sampler::FindSegment(float time, size_t hint) const
+{
+    return FindSegmentInTimes(m_Keyframes.size(), time, hint,
+        [this](size_t index) { return m_Keyframes[index].time; });
+}
+
+std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValues) const
+{
+    SamplerCursor cursor;
+    return Evaluate(time, extrapolateLastValues, cursor);
+}
+
+std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValues, SamplerCursor& cursor) const
+{
+    if (IsCompressed())
+        return EvaluateCompressed(m_Compressed, time, extrapolateLastValues, cursor);
+
+    const size_t count = m_Keyframes.size();
+
+    if (count == 0)
+        return std::optional<float4>();
+
+    if (time <= m_Keyframes[0].time)
+        return std::optional(m_Keyframes[0].value);
+
+    if (count == 1 || time >= m_Keyframes[count - 1].time)
+    {
+        if (extrapolateLastValues)
+            return std::optional(m_Keyframes[count - 1].value);
+        else
+            return std::optional<float4>();
+    }
+
     // Load 4 keyframes around the required time.
     // The outside keyframes (a) and (d) are needed for higher-order interpolation.
-    size_t const offset = left;
+    size_t const offset = FindSegment(time, cursor.segment);
+    cursor.segment = offset;
     const Keyframe& b = m_Keyframes[offset];
     const Keyframe& c = m_Keyframes[offset + 1];
     const Keyframe& a = (offset > 0) ? m_Keyframes[offset - 1] : b;
@@ -152,13 +195,27 @@ std::optional<dm::float4> Sampler::Evaluate(float time, bool extrapolateLastValu
     return std::optional(y);
 }
 
+std::vector<Keyframe>& Sampler::GetKeyframes()
+{
+    if (IsCompressed())
+        Decompress();
+
+    return m_Keyframes;
+}
+
 void Sampler::AddKeyframe(const Keyframe keyframe)
 {
+    if (IsCompressed())
+        Decompress();
+
     m_Keyframes.push_back(keyframe);
 }
 
 float Sampler::GetStartTime() const
 {
+    if (IsCompressed())
+        return m_Compressed.GetTime(0);
+
     if (!m_Keyframes.empty())
         return m_Keyframes[0].time;
 
@@ -167,6 +224,9 @@ float Sampler::GetStartTime() const
 
 float Sampler::GetEndTime() const
 {
+    if (IsCompressed())
+        return m_Compressed.GetTime(m_Compressed.count - 1);
+
     if (!m_Keyframes.empty())
         return m_Keyframes[m_Keyframes.size() - 1].time;
 
@@ -220,6 +280,797 @@ void Sampler::Load(Json::Value& node)
     }
 }
 
+CompressionReport& CompressionReport::operator+=(const CompressionReport& other)
+{
+    samplers += other.samplers;
+    uniformSamplers += other.uniformSamplers;
+    quantizedSamplers += other.quantizedSamplers;
+    originalKeyframes += other.originalKeyframes;
+    compressedKeyframes += other.compressedKeyframes;
+    originalBytes += other.originalBytes;
+    compressedBytes += other.compressedBytes;
+    maxError = std::max(maxError, other.maxError);
+    errorSum += other.errorSum;
+    errorSamples += other.errorSamples;
+    return *this;
+}
+
+// The smallest-three encoding drops the largest component of a unit quaternion and reconstructs it from the
+// unit length. The other three components are in [-1/sqrt(2), 1/sqrt(2)] and are stored with 15 bits each,
+// the low bits of the three words store the index of the largest component and the sign of the quaternion.
+static constexpr float c_SmallestThreeRange = 1.41421356f;
+static constexpr float c_SmallestThreeSteps = 32767.f;
+// Largest reconstruction error of a component, with margin: half a step of the stored components, amplified
+// by at most 3 when the largest component is reconstructed
+static constexpr float c_SmallestThreeError = 1e-4f;
+// Slerp samplers use the smallest-three encoding when all their values have this distance to unit length
+static constexpr float c_UnitQuaternionTolerance = 1e-4f;
+
+static constexpr float c_Unorm16Steps = 65535.f;
+
+// Largest weight of a tangent in the Hermite spline basis, (t^3 - 2t^2 + t) and (t^3 - t^2) each reach 4/27
+static constexpr float c_HermiteTangentWeight = 8.f / 27.f;
+
+static void EncodeSmallestThree(float4 q, uint16_t* dst)
+{
+    q = normalize(q);
+
+    int largest = 0;
+    for (int j = 1; j < 4; ++j)
+    {
+        if (std::abs(q[j]) > std::abs(q[largest]))
+            largest = j;
+    }
+
+    const bool negative = q[largest] < 0.f;
+    if (negative)
+        q = -q;
+
+    const uint32_t flags[3] = { uint32_t(largest) & 1, uint32_t(largest) >> 1, negative ? 1u : 0u };
+    for (int j = 0, k = 0; j < 4; ++j)
+    {
+        if (j == largest)
+            continue;
+
+        const float normalized = saturate(q[j] / c_SmallestThreeRange + 0.5f);
+        const uint32_t value = uint32_t(std::lround(normalized * c_SmallestThreeSteps));
+        dst[k] = uint16_t((value << 1) | flags[k]);
+        ++k;
+    }
+}
+
+static float4 DecodeSmallestThree(const uint16_t* src)
+{
+    const int largest = int(src[0] & 1) | (int(src[1] & 1) << 1);
+
+    float4 q = 0.f;
+    float sumSquares = 0.f;
+    for (int j = 0, k = 0; j < 4; ++j)
+    {
+        if (j == largest)
+            continue;
+
+        q[j] = (float(src[k] >> 1) / c_SmallestThreeSteps - 0.5f) * c_SmallestThreeRange;
+        sumSquares += q[j] * q[j];
+        ++k;
+    }
+    q[largest] = std::sqrt(std::max(0.f, 1.f - sumSquares));
+
+    return (src[2] & 1) ? -q : q;
+}
+
+static uint16_t QuantizeUnorm16(float value, float offset, float scale)
+{
+    if (scale <= 0.f)
+        return 0;
+
+    return uint16_t(std::clamp(std::lround((value - offset) / scale), 0l, long(c_Unorm16Steps)));
+}
+
+size_t CompressedKeyframes::GetStride() const
+{
+    if (encoding == Encoding::SmallestThree)
+        return 3;
+
+    return components * (tangents ? 3 : 1);
+}
+
+size_t CompressedKeyframes::GetSizeInBytes() const
+{
+    return times.size() * sizeof(float) + quantized.size() * sizeof(uint16_t) + floats.size() * sizeof(float);
+}
+
+void CompressedKeyframes::Decode(size_t index, Keyframe& keyframe) const
+{
+    keyframe.time = GetTime(index);
+    keyframe.value = 0.f;
+    keyframe.inTangent = 0.f;
+    keyframe.outTangent = 0.f;
+
+    const size_t offset = index * GetStride();
+    switch (encoding)
+    {
+    case Encoding::Float:
+        for (uint32_t j = 0; j < components; ++j)
+        {
+            keyframe.value[j] = floats[offset + j];
+            if (tangents)
+            {
+                keyframe.inTangent[j] = floats[offset + components + j];
+                keyframe.outTangent[j] = floats[offset + 2 * components + j];
+            }
+        }
+        break;
+
+    case Encoding::Quantized:
+        for (uint32_t j = 0; j < components; ++j)
+        {
+            keyframe.value[j] = valueOffset[j] + float(quantized[offset + j]) * valueScale[j];
+            if (tangents)
+            {
+                keyframe.inTangent[j] = tangentOffset[j] + float(quantized[offset + components + j]) * tangentScale[j];
+                keyframe.outTangent[j] = tangentOffset[j] + float(quantized[offset + 2 * components + j]) * tangentScale[j];
+            }
+        }
+        break;
+
+    case Encoding::SmallestThree:
+        keyframe.value = DecodeSmallestThree(quantized.data() + offset);
+        break;
+    }
+}
+
+std::optional<dm::float4> Sampler::EvaluateCompressed(const CompressedKeyframes& track, float time,
+    bool extrapolateLastValues, SamplerCursor& cursor) const
+{
+    const size_t count = track.count;
+    Keyframe b, c;
+
+    if (count == 0)
+        return std::optional<float4>();
+
+    if (time <= track.GetTime(0))
+    {
+        track.Decode(0, b);
+        return std::optional(b.value);
+    }
+
+    if (count == 1 || time >= track.GetTime(count - 1))
+    {
+        if (extrapolateLastValues)
+        {
+            track.Decode(count - 1, c);
+            return std::optional(c.value);
+        }
+        else
+            return std::optional<float4>();
+    }
+
+    // Uniform keyframes are located directly from the time, the listed times are searched like in Evaluate.
+    size_t offset;
+    if (track.IsUniform())
+        offset = std::min(size_t((time - track.startTime) / track.timeStep), count - 2);
+    else
+        offset = FindSegmentInTimes(count, time, cursor.segment, [&track](size_t index) { return track.times[index]; });
+    cursor.segment = offset;
+
+    // Decode only the keyframes that the interpolation mode uses
+    track.Decode(offset, b);
+    track.Decode(offset + 1, c);
+    Keyframe a = b;
+    Keyframe d = c;
+    if (m_Mode == InterpolationMode::CatmullRomSpline)
+    {
+        if (offset > 0)
+            track.Decode(offset - 1, a);
+        if (offset < count - 2)
+            track.Decode(offset + 2, d);
+    }
+
+    // The uniform time of the segment is computed differently from its index, clamp to stay inside the segment
+    const float dt = c.time - b.time;
+    const float u = saturate((time - b.time) / dt);
+
+    float4 y = Interpolate(m_Mode, a, b, c, d, u, dt);
+
+    return std::optional(y);
+}
+
+// Difference between two sampler values used as the compression error.
+// The quaternions q and -q represent the same rotation, so slerp values are compared up to their sign.
+static float ValueError(const float4& a, const float4& b, bool quaternion)
+{
+    float error = maxComponent(abs(a - b));
+    if (quaternion)
+        error = std::min(error, maxComponent(abs(a + b)));
+    return error;
+}
+
+// Selects the keyframes to keep so that the removed ones are interpolated from their kept neighbors within
+// the tolerance. Each segment is extended while all the keyframes it covers stay within the tolerance.
+// Only valid for the step, linear and slerp modes, where a segment only depends on its two keyframes.
+static std::vector<uint32_t> ReduceKeyframes(const std::vector<Keyframe>& keyframes, InterpolationMode mode, float tolerance)
+{
+    // Limits the cost of checking long constant runs, which are the common case in motion capture data
+    constexpr size_t c_MaxSegmentLength = 256;
+
+    const size_t count = keyframes.size();
+    const bool quaternion = mode == InterpolationMode::Slerp;
+
+    std::vector<uint32_t> kept = { 0 };
+    size_t start = 0;
+    for (size_t end = 2; end < count; ++end)
+    {
+        const Keyframe& b = keyframes[start];
+        const Keyframe& c = keyframes[end];
+        const float dt = c.time - b.time;
+
+        bool fits = end - start <= c_MaxSegmentLength;
+        for (size_t i = start + 1; fits && i < end; ++i)
+        {
+            const float4 value = Interpolate(mode, b, b, c, c, (keyframes[i].time - b.time) / dt, dt);
+            fits = ValueError(value, keyframes[i].value, quaternion) <= tolerance;
+        }
+
+        if (!fits)
+        {
+            start = end - 1;
+            kept.push_back(uint32_t(start));
+        }
+    }
+
+    if (count > 1)
+        kept.push_back(uint32_t(count - 1));
+
+    return kept;
+}
+
+// Returns true if the times of the selected keyframes are (first + index * step) within the relative tolerance.
+static bool HasUniformTimes(const std::vector<Keyframe>& keyframes, const std::vector<uint32_t>& indices,
+    float tolerance, float& step)
+{
+    const size_t count = indices.size();
+    step = 0.f;
+    if (count < 2)
+        return true;
+
+    const float first = keyframes[indices[0]].time;
+    step = (keyframes[indices[count - 1]].time - first) / float(count - 1);
+    if (!(step > 0.f))
+        return false;
+
+    for (size_t i = 1; i < count - 1; ++i)
+    {
+        if (std::abs(keyframes[indices[i]].time - (first + float(i) * step)) > tolerance * step)
+            return false;
+    }
+
+    return true;
+}
+
+namespace
+{
+    struct CompressionAttempt
+    {
+        bool reduceKeyframes;
+        bool quantize;
+        bool uniformTimes;
+    };
+}
+
+static CompressedKeyframes BuildCompressedKeyframes(const std::vector<Keyframe>& keyframes, InterpolationMode mode,
+    const CompressionSettings& settings, const CompressionAttempt& attempt)
+{
+    CompressedKeyframes track;
+    track.tangents = mode == InterpolationMode::HermiteSpline;
+
+    // Store only the vector components up to the last one that is used
+    for (const Keyframe& keyframe : keyframes)
+    {
+        for (uint32_t j = track.components; j < 4; ++j)
+        {
+            if (keyframe.value[j] != 0.f || (track.tangents && (keyframe.inTangent[j] != 0.f || keyframe.outTangent[j] != 0.f)))
+                track.components = j + 1;
+        }
+    }
+    track.components = std::max(track.components, 1u);
+
+    float quantizationError = 0.f;
+    if (attempt.quantize)
+    {
+        bool unitQuaternions = mode == InterpolationMode::Slerp;
+        for (const Keyframe& keyframe : keyframes)
+            unitQuaternions = unitQuaternions && std::abs(length(keyframe.value) - 1.f) <= c_UnitQuaternionTolerance;
+
+        if (unitQuaternions)
+        {
+            track.encoding = CompressedKeyframes::Encoding::SmallestThree;
+            quantizationError = c_SmallestThreeError + c_UnitQuaternionTolerance;
+        }
+        else
+        {
+            float4 valueMin = keyframes[0].value;
+            float4 valueMax = keyframes[0].value;
+            float4 tangentMin = keyframes[0].inTangent;
+            float4 tangentMax = keyframes[0].inTangent;
+            float maxDt = 0.f;
+            for (size_t i = 0; i < keyframes.size(); ++i)
+            {
+                const Keyframe& keyframe = keyframes[i];
+                valueMin = min(valueMin, keyframe.value);
+                valueMax = max(valueMax, keyframe.value);
+                tangentMin = min(tangentMin, min(keyframe.inTangent, keyframe.outTangent));
+                tangentMax = max(tangentMax, max(keyframe.inTangent, keyframe.outTangent));
+                if (i > 0)
+                    maxDt = std::max(maxDt, keyframe.time - keyframes[i - 1].time);
+            }
+
+            track.encoding = CompressedKeyframes::Encoding::Quantized;
+            track.valueOffset = valueMin;
+            track.valueScale = (valueMax - valueMin) / c_Unorm16Steps;
+            quantizationError = maxComponent(track.valueScale) * 0.5f;
+
+            // The tangents are scaled by the segment duration in the Hermite spline
+            if (track.tangents)
+            {
+                track.tangentOffset = tangentMin;
+                track.tangentScale = (tangentMax - tangentMin) / c_Unorm16Steps;
+                quantizationError += maxComponent(track.tangentScale) * 0.5f * c_HermiteTangentWeight * maxDt;
+            }
+        }
+
+        // Leave at least half of the error budget to the keyframe reduction
+        if (quantizationError > settings.maxError * 0.5f)
+        {
+            track.encoding = CompressedKeyframes::Encoding::Float;
+            track.valueOffset = track.valueScale = track.tangentOffset = track.tangentScale = 0.f;
+            quantizationError = 0.f;
+        }
+    }
+
+    std::vector<uint32_t> allIndices(keyframes.size());
+    std::iota(allIndices.begin(), allIndices.end(), 0u);
+
+    std::vector<uint32_t> indices = attempt.reduceKeyframes
+        ? ReduceKeyframes(keyframes, mode, settings.maxError - quantizationError)
+        : allIndices;
+
+    // Use implicit times if the kept keyframes are uniform, or keep all keyframes if they are uniform
+    // and that takes less memory than the kept keyframes with their times.
+    bool uniform = false;
+    float timeStep = 0.f;
+    if (attempt.uniformTimes)
+    {
+        uniform = HasUniformTimes(keyframes, indices, settings.uniformTimeTolerance, timeStep);
+        if (!uniform && HasUniformTimes(keyframes, allIndices, settings.uniformTimeTolerance, timeStep))
+        {
+            const size_t keyframeSize = track.GetStride() *
+                (track.encoding == CompressedKeyframes::Encoding::Float ? sizeof(float) : sizeof(uint16_t));
+            if (allIndices.size() * keyframeSize < indices.size() * (keyframeSize + sizeof(float)))
+            {
+                indices = std::move(allIndices);
+                uniform = true;
+            }
+        }
+    }
+
+    track.count = uint32_t(indices.size());
+    track.startTime = keyframes[indices[0]].time;
+    if (uniform)
+        track.timeStep = timeStep;
+    else
+    {
+        track.times.reserve(indices.size());
+        for (uint32_t index : indices)
+            track.times.push_back(keyframes[index].time);
+    }
+
+    const size_t stride = track.GetStride();
+    if (track.encoding == CompressedKeyframes::Encoding::Float)
+        track.floats.resize(indices.size() * stride);
+    else
+        track.quantized.resize(indices.size() * stride);
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const Keyframe& keyframe = keyframes[indices[i]];
+        const size_t offset = i * stride;
+        const uint32_t components = track.components;
+
+        switch (track.encoding)
+        {
+        case CompressedKeyframes::Encoding::Float:
+            for (uint32_t j = 0; j < components; ++j)
+            {
+                track.floats[offset + j] = keyframe.value[j];
+                if (track.tangents)
+                {
+                    track.floats[offset + components + j] = keyframe.inTangent[j];
+                    track.floats[offset + 2 * components + j] = keyframe.outTangent[j];
+                }
+            }
+            break;
+
+        case CompressedKeyframes::Encoding::Quantized:
+            for (uint32_t j = 0; j < components; ++j)
+            {
+                track.quantized[offset + j] = QuantizeUnorm16(keyframe.value[j], track.valueOffset[j], track.valueScale[j]);
+                if (track.tangents)
+                {
+                    track.quantized[offset + components + j] = QuantizeUnorm16(keyframe.inTangent[j], track.tangentOffset[j], track.tangentScale[j]);
+                    track.quantized[offset + 2 * components + j] = QuantizeUnorm16(keyframe.outTangent[j], track.tangentOffset[j], track.tangentScale[j]);
+                }
+            }
+            break;
+
+        case CompressedKeyframes::Encoding::SmallestThree:
+            EncodeSmallestThree(keyframe.value, track.quantized.data() + offset);
+            break;
+        }
+    }
+
+    return track;
+}
+
+CompressionReport Sampler::Compress(const CompressionSettings& settings)
+{
+    CompressionReport report;
+    if (m_Keyframes.empty() || IsCompressed())
+        return report;
+
+    const bool quaternion = m_Mode == InterpolationMode::Slerp;
+    const bool splines = m_Mode == InterpolationMode::CatmullRomSpline || m_Mode == InterpolationMode::HermiteSpline;
+    // Step samplers change their values exactly at the keyframe times, which the implicit times would move
+    const bool uniformTimes = m_Mode != InterpolationMode::Step;
+
+    // From the most to the least compressed representation, the last one is lossless
+    const CompressionAttempt attempts[] = {
+        { settings.reduceKeyframes && !splines, settings.quantize, uniformTimes },
+        { false, settings.quantize, uniformTimes },
+        { false, false, uniformTimes },
+        { false, false, false }
+    };
+
+    CompressedKeyframes track;
+    for (const CompressionAttempt& attempt : attempts)
+    {
+        track = BuildCompressedKeyframes(m_Keyframes, m_Mode, settings, attempt);
+
+        report.maxError = 0.f;
+        report.errorSum = 0.0;
+        report.errorSamples = 0;
+
+        SamplerCursor originalCursor;
+        SamplerCursor compressedCursor;
+        for (size_t i = 0; i < m_Keyframes.size(); ++i)
+        {
+            for (int halfway = 0; halfway < 2; ++halfway)
+            {
+                float time = m_Keyframes[i].time;
+                if (halfway)
+                {
+                    if (i + 1 == m_Keyframes.size())
+                        break;
+                    time = 0.5f * (time + m_Keyframes[i + 1].time);
+                }
+
+                std::optional<float4> expected = Evaluate(time, true, originalCursor);
+                std::optional<float4> result = EvaluateCompressed(track, time, true, compressedCursor);
+                float error = (expected.has_value() && result.has_value())
+                    ? ValueError(*expected, *result, quaternion)
+                    : std::numeric_limits<float>::infinity();
+
+                report.maxError = std::max(report.maxError, error);
+                report.errorSum += double(error);
+                ++report.errorSamples;
+            }
+        }
+
+        if (report.maxError <= settings.maxError)
+            break;
+    }
+
+    report.samplers = 1;
+    report.uniformSamplers = track.IsUniform() ? 1 : 0;
+    report.quantizedSamplers = track.encoding != CompressedKeyframes::Encoding::Float ? 1 : 0;
+    report.originalKeyframes = m_Keyframes.size();
+    report.compressedKeyframes = track.count;
+    report.originalBytes = m_Keyframes.size() * sizeof(Keyframe);
+    report.compressedBytes = track.GetSizeInBytes();
+
+    m_Compressed = std::move(track);
+    std::vector<Keyframe>().swap(m_Keyframes);
+
+    return report;
+}
+
+void Sampler::Decompress()
+{
+    if (!IsCompressed())
+        return;
+
+    m_Keyframes.resize(m_Compressed.count);
+    for (size_t i = 0; i < m_Keyframes.size(); ++i)
+        m_Compressed.Decode(i, m_Keyframes[i]);
+
+    m_Compressed = CompressedKeyframes();
+}
+
+void SamplerBatch::Lanes::Resize(size_t capacity)
+{
+    samplers.resize(capacity);
+    t.resize(capacity);
+    dt.resize(capacity);
+    for (int j = 0; j < 4; ++j)
+    {
+        a[j].resize(capacity);
+        b[j].resize(capacity);
+        c[j].resize(capacity);
+        d[j].resize(capacity);
+        result[j].resize(capacity);
+    }
+    wa.resize(capacity);
+    wb.resize(capacity);
+}
+
+void SamplerBatch::Lanes::Add(uint32_t sampler, const float4& kb, const float4& kc, float laneT, float laneDt)
+{
+    samplers[count] = sampler;
+    t[count] = laneT;
+    dt[count] = laneDt;
+    for (int j = 0; j < 4; ++j)
+    {
+        b[j][count] = kb[j];
+        c[j][count] = kc[j];
+    }
+    ++count;
+}
+
+void SamplerBatch::Lanes::Add(uint32_t sampler, const float4& ka, const float4& kb, const float4& kc, const float4& kd,
+    float laneT, float laneDt)
+{
+    for (int j = 0; j < 4; ++j)
+    {
+        a[j][count] = ka[j];
+        d[j][count] = kd[j];
+    }
+    Add(sampler, kb, kc, laneT, laneDt);
+}
+
+// The interpolation functions below compute the same expressions as Interpolate, in the same order,
+// one vector component at a time over all lanes.
+
+static void InterpolateLinear(SamplerBatch::Lanes& lanes)
+{
+    const size_t count = lanes.Size();
+    const float* t = lanes.t.data();
+    for (int j = 0; j < 4; ++j)
+    {
+        const float* b = lanes.b[j].data();
+        const float* c = lanes.c[j].data();
+        float* result = lanes.result[j].data();
+        for (size_t i = 0; i < count; ++i)
+            result[i] = b[i] + (c[i] - b[i]) * t[i];
+    }
+}
+
+static void InterpolateSlerp(SamplerBatch::Lanes& lanes)
+{
+    const size_t count = lanes.Size();
+    const float* t = lanes.t.data();
+    float* wa = lanes.wa.data();
+    float* wb = lanes.wb.data();
+
+    // Same as quat slerp: the values are quaternions in XYZW order, the dot product is computed in WXYZ order
+    for (size_t i = 0; i < count; ++i)
+    {
+        float dp = lanes.b[3][i] * lanes.c[3][i] + lanes.b[0][i] * lanes.c[0][i]
+            + lanes.b[1][i] * lanes.c[1][i] + lanes.b[2][i] * lanes.c[2][i];
+        // Store the sign and the absolute value of the dot product in the weights for now
+        wb[i] = dp < 0.f ? -1.f : 1.f;
+        wa[i] = std::abs(dp);
+    }
+
+    // The trigonometric functions are not vectorized, but only run for the lanes that need them
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float dp = wa[i];
+        float fa = 1.f - t[i];
+        float fb = t[i];
+        if (1.f - dp > 0.001f)
+        {
+            float theta = std::acos(dp);
+            fa = std::sin(theta * fa) / std::sin(theta);
+            fb = std::sin(theta * fb) / std::sin(theta);
+        }
+        wa[i] = fa;
+        wb[i] = wb[i] * fb;
+    }
+
+    for (int j = 0; j < 4; ++j)
+    {
+        const float* b = lanes.b[j].data();
+        const float* c = lanes.c[j].data();
+        float* result = lanes.result[j].data();
+        for (size_t i = 0; i < count; ++i)
+            result[i] = wa[i] * b[i] + wb[i] * c[i];
+    }
+}
+
+static void InterpolateCatmullRom(SamplerBatch::Lanes& lanes)
+{
+    const size_t count = lanes.Size();
+    const float* t = lanes.t.data();
+    for (int j = 0; j < 4; ++j)
+    {
+        const float* a = lanes.a[j].data();
+        const float* b = lanes.b[j].data();
+        const float* c = lanes.c[j].data();
+        const float* d = lanes.d[j].data();
+        float* result = lanes.result[j].data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            float ci = -a[i] + 3.f * b[i] - 3.f * c[i] + d[i];
+            float cj = 2.f * a[i] - 5.f * b[i] + 4.f * c[i] - d[i];
+            float ck = -a[i] + c[i];
+            result[i] = 0.5f * ((ci * t[i] + cj) * t[i] + ck) * t[i] + b[i];
+        }
+    }
+}
+
+static void InterpolateHermite(SamplerBatch::Lanes& lanes)
+{
+    const size_t count = lanes.Size();
+    const float* t = lanes.t.data();
+    const float* dt = lanes.dt.data();
+    for (int j = 0; j < 4; ++j)
+    {
+        const float* outTangent = lanes.a[j].data();
+        const float* b = lanes.b[j].data();
+        const float* c = lanes.c[j].data();
+        const float* inTangent = lanes.d[j].data();
+        float* result = lanes.result[j].data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float t2 = t[i] * t[i];
+            const float t3 = t2 * t[i];
+            result[i] = (2.f * t3 - 3.f * t2 + 1.f) * b[i]
+                + (t3 - 2.f * t2 + t[i]) * outTangent[i] * dt[i]
+                + (-2.f * t3 + 3.f * t2) * c[i]
+                + (t3 - t2) * inTangent[i] * dt[i];
+        }
+    }
+}
+
+size_t SamplerBatch::AddSampler(std::shared_ptr<Sampler> sampler)
+{
+    m_Samplers.push_back(std::move(sampler));
+    m_Cursors.emplace_back();
+    m_Values.emplace_back(0.f);
+    m_HasValue.push_back(0);
+    return m_Samplers.size() - 1;
+}
+
+void SamplerBatch::Clear()
+{
+    m_Samplers.clear();
+    m_Cursors.clear();
+    m_Values.clear();
+    m_HasValue.clear();
+}
+
+void SamplerBatch::Evaluate(float time, bool extrapolateLastValues)
+{
+    for (Lanes* lanes : { &m_Linear, &m_Slerp, &m_CatmullRom, &m_Hermite })
+    {
+        lanes->count = 0;
+        if (lanes->samplers.size() < m_Samplers.size())
+            lanes->Resize(m_Samplers.size());
+    }
+
+    // Find the segments and gather the keyframes into the lanes of their interpolation modes.
+    // The boundary and step cases are resolved here, same as in Sampler::Evaluate.
+    for (size_t index = 0; index < m_Samplers.size(); ++index)
+    {
+        const Sampler& sampler = *m_Samplers[index];
+        const std::vector<Keyframe>& keyframes = sampler.m_Keyframes;
+        const size_t count = keyframes.size();
+        m_HasValue[index] = 0;
+
+        if (sampler.IsCompressed())
+        {
+            if (std::optional<float4> value = sampler.EvaluateCompressed(sampler.m_Compressed, time,
+                extrapolateLastValues, m_Cursors[index]))
+            {
+                m_Values[index] = *value;
+                m_HasValue[index] = 1;
+            }
+            continue;
+        }
+
+        if (count == 0)
+            continue;
+
+        if (time <= keyframes[0].time)
+        {
+            m_Values[index] = keyframes[0].value;
+            m_HasValue[index] = 1;
+            continue;
+        }
+
+        if (count == 1 || time >= keyframes[count - 1].time)
+        {
+            if (extrapolateLastValues)
+            {
+                m_Values[index] = keyframes[count - 1].value;
+                m_HasValue[index] = 1;
+            }
+            continue;
+        }
+
+        size_t const offset = sampler.FindSegment(time, m_Cursors[index].segment);
+        m_Cursors[index].segment = offset;
+        const Keyframe& b = keyframes[offset];
+        const Keyframe& c = keyframes[offset + 1];
+        const Keyframe& a = (offset > 0) ? keyframes[offset - 1] : b;
+        const Keyframe& d = (offset < count - 2) ? keyframes[offset + 2] : c;
+
+        if (time < b.time || time >= c.time)
+        {
+            assert(!"Incorrect keyframe search result! Array not sorted?");
+            continue;
+        }
+
+        const float dt = c.time - b.time;
+        const float u = (time - b.time) / dt;
+        const uint32_t lane = uint32_t(index);
+
+        switch (sampler.m_Mode)
+        {
+        case InterpolationMode::Linear:
+            m_Linear.Add(lane, b.value, c.value, u, dt);
+            break;
+        case InterpolationMode::Slerp:
+            m_Slerp.Add(lane, b.value, c.value, u, dt);
+            break;
+        case InterpolationMode::CatmullRomSpline:
+            m_CatmullRom.Add(lane, a.value, b.value, c.value, d.value, u, dt);
+            break;
+        case InterpolationMode::HermiteSpline:
+            m_Hermite.Add(lane, b.outTangent, b.value, c.value, c.inTangent, u, dt);
+            break;
+        case InterpolationMode::Step:
+        default:
+            m_Values[index] = Interpolate(sampler.m_Mode, a, b, c, d, u, dt);
+            m_HasValue[index] = 1;
+            break;
+        }
+    }
+
+    const std::pair<Lanes*, void(*)(Lanes&)> groups[] = {
+        { &m_Linear, InterpolateLinear },
+        { &m_Slerp, InterpolateSlerp },
+        { &m_CatmullRom, InterpolateCatmullRom },
+        { &m_Hermite, InterpolateHermite }
+    };
+
+    for (const auto& [lanes, interpolate] : groups)
+    {
+        const size_t count = lanes->Size();
+        if (count == 0)
+            continue;
+
+        interpolate(*lanes);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t index = lanes->samplers[i];
+            m_Values[index] = float4(lanes->result[0][i], lanes->result[1][i], lanes->result[2][i], lanes->result[3][i]);
+            m_HasValue[index] = 1;
+        }
+    }
+}
+
 std::optional<dm::float4> Sequence::Evaluate(const std::string& name, float time, bool extrapolateLastValues)
 {
     std::shared_ptr<Sampler> track = GetTrack(name);
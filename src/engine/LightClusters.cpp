@@ -0,0 +1,408 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/engine/LightClusters.h>
+#include <donut/engine/SceneGraph.h>
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define DONUT_LIGHT_CLUSTERS_SSE2 1
+#include <emmintrin.h>
+#else
+#define DONUT_LIGHT_CLUSTERS_SSE2 0
+#endif
+
+using namespace donut::math;
+using namespace donut::engine;
+
+// Tile ranges computed from projected light bounds are extended by this fraction of a tile to absorb rounding errors.
+static constexpr float c_TileRangeEpsilon = 1e-3f;
+
+bool ClusterLight::FromLight(const Light& light, ClusterLight& result)
+{
+    float range = 0.f;
+    float outerAngle = 180.f;
+
+    if (auto pointLight = dynamic_cast<const PointLight*>(&light))
+    {
+        range = pointLight->range;
+    }
+    else if (auto spotLight = dynamic_cast<const SpotLight*>(&light))
+    {
+        range = spotLight->range;
+        outerAngle = spotLight->outerAngle;
+    }
+    else
+        return false;
+
+    // Lights with infinite range reach every cluster
+    if (range <= 0.f)
+        return false;
+
+    result.position = float3(light.GetPosition());
+    result.range = range;
+    result.direction = float3(light.GetDirection());
+    result.cosOuterAngle = -1.f;
+    result.sinOuterAngle = 0.f;
+
+    // The shaders use the outer angle as the angle between the cone axis and its side
+    float angle = radians(outerAngle);
+    if (angle < PI_f * 0.5f)
+    {
+        result.cosOuterAngle = cosf(angle);
+        result.sinOuterAngle = sinf(angle);
+    }
+
+    return true;
+}
+
+bool LightClusterGrid::Desc::operator==(const Desc& other) const
+{
+    return tilesX == other.tilesX &&
+        tilesY == other.tilesY &&
+        slices == other.slices &&
+        nearZ == other.nearZ &&
+        farZ == other.farZ;
+}
+
+void LightClusterGrid::Setup(const affine3& worldToView, const float4x4& viewToClip, const Desc& desc)
+{
+    m_WorldToView = worldToView;
+
+    if (m_IsSetup && desc == m_Desc && all(viewToClip == m_ViewToClip))
+        return;
+
+    m_Desc = desc;
+    m_Desc.tilesX = std::max(m_Desc.tilesX, 1u);
+    m_Desc.tilesY = std::max(m_Desc.tilesY, 1u);
+    m_Desc.slices = std::max(m_Desc.slices, 1u);
+    m_Desc.nearZ = std::max(m_Desc.nearZ, 1e-4f);
+    m_Desc.farZ = std::max(m_Desc.farZ, m_Desc.nearZ * 1.001f);
+    m_ViewToClip = viewToClip;
+    m_IsSetup = true;
+
+    BuildClusterBounds();
+}
+
+void LightClusterGrid::BuildClusterBounds()
+{
+    const uint32_t tilesX = m_Desc.tilesX;
+    const uint32_t tilesY = m_Desc.tilesY;
+    const uint32_t slices = m_Desc.slices;
+
+    m_SliceDepths.resize(slices + 1);
+    m_SliceDepths[0] = 0.f;
+    for (uint32_t slice = 1; slice < slices; slice++)
+        m_SliceDepths[slice] = m_Desc.nearZ * std::pow(m_Desc.farZ / m_Desc.nearZ, float(slice) / float(slices));
+    m_SliceDepths[slices] = m_Desc.farZ;
+
+    // The view rays through the tile corners, as a point and the change of the point per unit of view depth.
+    // Two points at different depths make this work with both perspective and orthographic projections.
+    const float4x4 clipToView = inverse(m_ViewToClip);
+    auto unproject = [&clipToView](float x, float y, float z)
+    {
+        float4 p = float4(x, y, z, 1.f) * clipToView;
+        return p.xyz() / p.w;
+    };
+
+    std::vector<float3> rayOrigins((tilesX + 1) * (tilesY + 1));
+    std::vector<float3> raySlopes(rayOrigins.size());
+    for (uint32_t y = 0; y <= tilesY; y++)
+    {
+        for (uint32_t x = 0; x <= tilesX; x++)
+        {
+            float ndcX = float(x) / float(tilesX) * 2.f - 1.f;
+            float ndcY = 1.f - float(y) / float(tilesY) * 2.f;
+            float3 a = unproject(ndcX, ndcY, 0.25f);
+            float3 b = unproject(ndcX, ndcY, 0.75f);
+
+            uint32_t index = y * (tilesX + 1) + x;
+            rayOrigins[index] = a;
+            raySlopes[index] = (b - a) / (b.z - a.z);
+        }
+    }
+
+    const uint32_t numClusters = GetNumClusters();
+    const size_t paddedSize = numClusters + 4;
+    for (auto* array : { &m_MinX, &m_MinY, &m_MinZ, &m_CenterX, &m_CenterY, &m_CenterZ })
+        array->assign(paddedSize, FLT_MAX);
+    for (auto* array : { &m_MaxX, &m_MaxY, &m_MaxZ })
+        array->assign(paddedSize, -FLT_MAX);
+    m_Radius.assign(paddedSize, 0.f);
+
+    for (uint32_t slice = 0; slice < slices; slice++)
+    {
+        const float depths[2] = { m_SliceDepths[slice], m_SliceDepths[slice + 1] };
+
+        for (uint32_t y = 0; y < tilesY; y++)
+        {
+            for (uint32_t x = 0; x < tilesX; x++)
+            {
+                box3 bounds = box3::empty();
+                for (uint32_t corner = 0; corner < 4; corner++)
+                {
+                    uint32_t rayIndex = (y + (corner >> 1)) * (tilesX + 1) + x + (corner & 1);
+                    for (float depth : depths)
+                        bounds |= rayOrigins[rayIndex] + raySlopes[rayIndex] * (depth - rayOrigins[rayIndex].z);
+                }
+
+                uint32_t index = GetClusterIndex(x, y, slice);
+                m_MinX[index] = bounds.m_mins.x;
+                m_MinY[index] = bounds.m_mins.y;
+                m_MinZ[index] = bounds.m_mins.z;
+                m_MaxX[index] = bounds.m_maxs.x;
+                m_MaxY[index] = bounds.m_maxs.y;
+                m_MaxZ[index] = bounds.m_maxs.z;
+
+                float3 center = bounds.center();
+                m_CenterX[index] = center.x;
+                m_CenterY[index] = center.y;
+                m_CenterZ[index] = center.z;
+                m_Radius[index] = length(bounds.diagonal()) * 0.5f;
+            }
+        }
+    }
+}
+
+uint32_t LightClusterGrid::GetSliceIndex(float viewDepth) const
+{
+    if (viewDepth <= 0.f)
+        return 0;
+
+    float2 scaleBias = GetSliceScaleBias();
+    float slice = floorf(std::log2(viewDepth) * scaleBias.x + scaleBias.y);
+    return uint32_t(clamp(slice, 0.f, float(m_Desc.slices - 1)));
+}
+
+float2 LightClusterGrid::GetSliceScaleBias() const
+{
+    float scale = float(m_Desc.slices) / std::log2(m_Desc.farZ / m_Desc.nearZ);
+    return float2(scale, -std::log2(m_Desc.nearZ) * scale);
+}
+
+box3 LightClusterGrid::GetClusterBounds(uint32_t clusterIndex) const
+{
+    return box3(
+        float3(m_MinX[clusterIndex], m_MinY[clusterIndex], m_MinZ[clusterIndex]),
+        float3(m_MaxX[clusterIndex], m_MaxY[clusterIndex], m_MaxZ[clusterIndex]));
+}
+
+void LightClusterGrid::BinLight(const ClusterLight& light, uint32_t lightIndex)
+{
+    const float3 center = m_WorldToView.transformPoint(light.position);
+    const float radius = light.range;
+
+    const float minDepth = center.z - radius;
+    const float maxDepth = center.z + radius;
+    if (maxDepth < 0.f)
+        return;
+
+    // The shaders put the surfaces beyond farZ into the last slice, so the lights reaching past farZ are binned
+    // into all of its clusters that they project to, without testing them against the cluster bounds.
+    const uint32_t farSlice = m_Desc.slices - 1;
+    const bool reachesBeyondFarZ = maxDepth > m_Desc.farZ;
+
+    // Slices whose depth ranges overlap the light
+    uint32_t firstSlice = 0;
+    while (firstSlice + 1 < m_Desc.slices && m_SliceDepths[firstSlice + 1] < minDepth)
+        ++firstSlice;
+    uint32_t lastSlice = firstSlice;
+    while (lastSlice + 1 < m_Desc.slices && m_SliceDepths[lastSlice + 1] <= maxDepth)
+        ++lastSlice;
+
+    // Tiles covered by the projection of the light bounding box, or all tiles if the box crosses the camera plane
+    int firstTileX = 0, lastTileX = int(m_Desc.tilesX) - 1;
+    int firstTileY = 0, lastTileY = int(m_Desc.tilesY) - 1;
+    {
+        float2 ndcMin = FLT_MAX;
+        float2 ndcMax = -FLT_MAX;
+        bool allInFront = true;
+        for (uint32_t corner = 0; corner < 8 && allInFront; corner++)
+        {
+            float3 p = center + float3(
+                (corner & 1) ? radius : -radius,
+                (corner & 2) ? radius : -radius,
+                (corner & 4) ? radius : -radius);
+            float4 clip = float4(p, 1.f) * m_ViewToClip;
+            allInFront = clip.w > 1e-6f;
+            float2 ndc = clip.xy() / clip.w;
+            ndcMin = min(ndcMin, ndc);
+            ndcMax = max(ndcMax, ndc);
+        }
+
+        if (allInFront)
+        {
+            float tileMinX = (ndcMin.x * 0.5f + 0.5f) * float(m_Desc.tilesX);
+            float tileMaxX = (ndcMax.x * 0.5f + 0.5f) * float(m_Desc.tilesX);
+            float tileMinY = (0.5f - ndcMax.y * 0.5f) * float(m_Desc.tilesY);
+            float tileMaxY = (0.5f - ndcMin.y * 0.5f) * float(m_Desc.tilesY);
+
+            if (tileMaxX < 0.f || tileMaxY < 0.f || tileMinX >= float(m_Desc.tilesX) || tileMinY >= float(m_Desc.tilesY))
+                return;
+
+            firstTileX = std::max(firstTileX, int(floorf(tileMinX - c_TileRangeEpsilon)));
+            lastTileX = std::min(lastTileX, int(floorf(tileMaxX + c_TileRangeEpsilon)));
+            firstTileY = std::max(firstTileY, int(floorf(tileMinY - c_TileRangeEpsilon)));
+            lastTileY = std::min(lastTileY, int(floorf(tileMaxY + c_TileRangeEpsilon)));
+        }
+    }
+
+    const bool isSpot = light.cosOuterAngle > -1.f;
+    const float3 direction = isSpot ? normalize(m_WorldToView.transformVector(light.direction)) : float3(0.f);
+    const float radiusSquared = radius * radius;
+
+    for (uint32_t slice = firstSlice; slice <= lastSlice; slice++)
+    {
+        if (reachesBeyondFarZ && slice == farSlice)
+        {
+            for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+            {
+                for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+                {
+                    m_HitClusters.push_back(GetClusterIndex(uint32_t(tileX), uint32_t(tileY), slice));
+                    m_HitLights.push_back(lightIndex);
+                }
+            }
+            continue;
+        }
+
+        for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+        {
+            const uint32_t rowStart = GetClusterIndex(0, uint32_t(tileY), slice);
+
+#if DONUT_LIGHT_CLUSTERS_SSE2
+            const __m128 centerX = _mm_set1_ps(center.x);
+            const __m128 centerY = _mm_set1_ps(center.y);
+            const __m128 centerZ = _mm_set1_ps(center.z);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (int tileX = firstTileX; tileX <= lastTileX; tileX += 4)
+            {
+                const uint32_t index = rowStart + uint32_t(tileX);
+
+                // Squared distance from the light center to the cluster box
+                __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinX[index]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&m_MaxX[index]))), zero);
+                __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinY[index]), centerY), _mm_sub_ps(centerY, _mm_loadu_ps(&m_MaxY[index]))), zero);
+                __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinZ[index]), centerZ), _mm_sub_ps(centerZ, _mm_loadu_ps(&m_MaxZ[index]))), zero);
+                __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_set1_ps(radiusSquared)));
+
+                if (isSpot && mask != 0)
+                {
+                    // Cone against the cluster bounding sphere
+                    __m128 vx = _mm_sub_ps(_mm_loadu_ps(&m_CenterX[index]), centerX);
+                    __m128 vy = _mm_sub_ps(_mm_loadu_ps(&m_CenterY[index]), centerY);
+                    __m128 vz = _mm_sub_ps(_mm_loadu_ps(&m_CenterZ[index]), centerZ);
+                    __m128 sphereRadius = _mm_loadu_ps(&m_Radius[index]);
+                    __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+                    __m128 axial = _mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(vx, _mm_set1_ps(direction.x)),
+                        _mm_mul_ps(vy, _mm_set1_ps(direction.y))),
+                        _mm_mul_ps(vz, _mm_set1_ps(direction.z)));
+                    __m128 radial = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lengthSquared, _mm_mul_ps(axial, axial)), zero));
+                    __m128 closest = _mm_sub_ps(
+                        _mm_mul_ps(_mm_set1_ps(light.cosOuterAngle), radial),
+                        _mm_mul_ps(_mm_set1_ps(light.sinOuterAngle), axial));
+                    __m128 inside = _mm_and_ps(
+                        _mm_cmple_ps(closest, sphereRadius),
+                        _mm_cmpge_ps(axial, _mm_sub_ps(zero, sphereRadius)));
+                    mask &= _mm_movemask_ps(inside);
+                }
+
+                // Drop the lanes past the last tile
+                int numLanes = std::min(4, lastTileX - tileX + 1);
+                mask &= (1 << numLanes) - 1;
+
+                while (mask)
+                {
+                    int lane = 0;
+                    while ((mask & (1 << lane)) == 0)
+                        ++lane;
+                    mask &= ~(1 << lane);
+
+                    m_HitClusters.push_back(index + uint32_t(lane));
+                    m_HitLights.push_back(lightIndex);
+                }
+            }
+#else
+            for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+            {
+                const uint32_t index = rowStart + uint32_t(tileX);
+
+                float dx = std::max(std::max(m_MinX[index] - center.x, center.x - m_MaxX[index]), 0.f);
+                float dy = std::max(std::max(m_MinY[index] - center.y, center.y - m_MaxY[index]), 0.f);
+                float dz = std::max(std::max(m_MinZ[index] - center.z, center.z - m_MaxZ[index]), 0.f);
+                if (dx * dx + dy * dy + dz * dz > radiusSquared)
+                    continue;
+
+                if (isSpot)
+                {
+                    float3 v = float3(m_CenterX[index], m_CenterY[index], m_CenterZ[index]) - center;
+                    float axial = dot(v, direction);
+                    float radial = sqrtf(std::max(dot(v, v) - axial * axial, 0.f));
+                    float closest = light.cosOuterAngle * radial - light.sinOuterAngle * axial;
+                    if (closest > m_Radius[index] || axial < -m_Radius[index])
+                        continue;
+                }
+
+                m_HitClusters.push_back(index);
+                m_HitLights.push_back(lightIndex);
+            }
+#endif
+        }
+    }
+}
+
+void LightClusterGrid::BinLights(const ClusterLight* lights, uint32_t numLights)
+{
+    assert(m_IsSetup);
+
+    m_HitClusters.clear();
+    m_HitLights.clear();
+
+    for (uint32_t lightIndex = 0; lightIndex < numLights; lightIndex++)
+        BinLight(lights[lightIndex], lightIndex);
+
+    // Counting sort of the hits by cluster; the hits are in light order, so each cluster lists its lights in order
+    const uint32_t numClusters = GetNumClusters();
+    m_ClusterRanges.assign(numClusters, uint2(0u));
+    for (uint32_t cluster : m_HitClusters)
+        ++m_ClusterRanges[cluster].y;
+
+    uint32_t offset = 0;
+    for (auto& range : m_ClusterRanges)
+    {
+        range.x = offset;
+        offset += range.y;
+        range.y = 0;
+    }
+
+    m_LightIndices.resize(m_HitClusters.size());
+    for (size_t hit = 0; hit < m_HitClusters.size(); hit++)
+    {
+        uint2& range = m_ClusterRanges[m_HitClusters[hit]];
+        m_LightIndices[range.x + range.y] = m_HitLights[hit];
+        ++range.y;
+    }
+}
@@ -88,14 +88,19 @@ nvrhi::IBindingSet* donut::engine::MaterialBindingCache::GetMaterialBindingSet(c
 {
     std::lock_guard<std::mutex> lockGuard(m_Mutex);
 
-    nvrhi::BindingSetHandle& bindingSet = m_BindingSets[material];
+    CachedBindingSet& entry = m_BindingSets[material];
 
-    if (bindingSet)
-        return bindingSet;
+    // Streamed textures replace their texture objects when the resident mips change, and the binding set
+    // has to be recreated to reference the new objects.
+    const uint64_t textureGeneration = GetTextureGeneration(material);
 
-    bindingSet = CreateMaterialBindingSet(material);
+    if (entry.bindingSet && entry.textureGeneration == textureGeneration)
+        return entry.bindingSet;
 
-    return bindingSet;
+    entry.bindingSet = CreateMaterialBindingSet(material);
+    entry.textureGeneration = textureGeneration;
+
+    return entry.bindingSet;
 }
 
 void donut::engine::MaterialBindingCache::Clear()
@@ -110,6 +115,34 @@ nvrhi::BindingSetItem MaterialBindingCache::GetTextureBindingSetItem(uint32_t sl
     return nvrhi::BindingSetItem::Texture_SRV(slot, texture && texture->texture ? texture->texture.Get() : m_FallbackTexture.Get());
 }
 
+uint64_t MaterialBindingCache::GetTextureGeneration(const Material* material) const
+{
+    // Generations only grow, so the sum changes whenever any of the textures is replaced.
+    uint64_t generation = 0;
+
+    for (const auto& item : m_BindingDesc)
+    {
+        const LoadedTexture* texture = nullptr;
+
+        switch (item.resource)
+        {
+        case MaterialResource::DiffuseTexture:      texture = material->baseOrDiffuseTexture.get(); break;
+        case MaterialResource::SpecularTexture:     texture = material->metalRoughOrSpecularTexture.get(); break;
+        case MaterialResource::NormalTexture:       texture = material->normalTexture.get(); break;
+        case MaterialResource::EmissiveTexture:     texture = material->emissiveTexture.get(); break;
+        case MaterialResource::OcclusionTexture:    texture = material->occlusionTexture.get(); break;
+        case MaterialResource::TransmissionTexture: texture = material->transmissionTexture.get(); break;
+        case MaterialResource::OpacityTexture:      texture = material->opacityTexture.get(); break;
+        default: break;
+        }
+
+        if (texture)
+            generation += texture->generation;
+    }
+
+    return generation;
+}
+
 nvrhi::BindingSetHandle donut::engine::MaterialBindingCache::CreateMaterialBindingSet(const Material* material)
 {
     nvrhi::BindingSetDesc bindingSetDesc;
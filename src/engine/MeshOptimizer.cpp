@@ -0,0 +1,613 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshOptimizer.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/log.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace donut::math;
+using namespace donut::engine;
+
+namespace
+{
+    constexpr uint32_t c_InvalidIndex = ~0u;
+
+    // Parameters of the vertex scores in Forsyth's algorithm
+    constexpr uint32_t c_CacheSize = 32;
+    constexpr float c_CacheDecayPower = 1.5f;
+    constexpr float c_LastTriangleScore = 0.75f;
+    constexpr float c_ValenceBoostScale = 2.f;
+    constexpr float c_ValenceBoostPower = 0.5f;
+    constexpr uint32_t c_MaxValence = 32;
+
+    struct VertexScoreTable
+    {
+        float cache[c_CacheSize];
+        float valence[c_MaxValence + 1];
+
+        VertexScoreTable()
+        {
+            for (uint32_t position = 0; position < c_CacheSize; ++position)
+            {
+                // The vertices of the last triangle get a fixed score, so that its neighbors are not preferred
+                // over triangles that use the other cached vertices
+                cache[position] = (position < 3)
+                    ? c_LastTriangleScore
+                    : powf(1.f - float(position - 3) / float(c_CacheSize - 3), c_CacheDecayPower);
+            }
+
+            valence[0] = 0.f;
+            for (uint32_t count = 1; count <= c_MaxValence; ++count)
+                valence[count] = c_ValenceBoostScale * powf(float(count), -c_ValenceBoostPower);
+        }
+
+        [[nodiscard]] float Get(uint32_t cachePosition, uint32_t remainingTriangles) const
+        {
+            if (remainingTriangles == 0)
+                return -1.f;
+
+            const float cacheScore = (cachePosition < c_CacheSize) ? cache[cachePosition] : 0.f;
+            return cacheScore + valence[std::min(remainingTriangles, c_MaxValence)];
+        }
+    };
+
+    const VertexScoreTable c_VertexScores;
+
+    struct VertexStream
+    {
+        const uint8_t* data;
+        size_t elementSize;
+    };
+
+    // Maps every vertex to the first vertex that has the same data in all streams
+    void GenerateVertexRemap(const std::vector<VertexStream>& streams, size_t numVertices, std::vector<uint32_t>& remap)
+    {
+        auto hash = [&streams](uint32_t vertex)
+        {
+            uint64_t result = 14695981039346656037ull;
+            for (const VertexStream& stream : streams)
+            {
+                const uint8_t* bytes = stream.data + vertex * stream.elementSize;
+                for (size_t index = 0; index < stream.elementSize; ++index)
+                    result = (result ^ bytes[index]) * 1099511628211ull;
+            }
+            return size_t(result);
+        };
+
+        auto equal = [&streams](uint32_t a, uint32_t b)
+        {
+            for (const VertexStream& stream : streams)
+            {
+                if (memcmp(stream.data + a * stream.elementSize, stream.data + b * stream.elementSize, stream.elementSize) != 0)
+                    return false;
+            }
+            return true;
+        };
+
+        std::unordered_set<uint32_t, decltype(hash), decltype(equal)> uniqueVertices(numVertices, hash, equal);
+
+        remap.resize(numVertices);
+        for (uint32_t vertex = 0; vertex < uint32_t(numVertices); ++vertex)
+            remap[vertex] = *uniqueVertices.insert(vertex).first;
+    }
+
+    template<typename T>
+    void RemapStream(std::vector<T>& data, const std::vector<uint32_t>& oldVertices)
+    {
+        if (data.empty())
+            return;
+
+        std::vector<T> remapped;
+        remapped.reserve(oldVertices.size());
+        for (uint32_t vertex : oldVertices)
+            remapped.push_back(data[vertex]);
+        data.swap(remapped);
+    }
+}
+
+VertexCacheStatistics donut::engine::AnalyzeVertexCache(
+    const uint32_t* indices,
+    size_t numIndices,
+    size_t numVertices,
+    uint32_t cacheSize)
+{
+    VertexCacheStatistics stats;
+    stats.triangles = numIndices / 3;
+
+    // A vertex is in the FIFO cache while fewer than 'cacheSize' other vertices have been loaded after it
+    std::vector<uint32_t> timestamps(numVertices, 0);
+    uint32_t timestamp = cacheSize + 1;
+
+    for (size_t index = 0; index < stats.triangles * 3; ++index)
+    {
+        const uint32_t vertex = indices[index];
+        assert(vertex < numVertices);
+
+        if (timestamps[vertex] == 0)
+            ++stats.vertices;
+
+        if (timestamp - timestamps[vertex] > cacheSize)
+        {
+            timestamps[vertex] = timestamp++;
+            ++stats.transforms;
+        }
+    }
+
+    return stats;
+}
+
+void donut::engine::OptimizeVertexCache(
+    uint32_t* destination,
+    const uint32_t* indices,
+    size_t numIndices,
+    size_t numVertices)
+{
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles == 0)
+        return;
+
+    // Copy the input, so that the output can overwrite it
+    const std::vector<uint32_t> input(indices, indices + numTriangles * 3);
+
+    // Triangles around each vertex; the emitted triangles are moved past the end of each list
+    std::vector<uint32_t> remainingTriangles(numVertices, 0);
+    for (uint32_t vertex : input)
+    {
+        assert(vertex < numVertices);
+        ++remainingTriangles[vertex];
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+    for (size_t vertex = 0; vertex < numVertices; ++vertex)
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + remainingTriangles[vertex];
+
+    std::vector<uint32_t> adjacency(input.size());
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t index = 0; index < input.size(); ++index)
+            adjacency[fill[input[index]]++] = uint32_t(index / 3);
+    }
+
+    std::vector<uint32_t> cachePositions(numVertices, c_InvalidIndex);
+    std::vector<float> vertexScores(numVertices);
+    for (size_t vertex = 0; vertex < numVertices; ++vertex)
+        vertexScores[vertex] = c_VertexScores.Get(c_InvalidIndex, remainingTriangles[vertex]);
+
+    auto getTriangleScore = [&input, &vertexScores](uint32_t triangle)
+    {
+        const uint32_t* vertices = input.data() + size_t(triangle) * 3;
+        return vertexScores[vertices[0]] + vertexScores[vertices[1]] + vertexScores[vertices[2]];
+    };
+
+    // Start with the best triangle overall: low valence vertices, typically on a border
+    uint32_t bestTriangle = 0;
+    float bestScore = getTriangleScore(0);
+    for (uint32_t triangle = 1; triangle < uint32_t(numTriangles); ++triangle)
+    {
+        const float score = getTriangleScore(triangle);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestTriangle = triangle;
+        }
+    }
+
+    std::vector<bool> emitted(numTriangles, false);
+    size_t inputCursor = 0;
+
+    uint32_t cache[c_CacheSize + 3];
+    uint32_t newCache[c_CacheSize + 3];
+    size_t cacheCount = 0;
+
+    for (size_t output = 0; output < numTriangles; ++output)
+    {
+        // When no cached vertex has triangles left, continue with the next triangle in input order
+        if (bestTriangle == c_InvalidIndex)
+        {
+            while (emitted[inputCursor])
+                ++inputCursor;
+            bestTriangle = uint32_t(inputCursor);
+        }
+
+        const uint32_t* triangle = input.data() + size_t(bestTriangle) * 3;
+        destination[output * 3 + 0] = triangle[0];
+        destination[output * 3 + 1] = triangle[1];
+        destination[output * 3 + 2] = triangle[2];
+        emitted[bestTriangle] = true;
+
+        size_t newCacheCount = 0;
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t vertex = triangle[corner];
+            if (std::find(newCache, newCache + newCacheCount, vertex) != newCache + newCacheCount)
+                continue;
+
+            // Remove the triangle from the list of the vertex
+            uint32_t* triangles = adjacency.data() + adjacencyOffsets[vertex];
+            uint32_t& count = remainingTriangles[vertex];
+            uint32_t* found = std::find(triangles, triangles + count, bestTriangle);
+            assert(found != triangles + count);
+            std::swap(*found, triangles[count - 1]);
+            --count;
+
+            newCache[newCacheCount++] = vertex;
+        }
+
+        // Move the vertices of the triangle to the front of the LRU cache
+        for (size_t index = 0; index < cacheCount; ++index)
+        {
+            const uint32_t vertex = cache[index];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                newCache[newCacheCount++] = vertex;
+        }
+
+        // Update the scores of the cached and evicted vertices, then pick the best triangle around the cached ones
+        for (size_t index = 0; index < newCacheCount; ++index)
+        {
+            const uint32_t vertex = newCache[index];
+            cachePositions[vertex] = (index < c_CacheSize) ? uint32_t(index) : c_InvalidIndex;
+            vertexScores[vertex] = c_VertexScores.Get(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+
+        bestTriangle = c_InvalidIndex;
+        bestScore = -1.f;
+        cacheCount = std::min<size_t>(newCacheCount, c_CacheSize);
+        for (size_t index = 0; index < cacheCount; ++index)
+        {
+            const uint32_t vertex = newCache[index];
+            const uint32_t* triangles = adjacency.data() + adjacencyOffsets[vertex];
+            for (uint32_t adjacent = 0; adjacent < remainingTriangles[vertex]; ++adjacent)
+            {
+                const float score = getTriangleScore(triangles[adjacent]);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = triangles[adjacent];
+                }
+            }
+
+            cache[index] = vertex;
+        }
+    }
+}
+
+uint32_t donut::engine::OptimizeVertexFetch(
+    uint32_t* indices,
+    size_t numIndices,
+    size_t numVertices,
+    std::vector<uint32_t>& vertexOrder)
+{
+    std::vector<uint32_t> newIndices(numVertices, c_InvalidIndex);
+    vertexOrder.clear();
+
+    for (size_t index = 0; index < numIndices; ++index)
+    {
+        const uint32_t vertex = indices[index];
+        assert(vertex < numVertices);
+
+        if (newIndices[vertex] == c_InvalidIndex)
+        {
+            newIndices[vertex] = uint32_t(vertexOrder.size());
+            vertexOrder.push_back(vertex);
+        }
+        indices[index] = newIndices[vertex];
+    }
+
+    return uint32_t(vertexOrder.size());
+}
+
+MeshOptimizationResult donut::engine::OptimizeMeshes(
+    const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+    const MeshOptimizationParams& params,
+    ThreadPool* threadPool)
+{
+    struct GeometryItem
+    {
+        MeshGeometry* geometry = nullptr;
+        const std::vector<VertexStream>* streams = nullptr;
+        uint32_t oldFirstVertex = 0;            // in the buffer group
+        bool optimize = false;
+        std::vector<uint32_t> indices;
+        std::vector<uint32_t> vertexOrder;      // old geometry-local index of every new vertex
+        std::vector<uint32_t> duplicateRemap;   // old geometry-local index of the vertex that replaces each duplicate
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+    };
+
+    struct GroupItem
+    {
+        BufferGroup* buffers = nullptr;
+        std::vector<MeshInfo*> meshes;
+        std::vector<VertexStream> streams;
+        std::vector<GeometryItem> geometries;   // in the order of the meshes and their geometries
+    };
+
+    // Meshes of skinned instances don't own their vertex data, and the meshes of one buffer group are processed together
+    std::vector<GroupItem> groups;
+    {
+        std::unordered_map<BufferGroup*, size_t> groupIndices;
+        std::unordered_set<MeshInfo*> visitedMeshes;
+        for (const auto& mesh : meshes)
+        {
+            if (!mesh || !mesh->buffers || mesh->skinPrototype || !visitedMeshes.insert(mesh.get()).second)
+                continue;
+
+            auto [found, inserted] = groupIndices.emplace(mesh->buffers.get(), groups.size());
+            if (inserted)
+                groups.emplace_back().buffers = mesh->buffers.get();
+            groups[found->second].meshes.push_back(mesh.get());
+        }
+    }
+
+    for (GroupItem& group : groups)
+    {
+        BufferGroup& buffers = *group.buffers;
+        const size_t numVertices = buffers.positionData.size();
+        bool valid = numVertices > 0;
+
+        auto addStream = [&group, &valid, numVertices](const auto& data)
+        {
+            if (data.empty())
+                return;
+            if (data.size() != numVertices)
+                valid = false;
+            else
+                group.streams.push_back({ reinterpret_cast<const uint8_t*>(data.data()), sizeof(data[0]) });
+        };
+
+        addStream(buffers.positionData);
+        addStream(buffers.normalData);
+        addStream(buffers.tangentData);
+        addStream(buffers.texcoord1Data);
+        addStream(buffers.texcoord2Data);
+        addStream(buffers.jointData);
+        addStream(buffers.weightData);
+        addStream(buffers.radiusData);
+
+        // Every morph target frame covers the whole buffer group
+        if (!buffers.morphTargetData.empty() && valid)
+        {
+            const size_t numFrames = buffers.morphTargetData.size() / numVertices;
+            valid = buffers.morphTargetData.size() % numVertices == 0 && numFrames == buffers.morphTargetBufferRange.size();
+            for (size_t frame = 0; frame < numFrames && valid; ++frame)
+                group.streams.push_back({ reinterpret_cast<const uint8_t*>(buffers.morphTargetData.data() + frame * numVertices), sizeof(float4) });
+        }
+
+        // The vertex ranges of the geometries must not overlap, because each geometry gets its own new range
+        std::vector<std::pair<size_t, size_t>> vertexRanges;
+        std::sort(group.meshes.begin(), group.meshes.end(), [](const MeshInfo* a, const MeshInfo* b) { return a->vertexOffset < b->vertexOffset; });
+        for (MeshInfo* mesh : group.meshes)
+        {
+            for (const auto& geometry : mesh->geometries)
+            {
+                const size_t firstVertex = size_t(mesh->vertexOffset) + geometry->vertexOffsetInMesh;
+                const size_t firstIndex = size_t(mesh->indexOffset) + geometry->indexOffsetInMesh;
+                valid &= firstVertex + geometry->numVertices <= numVertices && firstIndex + geometry->numIndices <= buffers.indexData.size();
+                vertexRanges.emplace_back(firstVertex, firstVertex + geometry->numVertices);
+
+                GeometryItem& item = group.geometries.emplace_back();
+                item.geometry = geometry.get();
+                item.streams = &group.streams;
+                item.oldFirstVertex = uint32_t(firstVertex);
+                item.optimize = geometry->type == MeshGeometryPrimitiveType::Triangles && geometry->numIndices >= 3 && !mesh->IsCurve();
+                if (valid && item.optimize)
+                {
+                    const uint32_t* indices = buffers.indexData.data() + firstIndex;
+                    item.indices.assign(indices, indices + geometry->numIndices);
+                    valid = std::all_of(item.indices.begin(), item.indices.end(), [&geometry](uint32_t index) { return index < geometry->numVertices; });
+                }
+            }
+        }
+
+        std::sort(vertexRanges.begin(), vertexRanges.end());
+        for (size_t index = 1; index < vertexRanges.size(); ++index)
+            valid &= vertexRanges[index - 1].second <= vertexRanges[index].first;
+
+        if (!valid)
+        {
+            log::warning("Skipping the optimization of a buffer group with an unexpected vertex layout");
+            group.meshes.clear();
+            group.geometries.clear();
+        }
+    }
+
+    auto optimize = [&params](GeometryItem& item)
+    {
+        const uint32_t numVertices = item.geometry->numVertices;
+        uint32_t* indices = item.indices.data();
+        const size_t numIndices = item.indices.size();
+
+        item.before = AnalyzeVertexCache(indices, numIndices, numVertices, params.statisticsCacheSize);
+
+        if (params.deduplicateVertices)
+        {
+            std::vector<VertexStream> streams = *item.streams;
+            for (VertexStream& stream : streams)
+                stream.data += item.oldFirstVertex * stream.elementSize;
+
+            GenerateVertexRemap(streams, numVertices, item.duplicateRemap);
+            for (size_t index = 0; index < numIndices; ++index)
+                indices[index] = item.duplicateRemap[indices[index]];
+        }
+
+        if (params.optimizeVertexCache)
+            OptimizeVertexCache(indices, indices, numIndices, numVertices);
+
+        uint32_t newNumVertices = numVertices;
+        if (params.optimizeVertexFetch)
+        {
+            newNumVertices = OptimizeVertexFetch(indices, numIndices, numVertices, item.vertexOrder);
+        }
+        else if (params.deduplicateVertices)
+        {
+            // Drop the merged vertices, but keep the order of the others
+            std::vector<uint32_t> newIndices(numVertices, c_InvalidIndex);
+            for (size_t index = 0; index < numIndices; ++index)
+                newIndices[indices[index]] = 0;
+            for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+            {
+                if (newIndices[vertex] == 0)
+                {
+                    newIndices[vertex] = uint32_t(item.vertexOrder.size());
+                    item.vertexOrder.push_back(vertex);
+                }
+            }
+            for (size_t index = 0; index < numIndices; ++index)
+                indices[index] = newIndices[indices[index]];
+            newNumVertices = uint32_t(item.vertexOrder.size());
+        }
+
+        item.after = AnalyzeVertexCache(indices, numIndices, newNumVertices, params.statisticsCacheSize);
+    };
+
+    std::vector<GeometryItem*> work;
+    for (GroupItem& group : groups)
+    {
+        for (GeometryItem& item : group.geometries)
+        {
+            if (item.optimize)
+                work.push_back(&item);
+        }
+    }
+
+    if (threadPool && work.size() > 1)
+    {
+        ThreadPoolTaskGroup taskGroup;
+        for (GeometryItem* item : work)
+            threadPool->AddTask(taskGroup, [&optimize, item]() { optimize(*item); });
+        threadPool->Wait(taskGroup);
+    }
+    else
+    {
+        for (GeometryItem* item : work)
+            optimize(*item);
+    }
+
+    MeshOptimizationResult result;
+
+    // Lay out the new vertex ranges of the geometries one after another, and remap all vertex streams
+    for (GroupItem& group : groups)
+    {
+        if (group.geometries.empty())
+            continue;
+
+        BufferGroup& buffers = *group.buffers;
+        const size_t oldNumVertices = buffers.positionData.size();
+        std::vector<uint32_t> oldVertices;
+        std::vector<uint32_t> newVertices(oldNumVertices, c_InvalidIndex);
+        oldVertices.reserve(oldNumVertices);
+
+        GeometryItem* item = group.geometries.data();
+        for (MeshInfo* mesh : group.meshes)
+        {
+            const uint32_t meshFirstVertex = uint32_t(oldVertices.size());
+            for (const auto& geometry : mesh->geometries)
+            {
+                assert(item->geometry == geometry.get());
+                const uint32_t firstVertex = uint32_t(oldVertices.size());
+
+                if (item->optimize)
+                {
+                    result.before += item->before;
+                    result.after += item->after;
+
+                    if (item->vertexOrder.empty() && !params.optimizeVertexFetch && !params.deduplicateVertices)
+                    {
+                        for (uint32_t vertex = 0; vertex < geometry->numVertices; ++vertex)
+                            item->vertexOrder.push_back(vertex);
+                    }
+
+                    std::copy(item->indices.begin(), item->indices.end(),
+                        buffers.indexData.begin() + mesh->indexOffset + geometry->indexOffsetInMesh);
+                }
+                else
+                {
+                    for (uint32_t vertex = 0; vertex < geometry->numVertices; ++vertex)
+                        item->vertexOrder.push_back(vertex);
+                }
+
+                for (uint32_t vertex : item->vertexOrder)
+                {
+                    newVertices[item->oldFirstVertex + vertex] = uint32_t(oldVertices.size());
+                    oldVertices.push_back(item->oldFirstVertex + vertex);
+                }
+
+                // Meshlets reference the vertices with geometry-local indices
+                for (uint32_t index = 0; index < geometry->numMeshlets; ++index)
+                {
+                    const Meshlet& meshlet = buffers.meshletData[geometry->meshletOffset + index];
+                    for (uint32_t vertex = 0; vertex < meshlet.vertexCount; ++vertex)
+                    {
+                        uint32_t& meshletVertex = buffers.meshletVertexData[meshlet.vertexOffset + vertex];
+                        if (!item->duplicateRemap.empty())
+                            meshletVertex = item->duplicateRemap[meshletVertex];
+                        assert(newVertices[item->oldFirstVertex + meshletVertex] != c_InvalidIndex);
+                        meshletVertex = newVertices[item->oldFirstVertex + meshletVertex] - firstVertex;
+                    }
+                }
+
+                geometry->vertexOffsetInMesh = firstVertex - meshFirstVertex;
+                geometry->numVertices = uint32_t(oldVertices.size()) - firstVertex;
+                ++item;
+            }
+
+            mesh->vertexOffset = meshFirstVertex;
+            mesh->totalVertices = uint32_t(oldVertices.size()) - meshFirstVertex;
+        }
+
+        RemapStream(buffers.positionData, oldVertices);
+        RemapStream(buffers.normalData, oldVertices);
+        RemapStream(buffers.tangentData, oldVertices);
+        RemapStream(buffers.texcoord1Data, oldVertices);
+        RemapStream(buffers.texcoord2Data, oldVertices);
+        RemapStream(buffers.jointData, oldVertices);
+        RemapStream(buffers.weightData, oldVertices);
+        RemapStream(buffers.radiusData, oldVertices);
+
+        if (!buffers.morphTargetData.empty())
+        {
+            const size_t numFrames = buffers.morphTargetBufferRange.size();
+            const size_t newNumVertices = oldVertices.size();
+            std::vector<float4> morphTargetData;
+            morphTargetData.reserve(numFrames * newNumVertices);
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                const float4* frameData = buffers.morphTargetData.data() + frame * oldNumVertices;
+                for (uint32_t vertex : oldVertices)
+                    morphTargetData.push_back(frameData[vertex]);
+
+                nvrhi::BufferRange& range = buffers.morphTargetBufferRange[frame];
+                range.byteOffset = frame * newNumVertices * sizeof(float4);
+                range.byteSize = newNumVertices * sizeof(float4);
+            }
+            buffers.morphTargetData.swap(morphTargetData);
+        }
+    }
+
+    return result;
+}
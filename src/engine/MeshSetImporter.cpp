@@ -0,0 +1,579 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshSetImporter.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/core/chunk/chunk.h>
+#include <donut/core/vfs/VFS.h>
+#include <donut/core/log.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+using namespace donut::math;
+using namespace donut::vfs;
+using namespace donut::engine;
+
+namespace
+{
+    constexpr uint32_t c_InvalidId = ~0u;
+    constexpr uint32_t c_MeshletSize = uint32_t(sizeof(Meshlet) / sizeof(uint32_t));
+
+    // Appends 'count' elements of 'src' starting at 'base', or default values if the source stream is missing
+    template<typename T>
+    void AppendStream(std::vector<T>& dst, const std::vector<T>& src, size_t base, size_t count, const T& defaultValue, bool& present)
+    {
+        if (src.size() >= base + count)
+        {
+            dst.insert(dst.end(), src.begin() + ptrdiff_t(base), src.begin() + ptrdiff_t(base + count));
+            present = true;
+        }
+        else
+            dst.resize(dst.size() + count, defaultValue);
+    }
+
+    template<typename T>
+    void CopyStream(std::vector<T>& dst, const T* src, uint32_t count)
+    {
+        if (src)
+            dst.assign(src, src + count);
+    }
+
+    void SetNodeTransform(SceneGraphNode& node, const affine3& transform)
+    {
+        double3 translation;
+        dquat rotation;
+        double3 scaling;
+        decomposeAffine(daffine3(transform), &translation, &rotation, &scaling);
+        node.SetTransform(&translation, &rotation, &scaling);
+    }
+}
+
+MeshSetImporter::MeshSetImporter(std::shared_ptr<vfs::IFileSystem> fs, std::shared_ptr<SceneTypeFactory> sceneTypeFactory)
+    : m_fs(std::move(fs))
+    , m_SceneTypeFactory(std::move(sceneTypeFactory))
+{
+}
+
+bool MeshSetImporter::Load(const std::filesystem::path& fileName, SceneImportResult& result) const
+{
+    const std::string fileNameString = fileName.generic_string();
+
+    const std::shared_ptr<IBlob> blob = m_fs->readFile(fileName);
+    if (!blob)
+    {
+        log::error("Couldn't read file '%s'", fileNameString.c_str());
+        return false;
+    }
+
+    const std::shared_ptr<chunk::MeshSetBase const> meshSet = chunk::deserialize(blob, fileNameString.c_str());
+    if (!meshSet)
+        return false;
+
+    if (!LoadMeshSet(*meshSet, result))
+    {
+        log::error("Invalid mesh set in '%s'", fileNameString.c_str());
+        return false;
+    }
+
+    if (result.rootNode->GetName().empty())
+        result.rootNode->SetName(fileName.filename().generic_string());
+
+    return true;
+}
+
+bool MeshSetImporter::LoadMeshSet(const chunk::MeshSetBase& meshSet, SceneImportResult& result) const
+{
+    result.rootNode.reset();
+
+    if (!meshSet.streams.position)
+        return false;
+
+    const bool isMeshletSet = meshSet.type == chunk::MeshSetBase::MESHLET;
+    if (!isMeshletSet && meshSet.type != chunk::MeshSetBase::MESH)
+        return false;
+
+    auto buffers = std::make_shared<BufferGroup>();
+    CopyStream(buffers->positionData, meshSet.streams.position, meshSet.nverts);
+    CopyStream(buffers->normalData, meshSet.streams.normal, meshSet.nverts);
+    CopyStream(buffers->tangentData, meshSet.streams.tangent, meshSet.nverts);
+    CopyStream(buffers->texcoord1Data, meshSet.streams.texcoord0, meshSet.nverts);
+    CopyStream(buffers->texcoord2Data, meshSet.streams.texcoord1, meshSet.nverts);
+
+    std::unordered_map<uint32_t, std::shared_ptr<Material>> materials;
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+    meshes.reserve(meshSet.nmeshInfos);
+
+    for (uint32_t meshIndex = 0; meshIndex < meshSet.nmeshInfos; ++meshIndex)
+    {
+        const chunk::MeshInfoBase& info = isMeshletSet
+            ? static_cast<const chunk::MeshInfoBase&>(static_cast<const chunk::MeshletSet&>(meshSet).meshInfos[meshIndex])
+            : static_cast<const chunk::MeshInfoBase&>(static_cast<const chunk::MeshSet&>(meshSet).meshInfos[meshIndex]);
+
+        uint32_t firstVertex = 0;
+        uint32_t numVertices = 0;
+        const uint32_t indexOffset = uint32_t(buffers->indexData.size());
+        auto geometry = m_SceneTypeFactory->CreateMeshGeometry();
+
+        if (isMeshletSet)
+        {
+            const auto& set = static_cast<const chunk::MeshletSet&>(meshSet);
+            const auto& meshletInfo = set.meshInfos[meshIndex];
+
+            if (set.meshletSize < c_MeshletSize || uint64_t(meshletInfo.firstMeshlet) + meshletInfo.numMeshlets > set.nmeshlets)
+                return false;
+
+            std::vector<Meshlet> meshlets(meshletInfo.numMeshlets);
+            uint32_t minVertex = ~0u;
+            uint32_t maxVertex = 0;
+            for (uint32_t index = 0; index < meshletInfo.numMeshlets; ++index)
+            {
+                Meshlet& meshlet = meshlets[index];
+                memcpy(&meshlet, set.meshlets + size_t(meshletInfo.firstMeshlet + index) * set.meshletSize, sizeof(Meshlet));
+
+                if (uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > set.nindices32
+                    || (uint64_t(meshlet.primitiveOffset) + meshlet.primitiveCount) * 3 > set.nindices8)
+                    return false;
+
+                for (uint32_t vertex = 0; vertex < meshlet.vertexCount; ++vertex)
+                {
+                    const uint32_t vertexIndex = set.indices32[meshlet.vertexOffset + vertex];
+                    minVertex = std::min(minVertex, vertexIndex);
+                    maxVertex = std::max(maxVertex, vertexIndex);
+                }
+            }
+
+            if (minVertex <= maxVertex)
+            {
+                firstVertex = minVertex;
+                numVertices = maxVertex - minVertex + 1;
+            }
+
+            if (uint64_t(firstVertex) + numVertices > meshSet.nverts)
+                return false;
+
+            // Rebuild the index buffer, and store the meshlets with geometry-local vertex indices
+            geometry->meshletOffset = uint32_t(buffers->meshletData.size());
+            geometry->numMeshlets = uint32_t(meshlets.size());
+            for (Meshlet meshlet : meshlets)
+            {
+                const uint32_t* vertices = set.indices32 + meshlet.vertexOffset;
+                const uint8_t* primitives = set.indices8 + size_t(meshlet.primitiveOffset) * 3;
+
+                for (uint32_t index = 0; index < meshlet.primitiveCount * 3; ++index)
+                {
+                    if (primitives[index] >= meshlet.vertexCount)
+                        return false;
+                    buffers->indexData.push_back(vertices[primitives[index]] - firstVertex);
+                }
+
+                meshlet.vertexOffset = uint32_t(buffers->meshletVertexData.size());
+                meshlet.primitiveOffset = uint32_t(buffers->meshletPrimitiveData.size() / 3);
+                for (uint32_t vertex = 0; vertex < meshlet.vertexCount; ++vertex)
+                    buffers->meshletVertexData.push_back(vertices[vertex] - firstVertex);
+                buffers->meshletPrimitiveData.insert(buffers->meshletPrimitiveData.end(),
+                    primitives, primitives + size_t(meshlet.primitiveCount) * 3);
+                buffers->meshletData.push_back(meshlet);
+            }
+        }
+        else
+        {
+            const auto& set = static_cast<const chunk::MeshSet&>(meshSet);
+            const auto& meshInfo = set.meshInfos[meshIndex];
+
+            if (uint64_t(meshInfo.firstVertex) + meshInfo.numVertices > meshSet.nverts
+                || uint64_t(meshInfo.firstIndex) + meshInfo.numIndices > set.nindices)
+                return false;
+
+            firstVertex = meshInfo.firstVertex;
+            numVertices = meshInfo.numVertices;
+            buffers->indexData.insert(buffers->indexData.end(),
+                set.indices + meshInfo.firstIndex, set.indices + meshInfo.firstIndex + meshInfo.numIndices);
+        }
+
+        std::shared_ptr<Material>& material = materials[info.materialId];
+        if (!material)
+        {
+            material = m_SceneTypeFactory->CreateMaterial();
+            material->name = info.materialName ? info.materialName : "";
+            material->materialIndexInModel = int(info.materialId);
+        }
+
+        geometry->material = material;
+        geometry->numIndices = uint32_t(buffers->indexData.size()) - indexOffset;
+        geometry->numVertices = numVertices;
+        geometry->objectSpaceBounds = info.bbox;
+
+        auto mesh = m_SceneTypeFactory->CreateMesh();
+        mesh->name = info.name ? info.name : "";
+        mesh->buffers = buffers;
+        mesh->indexOffset = indexOffset;
+        mesh->vertexOffset = firstVertex;
+        mesh->totalIndices = geometry->numIndices;
+        mesh->totalVertices = numVertices;
+        mesh->objectSpaceBounds = info.bbox;
+        mesh->geometries.push_back(geometry);
+        meshes.push_back(mesh);
+    }
+
+    // Build the node hierarchy from the root down, so that every parent is attached before its children
+    auto graph = std::make_shared<SceneGraph>();
+    std::vector<std::shared_ptr<SceneGraphNode>> nodes(meshSet.nnodes);
+    std::shared_ptr<SceneGraphNode> root;
+
+    if (meshSet.nnodes > 0)
+    {
+        std::vector<std::vector<uint32_t>> children(meshSet.nnodes);
+        for (uint32_t index = 0; index < meshSet.nnodes; ++index)
+        {
+            const chunk::MeshNode& src = meshSet.nodes[index];
+            nodes[index] = std::make_shared<SceneGraphNode>();
+            nodes[index]->SetName(src.name ? src.name : "");
+            if (src.transform != affine3::identity())
+                SetNodeTransform(*nodes[index], src.transform);
+
+            if (index != meshSet.rootId && src.parentId < meshSet.nnodes && src.parentId != index)
+                children[src.parentId].push_back(index);
+        }
+
+        const uint32_t rootId = meshSet.rootId < meshSet.nnodes ? meshSet.rootId : 0;
+        root = nodes[rootId];
+
+        std::vector<bool> attached(meshSet.nnodes, false);
+        std::vector<uint32_t> stack = { rootId };
+        attached[rootId] = true;
+        while (!stack.empty())
+        {
+            const uint32_t parent = stack.back();
+            stack.pop_back();
+            for (uint32_t child : children[parent])
+            {
+                if (attached[child])
+                    continue;
+                attached[child] = true;
+                graph->Attach(nodes[parent], nodes[child]);
+                stack.push_back(child);
+            }
+        }
+    }
+    else
+    {
+        root = std::make_shared<SceneGraphNode>();
+        root->SetName(meshSet.name ? meshSet.name : "");
+    }
+
+    for (uint32_t index = 0; index < meshSet.ninstances; ++index)
+    {
+        const chunk::MeshInstance& src = meshSet.instances[index];
+        if (src.minfoId >= meshes.size())
+            return false;
+
+        auto leaf = m_SceneTypeFactory->CreateMeshInstance(meshes[src.minfoId]);
+
+        if (src.nodeId < meshSet.nnodes)
+        {
+            const std::shared_ptr<SceneGraphNode>& node = nodes[src.nodeId];
+            if (!node->GetLeaf())
+            {
+                node->SetLeaf(leaf);
+                continue;
+            }
+
+            // Additional instances on the same node get their own child nodes
+            auto child = std::make_shared<SceneGraphNode>();
+            child->SetName(src.name ? src.name : "");
+            child->SetLeaf(leaf);
+            graph->Attach(node, child);
+        }
+        else
+        {
+            // Without a node, the instance transform is relative to the root
+            auto child = std::make_shared<SceneGraphNode>();
+            child->SetName(src.name ? src.name : "");
+            if (src.transform != affine3::identity())
+                SetNodeTransform(*child, src.transform);
+            child->SetLeaf(leaf);
+            graph->Attach(root, child);
+        }
+    }
+
+    result.rootNode = root;
+    return true;
+}
+
+std::shared_ptr<IBlob const> MeshSetImporter::Serialize(const SceneImportResult& result)
+{
+    if (!result.rootNode)
+        return nullptr;
+
+    // Flatten the node hierarchy in depth-first order, so that parents come before their children
+    std::vector<SceneGraphNode*> nodes;
+    std::unordered_map<const SceneGraphNode*, uint32_t> nodeIndices;
+    {
+        std::vector<SceneGraphNode*> stack = { result.rootNode.get() };
+        while (!stack.empty())
+        {
+            SceneGraphNode* node = stack.back();
+            stack.pop_back();
+
+            nodeIndices[node] = uint32_t(nodes.size());
+            nodes.push_back(node);
+
+            for (size_t child = node->GetNumChildren(); child > 0; --child)
+                stack.push_back(node->GetChild(child - 1));
+        }
+    }
+
+    std::vector<chunk::MeshNode> meshNodes(nodes.size());
+    std::vector<chunk::MeshInstance> meshInstances;
+    std::vector<chunk::MeshInfo> meshInfos;
+    std::vector<chunk::MeshletInfo> meshletInfos;
+    std::unordered_map<const MeshInfo*, std::pair<uint32_t, uint32_t>> meshInfoRanges; // first info, count
+    std::unordered_map<const Material*, uint32_t> materialIds;
+
+    std::vector<float3> positions;
+    std::vector<uint32_t> normals;
+    std::vector<uint32_t> tangents;
+    std::vector<float2> texcoords0;
+    std::vector<float2> texcoords1;
+    bool hasNormals = false;
+    bool hasTangents = false;
+    bool hasTexcoords0 = false;
+    bool hasTexcoords1 = false;
+
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> indices32;
+    std::vector<uint8_t> indices8;
+    std::vector<Meshlet> meshlets;
+    uint32_t maxMeshletVertices = 0;
+    uint32_t maxMeshletPrimitives = 0;
+    bool allGeometriesHaveMeshlets = true;
+
+    auto addMesh = [&](const MeshInfo& mesh)
+    {
+        auto found = meshInfoRanges.find(&mesh);
+        if (found != meshInfoRanges.end())
+            return found->second;
+
+        const uint32_t firstInfo = uint32_t(meshInfos.size());
+        const BufferGroup* buffers = mesh.buffers.get();
+
+        for (const auto& geometry : mesh.geometries)
+        {
+            const size_t vertexBase = size_t(mesh.vertexOffset) + geometry->vertexOffsetInMesh;
+            const size_t indexBase = size_t(mesh.indexOffset) + geometry->indexOffsetInMesh;
+            if (!buffers || geometry->type != MeshGeometryPrimitiveType::Triangles
+                || vertexBase + geometry->numVertices > buffers->positionData.size()
+                || indexBase + geometry->numIndices > buffers->indexData.size())
+                continue;
+
+            chunk::MeshInfo info{};
+            info.name = mesh.name.c_str();
+            info.bbox = geometry->objectSpaceBounds;
+            info.firstVertex = uint32_t(positions.size());
+            info.numVertices = geometry->numVertices;
+            info.firstIndex = uint32_t(indices.size());
+            info.numIndices = geometry->numIndices;
+
+            if (const Material* material = geometry->material.get())
+            {
+                info.materialName = material->name.c_str();
+                info.materialId = materialIds.emplace(material, uint32_t(materialIds.size())).first->second;
+            }
+            else
+                info.materialId = c_InvalidId;
+
+            positions.insert(positions.end(), buffers->positionData.begin() + ptrdiff_t(vertexBase),
+                buffers->positionData.begin() + ptrdiff_t(vertexBase + geometry->numVertices));
+            AppendStream(normals, buffers->normalData, vertexBase, geometry->numVertices, 0u, hasNormals);
+            AppendStream(tangents, buffers->tangentData, vertexBase, geometry->numVertices, 0u, hasTangents);
+            AppendStream(texcoords0, buffers->texcoord1Data, vertexBase, geometry->numVertices, float2(0.f), hasTexcoords0);
+            AppendStream(texcoords1, buffers->texcoord2Data, vertexBase, geometry->numVertices, float2(0.f), hasTexcoords1);
+            indices.insert(indices.end(), buffers->indexData.begin() + ptrdiff_t(indexBase),
+                buffers->indexData.begin() + ptrdiff_t(indexBase + geometry->numIndices));
+
+            chunk::MeshletInfo meshletInfo{};
+            static_cast<chunk::MeshInfoBase&>(meshletInfo) = info;
+            meshletInfo.firstMeshlet = uint32_t(meshlets.size());
+
+            if (geometry->numMeshlets == 0 || size_t(geometry->meshletOffset) + geometry->numMeshlets > buffers->meshletData.size())
+                allGeometriesHaveMeshlets = false;
+            else if (allGeometriesHaveMeshlets)
+            {
+                for (uint32_t index = 0; index < geometry->numMeshlets; ++index)
+                {
+                    Meshlet meshlet = buffers->meshletData[geometry->meshletOffset + index];
+                    const uint32_t* vertices = buffers->meshletVertexData.data() + meshlet.vertexOffset;
+                    const uint8_t* primitives = buffers->meshletPrimitiveData.data() + size_t(meshlet.primitiveOffset) * 3;
+
+                    meshlet.vertexOffset = uint32_t(indices32.size());
+                    meshlet.primitiveOffset = uint32_t(indices8.size() / 3);
+                    for (uint32_t vertex = 0; vertex < meshlet.vertexCount; ++vertex)
+                        indices32.push_back(vertices[vertex] + info.firstVertex);
+                    indices8.insert(indices8.end(), primitives, primitives + size_t(meshlet.primitiveCount) * 3);
+                    meshlets.push_back(meshlet);
+
+                    maxMeshletVertices = std::max(maxMeshletVertices, meshlet.vertexCount);
+                    maxMeshletPrimitives = std::max(maxMeshletPrimitives, meshlet.primitiveCount);
+                }
+                meshletInfo.numMeshlets = geometry->numMeshlets;
+            }
+
+            meshInfos.push_back(info);
+            meshletInfos.push_back(meshletInfo);
+        }
+
+        const auto range = std::make_pair(firstInfo, uint32_t(meshInfos.size()) - firstInfo);
+        meshInfoRanges[&mesh] = range;
+        return range;
+    };
+
+    box3 sceneBounds = box3::empty();
+
+    for (chunk::MeshNode& node : meshNodes)
+    {
+        node.parentId = c_InvalidId;
+        node.siblingId = c_InvalidId;
+        node.instanceId = c_InvalidId;
+        node.bbox = box3::empty();
+    }
+
+    for (uint32_t nodeIndex = 0; nodeIndex < uint32_t(nodes.size()); ++nodeIndex)
+    {
+        const SceneGraphNode* node = nodes[nodeIndex];
+        chunk::MeshNode& dst = meshNodes[nodeIndex];
+
+        daffine3 localTransform = scaling(node->GetScaling());
+        localTransform *= node->GetRotation().toAffine();
+        localTransform *= translation(node->GetTranslation());
+
+        dst.name = node->GetName().c_str();
+        dst.transform = affine3(localTransform);
+        dst.ctm = dst.transform;
+
+        if (const SceneGraphNode* parent = node->GetParent(); parent && nodeIndex > 0)
+        {
+            dst.parentId = nodeIndices[parent];
+            dst.ctm = dst.transform * meshNodes[dst.parentId].ctm;
+        }
+
+        for (size_t child = 0; child + 1 < node->GetNumChildren(); ++child)
+            meshNodes[nodeIndices[node->GetChild(child)]].siblingId = nodeIndices[node->GetChild(child + 1)];
+
+        const auto* meshInstance = dynamic_cast<const MeshInstance*>(node->GetLeaf().get());
+        if (!meshInstance || dynamic_cast<const SkinnedMeshInstance*>(meshInstance))
+            continue;
+
+        const MeshInfo* mesh = meshInstance->GetMesh().get();
+        if (!mesh || mesh->IsCurve())
+            continue;
+
+        const auto [firstInfo, numInfos] = addMesh(*mesh);
+        for (uint32_t info = firstInfo; info < firstInfo + numInfos; ++info)
+        {
+            chunk::MeshInstance instance{};
+            instance.name = dst.name;
+            instance.minfoId = info;
+            instance.nodeId = nodeIndex;
+            instance.transform = dst.ctm;
+            instance.bbox = meshInfos[info].bbox * dst.ctm;
+            instance.center = instance.bbox.center();
+
+            if (dst.instanceId == c_InvalidId)
+                dst.instanceId = uint32_t(meshInstances.size());
+            meshInstances.push_back(instance);
+
+            // Node bounds cover their whole subtree
+            for (uint32_t parent = nodeIndex; parent != c_InvalidId; parent = meshNodes[parent].parentId)
+                meshNodes[parent].bbox |= instance.bbox;
+            sceneBounds |= instance.bbox;
+        }
+    }
+
+    if (meshInstances.empty())
+    {
+        log::warning("The model has no mesh instances to serialize");
+        return nullptr;
+    }
+
+    for (chunk::MeshNode& node : meshNodes)
+        node.center = node.bbox.isempty() ? node.ctm.m_translation : node.bbox.center();
+
+    chunk::MeshSet meshSet;
+    chunk::MeshletSet meshletSet;
+    const bool useMeshlets = allGeometriesHaveMeshlets && !meshlets.empty();
+    chunk::MeshSetBase& base = useMeshlets ? static_cast<chunk::MeshSetBase&>(meshletSet) : static_cast<chunk::MeshSetBase&>(meshSet);
+
+    if (useMeshlets)
+    {
+        meshletSet.type = chunk::MeshSetBase::MESHLET;
+        meshletSet.maxVerts = maxMeshletVertices;
+        meshletSet.maxPrims = maxMeshletPrimitives;
+        meshletSet.indices32 = indices32.data();
+        meshletSet.nindices32 = uint32_t(indices32.size());
+        meshletSet.indices8 = indices8.data();
+        meshletSet.nindices8 = uint32_t(indices8.size());
+        meshletSet.meshlets = reinterpret_cast<const uint32_t*>(meshlets.data());
+        meshletSet.nmeshlets = uint32_t(meshlets.size());
+        meshletSet.meshletSize = uint8_t(c_MeshletSize);
+        meshletSet.meshInfos = meshletInfos.data();
+    }
+    else
+    {
+        meshSet.type = chunk::MeshSetBase::MESH;
+        meshSet.indices = indices.data();
+        meshSet.nindices = uint32_t(indices.size());
+        meshSet.meshInfos = meshInfos.data();
+    }
+
+    base.name = result.rootNode->GetName().c_str();
+    base.streams.position = positions.data();
+    base.streams.normal = hasNormals ? normals.data() : nullptr;
+    base.streams.tangent = hasTangents ? tangents.data() : nullptr;
+    base.streams.texcoord0 = hasTexcoords0 ? texcoords0.data() : nullptr;
+    base.streams.texcoord1 = hasTexcoords1 ? texcoords1.data() : nullptr;
+    base.nverts = uint32_t(positions.size());
+    base.nmeshInfos = uint32_t(meshInfos.size());
+    base.instances = meshInstances.data();
+    base.ninstances = uint32_t(meshInstances.size());
+    base.nodes = meshNodes.data();
+    base.nnodes = uint32_t(meshNodes.size());
+    base.rootId = 0;
+    base.bbox = sceneBounds;
+
+    return chunk::serialize(base);
+}
+
+bool MeshSetImporter::Store(const std::filesystem::path& fileName, const SceneImportResult& result) const
+{
+    const std::shared_ptr<IBlob const> blob = Serialize(result);
+    if (!blob)
+        return false;
+
+    if (!m_fs->writeFile(fileName, blob->data(), blob->size()))
+    {
+        log::error("Couldn't write file '%s'", fileName.generic_string().c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,525 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshSimplifier.h>
+#include <donut/engine/ThreadPool.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace donut::math;
+using namespace donut::engine;
+
+namespace
+{
+    // Collapses that rotate a triangle by more than ~75 degrees are considered flips
+    constexpr float c_MinNormalCosine = 0.25f;
+
+    // Sum of squared distances to a set of planes, weighted by the areas of the triangles that define them:
+    // Q(p) = p^T A p + 2 b^T p + c
+    struct Quadric
+    {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0;
+        double c = 0;
+        double weight = 0;
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+    };
+
+    Quadric MakePlaneQuadric(const float3& p0, const float3& p1, const float3& p2)
+    {
+        const float3 normal = cross(p1 - p0, p2 - p0);
+        const double length = double(dm::length(normal));
+        Quadric q;
+        if (length <= 0.0)
+            return q;
+
+        const double nx = double(normal.x) / length;
+        const double ny = double(normal.y) / length;
+        const double nz = double(normal.z) / length;
+        const double d = -(nx * double(p0.x) + ny * double(p0.y) + nz * double(p0.z));
+        const double w = length * 0.5;
+
+        q.a00 = w * nx * nx; q.a01 = w * nx * ny; q.a02 = w * nx * nz;
+        q.a11 = w * ny * ny; q.a12 = w * ny * nz; q.a22 = w * nz * nz;
+        q.b0 = w * nx * d; q.b1 = w * ny * d; q.b2 = w * nz * d;
+        q.c = w * d * d;
+        q.weight = w;
+        return q;
+    }
+
+    // Returns the area weighted RMS distance of the point to the planes of the quadric
+    float EvaluateQuadric(const Quadric& q, const float3& point)
+    {
+        if (q.weight <= 0.0)
+            return 0.f;
+
+        const double x = point.x, y = point.y, z = point.z;
+        const double value =
+            q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+            2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+            2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) +
+            q.c;
+
+        return float(std::sqrt(std::max(value, 0.0) / q.weight));
+    }
+
+    struct PositionHash
+    {
+        size_t operator()(const float3& p) const
+        {
+            uint32_t bits[3];
+            memcpy(bits, &p, sizeof(bits));
+            return size_t(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+        }
+    };
+
+    struct PositionEqual
+    {
+        bool operator()(const float3& a, const float3& b) const
+        {
+            return memcmp(&a, &b, sizeof(float3)) == 0;
+        }
+    };
+
+    // Marks the vertices that must not be moved: vertices on open or non-manifold edges,
+    // and vertices that share their position with other vertices, which are on attribute seams.
+    std::vector<bool> FindLockedVertices(const uint32_t* indices, size_t numIndices, const float3* positions, size_t numVertices)
+    {
+        std::vector<bool> locked(numVertices, false);
+
+        std::unordered_map<float3, uint32_t, PositionHash, PositionEqual> firstVertexAtPosition;
+        firstVertexAtPosition.reserve(numVertices);
+        std::vector<bool> referenced(numVertices, false);
+        for (size_t index = 0; index < numIndices; ++index)
+            referenced[indices[index]] = true;
+
+        for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+        {
+            if (!referenced[vertex])
+                continue;
+
+            auto [it, inserted] = firstVertexAtPosition.emplace(positions[vertex], vertex);
+            if (!inserted)
+            {
+                locked[vertex] = true;
+                locked[it->second] = true;
+            }
+        }
+
+        // Every interior edge of a consistently oriented manifold is used once in each direction
+        std::unordered_map<uint64_t, uint32_t> directedEdges;
+        directedEdges.reserve(numIndices);
+        for (size_t triangle = 0; triangle < numIndices / 3; ++triangle)
+        {
+            for (int edge = 0; edge < 3; ++edge)
+            {
+                const uint64_t a = indices[triangle * 3 + edge];
+                const uint64_t b = indices[triangle * 3 + (edge + 1) % 3];
+                ++directedEdges[(a << 32) | b];
+            }
+        }
+
+        for (const auto& [key, count] : directedEdges)
+        {
+            const uint32_t a = uint32_t(key >> 32);
+            const uint32_t b = uint32_t(key);
+            const auto reverse = directedEdges.find((uint64_t(b) << 32) | a);
+            if (count != 1 || reverse == directedEdges.end() || reverse->second != 1)
+            {
+                locked[a] = true;
+                locked[b] = true;
+            }
+        }
+
+        return locked;
+    }
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        float error;
+    };
+}
+
+size_t donut::engine::SimplifyMesh(
+    uint32_t* destination,
+    const uint32_t* indices,
+    size_t numIndices,
+    const float3* positions,
+    size_t numVertices,
+    size_t targetIndexCount,
+    float targetError,
+    float* resultError)
+{
+    assert(numIndices % 3 == 0);
+
+    std::vector<uint32_t> triangles(indices, indices + numIndices);
+    const std::vector<bool> locked = FindLockedVertices(indices, numIndices, positions, numVertices);
+
+    std::vector<Quadric> quadrics(numVertices);
+    for (size_t triangle = 0; triangle < numIndices / 3; ++triangle)
+    {
+        const uint32_t* t = &triangles[triangle * 3];
+        const Quadric q = MakePlaneQuadric(positions[t[0]], positions[t[1]], positions[t[2]]);
+        quadrics[t[0]] += q;
+        quadrics[t[1]] += q;
+        quadrics[t[2]] += q;
+    }
+
+    std::vector<uint32_t> remap(numVertices);
+    std::vector<bool> touched(numVertices);
+    std::vector<uint32_t> adjacencyOffsets(numVertices + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    float maxError = 0.f;
+
+    while (triangles.size() > targetIndexCount)
+    {
+        const size_t numTriangles = triangles.size() / 3;
+
+        // Triangles around every vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t vertex : triangles)
+            ++adjacencyOffsets[vertex + 1];
+        for (size_t vertex = 0; vertex < numVertices; ++vertex)
+            adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+        adjacency.resize(triangles.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t index = 0; index < triangles.size(); ++index)
+                adjacency[fill[triangles[index]]++] = uint32_t(index / 3);
+        }
+
+        // Every edge once, collapsed in the cheaper direction that moves an unlocked vertex
+        collapses.clear();
+        for (size_t index = 0; index < triangles.size(); ++index)
+        {
+            const uint32_t a = triangles[index];
+            const uint32_t b = triangles[index - index % 3 + (index + 1) % 3];
+            if (a > b && !locked[a] && !locked[b])
+                continue; // the interior edge is also found in the other direction
+
+            Quadric q = quadrics[a];
+            q += quadrics[b];
+
+            Collapse best = { 0, 0, INFINITY };
+            if (!locked[a])
+                best = { a, b, EvaluateQuadric(q, positions[b]) };
+            if (!locked[b])
+            {
+                const float error = EvaluateQuadric(q, positions[a]);
+                if (error < best.error)
+                    best = { b, a, error };
+            }
+
+            if (best.error <= targetError)
+                collapses.push_back(best);
+        }
+
+        if (collapses.empty())
+            break;
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y)
+        {
+            if (x.error != y.error)
+                return x.error < y.error;
+            return x.from != y.from ? x.from < y.from : x.to < y.to;
+        });
+
+        for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+            remap[vertex] = vertex;
+        std::fill(touched.begin(), touched.end(), false);
+
+        // Each collapse typically removes 2 triangles, only do as many as needed to reach the target
+        const size_t trianglesToRemove = numTriangles - targetIndexCount / 3;
+        size_t removedTriangles = 0;
+        bool collapsed = false;
+
+        for (const Collapse& collapse : collapses)
+        {
+            if (removedTriangles >= trianglesToRemove)
+                break;
+
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            // Reject the collapse if it flips or folds any of the remaining triangles around the vertex
+            bool flips = false;
+            size_t removed = 0;
+            for (uint32_t adjacent = adjacencyOffsets[collapse.from]; adjacent < adjacencyOffsets[collapse.from + 1]; ++adjacent)
+            {
+                const uint32_t* t = &triangles[adjacency[adjacent] * 3];
+                if (t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to)
+                {
+                    ++removed;
+                    continue;
+                }
+
+                float3 before[3], after[3];
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    before[corner] = positions[t[corner]];
+                    after[corner] = positions[t[corner] == collapse.from ? collapse.to : t[corner]];
+                }
+
+                const float3 normalBefore = cross(before[1] - before[0], before[2] - before[0]);
+                const float3 normalAfter = cross(after[1] - after[0], after[2] - after[0]);
+                if (dot(normalBefore, normalAfter) <= c_MinNormalCosine * length(normalBefore) * length(normalAfter))
+                {
+                    flips = true;
+                    break;
+                }
+            }
+
+            if (flips)
+                continue;
+
+            // The triangles around the vertex change, don't collapse any of their other edges in this pass
+            for (uint32_t adjacent = adjacencyOffsets[collapse.from]; adjacent < adjacencyOffsets[collapse.from + 1]; ++adjacent)
+            {
+                const uint32_t* t = &triangles[adjacency[adjacent] * 3];
+                touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+            }
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            maxError = std::max(maxError, collapse.error);
+            removedTriangles += removed;
+            collapsed = true;
+        }
+
+        if (!collapsed)
+            break;
+
+        size_t writeIndex = 0;
+        for (size_t triangle = 0; triangle < numTriangles; ++triangle)
+        {
+            const uint32_t a = remap[triangles[triangle * 3 + 0]];
+            const uint32_t b = remap[triangles[triangle * 3 + 1]];
+            const uint32_t c = remap[triangles[triangle * 3 + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+
+            triangles[writeIndex++] = a;
+            triangles[writeIndex++] = b;
+            triangles[writeIndex++] = c;
+        }
+        triangles.resize(writeIndex);
+    }
+
+    if (!triangles.empty())
+        memcpy(destination, triangles.data(), triangles.size() * sizeof(uint32_t));
+
+    if (resultError)
+        *resultError = maxError;
+
+    return triangles.size();
+}
+
+MeshLodStatistics donut::engine::GenerateMeshLods(
+    const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+    const MeshLodParams& params,
+    ThreadPool* threadPool)
+{
+    struct LevelItem
+    {
+        std::vector<std::vector<uint32_t>> geometryIndices;
+        float error = 0.f;
+        uint32_t numTriangles = 0;
+    };
+
+    struct MeshItem
+    {
+        MeshInfo* mesh = nullptr;
+        uint32_t baseTriangles = 0;
+        std::vector<LevelItem> levels;
+    };
+
+    std::vector<MeshItem> items;
+    std::unordered_set<const MeshInfo*> visitedMeshes;
+    for (const auto& mesh : meshes)
+    {
+        if (!mesh || !visitedMeshes.insert(mesh.get()).second)
+            continue;
+
+        const BufferGroup* buffers = mesh->buffers.get();
+        if (!buffers || mesh->skinPrototype || mesh->type != MeshType::Triangles || !mesh->lods.empty()
+            || buffers->positionData.empty() || buffers->indexData.empty())
+            continue;
+
+        MeshItem item;
+        item.mesh = mesh.get();
+        items.push_back(item);
+    }
+
+    const auto simplify = [&params](MeshItem& item)
+    {
+        const MeshInfo& mesh = *item.mesh;
+        const BufferGroup& buffers = *mesh.buffers;
+        const float errorLimit = params.maxError * length(mesh.objectSpaceBounds.diagonal());
+
+        for (const auto& geometry : mesh.geometries)
+        {
+            if (geometry->type == MeshGeometryPrimitiveType::Triangles)
+                item.baseTriangles += geometry->numIndices / 3;
+        }
+
+        uint32_t previousTriangles = item.baseTriangles;
+        float targetRatio = 1.f;
+
+        for (uint32_t level = 1; level < params.numLods && previousTriangles > 0; ++level)
+        {
+            // Every level is simplified from the full detail mesh, so that its error is measured against it
+            targetRatio *= params.reductionRatio;
+
+            LevelItem levelItem;
+            for (const auto& geometry : mesh.geometries)
+            {
+                std::vector<uint32_t> indices;
+                const size_t firstIndex = mesh.indexOffset + geometry->indexOffsetInMesh;
+                const size_t firstVertex = mesh.vertexOffset + geometry->vertexOffsetInMesh;
+                const bool valid = firstIndex + geometry->numIndices <= buffers.indexData.size()
+                    && firstVertex + geometry->numVertices <= buffers.positionData.size();
+
+                if (geometry->type == MeshGeometryPrimitiveType::Triangles && valid)
+                {
+                    indices.resize(geometry->numIndices);
+                    const size_t targetIndexCount = size_t(float(geometry->numIndices / 3) * targetRatio) * 3;
+                    float error = 0.f;
+                    indices.resize(SimplifyMesh(indices.data(), buffers.indexData.data() + firstIndex, geometry->numIndices,
+                        buffers.positionData.data() + firstVertex, geometry->numVertices, targetIndexCount, errorLimit, &error));
+                    levelItem.error = std::max(levelItem.error, error);
+                    levelItem.numTriangles += uint32_t(indices.size() / 3);
+                }
+                else if (valid)
+                {
+                    // Other primitives are kept as they are
+                    indices.assign(buffers.indexData.begin() + firstIndex, buffers.indexData.begin() + firstIndex + geometry->numIndices);
+                }
+
+                levelItem.geometryIndices.push_back(std::move(indices));
+            }
+
+            if (float(levelItem.numTriangles) > float(previousTriangles) * (1.f - params.minReduction))
+                break;
+
+            previousTriangles = levelItem.numTriangles;
+            item.levels.push_back(std::move(levelItem));
+        }
+    };
+
+    if (threadPool && items.size() > 1)
+    {
+        ThreadPoolTaskGroup taskGroup;
+        for (MeshItem& item : items)
+        {
+            MeshItem* itemPtr = &item;
+            threadPool->AddTask(taskGroup, [&simplify, itemPtr]() { simplify(*itemPtr); });
+        }
+        threadPool->Wait(taskGroup);
+    }
+    else
+    {
+        for (MeshItem& item : items)
+            simplify(item);
+    }
+
+    // Append the indices of the levels to the buffer groups in a deterministic order
+    MeshLodStatistics stats;
+    for (MeshItem& item : items)
+    {
+        if (item.levels.empty())
+            continue;
+
+        MeshInfo& mesh = *item.mesh;
+        std::vector<uint32_t>& indexData = mesh.buffers->indexData;
+
+        for (LevelItem& levelItem : item.levels)
+        {
+            MeshLod lod;
+            lod.error = levelItem.error;
+            lod.numTriangles = levelItem.numTriangles;
+
+            for (size_t geometryIndex = 0; geometryIndex < mesh.geometries.size(); ++geometryIndex)
+            {
+                const std::vector<uint32_t>& indices = levelItem.geometryIndices[geometryIndex];
+
+                auto geometry = std::make_shared<MeshGeometry>(*mesh.geometries[geometryIndex]);
+                geometry->indexOffsetInMesh = uint32_t(indexData.size() - mesh.indexOffset);
+                geometry->numIndices = uint32_t(indices.size());
+                geometry->meshletOffset = 0;
+                geometry->numMeshlets = 0;
+                indexData.insert(indexData.end(), indices.begin(), indices.end());
+
+                lod.geometries.push_back(std::move(geometry));
+            }
+
+            stats.lodTriangles += lod.numTriangles;
+            ++stats.lods;
+            mesh.lods.push_back(std::move(lod));
+        }
+
+        ++stats.meshes;
+        stats.baseTriangles += item.baseTriangles;
+    }
+
+    return stats;
+}
+
+uint32_t donut::engine::SelectMeshLod(
+    const MeshInfo& mesh,
+    float pixelsPerUnit,
+    float maxScreenError,
+    float hysteresis,
+    uint32_t currentLod)
+{
+    const uint32_t numLevels = uint32_t(mesh.lods.size()) + 1;
+    uint32_t lod = std::min(currentLod, numLevels - 1);
+
+    const auto screenError = [&mesh, pixelsPerUnit](uint32_t level)
+    {
+        return level == 0 ? 0.f : mesh.lods[level - 1].error * pixelsPerUnit;
+    };
+
+    while (lod > 0 && screenError(lod) > maxScreenError)
+        --lod;
+
+    const float coarsenThreshold = maxScreenError * (1.f - hysteresis);
+    while (lod + 1 < numLevels && screenError(lod + 1) <= coarsenThreshold)
+        ++lod;
+
+    return lod;
+}
@@ -0,0 +1,394 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshletBuilder.h>
+#include <donut/engine/ThreadPool.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace donut::math;
+using namespace donut::engine;
+
+namespace
+{
+    constexpr uint32_t c_InvalidIndex = ~0u;
+
+    // Inserts two zero bits between each of the lower 10 bits of v.
+    uint32_t SpreadBits10(uint32_t v)
+    {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    float3 GetTriangleCenter(const uint32_t* indices, const float3* positions, uint32_t triangle)
+    {
+        return (positions[indices[triangle * 3 + 0]] +
+                positions[indices[triangle * 3 + 1]] +
+                positions[indices[triangle * 3 + 2]]) * (1.f / 3.f);
+    }
+}
+
+uint32_t donut::engine::BuildMeshlets(
+    const uint32_t* indices,
+    size_t numIndices,
+    const float3* positions,
+    size_t numVertices,
+    const MeshletBuildParams& params,
+    std::vector<Meshlet>& meshlets,
+    std::vector<uint32_t>& meshletVertices,
+    std::vector<uint8_t>& meshletPrimitives)
+{
+    const uint32_t maxVertices = clamp(params.maxVertices, 3u, 256u);
+    const uint32_t maxPrimitives = std::max(params.maxPrimitives, 1u);
+    const uint32_t numTriangles = uint32_t(numIndices / 3);
+
+    if (numTriangles == 0)
+        return 0;
+
+    // Vertex to triangle adjacency, and the number of triangles of each vertex that are not in a meshlet yet.
+    // Preferring the triangles whose vertices have few remaining triangles avoids leaving isolated triangles behind.
+    std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+    for (uint32_t index = 0; index < numTriangles * 3; index++)
+    {
+        assert(indices[index] < numVertices);
+        ++adjacencyOffsets[indices[index] + 1];
+    }
+
+    std::vector<uint32_t> liveCounts(numVertices);
+    for (size_t vertex = 0; vertex < numVertices; vertex++)
+    {
+        liveCounts[vertex] = adjacencyOffsets[vertex + 1];
+        adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+    }
+
+    std::vector<uint32_t> adjacency(numTriangles * 3);
+    {
+        std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t index = 0; index < numTriangles * 3; index++)
+            adjacency[cursors[indices[index]]++] = index / 3;
+    }
+
+    // Seed triangles are taken in Morton order of their centers
+    box3 bounds = box3::empty();
+    for (size_t vertex = 0; vertex < numVertices; vertex++)
+        bounds |= positions[vertex];
+
+    const float3 boundsScale = 1023.f / max(bounds.diagonal(), float3(1e-20f));
+    std::vector<uint64_t> seedKeys(numTriangles);
+    for (uint32_t triangle = 0; triangle < numTriangles; triangle++)
+    {
+        const float3 cell = clamp((GetTriangleCenter(indices, positions, triangle) - bounds.m_mins) * boundsScale, float3(0.f), float3(1023.f));
+        const uint32_t morton = SpreadBits10(uint32_t(cell.x)) | (SpreadBits10(uint32_t(cell.y)) << 1) | (SpreadBits10(uint32_t(cell.z)) << 2);
+        seedKeys[triangle] = (uint64_t(morton) << 32) | triangle;
+    }
+    std::sort(seedKeys.begin(), seedKeys.end());
+
+    std::vector<uint8_t> emitted(numTriangles, 0);
+    std::vector<uint32_t> localIndices(numVertices, c_InvalidIndex);
+
+    const size_t firstMeshlet = meshlets.size();
+    Meshlet current;
+    current.vertexOffset = uint32_t(meshletVertices.size());
+    current.primitiveOffset = uint32_t(meshletPrimitives.size() / 3);
+    box3 currentBounds = box3::empty();
+    uint32_t lastTriangle = c_InvalidIndex;
+    size_t seedCursor = 0;
+
+    auto countNewVertices = [&](uint32_t triangle)
+    {
+        const uint32_t a = indices[triangle * 3 + 0];
+        const uint32_t b = indices[triangle * 3 + 1];
+        const uint32_t c = indices[triangle * 3 + 2];
+        return uint32_t(localIndices[a] == c_InvalidIndex)
+             + uint32_t(localIndices[b] == c_InvalidIndex && b != a)
+             + uint32_t(localIndices[c] == c_InvalidIndex && c != a && c != b);
+    };
+
+    auto finishMeshlet = [&]()
+    {
+        if (current.primitiveCount != 0)
+        {
+            ComputeMeshletBounds(current, meshletVertices.data() + current.vertexOffset,
+                meshletPrimitives.data() + size_t(current.primitiveOffset) * 3, positions);
+            meshlets.push_back(current);
+        }
+
+        for (uint32_t index = 0; index < current.vertexCount; index++)
+            localIndices[meshletVertices[current.vertexOffset + index]] = c_InvalidIndex;
+
+        current = Meshlet();
+        current.vertexOffset = uint32_t(meshletVertices.size());
+        current.primitiveOffset = uint32_t(meshletPrimitives.size() / 3);
+        currentBounds = box3::empty();
+        lastTriangle = c_InvalidIndex;
+    };
+
+    uint32_t bestTriangle = c_InvalidIndex;
+    uint32_t bestNewVertices = 0;
+    uint32_t bestLiveCount = 0;
+
+    auto considerNeighbors = [&](uint32_t vertex)
+    {
+        for (uint32_t entry = adjacencyOffsets[vertex]; entry < adjacencyOffsets[vertex + 1]; entry++)
+        {
+            const uint32_t triangle = adjacency[entry];
+            if (emitted[triangle])
+                continue;
+
+            const uint32_t newVertices = countNewVertices(triangle);
+            if (current.vertexCount + newVertices > maxVertices)
+                continue;
+
+            const uint32_t liveCount = liveCounts[indices[triangle * 3 + 0]]
+                + liveCounts[indices[triangle * 3 + 1]]
+                + liveCounts[indices[triangle * 3 + 2]];
+
+            if (bestTriangle == c_InvalidIndex || newVertices < bestNewVertices ||
+                (newVertices == bestNewVertices && liveCount < bestLiveCount))
+            {
+                bestTriangle = triangle;
+                bestNewVertices = newVertices;
+                bestLiveCount = liveCount;
+            }
+        }
+    };
+
+    uint32_t numEmitted = 0;
+    while (numEmitted < numTriangles)
+    {
+        bestTriangle = c_InvalidIndex;
+
+        if (current.primitiveCount < maxPrimitives)
+        {
+            // The neighbors of the last triangle are usually enough, fall back to the neighbors of the whole meshlet
+            if (lastTriangle != c_InvalidIndex)
+            {
+                for (uint32_t corner = 0; corner < 3; corner++)
+                    considerNeighbors(indices[lastTriangle * 3 + corner]);
+            }
+
+            if (bestTriangle == c_InvalidIndex)
+            {
+                for (uint32_t index = 0; index < current.vertexCount; index++)
+                    considerNeighbors(meshletVertices[current.vertexOffset + index]);
+            }
+
+            // No connected triangle fits: continue with the next seed if the meshlet is empty,
+            // or if the seed is close enough to keep the meshlet compact, e.g. for disconnected foliage cards.
+            if (bestTriangle == c_InvalidIndex)
+            {
+                while (emitted[uint32_t(seedKeys[seedCursor])])
+                    ++seedCursor;
+
+                const uint32_t seed = uint32_t(seedKeys[seedCursor]);
+
+                if (current.primitiveCount == 0)
+                    bestTriangle = seed;
+                else if (current.vertexCount + countNewVertices(seed) <= maxVertices)
+                {
+                    const float3 center = GetTriangleCenter(indices, positions, seed);
+                    const float3 nearest = clamp(center, currentBounds.m_mins, currentBounds.m_maxs);
+                    if (length(center - nearest) <= length(currentBounds.diagonal()))
+                        bestTriangle = seed;
+                }
+            }
+        }
+
+        if (bestTriangle == c_InvalidIndex)
+        {
+            finishMeshlet();
+            continue;
+        }
+
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            const uint32_t vertex = indices[bestTriangle * 3 + corner];
+            if (localIndices[vertex] == c_InvalidIndex)
+            {
+                localIndices[vertex] = current.vertexCount++;
+                meshletVertices.push_back(vertex);
+                currentBounds |= positions[vertex];
+            }
+            meshletPrimitives.push_back(uint8_t(localIndices[vertex]));
+            --liveCounts[vertex];
+        }
+
+        emitted[bestTriangle] = 1;
+        lastTriangle = bestTriangle;
+        ++current.primitiveCount;
+        ++numEmitted;
+    }
+
+    finishMeshlet();
+
+    return uint32_t(meshlets.size() - firstMeshlet);
+}
+
+void donut::engine::ComputeMeshletBounds(
+    Meshlet& meshlet,
+    const uint32_t* meshletVertices,
+    const uint8_t* meshletPrimitives,
+    const float3* positions)
+{
+    box3 bounds = box3::empty();
+    for (uint32_t index = 0; index < meshlet.vertexCount; index++)
+        bounds |= positions[meshletVertices[index]];
+
+    meshlet.center = bounds.center();
+    meshlet.radius = 0.f;
+    for (uint32_t index = 0; index < meshlet.vertexCount; index++)
+        meshlet.radius = std::max(meshlet.radius, length(positions[meshletVertices[index]] - meshlet.center));
+
+    auto getNormal = [meshletVertices, meshletPrimitives, positions](uint32_t triangle, float3& normal)
+    {
+        const float3 p0 = positions[meshletVertices[meshletPrimitives[triangle * 3 + 0]]];
+        const float3 p1 = positions[meshletVertices[meshletPrimitives[triangle * 3 + 1]]];
+        const float3 p2 = positions[meshletVertices[meshletPrimitives[triangle * 3 + 2]]];
+        normal = cross(p1 - p0, p2 - p0);
+        const float area = length(normal);
+        if (area <= 0.f)
+            return false;
+        normal /= area;
+        return true;
+    };
+
+    // The cone axis is the average of the triangle normals, and the cone contains all the normals.
+    // Triangles with zero area don't face any direction and are ignored.
+    meshlet.coneAxis = 0.f;
+    meshlet.coneCutoff = 1.f;
+
+    float3 normalSum = 0.f;
+    float3 normal;
+    for (uint32_t triangle = 0; triangle < meshlet.primitiveCount; triangle++)
+    {
+        if (getNormal(triangle, normal))
+            normalSum += normal;
+    }
+
+    const float axisLength = length(normalSum);
+    if (axisLength < 1e-6f)
+        return;
+
+    const float3 axis = normalSum / axisLength;
+    float minDot = 1.f;
+    for (uint32_t triangle = 0; triangle < meshlet.primitiveCount; triangle++)
+    {
+        if (getNormal(triangle, normal))
+            minDot = std::min(minDot, dot(normal, axis));
+    }
+
+    // Cones wider than about 84 degrees cull too rarely to be worth testing
+    if (minDot <= 0.1f)
+        return;
+
+    // The meshlet is back-facing when the view direction is within (90 degrees - cone angle) of the axis,
+    // i.e. when its cosine with the axis exceeds sin(cone angle).
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+}
+
+void donut::engine::BuildMeshlets(
+    const std::vector<std::shared_ptr<MeshInfo>>& meshes,
+    const MeshletBuildParams& params,
+    ThreadPool* threadPool)
+{
+    struct GeometryMeshlets
+    {
+        MeshInfo* mesh = nullptr;
+        MeshGeometry* geometry = nullptr;
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> vertices;
+        std::vector<uint8_t> primitives;
+    };
+
+    std::vector<GeometryMeshlets> geometries;
+    for (const auto& mesh : meshes)
+    {
+        if (!mesh || !mesh->buffers || mesh->IsCurve() || mesh->skinPrototype)
+            continue;
+
+        const BufferGroup& buffers = *mesh->buffers;
+        for (const auto& geometry : mesh->geometries)
+        {
+            if (geometry->type != MeshGeometryPrimitiveType::Triangles || geometry->numMeshlets != 0 || geometry->numIndices < 3)
+                continue;
+
+            const size_t indexEnd = size_t(mesh->indexOffset) + geometry->indexOffsetInMesh + geometry->numIndices;
+            const size_t vertexEnd = size_t(mesh->vertexOffset) + geometry->vertexOffsetInMesh + geometry->numVertices;
+            if (indexEnd > buffers.indexData.size() || vertexEnd > buffers.positionData.size())
+                continue;
+
+            GeometryMeshlets& item = geometries.emplace_back();
+            item.mesh = mesh.get();
+            item.geometry = geometry.get();
+        }
+    }
+
+    auto build = [&params](GeometryMeshlets& item)
+    {
+        const BufferGroup& buffers = *item.mesh->buffers;
+        const MeshGeometry& geometry = *item.geometry;
+        BuildMeshlets(
+            buffers.indexData.data() + item.mesh->indexOffset + geometry.indexOffsetInMesh, geometry.numIndices,
+            buffers.positionData.data() + item.mesh->vertexOffset + geometry.vertexOffsetInMesh, geometry.numVertices,
+            params, item.meshlets, item.vertices, item.primitives);
+    };
+
+    if (threadPool && geometries.size() > 1)
+    {
+        ThreadPoolTaskGroup taskGroup;
+        for (GeometryMeshlets& item : geometries)
+            threadPool->AddTask(taskGroup, [&build, &item]() { build(item); });
+        threadPool->Wait(taskGroup);
+    }
+    else
+    {
+        for (GeometryMeshlets& item : geometries)
+            build(item);
+    }
+
+    // Append the meshlets to the buffer groups in geometry order, so that the result doesn't depend on the threads
+    for (GeometryMeshlets& item : geometries)
+    {
+        BufferGroup& buffers = *item.mesh->buffers;
+        const uint32_t vertexBase = uint32_t(buffers.meshletVertexData.size());
+        const uint32_t primitiveBase = uint32_t(buffers.meshletPrimitiveData.size() / 3);
+
+        item.geometry->meshletOffset = uint32_t(buffers.meshletData.size());
+        item.geometry->numMeshlets = uint32_t(item.meshlets.size());
+
+        for (Meshlet& meshlet : item.meshlets)
+        {
+            meshlet.vertexOffset += vertexBase;
+            meshlet.primitiveOffset += primitiveBase;
+            buffers.meshletData.push_back(meshlet);
+        }
+
+        buffers.meshletVertexData.insert(buffers.meshletVertexData.end(), item.vertices.begin(), item.vertices.end());
+        buffers.meshletPrimitiveData.insert(buffers.meshletPrimitiveData.end(), item.primitives.begin(), item.primitives.end());
+    }
+}
@@ -0,0 +1,592 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/engine/OcclusionBuffer.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define DONUT_OCCLUSION_SSE2 1
+#include <emmintrin.h>
+#else
+#define DONUT_OCCLUSION_SSE2 0
+#endif
+
+#include <stb_image_write.h>
+
+using namespace donut::math;
+using namespace donut::engine;
+
+// Triangles are clipped to this multiple of the screen size in X and Y, which keeps the screen space coordinates
+// small enough for the edge functions to be accurate.
+static constexpr float c_GuardBand = 4.f;
+
+// Relative tolerance of the depth comparison, which prevents occluders from hiding themselves due to rounding.
+static constexpr float c_DepthTolerance = 1e-4f;
+
+// The number of occluder triangles set up by one binning job when a thread pool is used.
+static constexpr uint32_t c_TrianglesPerJob = 4096;
+
+OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+{
+    Resize(width, height);
+}
+
+void OcclusionBuffer::Resize(uint32_t width, uint32_t height)
+{
+    m_TilesX = std::max((width + TileWidth - 1) / TileWidth, 1u);
+    m_TilesY = std::max((height + TileHeight - 1) / TileHeight, 1u);
+    m_Width = m_TilesX * TileWidth;
+    m_Height = m_TilesY * TileHeight;
+
+    m_DepthLevels.clear();
+    m_LevelSizes.clear();
+
+    uint2 size = uint2(m_Width, m_Height);
+    while (true)
+    {
+        m_LevelSizes.push_back(size);
+        m_DepthLevels.emplace_back(size_t(size.x) * size.y, 0.f);
+
+        if (size.x == 1 && size.y == 1)
+            break;
+
+        size = uint2((size.x + 1) / 2, (size.y + 1) / 2);
+    }
+}
+
+void OcclusionBuffer::BeginFrame(const float4x4& viewProjection, bool reverseDepth)
+{
+    m_ViewProjection = viewProjection;
+    m_ReverseDepth = reverseDepth;
+    m_Occluders.clear();
+    m_Stats = Stats();
+
+    for (auto& level : m_DepthLevels)
+        std::fill(level.begin(), level.end(), 0.f);
+}
+
+void OcclusionBuffer::AddOccluder(const float3* positions, const uint32_t* indices, uint32_t numIndices, const affine3& objectToWorld)
+{
+    if (!positions || !indices || numIndices < 3)
+        return;
+
+    m_Occluders.push_back(Occluder{ positions, indices, numIndices, objectToWorld });
+}
+
+// Transforms a world space position into clip space, with Z replaced by the depth in the buffer's convention:
+// the result is (x, y, depth * w, w), and the point is in front of the near plane when w - depth * w >= 0.
+static float4 TransformToClip(const float3& position, const float4x4& viewProjection, bool reverseDepth)
+{
+    float4 clip = float4(position, 1.f) * viewProjection;
+    if (!reverseDepth)
+        clip.z = clip.w - clip.z;
+    return clip;
+}
+
+// Signed distances to the clipping planes, non-negative inside.
+static float GetClipDistance(const float4& v, int plane)
+{
+    switch (plane)
+    {
+    case 0: return v.w - v.z; // near
+    case 1: return c_GuardBand * v.w - v.x;
+    case 2: return c_GuardBand * v.w + v.x;
+    case 3: return c_GuardBand * v.w - v.y;
+    default: return c_GuardBand * v.w + v.y;
+    }
+}
+
+void OcclusionBuffer::SetupTriangles(uint32_t firstOccluder, uint32_t lastOccluder, Bin& bin) const
+{
+    bin.triangles.clear();
+    bin.tileTriangles.resize(size_t(m_TilesX) * m_TilesY);
+    for (auto& tile : bin.tileTriangles)
+        tile.clear();
+
+    constexpr int numPlanes = 5;
+    constexpr int maxPolygonSize = 3 + numPlanes;
+
+    for (uint32_t occluderIndex = firstOccluder; occluderIndex < lastOccluder; occluderIndex++)
+    {
+        const Occluder& occluder = m_Occluders[occluderIndex];
+
+        for (uint32_t index = 0; index + 2 < occluder.numIndices; index += 3)
+        {
+            float4 polygon[maxPolygonSize];
+            int polygonSize = 3;
+            uint32_t outsideMask = 0;
+            for (int vertex = 0; vertex < 3; vertex++)
+            {
+                float3 worldPosition = occluder.objectToWorld.transformPoint(occluder.positions[occluder.indices[index + vertex]]);
+                polygon[vertex] = TransformToClip(worldPosition, m_ViewProjection, m_ReverseDepth);
+
+                for (int plane = 0; plane < numPlanes; plane++)
+                {
+                    if (GetClipDistance(polygon[vertex], plane) < 0.f)
+                        outsideMask |= 1u << plane;
+                }
+            }
+
+            // Sutherland-Hodgman clipping against the planes that any of the vertices are outside of
+            for (int plane = 0; plane < numPlanes && polygonSize >= 3; plane++)
+            {
+                if ((outsideMask & (1u << plane)) == 0)
+                    continue;
+
+                float4 clipped[maxPolygonSize];
+                int clippedSize = 0;
+                for (int vertex = 0; vertex < polygonSize; vertex++)
+                {
+                    const float4& a = polygon[vertex];
+                    const float4& b = polygon[(vertex + 1) % polygonSize];
+                    float da = GetClipDistance(a, plane);
+                    float db = GetClipDistance(b, plane);
+
+                    if (da >= 0.f)
+                        clipped[clippedSize++] = a;
+                    if ((da >= 0.f) != (db >= 0.f) && clippedSize < maxPolygonSize)
+                        clipped[clippedSize++] = lerp(a, b, da / (da - db));
+                }
+
+                std::copy(clipped, clipped + clippedSize, polygon);
+                polygonSize = clippedSize;
+            }
+
+            for (int vertex = 2; vertex < polygonSize; vertex++)
+                AddTriangle(polygon[0], polygon[vertex - 1], polygon[vertex], bin);
+        }
+    }
+}
+
+void OcclusionBuffer::AddTriangle(const float4& v0, const float4& v1, const float4& v2, Bin& bin) const
+{
+    if (v0.w <= 0.f || v1.w <= 0.f || v2.w <= 0.f)
+        return;
+
+    // Screen space positions in pixels and depths
+    float2 p[3];
+    float depth[3];
+    const float4* vertices[3] = { &v0, &v1, &v2 };
+    for (int i = 0; i < 3; i++)
+    {
+        const float4& v = *vertices[i];
+        float invW = 1.f / v.w;
+        p[i].x = (v.x * invW * 0.5f + 0.5f) * float(m_Width);
+        p[i].y = (0.5f - v.y * invW * 0.5f) * float(m_Height);
+        depth[i] = v.z * invW;
+    }
+
+    float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+    if (std::abs(area) < 1e-8f)
+        return;
+
+    // Pixel range covered by the bounding rectangle, in terms of pixel centers
+    float minX = std::min({ p[0].x, p[1].x, p[2].x });
+    float maxX = std::max({ p[0].x, p[1].x, p[2].x });
+    float minY = std::min({ p[0].y, p[1].y, p[2].y });
+    float maxY = std::max({ p[0].y, p[1].y, p[2].y });
+
+    Triangle triangle;
+    triangle.minX = std::max(int(std::ceil(minX - 0.5f)), 0);
+    triangle.maxX = std::min(int(std::floor(maxX - 0.5f)), int(m_Width) - 1);
+    triangle.minY = std::max(int(std::ceil(minY - 0.5f)), 0);
+    triangle.maxY = std::min(int(std::floor(maxY - 0.5f)), int(m_Height) - 1);
+
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        return;
+
+    // Edge functions that are positive inside the triangle, for either winding, evaluated at pixel centers.
+    // Edge i is opposite to vertex i, and its value at vertex i equals the absolute area.
+    float sign = (area > 0.f) ? 1.f : -1.f;
+    for (int i = 0; i < 3; i++)
+    {
+        const float2& a = p[(i + 1) % 3];
+        const float2& b = p[(i + 2) % 3];
+        float edgeA = (a.y - b.y) * sign;
+        float edgeB = (b.x - a.x) * sign;
+        triangle.edgeA[i] = edgeA;
+        triangle.edgeB[i] = edgeB;
+        triangle.edgeC[i] = (a.x * b.y - a.y * b.x) * sign + 0.5f * (edgeA + edgeB);
+    }
+
+    // Depth plane from the barycentric coordinates
+    float invArea = 1.f / std::abs(area);
+    triangle.depthA = (triangle.edgeA[0] * depth[0] + triangle.edgeA[1] * depth[1] + triangle.edgeA[2] * depth[2]) * invArea;
+    triangle.depthB = (triangle.edgeB[0] * depth[0] + triangle.edgeB[1] * depth[1] + triangle.edgeB[2] * depth[2]) * invArea;
+    triangle.depthC = (triangle.edgeC[0] * depth[0] + triangle.edgeC[1] * depth[1] + triangle.edgeC[2] * depth[2]) * invArea;
+
+    uint32_t triangleIndex = uint32_t(bin.triangles.size());
+    bin.triangles.push_back(triangle);
+
+    uint32_t tileMinX = uint32_t(triangle.minX) / TileWidth;
+    uint32_t tileMaxX = uint32_t(triangle.maxX) / TileWidth;
+    uint32_t tileMinY = uint32_t(triangle.minY) / TileHeight;
+    uint32_t tileMaxY = uint32_t(triangle.maxY) / TileHeight;
+    for (uint32_t tileY = tileMinY; tileY <= tileMaxY; tileY++)
+    {
+        for (uint32_t tileX = tileMinX; tileX <= tileMaxX; tileX++)
+            bin.tileTriangles[tileY * m_TilesX + tileX].push_back(triangleIndex);
+    }
+}
+
+void OcclusionBuffer::RasterizeTile(uint32_t tileIndex)
+{
+    const int tileX0 = int((tileIndex % m_TilesX) * TileWidth);
+    const int tileY0 = int((tileIndex / m_TilesX) * TileHeight);
+    float* depthBuffer = m_DepthLevels[0].data();
+
+    for (int y = tileY0; y < tileY0 + int(TileHeight); y++)
+        std::fill_n(depthBuffer + size_t(y) * m_Width + tileX0, TileWidth, 0.f);
+
+    for (const Bin& bin : m_Bins)
+    {
+        for (uint32_t triangleIndex : bin.tileTriangles[tileIndex])
+        {
+            const Triangle& t = bin.triangles[triangleIndex];
+
+            // The SIMD path processes aligned groups of 4 pixels, the edge functions reject the pixels outside of the triangle
+            const int x0 = std::max(t.minX, tileX0) & ~3;
+            const int x1 = std::min(t.maxX, tileX0 + int(TileWidth) - 1);
+            const int y0 = std::max(t.minY, tileY0);
+            const int y1 = std::min(t.maxY, tileY0 + int(TileHeight) - 1);
+
+            for (int y = y0; y <= y1; y++)
+            {
+                float* row = depthBuffer + size_t(y) * m_Width;
+                const float fy = float(y);
+
+#if DONUT_OCCLUSION_SSE2
+                const __m128 laneOffsets = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+                const __m128 zero = _mm_setzero_ps();
+                __m128 edgeStep[3];
+                __m128 edgeRow[3];
+                for (int i = 0; i < 3; i++)
+                {
+                    edgeStep[i] = _mm_set1_ps(t.edgeA[i] * 4.f);
+                    edgeRow[i] = _mm_add_ps(
+                        _mm_set1_ps(t.edgeA[i] * float(x0) + t.edgeB[i] * fy + t.edgeC[i]),
+                        _mm_mul_ps(_mm_set1_ps(t.edgeA[i]), laneOffsets));
+                }
+                const __m128 depthStep = _mm_set1_ps(t.depthA * 4.f);
+                __m128 depthRow = _mm_add_ps(
+                    _mm_set1_ps(t.depthA * float(x0) + t.depthB * fy + t.depthC),
+                    _mm_mul_ps(_mm_set1_ps(t.depthA), laneOffsets));
+
+                for (int x = x0; x <= x1; x += 4)
+                {
+                    __m128 inside = _mm_and_ps(_mm_and_ps(
+                        _mm_cmpge_ps(edgeRow[0], zero),
+                        _mm_cmpge_ps(edgeRow[1], zero)),
+                        _mm_cmpge_ps(edgeRow[2], zero));
+
+                    if (_mm_movemask_ps(inside))
+                    {
+                        __m128 current = _mm_loadu_ps(row + x);
+                        __m128 updated = _mm_max_ps(current, depthRow);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, updated), _mm_andnot_ps(inside, current)));
+                    }
+
+                    for (int i = 0; i < 3; i++)
+                        edgeRow[i] = _mm_add_ps(edgeRow[i], edgeStep[i]);
+                    depthRow = _mm_add_ps(depthRow, depthStep);
+                }
+#else
+                for (int x = x0; x <= x1; x++)
+                {
+                    const float fx = float(x);
+                    bool inside = true;
+                    for (int i = 0; i < 3; i++)
+                        inside = inside && (t.edgeA[i] * fx + t.edgeB[i] * fy + t.edgeC[i] >= 0.f);
+
+                    if (inside)
+                        row[x] = std::max(row[x], t.depthA * fx + t.depthB * fy + t.depthC);
+                }
+#endif
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::BuildDepthPyramid()
+{
+    for (size_t level = 1; level < m_DepthLevels.size(); level++)
+    {
+        const std::vector<float>& src = m_DepthLevels[level - 1];
+        std::vector<float>& dst = m_DepthLevels[level];
+        const uint2 srcSize = m_LevelSizes[level - 1];
+        const uint2 dstSize = m_LevelSizes[level];
+
+        for (uint32_t y = 0; y < dstSize.y; y++)
+        {
+            const uint32_t sy0 = y * 2;
+            const uint32_t sy1 = std::min(sy0 + 1, srcSize.y - 1);
+            for (uint32_t x = 0; x < dstSize.x; x++)
+            {
+                const uint32_t sx0 = x * 2;
+                const uint32_t sx1 = std::min(sx0 + 1, srcSize.x - 1);
+                dst[y * dstSize.x + x] = std::min(
+                    std::min(src[sy0 * srcSize.x + sx0], src[sy0 * srcSize.x + sx1]),
+                    std::min(src[sy1 * srcSize.x + sx0], src[sy1 * srcSize.x + sx1]));
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::Rasterize(ThreadPool* threadPool)
+{
+    const uint32_t numOccluders = uint32_t(m_Occluders.size());
+    const uint32_t numTiles = m_TilesX * m_TilesY;
+
+    // Split the occluders into binning jobs of roughly equal triangle counts
+    std::vector<uint32_t> jobStarts;
+    jobStarts.push_back(0);
+    if (threadPool)
+    {
+        uint32_t jobTriangles = 0;
+        for (uint32_t occluderIndex = 0; occluderIndex < numOccluders; occluderIndex++)
+        {
+            jobTriangles += m_Occluders[occluderIndex].numIndices / 3;
+            if (jobTriangles >= c_TrianglesPerJob && occluderIndex + 1 < numOccluders)
+            {
+                jobStarts.push_back(occluderIndex + 1);
+                jobTriangles = 0;
+            }
+        }
+    }
+    jobStarts.push_back(numOccluders);
+
+    const uint32_t numJobs = uint32_t(jobStarts.size()) - 1;
+    m_Bins.resize(numJobs);
+
+    if (threadPool && numJobs > 1)
+    {
+        ThreadPoolTaskGroup group;
+        for (uint32_t job = 0; job < numJobs; job++)
+        {
+            threadPool->AddTask(group, [this, job, &jobStarts]()
+            {
+                SetupTriangles(jobStarts[job], jobStarts[job + 1], m_Bins[job]);
+            });
+        }
+        threadPool->Wait(group);
+    }
+    else
+    {
+        SetupTriangles(0, numOccluders, m_Bins[0]);
+    }
+
+    if (threadPool)
+    {
+        ThreadPoolTaskGroup group;
+        for (uint32_t tile = 0; tile < numTiles; tile++)
+            threadPool->AddTask(group, [this, tile]() { RasterizeTile(tile); });
+        threadPool->Wait(group);
+    }
+    else
+    {
+        for (uint32_t tile = 0; tile < numTiles; tile++)
+            RasterizeTile(tile);
+    }
+
+    BuildDepthPyramid();
+
+    m_Stats.occluders = numOccluders;
+    m_Stats.triangles = 0;
+    m_Stats.binnedTriangles = 0;
+    for (const Bin& bin : m_Bins)
+    {
+        m_Stats.triangles += uint32_t(bin.triangles.size());
+        for (const auto& tile : bin.tileTriangles)
+            m_Stats.binnedTriangles += uint32_t(tile.size());
+    }
+
+    m_Occluders.clear();
+}
+
+bool OcclusionBuffer::ProjectBox(const box3& worldBox, float2& screenMin, float2& screenMax, float& maxDepth) const
+{
+    screenMin = float2(std::numeric_limits<float>::max());
+    screenMax = float2(-std::numeric_limits<float>::max());
+    maxDepth = -std::numeric_limits<float>::max();
+
+    for (int corner = 0; corner < 8; corner++)
+    {
+        float4 clip = TransformToClip(worldBox.getCorner(corner), m_ViewProjection, m_ReverseDepth);
+        if (clip.w <= 0.f || clip.w - clip.z < 0.f)
+            return false;
+
+        float invW = 1.f / clip.w;
+        float2 screen = float2(
+            (clip.x * invW * 0.5f + 0.5f) * float(m_Width),
+            (0.5f - clip.y * invW * 0.5f) * float(m_Height));
+        screenMin = min(screenMin, screen);
+        screenMax = max(screenMax, screen);
+        maxDepth = std::max(maxDepth, clip.z * invW);
+    }
+
+    return true;
+}
+
+bool OcclusionBuffer::IsVisible(const box3& worldBox) const
+{
+    if (worldBox.isempty())
+        return false;
+
+    float2 screenMin, screenMax;
+    float maxDepth;
+    if (!ProjectBox(worldBox, screenMin, screenMax, maxDepth))
+        return true;
+
+    // All pixels that the screen rectangle touches
+    int x0 = int(std::floor(std::max(screenMin.x, 0.f)));
+    int y0 = int(std::floor(std::max(screenMin.y, 0.f)));
+    int x1 = int(std::ceil(std::min(screenMax.x, float(m_Width)))) - 1;
+    int y1 = int(std::ceil(std::min(screenMax.y, float(m_Height)))) - 1;
+    x1 = std::max(x1, x0);
+    y1 = std::max(y1, y0);
+
+    if (screenMax.x < 0.f || screenMax.y < 0.f || x0 >= int(m_Width) || y0 >= int(m_Height))
+        return true;
+
+    // Pick the pyramid level where the rectangle covers at most 2x2 texels
+    uint32_t level = 0;
+    while (level + 1 < m_DepthLevels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+        level++;
+
+    const float threshold = maxDepth * (1.f + c_DepthTolerance);
+    const std::vector<float>& depth = m_DepthLevels[level];
+    const uint32_t levelWidth = m_LevelSizes[level].x;
+    for (int y = y0 >> level; y <= (y1 >> level); y++)
+    {
+        for (int x = x0 >> level; x <= (x1 >> level); x++)
+        {
+            if (depth[size_t(y) * levelWidth + x] <= threshold)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+float OcclusionBuffer::GetScreenCoverage(const box3& worldBox) const
+{
+    if (worldBox.isempty())
+        return 0.f;
+
+    float2 screenMin, screenMax;
+    float maxDepth;
+    if (!ProjectBox(worldBox, screenMin, screenMax, maxDepth))
+        return 1.f;
+
+    float2 size = max(min(screenMax, float2(float(m_Width), float(m_Height))) - max(screenMin, float2(0.f)), float2(0.f));
+    return std::min(size.x * size.y / (float(m_Width) * float(m_Height)), 1.f);
+}
+
+void OcclusionBuffer::GetDebugImage(std::vector<uint8_t>& pixels) const
+{
+    const std::vector<float>& depth = m_DepthLevels[0];
+    pixels.resize(depth.size());
+
+    // Stretch the contrast over the range of depths that were rasterized
+    float minDepth = std::numeric_limits<float>::max();
+    float maxDepth = 0.f;
+    for (float d : depth)
+    {
+        if (d > 0.f)
+        {
+            minDepth = std::min(minDepth, d);
+            maxDepth = std::max(maxDepth, d);
+        }
+    }
+
+    float scale = (maxDepth > minDepth) ? 223.f / (maxDepth - minDepth) : 0.f;
+    for (size_t i = 0; i < depth.size(); i++)
+        pixels[i] = (depth[i] > 0.f) ? uint8_t(32.f + (depth[i] - minDepth) * scale) : 0;
+}
+
+bool OcclusionBuffer::WriteDebugImage(const std::filesystem::path& fileName) const
+{
+    std::vector<uint8_t> pixels;
+    GetDebugImage(pixels);
+    return stbi_write_png(fileName.generic_string().c_str(), int(m_Width), int(m_Height), 1, pixels.data(), int(m_Width)) != 0;
+}
+
+static bool IsOccluderCandidate(const MeshInfo& mesh, uint32_t maxTriangles)
+{
+    if (mesh.type != MeshType::Triangles || mesh.skinPrototype || mesh.isSkinPrototype || mesh.geometries.empty())
+        return false;
+
+    uint32_t numTriangles = 0;
+    for (const auto& geometry : mesh.geometries)
+    {
+        if (geometry->type != MeshGeometryPrimitiveType::Triangles)
+            return false;
+        if (!geometry->material || geometry->material->domain != MaterialDomain::Opaque)
+            return false;
+
+        numTriangles += geometry->numIndices / 3;
+    }
+
+    return numTriangles <= maxTriangles;
+}
+
+uint32_t donut::engine::SelectOccluders(const SceneGraph& sceneGraph, const OccluderSelectionParams& params)
+{
+    const auto& instances = sceneGraph.GetMeshInstances();
+
+    std::vector<box3> instanceBounds(instances.size(), box3::empty());
+    box3 sceneBounds = box3::empty();
+    for (size_t index = 0; index < instances.size(); index++)
+    {
+        const MeshInstance& instance = *instances[index];
+        const SceneGraphNode* node = instance.GetNode();
+        if (!node || !instance.GetMesh())
+            continue;
+
+        instanceBounds[index] = instance.GetMesh()->objectSpaceBounds * node->GetLocalToWorldTransformFloat();
+        sceneBounds |= instanceBounds[index];
+    }
+
+    if (sceneBounds.isempty())
+        return 0;
+
+    const float minDiagonal = length(sceneBounds.diagonal()) * params.minRelativeSize;
+
+    uint32_t numSelected = 0;
+    for (size_t index = 0; index < instances.size(); index++)
+    {
+        const std::shared_ptr<MeshInfo>& mesh = instances[index]->GetMesh();
+        if (!mesh || mesh->isOccluder || instanceBounds[index].isempty())
+            continue;
+
+        if (length(instanceBounds[index].diagonal()) >= minDiagonal && IsOccluderCandidate(*mesh, params.maxTriangles))
+        {
+            mesh->isOccluder = true;
+            ++numSelected;
+        }
+    }
+
+    return numSelected;
+}
@@ -36,12 +36,16 @@ this software is released into the Public Domain.
 
 #include <donut/engine/Scene.h>
 #include <donut/engine/GltfImporter.h>
+#include <donut/engine/MeshSetImporter.h>
+#include <donut/engine/SceneCache.h>
 #include <donut/engine/ThreadPool.h>
 #include <donut/core/json.h>
 #include <donut/core/log.h>
 #include <donut/core/string_utils.h>
 #include <nvrhi/common/misc.h>
 #include <json/json-forwards.h>
+#include <chrono>
+#include <unordered_set>
 
 #include "donut/engine/ShaderFactory.h"
 
@@ -98,6 +102,7 @@ Scene::Scene(
         m_SceneTypeFactory = std::make_shared<SceneTypeFactory>();
 
     m_GltfImporter = std::make_shared<GltfImporter>(m_fs, m_SceneTypeFactory);
+    m_MeshSetImporter = std::make_shared<MeshSetImporter>(m_fs, m_SceneTypeFactory);
 
     m_EnableBindlessResources = !!m_DescriptorTable;
     m_RayTracingSupported = m_Device->queryFeatureSupport(nvrhi::Feature::RayTracingAccelStruct);
@@ -135,10 +140,18 @@ bool Scene::LoadWithThreadPool(const std::filesystem::path& sceneFileName, Threa
 {
     g_LoadingStats.ObjectsLoaded = 0;
     g_LoadingStats.ObjectsTotal = 0;
+    g_LoadingStats.ObjectsLoadedFromCache = 0;
+    g_LoadingStats.MeshLayoutMicroseconds = 0;
+    g_LoadingStats.MeshDataMicroseconds = 0;
+    g_LoadingStats.MeshOptimizationMicroseconds = 0;
+    g_LoadingStats.MeshletMicroseconds = 0;
+    g_LoadingStats.MeshLodMicroseconds = 0;
+    g_LoadingStats.VertexBytesSaved = 0;
+    g_LoadingStats.AnimationBytesSaved = 0;
     
     m_SceneGraph = std::make_shared<SceneGraph>();
 
-    if (sceneFileName.extension() == ".gltf" || sceneFileName.extension() == ".glb")
+    if (sceneFileName.extension() == ".gltf" || sceneFileName.extension() == ".glb" || sceneFileName.extension() == ".meshset")
     {
         ++g_LoadingStats.ObjectsTotal;
         m_Models.resize(1);
@@ -184,6 +197,135 @@ bool Scene::LoadWithThreadPool(const std::filesystem::path& sceneFileName, Threa
     return true;
 }
 
+static std::vector<std::shared_ptr<MeshInfo>> CollectMeshes(const SceneImportResult& result)
+{
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+    std::unordered_set<const MeshInfo*> visitedMeshes;
+    for (SceneGraphWalker walker(result.rootNode.get()); walker; walker.Next(true))
+    {
+        if (auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(walker->GetLeaf()))
+        {
+            const auto& mesh = meshInstance->GetMesh();
+            if (mesh && visitedMeshes.insert(mesh.get()).second)
+                meshes.push_back(mesh);
+        }
+    }
+    return meshes;
+}
+
+static void LogAnimationCompression(const animation::CompressionReport& report, const char* source)
+{
+    if (!report.samplers)
+        return;
+
+    g_LoadingStats.AnimationBytesSaved += report.originalBytes - std::min(report.originalBytes, report.compressedBytes);
+
+    donut::log::info("Compressed %u animation samplers in '%s': %llu to %llu keyframes, %.1f KB to %.1f KB, "
+        "%u quantized, %u with uniform times, max error %g, mean error %g",
+        report.samplers, source,
+        (unsigned long long)report.originalKeyframes, (unsigned long long)report.compressedKeyframes,
+        double(report.originalBytes) / 1024.0, double(report.compressedBytes) / 1024.0,
+        report.quantizedSamplers, report.uniformSamplers, report.maxError, report.GetMeanError());
+}
+
+bool Scene::LoadModel(
+    const std::filesystem::path& fileName,
+    ThreadPool* threadPool,
+    SceneImportResult& result)
+{
+    if (fileName.extension() == ".meshset")
+    {
+        if (!m_MeshSetImporter->Load(fileName, result))
+            return false;
+    }
+    else if (m_SceneCache && m_SceneCache->Load(fileName, *m_TextureCache, threadPool, result))
+    {
+        ++g_LoadingStats.ObjectsLoadedFromCache;
+
+        // The cache file may have been written with meshlets disabled
+        if (m_BuildMeshlets)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+
+            BuildMeshlets(CollectMeshes(result), m_MeshletParams, threadPool);
+
+            auto endTime = std::chrono::steady_clock::now();
+            g_LoadingStats.MeshletMicroseconds += uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count());
+        }
+    }
+    else
+    {
+        if (!m_GltfImporter->Load(fileName, *m_TextureCache, g_LoadingStats, threadPool, result))
+            return false;
+
+        if (m_SceneCache)
+            m_SceneCache->Store(fileName, result);
+    }
+
+    // The levels of detail are not stored in the scene cache, so they are generated for every loading path
+    if (m_GenerateLods)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        const MeshLodStatistics stats = GenerateMeshLods(CollectMeshes(result), m_LodParams, threadPool);
+
+        auto endTime = std::chrono::steady_clock::now();
+        g_LoadingStats.MeshLodMicroseconds += uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count());
+
+        if (stats.meshes)
+        {
+            log::info("Generated %u levels of detail for %u meshes in '%s', %llu triangles in the full detail meshes, %llu in the levels",
+                stats.lods, stats.meshes, fileName.generic_string().c_str(),
+                (unsigned long long)stats.baseTriangles, (unsigned long long)stats.lodTriangles);
+        }
+    }
+
+    // The scene cache stores the original keyframes, so the animations are compressed for every loading path
+    if (m_CompressAnimations)
+    {
+        animation::CompressionReport report;
+        for (SceneGraphWalker walker(result.rootNode.get()); walker; walker.Next(true))
+        {
+            if (auto animation = std::dynamic_pointer_cast<SceneGraphAnimation>(walker->GetLeaf()))
+                report += animation->Compress(m_AnimationCompression);
+        }
+
+        LogAnimationCompression(report, fileName.generic_string().c_str());
+    }
+
+    return true;
+}
+
+void Scene::SetOptimizeMeshes(bool enable, const MeshOptimizationParams& params)
+{
+    m_GltfImporter->SetOptimizeMeshes(enable, params);
+}
+
+void Scene::SetBuildMeshlets(bool enable, const MeshletBuildParams& params)
+{
+    m_BuildMeshlets = enable;
+    m_MeshletParams = params;
+    m_GltfImporter->SetBuildMeshlets(enable, params);
+}
+
+void Scene::SetGenerateLods(bool enable, const MeshLodParams& params)
+{
+    m_GenerateLods = enable;
+    m_LodParams = params;
+}
+
+void Scene::SetSelectOccluders(bool enable, const OccluderSelectionParams& params)
+{
+    m_SelectOccluders = enable;
+    m_OccluderParams = params;
+}
+
+void Scene::SetCompressAnimations(bool enable, const animation::CompressionSettings& settings)
+{
+    m_CompressAnimations = enable;
+    m_AnimationCompression = settings;
+}
+
 void Scene::LoadModelAsync(
     uint32_t index,
     const std::filesystem::path& fileName,
@@ -194,7 +336,7 @@ void Scene::LoadModelAsync(
         threadPool->AddTask([this, index, threadPool, fileName]()
         {
             SceneImportResult result;
-            m_GltfImporter->Load(fileName, *m_TextureCache, g_LoadingStats, threadPool, result);
+            LoadModel(fileName, threadPool, result);
             ++g_LoadingStats.ObjectsLoaded;
             m_Models[index] = result;
         });
@@ -202,7 +344,7 @@ void Scene::LoadModelAsync(
     else
     {
         SceneImportResult result;
-        m_GltfImporter->Load(fileName, *m_TextureCache, g_LoadingStats, threadPool, result);
+        LoadModel(fileName, threadPool, result);
         ++g_LoadingStats.ObjectsLoaded;
         m_Models[index] = result;
     }
@@ -389,6 +531,7 @@ static dm::float4 ReadUpToFloat4(const Json::Value& node)
 void Scene::LoadAnimations(const Json::Value& nodeList)
 {
     std::shared_ptr<SceneGraphNode> animationContainer;
+    animation::CompressionReport compressionReport;
 
     for (const auto& animationNode : nodeList)
     {
@@ -565,6 +708,9 @@ void Scene::LoadAnimations(const Json::Value& nodeList)
             }
             
             m_SceneGraph->Attach(animationContainer, sceneAnimationNode);
+
+            if (m_CompressAnimations)
+                compressionReport += animation->Compress(m_AnimationCompression);
         }
         else
         {
@@ -572,6 +718,8 @@ void Scene::LoadAnimations(const Json::Value& nodeList)
                 animation->GetName().c_str());
         }
     }
+
+    LogAnimationCompression(compressionReport, "scene file");
 }
 
 bool Scene::LoadCustomData(Json::Value& rootNode, ThreadPool* threadPool)
@@ -585,18 +733,27 @@ void Scene::FinishedLoading(uint32_t frameIndex)
     nvrhi::CommandListHandle commandList = m_Device->createCommandList();
     commandList->open();
     
+    // Occluder selection needs the instance transforms, and it has to happen before the mesh buffers
+    // are created, because that releases the CPU geometry of the meshes that are not occluders.
+    RefreshSceneGraph(frameIndex);
     CreateMeshBuffers(commandList);
-    Refresh(commandList, frameIndex);
+    RefreshBuffers(commandList, frameIndex);
+
+    if (m_VertexLayout == VertexLayout::Compact)
+    {
+        log::info("Compact vertex layout saved %.2f MB of vertex buffer memory",
+            double(g_LoadingStats.VertexBytesSaved) / (1024.0 * 1024.0));
+    }
 
     commandList->close();
     m_Device->executeCommandList(commandList);
 }
 
-void Scene::RefreshSceneGraph(uint32_t frameIndex)
+void Scene::RefreshSceneGraph(uint32_t frameIndex, ThreadPool* threadPool)
 {
     m_SceneStructureChanged = m_SceneGraph->HasPendingStructureChanges();
     m_SceneTransformsChanged = m_SceneGraph->HasPendingTransformChanges();
-    m_SceneGraph->Refresh(frameIndex);
+    m_SceneGraph->RefreshWithThreadPool(frameIndex, threadPool);
 }
 
 void Scene::RefreshBuffers(nvrhi::ICommandList* commandList, uint32_t frameIndex)
@@ -761,15 +918,16 @@ void Scene::UpdateSkinnedMeshes(nvrhi::ICommandList* commandList, uint32_t frame
         if (prototypeBuffers->hasAttribute(VertexAttribute::TexCoord1)) constants.flags |= SkinningFlag_TexCoord1;
         if (prototypeBuffers->hasAttribute(VertexAttribute::TexCoord2)) constants.flags |= SkinningFlag_TexCoord2;
         if (!skinnedInstance->skinningInitialized) constants.flags |= SkinningFlag_FirstFrame;
+        if (prototypeBuffers->vertexLayout == VertexLayout::Compact) constants.flags |= SkinningFlag_CompactVertices;
         skinnedInstance->skinningInitialized = true;
 
-        constants.inputPositionOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::Position).byteOffset + vertexOffset * sizeof(float3));
+        constants.inputPositionOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::Position).byteOffset + vertexOffset * prototypeBuffers->getVertexStride(VertexAttribute::Position));
         constants.inputNormalOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::Normal).byteOffset + vertexOffset * sizeof(uint32_t));
         constants.inputTangentOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::Tangent).byteOffset + vertexOffset * sizeof(uint32_t));
-        constants.inputTexCoord1Offset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::TexCoord1).byteOffset + vertexOffset * sizeof(float2));
-        constants.inputTexCoord2Offset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::TexCoord2).byteOffset + vertexOffset * sizeof(float2));
+        constants.inputTexCoord1Offset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::TexCoord1).byteOffset + vertexOffset * prototypeBuffers->getVertexStride(VertexAttribute::TexCoord1));
+        constants.inputTexCoord2Offset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::TexCoord2).byteOffset + vertexOffset * prototypeBuffers->getVertexStride(VertexAttribute::TexCoord2));
         constants.inputJointIndexOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::JointIndices).byteOffset + vertexOffset * sizeof(uint2));
-        constants.inputJointWeightOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::JointWeights).byteOffset + vertexOffset * sizeof(float4));
+        constants.inputJointWeightOffset = uint32_t(prototypeBuffers->getVertexBufferRange(VertexAttribute::JointWeights).byteOffset + vertexOffset * prototypeBuffers->getVertexStride(VertexAttribute::JointWeights));
         constants.outputPositionOffset = uint32_t(skinnedBuffers->getVertexBufferRange(VertexAttribute::Position).byteOffset);
         constants.outputPrevPositionOffset = uint32_t(skinnedBuffers->getVertexBufferRange(VertexAttribute::PrevPosition).byteOffset);
         constants.outputNormalOffset = uint32_t(skinnedBuffers->getVertexBufferRange(VertexAttribute::Normal).byteOffset);
@@ -820,6 +978,21 @@ inline void AppendBufferRange(nvrhi::BufferRange& range, size_t size, uint64_t&
 
 void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
 {
+    if (m_SelectOccluders)
+    {
+        uint32_t numOccluders = SelectOccluders(*m_SceneGraph, m_OccluderParams);
+        if (numOccluders > 0)
+            log::info("Selected %u meshes as occluders", numOccluders);
+    }
+
+    // Occluder meshes are rasterized on the CPU, keep their positions and indices
+    std::unordered_set<const BufferGroup*> occluderBuffers;
+    for (const auto& mesh : m_SceneGraph->GetMeshes())
+    {
+        if (mesh->isOccluder && mesh->buffers)
+            occluderBuffers.insert(mesh->buffers.get());
+    }
+
     for (const auto& mesh : m_SceneGraph->GetMeshes())
     {
         auto buffers = mesh->buffers;
@@ -827,6 +1000,8 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
         if (!buffers)
             continue;
 
+        const bool keepCpuGeometry = occluderBuffers.find(buffers.get()) != occluderBuffers.end();
+
         if (!buffers->indexData.empty() && !buffers->indexBuffer)
         {
             nvrhi::BufferDesc bufferDesc;
@@ -849,7 +1024,8 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             commandList->beginTrackingBufferState(buffers->indexBuffer, nvrhi::ResourceStates::Common);
 
             commandList->writeBuffer(buffers->indexBuffer, buffers->indexData.data(), buffers->indexData.size() * sizeof(uint32_t));
-            std::vector<uint32_t>().swap(buffers->indexData);
+            if (!keepCpuGeometry)
+                std::vector<uint32_t>().swap(buffers->indexData);
 
             nvrhi::ResourceStates state = nvrhi::ResourceStates::IndexBuffer | nvrhi::ResourceStates::ShaderResource;
 
@@ -870,10 +1046,20 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             bufferDesc.canHaveRawViews = true;
             bufferDesc.isAccelStructBuildInput = m_RayTracingSupported;
 
+            // Keep the full layout for the buffer groups whose positions don't fit into FP16, the passes handle both
+            std::vector<float16_t4> quantizedPositions;
+            buffers->vertexLayout = m_VertexLayout;
+            if (m_VertexLayout == VertexLayout::Compact &&
+                !QuantizePositions(buffers->positionData.data(), buffers->positionData.size(), quantizedPositions))
+            {
+                buffers->vertexLayout = VertexLayout::Full;
+            }
+            const bool compact = buffers->vertexLayout == VertexLayout::Compact;
+
             if (!buffers->positionData.empty())
             {
                 AppendBufferRange(buffers->getVertexBufferRange(VertexAttribute::Position), 
-                    buffers->positionData.size() * sizeof(buffers->positionData[0]), bufferDesc.byteSize);
+                    buffers->positionData.size() * buffers->getVertexStride(VertexAttribute::Position), bufferDesc.byteSize);
             }
 
             if (!buffers->normalData.empty())
@@ -891,19 +1077,19 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             if (!buffers->texcoord1Data.empty())
             {
                 AppendBufferRange(buffers->getVertexBufferRange(VertexAttribute::TexCoord1),
-                    buffers->texcoord1Data.size() * sizeof(buffers->texcoord1Data[0]), bufferDesc.byteSize);
+                    buffers->texcoord1Data.size() * buffers->getVertexStride(VertexAttribute::TexCoord1), bufferDesc.byteSize);
             }
 
             if (!buffers->texcoord2Data.empty())
             {
                 AppendBufferRange(buffers->getVertexBufferRange(VertexAttribute::TexCoord2),
-                    buffers->texcoord2Data.size() * sizeof(buffers->texcoord2Data[0]), bufferDesc.byteSize);
+                    buffers->texcoord2Data.size() * buffers->getVertexStride(VertexAttribute::TexCoord2), bufferDesc.byteSize);
             }
 
             if (!buffers->weightData.empty())
             {
                 AppendBufferRange(buffers->getVertexBufferRange(VertexAttribute::JointWeights),
-                    buffers->weightData.size() * sizeof(buffers->weightData[0]), bufferDesc.byteSize);
+                    buffers->weightData.size() * buffers->getVertexStride(VertexAttribute::JointWeights), bufferDesc.byteSize);
             }
 
             if (!buffers->jointData.empty())
@@ -923,6 +1109,19 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
 	            continue;
             }
 
+            if (compact)
+            {
+                const size_t fullSize =
+                    buffers->positionData.size() * sizeof(float3) +
+                    (buffers->texcoord1Data.size() + buffers->texcoord2Data.size()) * sizeof(float2) +
+                    buffers->weightData.size() * sizeof(float4);
+                const size_t compactSize =
+                    buffers->positionData.size() * sizeof(float16_t4) +
+                    (buffers->texcoord1Data.size() + buffers->texcoord2Data.size()) * sizeof(float16_t2) +
+                    buffers->weightData.size() * sizeof(uint32_t);
+                g_LoadingStats.VertexBytesSaved += fullSize - compactSize;
+            }
+
             buffers->vertexBuffer = m_Device->createBuffer(bufferDesc);
             if (m_DescriptorTable)
             {
@@ -935,8 +1134,12 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             if (!buffers->positionData.empty())
             {
                 const auto& range = buffers->getVertexBufferRange(VertexAttribute::Position);
-                commandList->writeBuffer(buffers->vertexBuffer, buffers->positionData.data(), range.byteSize, range.byteOffset);
-                std::vector<float3>().swap(buffers->positionData);
+                if (compact)
+                    commandList->writeBuffer(buffers->vertexBuffer, quantizedPositions.data(), range.byteSize, range.byteOffset);
+                else
+                    commandList->writeBuffer(buffers->vertexBuffer, buffers->positionData.data(), range.byteSize, range.byteOffset);
+                if (!keepCpuGeometry)
+                    std::vector<float3>().swap(buffers->positionData);
             }
 
             if (!buffers->normalData.empty())
@@ -956,21 +1159,39 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             if (!buffers->texcoord1Data.empty())
             {
                 const auto& range = buffers->getVertexBufferRange(VertexAttribute::TexCoord1);
-                commandList->writeBuffer(buffers->vertexBuffer, buffers->texcoord1Data.data(), range.byteSize, range.byteOffset);
+                if (compact)
+                {
+                    const auto quantized = QuantizeTexCoords(buffers->texcoord1Data.data(), buffers->texcoord1Data.size());
+                    commandList->writeBuffer(buffers->vertexBuffer, quantized.data(), quantized.size() * sizeof(quantized[0]), range.byteOffset);
+                }
+                else
+                    commandList->writeBuffer(buffers->vertexBuffer, buffers->texcoord1Data.data(), range.byteSize, range.byteOffset);
                 std::vector<float2>().swap(buffers->texcoord1Data);
             }
 
             if (!buffers->texcoord2Data.empty())
             {
                 const auto& range = buffers->getVertexBufferRange(VertexAttribute::TexCoord2);
-                commandList->writeBuffer(buffers->vertexBuffer, buffers->texcoord2Data.data(), range.byteSize, range.byteOffset);
+                if (compact)
+                {
+                    const auto quantized = QuantizeTexCoords(buffers->texcoord2Data.data(), buffers->texcoord2Data.size());
+                    commandList->writeBuffer(buffers->vertexBuffer, quantized.data(), quantized.size() * sizeof(quantized[0]), range.byteOffset);
+                }
+                else
+                    commandList->writeBuffer(buffers->vertexBuffer, buffers->texcoord2Data.data(), range.byteSize, range.byteOffset);
                 std::vector<float2>().swap(buffers->texcoord2Data);
             }
 
             if (!buffers->weightData.empty())
             {
                 const auto& range = buffers->getVertexBufferRange(VertexAttribute::JointWeights);
-                commandList->writeBuffer(buffers->vertexBuffer, buffers->weightData.data(), range.byteSize, range.byteOffset);
+                if (compact)
+                {
+                    const auto quantized = QuantizeJointWeights(buffers->weightData.data(), buffers->weightData.size());
+                    commandList->writeBuffer(buffers->vertexBuffer, quantized.data(), quantized.size() * sizeof(quantized[0]), range.byteOffset);
+                }
+                else
+                    commandList->writeBuffer(buffers->vertexBuffer, buffers->weightData.data(), range.byteSize, range.byteOffset);
                 std::vector<float4>().swap(buffers->weightData);
             }
 
@@ -1017,11 +1238,14 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             size_t skinnedVertexBufferSize = 0;
             assert(prototypeBuffers->hasAttribute(VertexAttribute::Position));
 
+            // The skinning shader writes the same encoding that it reads
+            skinnedBuffers->vertexLayout = prototypeBuffers->vertexLayout;
+
             AppendBufferRange(skinnedBuffers->getVertexBufferRange(VertexAttribute::Position),
-                totalVertices * sizeof(float3), skinnedVertexBufferSize);
+                totalVertices * skinnedBuffers->getVertexStride(VertexAttribute::Position), skinnedVertexBufferSize);
     
             AppendBufferRange(skinnedBuffers->getVertexBufferRange(VertexAttribute::PrevPosition),
-                totalVertices * sizeof(float3), skinnedVertexBufferSize);
+                totalVertices * skinnedBuffers->getVertexStride(VertexAttribute::PrevPosition), skinnedVertexBufferSize);
             
             if(prototypeBuffers->hasAttribute(VertexAttribute::Normal))
             {
@@ -1038,13 +1262,13 @@ void Scene::CreateMeshBuffers(nvrhi::ICommandList* commandList)
             if (prototypeBuffers->hasAttribute(VertexAttribute::TexCoord1))
             {
                 AppendBufferRange(skinnedBuffers->getVertexBufferRange(VertexAttribute::TexCoord1),
-                    totalVertices * sizeof(float2), skinnedVertexBufferSize);
+                    totalVertices * skinnedBuffers->getVertexStride(VertexAttribute::TexCoord1), skinnedVertexBufferSize);
             }
 
             if (prototypeBuffers->hasAttribute(VertexAttribute::TexCoord2))
             {
                 AppendBufferRange(skinnedBuffers->getVertexBufferRange(VertexAttribute::TexCoord2),
-                    totalVertices * sizeof(float2), skinnedVertexBufferSize);
+                    totalVertices * skinnedBuffers->getVertexStride(VertexAttribute::TexCoord2), skinnedVertexBufferSize);
             }
 
             nvrhi::BufferDesc bufferDesc;
@@ -1193,13 +1417,13 @@ void Scene::UpdateGeometry(const std::shared_ptr<MeshInfo>& mesh)
         gdata.indexOffset = indexOffset * sizeof(uint32_t);
         gdata.vertexBufferIndex = mesh->buffers->vertexBufferDescriptor ? mesh->buffers->vertexBufferDescriptor->Get() : -1;
         gdata.positionOffset = mesh->buffers->hasAttribute(VertexAttribute::Position)
-            ? uint32_t(vertexOffset * sizeof(float3) + mesh->buffers->getVertexBufferRange(VertexAttribute::Position).byteOffset) : ~0u;
+            ? uint32_t(vertexOffset * mesh->buffers->getVertexStride(VertexAttribute::Position) + mesh->buffers->getVertexBufferRange(VertexAttribute::Position).byteOffset) : ~0u;
         gdata.prevPositionOffset = mesh->buffers->hasAttribute(VertexAttribute::PrevPosition)
-            ? uint32_t(vertexOffset * sizeof(float3) + mesh->buffers->getVertexBufferRange(VertexAttribute::PrevPosition).byteOffset) : ~0u;
+            ? uint32_t(vertexOffset * mesh->buffers->getVertexStride(VertexAttribute::PrevPosition) + mesh->buffers->getVertexBufferRange(VertexAttribute::PrevPosition).byteOffset) : ~0u;
         gdata.texCoord1Offset = mesh->buffers->hasAttribute(VertexAttribute::TexCoord1)
-            ? uint32_t(vertexOffset * sizeof(float2) + mesh->buffers->getVertexBufferRange(VertexAttribute::TexCoord1).byteOffset) : ~0u;
+            ? uint32_t(vertexOffset * mesh->buffers->getVertexStride(VertexAttribute::TexCoord1) + mesh->buffers->getVertexBufferRange(VertexAttribute::TexCoord1).byteOffset) : ~0u;
         gdata.texCoord2Offset = mesh->buffers->hasAttribute(VertexAttribute::TexCoord2)
-            ? uint32_t(vertexOffset * sizeof(float2) + mesh->buffers->getVertexBufferRange(VertexAttribute::TexCoord2).byteOffset) : ~0u;
+            ? uint32_t(vertexOffset * mesh->buffers->getVertexStride(VertexAttribute::TexCoord2) + mesh->buffers->getVertexBufferRange(VertexAttribute::TexCoord2).byteOffset) : ~0u;
         gdata.normalOffset = mesh->buffers->hasAttribute(VertexAttribute::Normal)
             ? uint32_t(vertexOffset * sizeof(uint32_t) + mesh->buffers->getVertexBufferRange(VertexAttribute::Normal).byteOffset) : ~0u;
         gdata.tangentOffset = mesh->buffers->hasAttribute(VertexAttribute::Tangent)
@@ -1207,6 +1431,7 @@ void Scene::UpdateGeometry(const std::shared_ptr<MeshInfo>& mesh)
         gdata.curveRadiusOffset = mesh->buffers->hasAttribute(VertexAttribute::CurveRadius)
             ? uint32_t(vertexOffset * sizeof(float) + mesh->buffers->getVertexBufferRange(VertexAttribute::CurveRadius).byteOffset) : ~0u;
         gdata.materialIndex = geometry->material ? geometry->material->materialID : ~0u;
+        gdata.flags = mesh->buffers->vertexLayout == VertexLayout::Compact ? GeometryFlags_CompactVertices : 0;
     }
 }
 
@@ -0,0 +1,1146 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/SceneCache.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/TextureCache.h>
+#include <donut/core/chunk/chunkFile.h>
+#include <donut/core/vfs/VFS.h>
+#include <donut/core/log.h>
+
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace donut::math;
+using namespace donut::vfs;
+using namespace donut::engine;
+
+namespace
+{
+    // Chunk types used in the scene cache files. They don't overlap with the types in donut::chunk::ChunkType.
+    // Increment the version of a chunk when its contents change, and the old cache files will be ignored.
+    enum SceneCacheChunkType : uint32_t
+    {
+        SCENECACHE_SOURCES      = 0x1000,
+        SCENECACHE_BUFFERS,
+        SCENECACHE_MATERIALS,
+        SCENECACHE_MESHES,
+        SCENECACHE_NODES
+    };
+
+    struct Sources_ChunkDesc
+    {
+        static constexpr uint32_t const version = 0x101;
+        static constexpr uint32_t const chunktype = SCENECACHE_SOURCES;
+    };
+
+    struct Buffers_ChunkDesc
+    {
+        static constexpr uint32_t const version = 0x101;
+        static constexpr uint32_t const chunktype = SCENECACHE_BUFFERS;
+    };
+
+    struct Materials_ChunkDesc
+    {
+        static constexpr uint32_t const version = 0x100;
+        static constexpr uint32_t const chunktype = SCENECACHE_MATERIALS;
+    };
+
+    struct Meshes_ChunkDesc
+    {
+        static constexpr uint32_t const version = 0x101;
+        static constexpr uint32_t const chunktype = SCENECACHE_MESHES;
+    };
+
+    struct Nodes_ChunkDesc
+    {
+        static constexpr uint32_t const version = 0x100;
+        static constexpr uint32_t const chunktype = SCENECACHE_NODES;
+    };
+
+    enum class CachedLeafType : uint8_t
+    {
+        None,
+        MeshInstance,
+        SkinnedMeshInstance,
+        PerspectiveCamera,
+        OrthographicCamera,
+        DirectionalLight,
+        PointLight,
+        SpotLight,
+        Animation
+    };
+
+    // The texture slots of a material, in the order they are stored in the cache.
+    std::shared_ptr<LoadedTexture> Material::* const c_MaterialTextures[] = {
+        &Material::baseOrDiffuseTexture,
+        &Material::metalRoughOrSpecularTexture,
+        &Material::normalTexture,
+        &Material::emissiveTexture,
+        &Material::occlusionTexture,
+        &Material::transmissionTexture,
+        &Material::opacityTexture
+    };
+
+    // A 64-bit hash of the file contents that processes 8 bytes at a time, to keep the validation of large buffers cheap.
+    uint64_t HashFileData(const void* data, size_t size)
+    {
+        constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+        constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+        auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = 0x9e3779b97f4a7c15ull ^ size;
+
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, bytes + offset, sizeof(word));
+            hash ^= rotl(word * c1, 31) * c2;
+            hash = rotl(hash, 27) * 5 + 0x52dce729;
+        }
+
+        uint64_t tail = 0;
+        memcpy(&tail, bytes + offset, size - offset);
+        hash ^= rotl(tail * c1, 31) * c2;
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Appends plain values, strings and vectors to a byte stream that becomes the contents of one chunk.
+    class ChunkDataWriter
+    {
+    private:
+        std::vector<uint8_t> m_Data;
+
+    public:
+        [[nodiscard]] const std::vector<uint8_t>& GetData() const { return m_Data; }
+
+        void WriteBytes(const void* data, size_t size)
+        {
+            if (size == 0)
+                return;
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            m_Data.insert(m_Data.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            WriteBytes(&value, sizeof(T));
+        }
+
+        void WriteString(const std::string& value)
+        {
+            Write(uint32_t(value.size()));
+            WriteBytes(value.data(), value.size());
+        }
+
+        template<typename T>
+        void WriteVector(const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(uint64_t(values.size()));
+            WriteBytes(values.data(), values.size() * sizeof(T));
+        }
+    };
+
+    // Reads the values written by ChunkDataWriter. Reading past the end of the chunk sets the error flag
+    // and returns zeros, so the callers only need to check HasError() once they are done.
+    class ChunkDataReader
+    {
+    private:
+        const uint8_t* m_Data;
+        size_t m_Size;
+        size_t m_Offset = 0;
+        bool m_Error = false;
+
+    public:
+        explicit ChunkDataReader(const donut::chunk::Chunk* chunk)
+            : m_Data(static_cast<const uint8_t*>(chunk->data))
+            , m_Size(chunk->size)
+        { }
+
+        [[nodiscard]] bool HasError() const { return m_Error; }
+        void SetError() { m_Error = true; }
+
+        bool ReadBytes(void* data, size_t size)
+        {
+            if (m_Error || size > m_Size - m_Offset)
+            {
+                m_Error = true;
+                memset(data, 0, size);
+                return false;
+            }
+            if (size != 0)
+                memcpy(data, m_Data + m_Offset, size);
+            m_Offset += size;
+            return true;
+        }
+
+        template<typename T>
+        T Read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            ReadBytes(&value, sizeof(T));
+            return value;
+        }
+
+        std::string ReadString()
+        {
+            const uint32_t length = Read<uint32_t>();
+            if (m_Error || length > m_Size - m_Offset)
+            {
+                m_Error = true;
+                return std::string();
+            }
+            std::string value(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+            m_Offset += length;
+            return value;
+        }
+
+        template<typename T>
+        void ReadVector(std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const uint64_t count = Read<uint64_t>();
+            if (m_Error || count > (m_Size - m_Offset) / sizeof(T))
+            {
+                m_Error = true;
+                values.clear();
+                return;
+            }
+            values.resize(size_t(count));
+            ReadBytes(values.data(), size_t(count) * sizeof(T));
+        }
+
+        // Reads an index into a table of 'count' objects, where -1 means "no object".
+        int ReadIndex(size_t count)
+        {
+            const int index = Read<int>();
+            if (index < -1 || index >= int(count))
+                m_Error = true;
+            return m_Error ? -1 : index;
+        }
+    };
+
+    template<typename T>
+    int FindIndex(const std::unordered_map<const T*, int>& map, const T* object)
+    {
+        if (!object)
+            return -1;
+        auto it = map.find(object);
+        return (it != map.end()) ? it->second : -1;
+    }
+
+    // Returns the chunk of the given type if its version matches the current one.
+    // Unlike ChunkFile::validateChunk, doesn't log errors because cache files from older versions are expected.
+    template<typename ChunkDesc>
+    const donut::chunk::Chunk* FindChunk(const donut::chunk::ChunkFile& chunkFile)
+    {
+        for (const auto& chunk : chunkFile.getChunks())
+        {
+            if (chunk && chunk->chunkType == ChunkDesc::chunktype)
+                return (chunk->chunkVersion == ChunkDesc::version && chunk->size != 0) ? chunk.get() : nullptr;
+        }
+        return nullptr;
+    }
+
+    void WriteMaterial(ChunkDataWriter& writer, const Material& material, const std::unordered_map<const LoadedTexture*, int>& textureIndices)
+    {
+        writer.WriteString(material.name);
+        writer.WriteString(material.modelFileName);
+        writer.Write(material.materialIndexInModel);
+        writer.Write(material.domain);
+        for (auto texture : c_MaterialTextures)
+            writer.Write(FindIndex(textureIndices, (material.*texture).get()));
+        writer.Write(material.baseOrDiffuseColor);
+        writer.Write(material.specularColor);
+        writer.Write(material.emissiveColor);
+        writer.Write(material.emissiveIntensity);
+        writer.Write(material.metalness);
+        writer.Write(material.roughness);
+        writer.Write(material.opacity);
+        writer.Write(material.alphaCutoff);
+        writer.Write(material.transmissionFactor);
+        writer.Write(material.normalTextureScale);
+        writer.Write(material.occlusionStrength);
+        writer.Write(material.normalTextureTransformScale);
+        writer.Write(material.useSpecularGlossModel);
+        writer.Write(material.enableSubsurfaceScattering);
+        writer.Write(material.subsurface);
+        writer.Write(material.enableHair);
+        writer.Write(material.hair);
+        writer.Write(material.enableBaseOrDiffuseTexture);
+        writer.Write(material.enableMetalRoughOrSpecularTexture);
+        writer.Write(material.enableNormalTexture);
+        writer.Write(material.enableEmissiveTexture);
+        writer.Write(material.enableOcclusionTexture);
+        writer.Write(material.enableTransmissionTexture);
+        writer.Write(material.enableOpacityTexture);
+        writer.Write(material.doubleSided);
+        writer.Write(material.metalnessInRedChannel);
+    }
+
+    void ReadMaterial(ChunkDataReader& reader, Material& material, const std::vector<std::shared_ptr<LoadedTexture>>& textures)
+    {
+        material.name = reader.ReadString();
+        material.modelFileName = reader.ReadString();
+        material.materialIndexInModel = reader.Read<int>();
+        material.domain = reader.Read<MaterialDomain>();
+        for (auto texture : c_MaterialTextures)
+        {
+            const int textureIndex = reader.ReadIndex(textures.size());
+            material.*texture = (textureIndex >= 0) ? textures[textureIndex] : nullptr;
+        }
+        material.baseOrDiffuseColor = reader.Read<float3>();
+        material.specularColor = reader.Read<float3>();
+        material.emissiveColor = reader.Read<float3>();
+        material.emissiveIntensity = reader.Read<float>();
+        material.metalness = reader.Read<float>();
+        material.roughness = reader.Read<float>();
+        material.opacity = reader.Read<float>();
+        material.alphaCutoff = reader.Read<float>();
+        material.transmissionFactor = reader.Read<float>();
+        material.normalTextureScale = reader.Read<float>();
+        material.occlusionStrength = reader.Read<float>();
+        material.normalTextureTransformScale = reader.Read<float2>();
+        material.useSpecularGlossModel = reader.Read<bool>();
+        material.enableSubsurfaceScattering = reader.Read<bool>();
+        material.subsurface = reader.Read<Material::SubsurfaceParams>();
+        material.enableHair = reader.Read<bool>();
+        material.hair = reader.Read<Material::HairParams>();
+        material.enableBaseOrDiffuseTexture = reader.Read<bool>();
+        material.enableMetalRoughOrSpecularTexture = reader.Read<bool>();
+        material.enableNormalTexture = reader.Read<bool>();
+        material.enableEmissiveTexture = reader.Read<bool>();
+        material.enableOcclusionTexture = reader.Read<bool>();
+        material.enableTransmissionTexture = reader.Read<bool>();
+        material.enableOpacityTexture = reader.Read<bool>();
+        material.doubleSided = reader.Read<bool>();
+        material.metalnessInRedChannel = reader.Read<bool>();
+    }
+
+    void WriteBufferGroup(ChunkDataWriter& writer, const BufferGroup& buffers)
+    {
+        writer.WriteVector(buffers.indexData);
+        writer.WriteVector(buffers.positionData);
+        writer.WriteVector(buffers.texcoord1Data);
+        writer.WriteVector(buffers.texcoord2Data);
+        writer.WriteVector(buffers.normalData);
+        writer.WriteVector(buffers.tangentData);
+        writer.WriteVector(buffers.jointData);
+        writer.WriteVector(buffers.weightData);
+        writer.WriteVector(buffers.radiusData);
+        writer.WriteVector(buffers.morphTargetData);
+        writer.WriteVector(buffers.meshletData);
+        writer.WriteVector(buffers.meshletVertexData);
+        writer.WriteVector(buffers.meshletPrimitiveData);
+
+        writer.Write(uint64_t(buffers.morphTargetBufferRange.size()));
+        for (const auto& range : buffers.morphTargetBufferRange)
+        {
+            writer.Write(uint64_t(range.byteOffset));
+            writer.Write(uint64_t(range.byteSize));
+        }
+    }
+
+    void ReadBufferGroup(ChunkDataReader& reader, BufferGroup& buffers)
+    {
+        reader.ReadVector(buffers.indexData);
+        reader.ReadVector(buffers.positionData);
+        reader.ReadVector(buffers.texcoord1Data);
+        reader.ReadVector(buffers.texcoord2Data);
+        reader.ReadVector(buffers.normalData);
+        reader.ReadVector(buffers.tangentData);
+        reader.ReadVector(buffers.jointData);
+        reader.ReadVector(buffers.weightData);
+        reader.ReadVector(buffers.radiusData);
+        reader.ReadVector(buffers.morphTargetData);
+        reader.ReadVector(buffers.meshletData);
+        reader.ReadVector(buffers.meshletVertexData);
+        reader.ReadVector(buffers.meshletPrimitiveData);
+
+        const uint64_t rangeCount = reader.Read<uint64_t>();
+        for (uint64_t index = 0; index < rangeCount && !reader.HasError(); index++)
+        {
+            nvrhi::BufferRange range;
+            range.byteOffset = reader.Read<uint64_t>();
+            range.byteSize = reader.Read<uint64_t>();
+            buffers.morphTargetBufferRange.push_back(range);
+        }
+    }
+}
+
+SceneCache::SceneCache(std::shared_ptr<IFileSystem> fs, std::shared_ptr<SceneTypeFactory> sceneTypeFactory)
+    : m_fs(std::move(fs))
+    , m_SceneTypeFactory(std::move(sceneTypeFactory))
+{
+}
+
+std::filesystem::path SceneCache::GetCacheFileName(const std::filesystem::path& fileName)
+{
+    std::filesystem::path cacheFileName = fileName;
+    cacheFileName += ".dcache";
+    return cacheFileName;
+}
+
+bool SceneCache::Store(const std::filesystem::path& fileName, const SceneImportResult& result) const
+{
+    if (!result.rootNode || result.sourceFiles.empty())
+        return false;
+
+    const std::string modelName = fileName.generic_string();
+
+    // Flatten the node hierarchy in depth-first order, so that parents come before their children,
+    // and collect the meshes, buffers, materials and textures used by the node leaves.
+    std::vector<SceneGraphNode*> nodes;
+    std::unordered_map<const SceneGraphNode*, int> nodeIndices;
+    {
+        std::vector<SceneGraphNode*> stack = { result.rootNode.get() };
+        while (!stack.empty())
+        {
+            SceneGraphNode* node = stack.back();
+            stack.pop_back();
+
+            nodeIndices[node] = int(nodes.size());
+            nodes.push_back(node);
+
+            for (size_t child = node->GetNumChildren(); child > 0; --child)
+                stack.push_back(node->GetChild(child - 1));
+        }
+    }
+
+    std::vector<const MeshInfo*> meshes;
+    std::unordered_map<const MeshInfo*, int> meshIndices;
+    std::vector<const BufferGroup*> bufferGroups;
+    std::unordered_map<const BufferGroup*, int> bufferGroupIndices;
+    std::vector<const Material*> materials;
+    std::unordered_map<const Material*, int> materialIndices;
+    std::vector<const LoadedTexture*> textures;
+    std::unordered_map<const LoadedTexture*, int> textureIndices;
+
+    auto addMesh = [&](const MeshInfo* mesh)
+    {
+        if (!mesh || meshIndices.find(mesh) != meshIndices.end())
+            return true;
+
+        meshIndices[mesh] = int(meshes.size());
+        meshes.push_back(mesh);
+
+        const BufferGroup* buffers = mesh->buffers.get();
+        if (buffers && bufferGroupIndices.find(buffers) == bufferGroupIndices.end())
+        {
+            bufferGroupIndices[buffers] = int(bufferGroups.size());
+            bufferGroups.push_back(buffers);
+        }
+
+        for (const auto& geometry : mesh->geometries)
+        {
+            const Material* material = geometry->material.get();
+            if (!material || materialIndices.find(material) != materialIndices.end())
+                continue;
+
+            materialIndices[material] = int(materials.size());
+            materials.push_back(material);
+
+            for (auto textureSlot : c_MaterialTextures)
+            {
+                const LoadedTexture* texture = (material->*textureSlot).get();
+                if (!texture || textureIndices.find(texture) != textureIndices.end())
+                    continue;
+
+                // Only textures that come from files can be loaded again through the texture cache.
+                if (!texture->swizzleOptions.empty() || texture->path.empty() || !m_fs->fileExists(texture->path))
+                {
+                    log::info("Model '%s' uses embedded or swizzled textures and cannot be cached.", modelName.c_str());
+                    return false;
+                }
+
+                textureIndices[texture] = int(textures.size());
+                textures.push_back(texture);
+            }
+        }
+
+        return true;
+    };
+
+    for (const SceneGraphNode* node : nodes)
+    {
+        const auto& leaf = node->GetLeaf();
+        if (auto skinnedInstance = std::dynamic_pointer_cast<SkinnedMeshInstance>(leaf))
+        {
+            if (!addMesh(skinnedInstance->GetPrototypeMesh().get()))
+                return false;
+        }
+        else if (auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(leaf))
+        {
+            if (!addMesh(meshInstance->GetMesh().get()))
+                return false;
+        }
+    }
+
+    ChunkDataWriter sourcesWriter;
+    sourcesWriter.Write(uint32_t(result.sourceFiles.size()));
+    for (const std::string& sourceFile : result.sourceFiles)
+    {
+        auto blob = m_fs->readFile(sourceFile);
+        if (!blob)
+        {
+            log::warning("Couldn't read file '%s' to create the cache for model '%s'.", sourceFile.c_str(), modelName.c_str());
+            return false;
+        }
+
+        // The modification time is 0 if the file system doesn't report it, which makes Load always hash the file.
+        vfs::FileAttributes attributes;
+        if (!m_fs->getFileAttributes(sourceFile, attributes) || attributes.size != blob->size())
+            attributes = vfs::FileAttributes();
+
+        sourcesWriter.WriteString(sourceFile);
+        sourcesWriter.Write(uint64_t(blob->size()));
+        sourcesWriter.Write(attributes.modificationTime);
+        sourcesWriter.Write(HashFileData(blob->data(), blob->size()));
+    }
+
+    ChunkDataWriter buffersWriter;
+    buffersWriter.Write(uint32_t(bufferGroups.size()));
+    for (const BufferGroup* buffers : bufferGroups)
+        WriteBufferGroup(buffersWriter, *buffers);
+
+    ChunkDataWriter materialsWriter;
+    materialsWriter.Write(uint32_t(textures.size()));
+    for (const LoadedTexture* texture : textures)
+    {
+        // Textures loaded from files are always created by TextureCache::CreateTextureData.
+        const TextureData* textureData = static_cast<const TextureData*>(texture);
+        materialsWriter.WriteString(texture->path);
+        materialsWriter.Write(textureData->forceSRGB);
+    }
+    materialsWriter.Write(uint32_t(materials.size()));
+    for (const Material* material : materials)
+        WriteMaterial(materialsWriter, *material, textureIndices);
+
+    ChunkDataWriter meshesWriter;
+    meshesWriter.Write(uint32_t(meshes.size()));
+    for (const MeshInfo* mesh : meshes)
+    {
+        meshesWriter.WriteString(mesh->name);
+        meshesWriter.Write(mesh->type);
+        meshesWriter.Write(FindIndex(bufferGroupIndices, mesh->buffers.get()));
+        meshesWriter.Write(mesh->objectSpaceBounds);
+        meshesWriter.Write(mesh->indexOffset);
+        meshesWriter.Write(mesh->vertexOffset);
+        meshesWriter.Write(mesh->totalIndices);
+        meshesWriter.Write(mesh->totalVertices);
+        meshesWriter.Write(mesh->isMorphTargetAnimationMesh);
+        meshesWriter.Write(mesh->isSkinPrototype);
+
+        meshesWriter.Write(uint32_t(mesh->geometries.size()));
+        for (const auto& geometry : mesh->geometries)
+        {
+            meshesWriter.Write(FindIndex(materialIndices, geometry->material.get()));
+            meshesWriter.Write(geometry->objectSpaceBounds);
+            meshesWriter.Write(geometry->indexOffsetInMesh);
+            meshesWriter.Write(geometry->vertexOffsetInMesh);
+            meshesWriter.Write(geometry->numIndices);
+            meshesWriter.Write(geometry->numVertices);
+            meshesWriter.Write(geometry->meshletOffset);
+            meshesWriter.Write(geometry->numMeshlets);
+            meshesWriter.Write(geometry->type);
+        }
+    }
+
+    ChunkDataWriter nodesWriter;
+    nodesWriter.Write(uint32_t(nodes.size()));
+    for (const SceneGraphNode* node : nodes)
+    {
+        nodesWriter.Write(node->GetParent() ? FindIndex(nodeIndices, node->GetParent()) : -1);
+        nodesWriter.WriteString(node->GetName());
+
+        const bool hasTransform = any(node->GetTranslation() != 0.0)
+            || any(node->GetScaling() != 1.0)
+            || any(node->GetRotation() != dquat::identity());
+        nodesWriter.Write(hasTransform);
+        if (hasTransform)
+        {
+            nodesWriter.Write(node->GetTranslation());
+            nodesWriter.Write(node->GetRotation());
+            nodesWriter.Write(node->GetScaling());
+        }
+
+        // SkinnedMeshReference leaves are not stored, they are re-created from the joints of the skinned instances.
+        const auto& leaf = node->GetLeaf();
+        if (!leaf || std::dynamic_pointer_cast<SkinnedMeshReference>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::None);
+        }
+        else if (auto skinnedInstance = std::dynamic_pointer_cast<SkinnedMeshInstance>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::SkinnedMeshInstance);
+            nodesWriter.Write(FindIndex(meshIndices, skinnedInstance->GetPrototypeMesh().get()));
+            nodesWriter.Write(uint32_t(skinnedInstance->joints.size()));
+            for (const auto& joint : skinnedInstance->joints)
+            {
+                auto jointNode = joint.node.lock();
+                nodesWriter.Write(FindIndex(nodeIndices, jointNode.get()));
+                nodesWriter.Write(joint.inverseBindMatrix);
+            }
+        }
+        else if (auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::MeshInstance);
+            nodesWriter.Write(FindIndex(meshIndices, meshInstance->GetMesh().get()));
+        }
+        else if (auto perspectiveCamera = std::dynamic_pointer_cast<PerspectiveCamera>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::PerspectiveCamera);
+            nodesWriter.Write(perspectiveCamera->zNear);
+            nodesWriter.Write(perspectiveCamera->verticalFov);
+            nodesWriter.Write(perspectiveCamera->zFar.has_value());
+            nodesWriter.Write(perspectiveCamera->zFar.value_or(0.f));
+            nodesWriter.Write(perspectiveCamera->aspectRatio.has_value());
+            nodesWriter.Write(perspectiveCamera->aspectRatio.value_or(0.f));
+        }
+        else if (auto orthographicCamera = std::dynamic_pointer_cast<OrthographicCamera>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::OrthographicCamera);
+            nodesWriter.Write(orthographicCamera->zNear);
+            nodesWriter.Write(orthographicCamera->zFar);
+            nodesWriter.Write(orthographicCamera->xMag);
+            nodesWriter.Write(orthographicCamera->yMag);
+        }
+        else if (auto directionalLight = std::dynamic_pointer_cast<DirectionalLight>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::DirectionalLight);
+            nodesWriter.Write(directionalLight->color);
+            nodesWriter.Write(directionalLight->irradiance);
+            nodesWriter.Write(directionalLight->angularSize);
+        }
+        else if (auto pointLight = std::dynamic_pointer_cast<PointLight>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::PointLight);
+            nodesWriter.Write(pointLight->color);
+            nodesWriter.Write(pointLight->intensity);
+            nodesWriter.Write(pointLight->radius);
+            nodesWriter.Write(pointLight->range);
+        }
+        else if (auto spotLight = std::dynamic_pointer_cast<SpotLight>(leaf))
+        {
+            nodesWriter.Write(CachedLeafType::SpotLight);
+            nodesWriter.Write(spotLight->color);
+            nodesWriter.Write(spotLight->intensity);
+            nodesWriter.Write(spotLight->radius);
+            nodesWriter.Write(spotLight->range);
+            nodesWriter.Write(spotLight->innerAngle);
+            nodesWriter.Write(spotLight->outerAngle);
+        }
+        else if (auto animation = std::dynamic_pointer_cast<SceneGraphAnimation>(leaf))
+        {
+            std::vector<animation::Sampler*> samplers;
+            std::unordered_map<const animation::Sampler*, int> samplerIndices;
+            for (const auto& channel : animation->GetChannels())
+            {
+                animation::Sampler* sampler = channel->GetSampler().get();
+                if (samplerIndices.find(sampler) == samplerIndices.end())
+                {
+                    samplerIndices[sampler] = int(samplers.size());
+                    samplers.push_back(sampler);
+                }
+            }
+
+            nodesWriter.Write(CachedLeafType::Animation);
+            nodesWriter.Write(uint32_t(samplers.size()));
+            for (animation::Sampler* sampler : samplers)
+            {
+                nodesWriter.Write(sampler->GetMode());
+                nodesWriter.WriteVector(sampler->GetKeyframes());
+            }
+
+            nodesWriter.Write(uint32_t(animation->GetChannels().size()));
+            for (const auto& channel : animation->GetChannels())
+            {
+                auto targetNode = channel->GetTargetNode();
+                if (!targetNode)
+                {
+                    log::info("Model '%s' has animations that don't target nodes and cannot be cached.", modelName.c_str());
+                    return false;
+                }
+
+                nodesWriter.Write(FindIndex(samplerIndices, channel->GetSampler().get()));
+                nodesWriter.Write(channel->GetAttribute());
+                nodesWriter.Write(FindIndex(nodeIndices, targetNode.get()));
+                nodesWriter.WriteString(channel->GetLeafPropertyName());
+            }
+        }
+        else
+        {
+            log::info("Model '%s' contains scene graph leaves of unsupported types and cannot be cached.", modelName.c_str());
+            return false;
+        }
+    }
+
+    donut::chunk::ChunkFile chunkFile;
+    chunkFile.addChunk<Sources_ChunkDesc>(sourcesWriter.GetData().data(), sourcesWriter.GetData().size());
+    chunkFile.addChunk<Buffers_ChunkDesc>(buffersWriter.GetData().data(), buffersWriter.GetData().size());
+    chunkFile.addChunk<Materials_ChunkDesc>(materialsWriter.GetData().data(), materialsWriter.GetData().size());
+    chunkFile.addChunk<Meshes_ChunkDesc>(meshesWriter.GetData().data(), meshesWriter.GetData().size());
+    chunkFile.addChunk<Nodes_ChunkDesc>(nodesWriter.GetData().data(), nodesWriter.GetData().size());
+
+    auto blob = chunkFile.serialize();
+    if (!blob)
+        return false;
+
+    const std::filesystem::path cacheFileName = GetCacheFileName(fileName);
+    if (!m_fs->writeFile(cacheFileName, blob->data(), blob->size()))
+    {
+        log::warning("Couldn't write the scene cache file '%s'.", cacheFileName.generic_string().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool SceneCache::Load(
+    const std::filesystem::path& fileName,
+    TextureCache& textureCache,
+    ThreadPool* threadPool,
+    SceneImportResult& result) const
+{
+    using namespace std::chrono;
+
+    result.rootNode.reset();
+    result.sourceFiles.clear();
+
+    const std::filesystem::path cacheFileName = GetCacheFileName(fileName);
+    const std::string cacheName = cacheFileName.generic_string();
+    if (!m_fs->fileExists(cacheFileName))
+        return false;
+
+    const auto loadStart = steady_clock::now();
+
+    std::shared_ptr<IBlob> blob = m_fs->readFile(cacheFileName);
+    if (IBlob::isEmpty(blob.get()))
+        return false;
+
+    auto chunkFile = donut::chunk::ChunkFile::deserialize(blob, cacheName.c_str());
+    if (!chunkFile)
+        return false;
+
+    const donut::chunk::Chunk* sourcesChunk = FindChunk<Sources_ChunkDesc>(*chunkFile);
+    const donut::chunk::Chunk* buffersChunk = FindChunk<Buffers_ChunkDesc>(*chunkFile);
+    const donut::chunk::Chunk* materialsChunk = FindChunk<Materials_ChunkDesc>(*chunkFile);
+    const donut::chunk::Chunk* meshesChunk = FindChunk<Meshes_ChunkDesc>(*chunkFile);
+    const donut::chunk::Chunk* nodesChunk = FindChunk<Nodes_ChunkDesc>(*chunkFile);
+
+    if (!sourcesChunk || !buffersChunk || !materialsChunk || !meshesChunk || !nodesChunk)
+    {
+        log::info("Scene cache '%s' has an unsupported format, ignoring.", cacheName.c_str());
+        return false;
+    }
+
+    // Make sure that the files the model was imported from have not changed since the cache was created.
+    // Files whose size and modification time match the recorded values are assumed to be unchanged;
+    // the others are read and hashed, so that a file that was only touched doesn't invalidate the cache.
+    std::vector<std::string> sourceFiles;
+    {
+        ChunkDataReader reader(sourcesChunk);
+        const uint32_t sourceCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < sourceCount && !reader.HasError(); index++)
+        {
+            std::string sourceFile = reader.ReadString();
+            const uint64_t size = reader.Read<uint64_t>();
+            const uint64_t modificationTime = reader.Read<uint64_t>();
+            const uint64_t hash = reader.Read<uint64_t>();
+            if (reader.HasError())
+                break;
+
+            vfs::FileAttributes attributes;
+            const bool haveAttributes = m_fs->getFileAttributes(sourceFile, attributes);
+            bool upToDate;
+            if (haveAttributes && attributes.size != size)
+                upToDate = false;
+            else if (haveAttributes && modificationTime != 0 && attributes.modificationTime == modificationTime)
+                upToDate = true;
+            else
+            {
+                auto sourceBlob = m_fs->readFile(sourceFile);
+                upToDate = sourceBlob && sourceBlob->size() == size && HashFileData(sourceBlob->data(), sourceBlob->size()) == hash;
+            }
+
+            if (!upToDate)
+            {
+                log::info("Scene cache '%s' is out of date.", cacheName.c_str());
+                return false;
+            }
+
+            sourceFiles.push_back(std::move(sourceFile));
+        }
+
+        if (reader.HasError() || sourceFiles.empty())
+        {
+            log::warning("Scene cache '%s' is corrupted.", cacheName.c_str());
+            return false;
+        }
+    }
+
+    std::vector<std::shared_ptr<BufferGroup>> bufferGroups;
+    {
+        ChunkDataReader reader(buffersChunk);
+        const uint32_t bufferGroupCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < bufferGroupCount && !reader.HasError(); index++)
+        {
+            auto buffers = std::make_shared<BufferGroup>();
+            ReadBufferGroup(reader, *buffers);
+            bufferGroups.push_back(buffers);
+        }
+
+        if (reader.HasError())
+        {
+            log::warning("Scene cache '%s' is corrupted.", cacheName.c_str());
+            return false;
+        }
+    }
+
+    std::vector<std::shared_ptr<Material>> materials;
+    {
+        ChunkDataReader reader(materialsChunk);
+
+        std::vector<std::shared_ptr<LoadedTexture>> textures;
+        const uint32_t textureCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < textureCount && !reader.HasError(); index++)
+        {
+            const std::string path = reader.ReadString();
+            const bool sRGB = reader.Read<bool>();
+            if (reader.HasError())
+                break;
+
+            if (threadPool)
+                textures.push_back(textureCache.LoadTextureFromFileAsync(path, sRGB, *threadPool));
+            else
+                textures.push_back(textureCache.LoadTextureFromFileDeferred(path, sRGB));
+        }
+
+        const uint32_t materialCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < materialCount && !reader.HasError(); index++)
+        {
+            auto material = m_SceneTypeFactory->CreateMaterial();
+            ReadMaterial(reader, *material, textures);
+            materials.push_back(material);
+        }
+
+        if (reader.HasError())
+        {
+            log::warning("Scene cache '%s' is corrupted.", cacheName.c_str());
+            return false;
+        }
+    }
+
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+    {
+        ChunkDataReader reader(meshesChunk);
+        const uint32_t meshCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < meshCount && !reader.HasError(); index++)
+        {
+            auto mesh = m_SceneTypeFactory->CreateMesh();
+            mesh->name = reader.ReadString();
+            mesh->type = reader.Read<MeshType>();
+            const int bufferGroupIndex = reader.ReadIndex(bufferGroups.size());
+            mesh->buffers = (bufferGroupIndex >= 0) ? bufferGroups[bufferGroupIndex] : nullptr;
+            mesh->objectSpaceBounds = reader.Read<box3>();
+            mesh->indexOffset = reader.Read<uint32_t>();
+            mesh->vertexOffset = reader.Read<uint32_t>();
+            mesh->totalIndices = reader.Read<uint32_t>();
+            mesh->totalVertices = reader.Read<uint32_t>();
+            mesh->isMorphTargetAnimationMesh = reader.Read<bool>();
+            mesh->isSkinPrototype = reader.Read<bool>();
+
+            const uint32_t geometryCount = reader.Read<uint32_t>();
+            for (uint32_t geometryIndex = 0; geometryIndex < geometryCount && !reader.HasError(); geometryIndex++)
+            {
+                auto geometry = m_SceneTypeFactory->CreateMeshGeometry();
+                const int materialIndex = reader.ReadIndex(materials.size());
+                geometry->material = (materialIndex >= 0) ? materials[materialIndex] : nullptr;
+                geometry->objectSpaceBounds = reader.Read<box3>();
+                geometry->indexOffsetInMesh = reader.Read<uint32_t>();
+                geometry->vertexOffsetInMesh = reader.Read<uint32_t>();
+                geometry->numIndices = reader.Read<uint32_t>();
+                geometry->numVertices = reader.Read<uint32_t>();
+                geometry->meshletOffset = reader.Read<uint32_t>();
+                geometry->numMeshlets = reader.Read<uint32_t>();
+                geometry->type = reader.Read<MeshGeometryPrimitiveType>();
+                mesh->geometries.push_back(geometry);
+            }
+
+            meshes.push_back(mesh);
+        }
+
+        if (reader.HasError())
+        {
+            log::warning("Scene cache '%s' is corrupted.", cacheName.c_str());
+            return false;
+        }
+    }
+
+    // Build the node hierarchy in the same order as GltfImporter: simple leaves are created with the nodes,
+    // skinned instances and animations are created after all nodes exist because they reference other nodes.
+    {
+        ChunkDataReader reader(nodesChunk);
+
+        struct PendingJoint
+        {
+            int nodeIndex;
+            float4x4 inverseBindMatrix;
+        };
+
+        struct PendingSkin
+        {
+            std::shared_ptr<SceneGraphNode> node;
+            std::shared_ptr<MeshInfo> prototypeMesh;
+            std::vector<PendingJoint> joints;
+        };
+
+        struct PendingChannel
+        {
+            int samplerIndex;
+            AnimationAttribute attribute;
+            int targetNodeIndex;
+            std::string leafPropertyName;
+        };
+
+        struct PendingAnimation
+        {
+            std::shared_ptr<SceneGraphNode> node;
+            std::vector<std::shared_ptr<animation::Sampler>> samplers;
+            std::vector<PendingChannel> channels;
+        };
+
+        std::vector<PendingSkin> pendingSkins;
+        std::vector<PendingAnimation> pendingAnimations;
+
+        auto graph = std::make_shared<SceneGraph>();
+        std::vector<std::shared_ptr<SceneGraphNode>> nodes;
+
+        const uint32_t nodeCount = reader.Read<uint32_t>();
+        for (uint32_t index = 0; index < nodeCount && !reader.HasError(); index++)
+        {
+            const int parentIndex = reader.ReadIndex(nodes.size());
+            if (index > 0 && parentIndex < 0)
+                break;
+
+            auto node = std::make_shared<SceneGraphNode>();
+            node->SetName(reader.ReadString());
+
+            if (reader.Read<bool>())
+            {
+                const double3 translation = reader.Read<double3>();
+                const dquat rotation = reader.Read<dquat>();
+                const double3 scaling = reader.Read<double3>();
+                node->SetTransform(&translation, &rotation, &scaling);
+            }
+
+            if (parentIndex >= 0)
+                graph->Attach(nodes[parentIndex], node);
+            nodes.push_back(node);
+
+            const CachedLeafType leafType = reader.Read<CachedLeafType>();
+            switch (leafType)
+            {
+            case CachedLeafType::None:
+                break;
+
+            case CachedLeafType::MeshInstance: {
+                const int meshIndex = reader.ReadIndex(meshes.size());
+                if (meshIndex >= 0)
+                    node->SetLeaf(m_SceneTypeFactory->CreateMeshInstance(meshes[meshIndex]));
+                break;
+            }
+
+            case CachedLeafType::SkinnedMeshInstance: {
+                PendingSkin skin;
+                skin.node = node;
+                const int meshIndex = reader.ReadIndex(meshes.size());
+                skin.prototypeMesh = (meshIndex >= 0) ? meshes[meshIndex] : nullptr;
+                const uint32_t jointCount = reader.Read<uint32_t>();
+                for (uint32_t jointIndex = 0; jointIndex < jointCount && !reader.HasError(); jointIndex++)
+                {
+                    PendingJoint joint;
+                    joint.nodeIndex = reader.ReadIndex(nodeCount);
+                    joint.inverseBindMatrix = reader.Read<float4x4>();
+                    skin.joints.push_back(joint);
+                }
+                if (skin.prototypeMesh)
+                    pendingSkins.push_back(std::move(skin));
+                break;
+            }
+
+            case CachedLeafType::PerspectiveCamera: {
+                auto camera = std::make_shared<PerspectiveCamera>();
+                camera->zNear = reader.Read<float>();
+                camera->verticalFov = reader.Read<float>();
+                const bool hasZFar = reader.Read<bool>();
+                const float zFar = reader.Read<float>();
+                if (hasZFar)
+                    camera->zFar = zFar;
+                const bool hasAspectRatio = reader.Read<bool>();
+                const float aspectRatio = reader.Read<float>();
+                if (hasAspectRatio)
+                    camera->aspectRatio = aspectRatio;
+                node->SetLeaf(camera);
+                break;
+            }
+
+            case CachedLeafType::OrthographicCamera: {
+                auto camera = std::make_shared<OrthographicCamera>();
+                camera->zNear = reader.Read<float>();
+                camera->zFar = reader.Read<float>();
+                camera->xMag = reader.Read<float>();
+                camera->yMag = reader.Read<float>();
+                node->SetLeaf(camera);
+                break;
+            }
+
+            case CachedLeafType::DirectionalLight: {
+                auto light = std::dynamic_pointer_cast<DirectionalLight>(m_SceneTypeFactory->CreateLeaf("DirectionalLight"));
+                light->color = reader.Read<float3>();
+                light->irradiance = reader.Read<float>();
+                light->angularSize = reader.Read<float>();
+                node->SetLeaf(light);
+                break;
+            }
+
+            case CachedLeafType::PointLight: {
+                auto light = std::dynamic_pointer_cast<PointLight>(m_SceneTypeFactory->CreateLeaf("PointLight"));
+                light->color = reader.Read<float3>();
+                light->intensity = reader.Read<float>();
+                light->radius = reader.Read<float>();
+                light->range = reader.Read<float>();
+                node->SetLeaf(light);
+                break;
+            }
+
+            case CachedLeafType::SpotLight: {
+                auto light = std::dynamic_pointer_cast<SpotLight>(m_SceneTypeFactory->CreateLeaf("SpotLight"));
+                light->color = reader.Read<float3>();
+                light->intensity = reader.Read<float>();
+                light->radius = reader.Read<float>();
+                light->range = reader.Read<float>();
+                light->innerAngle = reader.Read<float>();
+                light->outerAngle = reader.Read<float>();
+                node->SetLeaf(light);
+                break;
+            }
+
+            case CachedLeafType::Animation: {
+                PendingAnimation animation;
+                animation.node = node;
+                const uint32_t samplerCount = reader.Read<uint32_t>();
+                for (uint32_t samplerIndex = 0; samplerIndex < samplerCount && !reader.HasError(); samplerIndex++)
+                {
+                    auto sampler = std::make_shared<animation::Sampler>();
+                    sampler->SetInterpolationMode(reader.Read<animation::InterpolationMode>());
+                    reader.ReadVector(sampler->GetKeyframes());
+                    animation.samplers.push_back(sampler);
+                }
+                const uint32_t channelCount = reader.Read<uint32_t>();
+                for (uint32_t channelIndex = 0; channelIndex < channelCount && !reader.HasError(); channelIndex++)
+                {
+                    PendingChannel channel;
+                    channel.samplerIndex = reader.ReadIndex(animation.samplers.size());
+                    channel.attribute = reader.Read<AnimationAttribute>();
+                    channel.targetNodeIndex = reader.ReadIndex(nodeCount);
+                    channel.leafPropertyName = reader.ReadString();
+                    animation.channels.push_back(std::move(channel));
+                }
+                pendingAnimations.push_back(std::move(animation));
+                break;
+            }
+
+            default:
+                reader.SetError();
+                break;
+            }
+        }
+
+        if (reader.HasError() || nodes.size() != nodeCount || nodes.empty())
+        {
+            log::warning("Scene cache '%s' is corrupted.", cacheName.c_str());
+            return false;
+        }
+
+        for (const PendingSkin& skin : pendingSkins)
+        {
+            auto skinnedInstance = m_SceneTypeFactory->CreateSkinnedMeshInstance(m_SceneTypeFactory, skin.prototypeMesh);
+            skinnedInstance->joints.resize(skin.joints.size());
+
+            for (size_t jointIndex = 0; jointIndex < skin.joints.size(); jointIndex++)
+            {
+                const PendingJoint& src = skin.joints[jointIndex];
+                SkinnedMeshJoint& joint = skinnedInstance->joints[jointIndex];
+                joint.inverseBindMatrix = src.inverseBindMatrix;
+                if (src.nodeIndex < 0)
+                    continue;
+
+                joint.node = nodes[src.nodeIndex];
+                if (!nodes[src.nodeIndex]->GetLeaf())
+                    nodes[src.nodeIndex]->SetLeaf(std::make_shared<SkinnedMeshReference>(skinnedInstance));
+            }
+
+            skin.node->SetLeaf(skinnedInstance);
+        }
+
+        for (const PendingAnimation& pending : pendingAnimations)
+        {
+            auto animation = std::make_shared<SceneGraphAnimation>();
+            for (const PendingChannel& src : pending.channels)
+            {
+                if (src.samplerIndex < 0 || src.targetNodeIndex < 0)
+                    continue;
+
+                auto channel = std::make_shared<SceneGraphAnimationChannel>(pending.samplers[src.samplerIndex], nodes[src.targetNodeIndex], src.attribute);
+                if (!src.leafPropertyName.empty())
+                    channel->SetLeafProperyName(src.leafPropertyName);
+                animation->AddChannel(channel);
+            }
+            pending.node->SetLeaf(animation);
+        }
+
+        result.rootNode = nodes[0];
+    }
+
+    result.sourceFiles = std::move(sourceFiles);
+
+    log::debug("Loaded '%s' from the scene cache in %.1f ms", fileName.generic_string().c_str(),
+        float(duration_cast<microseconds>(steady_clock::now() - loadStart).count()) * 1e-3f);
+
+    return true;
+}
@@ -21,9 +21,11 @@
 */
 
 #include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
 #include <donut/core/log.h>
 #include <donut/core/json.h>
 #include <sstream>
+#include <unordered_set>
 
 using namespace donut::engine;
 
@@ -242,12 +244,75 @@ bool OrthographicCamera::SetProperty(const std::string& name, const dm::float4&
     return SceneGraphLeaf::SetProperty(name, value);
 }
 
-void SceneGraphNode::UpdateLocalTransform()
+const dm::daffine3 SceneGraphNode::s_IdentityTransform = dm::daffine3::identity();
+const dm::affine3 SceneGraphNode::s_IdentityTransformFloat = dm::affine3::identity();
+
+dm::daffine3 SceneGraphNode::ComputeLocalTransform() const
 {
     dm::daffine3 transform = dm::scaling(m_Scaling);
     transform *= m_Rotation.toAffine();
     transform *= dm::translation(m_Translation);
-    m_LocalTransform = transform;
+    return transform;
+}
+
+// Copies the transforms out of the store of the graph before the node leaves it.
+void SceneGraphNode::LeaveTransformStore()
+{
+    if (!m_TransformStore)
+        return;
+
+    const SceneGraphTransformStore& store = *m_TransformStore;
+    const uint32_t index = m_TransformIndex;
+    m_Transforms = std::make_unique<Transforms>(Transforms{
+        store.localTransforms[index],
+        store.globalTransforms[index],
+        store.globalTransformsFloat[index],
+        store.prevLocalTransforms[index],
+        store.prevGlobalTransforms[index],
+        store.prevGlobalTransformsFloat[index] });
+    m_TransformStore = nullptr;
+}
+
+const dm::daffine3& SceneGraphNode::GetLocalToParentTransform() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->localTransforms[m_TransformIndex];
+    return m_Transforms ? m_Transforms->localTransform : s_IdentityTransform;
+}
+
+const dm::daffine3& SceneGraphNode::GetLocalToWorldTransform() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->globalTransforms[m_TransformIndex];
+    return m_Transforms ? m_Transforms->globalTransform : s_IdentityTransform;
+}
+
+const dm::affine3& SceneGraphNode::GetLocalToWorldTransformFloat() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->globalTransformsFloat[m_TransformIndex];
+    return m_Transforms ? m_Transforms->globalTransformFloat : s_IdentityTransformFloat;
+}
+
+const dm::daffine3& SceneGraphNode::GetPrevLocalToParentTransform() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->prevLocalTransforms[m_TransformIndex];
+    return m_Transforms ? m_Transforms->prevLocalTransform : s_IdentityTransform;
+}
+
+const dm::daffine3& SceneGraphNode::GetPrevLocalToWorldTransform() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->prevGlobalTransforms[m_TransformIndex];
+    return m_Transforms ? m_Transforms->prevGlobalTransform : s_IdentityTransform;
+}
+
+const dm::affine3& SceneGraphNode::GetPrevLocalToWorldTransformFloat() const
+{
+    if (m_TransformStore)
+        return m_TransformStore->prevGlobalTransformsFloat[m_TransformIndex];
+    return m_Transforms ? m_Transforms->prevGlobalTransformFloat : s_IdentityTransformFloat;
 }
 
 void SceneGraphNode::PropagateDirtyFlags(DirtyFlags flags)
@@ -394,7 +459,16 @@ int SceneGraphWalker::Up()
     return -1;
 }
 
-bool SceneGraphAnimationChannel::Apply(float time) const
+bool SceneGraphAnimationChannel::Apply(float time)
+{
+    auto valueOption = m_Sampler->Evaluate(time, true, m_Cursor);
+    if (!valueOption.has_value())
+        return false;
+
+    return ApplyValue(valueOption.value());
+}
+
+bool SceneGraphAnimationChannel::ApplyValue(const dm::float4& value) const
 {
     auto node = m_TargetNode.lock();
     auto material = m_TargetMaterial.lock();
@@ -402,12 +476,6 @@ bool SceneGraphAnimationChannel::Apply(float time) const
         (!material && !node && m_Attribute == AnimationAttribute::LeafProperty))
         return false;
 
-    auto valueOption = m_Sampler->Evaluate(time, true);
-    if (!valueOption.has_value())
-        return false;
-
-    auto value = valueOption.value();
-
     switch(m_Attribute)
     {
     case AnimationAttribute::Scaling:
@@ -491,21 +559,41 @@ bool SceneGraphAnimationChannel::IsValid() const
 void SceneGraphAnimation::AddChannel(const std::shared_ptr<SceneGraphAnimationChannel>& channel)
 {
     m_Channels.push_back(channel);
+    m_Samplers.AddSampler(channel->GetSampler());
     m_Duration = std::max(m_Duration, channel->GetSampler()->GetEndTime());
 ;}
 
-bool SceneGraphAnimation::Apply(float time) const
+bool SceneGraphAnimation::Apply(float time)
 {
     bool success = false;
 
-    for (const auto& channel : m_Channels)
+    m_Samplers.Evaluate(time, true);
+
+    for (size_t index = 0; index < m_Channels.size(); ++index)
     {
-        success = channel->Apply(time) && success;
+        const bool applied = m_Samplers.HasValue(index) && m_Channels[index]->ApplyValue(m_Samplers.GetValue(index));
+        success = applied && success;
     }
 
     return success;
 }
 
+animation::CompressionReport SceneGraphAnimation::Compress(const animation::CompressionSettings& settings)
+{
+    animation::CompressionReport report;
+
+    // Channels may share samplers, compress each one once
+    std::unordered_set<animation::Sampler*> compressed;
+    for (const auto& channel : m_Channels)
+    {
+        animation::Sampler* sampler = channel->GetSampler().get();
+        if (sampler && compressed.insert(sampler).second)
+            report += sampler->Compress(settings);
+    }
+
+    return report;
+}
+
 bool SceneGraphAnimation::IsVald() const
 {
     for (const auto& channel : m_Channels)
@@ -517,6 +605,17 @@ bool SceneGraphAnimation::IsVald() const
     return true;
 }
 
+SceneGraph::~SceneGraph()
+{
+    // The nodes can outlive the graph, make sure they don't reference the transform store anymore
+    SceneGraphWalker walker(m_Root.get());
+    while (walker)
+    {
+        walker->LeaveTransformStore();
+        walker.Next(true);
+    }
+}
+
 void SceneGraph::RegisterLeaf(const std::shared_ptr<SceneGraphLeaf>& leaf)
 {
     if (!leaf)
@@ -694,6 +793,8 @@ std::shared_ptr<SceneGraphNode> SceneGraph::Attach(const std::shared_ptr<SceneGr
     }
 
     assert(parentGraph.get() == this);
+    m_TransformStoreDirty = true;
+
     std::shared_ptr<SceneGraphNode> attachedChild;
     
     if (childGraph)
@@ -812,6 +913,9 @@ std::shared_ptr<SceneGraphNode> SceneGraph::Attach(const std::shared_ptr<SceneGr
         while (walker)
         {
             walker->m_Graph = weak_from_this();
+            // The local transforms in the store may be outdated if the node was never refreshed in a graph
+            if (walker->m_HasLocalTransform)
+                walker->m_Dirty |= SceneGraphNode::DirtyFlags::LocalTransform;
             auto leaf = walker->GetLeaf();
             if (leaf)
                 RegisterLeaf(leaf);
@@ -833,6 +937,7 @@ std::shared_ptr<SceneGraphNode> SceneGraph::Attach(const std::shared_ptr<SceneGr
     }
 
     attachedChild->PropagateDirtyFlags(SceneGraphNode::DirtyFlags::SubgraphStructure
+        | SceneGraphNode::DirtyFlags::SubgraphTransforms
         | (child->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask));
 
     return attachedChild;
@@ -856,11 +961,14 @@ std::shared_ptr<SceneGraphNode> SceneGraph::Detach(const std::shared_ptr<SceneGr
     {
         assert(nodeGraph.get() == this);
 
+        m_TransformStoreDirty = true;
+
         // unregister all leaves in the subgraph, detach all nodes from the graph
         SceneGraphWalker walker(node.get());
         while (walker)
         {
             walker->m_Graph.reset();
+            walker->LeaveTransformStore();
             auto leaf = walker->GetLeaf();
             if (leaf)
                 UnregisterLeaf(leaf);
@@ -956,182 +1064,602 @@ std::shared_ptr<SceneGraphNode> SceneGraph::FindNode(const std::filesystem::path
     return current->shared_from_this();
 }
 
-void SceneGraph::Refresh(uint32_t frameIndex)
+namespace
 {
-    struct StackItem
+    // Per-node state of SceneGraph::Refresh, stored in SceneGraph::m_RefreshFlags.
+    // The Supergraph* bits form the context passed to the children of a node.
+    enum RefreshFlags : uint8_t
     {
-        bool supergraphTransformUpdated = false;
-        bool supergraphContentUpdate = false;
-    };
+        RefreshFlags_None = 0,
+        RefreshFlags_SupergraphTransformUpdated = 0x01,
+        RefreshFlags_SupergraphContentUpdate = 0x02,
+        RefreshFlags_VisitChildren = 0x04,
 
-    bool structureDirty = HasPendingStructureChanges();
+        RefreshFlags_ContextMask = RefreshFlags_SupergraphTransformUpdated | RefreshFlags_SupergraphContentUpdate
+    };
+}
 
-    StackItem context;
-    std::vector<StackItem> stack;
+// Lays out the nodes of the graph in depth-first order and moves their transforms into the new arrays.
+// Nodes that were detached from a graph bring their last transforms, new nodes start with identity transforms.
+// When the store is disabled, only the node order is rebuilt and the transforms move into the nodes instead.
+void SceneGraph::RebuildTransformStore()
+{
+    SceneGraphTransformStore store;
+    size_t capacity = m_TransformStore.size();
+    store.nodes.reserve(capacity);
+    store.parentIndices.reserve(capacity);
+    store.subgraphEnds.reserve(capacity);
+    if (m_TransformStoreEnabled)
+    {
+        store.localTransforms.reserve(capacity);
+        store.globalTransforms.reserve(capacity);
+        store.globalTransformsFloat.reserve(capacity);
+        store.prevLocalTransforms.reserve(capacity);
+        store.prevGlobalTransforms.reserve(capacity);
+        store.prevGlobalTransformsFloat.reserve(capacity);
+    }
 
+    std::vector<uint32_t> path;
     SceneGraphWalker walker(m_Root.get());
     while (walker)
     {
-        auto current = walker.Get();
-        auto parent = current->m_Parent;
+        SceneGraphNode* node = walker.Get();
+        uint32_t index = uint32_t(store.nodes.size());
 
-        // save the current local/global transforms as previous
-        current->m_PrevLocalTransform = current->m_LocalTransform;
-        current->m_PrevGlobalTransform = current->m_GlobalTransform;
-        current->m_PrevGlobalTransformFloat = current->m_GlobalTransformFloat;
+        store.nodes.push_back(node);
+        store.parentIndices.push_back(path.empty() ? -1 : int(path.back()));
+        store.subgraphEnds.push_back(index + 1);
+        node->m_TransformIndex = index;
 
-        bool currentTransformUpdated = (current->m_Dirty & SceneGraphNode::DirtyFlags::LocalTransform) != 0;
-        bool currentContentUpdated = (current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphContentUpdate) != 0;
-
-        if (currentTransformUpdated)
+        if (!m_TransformStoreEnabled)
         {
-            current->UpdateLocalTransform();
+            node->LeaveTransformStore();
+            if (!node->m_Transforms)
+                node->m_Transforms = std::make_unique<SceneGraphNode::Transforms>();
         }
-
-        // update the global transform of the current node
-        if (parent)
+        else if (node->m_TransformStore == &m_TransformStore)
         {
-            current->m_GlobalTransform = current->m_HasLocalTransform
-                ? current->m_LocalTransform * parent->m_GlobalTransform
-                : parent->m_GlobalTransform;
+            uint32_t oldIndex = node->m_TransformIndex;
+            store.localTransforms.push_back(m_TransformStore.localTransforms[oldIndex]);
+            store.globalTransforms.push_back(m_TransformStore.globalTransforms[oldIndex]);
+            store.globalTransformsFloat.push_back(m_TransformStore.globalTransformsFloat[oldIndex]);
+            store.prevLocalTransforms.push_back(m_TransformStore.prevLocalTransforms[oldIndex]);
+            store.prevGlobalTransforms.push_back(m_TransformStore.prevGlobalTransforms[oldIndex]);
+            store.prevGlobalTransformsFloat.push_back(m_TransformStore.prevGlobalTransformsFloat[oldIndex]);
+        }
+        else if (node->m_Transforms)
+        {
+            const SceneGraphNode::Transforms& transforms = *node->m_Transforms;
+            store.localTransforms.push_back(transforms.localTransform);
+            store.globalTransforms.push_back(transforms.globalTransform);
+            store.globalTransformsFloat.push_back(transforms.globalTransformFloat);
+            store.prevLocalTransforms.push_back(transforms.prevLocalTransform);
+            store.prevGlobalTransforms.push_back(transforms.prevGlobalTransform);
+            store.prevGlobalTransformsFloat.push_back(transforms.prevGlobalTransformFloat);
+            node->m_Transforms.reset();
         }
         else
         {
-            current->m_GlobalTransform = current->m_LocalTransform;
+            store.localTransforms.push_back(dm::daffine3::identity());
+            store.globalTransforms.push_back(dm::daffine3::identity());
+            store.globalTransformsFloat.push_back(dm::affine3::identity());
+            store.prevLocalTransforms.push_back(dm::daffine3::identity());
+            store.prevGlobalTransforms.push_back(dm::daffine3::identity());
+            store.prevGlobalTransformsFloat.push_back(dm::affine3::identity());
         }
-        current->m_GlobalTransformFloat = dm::affine3(current->m_GlobalTransform);
 
-        // initialize the global bbox of the current node, start with the leaf (or an empty box if there is no leaf)
-        if ((current->m_Dirty & (SceneGraphNode::DirtyFlags::SubgraphStructure | SceneGraphNode::DirtyFlags::SubgraphTransforms)) != 0 || context.supergraphTransformUpdated)
+        if (m_TransformStoreEnabled)
+            node->m_TransformStore = &m_TransformStore;
+
+        int deltaDepth = walker.Next(true);
+        if (deltaDepth > 0)
         {
-            current->m_GlobalBoundingBox = dm::box3::empty();
-            if (current->m_Leaf)
+            path.push_back(index);
+        }
+        else
+        {
+            // close the subgraphs of the nodes we're leaving
+            while (deltaDepth++ < 0)
             {
-                dm::box3 localBoundingBox = current->m_Leaf->GetLocalBoundingBox();
-                if (!localBoundingBox.isempty())
-                    current->m_GlobalBoundingBox = localBoundingBox * current->m_GlobalTransformFloat;
+                store.subgraphEnds[path.back()] = uint32_t(store.nodes.size());
+                path.pop_back();
             }
         }
+    }
 
-        // initialize the content flags of the current node
-        if (context.supergraphContentUpdate || (current->m_Dirty & (SceneGraphNode::DirtyFlags::SubgraphStructure | SceneGraphNode::DirtyFlags::SubgraphContentUpdate)) != 0)
-        {
-            if (current->m_Leaf)
-                current->m_LeafContent = current->m_Leaf->GetContentFlags();
-            else
-                current->m_LeafContent = SceneContentFlags::None;
+    m_TransformStore = std::move(store);
+    m_RefreshFlags.assign(m_TransformStore.size(), RefreshFlags_None);
+    m_TransformStoreDirty = false;
+}
+
+// Updates the transforms, bounding box and content flags of one node, assuming its parent is already updated.
+// Returns the context for the children of the node, plus RefreshFlags_VisitChildren if they need to be refreshed.
+uint8_t SceneGraph::RefreshNode(uint32_t index, uint8_t context, uint32_t frameIndex)
+{
+    SceneGraphTransformStore& store = m_TransformStore;
+    SceneGraphNode* current = store.nodes[index];
+    int parentIndex = store.parentIndices[index];
 
-            current->m_SubgraphContent = current->m_LeafContent;
+    const bool supergraphTransformUpdated = (context & RefreshFlags_SupergraphTransformUpdated) != 0;
+    const bool supergraphContentUpdate = (context & RefreshFlags_SupergraphContentUpdate) != 0;
+
+    // the transforms are either in the store or in the nodes, see RebuildTransformStore
+    SceneGraphNode::Transforms* transforms = current->m_Transforms.get();
+    dm::daffine3& localTransform = transforms ? transforms->localTransform : store.localTransforms[index];
+    dm::daffine3& globalTransform = transforms ? transforms->globalTransform : store.globalTransforms[index];
+    dm::affine3& globalTransformFloat = transforms ? transforms->globalTransformFloat : store.globalTransformsFloat[index];
+
+    // save the current local/global transforms as previous
+    if (transforms)
+    {
+        transforms->prevLocalTransform = localTransform;
+        transforms->prevGlobalTransform = globalTransform;
+        transforms->prevGlobalTransformFloat = globalTransformFloat;
+    }
+    else
+    {
+        store.prevLocalTransforms[index] = localTransform;
+        store.prevGlobalTransforms[index] = globalTransform;
+        store.prevGlobalTransformsFloat[index] = globalTransformFloat;
+    }
+
+    bool currentTransformUpdated = (current->m_Dirty & SceneGraphNode::DirtyFlags::LocalTransform) != 0;
+    bool currentContentUpdated = (current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphContentUpdate) != 0;
+
+    if (currentTransformUpdated)
+    {
+        localTransform = current->ComputeLocalTransform();
+    }
+
+    // update the global transform of the current node
+    if (parentIndex >= 0)
+    {
+        // all nodes in the graph keep their transforms in the same place
+        const dm::daffine3& parentTransform = transforms
+            ? store.nodes[parentIndex]->m_Transforms->globalTransform
+            : store.globalTransforms[parentIndex];
+        globalTransform = current->m_HasLocalTransform
+            ? localTransform * parentTransform
+            : parentTransform;
+    }
+    else
+    {
+        globalTransform = localTransform;
+    }
+    globalTransformFloat = dm::affine3(globalTransform);
+
+    // initialize the global bbox of the current node, start with the leaf (or an empty box if there is no leaf)
+    if ((current->m_Dirty & (SceneGraphNode::DirtyFlags::SubgraphStructure | SceneGraphNode::DirtyFlags::SubgraphTransforms)) != 0 || supergraphTransformUpdated)
+    {
+        current->m_GlobalBoundingBox = dm::box3::empty();
+        if (current->m_Leaf)
+        {
+            dm::box3 localBoundingBox = current->m_Leaf->GetLocalBoundingBox();
+            if (!localBoundingBox.isempty())
+                current->m_GlobalBoundingBox = localBoundingBox * globalTransformFloat;
         }
+    }
+
+    // initialize the content flags of the current node
+    if (supergraphContentUpdate || (current->m_Dirty & (SceneGraphNode::DirtyFlags::SubgraphStructure | SceneGraphNode::DirtyFlags::SubgraphContentUpdate)) != 0)
+    {
+        if (current->m_Leaf)
+            current->m_LeafContent = current->m_Leaf->GetContentFlags();
+        else
+            current->m_LeafContent = SceneContentFlags::None;
 
-        // store the update frame number for skinned groups
-        if (auto meshReference = dynamic_cast<SkinnedMeshReference*>(current->m_Leaf.get()))
+        current->m_SubgraphContent = current->m_LeafContent;
+    }
+
+    // store the update frame number for skinned groups
+    if (auto meshReference = dynamic_cast<SkinnedMeshReference*>(current->m_Leaf.get()))
+    {
+        if ((current->m_Dirty & SceneGraphNode::DirtyFlags::LocalTransform) != 0)
         {
-            if ((current->m_Dirty & SceneGraphNode::DirtyFlags::LocalTransform) != 0)
+            auto instance = meshReference->m_Instance.lock();
+            if (instance)
             {
-                auto instance = meshReference->m_Instance.lock();
-                if (instance)
-                {
-                    instance->m_LastUpdateFrameIndex = frameIndex;
-                }
+                instance->m_LastUpdateFrameIndex.store(frameIndex, std::memory_order_relaxed);
             }
         }
+    }
 
-        // advance to the next node
-        bool subgraphNeedsRefresh = (current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask) != 0;
-        int deltaDepth = walker.Next(subgraphNeedsRefresh || context.supergraphTransformUpdated || context.supergraphContentUpdate);
+    bool subgraphNeedsRefresh = (current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask) != 0;
 
-        // save the dirty flag to update the same nodes' previous transforms on the next frame
-        current->m_Dirty = (currentTransformUpdated || context.supergraphTransformUpdated)
-            ? SceneGraphNode::DirtyFlags::PrevTransform
-            : SceneGraphNode::DirtyFlags::None;
-        
-        if (deltaDepth > 0)
+    // save the dirty flag to update the same nodes' previous transforms on the next frame
+    current->m_Dirty = (currentTransformUpdated || supergraphTransformUpdated)
+        ? SceneGraphNode::DirtyFlags::PrevTransform
+        : SceneGraphNode::DirtyFlags::None;
+
+    uint8_t childFlags = context;
+    if (currentTransformUpdated)
+        childFlags |= RefreshFlags_SupergraphTransformUpdated;
+    if (currentContentUpdated)
+        childFlags |= RefreshFlags_SupergraphContentUpdate;
+    if (subgraphNeedsRefresh || supergraphTransformUpdated || supergraphContentUpdate)
+        childFlags |= RefreshFlags_VisitChildren;
+
+    return childFlags;
+}
+
+// Adds the finished bbox, dirty flags and content flags of a child node to its parent's (or a partial reduction).
+void SceneGraph::MergeSubgraph(dm::box3& boundingBox, SceneGraphNode::DirtyFlags& dirty, SceneContentFlags& content, const SceneGraphNode* child)
+{
+    boundingBox |= child->m_GlobalBoundingBox;
+    // Note: a child with visited children that has PrevTransform always has SubgraphPrevTransforms already,
+    // so applying this rule to every child is equivalent to applying it to the last visited nodes only.
+    if ((child->m_Dirty & SceneGraphNode::DirtyFlags::PrevTransform) != 0)
+        dirty |= SceneGraphNode::DirtyFlags::SubgraphPrevTransforms;
+    dirty |= child->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask;
+    content |= child->m_SubgraphContent;
+}
+
+// Refreshes the subgraph of the node at 'scopeIndex' with a linear scan over its range in the transform store,
+// skipping the subgraphs that don't need a refresh, then merges the results bottom-up in reverse order.
+// When updateScopeParent is false, the results for the scope node are not merged into its parent,
+// which allows refreshing sibling subgraphs concurrently.
+void SceneGraph::RefreshSubgraph(uint32_t scopeIndex, uint8_t scopeContext, uint32_t frameIndex, bool updateScopeParent, std::vector<uint32_t>& refreshedNodes)
+{
+    const SceneGraphTransformStore& store = m_TransformStore;
+    const uint32_t scopeEnd = store.subgraphEnds[scopeIndex];
+
+    refreshedNodes.clear();
+    m_RefreshFlags[scopeIndex] = RefreshNode(scopeIndex, scopeContext, frameIndex);
+    refreshedNodes.push_back(scopeIndex);
+
+    uint32_t index = scopeIndex + 1;
+    while (index < scopeEnd)
+    {
+        // the parent is always refreshed before we get here, see below
+        uint32_t parentIndex = uint32_t(store.parentIndices[index]);
+        uint8_t parentFlags = m_RefreshFlags[parentIndex];
+
+        if ((parentFlags & RefreshFlags_VisitChildren) == 0)
         {
-            // going down the tree
-            stack.push_back(context);
-            context.supergraphTransformUpdated |= currentTransformUpdated;
-            context.supergraphContentUpdate |= currentContentUpdated;
+            // 'index' is the first child of 'parentIndex', skip all of the parent's subgraph
+            index = store.subgraphEnds[parentIndex];
+            continue;
         }
-        else
+
+        m_RefreshFlags[index] = RefreshNode(index, parentFlags & RefreshFlags_ContextMask, frameIndex);
+        refreshedNodes.push_back(index);
+        ++index;
+    }
+
+    // children always come after their parents, so walking backwards finishes every node before it's merged
+    for (auto it = refreshedNodes.rbegin(); it != refreshedNodes.rend(); ++it)
+    {
+        uint32_t childIndex = *it;
+        if (childIndex == scopeIndex && !updateScopeParent)
+            continue;
+
+        int parentIndex = store.parentIndices[childIndex];
+        if (parentIndex < 0)
+            continue;
+
+        SceneGraphNode* parent = store.nodes[parentIndex];
+        MergeSubgraph(parent->m_GlobalBoundingBox, parent->m_Dirty, parent->m_SubgraphContent, store.nodes[childIndex]);
+    }
+}
+
+void SceneGraph::UpdateIndices()
+{
+    int instanceIndex = 0;
+    int geometryInstanceIndex = 0;
+    for (const auto& instance : m_MeshInstances)
+    {
+        instance->m_InstanceIndex = instanceIndex;
+        ++instanceIndex;
+
+        const auto& mesh = instance->GetMesh();
+        instance->m_GeometryInstanceIndex = geometryInstanceIndex;
+        geometryInstanceIndex += int(mesh->geometries.size());
+    }
+    m_GeometryInstancesCount = geometryInstanceIndex;
+
+    int meshIndex = 0;
+    int geometryIndex = 0;
+    for (const auto& mesh : m_Meshes)
+    {
+        for (const auto& geometry : mesh->geometries)
         {
-            // sibling or going up. done with our bbox, update the parent.
-            if (parent)
-            {
-                parent->m_GlobalBoundingBox |= current->m_GlobalBoundingBox;
-                if ((current->m_Dirty & SceneGraphNode::DirtyFlags::PrevTransform) != 0)
-                    parent->m_Dirty |= SceneGraphNode::DirtyFlags::SubgraphPrevTransforms;
-                parent->m_Dirty |= current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask;
-                parent->m_SubgraphContent |= current->m_SubgraphContent;
-            }
+            geometry->globalGeometryIndex = geometryIndex;
+            ++geometryIndex;
+        }
 
-            // going up the tree, potentially multiple levels
-            while (deltaDepth++ < 0)
-            {
-                if (stack.empty())
-                {
-                    context = StackItem(); // should only happen once when we reach the top
-                }
-                else
-                {
-                    // we're moving up to node 'parent' whose parent is 'newParent'
-                    // update 'newParent's bbox with the finished bbox of 'parent'
-                    assert(parent);
-                    current = parent;
-                    parent = current->m_Parent;
+        mesh->globalMeshIndex = meshIndex;
+        ++meshIndex;
+    }
 
-                    if (parent)
-                    {
-                        parent->m_GlobalBoundingBox |= current->m_GlobalBoundingBox;
-                        parent->m_Dirty |= current->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphMask;
-                        parent->m_SubgraphContent |= current->m_SubgraphContent;
-                    }
+    assert(m_GeometryCount == geometryIndex);
 
-                    context = stack.back();
-                    stack.pop_back();
-                }
-            }
+    // Buffer groups can be shared by several meshes, number them in the order of their first mesh
+    for (const auto& mesh : m_Meshes)
+    {
+        if (mesh->buffers)
+            mesh->buffers->globalBufferGroupIndex = -1;
+    }
+
+    int bufferGroupIndex = 0;
+    for (const auto& mesh : m_Meshes)
+    {
+        if (mesh->buffers && mesh->buffers->globalBufferGroupIndex < 0)
+        {
+            mesh->buffers->globalBufferGroupIndex = bufferGroupIndex;
+            ++bufferGroupIndex;
         }
     }
 
+    int materialIndex = 0;
+    for (const auto& material : m_Materials)
+    {
+        material->materialID = materialIndex;
+        ++materialIndex;
+    }
+}
+
+void SceneGraph::UpdateVersions()
+{
+    if (!m_Root)
+        return;
+
+    if ((m_Root->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphStructure) != 0)
+        ++m_StructureVersion;
+    if ((m_Root->m_Dirty & SceneGraphNode::DirtyFlags::SubgraphContentUpdate) != 0)
+        ++m_ContentVersion;
+    if ((m_Root->m_Dirty & (SceneGraphNode::DirtyFlags::LocalTransform | SceneGraphNode::DirtyFlags::SubgraphTransforms)) != 0)
+        ++m_TransformVersion;
+}
+
+void SceneGraph::Refresh(uint32_t frameIndex)
+{
+    bool structureDirty = HasPendingStructureChanges();
+    UpdateVersions();
+
+    if (m_TransformStoreDirty)
+        RebuildTransformStore();
+
+    if (m_TransformStore.size() != 0)
+        RefreshSubgraph(0, RefreshFlags_None, frameIndex, true, m_RefreshedNodes);
+    else
+        m_RefreshedNodes.clear();
+
     if (structureDirty)
+        UpdateIndices();
+
+    if (m_InstanceBVH)
+        UpdateInstanceBVH(structureDirty, m_RefreshedNodes);
+}
+
+void SceneGraph::SetTransformStoreEnabled(bool enabled)
+{
+    if (m_TransformStoreEnabled == enabled)
+        return;
+
+    m_TransformStoreEnabled = enabled;
+    m_TransformStoreDirty = true;
+}
+
+void SceneGraph::SetInstanceBVHEnabled(bool enabled)
+{
+    if (!enabled)
+        m_InstanceBVH.reset();
+    else if (!m_InstanceBVH)
+        m_InstanceBVH = std::make_unique<InstanceBVH>(); // built on the next Refresh, see UpdateInstanceBVH
+}
+
+static dm::box3 GetInstanceWorldBounds(MeshInstance& instance, const SceneGraphNode* node)
+{
+    dm::box3 localBounds = instance.GetLocalBoundingBox();
+    if (!node || localBounds.isempty())
+        return dm::box3::empty();
+
+    return localBounds * node->GetLocalToWorldTransformFloat();
+}
+
+// Rebuilds the instance BVH after structure changes, or updates the instances whose transforms changed,
+// which are the refreshed nodes that have the PrevTransform flag set.
+void SceneGraph::UpdateInstanceBVH(bool rebuild, const std::vector<uint32_t>& refreshedNodes)
+{
+    if (rebuild || m_InstanceBVH->GetNumLeaves() != m_MeshInstances.size())
     {
-        int instanceIndex = 0;
-        int geometryInstanceIndex = 0;
+        std::vector<dm::box3> bounds;
+        bounds.reserve(m_MeshInstances.size());
         for (const auto& instance : m_MeshInstances)
+            bounds.push_back(GetInstanceWorldBounds(*instance, instance->GetNode()));
+
+        m_InstanceBVH->Build(bounds);
+        return;
+    }
+
+    for (uint32_t index : refreshedNodes)
+    {
+        SceneGraphNode* node = m_TransformStore.nodes[index];
+        if ((node->m_Dirty & SceneGraphNode::DirtyFlags::PrevTransform) == 0)
+            continue;
+
+        auto meshInstance = dynamic_cast<MeshInstance*>(node->m_Leaf.get());
+        if (!meshInstance || meshInstance->m_InstanceIndex < 0)
+            continue;
+
+        m_InstanceBVH->UpdateLeaf(uint32_t(meshInstance->m_InstanceIndex), GetInstanceWorldBounds(*meshInstance, node));
+    }
+
+    m_InstanceBVH->Commit();
+}
+
+namespace
+{
+    // Minimum number of subgraphs per worker thread before the serial top-down pass stops expanding the hierarchy
+    constexpr size_t c_RefreshSubgraphsPerThread = 8;
+
+    // Maximum depth of the serial top-down pass, limits the serial work on deep and narrow hierarchies
+    constexpr int c_RefreshMaxSerialDepth = 8;
+}
+
+void SceneGraph::RefreshWithThreadPool(uint32_t frameIndex, ThreadPool* threadPool)
+{
+    if (!threadPool || threadPool->GetNumThreads() == 0)
+    {
+        Refresh(frameIndex);
+        return;
+    }
+
+    bool structureDirty = HasPendingStructureChanges();
+    UpdateVersions();
+
+    if (m_TransformStoreDirty)
+        RebuildTransformStore();
+
+    if (m_TransformStore.size() == 0)
+    {
+        if (m_InstanceBVH)
+            UpdateInstanceBVH(structureDirty, {});
+        return;
+    }
+
+    struct FrontierItem
+    {
+        uint32_t index;
+        uint8_t context;
+    };
+
+    // Top-down pass: refresh the upper levels of the hierarchy serially, level by level,
+    // until there are enough dirty subgraphs to keep the workers busy.
+    const size_t numWorkers = threadPool->GetNumThreads() + 1; // the calling thread participates too
+    const size_t minFrontierSize = numWorkers * c_RefreshSubgraphsPerThread;
+
+    std::vector<uint32_t> serialNodes;
+    std::vector<FrontierItem> frontier = { { 0, RefreshFlags_None } };
+    for (int depth = 0; !frontier.empty() && frontier.size() < minFrontierSize && depth < c_RefreshMaxSerialDepth; ++depth)
+    {
+        std::vector<FrontierItem> nextLevel;
+        for (const FrontierItem& item : frontier)
         {
-            instance->m_InstanceIndex = instanceIndex;
-            ++instanceIndex;
+            uint8_t childFlags = RefreshNode(item.index, item.context, frameIndex);
+            m_RefreshFlags[item.index] = childFlags;
+            serialNodes.push_back(item.index);
 
-            const auto& mesh = instance->GetMesh();
-            instance->m_GeometryInstanceIndex = geometryInstanceIndex;
-            geometryInstanceIndex += int(mesh->geometries.size());
+            if ((childFlags & RefreshFlags_VisitChildren) != 0)
+            {
+                for (const auto& child : m_TransformStore.nodes[item.index]->m_Children)
+                    nextLevel.push_back({ child->m_TransformIndex, uint8_t(childFlags & RefreshFlags_ContextMask) });
+            }
         }
-        m_GeometryInstancesCount = geometryInstanceIndex;
+        frontier = std::move(nextLevel);
+    }
+
+    // Split the frontier into batches of siblings. Each batch produces a partial reduction for its parent.
+    struct Batch
+    {
+        size_t begin = 0;
+        size_t end = 0;
+        dm::box3 boundingBox = dm::box3::empty();
+        SceneGraphNode::DirtyFlags dirty = SceneGraphNode::DirtyFlags::None;
+        SceneContentFlags content = SceneContentFlags::None;
+        std::vector<uint32_t> refreshedNodes; // only collected for the instance BVH
+    };
 
-        int meshIndex = 0;
-        int geometryIndex = 0;
-        for (const auto& mesh : m_Meshes)
+    struct SharedState
+    {
+        SceneGraph* graph = nullptr;
+        std::vector<FrontierItem> frontier;
+        std::vector<Batch> batches;
+        std::atomic<size_t> nextBatch = 0;
+        uint32_t frameIndex = 0;
+        bool collectRefreshedNodes = false;
+
+        // Processes batches until there are none left. Safe to call after all batches are taken.
+        void Run()
         {
-            for (const auto& geometry : mesh->geometries)
+            std::vector<uint32_t> refreshedNodes;
+            size_t batchIndex;
+            while ((batchIndex = nextBatch.fetch_add(1)) < batches.size())
             {
-                geometry->globalGeometryIndex = geometryIndex;
-                ++geometryIndex;
+                Batch& batch = batches[batchIndex];
+                for (size_t index = batch.begin; index < batch.end; ++index)
+                {
+                    const FrontierItem& item = frontier[index];
+                    graph->RefreshSubgraph(item.index, item.context, frameIndex, false, refreshedNodes);
+                    MergeSubgraph(batch.boundingBox, batch.dirty, batch.content, graph->m_TransformStore.nodes[item.index]);
+                    if (collectRefreshedNodes)
+                        batch.refreshedNodes.insert(batch.refreshedNodes.end(), refreshedNodes.begin(), refreshedNodes.end());
+                }
             }
+        }
+    };
+
+    // The tasks are waited on before returning, so they can reference the state on the stack.
+    SharedState state;
+    state.graph = this;
+    state.frontier = std::move(frontier);
+    state.frameIndex = frameIndex;
+    state.collectRefreshedNodes = m_InstanceBVH != nullptr;
+
+    const std::vector<int>& parentIndices = m_TransformStore.parentIndices;
+    const size_t maxBatchSize = std::max<size_t>(1, state.frontier.size() / (numWorkers * c_RefreshSubgraphsPerThread));
+    for (size_t index = 0; index < state.frontier.size(); )
+    {
+        Batch batch;
+        batch.begin = index;
+        int parentIndex = parentIndices[state.frontier[index].index];
+        while (index < state.frontier.size() && index - batch.begin < maxBatchSize && parentIndices[state.frontier[index].index] == parentIndex)
+            ++index;
+        batch.end = index;
+        state.batches.push_back(batch);
+    }
 
-            mesh->globalMeshIndex = meshIndex;
-            ++meshIndex;
+    if (!state.batches.empty())
+    {
+        ThreadPoolTaskGroup group;
+        size_t numTasks = std::min(state.batches.size() - 1, numWorkers - 1);
+        for (size_t task = 0; task < numTasks; ++task)
+        {
+            threadPool->AddTask(group, [&state]() { state.Run(); }, ThreadPoolPriority::High);
         }
 
-        assert(m_GeometryCount == geometryIndex);
+        state.Run();
+
+        // The batches taken by the tasks are done when the group is: Wait runs other queued tasks
+        // in the meantime instead of spinning.
+        threadPool->Wait(group);
+    }
+
+    // Bottom-up pass: merge the batches into their parents, then merge the serially refreshed nodes
+    // into their parents in reverse order, so that every node is complete before it's merged.
+    for (const Batch& batch : state.batches)
+    {
+        int parentIndex = parentIndices[state.frontier[batch.begin].index];
+        if (parentIndex >= 0)
+        {
+            SceneGraphNode* parent = m_TransformStore.nodes[parentIndex];
+            parent->m_GlobalBoundingBox |= batch.boundingBox;
+            parent->m_Dirty |= batch.dirty;
+            parent->m_SubgraphContent |= batch.content;
+        }
+    }
 
-        int materialIndex = 0;
-        for (const auto& material : m_Materials)
+    for (auto it = serialNodes.rbegin(); it != serialNodes.rend(); ++it)
+    {
+        int parentIndex = parentIndices[*it];
+        if (parentIndex >= 0)
         {
-            material->materialID = materialIndex;
-            ++materialIndex;
+            SceneGraphNode* parent = m_TransformStore.nodes[parentIndex];
+            MergeSubgraph(parent->m_GlobalBoundingBox, parent->m_Dirty, parent->m_SubgraphContent, m_TransformStore.nodes[*it]);
         }
     }
+
+    if (structureDirty)
+        UpdateIndices();
+
+    if (m_InstanceBVH)
+    {
+        m_RefreshedNodes = std::move(serialNodes);
+        for (const Batch& batch : state.batches)
+            m_RefreshedNodes.insert(m_RefreshedNodes.end(), batch.refreshedNodes.begin(), batch.refreshedNodes.end());
+
+        UpdateInstanceBVH(structureDirty, m_RefreshedNodes);
+    }
 }
 
 std::shared_ptr<SceneGraphLeaf> SceneTypeFactory::CreateLeaf(const std::string& type)
@@ -1271,12 +1799,15 @@ void donut::engine::PrintSceneGraph(const std::shared_ptr<SceneGraphNode>& root)
                         ss << "Unknown Attribute";
                     }
                     ss << "): ";
-                    auto keyframes = channel->GetSampler()->GetKeyframes();
-                    ss << keyframes.size() << " keyframes";
-                    if (!keyframes.empty())
+                    // Don't access the keyframes, that would decompress the sampler
+                    const auto& sampler = channel->GetSampler();
+                    ss << sampler->GetNumKeyframes() << " keyframes";
+                    if (sampler->GetNumKeyframes() != 0)
                     {
-                        ss << ", " << keyframes[0].time << "s - " << keyframes[keyframes.size() - 1].time << "s";
+                        ss << ", " << sampler->GetStartTime() << "s - " << sampler->GetEndTime() << "s";
                     }
+                    if (sampler->IsCompressed())
+                        ss << ", compressed";
 
                     log::info("%s", ss.str().c_str());
                     ss.str(std::string()); // clear
@@ -315,42 +315,72 @@ bool PointLight::SetProperty(const std::string& name, const dm::float4& value)
     return Light::SetProperty(name, value);
 }
 
-nvrhi::VertexAttributeDesc donut::engine::GetVertexAttributeDesc(VertexAttribute attribute, const char* name, uint32_t bufferIndex)
+uint32_t donut::engine::GetVertexAttributeStride(VertexAttribute attribute, VertexLayout layout)
 {
+    const bool compact = layout == VertexLayout::Compact;
+
+    switch (attribute)
+    {
+    case VertexAttribute::Position:
+    case VertexAttribute::PrevPosition:
+        return compact ? sizeof(float16_t4) : sizeof(float3);
+    case VertexAttribute::TexCoord1:
+    case VertexAttribute::TexCoord2:
+        return compact ? sizeof(float16_t2) : sizeof(float2);
+    case VertexAttribute::Normal:
+    case VertexAttribute::Tangent:
+        return sizeof(uint32_t);
+    case VertexAttribute::Transform:
+    case VertexAttribute::PrevTransform:
+        return sizeof(InstanceData);
+    case VertexAttribute::JointIndices:
+        return sizeof(vector<uint16_t, 4>);
+    case VertexAttribute::JointWeights:
+        return compact ? sizeof(uint32_t) : sizeof(float4);
+    case VertexAttribute::CurveRadius:
+        return sizeof(float);
+
+    default:
+        assert(!"unknown attribute");
+        return 0;
+    }
+}
+
+nvrhi::VertexAttributeDesc donut::engine::GetVertexAttributeDesc(VertexAttribute attribute, const char* name, uint32_t bufferIndex,
+    VertexLayout layout)
+{
+    const bool compact = layout == VertexLayout::Compact;
+
     nvrhi::VertexAttributeDesc result = {};
     result.name = name;
     result.bufferIndex = bufferIndex;
     result.arraySize = 1;
+    result.elementStride = GetVertexAttributeStride(attribute, layout);
 
     switch (attribute)
     {
     case VertexAttribute::Position:
     case VertexAttribute::PrevPosition:
-        result.format = nvrhi::Format::RGB32_FLOAT;
-        result.elementStride = sizeof(float3);
+        result.format = compact ? nvrhi::Format::RGBA16_FLOAT : nvrhi::Format::RGB32_FLOAT;
         break;
     case VertexAttribute::TexCoord1:
     case VertexAttribute::TexCoord2:
-        result.format = nvrhi::Format::RG32_FLOAT;
-        result.elementStride = sizeof(float2);
+        result.format = compact ? nvrhi::Format::RG16_FLOAT : nvrhi::Format::RG32_FLOAT;
         break;
     case VertexAttribute::Normal:
     case VertexAttribute::Tangent:
         result.format = nvrhi::Format::RGBA8_SNORM;
-        result.elementStride = sizeof(uint32_t);
         break;
     case VertexAttribute::Transform:
         result.format = nvrhi::Format::RGBA32_FLOAT;
         result.arraySize = 3;
         result.offset = offsetof(InstanceData, transform);
-        result.elementStride = sizeof(InstanceData);
         result.isInstanced = true;
         break;
     case VertexAttribute::PrevTransform:
         result.format = nvrhi::Format::RGBA32_FLOAT;
         result.arraySize = 3;
         result.offset = offsetof(InstanceData, prevTransform);
-        result.elementStride = sizeof(InstanceData);
         result.isInstanced = true;
         break;
 
@@ -361,6 +391,80 @@ nvrhi::VertexAttributeDesc donut::engine::GetVertexAttributeDesc(VertexAttribute
     return result;
 }
 
+bool donut::engine::QuantizePositions(const float3* positions, size_t count, std::vector<float16_t4>& result)
+{
+    constexpr float c_MaxErrorRelativeToBounds = 1.f / 1024.f;
+
+    box3 bounds = box3::empty();
+    for (size_t i = 0; i < count; i++)
+        bounds |= positions[i];
+    const float maxError = count ? maxComponent(bounds.diagonal()) * c_MaxErrorRelativeToBounds : 0.f;
+
+    // Compare the decoded values with the inputs, which also rejects the values that overflow to infinity
+    result.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = Float32ToFloat16x4(float4(positions[i], 1.f));
+        const float3 error = abs(Float16ToFloat32x4(result[i]).xyz() - positions[i]);
+        if (!(maxComponent(error) <= maxError))
+            return false;
+    }
+    return true;
+}
+
+std::vector<float16_t2> donut::engine::QuantizeTexCoords(const float2* texCoords, size_t count)
+{
+    // Both arrays are tightly packed, so convert them as flat arrays of 2 * count values
+    static_assert(sizeof(float2) == 2 * sizeof(float) && sizeof(float16_t2) == 2 * sizeof(float16_t));
+    std::vector<float16_t2> result(count);
+    if (count != 0)
+        Float32ToFloat16(&texCoords[0].x, reinterpret_cast<float16_t*>(result.data()), count * 2);
+    return result;
+}
+
+std::vector<uint32_t> donut::engine::QuantizeJointWeights(const float4* weights, size_t count)
+{
+    std::vector<uint32_t> result(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const float4 w = max(weights[i], float4(0.f));
+        const float sum = w.x + w.y + w.z + w.w;
+        if (sum <= 0.f)
+        {
+            result[i] = 0;
+            continue;
+        }
+
+        // Round down, then hand out the remaining units to the largest remainders
+        // so that the decoded weights still sum up to exactly 1.
+        const float4 scaled = w * (255.f / sum);
+        uint32_t quantized[4];
+        float remainders[4];
+        int total = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            quantized[c] = std::min(uint32_t(scaled[c]), 255u);
+            remainders[c] = scaled[c] - float(quantized[c]);
+            total += int(quantized[c]);
+        }
+
+        for (; total < 255; total++)
+        {
+            int best = 0;
+            for (int c = 1; c < 4; c++)
+            {
+                if (remainders[c] > remainders[best])
+                    best = c;
+            }
+            quantized[best]++;
+            remainders[best] -= 1.f;
+        }
+
+        result[i] = quantized[0] | (quantized[1] << 8) | (quantized[2] << 16) | (quantized[3] << 24);
+    }
+    return result;
+}
+
 const char* donut::engine::MaterialDomainToString(MaterialDomain domain)
 {
     switch (domain)
@@ -132,9 +132,16 @@ void TextureCache::Reset()
 	std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
 
 	m_LoadedTextures.clear();
+    m_EvictedTextures.clear();
 
     m_TexturesRequested = 0;
     m_TexturesLoaded = 0;
+
+    m_ResidentBytes = 0;
+    m_AccessCounter = 0;
+    m_CacheHits = 0;
+    m_CacheMisses = 0;
+    m_Evictions = 0;
 }
 
 void TextureCache::SetGenerateMipmaps(bool generateMipmaps)
@@ -151,14 +158,25 @@ bool TextureCache::FindTextureInCache(const std::filesystem::path& path, std::sh
     texture = m_LoadedTextures[path.generic_string()];
     if (texture)
     {
+        texture->lastAccess = ++m_AccessCounter;
+        ++texture->accessCount;
+        ++m_CacheHits;
         return true;
     }
 
+    ++m_CacheMisses;
+
+    // Make room for the new texture before it's loaded.
+    if (m_MemoryBudget > 0)
+        EvictTexturesLocked(m_MemoryBudget);
+
     // Allocate a new texture slot for this file name and return it. Load the file later in a thread pool.
     // LoadTextureFromFileAsync function for a given scene is only called from one thread, so there is no 
     // chance of loading the same texture twice.
 
     texture = CreateTextureData();
+    texture->lastAccess = ++m_AccessCounter;
+    texture->accessCount = 1;
     m_LoadedTextures[path.generic_string()] = texture;
 
     ++m_TexturesRequested;
@@ -166,6 +184,167 @@ bool TextureCache::FindTextureInCache(const std::filesystem::path& path, std::sh
     return false;
 }
 
+static uint64_t GetTextureMemorySize(const nvrhi::TextureDesc& desc)
+{
+    const nvrhi::FormatInfo& formatInfo = nvrhi::getFormatInfo(desc.format);
+    const uint32_t blockSize = std::max<uint32_t>(formatInfo.blockSize, 1);
+
+    uint64_t size = 0;
+    for (uint32_t mipLevel = 0; mipLevel < desc.mipLevels; mipLevel++)
+    {
+        uint64_t widthInBlocks = (std::max(desc.width >> mipLevel, 1u) + blockSize - 1) / blockSize;
+        uint64_t heightInBlocks = (std::max(desc.height >> mipLevel, 1u) + blockSize - 1) / blockSize;
+        uint64_t depth = desc.dimension == nvrhi::TextureDimension::Texture3D ? std::max(desc.depth >> mipLevel, 1u) : 1;
+
+        size += widthInBlocks * heightInBlocks * depth * formatInfo.bytesPerBlock;
+    }
+
+    return size * desc.arraySize * std::max(desc.sampleCount, 1u);
+}
+
+void TextureCache::UpdateTextureResidency(const std::shared_ptr<TextureData>& texture)
+{
+    uint64_t size = 0;
+
+    if (texture->texture)
+        size += GetTextureMemorySize(texture->texture->getDesc());
+
+    if (texture->data)
+    {
+        for (const auto& arraySlice : texture->dataLayout)
+            for (const TextureSubresourceData& layout : arraySlice)
+                size += layout.dataSize;
+    }
+
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    // Textures loaded from memory are not cached and not counted.
+    auto it = m_LoadedTextures.find(texture->path);
+    if (it == m_LoadedTextures.end() || it->second != texture)
+        return;
+
+    m_ResidentBytes = m_ResidentBytes - texture->residentBytes + size;
+    texture->residentBytes = size;
+
+    if (m_MemoryBudget > 0)
+        EvictTexturesLocked(m_MemoryBudget);
+}
+
+uint32_t TextureCache::EvictTexturesLocked(uint64_t targetBytes)
+{
+    if (m_ResidentBytes <= targetBytes)
+        return 0;
+
+    // Only the textures that nobody else references can be evicted: other references mean that the texture
+    // is used by a material, or is still being loaded or waiting for upload.
+    std::vector<decltype(m_LoadedTextures)::iterator> candidates;
+    for (auto it = m_LoadedTextures.begin(); it != m_LoadedTextures.end(); ++it)
+    {
+        if (it->second && it->second.use_count() == 1)
+            candidates.push_back(it);
+    }
+
+    if (m_EvictionPolicy == TextureEvictionPolicy::LeastFrequentlyUsed)
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+        {
+            if (a->second->accessCount != b->second->accessCount)
+                return a->second->accessCount < b->second->accessCount;
+            return a->second->lastAccess < b->second->lastAccess;
+        });
+    }
+    else
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+        {
+            return a->second->lastAccess < b->second->lastAccess;
+        });
+    }
+
+    uint32_t numEvicted = 0;
+    for (const auto& it : candidates)
+    {
+        if (m_ResidentBytes <= targetBytes)
+            break;
+
+        m_ResidentBytes -= it->second->residentBytes;
+        m_EvictedTextures.push_back(std::move(it->second));
+        m_LoadedTextures.erase(it);
+        ++numEvicted;
+    }
+
+    m_Evictions += numEvicted;
+
+    return numEvicted;
+}
+
+void TextureCache::SetMemoryBudget(uint64_t bytes)
+{
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    m_MemoryBudget = bytes;
+
+    if (m_MemoryBudget > 0)
+        EvictTexturesLocked(m_MemoryBudget);
+}
+
+uint64_t TextureCache::GetMemoryBudget() const
+{
+    std::shared_lock<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    return m_MemoryBudget;
+}
+
+void TextureCache::SetEvictionPolicy(TextureEvictionPolicy policy)
+{
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    m_EvictionPolicy = policy;
+}
+
+uint32_t TextureCache::EnforceMemoryBudget()
+{
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    return m_MemoryBudget > 0 ? EvictTexturesLocked(m_MemoryBudget) : 0;
+}
+
+uint32_t TextureCache::EvictUnusedTextures()
+{
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    return EvictTexturesLocked(0);
+}
+
+TextureCacheStats TextureCache::GetStats() const
+{
+    std::shared_lock<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    TextureCacheStats stats;
+    stats.hits = m_CacheHits;
+    stats.misses = m_CacheMisses;
+    stats.evictions = m_Evictions;
+    stats.residentBytes = m_ResidentBytes;
+    stats.memoryBudget = m_MemoryBudget;
+
+    for (const auto& [path, texture] : m_LoadedTextures)
+    {
+        if (texture)
+            ++stats.residentTextures;
+    }
+
+    return stats;
+}
+
+void TextureCache::ResetStats()
+{
+    std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+    m_CacheHits = 0;
+    m_CacheMisses = 0;
+    m_Evictions = 0;
+}
+
 std::shared_ptr<IBlob> TextureCache::ReadTextureFile(const std::filesystem::path& path) const
 {
     auto fileData = m_fs->readFile(path);
@@ -176,6 +355,137 @@ std::shared_ptr<IBlob> TextureCache::ReadTextureFile(const std::filesystem::path
     return fileData;
 }
 
+static bool IsPowerOfTwo(uint32_t x)
+{
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+bool TextureCache::LoadTextureFileData(const std::filesystem::path& path, const std::shared_ptr<TextureData>& texture)
+{
+    if (m_MipStreaming)
+    {
+        bool streamable = false;
+        if (LoadDDSMipTail(path, texture, streamable))
+            return true;
+
+        if (streamable)
+            return false;
+    }
+
+    auto fileData = ReadTextureFile(path);
+    if (!fileData)
+        return false;
+
+    return FillTextureData(fileData, texture, path.extension().generic_string(), "");
+}
+
+bool TextureCache::LoadDDSMipTail(const std::filesystem::path& path, const std::shared_ptr<TextureData>& texture, bool& streamable) const
+{
+    streamable = false;
+
+    std::string extension = path.extension().generic_string();
+    if (extension != ".dds" && extension != ".DDS")
+        return false;
+
+    // If the header can't be read, let the regular loading path report the error.
+    auto headerData = m_fs->readFileRange(path, 0, DDSMaxHeaderSize);
+    if (!headerData || !LoadDDSTextureHeader(*texture, headerData->data(), headerData->size()))
+        return false;
+
+    if (texture->dimension == nvrhi::TextureDimension::Texture3D || texture->mipLevels < 2 ||
+        !IsPowerOfTwo(texture->width) || !IsPowerOfTwo(texture->height))
+        return false;
+
+    // The tail starts at the first mip that fits into the tail size, but the first resident mip must stay at least
+    // 4x4 pixels so that block compressed textures are still valid.
+    uint32_t tailMip = 0;
+    while (tailMip + 1 < texture->mipLevels &&
+        std::max(texture->width, texture->height) >> tailMip > m_MipTailSize &&
+        std::min(texture->width, texture->height) >> (tailMip + 1) >= 4)
+    {
+        ++tailMip;
+    }
+
+    if (tailMip == 0)
+        return false;
+
+    streamable = true;
+
+    auto streaming = std::make_shared<TextureStreamingState>();
+    streaming->width = texture->width;
+    streaming->height = texture->height;
+    streaming->mipLevels = texture->mipLevels;
+    streaming->fileLayout = std::move(texture->dataLayout);
+    streaming->tailMip = tailMip;
+    streaming->residentMip = tailMip;
+    streaming->desiredMip = tailMip;
+
+    texture->data = ReadTextureMips(path, *streaming, tailMip, texture->dataLayout);
+    if (!texture->data)
+    {
+        log::message(m_ErrorLogSeverity, "Couldn't read the mip tail of texture '%s'", path.generic_string().c_str());
+        return false;
+    }
+
+    texture->width = std::max(streaming->width >> tailMip, 1u);
+    texture->height = std::max(streaming->height >> tailMip, 1u);
+    texture->mipLevels = streaming->mipLevels - tailMip;
+    texture->streaming = std::move(streaming);
+
+    return true;
+}
+
+std::shared_ptr<IBlob> TextureCache::ReadTextureMips(
+    const std::filesystem::path& path,
+    const TextureStreamingState& streaming,
+    uint32_t firstMip,
+    std::vector<std::vector<TextureSubresourceData>>& dataLayout) const
+{
+    assert(firstMip < streaming.mipLevels);
+
+    // The mips of each array slice are stored together in a DDS file, so the mips from 'firstMip' to the end of
+    // the chain are one contiguous range per slice. The ranges are packed into one blob for the upload.
+    size_t totalSize = 0;
+    for (const auto& sliceLayout : streaming.fileLayout)
+    {
+        for (uint32_t mipLevel = firstMip; mipLevel < streaming.mipLevels; mipLevel++)
+            totalSize += sliceLayout[mipLevel].dataSize;
+    }
+
+    char* data = static_cast<char*>(malloc(totalSize));
+    if (!data)
+        return nullptr;
+
+    auto blob = std::make_shared<Blob>(data, totalSize);
+
+    dataLayout.clear();
+    dataLayout.resize(streaming.fileLayout.size());
+
+    ptrdiff_t dataOffset = 0;
+    for (size_t arraySlice = 0; arraySlice < streaming.fileLayout.size(); arraySlice++)
+    {
+        const auto& sliceLayout = streaming.fileLayout[arraySlice];
+        const TextureSubresourceData& firstLayout = sliceLayout[firstMip];
+        const TextureSubresourceData& lastLayout = sliceLayout[streaming.mipLevels - 1];
+        size_t rangeSize = size_t(lastLayout.dataOffset - firstLayout.dataOffset) + lastLayout.dataSize;
+
+        auto rangeData = m_fs->readFileRange(path, uint64_t(firstLayout.dataOffset), rangeSize);
+        if (!rangeData || rangeData->size() < rangeSize)
+            return nullptr;
+
+        for (uint32_t mipLevel = firstMip; mipLevel < streaming.mipLevels; mipLevel++)
+        {
+            TextureSubresourceData layout = sliceLayout[mipLevel];
+            memcpy(data + dataOffset, static_cast<const char*>(rangeData->data()) + (layout.dataOffset - firstLayout.dataOffset), layout.dataSize);
+            layout.dataOffset = dataOffset;
+            dataOffset += ptrdiff_t(layout.dataSize);
+            dataLayout[arraySlice].push_back(layout);
+        }
+    }
+
+    return blob;
+}
+
 std::shared_ptr<TextureData> TextureCache::CreateTextureData()
 {
     return std::make_shared<TextureData>();
@@ -469,6 +779,9 @@ void TextureCache::FinalizeTexture(
     commandList->commitBarriers();
 
     ++m_TexturesFinalized;
+    texture->finalized = true;
+
+    UpdateTextureResidency(texture);
 }
 
 void TextureCache::TextureLoaded(std::shared_ptr<TextureData> texture)
@@ -497,15 +810,11 @@ std::shared_ptr<LoadedTexture> TextureCache::LoadTextureFromFile(
     texture->forceSRGB = sRGB;
     texture->path = path.generic_string();
 
-    auto fileData = ReadTextureFile(path);
-    if (fileData)
+    if (LoadTextureFileData(path, texture))
     {
-        if (FillTextureData(fileData, texture, path.extension().generic_string(), ""))
-        {
-            TextureLoaded(texture);
+        TextureLoaded(texture);
 
-            FinalizeTexture(texture, passes, commandList);
-        }
+        FinalizeTexture(texture, passes, commandList);
     }
 
     ++m_TexturesLoaded;
@@ -525,17 +834,15 @@ std::shared_ptr<LoadedTexture> TextureCache::LoadTextureFromFileDeferred(
     texture->forceSRGB = sRGB;
     texture->path = path.generic_string();
 
-    auto fileData = ReadTextureFile(path);
-    if (fileData)
+    if (LoadTextureFileData(path, texture))
     {
-        if (FillTextureData(fileData, texture, path.extension().generic_string(), ""))
-        {
-            TextureLoaded(texture);
+        TextureLoaded(texture);
 
-            std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
+        UpdateTextureResidency(texture);
 
-            m_TexturesToFinalize.push(texture);
-        }
+        std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
+
+        m_TexturesToFinalize.push(texture);
     }
 
     ++m_TexturesLoaded;
@@ -558,21 +865,19 @@ std::shared_ptr<LoadedTexture> TextureCache::LoadTextureFromFileAsync(
 
     threadPool.AddTask([this, texture, path]()
     {
-        auto fileData = ReadTextureFile(path);
-        if (fileData)
+        if (LoadTextureFileData(path, texture))
         {
-            if (FillTextureData(fileData, texture, path.extension().generic_string(), ""))
-            {
-                TextureLoaded(texture);
+            TextureLoaded(texture);
 
-                std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
+            UpdateTextureResidency(texture);
 
-                m_TexturesToFinalize.push(texture);
-            }
+            std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
+
+            m_TexturesToFinalize.push(texture);
         }
 
         ++m_TexturesLoaded;
-    });
+    }, ThreadPoolPriority::Low);
 
     return texture;
 }
@@ -602,7 +907,7 @@ std::shared_ptr<LoadedTexture> TextureCache::LoadTextureFromMemoryAsync(
             }
 
             ++m_TexturesLoaded;
-        });
+        }, ThreadPoolPriority::Low);
 
     return texture;
 }
@@ -672,10 +977,19 @@ bool TextureCache::ProcessRenderingThreadCommands(CommonRenderPasses& passes, fl
 
     time_point<high_resolution_clock> startTime = high_resolution_clock::now();
 
+    // Release the evicted textures here and not on the thread that evicted them, see m_EvictedTextures.
+    std::vector<std::shared_ptr<TextureData>> evictedTextures;
+    {
+        std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+        evictedTextures.swap(m_EvictedTextures);
+    }
+    evictedTextures.clear();
+
     uint commandsExecuted = 0;
     while (true)
     {
         std::shared_ptr<TextureData> pTexture;
+        TextureMipUpload mipUpload;
 
         if (timeLimitMilliseconds > 0 && commandsExecuted > 0)
         {
@@ -688,14 +1002,38 @@ bool TextureCache::ProcessRenderingThreadCommands(CommonRenderPasses& passes, fl
         {
             std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
 
-            if (m_TexturesToFinalize.empty())
+            if (!m_TexturesToFinalize.empty())
+            {
+                pTexture = m_TexturesToFinalize.front();
+                m_TexturesToFinalize.pop();
+            }
+            else if (!m_MipUploads.empty())
+            {
+                mipUpload = std::move(m_MipUploads.front());
+                m_MipUploads.pop();
+            }
+            else
                 break;
-
-            pTexture = m_TexturesToFinalize.front();
-            m_TexturesToFinalize.pop();
         }
 
-        if (pTexture->data)
+        if (mipUpload.texture)
+        {
+            commandsExecuted += 1;
+
+            if (!m_CommandList)
+            {
+                m_CommandList = m_Device->createCommandList();
+            }
+
+            m_CommandList->open();
+
+            UploadTextureMips(mipUpload, m_CommandList);
+
+            m_CommandList->close();
+            m_Device->executeCommandList(m_CommandList);
+            m_Device->runGarbageCollection();
+        }
+        else if (pTexture->data)
         {
             commandsExecuted += 1;
 
@@ -727,6 +1065,154 @@ void TextureCache::SetMaxTextureSize(uint32_t size)
 	m_MaxTextureSize = size;
 }
 
+void TextureCache::SetMipStreaming(bool enable, uint32_t mipTailSize)
+{
+    m_MipStreaming = enable;
+    m_MipTailSize = std::max(mipTailSize, 4u);
+}
+
+void TextureCache::SetDesiredMipLevel(const std::shared_ptr<LoadedTexture>& _texture, uint32_t mipLevel)
+{
+    TextureData* texture = static_cast<TextureData*>(_texture.get());
+    if (!texture || !texture->finalized || !texture->streaming)
+        return;
+
+    texture->streaming->desiredMip = std::min(mipLevel, texture->streaming->tailMip);
+}
+
+void TextureCache::RequestMipForScreenSize(const std::shared_ptr<LoadedTexture>& _texture, float screenSizeInPixels)
+{
+    TextureData* texture = static_cast<TextureData*>(_texture.get());
+    if (!texture || !texture->finalized || !texture->streaming)
+        return;
+
+    const TextureStreamingState& streaming = *texture->streaming;
+    float textureSize = float(std::max(streaming.width, streaming.height));
+
+    uint32_t mipLevel = 0;
+    if (screenSizeInPixels <= 0.f)
+        mipLevel = streaming.tailMip;
+    else if (textureSize > screenSizeInPixels)
+        mipLevel = uint32_t(std::floor(std::log2(textureSize / screenSizeInPixels)));
+
+    SetDesiredMipLevel(_texture, mipLevel);
+}
+
+uint32_t TextureCache::GetResidentMipLevel(const std::shared_ptr<LoadedTexture>& _texture)
+{
+    TextureData* texture = static_cast<TextureData*>(_texture.get());
+    if (!texture || !texture->finalized || !texture->streaming)
+        return 0;
+
+    return texture->streaming->residentMip;
+}
+
+void TextureCache::UpdateMipStreaming(ThreadPool& threadPool)
+{
+    std::vector<std::pair<std::shared_ptr<TextureData>, uint32_t>> requests;
+
+    {
+        std::shared_lock<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
+        bool overBudget = m_MemoryBudget > 0 && m_ResidentBytes > m_MemoryBudget;
+
+        for (const auto& [path, texture] : m_LoadedTextures)
+        {
+            // Skip textures that are not uploaded yet, or are not streaming, or are being updated.
+            if (!texture || !texture->finalized || !texture->streaming || texture->streaming->updatePending)
+                continue;
+
+            TextureStreamingState& streaming = *texture->streaming;
+            uint32_t desiredMip = streaming.desiredMip;
+
+            // Finer mips are loaded when requested, but only released under memory pressure,
+            // so that textures don't thrash between two levels.
+            if (desiredMip == streaming.residentMip || (desiredMip > streaming.residentMip && !overBudget))
+                continue;
+
+            streaming.updatePending = true;
+            requests.push_back(std::make_pair(texture, desiredMip));
+        }
+    }
+
+    for (const auto& [texture, firstMip] : requests)
+    {
+        threadPool.AddTask([this, texture = texture, firstMip = firstMip]()
+        {
+            TextureMipUpload upload;
+            upload.texture = texture;
+            upload.firstMip = firstMip;
+            upload.data = ReadTextureMips(texture->path, *texture->streaming, firstMip, upload.dataLayout);
+
+            if (!upload.data)
+            {
+                log::message(m_ErrorLogSeverity, "Couldn't read mip %d of texture '%s'", firstMip, texture->path.c_str());
+                texture->streaming->updatePending = false;
+                return;
+            }
+
+            std::lock_guard<std::mutex> guard(m_TexturesToFinalizeMutex);
+
+            m_MipUploads.push(std::move(upload));
+        }, ThreadPoolPriority::Low);
+    }
+}
+
+void TextureCache::UploadTextureMips(TextureMipUpload& upload, nvrhi::ICommandList* commandList)
+{
+    TextureData& texture = *upload.texture;
+    TextureStreamingState& streaming = *texture.streaming;
+
+    // Resident mips are replaced by creating a new texture with the new mip chain, because the old one
+    // is in a permanent state and can't be copied from. The bindless descriptor keeps its index.
+    nvrhi::TextureDesc textureDesc = texture.texture->getDesc();
+    textureDesc.width = std::max(streaming.width >> upload.firstMip, 1u);
+    textureDesc.height = std::max(streaming.height >> upload.firstMip, 1u);
+    textureDesc.mipLevels = streaming.mipLevels - upload.firstMip;
+
+    nvrhi::TextureHandle newTexture = m_Device->createTexture(textureDesc);
+    if (!newTexture)
+    {
+        streaming.updatePending = false;
+        return;
+    }
+
+    commandList->beginTrackingTextureState(newTexture, nvrhi::AllSubresources, nvrhi::ResourceStates::Common);
+
+    const char* dataPointer = static_cast<const char*>(upload.data->data());
+
+    for (uint32_t arraySlice = 0; arraySlice < textureDesc.arraySize; arraySlice++)
+    {
+        for (uint32_t mipLevel = 0; mipLevel < textureDesc.mipLevels; mipLevel++)
+        {
+            const TextureSubresourceData& layout = upload.dataLayout[arraySlice][mipLevel];
+
+            commandList->writeTexture(newTexture, arraySlice, mipLevel, dataPointer + layout.dataOffset,
+                layout.rowPitch, layout.depthPitch);
+        }
+    }
+
+    commandList->setPermanentTextureState(newTexture, nvrhi::ResourceStates::ShaderResource);
+    commandList->commitBarriers();
+
+    texture.texture = newTexture;
+    ++texture.generation;
+    texture.width = textureDesc.width;
+    texture.height = textureDesc.height;
+    texture.mipLevels = textureDesc.mipLevels;
+
+    if (m_DescriptorTable && texture.bindlessDescriptor.IsValid())
+        m_DescriptorTable->ReplaceDescriptor(texture.bindlessDescriptor.Get(), nvrhi::BindingSetItem::Texture_SRV(0, newTexture));
+
+    log::message(m_InfoLogSeverity, "Changed the first resident mip from %d to %d: %s", streaming.residentMip,
+        upload.firstMip, texture.path.c_str());
+
+    streaming.residentMip = upload.firstMip;
+    streaming.updatePending = false;
+
+    UpdateTextureResidency(upload.texture);
+}
+
 #ifdef _MSC_VER 
 #define strcasecmp _stricmp
 #endif
@@ -897,11 +1383,16 @@ namespace donut::engine
 
     bool TextureCache::UnloadTexture(const std::shared_ptr<LoadedTexture>& texture)
     {
+        std::lock_guard<std::shared_mutex> guard(m_LoadedTexturesMutex);
+
         const auto& it = m_LoadedTextures.find(texture->path);
 
         if (it == m_LoadedTextures.end())
             return false;
 
+        if (it->second)
+            m_ResidentBytes -= it->second->residentBytes;
+
         m_LoadedTextures.erase(it);
 
         return true;
@@ -21,37 +21,32 @@
 */
 
 #include <donut/engine/ThreadPool.h>
+#include <algorithm>
 #include <cassert>
 
 namespace donut::engine
 {
 
-// A simple task wrapper for a function object
-class ThreadPoolFunctionTask : public ThreadPoolTask
+namespace
 {
-public:
-    ThreadPoolFunctionTask(std::function<void()>&& func)
-        : m_func(std::move(func))
-    { }
-
-    void Run() override
-    {
-        return m_func();
-    }
-
-private:
-    std::function<void()> m_func;
-};
+    // Identifies the pool and the queue of the current thread when it's a worker thread
+    thread_local const ThreadPool* t_currentPool = nullptr;
+    thread_local uint32_t t_workerIndex = 0;
+}
 
 ThreadPool::ThreadPool(uint32_t numThreads)
 {
     if (numThreads == 0)
         numThreads = std::thread::hardware_concurrency();
 
+    // Keep at least one queue so that tasks can be added and executed by the waiting threads
+    m_numQueues = std::max(numThreads, 1u);
+    m_queues = std::make_unique<WorkerQueue[]>(m_numQueues);
+
     m_threads.resize(numThreads);
     for (uint32_t i = 0; i < numThreads; ++i)
     {
-        m_threads[i] = std::thread(StaticThreadProc, this);
+        m_threads[i] = std::thread(StaticThreadProc, this, i);
     }
 }
 
@@ -59,7 +54,10 @@ ThreadPool::~ThreadPool()
 {
     WaitForTasks();
 
-    m_terminate.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_terminate.store(true);
+    }
 
     m_forward.notify_all();
 
@@ -67,30 +65,165 @@ ThreadPool::~ThreadPool()
         thread.join();
 }
 
-void ThreadPool::AddTask(std::shared_ptr<ThreadPoolTask> const& task)
+void ThreadPool::AddTask(std::shared_ptr<ThreadPoolTask> const& task, ThreadPoolPriority priority)
+{
+    Enqueue(ThreadPoolJob([task]() { task->Run(); }, nullptr), priority);
+}
+
+void ThreadPool::Enqueue(ThreadPoolJob&& job, ThreadPoolPriority priority)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    
-    m_tasks.push(task);
+    const size_t lane = size_t(priority);
+    assert(lane < c_NumPriorities);
+
+    // Tasks spawned by a worker go to its own queue, where they stay hot in its caches unless stolen
+    uint32_t queueIndex = (t_currentPool == this)
+        ? t_workerIndex
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_numQueues;
+
     ++m_pendingTasks;
 
-    m_forward.notify_one();
+    {
+        WorkerQueue& queue = m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.lanes[lane].push_back(std::move(job));
+        ++m_queuedTasks[lane];
+    }
+
+    // Only touch the mutex when some thread is sleeping. The sleeping threads register themselves
+    // before checking the queued task counts, so either they see this task or we see them.
+    if (m_sleepingThreads.load() != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_forward.notify_one();
+    }
 }
 
-void ThreadPool::AddTask(std::function<void()> func)
+bool ThreadPool::TryPopJob(ThreadPoolJob& job)
 {
-    std::shared_ptr<ThreadPoolFunctionTask> task = std::make_shared<ThreadPoolFunctionTask>(std::move(func));
-    AddTask(task);
+    const bool isWorker = t_currentPool == this;
+    const uint32_t ownQueue = isWorker ? t_workerIndex : 0;
+
+    for (size_t lane = 0; lane < c_NumPriorities; ++lane)
+    {
+        if (m_queuedTasks[lane].load() <= 0)
+            continue;
+
+        // Workers take the most recently added task from their own queue...
+        if (isWorker)
+        {
+            WorkerQueue& queue = m_queues[ownQueue];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& deque = queue.lanes[lane];
+            if (!deque.empty())
+            {
+                job = std::move(deque.back());
+                deque.pop_back();
+                --m_queuedTasks[lane];
+                return true;
+            }
+        }
+
+        // ...and steal the oldest tasks from the other queues
+        for (uint32_t offset = isWorker ? 1 : 0; offset < m_numQueues; ++offset)
+        {
+            WorkerQueue& queue = m_queues[(ownQueue + offset) % m_numQueues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& deque = queue.lanes[lane];
+            if (!deque.empty())
+            {
+                job = std::move(deque.front());
+                deque.pop_front();
+                --m_queuedTasks[lane];
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::RunPendingJob()
+{
+    ThreadPoolJob job;
+    if (!TryPopJob(job))
+        return false;
+
+    try
+    {
+        job();
+    }
+    catch(...)
+    {
+        // Ignore task exceptions
+    }
+
+    ThreadPoolTaskGroup* group = job.GetGroup();
+    bool notify = group && group->m_pendingTasks.fetch_sub(1) == 1;
+
+    // Release the function object and its captures before the task is reported as complete
+    job = ThreadPoolJob();
+
+    if (--m_pendingTasks == 0)
+        notify = true;
+
+    if (notify)
+        NotifyWaiters();
+
+    return true;
+}
+
+bool ThreadPool::HasQueuedTasks() const
+{
+    for (const auto& count : m_queuedTasks)
+    {
+        if (count.load() > 0)
+            return true;
+    }
+    return false;
+}
+
+void ThreadPool::NotifyWaiters()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_forward.notify_all();
+}
+
+void ThreadPool::WaitUntil(std::function<bool()> const& isDone)
+{
+    while (!isDone())
+    {
+        // Help with the queued tasks instead of spinning
+        if (RunPendingJob())
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_sleepingThreads;
+        m_forward.wait(lock, [this, &isDone]()
+        {
+            return isDone() || HasQueuedTasks();
+        });
+        --m_sleepingThreads;
+    }
 }
 
 void ThreadPool::WaitForTasks()
 {
-    while(m_pendingTasks.load() != 0)
-        std::this_thread::yield();
+    WaitUntil([this]() { return m_pendingTasks.load() == 0; });
+}
+
+void ThreadPool::Wait(ThreadPoolTaskGroup& group)
+{
+    WaitUntil([&group]() { return group.IsDone(); });
 }
 
-void ThreadPool::StaticThreadProc(ThreadPool* self)
+void ThreadPool::StaticThreadProc(ThreadPool* self, uint32_t workerIndex)
 {
+    t_currentPool = self;
+    t_workerIndex = workerIndex;
     self->ThreadProc();
 }
 
@@ -98,33 +231,18 @@ void ThreadPool::ThreadProc()
 {
     while(!m_terminate.load())
     {
-        std::shared_ptr<ThreadPoolTask> task;
-        
-        // Wait until a task is available or termination is requested
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_forward.wait(lock, [this] { return !m_tasks.empty() || m_terminate.load(); });
-
-            if (!m_tasks.empty())
-            {
-                task = std::move(m_tasks.front());
-                m_tasks.pop();
-            }
-        }
+        if (RunPendingJob())
+            continue;
 
-        if (task)
+        // Wait until a task is available or termination is requested
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_sleepingThreads;
+        m_forward.wait(lock, [this]
         {
-            try
-            {
-                task->Run();
-            }
-            catch(...)
-            {
-                // Ignore task exceptions
-            }
-            --m_pendingTasks;
-        }
+            return m_terminate.load() || HasQueuedTasks();
+        });
+        --m_sleepingThreads;
     }
 }
 
-}
\ No newline at end of file
+}
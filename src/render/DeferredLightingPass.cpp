@@ -23,6 +23,7 @@
 #include <donut/render/DeferredLightingPass.h>
 #include <donut/render/DrawStrategy.h>
 #include <donut/render/GBuffer.h>
+#include <donut/render/LightClusterBuffers.h>
 #include <donut/engine/FramebufferFactory.h>
 #include <donut/engine/ShaderFactory.h>
 #include <donut/engine/ShadowMap.h>
@@ -85,6 +86,8 @@ void donut::render::DeferredLightingPass::Init(const std::shared_ptr<engine::Sha
     constantBufferDesc.isVolatile = true;
     constantBufferDesc.maxVersions = c_MaxRenderPassConstantBufferVersions;
     m_DeferredLightingCB = m_Device->createBuffer(constantBufferDesc);
+
+    m_LightClusters = std::make_shared<LightClusterBuffers>(m_Device);
     
     {
         nvrhi::BindingLayoutDesc layoutDesc;
@@ -95,6 +98,9 @@ void donut::render::DeferredLightingPass::Init(const std::shared_ptr<engine::Sha
             nvrhi::BindingLayoutItem::Texture_SRV(1),
             nvrhi::BindingLayoutItem::Texture_SRV(2),
             nvrhi::BindingLayoutItem::Texture_SRV(3),
+            nvrhi::BindingLayoutItem::StructuredBuffer_SRV(4),
+            nvrhi::BindingLayoutItem::StructuredBuffer_SRV(5),
+            nvrhi::BindingLayoutItem::StructuredBuffer_SRV(6),
             nvrhi::BindingLayoutItem::Texture_SRV(8),
             nvrhi::BindingLayoutItem::Texture_SRV(9),
             nvrhi::BindingLayoutItem::Texture_SRV(10),
@@ -160,6 +166,9 @@ void DeferredLightingPass::Render(
     {
         for (const auto& light : *inputs.lights)
         {
+            if (LightClusterBuffers::IsClusteredLight(*light))
+                continue;
+
             if (light->shadowMap)
             {
                 if (!shadowMapTexture)
@@ -212,7 +221,11 @@ void DeferredLightingPass::Render(
 
             ++deferredConstants.numLights;
         }
+
+        m_LightClusters->SetLights(commandList, *inputs.lights);
     }
+    else
+        m_LightClusters->SetLights(commandList, {});
 
     nvrhi::ITexture* lightProbeDiffuse = nullptr;
     nvrhi::ITexture* lightProbeSpecular = nullptr;
@@ -260,6 +273,9 @@ void DeferredLightingPass::Render(
         const IView* view = compositeView.GetChildView(ViewType::PLANAR, viewIndex);
         auto viewSubresources = view->GetSubresources();
 
+        // Binning may grow the cluster buffers, so it goes before the binding set lookup
+        m_LightClusters->BinLights(commandList, *view, deferredConstants.lightClusters);
+
         nvrhi::BindingSetDesc bindingSetDesc;
         bindingSetDesc.bindings = {
             nvrhi::BindingSetItem::ConstantBuffer(0, m_DeferredLightingCB),
@@ -267,6 +283,9 @@ void DeferredLightingPass::Render(
             nvrhi::BindingSetItem::Texture_SRV(1, lightProbeDiffuse ? lightProbeDiffuse : m_CommonPasses->m_BlackCubeMapArray.Get()),
             nvrhi::BindingSetItem::Texture_SRV(2, lightProbeSpecular ? lightProbeSpecular : m_CommonPasses->m_BlackCubeMapArray.Get()),
             nvrhi::BindingSetItem::Texture_SRV(3, lightProbeEnvironmentBrdf ? lightProbeEnvironmentBrdf : m_CommonPasses->m_BlackTexture.Get()),
+            nvrhi::BindingSetItem::StructuredBuffer_SRV(4, m_LightClusters->GetClusterBuffer()),
+            nvrhi::BindingSetItem::StructuredBuffer_SRV(5, m_LightClusters->GetIndexBuffer()),
+            nvrhi::BindingSetItem::StructuredBuffer_SRV(6, m_LightClusters->GetLightBuffer()),
             nvrhi::BindingSetItem::Texture_SRV(8, inputs.depth, nvrhi::Format::UNKNOWN, viewSubresources),
             nvrhi::BindingSetItem::Texture_SRV(9, inputs.gbufferDiffuse, nvrhi::Format::UNKNOWN, viewSubresources),
             nvrhi::BindingSetItem::Texture_SRV(10, inputs.gbufferSpecular, nvrhi::Format::UNKNOWN, viewSubresources),
@@ -67,10 +67,19 @@ DepthPass::DepthPass(
 void DepthPass::Init(ShaderFactory& shaderFactory, const CreateParameters& params)
 {
     m_UseInputAssembler = params.useInputAssembler;
-
-    m_VertexShader = CreateVertexShader(shaderFactory, params);
+    m_VertexLayout = params.vertexLayout;
+
+    // The full layout is always supported, the compact one only when requested
+    CreateParameters fullLayoutParams = params;
+    fullLayoutParams.vertexLayout = VertexLayout::Full;
+    m_VertexShader = CreateVertexShader(shaderFactory, fullLayoutParams);
+    m_InputLayout = CreateInputLayout(m_VertexShader, fullLayoutParams);
+    if (params.vertexLayout == VertexLayout::Compact)
+    {
+        m_CompactVertexShader = CreateVertexShader(shaderFactory, params);
+        m_CompactInputLayout = CreateInputLayout(m_CompactVertexShader, params);
+    }
     m_PixelShader = CreatePixelShader(shaderFactory, params);
-    m_InputLayout = CreateInputLayout(m_VertexShader, params);
     m_InputBindingLayout = CreateInputBindingLayout();
 
     if (params.materialBindings)
@@ -98,15 +107,18 @@ nvrhi::ShaderHandle DepthPass::CreateVertexShader(ShaderFactory& shaderFactory,
 {
     char const* sourceFileName = "donut/passes/depth_vs.hlsl";
 
+    std::vector<ShaderMacro> VertexShaderMacros;
+    VertexShaderMacros.push_back(ShaderMacro("COMPACT_VERTICES", params.vertexLayout == VertexLayout::Compact ? "1" : "0"));
+
     if (params.useInputAssembler)
     {
         return shaderFactory.CreateAutoShader(sourceFileName, "input_assembler",
-            DONUT_MAKE_PLATFORM_SHADER(g_depth_vs_input_assembler), nullptr, nvrhi::ShaderType::Vertex);
+            DONUT_MAKE_PLATFORM_SHADER(g_depth_vs_input_assembler), &VertexShaderMacros, nvrhi::ShaderType::Vertex);
     }
     else
     {
         return shaderFactory.CreateAutoShader(sourceFileName, "buffer_loads",
-            DONUT_MAKE_PLATFORM_SHADER(g_depth_vs_buffer_loads), nullptr, nvrhi::ShaderType::Vertex);
+            DONUT_MAKE_PLATFORM_SHADER(g_depth_vs_buffer_loads), &VertexShaderMacros, nvrhi::ShaderType::Vertex);
     }
 }
 
@@ -121,8 +133,8 @@ nvrhi::InputLayoutHandle DepthPass::CreateInputLayout(nvrhi::IShader* vertexShad
     {
         nvrhi::VertexAttributeDesc aInputDescs[] =
         {
-            GetVertexAttributeDesc(VertexAttribute::Position, "POSITION", 0),
-            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 1),
+            GetVertexAttributeDesc(VertexAttribute::Position, "POSITION", 0, params.vertexLayout),
+            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 1, params.vertexLayout),
             GetVertexAttributeDesc(VertexAttribute::Transform, "TRANSFORM", 2)
         };
 
@@ -174,8 +186,8 @@ nvrhi::GraphicsPipelineHandle DepthPass::CreateGraphicsPipeline(PipelineKey key,
     nvrhi::FramebufferInfo const& framebufferInfo)
 {
     nvrhi::GraphicsPipelineDesc pipelineDesc;
-    pipelineDesc.inputLayout = m_InputLayout;
-    pipelineDesc.VS = m_VertexShader;
+    pipelineDesc.inputLayout = key.bits.compactVertices ? m_CompactInputLayout : m_InputLayout;
+    pipelineDesc.VS = key.bits.compactVertices ? m_CompactVertexShader : m_VertexShader;
     pipelineDesc.PS = nullptr;
     pipelineDesc.renderState.rasterState.depthBias = m_DepthBias;
     pipelineDesc.renderState.rasterState.depthBiasClamp = m_DepthBiasClamp;
@@ -344,6 +356,8 @@ void DepthPass::SetupInputBuffers(GeometryPassContext& abstractContext, const en
 {
     auto& context = static_cast<Context&>(abstractContext);
 
+    assert(buffers->vertexLayout == VertexLayout::Full || m_VertexLayout == VertexLayout::Compact);
+    context.keyTemplate.bits.compactVertices = buffers->vertexLayout == VertexLayout::Compact;
     state.indexBuffer = { buffers->indexBuffer, nvrhi::Format::R32_UINT, 0 };
 
     if (m_UseInputAssembler)
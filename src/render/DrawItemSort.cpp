@@ -0,0 +1,232 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/render/DrawItemSort.h>
+#include <donut/render/GeometryPasses.h>
+#include <donut/engine/SceneGraph.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace donut::engine;
+using namespace donut::render;
+
+// Sequences shorter than this are sorted with insertion sort, which is faster than the radix passes.
+static constexpr size_t c_InsertionSortThreshold = 32;
+
+SortKeyLayout& SortKeyLayout::Add(SortKeyField field, uint32_t bits)
+{
+    bool isDepth = field == SortKeyField::DepthFrontToBack || field == SortKeyField::DepthBackToFront;
+    bits = std::min(bits, isDepth ? 32u : 64u);
+
+    if (bits == 0 || m_NumFields >= MaxFields || m_TotalBits + bits > 64)
+        return *this;
+
+    m_Fields[m_NumFields++] = Field{ field, uint8_t(bits) };
+    m_TotalBits += bits;
+    return *this;
+}
+
+static uint64_t GetFieldValue(const DrawItem& item, SortKeyField field, uint32_t bits)
+{
+    uint64_t value = 0;
+    switch (field)
+    {
+    case SortKeyField::Material:
+        value = item.material ? uint64_t(uint32_t(item.material->materialID)) : 0;
+        break;
+    case SortKeyField::BufferGroup:
+        value = item.buffers ? uint64_t(uint32_t(item.buffers->globalBufferGroupIndex)) : 0;
+        break;
+    case SortKeyField::Mesh:
+        value = item.mesh ? uint64_t(uint32_t(item.mesh->globalMeshIndex)) : 0;
+        break;
+    case SortKeyField::Instance:
+        value = item.instance ? uint64_t(uint32_t(item.instance->GetInstanceIndex())) : 0;
+        break;
+    case SortKeyField::Geometry:
+        value = item.geometry ? uint64_t(uint32_t(item.geometry->globalGeometryIndex)) : 0;
+        break;
+    case SortKeyField::CullMode:
+        value = (item.cullMode == nvrhi::RasterCullMode::Front) ? 0 : (item.cullMode == nvrhi::RasterCullMode::Back) ? 1 : 2;
+        break;
+    case SortKeyField::DepthFrontToBack:
+    case SortKeyField::DepthBackToFront: {
+        float distance = (item.distanceToCamera > 0.f) ? item.distanceToCamera : 0.f; // also maps NaN to 0
+        uint32_t distanceBits;
+        memcpy(&distanceBits, &distance, sizeof(distanceBits));
+        value = distanceBits >> (32 - bits);
+        if (field == SortKeyField::DepthBackToFront)
+            value = ~value;
+        break;
+    }
+    }
+
+    return (bits < 64) ? (value & ((uint64_t(1) << bits) - 1)) : value;
+}
+
+uint64_t SortKeyLayout::MakeKey(const DrawItem& item) const
+{
+    uint64_t key = 0;
+    uint32_t shift = 64;
+    for (uint32_t i = 0; i < m_NumFields; i++)
+    {
+        const Field& field = m_Fields[i];
+        shift -= field.bits;
+        key |= GetFieldValue(item, field.field, field.bits) << shift;
+    }
+    return key;
+}
+
+bool SortKeyLayout::UsesDepth() const
+{
+    for (uint32_t i = 0; i < m_NumFields; i++)
+    {
+        if (m_Fields[i].field == SortKeyField::DepthFrontToBack || m_Fields[i].field == SortKeyField::DepthBackToFront)
+            return true;
+    }
+    return false;
+}
+
+bool SortKeyLayout::operator==(const SortKeyLayout& other) const
+{
+    if (m_NumFields != other.m_NumFields)
+        return false;
+
+    for (uint32_t i = 0; i < m_NumFields; i++)
+    {
+        if (m_Fields[i].field != other.m_Fields[i].field || m_Fields[i].bits != other.m_Fields[i].bits)
+            return false;
+    }
+    return true;
+}
+
+SortKeyLayout SortKeyLayout::Opaque()
+{
+    return SortKeyLayout()
+        .Add(SortKeyField::Material, 16)
+        .Add(SortKeyField::BufferGroup, 12)
+        .Add(SortKeyField::Mesh, 16)
+        .Add(SortKeyField::Instance, 20);
+}
+
+SortKeyLayout SortKeyLayout::OpaqueFrontToBack()
+{
+    return SortKeyLayout()
+        .Add(SortKeyField::DepthFrontToBack, 16)
+        .Add(SortKeyField::Material, 16)
+        .Add(SortKeyField::BufferGroup, 12)
+        .Add(SortKeyField::Mesh, 20);
+}
+
+SortKeyLayout SortKeyLayout::Transparent()
+{
+    return SortKeyLayout()
+        .Add(SortKeyField::DepthBackToFront, 32)
+        .Add(SortKeyField::Instance, 30)
+        .Add(SortKeyField::CullMode, 2);
+}
+
+void donut::render::RadixSortKeys(
+    std::vector<uint64_t>& keys,
+    std::vector<uint32_t>& indices,
+    std::vector<uint64_t>& scratchKeys,
+    std::vector<uint32_t>& scratchIndices)
+{
+    const size_t count = keys.size();
+    indices.resize(count);
+    for (size_t i = 0; i < count; i++)
+        indices[i] = uint32_t(i);
+
+    if (count < c_InsertionSortThreshold)
+    {
+        for (size_t i = 1; i < count; i++)
+        {
+            uint64_t key = keys[i];
+            uint32_t index = indices[i];
+            size_t j = i;
+            for (; j > 0 && keys[j - 1] > key; j--)
+            {
+                keys[j] = keys[j - 1];
+                indices[j] = indices[j - 1];
+            }
+            keys[j] = key;
+            indices[j] = index;
+        }
+        return;
+    }
+
+    // Build the histograms of all 8 digits in one pass
+    constexpr int numPasses = 8;
+    std::vector<uint32_t> histograms(numPasses * 256, 0);
+    for (uint64_t key : keys)
+    {
+        for (int pass = 0; pass < numPasses; pass++)
+            ++histograms[pass * 256 + ((key >> (pass * 8)) & 0xff)];
+    }
+
+    scratchKeys.resize(count);
+    scratchIndices.resize(count);
+
+    for (int pass = 0; pass < numPasses; pass++)
+    {
+        uint32_t* histogram = histograms.data() + pass * 256;
+        const int shift = pass * 8;
+
+        // All keys have the same digit, this pass wouldn't change the order
+        if (histogram[(keys[0] >> shift) & 0xff] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; digit++)
+        {
+            uint32_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint64_t key = keys[i];
+            uint32_t destination = histogram[(key >> shift) & 0xff]++;
+            scratchKeys[destination] = key;
+            scratchIndices[destination] = indices[i];
+        }
+
+        keys.swap(scratchKeys);
+        indices.swap(scratchIndices);
+    }
+}
+
+void DrawItemSorter::Sort(const DrawItem** items, size_t count, const SortKeyLayout& layout)
+{
+    if (count < 2)
+        return;
+
+    m_Keys.resize(count);
+    for (size_t i = 0; i < count; i++)
+        m_Keys[i] = layout.MakeKey(*items[i]);
+
+    RadixSortKeys(m_Keys, m_Indices, m_ScratchKeys, m_ScratchIndices);
+
+    m_ScratchItems.assign(items, items + count);
+    for (size_t i = 0; i < count; i++)
+        items[i] = m_ScratchItems[m_Indices[i]];
+}
@@ -24,6 +24,11 @@
 #include <donut/render/GeometryPasses.h>
 #include <donut/engine/SceneGraph.h>
 #include <donut/engine/View.h>
+#include <donut/engine/OcclusionBuffer.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/engine/MeshSimplifier.h>
+#include <iterator>
+#include <limits>
 
 using namespace donut::math;
 using namespace donut::engine;
@@ -47,18 +52,214 @@ void PassthroughDrawStrategy::SetData(const DrawItem* data, size_t count)
     m_Count = count;
 }
 
-static int CompareDrawItemsOpaque(const DrawItem* a, const DrawItem* b)
+static void SortDrawItems(DrawItemSorter& sorter, std::vector<const DrawItem*>& items, const SortKeyLayout& layout)
 {
-    if (a->material != b->material)
-        return a->material < b->material;
+    if (items.size() > 1)
+        sorter.Sort(items.data(), items.size(), layout);
+}
+
+bool DrawListCache::IsValid(const List& list, const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::SceneGraph* graph)
+{
+    // Without a graph there are no versions to compare
+    if (!graph || !list.hasGraph || list.rootNode.lock() != rootNode)
+        return false;
+
+    if (list.structureVersion != graph->GetStructureVersion() || list.contentVersion != graph->GetContentVersion())
+        return false;
+
+    for (const auto& state : list.materials)
+    {
+        if (state.material->domain != state.domain || state.material->doubleSided != state.doubleSided)
+            return false;
+    }
+
+    return true;
+}
+
+void DrawListCache::Build(List& list, const std::shared_ptr<engine::SceneGraphNode>& rootNode, ListType type)
+{
+    std::vector<DrawItem> items;
+    std::vector<uint32_t> itemInstances;
+    std::vector<box3> itemBounds;
+    list.instanceNodes.clear();
+    list.instanceBounds.clear();
+    list.materials.clear();
+
+    const bool opaque = type == ListType::Opaque;
+    const auto relevantContentFlags = opaque
+        ? SceneContentFlags::OpaqueMeshes | SceneContentFlags::AlphaTestedMeshes
+        : SceneContentFlags::BlendedMeshes;
+
+    SceneGraphWalker walker(rootNode.get());
+    while (walker)
+    {
+        bool subgraphContentRelevant = (walker->GetSubgraphContentFlags() & relevantContentFlags) != 0;
+        bool nodeContentsRelevant = (walker->GetLeafContentFlags() & relevantContentFlags) != 0;
+
+        auto meshInstance = nodeContentsRelevant ? dynamic_cast<MeshInstance*>(walker->GetLeaf().get()) : nullptr;
+        if (meshInstance)
+        {
+            const engine::MeshInfo* mesh = meshInstance->GetMesh().get();
+            const uint32_t instanceIndex = uint32_t(list.instanceNodes.size());
+            const size_t firstItem = items.size();
+
+            for (const auto& geometry : mesh->geometries)
+            {
+                // Track the materials of all geometries, a domain change may move a geometry into the list
+                const engine::Material* material = geometry->material.get();
+                bool knownMaterial = false;
+                for (const auto& state : list.materials)
+                    knownMaterial = knownMaterial || state.material == material;
+                if (!knownMaterial)
+                    list.materials.push_back({ material, material->domain, material->doubleSided });
+
+                bool opaqueDomain = material->domain == MaterialDomain::Opaque || material->domain == MaterialDomain::AlphaTested;
+                if (opaqueDomain != opaque)
+                    continue;
+
+                // Same per-geometry culling conditions as the walking strategies
+                bool cullGeometry = opaque
+                    ? (mesh->geometries.size() > 1 && !mesh->skinPrototype)
+                    : (mesh->geometries.size() > 1 && mesh->skinPrototype.use_count() != 0);
+
+                DrawItem item{};
+                item.instance = meshInstance;
+                item.mesh = mesh;
+                item.geometry = geometry.get();
+                item.material = material;
+                item.buffers = mesh->buffers.get();
+                item.distanceToCamera = 0; // set by the strategy
+
+                int numItems = 1;
+                if (!material->doubleSided)
+                    item.cullMode = nvrhi::RasterCullMode::Back;
+                else if (type == ListType::TransparentSeparateDoubleSided)
+                {
+                    item.cullMode = nvrhi::RasterCullMode::Front;
+                    numItems = 2;
+                }
+                else
+                    item.cullMode = nvrhi::RasterCullMode::None;
+
+                for (int i = 0; i < numItems; i++)
+                {
+                    items.push_back(item);
+                    itemInstances.push_back(instanceIndex);
+                    itemBounds.push_back(cullGeometry ? geometry->objectSpaceBounds : box3::empty());
+                    item.cullMode = nvrhi::RasterCullMode::Back;
+                }
+            }
+
+            if (items.size() > firstItem)
+            {
+                list.instanceNodes.push_back(walker.Get());
+                list.instanceBounds.push_back(walker->GetGlobalBoundingBox());
+            }
+        }
+
+        walker.Next(subgraphContentRelevant);
+    }
+
+    // Sort the opaque items once, culling keeps the order
+    std::vector<uint32_t> order;
+    if (opaque)
+    {
+        const SortKeyLayout layout = SortKeyLayout::Opaque();
+        std::vector<uint64_t> keys(items.size());
+        for (size_t i = 0; i < items.size(); i++)
+            keys[i] = layout.MakeKey(items[i]);
+
+        std::vector<uint64_t> scratchKeys;
+        std::vector<uint32_t> scratchIndices;
+        RadixSortKeys(keys, order, scratchKeys, scratchIndices);
+    }
+    else
+    {
+        order.resize(items.size());
+        for (uint32_t i = 0; i < uint32_t(order.size()); i++)
+            order[i] = i;
+    }
+
+    list.items.resize(items.size());
+    list.itemInstances.resize(items.size());
+    list.itemBounds.resize(items.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        list.items[i] = items[order[i]];
+        list.itemInstances[i] = itemInstances[order[i]];
+        list.itemBounds[i] = itemBounds[order[i]];
+    }
+}
+
+void DrawListCache::UpdateBounds(List& list)
+{
+    for (size_t i = 0; i < list.instanceNodes.size(); i++)
+        list.instanceBounds.set(i, list.instanceNodes[i]->GetGlobalBoundingBox());
+}
+
+const DrawListCache::List& DrawListCache::GetList(const std::shared_ptr<engine::SceneGraphNode>& rootNode, ListType type)
+{
+    List& list = m_Lists[std::make_pair(rootNode.get(), type)];
+
+    auto graph = rootNode ? rootNode->GetGraph() : nullptr;
+    if (!IsValid(list, rootNode, graph.get()))
+    {
+        // Drop the lists of root nodes that no longer exist, their keys may be reused by new nodes
+        for (auto it = m_Lists.begin(); it != m_Lists.end(); )
+        {
+            if (&it->second != &list && it->second.rootNode.expired())
+                it = m_Lists.erase(it);
+            else
+                ++it;
+        }
+
+        Build(list, rootNode, type);
+        list.rootNode = rootNode;
+        list.hasGraph = graph != nullptr;
+        list.structureVersion = graph ? graph->GetStructureVersion() : 0;
+        list.contentVersion = graph ? graph->GetContentVersion() : 0;
+        list.transformVersion = graph ? graph->GetTransformVersion() : 0;
+        ++m_Stats.rebuilds;
+        return list;
+    }
+
+    ++m_Stats.reuses;
+
+    if (list.transformVersion != graph->GetTransformVersion())
+    {
+        UpdateBounds(list);
+        list.transformVersion = graph->GetTransformVersion();
+        ++m_Stats.boundsUpdates;
+    }
 
-    if (a->buffers != b->buffers)
-        return a->buffers < b->buffers;
+    return list;
+}
+
+// Culls the instances of a retained list against the frustum, then calls 'onVisible' with the index of each
+// visible item, in list order.
+template<typename F>
+static void CullDrawList(const DrawListCache::List& list, const frustum& viewFrustum, std::vector<uint64_t>& instanceMask, F&& onVisible)
+{
+    instanceMask.resize((list.instanceBounds.size() + 63) / 64);
+    if (!list.instanceBounds.empty())
+        cullBoxesMask(viewFrustum, list.instanceBounds, instanceMask.data());
 
-    if (a->mesh != b->mesh)
-        return a->mesh < b->mesh;
+    for (size_t itemIndex = 0; itemIndex < list.items.size(); itemIndex++)
+    {
+        uint32_t instanceIndex = list.itemInstances[itemIndex];
+        if ((instanceMask[instanceIndex / 64] & (uint64_t(1) << (instanceIndex % 64))) == 0)
+            continue;
+
+        const box3& itemBounds = list.itemBounds[itemIndex];
+        if (!itemBounds.isempty())
+        {
+            const SceneGraphNode* node = list.instanceNodes[instanceIndex];
+            if (!viewFrustum.intersectsWith(itemBounds * node->GetLocalToWorldTransformFloat()))
+                continue;
+        }
 
-    return a->instance < b->instance;
+        onVisible(itemIndex);
+    }
 }
 
 void InstancedOpaqueDrawStrategy::FillChunk()
@@ -67,6 +268,7 @@ void InstancedOpaqueDrawStrategy::FillChunk()
 
     DrawItem* writePtr = m_InstanceChunk.data();
     size_t itemCount = 0;
+    const bool useDepth = m_SortKeyLayout.UsesDepth();
 
     while (m_Walker && itemCount < m_ChunkSize)
     {
@@ -113,7 +315,7 @@ void InstancedOpaqueDrawStrategy::FillChunk()
                         item.material = geometry->material.get();
                         item.buffers = item.mesh->buffers.get();
                         item.cullMode = (item.material->doubleSided) ? nvrhi::RasterCullMode::None : nvrhi::RasterCullMode::Back;
-                        item.distanceToCamera = 0; // don't care
+                        item.distanceToCamera = useDepth ? length(m_Walker->GetGlobalBoundingBox().center() - m_ViewOrigin) : 0.f;
                         
                         ++writePtr;
                         ++itemCount;
@@ -133,24 +335,73 @@ void InstancedOpaqueDrawStrategy::FillChunk()
         m_InstancePtrChunk[i] = &m_InstanceChunk[i];
     }
     
-    if (itemCount > 1)
-    {
-        std::sort(m_InstancePtrChunk.data(), m_InstancePtrChunk.data() + m_InstancePtrChunk.size(), CompareDrawItemsOpaque);
-    }
+    SortDrawItems(m_Sorter, m_InstancePtrChunk, m_SortKeyLayout);
 
     m_ReadPtr = 0;
 }
 
 void donut::render::InstancedOpaqueDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
 {
-    m_Walker = SceneGraphWalker(rootNode.get());
+    m_MultiView = false;
     m_ViewFrustum = view.GetViewFrustum();
+    m_ViewOrigin = view.GetViewOrigin();
     m_InstanceChunk.clear();
     m_ReadPtr = 0;
+
+    m_Retained = m_DrawListCache != nullptr;
+    if (m_Retained)
+    {
+        m_Walker = SceneGraphWalker();
+        m_InstancePtrChunk.clear();
+
+        const auto& list = m_DrawListCache->GetList(rootNode, DrawListCache::ListType::Opaque);
+        if (m_SortKeyLayout == SortKeyLayout::Opaque())
+        {
+            // The list is already in this order
+            CullDrawList(list, m_ViewFrustum, m_InstanceMask, [this, &list](size_t itemIndex)
+            {
+                m_InstancePtrChunk.push_back(&list.items[itemIndex]);
+            });
+            return;
+        }
+
+        CullDrawList(list, m_ViewFrustum, m_InstanceMask, [this, &list](size_t itemIndex)
+        {
+            DrawItem item = list.items[itemIndex];
+            item.distanceToCamera = length(list.instanceBounds.get(list.itemInstances[itemIndex]).center() - m_ViewOrigin);
+            m_InstanceChunk.push_back(item);
+        });
+
+        m_InstancePtrChunk.resize(m_InstanceChunk.size());
+        for (size_t i = 0; i < m_InstanceChunk.size(); i++)
+            m_InstancePtrChunk[i] = &m_InstanceChunk[i];
+
+        SortDrawItems(m_Sorter, m_InstancePtrChunk, m_SortKeyLayout);
+        return;
+    }
+
+    m_Walker = SceneGraphWalker(rootNode.get());
 }
 
 const DrawItem* InstancedOpaqueDrawStrategy::GetNextItem()
 {
+    if (m_MultiView)
+    {
+        const auto& itemPtrs = m_ViewItemPtrs[m_CurrentView];
+        if (m_ReadPtr >= itemPtrs.size())
+            return nullptr;
+
+        return itemPtrs[m_ReadPtr++];
+    }
+
+    if (m_Retained)
+    {
+        if (m_ReadPtr >= m_InstancePtrChunk.size())
+            return nullptr;
+
+        return m_InstancePtrChunk[m_ReadPtr++];
+    }
+
     if (m_ReadPtr >= m_InstancePtrChunk.size())
         FillChunk();
 
@@ -160,15 +411,180 @@ const DrawItem* InstancedOpaqueDrawStrategy::GetNextItem()
     return m_InstancePtrChunk[m_ReadPtr++];
 }
 
+bool InstancedOpaqueDrawStrategy::PrepareForViews(
+    const std::shared_ptr<engine::SceneGraphNode>& rootNode,
+    const engine::IView* const* views,
+    uint32_t numViews)
+{
+    if (numViews == 0 || numViews > MaxViews)
+        return false;
+
+    m_MultiView = true;
+    m_Retained = false;
+    m_CurrentView = 0;
+    m_ReadPtr = 0;
+    m_Walker = SceneGraphWalker();
+    m_InstanceChunk.clear();
+    m_InstancePtrChunk.clear();
+
+    m_ViewFrustums.resize(numViews);
+    m_ViewItems.resize(numViews);
+    m_ViewItemPtrs.resize(numViews);
+
+    for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+    {
+        m_ViewFrustums[viewIndex] = views[viewIndex]->GetViewFrustum();
+        m_ViewItems[viewIndex].clear();
+    }
+
+    const bool useDepth = m_SortKeyLayout.UsesDepth();
+    std::vector<float3> viewOrigins(numViews);
+    for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+        viewOrigins[viewIndex] = views[viewIndex]->GetViewOrigin();
+
+    if (m_DrawListCache && m_SortKeyLayout == SortKeyLayout::Opaque())
+    {
+        // The retained list is already sorted, cull it for each view
+        const auto& list = m_DrawListCache->GetList(rootNode, DrawListCache::ListType::Opaque);
+        for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+        {
+            auto& itemPtrs = m_ViewItemPtrs[viewIndex];
+            itemPtrs.clear();
+            CullDrawList(list, m_ViewFrustums[viewIndex], m_InstanceMask, [&itemPtrs, &list](size_t itemIndex)
+            {
+                itemPtrs.push_back(&list.items[itemIndex]);
+            });
+        }
+        return true;
+    }
+
+    if (m_DrawListCache)
+    {
+        const auto& list = m_DrawListCache->GetList(rootNode, DrawListCache::ListType::Opaque);
+        for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+        {
+            auto& items = m_ViewItems[viewIndex];
+            const float3 viewOrigin = viewOrigins[viewIndex];
+            CullDrawList(list, m_ViewFrustums[viewIndex], m_InstanceMask, [&items, &list, &viewOrigin](size_t itemIndex)
+            {
+                DrawItem item = list.items[itemIndex];
+                item.distanceToCamera = length(list.instanceBounds.get(list.itemInstances[itemIndex]).center() - viewOrigin);
+                items.push_back(item);
+            });
+        }
+    }
+    else
+    {
+        // Returns the subset of 'viewMask' whose frustums intersect the box.
+        auto cullBox = [this, numViews](const dm::box3& box, uint64_t viewMask)
+        {
+            uint64_t visibleMask = 0;
+            for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+            {
+                uint64_t viewBit = uint64_t(1) << viewIndex;
+                if ((viewMask & viewBit) && m_ViewFrustums[viewIndex].intersectsWith(box))
+                    visibleMask |= viewBit;
+            }
+            return visibleMask;
+        };
+
+        const uint64_t allViewsMask = (numViews == 64) ? ~uint64_t(0) : (uint64_t(1) << numViews) - 1;
+        const auto relevantContentFlags = SceneContentFlags::OpaqueMeshes | SceneContentFlags::AlphaTestedMeshes;
+
+        // The visibility masks of the ancestors of the current node, top is the mask of its parent.
+        std::vector<uint64_t> parentMasks;
+        parentMasks.push_back(allViewsMask);
+
+        SceneGraphWalker walker(rootNode.get());
+        while (walker)
+        {
+            bool subgraphContentRelevant = (walker->GetSubgraphContentFlags() & relevantContentFlags) != 0;
+            bool nodeContentsRelevant = (walker->GetLeafContentFlags() & relevantContentFlags) != 0;
+
+            uint64_t nodeMask = 0;
+            if (subgraphContentRelevant)
+            {
+                nodeMask = cullBox(walker->GetGlobalBoundingBox(), parentMasks.back());
+
+                if (nodeMask && nodeContentsRelevant)
+                {
+                    auto meshInstance = dynamic_cast<MeshInstance*>(walker->GetLeaf().get());
+                    if (meshInstance)
+                    {
+                        const engine::MeshInfo* mesh = meshInstance->GetMesh().get();
+
+                        for (const auto& geometry : mesh->geometries)
+                        {
+                            auto domain = geometry->material->domain;
+                            if (domain != MaterialDomain::Opaque && domain != MaterialDomain::AlphaTested)
+                                continue;
+
+                            uint64_t geometryMask = nodeMask;
+                            if (mesh->geometries.size() > 1 && !mesh->skinPrototype)
+                            {
+                                dm::box3 geometryGlobalBoundingBox = geometry->objectSpaceBounds * walker->GetLocalToWorldTransformFloat();
+                                geometryMask = cullBox(geometryGlobalBoundingBox, nodeMask);
+                            }
+
+                            DrawItem item;
+                            item.instance = meshInstance;
+                            item.mesh = mesh;
+                            item.geometry = geometry.get();
+                            item.material = geometry->material.get();
+                            item.buffers = item.mesh->buffers.get();
+                            item.cullMode = (item.material->doubleSided) ? nvrhi::RasterCullMode::None : nvrhi::RasterCullMode::Back;
+                            item.distanceToCamera = 0;
+
+                            for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+                            {
+                                if (geometryMask & (uint64_t(1) << viewIndex))
+                                {
+                                    if (useDepth)
+                                        item.distanceToCamera = length(walker->GetGlobalBoundingBox().center() - viewOrigins[viewIndex]);
+                                    m_ViewItems[viewIndex].push_back(item);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            int depth = walker.Next(nodeMask != 0);
+
+            if (depth > 0)
+                parentMasks.push_back(nodeMask);
+            else
+                parentMasks.resize(parentMasks.size() + depth);
+        }
+    }
+
+    for (uint32_t viewIndex = 0; viewIndex < numViews; viewIndex++)
+    {
+        const auto& items = m_ViewItems[viewIndex];
+        auto& itemPtrs = m_ViewItemPtrs[viewIndex];
+
+        itemPtrs.resize(items.size());
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            itemPtrs[i] = &items[i];
+        }
+
+        SortDrawItems(m_Sorter, itemPtrs, m_SortKeyLayout);
+    }
+
+    return true;
+}
 
-static int CompareDrawItemsTransparent(const DrawItem* a, const DrawItem* b)
+void InstancedOpaqueDrawStrategy::SelectView(uint32_t viewIndex)
 {
-    if (a->instance == b->instance)
-        return a->cullMode > b->cullMode;
+    assert(m_MultiView);
+    assert(viewIndex < m_ViewItemPtrs.size());
 
-    return a->distanceToCamera > b->distanceToCamera;
+    m_CurrentView = viewIndex;
+    m_ReadPtr = 0;
 }
 
+
 void TransparentDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const IView& view)
 {
     m_ReadPtr = 0;
@@ -179,75 +595,97 @@ void TransparentDrawStrategy::PrepareForView(const std::shared_ptr<engine::Scene
     float3 viewOrigin = view.GetViewOrigin();
     auto viewFrustum = view.GetViewFrustum();
 
-    SceneGraphWalker walker(rootNode.get());
-    while (walker)
+    if (m_DrawListCache)
     {
-        auto relevantContentFlags = SceneContentFlags::BlendedMeshes;
-        bool subgraphContentRelevant = (walker->GetSubgraphContentFlags() & relevantContentFlags) != 0;
-        bool nodeContentsRelevant = (walker->GetLeafContentFlags() & relevantContentFlags) != 0;
+        const auto& list = m_DrawListCache->GetList(rootNode, DrawDoubleSidedMaterialsSeparately
+            ? DrawListCache::ListType::TransparentSeparateDoubleSided
+            : DrawListCache::ListType::Transparent);
 
-        bool nodeVisible = false;
-        if (subgraphContentRelevant)
+        CullDrawList(list, viewFrustum, m_InstanceMask, [this, &list, &viewOrigin](size_t itemIndex)
         {
-            nodeVisible = viewFrustum.intersectsWith(walker->GetGlobalBoundingBox());
+            uint32_t instanceIndex = list.itemInstances[itemIndex];
+            const box3& itemBounds = list.itemBounds[itemIndex];
+            dm::box3 geometryGlobalBoundingBox = itemBounds.isempty()
+                ? list.instanceBounds.get(instanceIndex)
+                : itemBounds * list.instanceNodes[instanceIndex]->GetLocalToWorldTransformFloat();
 
-            if (nodeVisible && nodeContentsRelevant)
+            DrawItem item = list.items[itemIndex];
+            item.distanceToCamera = length(geometryGlobalBoundingBox.center() - viewOrigin);
+            m_InstancesToDraw.push_back(item);
+        });
+    }
+    else
+    {
+        SceneGraphWalker walker(rootNode.get());
+        while (walker)
+        {
+            auto relevantContentFlags = SceneContentFlags::BlendedMeshes;
+            bool subgraphContentRelevant = (walker->GetSubgraphContentFlags() & relevantContentFlags) != 0;
+            bool nodeContentsRelevant = (walker->GetLeafContentFlags() & relevantContentFlags) != 0;
+
+            bool nodeVisible = false;
+            if (subgraphContentRelevant)
             {
-                auto meshInstance = dynamic_cast<MeshInstance*>(walker->GetLeaf().get());
-                if (meshInstance)
+                nodeVisible = viewFrustum.intersectsWith(walker->GetGlobalBoundingBox());
+
+                if (nodeVisible && nodeContentsRelevant)
                 {
-                    const engine::MeshInfo* mesh = meshInstance->GetMesh().get();
-                    for (const auto& geometry : mesh->geometries)
+                    auto meshInstance = dynamic_cast<MeshInstance*>(walker->GetLeaf().get());
+                    if (meshInstance)
                     {
-                        const auto& material = geometry->material;
-                        if (material->domain == MaterialDomain::Opaque || material->domain == MaterialDomain::AlphaTested)
-                            continue;
-
-                        dm::box3 geometryGlobalBoundingBox;
-                        if (mesh->geometries.size() > 1 && mesh->skinPrototype.use_count() != 0)
+                        const engine::MeshInfo* mesh = meshInstance->GetMesh().get();
+                        for (const auto& geometry : mesh->geometries)
                         {
-                            geometryGlobalBoundingBox = geometry->objectSpaceBounds * walker->GetLocalToWorldTransformFloat();
-                            if (!viewFrustum.intersectsWith(geometryGlobalBoundingBox))
+                            const auto& material = geometry->material;
+                            if (material->domain == MaterialDomain::Opaque || material->domain == MaterialDomain::AlphaTested)
                                 continue;
-                        }
-                        else
-                        {
-                            geometryGlobalBoundingBox = walker->GetGlobalBoundingBox();
-                        }
 
-                        DrawItem item{};
-                        item.instance = meshInstance;
-                        item.mesh = mesh;
-                        item.geometry = geometry.get();
-                        item.material = geometry->material.get();
-                        item.buffers = mesh->buffers.get();
-                        item.distanceToCamera = length(geometryGlobalBoundingBox.center() - viewOrigin);
-                        if (material->doubleSided)
-                        {
-                            if (DrawDoubleSidedMaterialsSeparately)
+                            dm::box3 geometryGlobalBoundingBox;
+                            if (mesh->geometries.size() > 1 && mesh->skinPrototype.use_count() != 0)
                             {
-                                item.cullMode = nvrhi::RasterCullMode::Front;
-                                m_InstancesToDraw.push_back(item);
-                                item.cullMode = nvrhi::RasterCullMode::Back;
-                                m_InstancesToDraw.push_back(item);
+                                geometryGlobalBoundingBox = geometry->objectSpaceBounds * walker->GetLocalToWorldTransformFloat();
+                                if (!viewFrustum.intersectsWith(geometryGlobalBoundingBox))
+                                    continue;
+                            }
+                            else
+                            {
+                                geometryGlobalBoundingBox = walker->GetGlobalBoundingBox();
+                            }
+
+                            DrawItem item{};
+                            item.instance = meshInstance;
+                            item.mesh = mesh;
+                            item.geometry = geometry.get();
+                            item.material = geometry->material.get();
+                            item.buffers = mesh->buffers.get();
+                            item.distanceToCamera = length(geometryGlobalBoundingBox.center() - viewOrigin);
+                            if (material->doubleSided)
+                            {
+                                if (DrawDoubleSidedMaterialsSeparately)
+                                {
+                                    item.cullMode = nvrhi::RasterCullMode::Front;
+                                    m_InstancesToDraw.push_back(item);
+                                    item.cullMode = nvrhi::RasterCullMode::Back;
+                                    m_InstancesToDraw.push_back(item);
+                                }
+                                else
+                                {
+                                    item.cullMode = nvrhi::RasterCullMode::None;
+                                    m_InstancesToDraw.push_back(item);
+                                }
                             }
                             else
                             {
-                                item.cullMode = nvrhi::RasterCullMode::None;
+                                item.cullMode = nvrhi::RasterCullMode::Back;
                                 m_InstancesToDraw.push_back(item);
                             }
                         }
-                        else
-                        {
-                            item.cullMode = nvrhi::RasterCullMode::Back;
-                            m_InstancesToDraw.push_back(item);
-                        }
                     }
                 }
             }
-        }
 
-        walker.Next(nodeVisible);
+            walker.Next(nodeVisible);
+        }
     }
 
     if (m_InstancesToDraw.empty())
@@ -260,10 +698,7 @@ void TransparentDrawStrategy::PrepareForView(const std::shared_ptr<engine::Scene
         m_InstancePtrsToDraw[i] = &m_InstancesToDraw[i];
     }
 
-    if (m_InstancePtrsToDraw.size() > 1)
-    {
-        std::sort(m_InstancePtrsToDraw.data(), m_InstancePtrsToDraw.data() + m_InstancePtrsToDraw.size(), CompareDrawItemsTransparent);
-    }
+    SortDrawItems(m_Sorter, m_InstancePtrsToDraw, m_SortKeyLayout);
 }
 
 const DrawItem* TransparentDrawStrategy::GetNextItem()
@@ -277,3 +712,596 @@ const DrawItem* TransparentDrawStrategy::GetNextItem()
 
     return m_InstancePtrsToDraw[m_ReadPtr++];
 }
+
+// Appends the visible opaque and alpha-tested items of one mesh instance, with the culling rules of InstancedOpaqueDrawStrategy.
+// The instance node is assumed to be visible.
+static void AppendOpaqueItems(MeshInstance* meshInstance, const SceneGraphNode* node, const frustum& viewFrustum,
+    const float3& viewOrigin, bool useDepth, std::vector<DrawItem>& items)
+{
+    const MeshInfo* mesh = meshInstance->GetMesh().get();
+    for (const auto& geometry : mesh->geometries)
+    {
+        auto domain = geometry->material->domain;
+        if (domain != MaterialDomain::Opaque && domain != MaterialDomain::AlphaTested)
+            continue;
+
+        if (mesh->geometries.size() > 1 && !mesh->skinPrototype)
+        {
+            dm::box3 geometryGlobalBoundingBox = geometry->objectSpaceBounds * node->GetLocalToWorldTransformFloat();
+            if (!viewFrustum.intersectsWith(geometryGlobalBoundingBox))
+                continue;
+        }
+
+        DrawItem item;
+        item.instance = meshInstance;
+        item.mesh = mesh;
+        item.geometry = geometry.get();
+        item.material = geometry->material.get();
+        item.buffers = item.mesh->buffers.get();
+        item.cullMode = (item.material->doubleSided) ? nvrhi::RasterCullMode::None : nvrhi::RasterCullMode::Back;
+        item.distanceToCamera = useDepth ? length(node->GetGlobalBoundingBox().center() - viewOrigin) : 0.f;
+        items.push_back(item);
+    }
+}
+
+// Appends the visible blended items of one mesh instance, with the culling rules of TransparentDrawStrategy.
+static void AppendTransparentItems(MeshInstance* meshInstance, const SceneGraphNode* node, const frustum& viewFrustum,
+    const float3& viewOrigin, bool drawDoubleSidedMaterialsSeparately, std::vector<DrawItem>& items)
+{
+    const MeshInfo* mesh = meshInstance->GetMesh().get();
+    for (const auto& geometry : mesh->geometries)
+    {
+        const auto& material = geometry->material;
+        if (material->domain == MaterialDomain::Opaque || material->domain == MaterialDomain::AlphaTested)
+            continue;
+
+        dm::box3 geometryGlobalBoundingBox;
+        if (mesh->geometries.size() > 1 && mesh->skinPrototype.use_count() != 0)
+        {
+            geometryGlobalBoundingBox = geometry->objectSpaceBounds * node->GetLocalToWorldTransformFloat();
+            if (!viewFrustum.intersectsWith(geometryGlobalBoundingBox))
+                continue;
+        }
+        else
+        {
+            geometryGlobalBoundingBox = node->GetGlobalBoundingBox();
+        }
+
+        DrawItem item{};
+        item.instance = meshInstance;
+        item.mesh = mesh;
+        item.geometry = geometry.get();
+        item.material = geometry->material.get();
+        item.buffers = mesh->buffers.get();
+        item.distanceToCamera = length(geometryGlobalBoundingBox.center() - viewOrigin);
+        if (material->doubleSided)
+        {
+            if (drawDoubleSidedMaterialsSeparately)
+            {
+                item.cullMode = nvrhi::RasterCullMode::Front;
+                items.push_back(item);
+                item.cullMode = nvrhi::RasterCullMode::Back;
+                items.push_back(item);
+            }
+            else
+            {
+                item.cullMode = nvrhi::RasterCullMode::None;
+                items.push_back(item);
+            }
+        }
+        else
+        {
+            item.cullMode = nvrhi::RasterCullMode::Back;
+            items.push_back(item);
+        }
+    }
+}
+
+static void MakeItemPointers(const std::vector<DrawItem>& items, std::vector<const DrawItem*>& itemPtrs)
+{
+    itemPtrs.resize(items.size());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        itemPtrs[i] = &items[i];
+    }
+}
+
+// Returns the instance BVH that can replace a walk of the subgraph under rootNode, or NULL if there is none.
+static const InstanceBVH* GetInstanceBVHForRoot(const std::shared_ptr<SceneGraphNode>& rootNode)
+{
+    if (!rootNode)
+        return nullptr;
+
+    auto graph = rootNode->GetGraph();
+    if (!graph || graph->GetRootNode() != rootNode)
+        return nullptr;
+
+    const InstanceBVH* bvh = graph->GetInstanceBVH();
+    if (!bvh || bvh->GetNumLeaves() != graph->GetMeshInstances().size())
+        return nullptr;
+
+    return bvh;
+}
+
+void BVHOpaqueDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    m_ReadPtr = 0;
+    m_InstancesToDraw.clear();
+    m_InstancePtrsToDraw.clear();
+    m_QueryStats = InstanceBVH::QueryStats();
+
+    const InstanceBVH* bvh = GetInstanceBVHForRoot(rootNode);
+    m_UseFallback = !bvh;
+    if (m_UseFallback)
+    {
+        m_Fallback.SetSortKeyLayout(m_SortKeyLayout);
+        m_Fallback.PrepareForView(rootNode, view);
+        return;
+    }
+
+    const bool useDepth = m_SortKeyLayout.UsesDepth();
+    const float3 viewOrigin = view.GetViewOrigin();
+    const auto viewFrustum = view.GetViewFrustum();
+    m_VisibleInstances.clear();
+    bvh->Query(viewFrustum, m_VisibleInstances, &m_QueryStats);
+
+    const auto& meshInstances = rootNode->GetGraph()->GetMeshInstances();
+    const auto relevantContentFlags = SceneContentFlags::OpaqueMeshes | SceneContentFlags::AlphaTestedMeshes;
+
+    for (uint32_t instanceIndex : m_VisibleInstances)
+    {
+        MeshInstance* meshInstance = meshInstances[instanceIndex].get();
+        const SceneGraphNode* node = meshInstance->GetNode();
+        if (!node || (node->GetLeafContentFlags() & relevantContentFlags) == 0)
+            continue;
+
+        AppendOpaqueItems(meshInstance, node, viewFrustum, viewOrigin, useDepth, m_InstancesToDraw);
+    }
+
+    MakeItemPointers(m_InstancesToDraw, m_InstancePtrsToDraw);
+    SortDrawItems(m_Sorter, m_InstancePtrsToDraw, m_SortKeyLayout);
+}
+
+const DrawItem* BVHOpaqueDrawStrategy::GetNextItem()
+{
+    if (m_UseFallback)
+        return m_Fallback.GetNextItem();
+
+    if (m_ReadPtr >= m_InstancePtrsToDraw.size())
+        return nullptr;
+
+    return m_InstancePtrsToDraw[m_ReadPtr++];
+}
+
+void BVHTransparentDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    m_ReadPtr = 0;
+    m_InstancesToDraw.clear();
+    m_InstancePtrsToDraw.clear();
+    m_QueryStats = InstanceBVH::QueryStats();
+
+    const InstanceBVH* bvh = GetInstanceBVHForRoot(rootNode);
+    m_UseFallback = !bvh;
+    if (m_UseFallback)
+    {
+        m_Fallback.DrawDoubleSidedMaterialsSeparately = DrawDoubleSidedMaterialsSeparately;
+        m_Fallback.SetSortKeyLayout(m_SortKeyLayout);
+        m_Fallback.PrepareForView(rootNode, view);
+        return;
+    }
+
+    float3 viewOrigin = view.GetViewOrigin();
+    const auto viewFrustum = view.GetViewFrustum();
+    m_VisibleInstances.clear();
+    bvh->Query(viewFrustum, m_VisibleInstances, &m_QueryStats);
+
+    const auto& meshInstances = rootNode->GetGraph()->GetMeshInstances();
+
+    for (uint32_t instanceIndex : m_VisibleInstances)
+    {
+        MeshInstance* meshInstance = meshInstances[instanceIndex].get();
+        const SceneGraphNode* node = meshInstance->GetNode();
+        if (!node || (node->GetLeafContentFlags() & SceneContentFlags::BlendedMeshes) == 0)
+            continue;
+
+        AppendTransparentItems(meshInstance, node, viewFrustum, viewOrigin, DrawDoubleSidedMaterialsSeparately, m_InstancesToDraw);
+    }
+
+    MakeItemPointers(m_InstancesToDraw, m_InstancePtrsToDraw);
+    SortDrawItems(m_Sorter, m_InstancePtrsToDraw, m_SortKeyLayout);
+}
+
+const DrawItem* BVHTransparentDrawStrategy::GetNextItem()
+{
+    if (m_UseFallback)
+        return m_Fallback.GetNextItem();
+
+    if (m_ReadPtr >= m_InstancePtrsToDraw.size())
+        return nullptr;
+
+    return m_InstancePtrsToDraw[m_ReadPtr++];
+}
+
+// Returns the mesh instances of the graph if they can replace a walk of the subgraph under rootNode, or NULL.
+static const std::vector<std::shared_ptr<MeshInstance>>* GetMeshInstancesForRoot(const std::shared_ptr<SceneGraphNode>& rootNode)
+{
+    if (!rootNode)
+        return nullptr;
+
+    auto graph = rootNode->GetGraph();
+    if (!graph || graph->GetRootNode() != rootNode)
+        return nullptr;
+
+    return &graph->GetMeshInstances();
+}
+
+// Calls 'generate(instanceIndex, items)' for all mesh instances, split into jobs of 'instancesPerJob' instances
+// that run on the thread pool if there is one, and collects pointers to the generated items in instance order.
+template<typename F>
+static void GenerateItemsInParallel(ThreadPool* threadPool, size_t numInstances, uint32_t instancesPerJob,
+    std::vector<std::vector<DrawItem>>& jobItems, std::vector<const DrawItem*>& itemPtrs, const F& generate)
+{
+    const size_t jobSize = std::max<size_t>(instancesPerJob, 1);
+    const size_t numJobs = (numInstances + jobSize - 1) / jobSize;
+    jobItems.resize(numJobs);
+
+    auto runJob = [&jobItems, &generate, jobSize, numInstances](size_t job)
+    {
+        auto& items = jobItems[job];
+        items.clear();
+        const size_t end = std::min(numInstances, (job + 1) * jobSize);
+        for (size_t instanceIndex = job * jobSize; instanceIndex < end; instanceIndex++)
+            generate(instanceIndex, items);
+    };
+
+    if (threadPool && numJobs > 1)
+    {
+        ThreadPoolTaskGroup group;
+        for (size_t job = 0; job < numJobs; job++)
+            threadPool->AddTask(group, [&runJob, job]() { runJob(job); });
+        threadPool->Wait(group);
+    }
+    else
+    {
+        for (size_t job = 0; job < numJobs; job++)
+            runJob(job);
+    }
+
+    size_t numItems = 0;
+    for (const auto& items : jobItems)
+        numItems += items.size();
+
+    itemPtrs.clear();
+    itemPtrs.reserve(numItems);
+    for (const auto& items : jobItems)
+    {
+        for (const DrawItem& item : items)
+            itemPtrs.push_back(&item);
+    }
+}
+
+ParallelOpaqueDrawStrategy::ParallelOpaqueDrawStrategy(engine::ThreadPool* threadPool)
+    : m_ThreadPool(threadPool)
+{
+}
+
+void ParallelOpaqueDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    m_ReadPtr = 0;
+    m_InstancePtrsToDraw.clear();
+
+    const auto* meshInstances = GetMeshInstancesForRoot(rootNode);
+    m_UseFallback = !meshInstances;
+    if (m_UseFallback)
+    {
+        m_Fallback.SetSortKeyLayout(m_SortKeyLayout);
+        m_Fallback.PrepareForView(rootNode, view);
+        return;
+    }
+
+    const bool useDepth = m_SortKeyLayout.UsesDepth();
+    const float3 viewOrigin = view.GetViewOrigin();
+    const auto viewFrustum = view.GetViewFrustum();
+    const auto relevantContentFlags = SceneContentFlags::OpaqueMeshes | SceneContentFlags::AlphaTestedMeshes;
+
+    GenerateItemsInParallel(m_ThreadPool, meshInstances->size(), InstancesPerJob, m_JobItems, m_InstancePtrsToDraw,
+        [meshInstances, &viewFrustum, &viewOrigin, useDepth, relevantContentFlags](size_t instanceIndex, std::vector<DrawItem>& items)
+        {
+            MeshInstance* meshInstance = (*meshInstances)[instanceIndex].get();
+            const SceneGraphNode* node = meshInstance->GetNode();
+            if (!node || (node->GetLeafContentFlags() & relevantContentFlags) == 0)
+                return;
+
+            if (!viewFrustum.intersectsWith(node->GetGlobalBoundingBox()))
+                return;
+
+            AppendOpaqueItems(meshInstance, node, viewFrustum, viewOrigin, useDepth, items);
+        });
+
+    SortDrawItems(m_Sorter, m_InstancePtrsToDraw, m_SortKeyLayout);
+}
+
+const DrawItem* ParallelOpaqueDrawStrategy::GetNextItem()
+{
+    if (m_UseFallback)
+        return m_Fallback.GetNextItem();
+
+    if (m_ReadPtr >= m_InstancePtrsToDraw.size())
+        return nullptr;
+
+    return m_InstancePtrsToDraw[m_ReadPtr++];
+}
+
+ParallelTransparentDrawStrategy::ParallelTransparentDrawStrategy(engine::ThreadPool* threadPool)
+    : m_ThreadPool(threadPool)
+{
+}
+
+void ParallelTransparentDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    m_ReadPtr = 0;
+    m_InstancePtrsToDraw.clear();
+
+    const auto* meshInstances = GetMeshInstancesForRoot(rootNode);
+    m_UseFallback = !meshInstances;
+    if (m_UseFallback)
+    {
+        m_Fallback.DrawDoubleSidedMaterialsSeparately = DrawDoubleSidedMaterialsSeparately;
+        m_Fallback.SetSortKeyLayout(m_SortKeyLayout);
+        m_Fallback.PrepareForView(rootNode, view);
+        return;
+    }
+
+    const bool drawDoubleSidedMaterialsSeparately = DrawDoubleSidedMaterialsSeparately;
+    const float3 viewOrigin = view.GetViewOrigin();
+    const auto viewFrustum = view.GetViewFrustum();
+
+    GenerateItemsInParallel(m_ThreadPool, meshInstances->size(), InstancesPerJob, m_JobItems, m_InstancePtrsToDraw,
+        [meshInstances, &viewFrustum, &viewOrigin, drawDoubleSidedMaterialsSeparately](size_t instanceIndex, std::vector<DrawItem>& items)
+        {
+            MeshInstance* meshInstance = (*meshInstances)[instanceIndex].get();
+            const SceneGraphNode* node = meshInstance->GetNode();
+            if (!node || (node->GetLeafContentFlags() & SceneContentFlags::BlendedMeshes) == 0)
+                return;
+
+            if (!viewFrustum.intersectsWith(node->GetGlobalBoundingBox()))
+                return;
+
+            AppendTransparentItems(meshInstance, node, viewFrustum, viewOrigin, drawDoubleSidedMaterialsSeparately, items);
+        });
+
+    SortDrawItems(m_Sorter, m_InstancePtrsToDraw, m_SortKeyLayout);
+}
+
+const DrawItem* ParallelTransparentDrawStrategy::GetNextItem()
+{
+    if (m_UseFallback)
+        return m_Fallback.GetNextItem();
+
+    if (m_ReadPtr >= m_InstancePtrsToDraw.size())
+        return nullptr;
+
+    return m_InstancePtrsToDraw[m_ReadPtr++];
+}
+
+OcclusionCullingDrawStrategy::OcclusionCullingDrawStrategy(std::shared_ptr<IDrawStrategy> inner, engine::ThreadPool* threadPool)
+    : m_Inner(std::move(inner))
+    , m_OcclusionBuffer(std::make_shared<OcclusionBuffer>())
+    , m_ThreadPool(threadPool)
+{
+}
+
+void OcclusionCullingDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    m_ReadPtr = 0;
+    m_Items.clear();
+    m_ItemBounds.clear();
+    m_VisibleItems.clear();
+    m_NumOccluders = 0;
+    m_NumCulledItems = 0;
+
+    // The wrapped strategy may reuse its item storage, so copy the items
+    m_Inner->PrepareForView(rootNode, view);
+    while (const DrawItem* item = m_Inner->GetNextItem())
+        m_Items.push_back(*item);
+
+    if (!Enabled || m_Items.empty())
+    {
+        for (const DrawItem& item : m_Items)
+            m_VisibleItems.push_back(&item);
+        return;
+    }
+
+    m_OcclusionBuffer->BeginFrame(view.GetViewProjectionMatrix(), view.IsReverseDepth());
+
+    struct OccluderCandidate
+    {
+        size_t itemIndex;
+        float coverage;
+    };
+    std::vector<OccluderCandidate> candidates;
+
+    m_ItemBounds.resize(m_Items.size());
+    for (size_t itemIndex = 0; itemIndex < m_Items.size(); itemIndex++)
+    {
+        const DrawItem& item = m_Items[itemIndex];
+        const SceneGraphNode* node = item.instance ? item.instance->GetNode() : nullptr;
+        if (!node)
+        {
+            m_ItemBounds[itemIndex] = box3::empty();
+            continue;
+        }
+
+        m_ItemBounds[itemIndex] = item.mesh->skinPrototype
+            ? node->GetGlobalBoundingBox()
+            : item.geometry->objectSpaceBounds * node->GetLocalToWorldTransformFloat();
+
+        const BufferGroup* buffers = item.buffers;
+        bool canOcclude = item.material->domain == MaterialDomain::Opaque
+            && item.geometry->type == MeshGeometryPrimitiveType::Triangles
+            && !item.mesh->skinPrototype
+            && buffers && !buffers->positionData.empty() && !buffers->indexData.empty();
+        if (!canOcclude)
+            continue;
+
+        float coverage = m_OcclusionBuffer->GetScreenCoverage(m_ItemBounds[itemIndex]);
+        if (item.mesh->isOccluder || coverage >= OccluderMinScreenCoverage)
+            candidates.push_back({ itemIndex, item.mesh->isOccluder ? coverage + 1.f : coverage });
+    }
+
+    // Flagged occluders first, then the largest ones
+    std::sort(candidates.begin(), candidates.end(), [](const OccluderCandidate& a, const OccluderCandidate& b)
+    {
+        if (a.coverage != b.coverage)
+            return a.coverage > b.coverage;
+        return a.itemIndex < b.itemIndex;
+    });
+    if (candidates.size() > MaxOccluders)
+        candidates.resize(MaxOccluders);
+
+    for (const OccluderCandidate& candidate : candidates)
+    {
+        const DrawItem& item = m_Items[candidate.itemIndex];
+        const BufferGroup* buffers = item.buffers;
+        const uint32_t vertexOffset = item.mesh->vertexOffset + item.geometry->vertexOffsetInMesh;
+        const uint32_t indexOffset = item.mesh->indexOffset + item.geometry->indexOffsetInMesh;
+        if (indexOffset + item.geometry->numIndices > buffers->indexData.size())
+            continue;
+
+        m_OcclusionBuffer->AddOccluder(
+            buffers->positionData.data() + vertexOffset,
+            buffers->indexData.data() + indexOffset,
+            item.geometry->numIndices,
+            item.instance->GetNode()->GetLocalToWorldTransformFloat());
+        ++m_NumOccluders;
+    }
+
+    m_OcclusionBuffer->Rasterize(m_ThreadPool);
+
+    for (size_t itemIndex = 0; itemIndex < m_Items.size(); itemIndex++)
+    {
+        const box3& bounds = m_ItemBounds[itemIndex];
+        if (bounds.isempty() || m_OcclusionBuffer->IsVisible(bounds))
+            m_VisibleItems.push_back(&m_Items[itemIndex]);
+        else
+            ++m_NumCulledItems;
+    }
+}
+
+const DrawItem* OcclusionCullingDrawStrategy::GetNextItem()
+{
+    if (m_ReadPtr >= m_VisibleItems.size())
+        return nullptr;
+
+    return m_VisibleItems[m_ReadPtr++];
+}
+
+LodSelectionDrawStrategy::LodSelectionDrawStrategy(std::shared_ptr<IDrawStrategy> inner)
+    : m_Inner(std::move(inner))
+{
+}
+
+void LodSelectionDrawStrategy::PrepareForView(const std::shared_ptr<engine::SceneGraphNode>& rootNode, const engine::IView& view)
+{
+    constexpr uint32_t c_MaxStatsLod = uint32_t(std::size(Stats().instancesPerLod)) - 1;
+    constexpr uint32_t c_InstancePruneInterval = 64;
+
+    m_ReadPtr = 0;
+    m_Items.clear();
+    m_Stats = Stats();
+    ++m_Frame;
+
+    // Forget the instances that have not been seen for a while, they may not exist anymore
+    if (m_Frame % c_InstancePruneInterval == 0)
+    {
+        for (auto it = m_Instances.begin(); it != m_Instances.end(); )
+        {
+            if (m_Frame - it->second.lastFrame > c_InstancePruneInterval)
+                it = m_Instances.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    const nvrhi::Rect viewExtent = view.GetViewExtent();
+    const float4x4 projectionMatrix = view.GetProjectionMatrix(false);
+    const float3 viewOrigin = view.GetViewOrigin();
+    const bool orthographic = view.IsOrthographicProjection();
+    const float pixelsPerUnitAtUnitDistance = 0.5f * float(viewExtent.height()) * projectionMatrix[1][1];
+
+    m_Inner->PrepareForView(rootNode, view);
+    while (const DrawItem* innerItem = m_Inner->GetNextItem())
+    {
+        DrawItem item = *innerItem;
+        ++m_Stats.items;
+
+        // Skinned meshes share the levels of detail of their prototypes
+        const MeshInfo* lodMesh = item.mesh->skinPrototype ? item.mesh->skinPrototype.get() : item.mesh;
+        const SceneGraphNode* node = item.instance ? item.instance->GetNode() : nullptr;
+        const uint64_t baseTriangles = item.geometry->numIndices / 3;
+        m_Stats.baseTriangles += baseTriangles;
+
+        if (!Enabled || !node || lodMesh->lods.empty())
+        {
+            m_Stats.drawnTriangles += baseTriangles;
+            m_Items.push_back(item);
+            continue;
+        }
+
+        ++m_Stats.itemsWithLods;
+
+        InstanceState& state = m_Instances[item.instance];
+        if (state.lastFrame != m_Frame)
+        {
+            // Errors are in object space, scale them by the largest axis scale of the instance
+            const affine3& transform = node->GetLocalToWorldTransformFloat();
+            const float scale = std::max(std::max(
+                length(transform.m_linear.row0),
+                length(transform.m_linear.row1)),
+                length(transform.m_linear.row2));
+
+            float pixelsPerUnit = pixelsPerUnitAtUnitDistance * scale;
+            if (!orthographic)
+            {
+                const box3& bounds = node->GetGlobalBoundingBox();
+                const float distance = length(bounds.clamp(viewOrigin) - viewOrigin);
+                pixelsPerUnit = distance > 0.f ? pixelsPerUnit / distance : std::numeric_limits<float>::max();
+            }
+
+            state.lod = SelectMeshLod(*lodMesh, pixelsPerUnit, MaxScreenSpaceError, Hysteresis, state.lod);
+            state.lastFrame = m_Frame;
+
+            ++m_Stats.instancesPerLod[std::min(state.lod, c_MaxStatsLod)];
+        }
+
+        if (state.lod > 0)
+        {
+            // Skinned instance geometries are copies of the prototype geometries, so match them by index
+            const auto& geometries = item.mesh->geometries;
+            const size_t geometryIndex = size_t(std::find_if(geometries.begin(), geometries.end(),
+                [geometry = item.geometry](const std::shared_ptr<MeshGeometry>& g) { return g.get() == geometry; })
+                - geometries.begin());
+
+            const MeshLod& lod = lodMesh->lods[state.lod - 1];
+            if (geometryIndex < lod.geometries.size())
+            {
+                const MeshGeometry* lodGeometry = lod.geometries[geometryIndex].get();
+                if (lodGeometry->numIndices == 0)
+                    continue;
+
+                item.geometry = lodGeometry;
+            }
+        }
+
+        m_Stats.drawnTriangles += item.geometry->numIndices / 3;
+        m_Items.push_back(item);
+    }
+}
+
+const DrawItem* LodSelectionDrawStrategy::GetNextItem()
+{
+    if (m_ReadPtr >= m_Items.size())
+        return nullptr;
+
+    return &m_Items[m_ReadPtr++];
+}
@@ -22,6 +22,7 @@
 
 #include <donut/render/ForwardShadingPass.h>
 #include <donut/render/DrawStrategy.h>
+#include <donut/render/LightClusterBuffers.h>
 #include <donut/engine/FramebufferFactory.h>
 #include <donut/engine/ShaderFactory.h>
 #include <donut/engine/ShadowMap.h>
@@ -72,13 +73,22 @@ ForwardShadingPass::ForwardShadingPass(
 void ForwardShadingPass::Init(ShaderFactory& shaderFactory, const CreateParameters& params)
 {
     m_UseInputAssembler = params.useInputAssembler;
+    m_VertexLayout = params.vertexLayout;
 
     m_SupportedViewTypes = ViewType::PLANAR;
     if (params.singlePassCubemap)
         m_SupportedViewTypes = ViewType::CUBEMAP;
     
-    m_VertexShader = CreateVertexShader(shaderFactory, params);
-    m_InputLayout = CreateInputLayout(m_VertexShader, params);
+    // The full layout is always supported, the compact one only when requested
+    CreateParameters fullLayoutParams = params;
+    fullLayoutParams.vertexLayout = VertexLayout::Full;
+    m_VertexShader = CreateVertexShader(shaderFactory, fullLayoutParams);
+    m_InputLayout = CreateInputLayout(m_VertexShader, fullLayoutParams);
+    if (params.vertexLayout == VertexLayout::Compact)
+    {
+        m_CompactVertexShader = CreateVertexShader(shaderFactory, params);
+        m_CompactInputLayout = CreateInputLayout(m_CompactVertexShader, params);
+    }
     m_GeometryShader = CreateGeometryShader(shaderFactory, params);
     m_PixelShader = CreatePixelShader(shaderFactory, params, false);
     m_PixelShaderTransmissive = CreatePixelShader(shaderFactory, params, true);
@@ -96,6 +106,9 @@ void ForwardShadingPass::Init(ShaderFactory& shaderFactory, const CreateParamete
     m_ForwardViewCB = m_Device->createBuffer(nvrhi::utils::CreateVolatileConstantBufferDesc(sizeof(ForwardShadingViewConstants), "ForwardShadingViewConstants", params.numConstantBufferVersions));
     m_ForwardLightCB = m_Device->createBuffer(nvrhi::utils::CreateVolatileConstantBufferDesc(sizeof(ForwardShadingLightConstants), "ForwardShadingLightConstants", params.numConstantBufferVersions));
 
+    m_LightClusters = std::make_shared<LightClusterBuffers>(m_Device);
+    m_LightClusterBufferVersion = m_LightClusters->GetBufferVersion();
+
     m_ViewBindingLayout = CreateViewBindingLayout();
     m_ViewBindingSet = CreateViewBindingSet();
     m_ShadingBindingLayout = CreateShadingBindingLayout();
@@ -113,15 +126,18 @@ nvrhi::ShaderHandle ForwardShadingPass::CreateVertexShader(ShaderFactory& shader
 {
     char const* sourceFileName = "donut/passes/forward_vs.hlsl";
 
+    std::vector<ShaderMacro> VertexShaderMacros;
+    VertexShaderMacros.push_back(ShaderMacro("COMPACT_VERTICES", params.vertexLayout == VertexLayout::Compact ? "1" : "0"));
+
     if (params.useInputAssembler)
     {
         return shaderFactory.CreateAutoShader(sourceFileName, "input_assembler",
-            DONUT_MAKE_PLATFORM_SHADER(g_forward_vs_input_assembler), nullptr, nvrhi::ShaderType::Vertex);
+            DONUT_MAKE_PLATFORM_SHADER(g_forward_vs_input_assembler), &VertexShaderMacros, nvrhi::ShaderType::Vertex);
     }
     else
     {
         return shaderFactory.CreateAutoShader(sourceFileName, "buffer_loads",
-            DONUT_MAKE_PLATFORM_SHADER(g_forward_vs_buffer_loads), nullptr, nvrhi::ShaderType::Vertex);
+            DONUT_MAKE_PLATFORM_SHADER(g_forward_vs_buffer_loads), &VertexShaderMacros, nvrhi::ShaderType::Vertex);
     }
 }
 
@@ -157,9 +173,9 @@ nvrhi::InputLayoutHandle ForwardShadingPass::CreateInputLayout(nvrhi::IShader* v
     {
         const nvrhi::VertexAttributeDesc inputDescs[] =
         {
-            GetVertexAttributeDesc(VertexAttribute::Position, "POS", 0),
-            GetVertexAttributeDesc(VertexAttribute::PrevPosition, "PREV_POS", 1),
-            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 2),
+            GetVertexAttributeDesc(VertexAttribute::Position, "POS", 0, params.vertexLayout),
+            GetVertexAttributeDesc(VertexAttribute::PrevPosition, "PREV_POS", 1, params.vertexLayout),
+            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 2, params.vertexLayout),
             GetVertexAttributeDesc(VertexAttribute::Normal, "NORMAL", 3),
             GetVertexAttributeDesc(VertexAttribute::Tangent, "TANGENT", 4),
             GetVertexAttributeDesc(VertexAttribute::Transform, "TRANSFORM", 5),
@@ -176,7 +192,10 @@ nvrhi::BindingLayoutHandle ForwardShadingPass::CreateViewBindingLayout()
     auto bindingLayoutDesc = nvrhi::BindingLayoutDesc()
         .setVisibility(nvrhi::ShaderType::Vertex | nvrhi::ShaderType::Pixel)
         .setRegisterSpaceAndDescriptorSet(FORWARD_SPACE_VIEW)
-        .addItem(nvrhi::BindingLayoutItem::VolatileConstantBuffer(FORWARD_BINDING_VIEW_CONSTANTS));
+        .addItem(nvrhi::BindingLayoutItem::VolatileConstantBuffer(FORWARD_BINDING_VIEW_CONSTANTS))
+        .addItem(nvrhi::BindingLayoutItem::StructuredBuffer_SRV(FORWARD_BINDING_LIGHT_CLUSTERS))
+        .addItem(nvrhi::BindingLayoutItem::StructuredBuffer_SRV(FORWARD_BINDING_LIGHT_INDICES))
+        .addItem(nvrhi::BindingLayoutItem::StructuredBuffer_SRV(FORWARD_BINDING_CLUSTERED_LIGHTS));
 
     return m_Device->createBindingLayout(bindingLayoutDesc);
 }
@@ -186,7 +205,10 @@ nvrhi::BindingSetHandle ForwardShadingPass::CreateViewBindingSet()
 {
     auto bindingSetDesc = nvrhi::BindingSetDesc()
         .setTrackLiveness(m_TrackLiveness)
-        .addItem(nvrhi::BindingSetItem::ConstantBuffer(FORWARD_BINDING_VIEW_CONSTANTS, m_ForwardViewCB));
+        .addItem(nvrhi::BindingSetItem::ConstantBuffer(FORWARD_BINDING_VIEW_CONSTANTS, m_ForwardViewCB))
+        .addItem(nvrhi::BindingSetItem::StructuredBuffer_SRV(FORWARD_BINDING_LIGHT_CLUSTERS, m_LightClusters->GetClusterBuffer()))
+        .addItem(nvrhi::BindingSetItem::StructuredBuffer_SRV(FORWARD_BINDING_LIGHT_INDICES, m_LightClusters->GetIndexBuffer()))
+        .addItem(nvrhi::BindingSetItem::StructuredBuffer_SRV(FORWARD_BINDING_CLUSTERED_LIGHTS, m_LightClusters->GetLightBuffer()));
 
     return m_Device->createBindingSet(bindingSetDesc, m_ViewBindingLayout);
 }
@@ -240,8 +262,8 @@ nvrhi::GraphicsPipelineHandle ForwardShadingPass::CreateGraphicsPipeline(Forward
     nvrhi::FramebufferInfo const& framebufferInfo)
 {
     nvrhi::GraphicsPipelineDesc pipelineDesc;
-    pipelineDesc.inputLayout = m_InputLayout;
-    pipelineDesc.VS = m_VertexShader;
+    pipelineDesc.inputLayout = key.compactVertices ? m_CompactInputLayout : m_InputLayout;
+    pipelineDesc.VS = key.compactVertices ? m_CompactVertexShader : m_VertexShader;
     pipelineDesc.GS = m_GeometryShader;
     pipelineDesc.renderState.rasterState.frontCounterClockwise = key.frontCounterClockwise;
     pipelineDesc.renderState.rasterState.setCullMode(key.cullMode);
@@ -337,8 +359,21 @@ void ForwardShadingPass::SetupView(
     
     ForwardShadingViewConstants viewConstants = {};
     view->FillPlanarViewConstants(viewConstants.view);
+
+    // Single-pass cube maps render all faces with one set of constants, so their lights are not binned
+    if (m_SupportedViewTypes == ViewType::PLANAR)
+        m_LightClusters->BinLights(commandList, *view, viewConstants.lightClusters);
+    else
+        m_LightClusters->FillUnbinnedConstants(viewConstants.lightClusters);
+
     commandList->writeBuffer(m_ForwardViewCB, &viewConstants, sizeof(viewConstants));
 
+    if (m_LightClusters->GetBufferVersion() != m_LightClusterBufferVersion)
+    {
+        m_ViewBindingSet = CreateViewBindingSet();
+        m_LightClusterBufferVersion = m_LightClusters->GetBufferVersion();
+    }
+
     context.keyTemplate.frontCounterClockwise = view->IsMirrored();
     context.keyTemplate.reverseDepth = view->IsReverseDepth();
     context.keyTemplate.shadingRateState = view->GetVariableRateShadingState();
@@ -410,9 +445,13 @@ void ForwardShadingPass::PrepareLights(
 
     int numShadows = 0;
 
-    for (int nLight = 0; nLight < std::min(static_cast<int>(lights.size()), FORWARD_MAX_LIGHTS); nLight++)
+    for (const auto& light : lights)
     {
-        const auto& light = lights[nLight];
+        if (LightClusterBuffers::IsClusteredLight(*light))
+            continue;
+
+        if (constants.numLights >= FORWARD_MAX_LIGHTS)
+            break;
 
         LightConstants& lightConstants = constants.lights[constants.numLights];
         light->FillLightConstants(lightConstants);
@@ -461,6 +500,8 @@ void ForwardShadingPass::PrepareLights(
     }
 
     commandList->writeBuffer(m_ForwardLightCB, &constants, sizeof(constants));
+
+    m_LightClusters->SetLights(commandList, lights);
 }
 
 ViewType::Enum ForwardShadingPass::GetSupportedViewTypes() const
@@ -516,6 +557,8 @@ void ForwardShadingPass::SetupInputBuffers(GeometryPassContext& abstractContext,
 {
     auto& context = static_cast<Context&>(abstractContext);
     
+    assert(buffers->vertexLayout == VertexLayout::Full || m_VertexLayout == VertexLayout::Compact);
+    context.keyTemplate.compactVertices = buffers->vertexLayout == VertexLayout::Compact;
     state.indexBuffer = { buffers->indexBuffer, nvrhi::Format::R32_UINT, 0 };
     
     if (m_UseInputAssembler)
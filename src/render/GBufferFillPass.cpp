@@ -73,13 +73,22 @@ void GBufferFillPass::Init(ShaderFactory& shaderFactory, const CreateParameters&
 {
     m_EnableMotionVectors = params.enableMotionVectors;
     m_UseInputAssembler = params.useInputAssembler;
+    m_VertexLayout = params.vertexLayout;
 
     m_SupportedViewTypes = ViewType::PLANAR;
     if (params.enableSinglePassCubemap)
         m_SupportedViewTypes = ViewType::Enum(m_SupportedViewTypes | ViewType::CUBEMAP);
     
-    m_VertexShader = CreateVertexShader(shaderFactory, params);
-    m_InputLayout = CreateInputLayout(m_VertexShader, params);
+    // The full layout is always supported, the compact one only when requested
+    CreateParameters fullLayoutParams = params;
+    fullLayoutParams.vertexLayout = VertexLayout::Full;
+    m_VertexShader = CreateVertexShader(shaderFactory, fullLayoutParams);
+    m_InputLayout = CreateInputLayout(m_VertexShader, fullLayoutParams);
+    if (params.vertexLayout == VertexLayout::Compact)
+    {
+        m_CompactVertexShader = CreateVertexShader(shaderFactory, params);
+        m_CompactInputLayout = CreateInputLayout(m_CompactVertexShader, params);
+    }
     m_GeometryShader = CreateGeometryShader(shaderFactory, params);
     m_PixelShader = CreatePixelShader(shaderFactory, params, false);
     m_PixelShaderAlphaTested = CreatePixelShader(shaderFactory, params, true);
@@ -112,6 +121,7 @@ nvrhi::ShaderHandle GBufferFillPass::CreateVertexShader(ShaderFactory& shaderFac
 
     std::vector<ShaderMacro> VertexShaderMacros;
     VertexShaderMacros.push_back(ShaderMacro("MOTION_VECTORS", params.enableMotionVectors ? "1" : "0"));
+    VertexShaderMacros.push_back(ShaderMacro("COMPACT_VERTICES", params.vertexLayout == VertexLayout::Compact ? "1" : "0"));
 
     if (params.useInputAssembler)
     {
@@ -168,9 +178,9 @@ nvrhi::InputLayoutHandle GBufferFillPass::CreateInputLayout(nvrhi::IShader* vert
     {
         std::vector<nvrhi::VertexAttributeDesc> inputDescs =
         {
-            GetVertexAttributeDesc(VertexAttribute::Position, "POS", 0),
-            GetVertexAttributeDesc(VertexAttribute::PrevPosition, "PREV_POS", 1),
-            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 2),
+            GetVertexAttributeDesc(VertexAttribute::Position, "POS", 0, params.vertexLayout),
+            GetVertexAttributeDesc(VertexAttribute::PrevPosition, "PREV_POS", 1, params.vertexLayout),
+            GetVertexAttributeDesc(VertexAttribute::TexCoord1, "TEXCOORD", 2, params.vertexLayout),
             GetVertexAttributeDesc(VertexAttribute::Normal, "NORMAL", 3),
             GetVertexAttributeDesc(VertexAttribute::Tangent, "TANGENT", 4),
             GetVertexAttributeDesc(VertexAttribute::Transform, "TRANSFORM", 5),
@@ -208,8 +218,8 @@ void GBufferFillPass::CreateViewBindings(nvrhi::BindingLayoutHandle& layout, nvr
 nvrhi::GraphicsPipelineHandle GBufferFillPass::CreateGraphicsPipeline(PipelineKey key, nvrhi::FramebufferInfo const& framebufferInfo)
 {
     nvrhi::GraphicsPipelineDesc pipelineDesc;
-    pipelineDesc.inputLayout = m_InputLayout;
-    pipelineDesc.VS = m_VertexShader;
+    pipelineDesc.inputLayout = key.bits.compactVertices ? m_CompactInputLayout : m_InputLayout;
+    pipelineDesc.VS = key.bits.compactVertices ? m_CompactVertexShader : m_VertexShader;
     pipelineDesc.GS = m_GeometryShader;
     pipelineDesc.renderState.rasterState
         .setFrontCounterClockwise(key.bits.frontCounterClockwise)
@@ -357,6 +367,8 @@ void GBufferFillPass::SetupInputBuffers(GeometryPassContext& abstractContext, co
 {
     auto& context = static_cast<Context&>(abstractContext);
 
+    assert(buffers->vertexLayout == VertexLayout::Full || m_VertexLayout == VertexLayout::Compact);
+    context.keyTemplate.bits.compactVertices = buffers->vertexLayout == VertexLayout::Compact;
     state.indexBuffer = { buffers->indexBuffer, nvrhi::Format::R32_UINT, 0 };
 
     if (m_UseInputAssembler)
@@ -92,7 +92,9 @@ void donut::render::RenderView(
 
 
         bool newBuffers = item->buffers != lastBuffers;
-        bool newMaterial = item->material != lastMaterial || item->cullMode != lastCullMode;
+        // the pipeline depends on the vertex layout, which can differ between buffer groups
+        bool newLayout = newBuffers && lastBuffers && item->buffers->vertexLayout != lastBuffers->vertexLayout;
+        bool newMaterial = item->material != lastMaterial || item->cullMode != lastCullMode || newLayout;
 
         if (newBuffers || newMaterial)
         {
@@ -175,14 +177,30 @@ void donut::render::RenderCompositeView(
         assert(compositeView->GetNumChildViews(supportedViewTypes) == compositeViewPrev->GetNumChildViews(supportedViewTypes));
     }
     
-    for (uint viewIndex = 0; viewIndex < compositeView->GetNumChildViews(supportedViewTypes); viewIndex++)
+    uint numViews = compositeView->GetNumChildViews(supportedViewTypes);
+
+    // Let the draw strategy cull all child views in one scene traversal if it can.
+    bool viewsPrepared = false;
+    if (numViews > 1)
+    {
+        std::vector<const IView*> views(numViews);
+        for (uint viewIndex = 0; viewIndex < numViews; viewIndex++)
+            views[viewIndex] = compositeView->GetChildView(supportedViewTypes, viewIndex);
+
+        viewsPrepared = drawStrategy.PrepareForViews(rootNode, views.data(), numViews);
+    }
+
+    for (uint viewIndex = 0; viewIndex < numViews; viewIndex++)
     {
         const IView* view = compositeView->GetChildView(supportedViewTypes, viewIndex);
         const IView* viewPrev = compositeViewPrev ? compositeViewPrev->GetChildView(supportedViewTypes, viewIndex) : nullptr;
 
         assert(view != nullptr);
 
-        drawStrategy.PrepareForView(rootNode, *view);
+        if (viewsPrepared)
+            drawStrategy.SelectView(viewIndex);
+        else
+            drawStrategy.PrepareForView(rootNode, *view);
 
         nvrhi::IFramebuffer* framebuffer = framebufferFactory.GetFramebuffer(*view);
 
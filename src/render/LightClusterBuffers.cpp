@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/render/LightClusterBuffers.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/View.h>
+#include <algorithm>
+
+using namespace donut::math;
+#include <donut/shaders/light_cb.h>
+#include <donut/shaders/light_cluster_cb.h>
+
+using namespace donut::engine;
+using namespace donut::render;
+
+LightClusterBuffers::LightClusterBuffers(nvrhi::IDevice* device)
+    : m_Device(device)
+{
+    // Create minimal buffers so that the binding sets are always valid
+    ReserveBuffer(m_LightBuffer, 1, sizeof(LightConstants), "ClusteredLights");
+    ReserveBuffer(m_ClusterBuffer, 1, sizeof(uint2), "LightClusters");
+    ReserveBuffer(m_IndexBuffer, 1, sizeof(uint32_t), "LightClusterIndices");
+}
+
+void LightClusterBuffers::ReserveBuffer(nvrhi::BufferHandle& buffer, size_t count, uint32_t stride, const char* debugName)
+{
+    const size_t byteSize = count * stride;
+
+    if (buffer && buffer->getDesc().byteSize >= byteSize)
+        return;
+
+    // Grow geometrically to avoid recreating the buffers and the binding sets every time a light is added
+    size_t capacity = 64;
+    if (buffer)
+        capacity = std::max(capacity, size_t(buffer->getDesc().byteSize / stride) * 2);
+    capacity = std::max(capacity, count);
+
+    nvrhi::BufferDesc bufferDesc;
+    bufferDesc.byteSize = capacity * stride;
+    bufferDesc.debugName = debugName;
+    bufferDesc.structStride = stride;
+    bufferDesc.initialState = nvrhi::ResourceStates::ShaderResource;
+    bufferDesc.keepInitialState = true;
+
+    buffer = m_Device->createBuffer(bufferDesc);
+    ++m_BufferVersion;
+}
+
+bool LightClusterBuffers::IsClusteredLight(const Light& light)
+{
+    ClusterLight clusterLight;
+    return IsClusteredLight(light, clusterLight);
+}
+
+bool LightClusterBuffers::IsClusteredLight(const Light& light, ClusterLight& clusterLight)
+{
+    if (light.shadowMap || light.shadowChannel >= 0)
+        return false;
+
+    return ClusterLight::FromLight(light, clusterLight);
+}
+
+uint32_t LightClusterBuffers::SetLights(nvrhi::ICommandList* commandList, const std::vector<std::shared_ptr<Light>>& lights)
+{
+    m_Lights.clear();
+    std::vector<LightConstants> lightConstants;
+
+    for (const auto& light : lights)
+    {
+        ClusterLight clusterLight;
+        if (!IsClusteredLight(*light, clusterLight))
+            continue;
+
+        m_Lights.push_back(clusterLight);
+        light->FillLightConstants(lightConstants.emplace_back());
+    }
+
+    if (!lightConstants.empty())
+    {
+        ReserveBuffer(m_LightBuffer, lightConstants.size(), sizeof(LightConstants), "ClusteredLights");
+        commandList->writeBuffer(m_LightBuffer, lightConstants.data(), lightConstants.size() * sizeof(LightConstants));
+    }
+
+    return uint32_t(m_Lights.size());
+}
+
+void LightClusterBuffers::BinLights(nvrhi::ICommandList* commandList, const IView& view, LightClusterConstants& constants)
+{
+    if (m_Lights.empty())
+    {
+        FillUnbinnedConstants(constants);
+        return;
+    }
+
+    m_Grid.Setup(view.GetViewMatrix(), view.GetProjectionMatrix(true), gridDesc);
+    m_Grid.BinLights(m_Lights.data(), uint32_t(m_Lights.size()));
+
+    const auto& ranges = m_Grid.GetClusterRanges();
+    const auto& indices = m_Grid.GetLightIndices();
+
+    ReserveBuffer(m_ClusterBuffer, ranges.size(), sizeof(uint2), "LightClusters");
+    commandList->writeBuffer(m_ClusterBuffer, ranges.data(), ranges.size() * sizeof(uint2));
+
+    if (!indices.empty())
+    {
+        ReserveBuffer(m_IndexBuffer, indices.size(), sizeof(uint32_t), "LightClusterIndices");
+        commandList->writeBuffer(m_IndexBuffer, indices.data(), indices.size() * sizeof(uint32_t));
+    }
+
+    const LightClusterGrid::Desc& desc = m_Grid.GetDesc();
+    const nvrhi::Viewport& viewport = view.GetViewportState().viewports[0];
+    const float2 viewportOrigin = float2(viewport.minX, viewport.minY);
+    const float2 viewportSize = float2(viewport.maxX - viewport.minX, viewport.maxY - viewport.minY);
+    const float2 sliceScaleBias = m_Grid.GetSliceScaleBias();
+
+    constants.tileScale = float2(float(desc.tilesX), float(desc.tilesY)) / viewportSize;
+    constants.tileBias = -viewportOrigin * constants.tileScale;
+    constants.sliceScale = sliceScaleBias.x;
+    constants.sliceBias = sliceScaleBias.y;
+    constants.numClusteredLights = uint32_t(m_Lights.size());
+    constants.gridSize = uint3(desc.tilesX, desc.tilesY, desc.slices);
+}
+
+void LightClusterBuffers::FillUnbinnedConstants(LightClusterConstants& constants) const
+{
+    constants = {};
+    constants.numClusteredLights = uint32_t(m_Lights.size());
+}
@@ -0,0 +1,247 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/core/math/math.h>
+#include <donut/tests/utils.h>
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace donut::math;
+
+static box3_array make_random_boxes(size_t count, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> position(-100.f, 100.f);
+	std::uniform_real_distribution<float> extent(0.f, 10.f);
+
+	box3_array boxes;
+	boxes.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		float3 mins(position(rng), position(rng), position(rng));
+		float3 size(extent(rng), extent(rng), extent(rng));
+		boxes.push_back(box3(mins, mins + size));
+	}
+	return boxes;
+}
+
+static std::vector<frustum> make_test_frustums()
+{
+	std::vector<frustum> frustums;
+
+	// Perspective views looking in different directions
+	float4x4 projection = perspProjD3DStyle(radians(60.f), 1.5f, 0.1f, 150.f);
+	for (int i = 0; i < 4; i++)
+	{
+		float angle = radians(90.f * float(i) + 20.f);
+		float4x4 view = affineToHomogeneous(inverse(
+			rotation(float3(0.f, 1.f, 0.f), angle) * translation(float3(float(i) * 10.f, 5.f, -20.f))));
+		frustums.push_back(frustum(view * projection, false).normalize());
+	}
+
+	// Reverse-Z projection with an infinite far plane
+	frustums.push_back(frustum(perspProjD3DStyleReverse(radians(90.f), 1.f, 1.f), true));
+
+	// Box-shaped volumes, including one that touches the boxes along their faces
+	frustums.push_back(frustum::fromBox(box3(float3(-30.f), float3(30.f))));
+	frustums.push_back(frustum::fromBox(box3(float3(0.f), float3(100.f))));
+
+	frustums.push_back(frustum::empty());
+	frustums.push_back(frustum::infinite());
+
+	return frustums;
+}
+
+static void check_against_scalar(const frustum& f, const box3_array& boxes)
+{
+	std::vector<uint32_t> indices(boxes.size());
+	size_t numVisible = cullBoxes(f, boxes, indices.data());
+
+	std::vector<uint64_t> mask((boxes.size() + 63) / 64, ~uint64_t(0));
+	cullBoxesMask(f, boxes, mask.data());
+
+	size_t expectedVisible = 0;
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		bool expected = f.intersectsWith(boxes.get(i));
+
+		CHECK(((mask[i / 64] >> (i % 64)) & 1) == (expected ? 1 : 0));
+
+		if (expected)
+		{
+			CHECK(expectedVisible < numVisible);
+			CHECK(indices[expectedVisible] == i);
+			++expectedVisible;
+		}
+	}
+	CHECK(numVisible == expectedVisible);
+
+	// Bits past the last box must be cleared
+	if (boxes.size() % 64 != 0)
+		CHECK((mask.back() >> (boxes.size() % 64)) == 0);
+}
+
+void test_culling(simd_level level)
+{
+	setCullingSimdLevel(level);
+	if (getCullingSimdLevel() != level)
+		return; // not supported by this CPU
+
+	std::vector<frustum> frustums = make_test_frustums();
+
+	// Sizes that exercise the vector loops, the remainders and the 64-box words
+	for (size_t count : { 0, 1, 3, 4, 7, 8, 63, 64, 65, 1000, 4099 })
+	{
+		box3_array boxes = make_random_boxes(count, uint32_t(count));
+		for (const frustum& f : frustums)
+			check_against_scalar(f, boxes);
+	}
+
+	// Empty boxes are rejected the same way as by the scalar code
+	box3_array boxes = make_random_boxes(100, 1);
+	for (size_t i = 0; i < boxes.size(); i += 3)
+		boxes.set(i, box3::empty());
+	for (const frustum& f : frustums)
+		check_against_scalar(f, boxes);
+
+	// Multiple frustums
+	boxes = make_random_boxes(1000, 2);
+	std::vector<uint64_t> frustumMasks(boxes.size());
+	cullBoxesMultiFrustum(frustums.data(), uint32_t(frustums.size()), boxes, frustumMasks.data());
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		uint64_t expected = 0;
+		for (size_t f = 0; f < frustums.size(); f++)
+		{
+			if (frustums[f].intersectsWith(boxes.get(i)))
+				expected |= uint64_t(1) << f;
+		}
+		CHECK(frustumMasks[i] == expected);
+	}
+
+	setCullingSimdLevel(getBestCullingSimdLevel());
+}
+
+void test_transformed_boxes()
+{
+	box3 localBox(float3(-1.f, -2.f, -3.f), float3(1.f, 2.f, 3.f));
+	affine3 transform = rotation(normalize(float3(1.f, 1.f, 0.f)), radians(30.f)) * translation(float3(5.f, 0.f, -5.f));
+
+	box3_array boxes;
+	boxes.push_back(localBox, transform);
+	CHECK(boxes.size() == 1);
+
+	box3 expected = localBox * transform;
+	box3 actual = boxes.get(0);
+	CHECK(all(actual.m_mins == expected.m_mins) && all(actual.m_maxs == expected.m_maxs));
+
+	boxes.clear();
+	CHECK(boxes.empty());
+}
+
+static const char* get_simd_level_name(simd_level level)
+{
+	switch (level)
+	{
+	case simd_level::sse: return "SSE";
+	case simd_level::avx2: return "AVX2";
+	case simd_level::neon: return "NEON";
+	default: return "scalar";
+	}
+}
+
+void benchmark_culling()
+{
+	frustum f = make_test_frustums()[0];
+
+	for (size_t count : { 100000, 250000, 500000, 1000000 })
+	{
+		box3_array boxes = make_random_boxes(count, 3);
+		std::vector<uint32_t> indices(count);
+
+		printf("Culling %zu boxes:\n", count);
+
+		// The per-box loop that the draw strategies use
+		{
+			constexpr int iterations = 10;
+			size_t numVisible = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int it = 0; it < iterations; it++)
+			{
+				numVisible = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					if (f.intersectsWith(boxes.get(i)))
+						indices[numVisible++] = uint32_t(i);
+				}
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			double time = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+			printf("  frustum::intersectsWith: %.3f ms, %zu visible\n", time, numVisible);
+		}
+
+		for (simd_level level : { simd_level::scalar, simd_level::sse, simd_level::avx2, simd_level::neon })
+		{
+			setCullingSimdLevel(level);
+			if (getCullingSimdLevel() != level)
+				continue;
+
+			constexpr int iterations = 10;
+			size_t numVisible = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int it = 0; it < iterations; it++)
+				numVisible = cullBoxes(f, boxes, indices.data());
+			auto end = std::chrono::high_resolution_clock::now();
+			double time = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+			printf("  cullBoxes (%s): %.3f ms, %zu visible\n", get_simd_level_name(level), time, numVisible);
+		}
+	}
+
+	setCullingSimdLevel(getBestCullingSimdLevel());
+}
+
+int main(int argc, char** argv)
+{
+	bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+	try
+	{
+		test_culling(simd_level::scalar);
+		test_culling(simd_level::sse);
+		test_culling(simd_level::avx2);
+		test_culling(simd_level::neon);
+		test_transformed_boxes();
+	}
+	catch (const std::runtime_error& err)
+	{
+		fprintf(stderr, "%s", err.what());
+		return 1;
+	}
+
+	if (benchmark)
+		benchmark_culling();
+
+	return 0;
+}
@@ -21,9 +21,18 @@
 */
 
 #include <donut/core/vfs/VFS.h>
+#include <donut/core/vfs/Compression.h>
+#include <donut/core/vfs/IOScheduler.h>
+#include <donut/core/vfs/TarFile.h>
 
 #include <donut/tests/utils.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <thread>
 
 using namespace donut;
 
@@ -177,6 +186,553 @@ void test_root_filesystem()
 	CHECK(rootFS.unmount("/foo") == false);
 }
 
+std::vector<uint8_t> make_test_data(size_t size, uint32_t seed)
+{
+	std::vector<uint8_t> data(size);
+	uint32_t state = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		state = state * 1664525u + 1013904223u;
+		data[i] = uint8_t(state >> 24);
+	}
+	return data;
+}
+
+void test_mapped_files()
+{
+	vfs::NativeFileSystem fs;
+	std::filesystem::path bpath(DONUT_TEST_BINARY_DIR);
+
+	std::vector<uint8_t> largeData = make_test_data(1024 * 1024 + 17, 1);
+	std::vector<uint8_t> smallData = make_test_data(100, 2);
+	CHECK(fs.writeFile(bpath / "test_vfs_large.bin", largeData.data(), largeData.size()));
+	CHECK(fs.writeFile(bpath / "test_vfs_small.bin", smallData.data(), smallData.size()));
+
+	// large files are mapped, small files are read into memory
+	{
+		std::shared_ptr<vfs::IBlob> blob = fs.readFile(bpath / "test_vfs_large.bin");
+		CHECK(blob && std::dynamic_pointer_cast<vfs::MappedBlob>(blob));
+		CHECK(blob->size() == largeData.size());
+		CHECK(memcmp(blob->data(), largeData.data(), largeData.size()) == 0);
+
+		blob = fs.readFile(bpath / "test_vfs_small.bin");
+		CHECK(blob && !std::dynamic_pointer_cast<vfs::MappedBlob>(blob));
+		CHECK(blob->size() == smallData.size());
+		CHECK(memcmp(blob->data(), smallData.data(), smallData.size()) == 0);
+	}
+
+	// writing into a mapped blob doesn't modify the file
+	{
+		std::shared_ptr<vfs::IBlob> blob = fs.readFile(bpath / "test_vfs_large.bin");
+		memset(const_cast<void*>(blob->data()), 0, 4096);
+
+		std::shared_ptr<vfs::IBlob> other = fs.readFile(bpath / "test_vfs_large.bin");
+		CHECK(memcmp(other->data(), largeData.data(), largeData.size()) == 0);
+	}
+
+	// the mapping outlives the MappedFile reference used to create the blob
+	{
+		std::shared_ptr<vfs::IBlob> blob;
+		{
+			std::shared_ptr<vfs::MappedFile> file = vfs::MappedFile::open(bpath / "test_vfs_large.bin");
+			CHECK(file && file->size() == largeData.size());
+			blob = std::make_shared<vfs::MappedBlob>(file, 1000, 5000);
+		}
+		CHECK(blob->size() == 5000);
+		CHECK(memcmp(blob->data(), largeData.data() + 1000, 5000) == 0);
+	}
+
+	// ranges map only the pages that contain them, starting anywhere in the file
+	{
+		std::shared_ptr<vfs::MappedFile> file = vfs::MappedFile::open(bpath / "test_vfs_large.bin", 70001, 100000);
+		CHECK(file && file->size() == 100000);
+		CHECK(memcmp(file->data(), largeData.data() + 70001, 100000) == 0);
+
+		file = vfs::MappedFile::open(bpath / "test_vfs_large.bin", largeData.size() - 10, 100);
+		CHECK(file && file->size() == 10);
+		CHECK(memcmp(file->data(), largeData.data() + largeData.size() - 10, 10) == 0);
+
+		CHECK(vfs::MappedFile::open(bpath / "test_vfs_large.bin", largeData.size(), 10) == nullptr);
+	}
+
+	CHECK(vfs::MappedFile::open(bpath / "dummy") == nullptr);
+}
+
+// Writes a minimal ustar archive: a 512-byte header per file, followed by the file data padded to 512 bytes.
+void write_tar_archive(const std::filesystem::path& path, const std::vector<std::pair<std::string, std::vector<uint8_t>>>& files)
+{
+	std::vector<uint8_t> archive;
+	for (const auto& [name, data] : files)
+	{
+		uint8_t header[512] = {};
+		memcpy(header, name.c_str(), name.size());
+		snprintf(reinterpret_cast<char*>(header + 124), 12, "%011llo", (unsigned long long)data.size());
+		header[156] = '0';
+		memcpy(header + 257, "ustar", 5);
+
+		archive.insert(archive.end(), header, header + sizeof(header));
+		archive.insert(archive.end(), data.begin(), data.end());
+		archive.resize((archive.size() + 511) & ~size_t(511), 0);
+	}
+	archive.resize(archive.size() + 1024, 0);
+
+	vfs::NativeFileSystem fs;
+	CHECK(fs.writeFile(path, archive.data(), archive.size()));
+}
+
+void test_tar_file()
+{
+	std::filesystem::path archivePath = std::filesystem::path(DONUT_TEST_BINARY_DIR) / "test_vfs.tar";
+
+	std::vector<std::pair<std::string, std::vector<uint8_t>>> files;
+	for (uint32_t i = 0; i < 8; ++i)
+		files.push_back({ "dir/file" + std::to_string(i) + ".bin", make_test_data(1000 + i * 40000, i) });
+	write_tar_archive(archivePath, files);
+
+	vfs::TarFile tarFile(archivePath);
+	CHECK(tarFile.isOpen());
+	CHECK(tarFile.folderExists("dir"));
+	CHECK(tarFile.fileExists("dir/file3.bin"));
+	CHECK(tarFile.readFile("dir/dummy") == nullptr);
+
+	// read all files from several threads at once
+	std::vector<std::thread> threads;
+	std::vector<int> results(4, 0);
+	for (size_t t = 0; t < results.size(); ++t)
+	{
+		threads.emplace_back([&tarFile, &files, &results, t]()
+		{
+			for (int iteration = 0; iteration < 16; ++iteration)
+			{
+				for (const auto& [name, data] : files)
+				{
+					std::shared_ptr<vfs::IBlob> blob = tarFile.readFile(name);
+					if (blob && blob->size() == data.size() && memcmp(blob->data(), data.data(), data.size()) == 0 &&
+						std::dynamic_pointer_cast<vfs::MappedBlob>(blob))
+						++results[t];
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	for (int result : results)
+		CHECK(result == int(16 * files.size()));
+}
+
+// Text-like data with lots of repetition at various distances, to exercise long matches and literal runs
+std::vector<uint8_t> make_compressible_data(size_t size, uint32_t seed)
+{
+	static const char* words[] = { "vertex", "index", "buffer", "texture", "material", "mesh", " ", "\n", "0.25", "skinned" };
+
+	std::vector<uint8_t> data;
+	data.reserve(size);
+	uint32_t state = seed;
+	while (data.size() < size)
+	{
+		state = state * 1664525u + 1013904223u;
+		if ((state >> 28) == 0)
+			data.insert(data.end(), 300 + (state >> 16) % 700, uint8_t(state >> 8));
+		else
+		{
+			const char* word = words[(state >> 16) % std::size(words)];
+			data.insert(data.end(), word, word + strlen(word));
+		}
+	}
+	data.resize(size);
+	return data;
+}
+
+void check_compression_round_trip(const std::vector<uint8_t>& data, uint32_t blockSize)
+{
+	std::vector<uint8_t> compressed = vfs::compression::compressFile(data.data(), data.size(), blockSize);
+	CHECK(vfs::compression::isCompressedFile(compressed.data(), compressed.size()));
+
+	std::shared_ptr<vfs::IBlob> blob = vfs::compression::decompressFile(compressed.data(), compressed.size());
+	CHECK(blob && blob->size() == data.size());
+	CHECK(data.empty() || memcmp(blob->data(), data.data(), data.size()) == 0);
+}
+
+void test_compression()
+{
+	// incompressible, compressible and degenerate data with different block sizes
+	for (size_t size : { 0, 1, 12, 13, 100, 4096, 65536 + 3, 1000000 })
+	{
+		for (uint32_t blockSize : { 4096u, vfs::compression::DefaultBlockSize })
+		{
+			check_compression_round_trip(make_test_data(size, uint32_t(size)), blockSize);
+			check_compression_round_trip(make_compressible_data(size, uint32_t(size)), blockSize);
+			check_compression_round_trip(std::vector<uint8_t>(size, 0x5a), blockSize);
+		}
+	}
+
+	// compressible data should actually shrink
+	{
+		std::vector<uint8_t> data = make_compressible_data(1000000, 1);
+		std::vector<uint8_t> compressed = vfs::compression::compressFile(data.data(), data.size());
+		CHECK(compressed.size() < data.size() / 2);
+	}
+
+	// single-threaded and multi-threaded decompression produce the same result
+	{
+		std::vector<uint8_t> data = make_compressible_data(3000000, 2);
+		std::vector<uint8_t> compressed = vfs::compression::compressFile(data.data(), data.size(), 64 * 1024, 1);
+		CHECK(compressed == vfs::compression::compressFile(data.data(), data.size(), 64 * 1024, 4));
+
+		std::shared_ptr<vfs::IBlob> blob = vfs::compression::decompressFile(compressed.data(), compressed.size(), 1);
+		CHECK(blob && blob->size() == data.size() && memcmp(blob->data(), data.data(), data.size()) == 0);
+		blob = vfs::compression::decompressFile(compressed.data(), compressed.size(), 4);
+		CHECK(blob && blob->size() == data.size() && memcmp(blob->data(), data.data(), data.size()) == 0);
+
+		// the blocks can also be distributed by an external executor
+		uint32_t executorCalls = 0;
+		vfs::compression::parallel_for_t executor = [&executorCalls](uint32_t count, const std::function<void(uint32_t)>& func)
+		{
+			++executorCalls;
+			for (uint32_t index = count; index > 0; --index)
+				func(index - 1);
+		};
+		CHECK(compressed == vfs::compression::compressFile(data.data(), data.size(), 64 * 1024, executor));
+		blob = vfs::compression::decompressFile(compressed.data(), compressed.size(), executor);
+		CHECK(blob && blob->size() == data.size() && memcmp(blob->data(), data.data(), data.size()) == 0);
+		CHECK(executorCalls == 2);
+	}
+
+	// corrupt and truncated data is rejected without crashing
+	{
+		std::vector<uint8_t> data = make_compressible_data(200000, 3);
+		std::vector<uint8_t> compressed = vfs::compression::compressFile(data.data(), data.size(), 16 * 1024);
+
+		for (size_t size = 0; size < compressed.size(); size += 997)
+			CHECK(vfs::compression::decompressFile(compressed.data(), size) == nullptr);
+
+		uint32_t state = 1;
+		for (int i = 0; i < 200; ++i)
+		{
+			std::vector<uint8_t> corrupt = compressed;
+			state = state * 1664525u + 1013904223u;
+			corrupt[sizeof(vfs::compression::CompressedFileHeader) + state % (corrupt.size() - sizeof(vfs::compression::CompressedFileHeader))] ^= uint8_t(1 + (state >> 24) % 255);
+			// the result is either a failure or a blob of the right size
+			std::shared_ptr<vfs::IBlob> blob = vfs::compression::decompressFile(corrupt.data(), corrupt.size());
+			CHECK(!blob || blob->size() == data.size());
+		}
+	}
+
+	CHECK(!vfs::compression::isCompressedFile(nullptr, 0));
+	CHECK(vfs::compression::compressFile("x", 1, 0).empty());
+}
+
+void test_compression_layer()
+{
+	std::filesystem::path bpath(DONUT_TEST_BINARY_DIR);
+
+	// files written through the layer are compressed if that helps, and read back transparently
+	{
+		auto nativeFS = std::make_shared<vfs::NativeFileSystem>();
+		vfs::CompressionLayer compressedFS(nativeFS);
+
+		std::vector<uint8_t> compressible = make_compressible_data(500000, 4);
+		std::vector<uint8_t> random = make_test_data(5000, 5);
+		CHECK(compressedFS.writeFile(bpath / "test_vfs_compressed.bin", compressible.data(), compressible.size()));
+		CHECK(compressedFS.writeFile(bpath / "test_vfs_uncompressed.bin", random.data(), random.size()));
+
+		std::shared_ptr<vfs::IBlob> raw = nativeFS->readFile(bpath / "test_vfs_compressed.bin");
+		CHECK(raw && raw->size() < compressible.size() && vfs::compression::isCompressedFile(raw->data(), raw->size()));
+		raw = nativeFS->readFile(bpath / "test_vfs_uncompressed.bin");
+		CHECK(raw && raw->size() == random.size());
+
+		std::shared_ptr<vfs::IBlob> blob = compressedFS.readFile(bpath / "test_vfs_compressed.bin");
+		CHECK(blob && blob->size() == compressible.size() && memcmp(blob->data(), compressible.data(), compressible.size()) == 0);
+		blob = compressedFS.readFile(bpath / "test_vfs_uncompressed.bin");
+		CHECK(blob && blob->size() == random.size() && memcmp(blob->data(), random.data(), random.size()) == 0);
+
+		CHECK(compressedFS.readFile(bpath / "dummy") == nullptr);
+	}
+
+	// a package with compressed and stored entries, like the ones made by donut_pack
+	{
+		std::vector<std::pair<std::string, std::vector<uint8_t>>> originals;
+		std::vector<std::pair<std::string, std::vector<uint8_t>>> entries;
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			std::string name = "media/file" + std::to_string(i) + ".bin";
+			std::vector<uint8_t> data = (i & 1) ? make_test_data(10000 * i, i) : make_compressible_data(300000 * i + 10, i);
+			entries.push_back({ name, (i & 1) ? data : vfs::compression::compressFile(data.data(), data.size(), 32 * 1024) });
+			originals.push_back({ name, std::move(data) });
+		}
+
+		std::filesystem::path archivePath = bpath / "test_vfs.pkz";
+		write_tar_archive(archivePath, entries);
+
+		auto tarFile = std::make_shared<vfs::TarFile>(archivePath);
+		CHECK(tarFile->isOpen());
+		vfs::CompressionLayer compressedFS(tarFile);
+
+		CHECK(compressedFS.folderExists("media"));
+		CHECK(compressedFS.fileExists("media/file2.bin"));
+
+		std::vector<std::string> files;
+		CHECK(compressedFS.enumerateFiles("media", { ".bin" }, vfs::enumerate_to_vector(files)) == int(originals.size()));
+
+		for (const auto& [name, data] : originals)
+		{
+			std::shared_ptr<vfs::IBlob> blob = compressedFS.readFile(name);
+			CHECK(blob && blob->size() == data.size());
+			CHECK(data.empty() || memcmp(blob->data(), data.data(), data.size()) == 0);
+		}
+
+		CHECK(!compressedFS.writeFile("media/new.bin", "x", 1));
+	}
+}
+
+bool check_blob_range(const std::shared_ptr<vfs::IBlob>& blob, const std::vector<uint8_t>& data, size_t offset, size_t size)
+{
+	size = std::min(size, data.size() - offset);
+	return blob && blob->size() == size && (size == 0 || memcmp(blob->data(), data.data() + offset, size) == 0);
+}
+
+void test_file_ranges()
+{
+	std::filesystem::path bpath(DONUT_TEST_BINARY_DIR);
+	std::vector<uint8_t> data = make_test_data(300000, 6);
+	std::vector<std::pair<size_t, size_t>> ranges = {
+		{ 0, 10 }, { 0, data.size() }, { 1000, 100000 }, { 65535, 70000 }, { data.size() - 5, 100 }, { data.size(), 10 } };
+
+	// native, relative and root file systems
+	{
+		auto nativeFS = std::make_shared<vfs::NativeFileSystem>();
+		CHECK(nativeFS->writeFile(bpath / "test_vfs_ranges.bin", data.data(), data.size()));
+
+		auto relativeFS = std::make_shared<vfs::RelativeFileSystem>(nativeFS, bpath);
+		vfs::RootFileSystem rootFS;
+		rootFS.mount("/bin", relativeFS);
+
+		for (const auto& [offset, size] : ranges)
+		{
+			CHECK(check_blob_range(nativeFS->readFileRange(bpath / "test_vfs_ranges.bin", offset, size), data, offset, size));
+			CHECK(check_blob_range(relativeFS->readFileRange("test_vfs_ranges.bin", offset, size), data, offset, size));
+			CHECK(check_blob_range(rootFS.readFileRange("/bin/test_vfs_ranges.bin", offset, size), data, offset, size));
+		}
+
+		CHECK(nativeFS->readFileRange(bpath / "test_vfs_ranges.bin", data.size() + 1, 10) == nullptr);
+		CHECK(nativeFS->readFileRange(bpath / "dummy", 0, 10) == nullptr);
+		CHECK(rootFS.readFileRange("/foo/test_vfs_ranges.bin", 0, 10) == nullptr);
+
+		vfs::FileLocation location;
+		CHECK(rootFS.getFileLocation("/bin/test_vfs_ranges.bin", location) && location.container == nullptr);
+		CHECK(!rootFS.getFileLocation("/bin/dummy", location));
+	}
+
+	// tar archives with and without compression
+	{
+		std::vector<uint8_t> compressed = vfs::compression::compressFile(data.data(), data.size(), 16 * 1024);
+		std::filesystem::path archivePath = bpath / "test_vfs_ranges.tar";
+		write_tar_archive(archivePath, { { "raw.bin", data }, { "compressed.bin", compressed } });
+
+		auto tarFile = std::make_shared<vfs::TarFile>(archivePath);
+		CHECK(tarFile->isOpen());
+		vfs::CompressionLayer compressedFS(tarFile);
+
+		for (const auto& [offset, size] : ranges)
+		{
+			CHECK(check_blob_range(tarFile->readFileRange("raw.bin", offset, size), data, offset, size));
+			CHECK(check_blob_range(compressedFS.readFileRange("raw.bin", offset, size), data, offset, size));
+			CHECK(check_blob_range(compressedFS.readFileRange("compressed.bin", offset, size), data, offset, size));
+		}
+
+		CHECK(compressedFS.readFileRange("compressed.bin", data.size() + 1, 10) == nullptr);
+		CHECK(tarFile->readFileRange("raw.bin", data.size() + 1, 10) == nullptr);
+
+		vfs::FileLocation rawLocation, compressedLocation;
+		CHECK(compressedFS.getFileLocation("raw.bin", rawLocation) && rawLocation.container == tarFile.get());
+		CHECK(compressedFS.getFileLocation("compressed.bin", compressedLocation) && compressedLocation.container == tarFile.get());
+		CHECK(rawLocation.offset < compressedLocation.offset);
+	}
+}
+
+// In-memory file system that records the order of reads, and can hold the first read until it's released.
+class RecordingFileSystem : public vfs::IFileSystem
+{
+public:
+	std::vector<std::string> fileNames;
+	std::vector<std::string> readOrder;
+	std::promise<void> firstReadStarted;
+	std::shared_future<void> firstReadReleased;
+	std::string throwingFile; // reading this file throws an exception
+
+	bool folderExists(const std::filesystem::path&) override { return false; }
+	bool fileExists(const std::filesystem::path& name) override { return findFile(name) >= 0; }
+	bool writeFile(const std::filesystem::path&, const void*, size_t) override { return false; }
+	int enumerateFiles(const std::filesystem::path&, const std::vector<std::string>&, vfs::enumerate_callback_t, bool) override { return vfs::status::NotImplemented; }
+	int enumerateDirectories(const std::filesystem::path&, vfs::enumerate_callback_t, bool) override { return vfs::status::NotImplemented; }
+
+	std::shared_ptr<vfs::IBlob> readFile(const std::filesystem::path& name) override
+	{
+		int index = findFile(name);
+		if (index < 0)
+			return nullptr;
+
+		if (name.generic_string() == throwingFile)
+			throw std::runtime_error("read error");
+
+		if (readOrder.empty() && firstReadReleased.valid())
+		{
+			firstReadStarted.set_value();
+			firstReadReleased.wait();
+		}
+		readOrder.push_back(name.generic_string());
+
+		std::vector<uint8_t> data = make_test_data(100 + index, uint32_t(index));
+		void* copy = malloc(data.size());
+		memcpy(copy, data.data(), data.size());
+		return std::make_shared<vfs::Blob>(copy, data.size());
+	}
+
+	// files are stored in reverse order of their names
+	bool getFileLocation(const std::filesystem::path& name, vfs::FileLocation& location) override
+	{
+		int index = findFile(name);
+		if (index < 0)
+			return false;
+
+		location.container = this;
+		location.offset = uint64_t(fileNames.size() - index) * 1000;
+		return true;
+	}
+
+private:
+	int findFile(const std::filesystem::path& name) const
+	{
+		auto it = std::find(fileNames.begin(), fileNames.end(), name.generic_string());
+		return it == fileNames.end() ? -1 : int(it - fileNames.begin());
+	}
+};
+
+void test_io_scheduler()
+{
+	// requests complete with the same data as synchronous reads, in any order
+	{
+		std::vector<uint8_t> data = make_compressible_data(500000, 7);
+		std::filesystem::path archivePath = std::filesystem::path(DONUT_TEST_BINARY_DIR) / "test_vfs_scheduler.pkz";
+		write_tar_archive(archivePath, {
+			{ "a.bin", vfs::compression::compressFile(data.data(), data.size(), 32 * 1024) },
+			{ "b.bin", data } });
+
+		auto fs = std::make_shared<vfs::CompressionLayer>(std::make_shared<vfs::TarFile>(archivePath));
+		vfs::IOScheduler scheduler(2, 8);
+
+		std::atomic<int> numCallbacks = 0;
+		std::vector<std::pair<size_t, std::future<std::shared_ptr<vfs::IBlob>>>> futures;
+		for (size_t i = 0; i < 64; ++i)
+		{
+			vfs::IORequest request;
+			request.fs = fs;
+			request.name = (i & 1) ? "a.bin" : "b.bin";
+			request.offset = (i * 7919) % data.size();
+			request.size = (i % 5 == 0) ? vfs::IORequest::WholeFile : 40000;
+			request.priority = vfs::IOPriority(i % size_t(vfs::IOPriority::Count));
+			request.callback = [&numCallbacks](std::shared_ptr<vfs::IBlob> const& blob) { if (blob) ++numCallbacks; };
+			futures.push_back({ i, scheduler.submit(std::move(request)) });
+		}
+
+		for (auto& [i, future] : futures)
+		{
+			size_t offset = (i * 7919) % data.size();
+			size_t size = (i % 5 == 0) ? vfs::IORequest::WholeFile : 40000;
+			CHECK(check_blob_range(future.get(), data, offset, size));
+		}
+
+		scheduler.waitForIdle();
+		CHECK(scheduler.getNumPendingRequests() == 0);
+		CHECK(numCallbacks == int(futures.size()));
+
+		vfs::IORequest missing;
+		missing.fs = fs;
+		missing.name = "dummy.bin";
+		CHECK(scheduler.submit(std::move(missing)).get() == nullptr);
+	}
+
+	// requests are served by priority first, then in storage order
+	{
+		auto fs = std::make_shared<RecordingFileSystem>();
+		fs->fileNames = { "first", "low0", "low1", "low2", "normal0", "normal1", "high0" };
+		std::promise<void> release;
+		fs->firstReadReleased = release.get_future().share();
+
+		vfs::IOScheduler scheduler(1);
+
+		auto submit = [&scheduler, &fs](const char* name, vfs::IOPriority priority)
+		{
+			vfs::IORequest request;
+			request.fs = fs;
+			request.name = name;
+			request.priority = priority;
+			return scheduler.submit(std::move(request));
+		};
+
+		auto first = submit("first", vfs::IOPriority::Low);
+		fs->firstReadStarted.get_future().wait();
+
+		std::vector<std::future<std::shared_ptr<vfs::IBlob>>> futures;
+		futures.push_back(submit("low0", vfs::IOPriority::Low));
+		futures.push_back(submit("normal0", vfs::IOPriority::Normal));
+		futures.push_back(submit("low2", vfs::IOPriority::Low));
+		futures.push_back(submit("high0", vfs::IOPriority::High));
+		futures.push_back(submit("low1", vfs::IOPriority::Low));
+		futures.push_back(submit("normal1", vfs::IOPriority::Normal));
+		CHECK(scheduler.getNumPendingRequests() == futures.size() + 1);
+
+		release.set_value();
+		scheduler.waitForIdle();
+
+		CHECK(first.get() != nullptr);
+		for (auto& future : futures)
+			CHECK(future.get() != nullptr);
+
+		std::vector<std::string> expectedOrder = { "first", "high0", "normal1", "normal0", "low2", "low1", "low0" };
+		CHECK(fs->readOrder == expectedOrder);
+	}
+
+	// exceptions thrown by reads and callbacks don't stop the IO thread
+	{
+		auto fs = std::make_shared<RecordingFileSystem>();
+		fs->fileNames = { "good", "bad" };
+		fs->throwingFile = "bad";
+
+		vfs::IOScheduler scheduler(1);
+
+		bool badCallbackCalled = false;
+		vfs::IORequest bad;
+		bad.fs = fs;
+		bad.name = "bad";
+		bad.callback = [&badCallbackCalled](std::shared_ptr<vfs::IBlob> const& blob) { badCallbackCalled = !blob; };
+		CHECK(scheduler.submit(std::move(bad)).get() == nullptr);
+		CHECK(badCallbackCalled);
+
+		vfs::IORequest throwingCallback;
+		throwingCallback.fs = fs;
+		throwingCallback.name = "good";
+		throwingCallback.callback = [](std::shared_ptr<vfs::IBlob> const&) { throw std::runtime_error("callback error"); };
+		auto future = scheduler.submit(std::move(throwingCallback));
+		bool rethrown = false;
+		try
+		{
+			future.get();
+		}
+		catch (const std::runtime_error&)
+		{
+			rethrown = true;
+		}
+		CHECK(rethrown);
+
+		vfs::IORequest good;
+		good.fs = fs;
+		good.name = "good";
+		CHECK(scheduler.submit(std::move(good)).get() != nullptr);
+	}
+}
+
 int main(int, char** argv)
 {
 	try
@@ -184,6 +740,12 @@ int main(int, char** argv)
 		test_native_filesystem();
 		test_relative_filesystem();
 		test_root_filesystem();
+		test_mapped_files();
+		test_tar_file();
+		test_compression();
+		test_compression_layer();
+		test_file_ranges();
+		test_io_scheduler();
 	}
 	catch (const std::runtime_error & err)
 	{
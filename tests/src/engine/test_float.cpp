@@ -34,9 +34,15 @@ extern "C"
 #include <donut/tests/utils.h>
 #include <donut/app/DeviceManager.h>
 #include <donut/app/ApplicationBase.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <random>
+#include <string>
+#include <vector>
 #include <nvrhi/utils.h>
 
 using namespace donut::math;
@@ -404,6 +410,185 @@ bool test_float8e5m2()
     return errorCount == 0;
 }
 
+const char* get_simd_level_name(simd_level level)
+{
+    switch (level)
+    {
+    case simd_level::sse: return "SSE";
+    case simd_level::avx2: return "AVX2";
+    case simd_level::avx512: return "AVX-512";
+    case simd_level::neon: return "NEON";
+    default: return "scalar";
+    }
+}
+
+// Builds a batch of FP32 inputs that covers every sign, exponent and the upper 15 mantissa bits,
+// which contain all rounding positions of the output formats. The low mantissa bits cycle through
+// patterns around the rounding ties.
+void make_bulk_input(uint32_t firstHighBits, std::vector<float>& values)
+{
+    const uint32_t lowBits[] = { 0x00, 0x01, 0x7f, 0x80, 0x81, 0xff };
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        uint32_t highBits = firstHighBits + uint32_t(i);
+        values[i] = asfloat((highBits << 8) | lowBits[highBits % std::size(lowBits)]);
+    }
+}
+
+// Compares the bulk down-conversions with the scalar ones for 2^24 inputs.
+// The batch size is not a multiple of any vector width, so the scalar tail code is tested too.
+template<typename T>
+bool test_bulk_down_conversion(const char* name, T (*scalar)(float), void (*bulk)(const float*, T*, size_t))
+{
+    constexpr uint32_t batchSize = 4099;
+    constexpr uint32_t totalCount = 1u << 24;
+
+    std::vector<float> input(batchSize);
+    std::vector<T> expected(batchSize);
+    std::vector<T> output(batchSize);
+    uint32_t errorCount = 0;
+
+    for (uint32_t first = 0; first < totalCount; first += batchSize)
+    {
+        const size_t count = std::min(batchSize, totalCount - first);
+        input.resize(count);
+        make_bulk_input(first, input);
+
+        for (size_t i = 0; i < count; ++i)
+            expected[i] = scalar(input[i]);
+
+        bulk(input.data(), output.data(), count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (output[i] != expected[i])
+            {
+                ++errorCount;
+                if (errorCount < MAX_ERRORS)
+                {
+                    fprintf(stderr, "Bulk %s mismatch: input 0x%08x, expected 0x%04x, got 0x%04x\n",
+                        name, asuint(input[i]), uint32_t(expected[i].bits), uint32_t(output[i].bits));
+                }
+            }
+        }
+    }
+
+    if (errorCount >= MAX_ERRORS)
+    {
+        fprintf(stderr, "... %u more error(s) ...\n", errorCount - MAX_ERRORS);
+    }
+
+    return errorCount == 0;
+}
+
+// Compares the bulk up-conversions with the scalar ones for all inputs, including the exact NaN bits.
+template<typename T>
+bool test_bulk_up_conversion(const char* name, float (*scalar)(T), void (*bulk)(const T*, float*, size_t))
+{
+    constexpr size_t count = size_t(1) << (sizeof(T) * 8);
+
+    std::vector<T> input(count);
+    std::vector<float> output(count);
+    for (size_t i = 0; i < count; ++i)
+        input[i].bits = decltype(T::bits)(i);
+
+    bulk(input.data(), output.data(), count);
+
+    uint32_t errorCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t expected = asuint(scalar(input[i]));
+        if (asuint(output[i]) != expected)
+        {
+            ++errorCount;
+            if (errorCount < MAX_ERRORS)
+            {
+                fprintf(stderr, "Bulk %s mismatch: input 0x%04x, expected 0x%08x, got 0x%08x\n",
+                    name, uint32_t(i), expected, asuint(output[i]));
+            }
+        }
+    }
+
+    if (errorCount >= MAX_ERRORS)
+    {
+        fprintf(stderr, "... %u more error(s) ...\n", errorCount - MAX_ERRORS);
+    }
+
+    return errorCount == 0;
+}
+
+bool test_bulk_float16()
+{
+    bool pass = true;
+    pass &= test_bulk_down_conversion<float16_t>("FP16", Float32ToFloat16, Float32ToFloat16);
+    pass &= test_bulk_up_conversion<float16_t>("FP16", Float16ToFloat32, Float16ToFloat32);
+    return pass;
+}
+
+bool test_bulk_float8()
+{
+    bool pass = true;
+    pass &= test_bulk_down_conversion<float8e4m3_t>("E4M3", Float32ToFloat8E4M3, Float32ToFloat8E4M3);
+    pass &= test_bulk_up_conversion<float8e4m3_t>("E4M3", Float8E4M3ToFloat32, Float8E4M3ToFloat32);
+    pass &= test_bulk_down_conversion<float8e5m2_t>("E5M2", Float32ToFloat8E5M2, Float32ToFloat8E5M2);
+    pass &= test_bulk_up_conversion<float8e5m2_t>("E5M2", Float8E5M2ToFloat32, Float8E5M2ToFloat32);
+    return pass;
+}
+
+template<typename T>
+void benchmark_conversion(const char* name, T (*scalar)(float), void (*bulk)(const float*, T*, size_t),
+    float (*scalarUp)(T), void (*bulkUp)(const T*, float*, size_t))
+{
+    constexpr size_t count = 1 << 24;
+    std::vector<float> values(count);
+    std::vector<T> converted(count);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+    for (float& value : values)
+        value = distribution(rng);
+
+    const auto measure = [](auto&& function)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        return double(count) / seconds * 1e-6;
+    };
+
+    double scalarDown = measure([&]() { for (size_t i = 0; i < count; ++i) converted[i] = scalar(values[i]); });
+    double scalarUpRate = measure([&]() { for (size_t i = 0; i < count; ++i) values[i] = scalarUp(converted[i]); });
+    printf("  %s scalar functions: %.0f M/s down, %.0f M/s up\n", name, scalarDown, scalarUpRate);
+
+    for (simd_level level : { simd_level::scalar, simd_level::sse, simd_level::avx2, simd_level::avx512, simd_level::neon })
+    {
+        SetFloatConversionSimdLevel(level);
+        if (GetFloatConversionSimdLevel() != level)
+            continue;
+
+        double bulkDown = measure([&]() { bulk(values.data(), converted.data(), count); });
+        double bulkUpRate = measure([&]() { bulkUp(converted.data(), values.data(), count); });
+        printf("  %s bulk (%s): %.0f M/s down, %.0f M/s up\n", name, get_simd_level_name(level), bulkDown, bulkUpRate);
+    }
+
+    SetFloatConversionSimdLevel(GetBestFloatConversionSimdLevel());
+}
+
+void benchmark_bulk_conversions()
+{
+    printf("Bulk conversion throughput, %s F16C:\n", IsF16CSupported() ? "with" : "without");
+    if (IsF16CSupported())
+    {
+        EnableF16C(true);
+        benchmark_conversion<float16_t>("FP16", Float32ToFloat16, Float32ToFloat16, Float16ToFloat32, Float16ToFloat32);
+        printf("Without F16C:\n");
+    }
+    EnableF16C(false);
+    benchmark_conversion<float16_t>("FP16", Float32ToFloat16, Float32ToFloat16, Float16ToFloat32, Float16ToFloat32);
+    benchmark_conversion<float8e4m3_t>("E4M3", Float32ToFloat8E4M3, Float32ToFloat8E4M3, Float8E4M3ToFloat32, Float8E4M3ToFloat32);
+    benchmark_conversion<float8e5m2_t>("E5M2", Float32ToFloat8E5M2, Float32ToFloat8E5M2, Float8E5M2ToFloat32, Float8E5M2ToFloat32);
+}
+
 bool test_gpu_float8(nvrhi::IDevice* device, bool e5m2)
 {
     nvrhi::CommandListHandle commandList = device->createCommandList();
@@ -577,6 +762,12 @@ int main(int argc, char** argv)
     std::unique_ptr<donut::app::DeviceManager> deviceManager = InitializeGraphicsDevice(graphicsApi);
 
     bool f16c = donut::math::IsF16CSupported();
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+            benchmark = true;
+    }
 
     bool pass = true;
 
@@ -608,6 +799,24 @@ int main(int argc, char** argv)
         pass &= ReportTestResult("FP16 vectors (HW)", test_float16_vectors());
     }
 
+    for (simd_level level : { simd_level::scalar, simd_level::sse, simd_level::avx2, simd_level::avx512, simd_level::neon })
+    {
+        donut::math::SetFloatConversionSimdLevel(level);
+        if (donut::math::GetFloatConversionSimdLevel() != level)
+            continue;
+
+        std::string levelName = std::string(" (") + get_simd_level_name(level) + ")";
+        donut::math::EnableF16C(false);
+        pass &= ReportTestResult(("Bulk FP16 conversions" + levelName).c_str(), test_bulk_float16());
+        if (f16c)
+        {
+            donut::math::EnableF16C(true);
+            pass &= ReportTestResult(("Bulk FP16 conversions (HW)" + levelName).c_str(), test_bulk_float16());
+        }
+        pass &= ReportTestResult(("Bulk FP8 conversions" + levelName).c_str(), test_bulk_float8());
+    }
+    donut::math::SetFloatConversionSimdLevel(donut::math::GetBestFloatConversionSimdLevel());
+
     if (deviceManager && deviceManager->GetDevice())
     {
         std::string graphicsApiString = nvrhi::utils::GraphicsAPIToString(graphicsApi);
@@ -623,5 +832,8 @@ int main(int argc, char** argv)
         pass &= ReportTestResult(testName.c_str(), test_gpu_float8(deviceManager->GetDevice(), true));
     }
 	
+    if (benchmark)
+        benchmark_bulk_conversions();
+
     return pass ? 0 : 1;
 }
@@ -0,0 +1,398 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/GltfImporter.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/SceneTypes.h>
+#include <donut/engine/TextureCache.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/vfs/VFS.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <typeinfo>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// A read-only file system that keeps the files in memory, so that the test doesn't touch the disk.
+class MemoryFileSystem : public vfs::IFileSystem
+{
+public:
+    std::map<std::string, std::vector<uint8_t>> files;
+
+    bool folderExists(const std::filesystem::path& name) override { return false; }
+
+    bool fileExists(const std::filesystem::path& name) override
+    {
+        return files.find(name.generic_string()) != files.end();
+    }
+
+    std::shared_ptr<vfs::IBlob> readFile(const std::filesystem::path& name) override
+    {
+        auto it = files.find(name.generic_string());
+        if (it == files.end())
+            return nullptr;
+
+        void* data = malloc(it->second.size());
+        memcpy(data, it->second.data(), it->second.size());
+        return std::make_shared<vfs::Blob>(data, it->second.size());
+    }
+
+    bool getFileAttributes(const std::filesystem::path& name, vfs::FileAttributes& attributes) override { return false; }
+
+    bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override { return false; }
+
+    int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, vfs::enumerate_callback_t callback, bool allowDuplicates) override
+    {
+        return vfs::status::NotImplemented;
+    }
+
+    int enumerateDirectories(const std::filesystem::path& path, vfs::enumerate_callback_t callback, bool allowDuplicates) override
+    {
+        return vfs::status::NotImplemented;
+    }
+};
+
+// Writes a glTF file with an external buffer. Only the parts that the test model needs are supported.
+class GltfWriter
+{
+public:
+    std::vector<uint8_t> buffer;
+    std::string bufferViews;
+    std::string accessors;
+    int numAccessors = 0;
+
+    template<typename T>
+    int AddAccessor(const std::vector<T>& data, int componentType, const char* type, bool normalized = false)
+    {
+        size_t offset = (buffer.size() + 3) & ~size_t(3);
+        buffer.resize(offset + data.size() * sizeof(T));
+        memcpy(buffer.data() + offset, data.data(), data.size() * sizeof(T));
+
+        size_t numComponents = strcmp(type, "SCALAR") == 0 ? 1 : strcmp(type, "VEC2") == 0 ? 2
+            : strcmp(type, "VEC3") == 0 ? 3 : strcmp(type, "VEC4") == 0 ? 4 : 16;
+        size_t componentSize = (componentType == 5121) ? 1 : (componentType == 5123) ? 2 : 4;
+        size_t count = data.size() * sizeof(T) / (numComponents * componentSize);
+
+        int index = numAccessors++;
+        Append(bufferViews, "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) + ",\"byteLength\":" + std::to_string(data.size() * sizeof(T)) + "}");
+        Append(accessors, "{\"bufferView\":" + std::to_string(index) + ",\"componentType\":" + std::to_string(componentType)
+            + ",\"count\":" + std::to_string(count) + ",\"type\":\"" + type + "\"" + (normalized ? ",\"normalized\":true" : "") + "}");
+        return index;
+    }
+
+    static void Append(std::string& list, const std::string& item)
+    {
+        if (!list.empty())
+            list += ",";
+        list += item;
+    }
+};
+
+// Generates a model with enough vertices to split the mesh import into several batches: meshes with one or
+// two primitives and shared materials, primitives with and without tangents, 16 and 32-bit indices,
+// a primitive with morph targets, and a skinned mesh.
+static void WriteTestModel(MemoryFileSystem& fs, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    GltfWriter writer;
+
+    auto addVectors = [&writer, &rng, &dist](size_t count, int components, bool normalize)
+    {
+        std::vector<float> data(count * components);
+        for (size_t i = 0; i < count; i++)
+        {
+            float4 v = float4(dist(rng), dist(rng), dist(rng), 1.f);
+            if (normalize)
+                v = float4(math::normalize(v.xyz()), components == 4 ? 1.f : 0.f);
+            for (int c = 0; c < components; c++)
+                data[i * components + c] = v[c];
+        }
+        return writer.AddAccessor(data, 5126, components == 2 ? "VEC2" : components == 3 ? "VEC3" : "VEC4");
+    };
+
+    // Triangles over a grid of vertices, so that most vertices are shared by several triangles
+    auto addIndices = [&writer](uint32_t gridSize)
+    {
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y + 1 < gridSize; y++)
+        {
+            for (uint32_t x = 0; x + 1 < gridSize; x++)
+            {
+                uint32_t i = y * gridSize + x;
+                indices.insert(indices.end(), { i, i + 1, i + gridSize, i + 1, i + gridSize + 1, i + gridSize });
+            }
+        }
+
+        if (gridSize * gridSize <= 65536)
+            return writer.AddAccessor(std::vector<uint16_t>(indices.begin(), indices.end()), 5123, "SCALAR");
+        return writer.AddAccessor(indices, 5125, "SCALAR");
+    };
+
+    std::string meshes;
+    std::string nodes;
+    std::string rootChildren;
+    const int numMeshes = 8;
+    const int skinnedMesh = numMeshes - 1;
+    int numNodes = 1;
+
+    for (int meshIndex = 0; meshIndex < numMeshes; meshIndex++)
+    {
+        std::string primitives;
+        int numPrimitives = 1 + meshIndex % 2;
+        for (int primIndex = 0; primIndex < numPrimitives; primIndex++)
+        {
+            uint32_t gridSize = 20 + rng() % 120;
+            uint32_t numVertices = gridSize * gridSize;
+
+            std::string attributes = "\"POSITION\":" + std::to_string(addVectors(numVertices, 3, false))
+                + ",\"NORMAL\":" + std::to_string(addVectors(numVertices, 3, true))
+                + ",\"TEXCOORD_0\":" + std::to_string(addVectors(numVertices, 2, false));
+
+            // Every third mesh has no tangents and gets them generated
+            if (meshIndex % 3 != 0)
+                attributes += ",\"TANGENT\":" + std::to_string(addVectors(numVertices, 4, true));
+
+            if (meshIndex == skinnedMesh)
+            {
+                std::vector<uint8_t> joints(numVertices * 4);
+                std::vector<float> weights(numVertices * 4);
+                for (uint32_t i = 0; i < numVertices; i++)
+                {
+                    joints[i * 4 + 0] = 0;
+                    joints[i * 4 + 1] = 1;
+                    weights[i * 4 + 0] = float(i % 5) * 0.25f;
+                    weights[i * 4 + 1] = 1.f - weights[i * 4 + 0];
+                }
+                attributes += ",\"JOINTS_0\":" + std::to_string(writer.AddAccessor(joints, 5121, "VEC4"))
+                    + ",\"WEIGHTS_0\":" + std::to_string(writer.AddAccessor(weights, 5126, "VEC4"));
+            }
+
+            std::string primitive = "{\"attributes\":{" + attributes + "},\"indices\":" + std::to_string(addIndices(gridSize))
+                + ",\"material\":" + std::to_string((meshIndex + primIndex) % 3);
+
+            if (meshIndex == 2)
+            {
+                primitive += ",\"targets\":[{\"POSITION\":" + std::to_string(addVectors(numVertices, 3, false))
+                    + "},{\"POSITION\":" + std::to_string(addVectors(numVertices, 3, false))
+                    + ",\"NORMAL\":" + std::to_string(addVectors(numVertices, 3, false)) + "}]";
+            }
+
+            GltfWriter::Append(primitives, primitive + "}");
+        }
+
+        GltfWriter::Append(meshes, "{\"name\":\"Mesh" + std::to_string(meshIndex) + "\",\"primitives\":[" + primitives + "]}");
+
+        // Two instances of the first mesh
+        for (int instance = 0; instance < (meshIndex == 0 ? 2 : 1); instance++)
+        {
+            std::string node = "{\"name\":\"Node" + std::to_string(numNodes) + "\",\"mesh\":" + std::to_string(meshIndex)
+                + ",\"translation\":[" + std::to_string(meshIndex * 3) + "," + std::to_string(instance) + ",0]";
+            if (meshIndex == skinnedMesh)
+                node += ",\"skin\":0";
+            GltfWriter::Append(nodes, node + "}");
+            GltfWriter::Append(rootChildren, std::to_string(numNodes++));
+        }
+    }
+
+    // Joints of the skinned mesh
+    std::vector<float> inverseBindMatrices(32, 0.f);
+    for (int i = 0; i < 4; i++)
+        inverseBindMatrices[i * 5] = inverseBindMatrices[16 + i * 5] = 1.f;
+    int inverseBindMatricesAccessor = writer.AddAccessor(inverseBindMatrices, 5126, "MAT4");
+    int firstJoint = numNodes;
+    for (int joint = 0; joint < 2; joint++)
+    {
+        GltfWriter::Append(nodes, "{\"name\":\"Joint" + std::to_string(joint) + "\",\"translation\":[0," + std::to_string(joint) + ",0]}");
+        GltfWriter::Append(rootChildren, std::to_string(numNodes++));
+    }
+
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+        "\"nodes\":[{\"name\":\"Root\",\"children\":[" + rootChildren + "]}," + nodes + "],"
+        "\"meshes\":[" + meshes + "],"
+        "\"materials\":["
+            "{\"name\":\"Opaque\",\"pbrMetallicRoughness\":{\"baseColorFactor\":[1,0.5,0.25,1],\"roughnessFactor\":0.5}},"
+            "{\"name\":\"Masked\",\"alphaMode\":\"MASK\",\"alphaCutoff\":0.3,\"doubleSided\":true},"
+            "{\"name\":\"Blended\",\"alphaMode\":\"BLEND\",\"pbrMetallicRoughness\":{\"metallicFactor\":0.75}}],"
+        "\"skins\":[{\"inverseBindMatrices\":" + std::to_string(inverseBindMatricesAccessor)
+            + ",\"joints\":[" + std::to_string(firstJoint) + "," + std::to_string(firstJoint + 1) + "]}],"
+        "\"buffers\":[{\"uri\":\"model.bin\",\"byteLength\":" + std::to_string(writer.buffer.size()) + "}],"
+        "\"bufferViews\":[" + writer.bufferViews + "],"
+        "\"accessors\":[" + writer.accessors + "]}";
+
+    fs.files["/models/model.gltf"].assign(json.begin(), json.end());
+    fs.files["/models/model.bin"] = writer.buffer;
+}
+
+static bool Load(const std::shared_ptr<MemoryFileSystem>& fs, ThreadPool* threadPool, SceneImportResult& result)
+{
+    TextureCache textureCache(nullptr, fs, nullptr);
+    GltfImporter importer(fs, std::make_shared<SceneTypeFactory>());
+    SceneLoadingStats stats;
+    return importer.Load("/models/model.gltf", textureCache, stats, threadPool, result);
+}
+
+static bool CompareMaterials(const Material& a, const Material& b)
+{
+    return a.name == b.name
+        && a.materialIndexInModel == b.materialIndexInModel
+        && a.domain == b.domain
+        && all(a.baseOrDiffuseColor == b.baseOrDiffuseColor)
+        && a.metalness == b.metalness
+        && a.roughness == b.roughness
+        && a.alphaCutoff == b.alphaCutoff
+        && a.doubleSided == b.doubleSided;
+}
+
+// Compares the bytes, the vector types have no operator== that returns bool.
+template<typename T>
+static bool SameData(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+static bool CompareBuffers(const BufferGroup& a, const BufferGroup& b)
+{
+    return SameData(a.indexData, b.indexData)
+        && SameData(a.positionData, b.positionData)
+        && SameData(a.texcoord1Data, b.texcoord1Data)
+        && SameData(a.texcoord2Data, b.texcoord2Data)
+        && SameData(a.normalData, b.normalData)
+        && SameData(a.tangentData, b.tangentData)
+        && SameData(a.jointData, b.jointData)
+        && SameData(a.weightData, b.weightData)
+        && SameData(a.morphTargetData, b.morphTargetData);
+}
+
+static bool CompareMeshes(const MeshInfo& a, const MeshInfo& b)
+{
+    if (a.name != b.name || a.type != b.type || a.indexOffset != b.indexOffset || a.vertexOffset != b.vertexOffset
+        || a.totalIndices != b.totalIndices || a.totalVertices != b.totalVertices
+        || a.isMorphTargetAnimationMesh != b.isMorphTargetAnimationMesh || a.isSkinPrototype != b.isSkinPrototype
+        || a.geometries.size() != b.geometries.size() || !(a.objectSpaceBounds == b.objectSpaceBounds)
+        || !a.buffers != !b.buffers || (a.buffers && !CompareBuffers(*a.buffers, *b.buffers)))
+        return false;
+
+    for (size_t i = 0; i < a.geometries.size(); i++)
+    {
+        const MeshGeometry& ga = *a.geometries[i];
+        const MeshGeometry& gb = *b.geometries[i];
+        if (ga.indexOffsetInMesh != gb.indexOffsetInMesh || ga.vertexOffsetInMesh != gb.vertexOffsetInMesh
+            || ga.numIndices != gb.numIndices || ga.numVertices != gb.numVertices || ga.type != gb.type
+            || !(ga.objectSpaceBounds == gb.objectSpaceBounds) || !CompareMaterials(*ga.material, *gb.material))
+            return false;
+    }
+
+    return true;
+}
+
+// Walks both graphs in lockstep and compares the nodes, their transforms and their leaves.
+static bool CompareImports(const SceneImportResult& a, const SceneImportResult& b)
+{
+    SceneGraphWalker walkerA(a.rootNode.get());
+    SceneGraphWalker walkerB(b.rootNode.get());
+    int numMeshInstances = 0;
+
+    while (walkerA && walkerB)
+    {
+        if (walkerA->GetName() != walkerB->GetName()
+            || any(walkerA->GetTranslation() != walkerB->GetTranslation())
+            || any(walkerA->GetScaling() != walkerB->GetScaling())
+            || walkerA->GetNumChildren() != walkerB->GetNumChildren()
+            || !walkerA->GetLeaf() != !walkerB->GetLeaf())
+            return false;
+
+        if (walkerA->GetLeaf())
+        {
+            const SceneGraphLeaf& leafA = *walkerA->GetLeaf();
+            const SceneGraphLeaf& leafB = *walkerB->GetLeaf();
+            if (typeid(leafA) != typeid(leafB))
+                return false;
+
+            auto meshInstanceA = dynamic_cast<const MeshInstance*>(&leafA);
+            auto meshInstanceB = dynamic_cast<const MeshInstance*>(&leafB);
+            if (meshInstanceA)
+            {
+                if (!CompareMeshes(*meshInstanceA->GetMesh(), *meshInstanceB->GetMesh()))
+                    return false;
+                ++numMeshInstances;
+            }
+
+            auto skinnedInstanceA = dynamic_cast<const SkinnedMeshInstance*>(&leafA);
+            auto skinnedInstanceB = dynamic_cast<const SkinnedMeshInstance*>(&leafB);
+            if (skinnedInstanceA)
+            {
+                if (skinnedInstanceA->joints.size() != skinnedInstanceB->joints.size()
+                    || !CompareMeshes(*skinnedInstanceA->GetPrototypeMesh(), *skinnedInstanceB->GetPrototypeMesh()))
+                    return false;
+            }
+        }
+
+        walkerA.Next(true);
+        walkerB.Next(true);
+    }
+
+    return !walkerA && !walkerB && numMeshInstances != 0;
+}
+
+void test_parallel_import_matches_serial()
+{
+    auto fs = std::make_shared<MemoryFileSystem>();
+    WriteTestModel(*fs, 1);
+
+    SceneImportResult serial;
+    CHECK(Load(fs, nullptr, serial));
+    CHECK(serial.rootNode);
+
+    for (uint32_t numThreads : { 1u, 2u, 4u, 8u })
+    {
+        ThreadPool threadPool(numThreads);
+        SceneImportResult parallel;
+        CHECK(Load(fs, &threadPool, parallel));
+        CHECK(CompareImports(serial, parallel));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+
+    try
+    {
+        test_parallel_import_matches_serial();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    return 0;
+}
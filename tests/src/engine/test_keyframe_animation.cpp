@@ -0,0 +1,531 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/KeyframeAnimation.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+using namespace donut::engine::animation;
+
+const InterpolationMode c_AllModes[] = {
+    InterpolationMode::Step,
+    InterpolationMode::Linear,
+    InterpolationMode::Slerp,
+    InterpolationMode::CatmullRomSpline,
+    InterpolationMode::HermiteSpline
+};
+
+// Creates a sampler with unevenly spaced keyframes starting at 'startTime'.
+// Slerp samplers get normalized quaternions, the others get arbitrary values and tangents.
+std::shared_ptr<Sampler> MakeSampler(InterpolationMode mode, uint32_t numKeyframes, float startTime, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> step(0.01f, 0.1f);
+    std::uniform_real_distribution<float> value(-1.f, 1.f);
+
+    auto sampler = std::make_shared<Sampler>();
+    sampler->SetInterpolationMode(mode);
+
+    float time = startTime;
+    for (uint32_t i = 0; i < numKeyframes; ++i)
+    {
+        Keyframe keyframe;
+        keyframe.time = time;
+        keyframe.value = float4(value(rng), value(rng), value(rng), value(rng));
+        if (mode == InterpolationMode::Slerp)
+            keyframe.value = normalize(keyframe.value);
+        keyframe.inTangent = float4(value(rng), value(rng), value(rng), value(rng));
+        keyframe.outTangent = float4(value(rng), value(rng), value(rng), value(rng));
+        sampler->AddKeyframe(keyframe);
+        time += step(rng);
+    }
+
+    return sampler;
+}
+
+bool SameResult(const std::optional<float4>& a, const std::optional<float4>& b, float tolerance)
+{
+    if (a.has_value() != b.has_value())
+        return false;
+    if (!a.has_value())
+        return true;
+    return all(abs(a.value() - b.value()) <= float4(tolerance) * max(float4(1.f), abs(a.value())));
+}
+
+void test_sampler_cursor()
+{
+    std::mt19937 rng(7);
+
+    for (InterpolationMode mode : c_AllModes)
+    {
+        auto sampler = MakeSampler(mode, 200, 0.5f, uint32_t(mode));
+        const float start = sampler->GetStartTime();
+        const float end = sampler->GetEndTime();
+
+        // Forward playback in small steps, then larger steps, backward playback, looping and random jumps.
+        // The cursor must give exactly the same results as the search from scratch.
+        std::vector<float> times;
+        for (float t = start - 0.1f; t < end + 0.1f; t += 0.004f)
+            times.push_back(t);
+        for (float t = start; t < end; t += 0.37f)
+            times.push_back(t);
+        for (float t = end + 0.05f; t > start - 0.05f; t -= 0.011f)
+            times.push_back(t);
+        for (int loop = 0; loop < 3; ++loop)
+            for (float t = start; t < end; t += 0.09f)
+                times.push_back(t);
+        std::uniform_real_distribution<float> randomTime(start - 0.1f, end + 0.1f);
+        for (int i = 0; i < 1000; ++i)
+            times.push_back(randomTime(rng));
+        for (int i = 0; i < 200; i += 7)
+            times.push_back(sampler->GetKeyframes()[i].time);
+
+        SamplerCursor cursor;
+        for (float time : times)
+        {
+            for (bool extrapolate : { false, true })
+            {
+                std::optional<float4> expected = sampler->Evaluate(time, extrapolate);
+                std::optional<float4> result = sampler->Evaluate(time, extrapolate, cursor);
+                CHECK(SameResult(expected, result, 0.f));
+            }
+        }
+    }
+}
+
+void test_sampler_batch()
+{
+    SamplerBatch batch;
+    std::vector<std::shared_ptr<Sampler>> samplers;
+    uint32_t seed = 1;
+    for (InterpolationMode mode : c_AllModes)
+    {
+        // Different start times and lengths, so that the samplers hit their boundaries at different times
+        for (uint32_t i = 0; i < 20; ++i)
+            samplers.push_back(MakeSampler(mode, 2 + i * 5, float(i) * 0.1f, seed++));
+
+        // Degenerate samplers with one and zero keyframes
+        samplers.push_back(MakeSampler(mode, 1, 0.5f, seed++));
+        samplers.push_back(MakeSampler(mode, 0, 0.f, seed++));
+    }
+
+    for (size_t i = 0; i < samplers.size(); ++i)
+    {
+        CHECK(batch.AddSampler(samplers[i]) == i);
+    }
+
+    for (bool extrapolate : { false, true })
+    {
+        for (float time = -0.1f; time < 6.f; time += 0.013f)
+        {
+            batch.Evaluate(time, extrapolate);
+
+            for (size_t i = 0; i < samplers.size(); ++i)
+            {
+                std::optional<float4> expected = samplers[i]->Evaluate(time, extrapolate);
+                std::optional<float4> result;
+                if (batch.HasValue(i))
+                    result = batch.GetValue(i);
+
+                // The batch computes the same expressions, only allow for different contraction into FMA
+                CHECK(SameResult(expected, result, 1e-5f));
+            }
+        }
+    }
+}
+
+// Creates a sampler that looks like motion capture data: smooth curves sampled uniformly at 30 Hz,
+// with constant stretches. Slerp samplers get unit quaternions, Hermite samplers get the curve derivatives as tangents.
+std::shared_ptr<Sampler> MakeMotionSampler(InterpolationMode mode, uint32_t numKeyframes, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> frequency(0.2f, 2.f);
+    std::uniform_real_distribution<float> amplitude(0.1f, 3.f);
+    const float4 frequencies = float4(frequency(rng), frequency(rng), frequency(rng), frequency(rng));
+    const float4 amplitudes = float4(amplitude(rng), amplitude(rng), amplitude(rng), amplitude(rng));
+
+    auto sampler = std::make_shared<Sampler>();
+    sampler->SetInterpolationMode(mode);
+
+    for (uint32_t i = 0; i < numKeyframes; ++i)
+    {
+        // Hold the pose for one second out of every four
+        const float time = float(i) / 30.f;
+        const float phase = std::fmod(time, 4.f) < 1.f ? std::floor(time / 4.f) * 4.f : time;
+
+        Keyframe keyframe;
+        keyframe.time = time;
+        for (int j = 0; j < 4; ++j)
+        {
+            keyframe.value[j] = amplitudes[j] * std::sin(frequencies[j] * phase + float(j));
+            keyframe.inTangent[j] = keyframe.outTangent[j] = amplitudes[j] * frequencies[j] * std::cos(frequencies[j] * phase + float(j));
+        }
+
+        if (mode == InterpolationMode::Slerp)
+        {
+            const float3 axis = normalize(float3(std::sin(phase * 0.3f), 1.f, std::cos(phase * 0.7f)));
+            const float angle = keyframe.value.x;
+            keyframe.value = float4(axis * std::sin(angle * 0.5f), std::cos(angle * 0.5f));
+        }
+        else if (mode == InterpolationMode::Step)
+        {
+            for (int j = 0; j < 4; ++j)
+                keyframe.value[j] = std::round(keyframe.value[j]);
+        }
+        else if (mode == InterpolationMode::Linear)
+            keyframe.value.w = 0.f; // Translations and scales only have 3 components
+
+        sampler->AddKeyframe(keyframe);
+    }
+
+    return sampler;
+}
+
+float CompressionError(const std::optional<float4>& a, const std::optional<float4>& b, bool quaternion)
+{
+    if (a.has_value() != b.has_value())
+        return std::numeric_limits<float>::infinity();
+    if (!a.has_value())
+        return 0.f;
+    float error = maxComponent(abs(a.value() - b.value()));
+    if (quaternion)
+        error = std::min(error, maxComponent(abs(a.value() + b.value())));
+    return error;
+}
+
+void test_compression_accuracy()
+{
+    uint32_t seed = 100;
+
+    for (float maxError : { 1e-2f, 1e-3f, 1e-5f })
+    {
+        for (InterpolationMode mode : c_AllModes)
+        {
+            // Uniform motion data and random keyframes with uneven times
+            for (bool motion : { true, false })
+            {
+                auto sampler = motion ? MakeMotionSampler(mode, 600, seed) : MakeSampler(mode, 200, 0.5f, seed);
+                ++seed;
+                const Sampler original = *sampler;
+
+                CompressionSettings settings;
+                settings.maxError = maxError;
+                const CompressionReport report = sampler->Compress(settings);
+
+                CHECK(sampler->IsCompressed() && report.samplers == 1);
+                CHECK(report.maxError <= maxError);
+                CHECK(report.compressedBytes <= report.originalBytes);
+                CHECK(sampler->GetNumKeyframes() == report.compressedKeyframes);
+
+                // Dense playback with a cursor, and random times.
+                // Between the measured times the error can exceed the bound slightly, by the curvature of slerp.
+                const bool quaternion = mode == InterpolationMode::Slerp;
+                const float start = original.GetStartTime();
+                const float end = original.GetEndTime();
+                std::mt19937 rng(seed);
+                std::uniform_real_distribution<float> randomTime(start - 0.1f, end + 0.1f);
+                SamplerCursor cursor;
+                float error = 0.f;
+                for (float time = start - 0.1f; time < end + 0.1f; time += 0.0037f)
+                    error = std::max(error, CompressionError(original.Evaluate(time, true), sampler->Evaluate(time, true, cursor), quaternion));
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const float time = randomTime(rng);
+                    error = std::max(error, CompressionError(original.Evaluate(time, false), sampler->Evaluate(time, false), quaternion));
+                }
+
+                CHECK(error <= maxError * 1.1f);
+            }
+        }
+    }
+}
+
+void test_compression_representation()
+{
+    CompressionSettings settings;
+    settings.maxError = 1e-3f;
+
+    // Smooth uniform translations: quantized, and the constant stretches collapse
+    auto translation = MakeMotionSampler(InterpolationMode::Linear, 3000, 1);
+    CompressionReport report = translation->Compress(settings);
+    const CompressedKeyframes& translationKeys = translation->GetCompressedKeyframes();
+    CHECK(translationKeys.encoding == CompressedKeyframes::Encoding::Quantized);
+    CHECK(translationKeys.components == 3);
+    CHECK(report.compressedKeyframes * 5 < report.originalKeyframes * 4);
+    CHECK(report.compressedBytes * 6 < report.originalBytes);
+
+    // Rotations: smallest-three quaternions, 6 bytes per keyframe
+    auto rotation = MakeMotionSampler(InterpolationMode::Slerp, 3000, 2);
+    report = rotation->Compress(settings);
+    CHECK(rotation->GetCompressedKeyframes().encoding == CompressedKeyframes::Encoding::SmallestThree);
+    CHECK(report.compressedBytes * 8 < report.originalBytes);
+
+    // Without reduction, uniform keyframes only store their values
+    settings.reduceKeyframes = false;
+    auto uniform = MakeMotionSampler(InterpolationMode::Linear, 300, 3);
+    report = uniform->Compress(settings);
+    CHECK(report.uniformSamplers == 1 && uniform->GetCompressedKeyframes().IsUniform());
+    CHECK(report.compressedKeyframes == 300 && report.compressedBytes == 300 * 3 * sizeof(uint16_t));
+    CHECK(uniform->GetStartTime() == 0.f && std::abs(uniform->GetEndTime() - 299.f / 30.f) < 1e-5f);
+
+    // Without quantization, uneven times are stored and the values are exact
+    settings.quantize = false;
+    auto random = MakeSampler(InterpolationMode::CatmullRomSpline, 100, 0.5f, 4);
+    const Sampler original = *random;
+    report = random->Compress(settings);
+    CHECK(report.quantizedSamplers == 0 && report.uniformSamplers == 0 && report.maxError == 0.f);
+    for (float time = 0.f; time < original.GetEndTime() + 0.1f; time += 0.01f)
+        CHECK(SameResult(original.Evaluate(time), random->Evaluate(time), 0.f));
+
+    // Compressing again has no effect, accessing the keyframes decompresses
+    CHECK(random->Compress(settings).samplers == 0);
+    CHECK(random->GetKeyframes().size() == 100 && !random->IsCompressed());
+    for (size_t i = 0; i < 100; ++i)
+        CHECK(random->GetKeyframes()[i].time == const_cast<Sampler&>(original).GetKeyframes()[i].time);
+
+    // Empty samplers stay uncompressed
+    Sampler empty;
+    CHECK(empty.Compress().samplers == 0 && !empty.IsCompressed());
+}
+
+void test_compressed_batch()
+{
+    SamplerBatch batch;
+    std::vector<std::shared_ptr<Sampler>> samplers;
+    uint32_t seed = 200;
+    for (InterpolationMode mode : c_AllModes)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            auto sampler = (i & 1) ? MakeMotionSampler(mode, 90 + i, seed++) : MakeSampler(mode, 30 + i, 0.2f * float(i), seed++);
+            samplers.push_back(sampler);
+            batch.AddSampler(sampler);
+
+            // Compress half of the samplers after they are added to the batch
+            if (i & 2)
+                sampler->Compress();
+        }
+    }
+
+    for (float time = -0.1f; time < 4.f; time += 0.013f)
+    {
+        batch.Evaluate(time, true);
+        for (size_t i = 0; i < samplers.size(); ++i)
+        {
+            std::optional<float4> result;
+            if (batch.HasValue(i))
+                result = batch.GetValue(i);
+            CHECK(SameResult(samplers[i]->Evaluate(time, true), result, 1e-5f));
+        }
+    }
+}
+
+void test_scene_graph_animation()
+{
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    graph->SetRootNode(root);
+
+    auto translated = std::make_shared<SceneGraphNode>();
+    auto rotated = std::make_shared<SceneGraphNode>();
+    graph->Attach(root, translated);
+    graph->Attach(root, rotated);
+
+    auto translation = MakeSampler(InterpolationMode::Linear, 50, 0.f, 11);
+    auto rotation = MakeSampler(InterpolationMode::Slerp, 30, 0.2f, 12);
+
+    auto animation = std::make_shared<SceneGraphAnimation>();
+    animation->AddChannel(std::make_shared<SceneGraphAnimationChannel>(translation, translated, AnimationAttribute::Translation));
+    animation->AddChannel(std::make_shared<SceneGraphAnimationChannel>(rotation, rotated, AnimationAttribute::Rotation));
+
+    for (bool compressed : { false, true })
+    {
+        // The channels evaluate the compressed samplers in place
+        if (compressed)
+            CHECK(animation->Compress(CompressionSettings()).samplers == 2);
+
+        for (float time = 0.f; time < animation->GetDuration() + 0.5f; time += 0.05f)
+        {
+            animation->Apply(time);
+
+            const float4 expectedTranslation = translation->Evaluate(time, true).value();
+            CHECK(all(abs(float3(translated->GetTranslation()) - expectedTranslation.xyz()) <= float3(1e-5f)));
+
+            const dquat expectedRotation = normalize(dquat::fromXYZW(double4(rotation->Evaluate(time, true).value())));
+            const dquat rotationResult = rotated->GetRotation();
+            CHECK(std::abs(dot(rotationResult, expectedRotation)) > 1.0 - 1e-5);
+        }
+    }
+}
+
+void benchmark_animation()
+{
+    constexpr uint32_t numSamplers = 4096;
+    constexpr uint32_t numFrames = 600;
+    constexpr float frameTime = 1.f / 60.f;
+
+    SamplerBatch batch;
+    std::vector<std::shared_ptr<Sampler>> samplers;
+    for (uint32_t i = 0; i < numSamplers; ++i)
+    {
+        // Typical skeletal animation channels: translations, rotations and scales sampled at 30 Hz
+        InterpolationMode mode = (i % 3 == 1) ? InterpolationMode::Slerp : InterpolationMode::Linear;
+        auto sampler = std::make_shared<Sampler>();
+        sampler->SetInterpolationMode(mode);
+        for (uint32_t k = 0; k < 301; ++k)
+        {
+            Keyframe keyframe;
+            keyframe.time = float(k) / 30.f;
+            keyframe.value = normalize(float4(sinf(float(i + k)), cosf(float(i * 3 + k)), 0.5f, 1.f));
+            sampler->AddKeyframe(keyframe);
+        }
+        samplers.push_back(sampler);
+        batch.AddSampler(sampler);
+    }
+
+    const auto measure = [](auto&& evaluateFrame)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < numFrames; ++frame)
+            evaluateFrame(float(frame) * frameTime);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / double(numFrames);
+    };
+
+    float4 checksum = 0.f;
+    double search = measure([&](float time)
+    {
+        for (const auto& sampler : samplers)
+            checksum += sampler->Evaluate(time, true).value();
+    });
+
+    std::vector<SamplerCursor> cursors(numSamplers);
+    double cursor = measure([&](float time)
+    {
+        for (uint32_t i = 0; i < numSamplers; ++i)
+            checksum += samplers[i]->Evaluate(time, true, cursors[i]).value();
+    });
+
+    double batched = measure([&](float time)
+    {
+        batch.Evaluate(time, true);
+        checksum += batch.GetValue(0);
+    });
+
+    printf("Evaluating %u channels per frame: %.1f us with search, %.1f us with cursors, %.1f us batched (checksum %f)\n",
+        numSamplers, search, cursor, batched, checksum.x);
+}
+
+void benchmark_compression()
+{
+    // A motion capture clip: 60 joints with translation, rotation and scale, 2 minutes at 30 Hz
+    constexpr uint32_t numJoints = 60;
+    constexpr uint32_t numKeyframes = 3600;
+
+    for (float maxError : { 1e-2f, 1e-3f, 1e-4f })
+    {
+        SamplerBatch batch;
+        SamplerBatch originalBatch;
+        CompressionReport report;
+        CompressionSettings settings;
+        settings.maxError = maxError;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t joint = 0; joint < numJoints; ++joint)
+        {
+            for (InterpolationMode mode : { InterpolationMode::Linear, InterpolationMode::Slerp, InterpolationMode::Linear })
+            {
+                auto sampler = MakeMotionSampler(mode, numKeyframes, joint * 3 + uint32_t(mode));
+                originalBatch.AddSampler(std::make_shared<Sampler>(*sampler));
+                report += sampler->Compress(settings);
+                batch.AddSampler(sampler);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        float4 checksum = 0.f;
+        const auto measure = [&checksum](SamplerBatch& samplers)
+        {
+            auto evaluateStart = std::chrono::high_resolution_clock::now();
+            uint32_t frames = 0;
+            for (float time = 0.f; time < float(numKeyframes) / 30.f; time += 1.f / 60.f, ++frames)
+            {
+                samplers.Evaluate(time, true);
+                checksum += samplers.GetValue(0);
+            }
+            auto evaluateEnd = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::micro>(evaluateEnd - evaluateStart).count() / double(frames);
+        };
+        const double originalTime = measure(originalBatch);
+        const double compressedTime = measure(batch);
+
+        printf("Compression with max error %g: %llu to %llu keyframes, %.1f KB to %.1f KB (%.1fx), "
+            "%u quantized, %u uniform, measured max error %g, mean error %g, %.1f ms to compress, "
+            "%.2f us per frame, %.2f us uncompressed (checksum %f)\n",
+            maxError, (unsigned long long)report.originalKeyframes, (unsigned long long)report.compressedKeyframes,
+            double(report.originalBytes) / 1024.0, double(report.compressedBytes) / 1024.0,
+            double(report.originalBytes) / double(report.compressedBytes),
+            report.quantizedSamplers, report.uniformSamplers, report.maxError, report.GetMeanError(),
+            std::chrono::duration<double, std::milli>(end - start).count(),
+            compressedTime, originalTime, checksum.x);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_sampler_cursor();
+        test_sampler_batch();
+        test_scene_graph_animation();
+        test_compression_accuracy();
+        test_compression_representation();
+        test_compressed_batch();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+    {
+        benchmark_animation();
+        benchmark_compression();
+    }
+
+    return 0;
+}
@@ -0,0 +1,369 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/engine/LightClusters.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+static const affine3 c_WorldToView = translation(float3(-3.f, 1.f, 5.f)) * rotation(normalize(float3(0.3f, 1.f, 0.2f)), radians(40.f));
+
+static float4x4 MakeProjection(bool reverseDepth)
+{
+    const float aspect = 16.f / 9.f;
+    return reverseDepth
+        ? perspProjD3DStyleReverse(radians(60.f), aspect, 0.1f)
+        : perspProjD3DStyle(radians(60.f), aspect, 0.1f, 1000.f);
+}
+
+// Returns true if the light reaches the cluster, using the same tests as the grid with a relative tolerance:
+// a positive tolerance accepts clusters near the boundary, a negative one rejects them.
+static bool LightReachesCluster(const LightClusterGrid& grid, uint32_t clusterIndex, const ClusterLight& light, float tolerance)
+{
+    box3 bounds = grid.GetClusterBounds(clusterIndex);
+    float3 center = c_WorldToView.transformPoint(light.position);
+    float3 d = max(max(bounds.m_mins - center, center - bounds.m_maxs), float3(0.f));
+    float range = light.range * (1.f + tolerance);
+    if (dot(d, d) > range * range)
+        return false;
+
+    if (light.cosOuterAngle > -1.f)
+    {
+        float3 direction = normalize(c_WorldToView.transformVector(light.direction));
+        float sphereRadius = length(bounds.diagonal()) * 0.5f * (1.f + tolerance) + tolerance;
+        float3 v = bounds.center() - center;
+        float axial = dot(v, direction);
+        float radial = sqrtf(std::max(dot(v, v) - axial * axial, 0.f));
+        float closest = light.cosOuterAngle * radial - light.sinOuterAngle * axial;
+        if (closest > sphereRadius || axial < -sphereRadius)
+            return false;
+    }
+
+    return true;
+}
+
+static std::vector<ClusterLight> MakeRandomLights(uint32_t count, bool spotLights, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-60.f, 60.f);
+    std::uniform_real_distribution<float> range(0.5f, 8.f);
+    std::uniform_real_distribution<float> angle(radians(5.f), radians(80.f));
+    std::uniform_real_distribution<float> axis(-1.f, 1.f);
+
+    std::vector<ClusterLight> lights(count);
+    for (auto& light : lights)
+    {
+        light.position = float3(position(rng), position(rng) * 0.3f, position(rng) + 60.f);
+        light.range = range(rng);
+        if (spotLights)
+        {
+            light.direction = normalize(float3(axis(rng), axis(rng), axis(rng)) + float3(0.f, 0.f, 0.01f));
+            float outerAngle = angle(rng);
+            light.cosOuterAngle = cosf(outerAngle);
+            light.sinOuterAngle = sinf(outerAngle);
+        }
+    }
+    return lights;
+}
+
+void test_cluster_lookup()
+{
+    for (bool reverseDepth : { false, true })
+    {
+        const float4x4 projection = MakeProjection(reverseDepth);
+        LightClusterGrid grid;
+        grid.Setup(c_WorldToView, projection, LightClusterGrid::Desc());
+        const auto& desc = grid.GetDesc();
+
+        // Points inside the view must be inside the cluster that the shaders would pick for them
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> ndc(-0.999f, 0.999f);
+        std::uniform_real_distribution<float> depth(0.2f, desc.farZ * 0.999f);
+        for (int i = 0; i < 10000; i++)
+        {
+            float2 ndcXY = float2(ndc(rng), ndc(rng));
+            float viewDepth = depth(rng);
+            float4 clip = float4(0.f, 0.f, viewDepth, 1.f) * projection;
+            float4 p = float4(ndcXY * clip.w, clip.z, clip.w) * inverse(projection);
+            float3 viewPos = p.xyz() / p.w;
+
+            uint32_t tileX = uint32_t((ndcXY.x * 0.5f + 0.5f) * float(desc.tilesX));
+            uint32_t tileY = uint32_t((0.5f - ndcXY.y * 0.5f) * float(desc.tilesY));
+            uint32_t slice = grid.GetSliceIndex(viewDepth);
+            box3 bounds = grid.GetClusterBounds(grid.GetClusterIndex(tileX, tileY, slice));
+            CHECK(bounds.grow(1e-3f * viewDepth).contains(viewPos));
+        }
+
+        CHECK(grid.GetSliceIndex(0.f) == 0);
+        CHECK(grid.GetSliceIndex(desc.nearZ * 0.5f) == 0);
+        CHECK(grid.GetSliceIndex(desc.farZ * 2.f) == desc.slices - 1);
+    }
+}
+
+// Returns true if the light illuminates a view space point.
+static bool LightReachesPoint(const ClusterLight& light, const float3& viewPos)
+{
+    float3 v = viewPos - c_WorldToView.transformPoint(light.position);
+    if (length(v) >= light.range)
+        return false;
+
+    if (light.cosOuterAngle > -1.f)
+        return dot(normalize(v), normalize(c_WorldToView.transformVector(light.direction))) > light.cosOuterAngle;
+
+    return true;
+}
+
+static bool CheckBinning(const LightClusterGrid& grid, const float4x4& projection, const std::vector<ClusterLight>& lights)
+{
+    bool pass = true;
+    const auto& desc = grid.GetDesc();
+    const auto& ranges = grid.GetClusterRanges();
+    const auto& indices = grid.GetLightIndices();
+    pass &= ranges.size() == grid.GetNumClusters();
+
+    // The lists must be compact and sorted, and only contain lights that can reach the clusters
+    uint32_t expectedOffset = 0;
+    for (uint32_t clusterIndex = 0; clusterIndex < grid.GetNumClusters(); clusterIndex++)
+    {
+        const uint2 range = ranges[clusterIndex];
+        pass &= range.x == expectedOffset;
+        expectedOffset += range.y;
+
+        for (uint32_t i = 0; i < range.y; i++)
+        {
+            uint32_t lightIndex = indices[range.x + i];
+            pass &= i == 0 || indices[range.x + i - 1] < lightIndex;
+            pass &= LightReachesCluster(grid, clusterIndex, lights[lightIndex], 1e-3f);
+        }
+    }
+    pass &= expectedOffset == indices.size();
+
+    // Points near the lights must find all the lights that reach them in their clusters
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> offset(-1.f, 1.f);
+    const float4x4 viewToClip = projection;
+    for (const ClusterLight& light : lights)
+    {
+        for (int sample = 0; sample < 20; sample++)
+        {
+            float3 worldPos = light.position + float3(offset(rng), offset(rng), offset(rng)) * light.range;
+            float3 viewPos = c_WorldToView.transformPoint(worldPos);
+            float4 clip = float4(viewPos, 1.f) * viewToClip;
+            if (clip.w <= 0.f || viewPos.z >= desc.farZ)
+                continue;
+
+            float2 ndcXY = clip.xy() / clip.w;
+            if (any(abs(ndcXY) >= 1.f))
+                continue;
+
+            uint32_t tileX = uint32_t((ndcXY.x * 0.5f + 0.5f) * float(desc.tilesX));
+            uint32_t tileY = uint32_t((0.5f - ndcXY.y * 0.5f) * float(desc.tilesY));
+            uint2 range = ranges[grid.GetClusterIndex(tileX, tileY, grid.GetSliceIndex(viewPos.z))];
+
+            for (uint32_t lightIndex = 0; lightIndex < uint32_t(lights.size()); lightIndex++)
+            {
+                if (!LightReachesPoint(lights[lightIndex], viewPos))
+                    continue;
+
+                bool found = false;
+                for (uint32_t i = 0; i < range.y; i++)
+                    found = found || indices[range.x + i] == lightIndex;
+                pass &= found;
+            }
+        }
+    }
+
+    return pass;
+}
+
+void test_point_light_binning()
+{
+    for (bool reverseDepth : { false, true })
+    {
+        LightClusterGrid grid;
+        grid.Setup(c_WorldToView, MakeProjection(reverseDepth), LightClusterGrid::Desc());
+
+        auto lights = MakeRandomLights(300, false, 2);
+        grid.BinLights(lights.data(), uint32_t(lights.size()));
+        CHECK(!grid.GetLightIndices().empty());
+        CHECK(CheckBinning(grid, MakeProjection(reverseDepth), lights));
+    }
+}
+
+void test_spot_light_binning()
+{
+    LightClusterGrid grid;
+    grid.Setup(c_WorldToView, MakeProjection(true), LightClusterGrid::Desc());
+
+    auto lights = MakeRandomLights(300, true, 3);
+    grid.BinLights(lights.data(), uint32_t(lights.size()));
+
+    // Cones should reach fewer clusters than their spheres
+    auto spheres = lights;
+    for (auto& light : spheres)
+        light.cosOuterAngle = -1.f;
+    LightClusterGrid sphereGrid;
+    sphereGrid.Setup(c_WorldToView, MakeProjection(true), LightClusterGrid::Desc());
+    sphereGrid.BinLights(spheres.data(), uint32_t(spheres.size()));
+
+    CHECK(CheckBinning(grid, MakeProjection(true), lights));
+    CHECK(grid.GetLightIndices().size() < sphereGrid.GetLightIndices().size());
+}
+
+void test_culled_lights()
+{
+    LightClusterGrid grid;
+    grid.Setup(affine3::identity(), MakeProjection(false), LightClusterGrid::Desc());
+
+    ClusterLight lights[2];
+    lights[0].position = float3(0.f, 0.f, -10.f); // behind the camera
+    lights[0].range = 5.f;
+    lights[1].position = float3(500.f, 0.f, 10.f); // outside of the view
+    lights[1].range = 5.f;
+    grid.BinLights(lights, 2);
+
+    CHECK(grid.GetLightIndices().empty());
+
+    // A light around the camera reaches the clusters close to it
+    ClusterLight around;
+    around.range = 1.f;
+    grid.BinLights(&around, 1);
+    CHECK(grid.GetClusterRanges()[grid.GetClusterIndex(0, 0, 0)].y == 1);
+    CHECK(grid.GetClusterRanges()[grid.GetClusterIndex(0, 0, grid.GetDesc().slices - 1)].y == 0);
+}
+
+void test_far_lights()
+{
+    LightClusterGrid grid;
+    grid.Setup(affine3::identity(), MakeProjection(false), LightClusterGrid::Desc());
+    const auto& desc = grid.GetDesc();
+    const uint32_t farSlice = desc.slices - 1;
+
+    ClusterLight lights[2];
+    lights[0].position = float3(0.f, 0.f, desc.farZ * 4.f); // beyond farZ, in the middle of the screen
+    lights[0].range = 5.f;
+    lights[1].position = float3(0.f, 0.f, desc.farZ); // crossing farZ
+    lights[1].range = 5.f;
+    grid.BinLights(lights, 2);
+
+    const auto& ranges = grid.GetClusterRanges();
+    const auto& indices = grid.GetLightIndices();
+
+    // Surfaces beyond farZ use the last slice, so both lights must be in its clusters in the middle of the screen
+    const uint2 center = ranges[grid.GetClusterIndex(desc.tilesX / 2, desc.tilesY / 2, grid.GetSliceIndex(desc.farZ * 4.f))];
+    CHECK(grid.GetSliceIndex(desc.farZ * 4.f) == farSlice);
+    CHECK(center.y == 2 && indices[center.x] == 0 && indices[center.x + 1] == 1);
+
+    // The far light only projects to a few tiles, and only reaches the last slice
+    uint32_t farLightClusters = 0;
+    for (uint32_t clusterIndex = 0; clusterIndex < grid.GetNumClusters(); clusterIndex++)
+    {
+        for (uint32_t i = 0; i < ranges[clusterIndex].y; i++)
+        {
+            if (indices[ranges[clusterIndex].x + i] == 0)
+            {
+                ++farLightClusters;
+                CHECK(clusterIndex >= grid.GetClusterIndex(0, 0, farSlice));
+            }
+        }
+    }
+    CHECK(farLightClusters > 0 && farLightClusters <= 4);
+}
+
+void test_cluster_light_from_light()
+{
+    ClusterLight result;
+
+    PointLight pointLight;
+    CHECK(!ClusterLight::FromLight(pointLight, result)); // infinite range
+    pointLight.range = 10.f;
+    CHECK(ClusterLight::FromLight(pointLight, result) && result.range == 10.f && result.cosOuterAngle == -1.f);
+
+    SpotLight spotLight;
+    spotLight.range = 5.f;
+    spotLight.outerAngle = 30.f;
+    CHECK(ClusterLight::FromLight(spotLight, result) && fabsf(result.cosOuterAngle - cosf(radians(30.f))) < 1e-6f);
+    spotLight.outerAngle = 120.f;
+    CHECK(ClusterLight::FromLight(spotLight, result) && result.cosOuterAngle == -1.f);
+
+    DirectionalLight directionalLight;
+    CHECK(!ClusterLight::FromLight(directionalLight, result));
+}
+
+void benchmark_light_clusters()
+{
+    LightClusterGrid grid;
+    grid.Setup(c_WorldToView, MakeProjection(true), LightClusterGrid::Desc());
+    const auto& desc = grid.GetDesc();
+    printf("Light clusters %ux%ux%u:\n", desc.tilesX, desc.tilesY, desc.slices);
+
+    for (uint32_t numLights : { 1000u, 2000u, 5000u, 10000u })
+    {
+        for (bool spotLights : { false, true })
+        {
+            auto lights = MakeRandomLights(numLights, spotLights, 4);
+
+            const int iterations = 20;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+                grid.BinLights(lights.data(), numLights);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            printf("  %5u %s lights: %.3f ms, %zu indices\n", numLights, spotLights ? "spot" : "point",
+                std::chrono::duration<double, std::milli>(end - start).count() / iterations, grid.GetLightIndices().size());
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_cluster_lookup();
+        test_point_light_binning();
+        test_spot_light_binning();
+        test_culled_lights();
+        test_far_lights();
+        test_cluster_light_from_light();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_light_clusters();
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshSimplifier.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <chrono>
+#include <cstring>
+#include <map>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// Builds a closed UV sphere, with the poles as single vertices so that the mesh has no seams or borders
+void MakeClosedSphere(uint32_t rings, uint32_t segments, float radius, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    const uint32_t firstVertex = uint32_t(positions.size());
+    positions.push_back(float3(0.f, radius, 0.f));
+    for (uint32_t ring = 1; ring < rings; ++ring)
+    {
+        const float theta = PI_f * float(ring) / float(rings);
+        for (uint32_t segment = 0; segment < segments; ++segment)
+        {
+            const float phi = 2.f * PI_f * float(segment) / float(segments);
+            positions.push_back(float3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)) * radius);
+        }
+    }
+    positions.push_back(float3(0.f, -radius, 0.f));
+
+    const uint32_t bottom = uint32_t(positions.size()) - 1 - firstVertex;
+    const auto ringVertex = [segments](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+
+    for (uint32_t segment = 0; segment < segments; ++segment)
+    {
+        indices.insert(indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+        indices.insert(indices.end(), { bottom, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+    }
+    for (uint32_t ring = 1; ring + 1 < rings; ++ring)
+    {
+        for (uint32_t segment = 0; segment < segments; ++segment)
+        {
+            const uint32_t a = ringVertex(ring, segment);
+            const uint32_t b = ringVertex(ring, segment + 1);
+            const uint32_t c = ringVertex(ring + 1, segment);
+            const uint32_t d = ringVertex(ring + 1, segment + 1);
+            indices.insert(indices.end(), { a, b, c });
+            indices.insert(indices.end(), { b, d, c });
+        }
+    }
+}
+
+bool IsWatertight(const std::vector<uint32_t>& indices)
+{
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t index = 0; index < indices.size(); ++index)
+        ++edges[{ indices[index], indices[index - index % 3 + (index + 1) % 3] }];
+
+    for (const auto& [edge, count] : edges)
+    {
+        auto reverse = edges.find({ edge.second, edge.first });
+        if (count != 1 || reverse == edges.end() || reverse->second != 1)
+            return false;
+    }
+    return true;
+}
+
+void test_simplify_sphere()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeClosedSphere(32, 64, 1.f, positions, indices);
+    const size_t numTriangles = indices.size() / 3;
+
+    CHECK(IsWatertight(indices));
+
+    std::vector<uint32_t> simplified(indices.size());
+    float error = 0.f;
+    const size_t target = (numTriangles / 4) * 3;
+    simplified.resize(SimplifyMesh(simplified.data(), indices.data(), indices.size(), positions.data(), positions.size(),
+        target, 1.f, &error));
+
+    // Reaches the target within one pass worth of collapses, stays closed and doesn't flip triangles
+    CHECK(simplified.size() <= target);
+    CHECK(simplified.size() >= target / 2);
+    CHECK(error > 0.f);
+    CHECK(error <= 0.1f);
+    CHECK(IsWatertight(simplified));
+
+    for (size_t triangle = 0; triangle < simplified.size() / 3; ++triangle)
+    {
+        const float3 p0 = positions[simplified[triangle * 3 + 0]];
+        const float3 p1 = positions[simplified[triangle * 3 + 1]];
+        const float3 p2 = positions[simplified[triangle * 3 + 2]];
+        CHECK(dot(cross(p1 - p0, p2 - p0), p0 + p1 + p2) > 0.f);
+    }
+
+    // A zero error limit keeps the curved mesh as it is
+    std::vector<uint32_t> unchanged(indices.size());
+    unchanged.resize(SimplifyMesh(unchanged.data(), indices.data(), indices.size(), positions.data(), positions.size(),
+        target, 0.f, &error));
+    CHECK(unchanged == indices && error == 0.f);
+}
+
+void test_simplify_plane_keeps_borders()
+{
+    const uint32_t size = 16;
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y <= size; ++y)
+        for (uint32_t x = 0; x <= size; ++x)
+            positions.push_back(float3(float(x), float(y), 0.f));
+
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const uint32_t a = y * (size + 1) + x;
+            indices.insert(indices.end(), { a, a + 1, a + size + 1 });
+            indices.insert(indices.end(), { a + 1, a + size + 2, a + size + 1 });
+        }
+    }
+
+    // Interior collapses of a flat mesh have no error, so the mesh goes down to its border
+    std::vector<uint32_t> simplified(indices.size());
+    float error = 1.f;
+    simplified.resize(SimplifyMesh(simplified.data(), indices.data(), indices.size(), positions.data(), positions.size(),
+        0, 1e-4f, &error));
+
+    CHECK(!simplified.empty());
+    CHECK(simplified.size() < indices.size() / 4);
+    CHECK(error <= 1e-4f);
+
+    std::vector<bool> used(positions.size(), false);
+    float area = 0.f;
+    for (size_t triangle = 0; triangle < simplified.size() / 3; ++triangle)
+    {
+        const float3 p0 = positions[simplified[triangle * 3 + 0]];
+        const float3 p1 = positions[simplified[triangle * 3 + 1]];
+        const float3 p2 = positions[simplified[triangle * 3 + 2]];
+        const float3 normal = cross(p1 - p0, p2 - p0);
+        CHECK(normal.z > 0.f);
+        area += normal.z * 0.5f;
+        for (int corner = 0; corner < 3; ++corner)
+            used[simplified[triangle * 3 + corner]] = true;
+    }
+
+    for (uint32_t y = 0; y <= size; ++y)
+    {
+        for (uint32_t x = 0; x <= size; ++x)
+        {
+            const bool border = x == 0 || y == 0 || x == size || y == size;
+            CHECK(!border || used[y * (size + 1) + x]);
+        }
+    }
+
+    CHECK(fabsf(area - float(size * size)) < 1e-3f);
+}
+
+// Creates one buffer group with several sphere meshes of different radii
+std::vector<std::shared_ptr<MeshInfo>> MakeSphereMeshes(uint32_t count)
+{
+    auto buffers = std::make_shared<BufferGroup>();
+    auto material = std::make_shared<Material>();
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+
+    for (uint32_t meshIndex = 0; meshIndex < count; ++meshIndex)
+    {
+        auto mesh = std::make_shared<MeshInfo>();
+        mesh->buffers = buffers;
+        mesh->indexOffset = uint32_t(buffers->indexData.size());
+        mesh->vertexOffset = uint32_t(buffers->positionData.size());
+
+        auto geometry = std::make_shared<MeshGeometry>();
+        geometry->material = material;
+        std::vector<uint32_t> indices;
+        const float radius = 1.f + float(meshIndex);
+        MakeClosedSphere(24 + 8 * meshIndex, 48, radius, buffers->positionData, indices);
+        geometry->numIndices = uint32_t(indices.size());
+        geometry->numVertices = uint32_t(buffers->positionData.size()) - mesh->vertexOffset;
+        geometry->objectSpaceBounds = box3(float3(-radius), float3(radius));
+        buffers->indexData.insert(buffers->indexData.end(), indices.begin(), indices.end());
+
+        mesh->geometries.push_back(geometry);
+        mesh->objectSpaceBounds = geometry->objectSpaceBounds;
+        mesh->totalIndices = geometry->numIndices;
+        mesh->totalVertices = geometry->numVertices;
+        meshes.push_back(mesh);
+    }
+
+    return meshes;
+}
+
+void test_generate_mesh_lods()
+{
+    auto meshes = MakeSphereMeshes(3);
+    meshes.push_back(meshes[0]); // duplicates are processed once
+
+    MeshLodParams params;
+    params.numLods = 4;
+    params.maxError = 0.05f;
+
+    ThreadPool threadPool(2);
+    const MeshLodStatistics stats = GenerateMeshLods(meshes, params, &threadPool);
+    CHECK(stats.meshes == 3);
+    CHECK(stats.lods != 0);
+    CHECK(stats.lodTriangles != 0);
+
+    const BufferGroup& buffers = *meshes[0]->buffers;
+    uint32_t lods = 0;
+    for (size_t meshIndex = 0; meshIndex < 3; ++meshIndex)
+    {
+        const MeshInfo& mesh = *meshes[meshIndex];
+        CHECK(!mesh.lods.empty());
+        CHECK(mesh.lods.size() <= params.numLods - 1);
+
+        uint32_t previousTriangles = mesh.geometries[0]->numIndices / 3;
+        float previousError = 0.f;
+        for (const MeshLod& lod : mesh.lods)
+        {
+            CHECK(lod.geometries.size() == mesh.geometries.size());
+            CHECK(lod.numTriangles < previousTriangles);
+            CHECK(lod.error >= previousError);
+            CHECK(lod.error <= params.maxError * length(mesh.objectSpaceBounds.diagonal()));
+
+            const MeshGeometry& geometry = *lod.geometries[0];
+            CHECK(geometry.numIndices == lod.numTriangles * 3);
+            CHECK(geometry.material == mesh.geometries[0]->material);
+            CHECK(geometry.vertexOffsetInMesh == mesh.geometries[0]->vertexOffsetInMesh);
+            CHECK(geometry.numVertices == mesh.geometries[0]->numVertices);
+
+            const size_t firstIndex = mesh.indexOffset + geometry.indexOffsetInMesh;
+            CHECK(firstIndex + geometry.numIndices <= buffers.indexData.size());
+            for (uint32_t index = 0; index < geometry.numIndices; ++index)
+            {
+                CHECK(buffers.indexData[firstIndex + index] < geometry.numVertices);
+            }
+
+            previousTriangles = lod.numTriangles;
+            previousError = lod.error;
+            ++lods;
+        }
+    }
+
+    // A second call doesn't add more levels
+    const MeshLodStatistics again = GenerateMeshLods(meshes, params);
+    CHECK(lods == stats.lods && again.lods == 0);
+}
+
+void test_select_mesh_lod()
+{
+    MeshInfo mesh;
+    for (float error : { 0.01f, 0.04f, 0.16f })
+    {
+        MeshLod lod;
+        lod.error = error;
+        mesh.lods.push_back(lod);
+    }
+
+    const float maxError = 1.f;
+    const float hysteresis = 0.25f;
+
+    // Without history, the coarsest level whose error is below the coarsening threshold
+    CHECK(SelectMeshLod(mesh, 1000.f, maxError, hysteresis, 0) == 0);
+    CHECK(SelectMeshLod(mesh, 50.f, maxError, hysteresis, 0) == 1);    // 0.5 px, 2 px
+    CHECK(SelectMeshLod(mesh, 4.f, maxError, hysteresis, 0) == 3);     // 0.64 px
+    CHECK(SelectMeshLod(mesh, 4.f, maxError, hysteresis, 10) == 3);
+
+    // Level 2 has 0.9 px of error at 22.5 px/unit: it's kept once selected, but not selected from level 1
+    CHECK(SelectMeshLod(mesh, 22.5f, maxError, hysteresis, 2) == 2);
+    CHECK(SelectMeshLod(mesh, 22.5f, maxError, hysteresis, 1) == 1);
+
+    // Refines as soon as the error is too large
+    CHECK(SelectMeshLod(mesh, 26.f, maxError, hysteresis, 2) == 1);
+
+    // Meshes without levels always use the full detail geometries
+    MeshInfo empty;
+    CHECK(SelectMeshLod(empty, 1.f, maxError, hysteresis, 2) == 0);
+}
+
+struct ViewLodStatistics
+{
+    uint64_t baseTriangles = 0;
+    uint64_t drawnTriangles = 0;
+    uint32_t instancesPerLod[4] = {};
+};
+
+// A row of sphere instances seen from a perspective camera at several distances
+ViewLodStatistics EvaluateTestScene(const std::vector<std::shared_ptr<MeshInfo>>& meshes, float cameraDistance)
+{
+    const float viewportHeight = 1080.f;
+    const float pixelsPerUnitAtOne = 0.5f * viewportHeight / tanf(radians(30.f));
+
+    ViewLodStatistics stats;
+    for (uint32_t instance = 0; instance < 64; ++instance)
+    {
+        const MeshInfo& mesh = *meshes[instance % meshes.size()];
+        const float distance = cameraDistance + float(instance) * 4.f;
+        const uint32_t lod = SelectMeshLod(mesh, pixelsPerUnitAtOne / distance, 1.f, 0.25f, 0);
+
+        stats.baseTriangles += mesh.geometries[0]->numIndices / 3;
+        stats.drawnTriangles += lod == 0 ? mesh.geometries[0]->numIndices / 3 : mesh.lods[lod - 1].numTriangles;
+        ++stats.instancesPerLod[std::min(lod, 3u)];
+    }
+    return stats;
+}
+
+void test_lod_test_scene()
+{
+    auto meshes = MakeSphereMeshes(3);
+    MeshLodParams params;
+    GenerateMeshLods(meshes, params);
+
+    uint64_t previousTriangles = ~0ull;
+    for (float cameraDistance : { 1.f, 50.f, 400.f })
+    {
+        const ViewLodStatistics stats = EvaluateTestScene(meshes, cameraDistance);
+        CHECK(stats.drawnTriangles <= stats.baseTriangles);
+        CHECK(stats.drawnTriangles < previousTriangles);
+        previousTriangles = stats.drawnTriangles;
+    }
+}
+
+void benchmark_mesh_lods()
+{
+    printf("Mesh LOD benchmark:\n");
+
+    auto meshes = MakeSphereMeshes(8);
+    uint64_t totalTriangles = 0;
+    for (const auto& mesh : meshes)
+        totalTriangles += mesh->geometries[0]->numIndices / 3;
+
+    MeshLodParams params;
+    auto start = std::chrono::high_resolution_clock::now();
+    const MeshLodStatistics stats = GenerateMeshLods(meshes, params);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    printf("  %u meshes, %llu triangles: %u levels with %llu triangles in %.1f ms\n", stats.meshes,
+        (unsigned long long)totalTriangles, stats.lods, (unsigned long long)stats.lodTriangles,
+        std::chrono::duration<double, std::milli>(end - start).count());
+
+    for (float cameraDistance : { 1.f, 10.f, 50.f, 200.f, 1000.f })
+    {
+        const ViewLodStatistics view = EvaluateTestScene(meshes, cameraDistance);
+        printf("  view at %6.0f: %8llu of %8llu triangles (%5.1f%%), instances per LOD %u/%u/%u/%u\n", cameraDistance,
+            (unsigned long long)view.drawnTriangles, (unsigned long long)view.baseTriangles,
+            100.0 * double(view.drawnTriangles) / double(view.baseTriangles),
+            view.instancesPerLod[0], view.instancesPerLod[1], view.instancesPerLod[2], view.instancesPerLod[3]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_simplify_sphere();
+        test_simplify_plane_keeps_borders();
+        test_generate_mesh_lods();
+        test_select_mesh_lod();
+        test_lod_test_scene();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_mesh_lods();
+
+    return 0;
+}
@@ -0,0 +1,409 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshOptimizer.h>
+#include <donut/engine/MeshletBuilder.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// Builds a grid of quads, optionally with separate vertices for every triangle corner like a non-indexed export
+void MakeGrid(uint32_t size, bool splitVertices, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    std::vector<uint32_t> gridIndices;
+    std::vector<float3> gridPositions;
+    for (uint32_t y = 0; y <= size; ++y)
+        for (uint32_t x = 0; x <= size; ++x)
+            gridPositions.push_back(float3(float(x), float(y), float((x * 7 + y * 3) % 5) * 0.1f));
+
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const uint32_t a = y * (size + 1) + x;
+            const uint32_t b = a + size + 1;
+            gridIndices.insert(gridIndices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+
+    if (splitVertices)
+    {
+        for (uint32_t index : gridIndices)
+        {
+            indices.push_back(uint32_t(positions.size()));
+            positions.push_back(gridPositions[index]);
+        }
+    }
+    else
+    {
+        positions = gridPositions;
+        indices = gridIndices;
+    }
+}
+
+// Shuffles the triangles, so that the index buffer has no locality
+void ShuffleTriangles(std::vector<uint32_t>& indices, uint32_t seed)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t index = 0; index + 2 < indices.size(); index += 3)
+        triangles.push_back({ indices[index], indices[index + 1], indices[index + 2] });
+
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(seed));
+
+    indices.clear();
+    for (const auto& triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+}
+
+// Triangles with their vertices rotated so that the smallest index comes first, sorted
+std::vector<std::array<uint32_t, 3>> CanonicalTriangles(const uint32_t* indices, size_t numIndices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t index = 0; index + 2 < numIndices; index += 3)
+    {
+        std::array<uint32_t, 3> triangle = { indices[index], indices[index + 1], indices[index + 2] };
+        while (triangle[0] > triangle[1] || triangle[0] > triangle[2])
+            triangle = { triangle[1], triangle[2], triangle[0] };
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+void test_vertex_cache_statistics()
+{
+    // A single triangle loads every vertex once
+    const uint32_t triangle[] = { 0, 1, 2 };
+    VertexCacheStatistics stats = AnalyzeVertexCache(triangle, 3, 3);
+    CHECK(stats.triangles == 1 && stats.vertices == 3 && stats.transforms == 3);
+    CHECK(stats.GetACMR() == 3.f && stats.GetATVR() == 1.f);
+
+    // Reusing the cached vertices costs nothing, but vertex 0 is evicted after 4 other vertices are loaded
+    const uint32_t repeated[] = { 0, 1, 2, 2, 1, 0, 0, 1, 3, 4, 5, 6, 0, 6, 5 };
+    stats = AnalyzeVertexCache(repeated, 15, 7, 4);
+    CHECK(stats.triangles == 5 && stats.vertices == 7 && stats.transforms == 8);
+}
+
+void test_vertex_cache_optimization()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeGrid(64, false, positions, indices);
+    ShuffleTriangles(indices, 3);
+
+    const VertexCacheStatistics before = AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+
+    std::vector<uint32_t> optimized(indices.size());
+    OptimizeVertexCache(optimized.data(), indices.data(), indices.size(), positions.size());
+    const VertexCacheStatistics after = AnalyzeVertexCache(optimized.data(), optimized.size(), positions.size());
+
+    CHECK(CanonicalTriangles(indices.data(), indices.size()) == CanonicalTriangles(optimized.data(), optimized.size()));
+    CHECK(before.GetACMR() > 2.f);
+    CHECK(after.GetACMR() < 0.8f);
+    CHECK(after.GetATVR() < 1.4f);
+
+    // In-place optimization gives the same result
+    std::vector<uint32_t> inPlace = indices;
+    OptimizeVertexCache(inPlace.data(), inPlace.data(), inPlace.size(), positions.size());
+    CHECK(inPlace == optimized);
+
+    // Vertex fetch order follows the first use, and the triangles still reference the same positions
+    std::vector<uint32_t> vertexOrder;
+    std::vector<uint32_t> fetchIndices = optimized;
+    const uint32_t numVertices = OptimizeVertexFetch(fetchIndices.data(), fetchIndices.size(), positions.size(), vertexOrder);
+    CHECK(numVertices == positions.size() && vertexOrder.size() == positions.size());
+    uint32_t maxIndex = 0;
+    for (size_t index = 0; index < fetchIndices.size(); ++index)
+    {
+        CHECK(fetchIndices[index] <= maxIndex + 1 || fetchIndices[index] < maxIndex);
+        maxIndex = std::max(maxIndex, fetchIndices[index]);
+        CHECK(vertexOrder[fetchIndices[index]] == optimized[index]);
+    }
+}
+
+// Returns the attributes of all triangle corners of a mesh, with the triangles in canonical order
+struct CornerData
+{
+    float3 position;
+    uint32_t normal;
+    float2 texcoord;
+    dm::vector<uint16_t, 4> joints;
+    float4 weights;
+    std::vector<float4> morphTargets;
+
+    bool operator==(const CornerData& other) const
+    {
+        return all(position == other.position) && normal == other.normal && all(texcoord == other.texcoord) &&
+            all(joints == other.joints) && all(weights == other.weights) && morphTargets.size() == other.morphTargets.size() &&
+            std::equal(morphTargets.begin(), morphTargets.end(), other.morphTargets.begin(), [](const float4& a, const float4& b) { return all(a == b); });
+    }
+};
+
+std::vector<std::vector<CornerData>> GetGeometryTriangles(const MeshInfo& mesh, const MeshGeometry& geometry, bool fromMeshlets)
+{
+    const BufferGroup& buffers = *mesh.buffers;
+    const size_t numFrames = buffers.morphTargetBufferRange.size();
+
+    std::vector<uint32_t> indices;
+    if (fromMeshlets)
+    {
+        for (uint32_t index = 0; index < geometry.numMeshlets; ++index)
+        {
+            const Meshlet& meshlet = buffers.meshletData[geometry.meshletOffset + index];
+            for (uint32_t corner = 0; corner < meshlet.primitiveCount * 3; ++corner)
+                indices.push_back(buffers.meshletVertexData[meshlet.vertexOffset + buffers.meshletPrimitiveData[meshlet.primitiveOffset * 3 + corner]]);
+        }
+    }
+    else
+    {
+        const uint32_t* first = buffers.indexData.data() + mesh.indexOffset + geometry.indexOffsetInMesh;
+        indices.assign(first, first + geometry.numIndices);
+    }
+
+    auto getCorner = [&](uint32_t index)
+    {
+        const size_t vertex = size_t(mesh.vertexOffset) + geometry.vertexOffsetInMesh + index;
+        CornerData corner;
+        corner.position = buffers.positionData[vertex];
+        corner.normal = buffers.normalData[vertex];
+        corner.texcoord = buffers.texcoord1Data[vertex];
+        corner.joints = buffers.jointData[vertex];
+        corner.weights = buffers.weightData[vertex];
+        for (size_t frame = 0; frame < numFrames; ++frame)
+            corner.morphTargets.push_back(buffers.morphTargetData[buffers.morphTargetBufferRange[frame].byteOffset / sizeof(float4) + vertex]);
+        return corner;
+    };
+
+    // Order the corners by position so that the triangles can be compared regardless of the vertex numbering
+    auto less = [](const CornerData& a, const CornerData& b)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+            if (a.position[axis] != b.position[axis])
+                return a.position[axis] < b.position[axis];
+        return a.normal < b.normal;
+    };
+
+    std::vector<std::vector<CornerData>> triangles;
+    for (size_t index = 0; index + 2 < indices.size(); index += 3)
+    {
+        std::vector<CornerData> triangle = { getCorner(indices[index]), getCorner(indices[index + 1]), getCorner(indices[index + 2]) };
+        while (less(triangle[1], triangle[0]) || less(triangle[2], triangle[0]))
+            std::rotate(triangle.begin(), triangle.begin() + 1, triangle.end());
+        triangles.push_back(std::move(triangle));
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [&less](const auto& a, const auto& b)
+    {
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            if (less(a[corner], b[corner]))
+                return true;
+            if (less(b[corner], a[corner]))
+                return false;
+        }
+        return false;
+    });
+    return triangles;
+}
+
+// Builds two meshes in one buffer group, with all the vertex streams that the importer fills, two morph target frames,
+// and a geometry that is not referenced by the first mesh in vertex order
+std::vector<std::shared_ptr<MeshInfo>> BuildTestMeshes(bool splitVertices)
+{
+    auto buffers = std::make_shared<BufferGroup>();
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+
+    std::vector<std::pair<uint32_t, uint32_t>> geometrySizes = { { 16, 2 }, { 8, 3 }, { 12, 1 } };
+    std::vector<uint32_t> meshGeometryCounts = { 1, 2 };
+
+    size_t geometryIndex = 0;
+    for (uint32_t geometryCount : meshGeometryCounts)
+    {
+        auto mesh = std::make_shared<MeshInfo>();
+        mesh->buffers = buffers;
+        mesh->indexOffset = uint32_t(buffers->indexData.size());
+        mesh->vertexOffset = uint32_t(buffers->positionData.size());
+
+        for (uint32_t index = 0; index < geometryCount; ++index, ++geometryIndex)
+        {
+            std::vector<float3> positions;
+            std::vector<uint32_t> indices;
+            MakeGrid(geometrySizes[geometryIndex].first, splitVertices, positions, indices);
+            ShuffleTriangles(indices, geometrySizes[geometryIndex].second);
+
+            auto geometry = std::make_shared<MeshGeometry>();
+            geometry->indexOffsetInMesh = mesh->totalIndices;
+            geometry->vertexOffsetInMesh = mesh->totalVertices;
+            geometry->numIndices = uint32_t(indices.size());
+            geometry->numVertices = uint32_t(positions.size());
+
+            for (const float3& position : positions)
+            {
+                const uint32_t cell = uint32_t(position.x) / 2 + uint32_t(position.y) / 2 * 64;
+                buffers->positionData.push_back(position + float3(0.f, 0.f, float(geometryIndex)));
+                buffers->normalData.push_back(cell);
+                buffers->tangentData.push_back(cell * 3);
+                buffers->texcoord1Data.push_back(float2(position.x, position.y) * 0.1f);
+                buffers->jointData.push_back(dm::vector<uint16_t, 4>(uint16_t(cell & 3), 1, 0, 0));
+                buffers->weightData.push_back(float4(0.75f, 0.25f, 0.f, 0.f));
+            }
+            buffers->indexData.insert(buffers->indexData.end(), indices.begin(), indices.end());
+
+            mesh->totalIndices += geometry->numIndices;
+            mesh->totalVertices += geometry->numVertices;
+            mesh->geometries.push_back(geometry);
+        }
+
+        meshes.push_back(mesh);
+    }
+
+    // Two morph target frames over the whole buffer group
+    const size_t numVertices = buffers->positionData.size();
+    for (size_t frame = 0; frame < 2; ++frame)
+    {
+        nvrhi::BufferRange range;
+        range.byteOffset = frame * numVertices * sizeof(float4);
+        range.byteSize = numVertices * sizeof(float4);
+        buffers->morphTargetBufferRange.push_back(range);
+        for (size_t vertex = 0; vertex < numVertices; ++vertex)
+            buffers->morphTargetData.push_back(float4(buffers->positionData[vertex] * float(frame + 1), 0.f));
+    }
+
+    return meshes;
+}
+
+void test_optimize_meshes(bool splitVertices, bool deduplicate)
+{
+    auto meshes = BuildTestMeshes(splitVertices);
+    BuildMeshlets(meshes, MeshletBuildParams());
+
+    std::vector<std::vector<std::vector<CornerData>>> trianglesBefore;
+    for (const auto& mesh : meshes)
+        for (const auto& geometry : mesh->geometries)
+            trianglesBefore.push_back(GetGeometryTriangles(*mesh, *geometry, false));
+
+    const BufferGroup& buffers = *meshes[0]->buffers;
+    const size_t verticesBefore = buffers.positionData.size();
+    const size_t indicesBefore = buffers.indexData.size();
+
+    MeshOptimizationParams params;
+    params.deduplicateVertices = deduplicate;
+    const MeshOptimizationResult result = OptimizeMeshes(meshes, params);
+
+    CHECK(result.after.GetACMR() < result.before.GetACMR());
+    CHECK(buffers.indexData.size() == indicesBefore);
+
+    // All streams are compacted together, and the meshes and geometries cover the new streams exactly
+    const size_t verticesAfter = buffers.positionData.size();
+    CHECK(buffers.normalData.size() == verticesAfter && buffers.tangentData.size() == verticesAfter &&
+        buffers.texcoord1Data.size() == verticesAfter && buffers.jointData.size() == verticesAfter &&
+        buffers.weightData.size() == verticesAfter && buffers.morphTargetData.size() == verticesAfter * 2);
+    CHECK(buffers.morphTargetBufferRange[1].byteOffset == verticesAfter * sizeof(float4));
+    CHECK((deduplicate && splitVertices) ? (verticesAfter * 4 < verticesBefore) : (verticesAfter == verticesBefore));
+    CHECK(result.after.vertices == verticesAfter);
+
+    uint32_t nextVertex = 0;
+    size_t geometryIndex = 0;
+    for (const auto& mesh : meshes)
+    {
+        CHECK(mesh->vertexOffset == nextVertex);
+        for (const auto& geometry : mesh->geometries)
+        {
+            CHECK(mesh->vertexOffset + geometry->vertexOffsetInMesh == nextVertex);
+            nextVertex += geometry->numVertices;
+
+            // The rendering-relevant data of every triangle is preserved, through the index buffer and the meshlets
+            CHECK(GetGeometryTriangles(*mesh, *geometry, false) == trianglesBefore[geometryIndex]);
+            CHECK(GetGeometryTriangles(*mesh, *geometry, true) == trianglesBefore[geometryIndex]);
+            ++geometryIndex;
+        }
+        CHECK(mesh->totalVertices == nextVertex - mesh->vertexOffset);
+    }
+    CHECK(nextVertex == verticesAfter);
+}
+
+void test_optimize_meshes_invalid_layout()
+{
+    auto meshes = BuildTestMeshes(false);
+    BufferGroup& buffers = *meshes[0]->buffers;
+    buffers.normalData.pop_back();
+
+    const auto indices = buffers.indexData;
+    const auto positions = buffers.positionData.size();
+    const MeshOptimizationResult result = OptimizeMeshes(meshes, MeshOptimizationParams());
+
+    // Buffer groups whose streams don't match are left untouched
+    CHECK(result.before.triangles == 0 && buffers.indexData == indices && buffers.positionData.size() == positions);
+}
+
+void benchmark_mesh_optimizer()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeGrid(724, false, positions, indices);
+    ShuffleTriangles(indices, 1);
+
+    const VertexCacheStatistics before = AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    OptimizeVertexCache(indices.data(), indices.data(), indices.size(), positions.size());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    const VertexCacheStatistics after = AnalyzeVertexCache(indices.data(), indices.size(), positions.size());
+    printf("Vertex cache optimization of %zu triangles: %.1f ms, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", indices.size() / 3,
+        std::chrono::duration<double, std::milli>(end - start).count(), before.GetACMR(), after.GetACMR(), before.GetATVR(), after.GetATVR());
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Error);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_vertex_cache_statistics();
+        test_vertex_cache_optimization();
+        test_optimize_meshes(false, false);
+        test_optimize_meshes(true, true);
+        test_optimize_meshes_invalid_layout();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_mesh_optimizer();
+
+    return 0;
+}
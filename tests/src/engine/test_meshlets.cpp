@@ -0,0 +1,497 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/MeshletBuilder.h>
+#include <donut/engine/MeshSetImporter.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/core/chunk/chunk.h>
+#include <donut/core/vfs/VFS.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+typedef std::array<uint32_t, 3> Triangle;
+
+// Builds a UV sphere with outward facing, counter-clockwise triangles
+void MakeSphere(uint32_t rings, uint32_t segments, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    for (uint32_t ring = 0; ring <= rings; ++ring)
+    {
+        const float theta = PI_f * float(ring) / float(rings);
+        for (uint32_t segment = 0; segment <= segments; ++segment)
+        {
+            const float phi = 2.f * PI_f * float(segment) / float(segments);
+            positions.push_back(float3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+        }
+    }
+
+    for (uint32_t ring = 0; ring < rings; ++ring)
+    {
+        for (uint32_t segment = 0; segment < segments; ++segment)
+        {
+            const uint32_t a = ring * (segments + 1) + segment;
+            const uint32_t b = a + segments + 1;
+            if (ring > 0)
+                indices.insert(indices.end(), { a, a + 1, b });
+            if (ring + 1 < rings)
+                indices.insert(indices.end(), { a + 1, b + 1, b });
+        }
+    }
+}
+
+// Returns the triangles with their vertices rotated so that the smallest index comes first, sorted
+std::vector<Triangle> CanonicalTriangles(const std::vector<Triangle>& triangles)
+{
+    std::vector<Triangle> result;
+    for (Triangle triangle : triangles)
+    {
+        while (triangle[0] > triangle[1] || triangle[0] > triangle[2])
+            triangle = { triangle[1], triangle[2], triangle[0] };
+        result.push_back(triangle);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<Triangle> IndexTriangles(const uint32_t* indices, size_t numIndices)
+{
+    std::vector<Triangle> triangles;
+    for (size_t index = 0; index + 2 < numIndices; index += 3)
+        triangles.push_back({ indices[index], indices[index + 1], indices[index + 2] });
+    return triangles;
+}
+
+std::vector<Triangle> MeshletTriangles(const Meshlet* meshlets, size_t numMeshlets,
+    const uint32_t* meshletVertices, const uint8_t* meshletPrimitives)
+{
+    std::vector<Triangle> triangles;
+    for (size_t index = 0; index < numMeshlets; ++index)
+    {
+        const Meshlet& meshlet = meshlets[index];
+        const uint32_t* vertices = meshletVertices + meshlet.vertexOffset;
+        const uint8_t* primitives = meshletPrimitives + size_t(meshlet.primitiveOffset) * 3;
+        for (uint32_t primitive = 0; primitive < meshlet.primitiveCount; ++primitive)
+            triangles.push_back({ vertices[primitives[primitive * 3]], vertices[primitives[primitive * 3 + 1]], vertices[primitives[primitive * 3 + 2]] });
+    }
+    return triangles;
+}
+
+bool ValidateMeshlets(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, const MeshletBuildParams& params,
+    const std::vector<Meshlet>& meshlets, const std::vector<uint32_t>& meshletVertices, const std::vector<uint8_t>& meshletPrimitives)
+{
+    bool pass = true;
+    for (const Meshlet& meshlet : meshlets)
+    {
+        pass &= meshlet.vertexCount > 0 && meshlet.vertexCount <= params.maxVertices;
+        pass &= meshlet.primitiveCount > 0 && meshlet.primitiveCount <= params.maxPrimitives;
+        pass &= meshlet.vertexOffset + meshlet.vertexCount <= meshletVertices.size();
+        pass &= (meshlet.primitiveOffset + meshlet.primitiveCount) * 3 <= meshletPrimitives.size();
+        if (!pass)
+            return false;
+
+        for (uint32_t index = 0; index < meshlet.primitiveCount * 3; ++index)
+            pass &= meshletPrimitives[meshlet.primitiveOffset * 3 + index] < meshlet.vertexCount;
+
+        for (uint32_t index = 0; index < meshlet.vertexCount; ++index)
+        {
+            const float3 position = positions[meshletVertices[meshlet.vertexOffset + index]];
+            pass &= length(position - meshlet.center) <= meshlet.radius * 1.0001f + 1e-6f;
+        }
+    }
+
+    // Every triangle of the mesh is in exactly one meshlet
+    pass &= CanonicalTriangles(IndexTriangles(indices.data(), indices.size()))
+        == CanonicalTriangles(MeshletTriangles(meshlets.data(), meshlets.size(), meshletVertices.data(), meshletPrimitives.data()));
+
+    return pass;
+}
+
+void test_meshlet_limits()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeSphere(48, 96, positions, indices);
+
+    for (MeshletBuildParams params : { MeshletBuildParams(), MeshletBuildParams{ 32, 32 }, MeshletBuildParams{ 256, 512 }, MeshletBuildParams{ 3, 1 } })
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint8_t> meshletPrimitives;
+        const uint32_t count = BuildMeshlets(indices.data(), indices.size(), positions.data(), positions.size(), params,
+            meshlets, meshletVertices, meshletPrimitives);
+
+        CHECK(count == meshlets.size() && count > 0);
+        CHECK(ValidateMeshlets(positions, indices, params, meshlets, meshletVertices, meshletPrimitives));
+
+        // The meshlets should share most of their vertices between triangles on a regular mesh
+        if (params.maxVertices == 64)
+            CHECK(meshletVertices.size() < indices.size() * 2 / 3);
+    }
+}
+
+void test_meshlet_cone_culling()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeSphere(32, 64, positions, indices);
+
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint8_t> meshletPrimitives;
+    BuildMeshlets(indices.data(), indices.size(), positions.data(), positions.size(), MeshletBuildParams(),
+        meshlets, meshletVertices, meshletPrimitives);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordinate(-4.f, 4.f);
+
+    size_t culled = 0;
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        const float3 eye = float3(coordinate(rng), coordinate(rng), coordinate(rng));
+        if (length(eye) < 1.5f)
+            continue;
+
+        for (const Meshlet& meshlet : meshlets)
+        {
+            const float3 toCenter = meshlet.center - eye;
+            if (dot(toCenter, meshlet.coneAxis) < meshlet.coneCutoff * length(toCenter) + meshlet.radius)
+                continue;
+
+            ++culled;
+
+            // A culled meshlet must not have any triangle facing the eye
+            const uint32_t* vertices = meshletVertices.data() + meshlet.vertexOffset;
+            const uint8_t* primitives = meshletPrimitives.data() + size_t(meshlet.primitiveOffset) * 3;
+            for (uint32_t primitive = 0; primitive < meshlet.primitiveCount; ++primitive)
+            {
+                const float3 a = positions[vertices[primitives[primitive * 3]]];
+                const float3 b = positions[vertices[primitives[primitive * 3 + 1]]];
+                const float3 c = positions[vertices[primitives[primitive * 3 + 2]]];
+                CHECK(dot(cross(b - a, c - a), a - eye) >= -1e-5f);
+            }
+        }
+    }
+
+    // Roughly half of a convex mesh faces away from any viewer, and a good share of that should be culled
+    CHECK(culled > meshlets.size() * 10);
+}
+
+// Builds a model with two meshes that share a buffer group, one of them with two geometries,
+// and three instances of them in a small hierarchy.
+SceneImportResult BuildTestModel()
+{
+    auto buffers = std::make_shared<BufferGroup>();
+
+    auto material = std::make_shared<Material>();
+    material->name = "Grey";
+
+    auto addGeometry = [&buffers, &material](MeshInfo& mesh, uint32_t rings, uint32_t segments, float3 offset)
+    {
+        std::vector<float3> positions;
+        std::vector<uint32_t> indices;
+        MakeSphere(rings, segments, positions, indices);
+
+        auto geometry = std::make_shared<MeshGeometry>();
+        geometry->material = material;
+        geometry->indexOffsetInMesh = mesh.totalIndices;
+        geometry->vertexOffsetInMesh = mesh.totalVertices;
+        geometry->numIndices = uint32_t(indices.size());
+        geometry->numVertices = uint32_t(positions.size());
+        geometry->objectSpaceBounds = box3::empty();
+        for (float3& position : positions)
+        {
+            position += offset;
+            geometry->objectSpaceBounds |= position;
+        }
+
+        buffers->positionData.insert(buffers->positionData.end(), positions.begin(), positions.end());
+        buffers->indexData.insert(buffers->indexData.end(), indices.begin(), indices.end());
+        for (size_t index = 0; index < positions.size(); ++index)
+        {
+            buffers->normalData.push_back(uint32_t(index));
+            buffers->texcoord1Data.push_back(float2(float(index), 1.f));
+        }
+
+        mesh.totalIndices += geometry->numIndices;
+        mesh.totalVertices += geometry->numVertices;
+        mesh.objectSpaceBounds |= geometry->objectSpaceBounds;
+        mesh.geometries.push_back(geometry);
+    };
+
+    auto sphere = std::make_shared<MeshInfo>();
+    sphere->name = "Sphere";
+    sphere->buffers = buffers;
+    addGeometry(*sphere, 12, 24, float3(0.f));
+
+    auto pair = std::make_shared<MeshInfo>();
+    pair->name = "Pair";
+    pair->buffers = buffers;
+    pair->indexOffset = uint32_t(buffers->indexData.size());
+    pair->vertexOffset = uint32_t(buffers->positionData.size());
+    addGeometry(*pair, 16, 16, float3(-2.f, 0.f, 0.f));
+    addGeometry(*pair, 6, 8, float3(2.f, 0.f, 0.f));
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    root->SetName("model");
+
+    auto group = std::make_shared<SceneGraphNode>();
+    group->SetName("Group");
+    group->SetTranslation(double3(0.0, 5.0, 0.0));
+    group->SetScaling(double3(2.0));
+    graph->Attach(root, group);
+
+    auto first = std::make_shared<SceneGraphNode>();
+    first->SetName("First");
+    first->SetRotation(rotationQuat(double3(0.3, 0.2, 0.1)));
+    first->SetLeaf(std::make_shared<MeshInstance>(sphere));
+    graph->Attach(group, first);
+
+    auto second = std::make_shared<SceneGraphNode>();
+    second->SetName("Second");
+    second->SetTranslation(double3(1.0, 2.0, 3.0));
+    second->SetLeaf(std::make_shared<MeshInstance>(pair));
+    graph->Attach(group, second);
+
+    auto third = std::make_shared<SceneGraphNode>();
+    third->SetName("Third");
+    third->SetTranslation(double3(-4.0, 0.0, 0.0));
+    third->SetLeaf(std::make_shared<MeshInstance>(sphere));
+    graph->Attach(root, third);
+
+    SceneImportResult result;
+    result.rootNode = root;
+    return result;
+}
+
+daffine3 GetWorldTransform(const SceneGraphNode* node)
+{
+    daffine3 transform = daffine3::identity();
+    for (; node; node = node->GetParent())
+    {
+        daffine3 local = scaling(node->GetScaling());
+        local *= node->GetRotation().toAffine();
+        local *= translation(node->GetTranslation());
+        transform *= local;
+    }
+    return transform;
+}
+
+// Returns the world space triangles of all mesh instances in the model, sorted
+std::vector<std::array<float3, 3>> GetWorldTriangles(const SceneImportResult& model)
+{
+    std::vector<std::array<float3, 3>> triangles;
+    for (SceneGraphWalker walker(model.rootNode.get()); walker; walker.Next(true))
+    {
+        auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(walker->GetLeaf());
+        if (!meshInstance)
+            continue;
+
+        const affine3 transform = affine3(GetWorldTransform(walker.Get()));
+        const MeshInfo& mesh = *meshInstance->GetMesh();
+        for (const auto& geometry : mesh.geometries)
+        {
+            const uint32_t* indices = mesh.buffers->indexData.data() + mesh.indexOffset + geometry->indexOffsetInMesh;
+            const float3* positions = mesh.buffers->positionData.data() + mesh.vertexOffset + geometry->vertexOffsetInMesh;
+            for (const Triangle& triangle : CanonicalTriangles(IndexTriangles(indices, geometry->numIndices)))
+            {
+                triangles.push_back({
+                    transform.transformPoint(positions[triangle[0]]),
+                    transform.transformPoint(positions[triangle[1]]),
+                    transform.transformPoint(positions[triangle[2]]) });
+            }
+        }
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [](const auto& a, const auto& b)
+    {
+        for (int vertex = 0; vertex < 3; ++vertex)
+            for (int axis = 0; axis < 3; ++axis)
+                if (a[vertex][axis] != b[vertex][axis])
+                    return a[vertex][axis] < b[vertex][axis];
+        return false;
+    });
+    return triangles;
+}
+
+bool CompareWorldTriangles(const SceneImportResult& a, const SceneImportResult& b)
+{
+    const auto trianglesA = GetWorldTriangles(a);
+    const auto trianglesB = GetWorldTriangles(b);
+    if (trianglesA.size() != trianglesB.size() || trianglesA.empty())
+        return false;
+
+    // The sort order can differ when the transforms round differently, so compare the sums as well as the counts
+    float3 sumA = 0.f;
+    float3 sumB = 0.f;
+    for (size_t index = 0; index < trianglesA.size(); ++index)
+    {
+        sumA += trianglesA[index][0] + trianglesA[index][1] + trianglesA[index][2];
+        sumB += trianglesB[index][0] + trianglesB[index][1] + trianglesB[index][2];
+    }
+    return length(sumA - sumB) <= 1e-3f * float(trianglesA.size());
+}
+
+void test_mesh_meshlets()
+{
+    SceneImportResult model = BuildTestModel();
+    const auto& sphere = std::dynamic_pointer_cast<MeshInstance>(model.rootNode->GetChild(0)->GetChild(0)->GetLeaf())->GetMesh();
+    const auto& pair = std::dynamic_pointer_cast<MeshInstance>(model.rootNode->GetChild(0)->GetChild(1)->GetLeaf())->GetMesh();
+
+    MeshletBuildParams params;
+    params.maxVertices = 32;
+    params.maxPrimitives = 48;
+    BuildMeshlets({ sphere, pair, sphere }, params);
+
+    const BufferGroup& buffers = *sphere->buffers;
+    for (const auto& mesh : { sphere, pair })
+    {
+        for (const auto& geometry : mesh->geometries)
+        {
+            CHECK(geometry->numMeshlets > 0);
+            CHECK(geometry->meshletOffset + geometry->numMeshlets <= buffers.meshletData.size());
+
+            const uint32_t* indices = buffers.indexData.data() + mesh->indexOffset + geometry->indexOffsetInMesh;
+            CHECK(CanonicalTriangles(IndexTriangles(indices, geometry->numIndices))
+                == CanonicalTriangles(MeshletTriangles(buffers.meshletData.data() + geometry->meshletOffset, geometry->numMeshlets,
+                    buffers.meshletVertexData.data(), buffers.meshletPrimitiveData.data())));
+        }
+    }
+
+    // Building again doesn't add meshlets to the geometries that already have them
+    const size_t meshletCount = buffers.meshletData.size();
+    BuildMeshlets({ sphere, pair }, params);
+    CHECK(buffers.meshletData.size() == meshletCount);
+}
+
+void test_mesh_set_round_trip(bool withMeshlets)
+{
+    SceneImportResult model = BuildTestModel();
+    if (withMeshlets)
+    {
+        const auto& sphere = std::dynamic_pointer_cast<MeshInstance>(model.rootNode->GetChild(0)->GetChild(0)->GetLeaf())->GetMesh();
+        const auto& pair = std::dynamic_pointer_cast<MeshInstance>(model.rootNode->GetChild(0)->GetChild(1)->GetLeaf())->GetMesh();
+        BuildMeshlets({ sphere, pair }, MeshletBuildParams());
+    }
+
+    auto blob = MeshSetImporter::Serialize(model);
+    CHECK(blob);
+
+    auto meshSet = chunk::deserialize(blob, "model.meshset");
+    CHECK(meshSet);
+
+    CHECK(meshSet->type == (withMeshlets ? chunk::MeshSetBase::MESHLET : chunk::MeshSetBase::MESH));
+    CHECK(meshSet->nmeshInfos == 3);
+    CHECK(meshSet->ninstances == 4);
+    CHECK(meshSet->nnodes == 5);
+    CHECK(meshSet->streams.normal && meshSet->streams.texcoord0 && !meshSet->streams.tangent && !meshSet->streams.texcoord1);
+    if (withMeshlets)
+    {
+        const auto& meshletSet = static_cast<const chunk::MeshletSet&>(*meshSet);
+        CHECK(meshletSet.maxVerts <= MeshletBuildParams().maxVertices && meshletSet.maxPrims <= MeshletBuildParams().maxPrimitives);
+    }
+
+    MeshSetImporter importer(nullptr, std::make_shared<SceneTypeFactory>());
+    SceneImportResult loaded;
+    CHECK(importer.LoadMeshSet(*meshSet, loaded));
+    CHECK(loaded.rootNode);
+
+    CHECK(loaded.rootNode->GetName() == "model");
+    CHECK(loaded.rootNode->GetNumChildren() == 2);
+    CHECK(loaded.rootNode->GetChild(0)->GetName() == "Group");
+    CHECK(CompareWorldTriangles(model, loaded));
+
+    // The sphere instances share a mesh, and the pair instance has two geometries on two nodes
+    int numInstances = 0;
+    for (SceneGraphWalker walker(loaded.rootNode.get()); walker; walker.Next(true))
+    {
+        if (auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(walker->GetLeaf()))
+        {
+            ++numInstances;
+            for (const auto& geometry : meshInstance->GetMesh()->geometries)
+            {
+                CHECK(geometry->material && geometry->material->name == "Grey");
+                CHECK((geometry->numMeshlets > 0) == withMeshlets);
+            }
+        }
+    }
+    CHECK(numInstances == 4);
+}
+
+void benchmark_meshlets()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeSphere(512, 1024, positions, indices);
+
+    printf("Meshlets for %zu triangles:\n", indices.size() / 3);
+    for (MeshletBuildParams params : { MeshletBuildParams(), MeshletBuildParams{ 128, 256 } })
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint8_t> meshletPrimitives;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        BuildMeshlets(indices.data(), indices.size(), positions.data(), positions.size(), params,
+            meshlets, meshletVertices, meshletPrimitives);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        printf("  %u/%u: %.1f ms, %zu meshlets, %.1f vertices and %.1f triangles per meshlet\n", params.maxVertices, params.maxPrimitives,
+            std::chrono::duration<double, std::milli>(end - start).count(), meshlets.size(),
+            double(meshletVertices.size()) / double(meshlets.size()), double(meshletPrimitives.size() / 3) / double(meshlets.size()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_meshlet_limits();
+        test_meshlet_cone_culling();
+        test_mesh_meshlets();
+        test_mesh_set_round_trip(false);
+        test_mesh_set_round_trip(true);
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_meshlets();
+
+    return 0;
+}
@@ -0,0 +1,387 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/engine/OcclusionBuffer.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// A camera at the origin looking along +Z.
+float4x4 MakeViewProjection(bool reverseDepth)
+{
+    const float aspect = 2.f;
+    return reverseDepth
+        ? perspProjD3DStyleReverse(radians(60.f), aspect, 0.1f)
+        : perspProjD3DStyle(radians(60.f), aspect, 0.1f, 1000.f);
+}
+
+// An axis aligned quad facing the camera at depth z.
+struct Quad
+{
+    float3 positions[4];
+    uint32_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    Quad(float x0, float y0, float x1, float y1, float z)
+    {
+        positions[0] = float3(x0, y0, z);
+        positions[1] = float3(x1, y0, z);
+        positions[2] = float3(x1, y1, z);
+        positions[3] = float3(x0, y1, z);
+    }
+};
+
+void test_wall_occlusion()
+{
+    for (bool reverseDepth : { false, true })
+    {
+        for (bool flipWinding : { false, true })
+        {
+            Quad wall(-10.f, -10.f, 10.f, 10.f, 20.f);
+            if (flipWinding)
+                std::swap(wall.indices[1], wall.indices[2]), std::swap(wall.indices[4], wall.indices[5]);
+
+            OcclusionBuffer buffer;
+            buffer.BeginFrame(MakeViewProjection(reverseDepth), reverseDepth);
+            buffer.AddOccluder(wall.positions, wall.indices, 6, affine3::identity());
+            buffer.Rasterize();
+
+            CHECK(buffer.GetStats().triangles == 2);
+
+            // Behind the wall
+            CHECK(!buffer.IsVisible(box3(float3(-1.f, -1.f, 30.f), float3(1.f, 1.f, 32.f))));
+            CHECK(!buffer.IsVisible(box3(float3(-5.f, -5.f, 25.f), float3(5.f, 5.f, 100.f))));
+            // The wall itself
+            CHECK(buffer.IsVisible(box3(float3(-10.f, -10.f, 20.f), float3(10.f, 10.f, 20.f))));
+            // In front of the wall
+            CHECK(buffer.IsVisible(box3(float3(-1.f, -1.f, 10.f), float3(1.f, 1.f, 12.f))));
+            // Behind the wall but sticking out on the side
+            CHECK(buffer.IsVisible(box3(float3(5.f, -1.f, 30.f), float3(25.f, 1.f, 32.f))));
+            // Crossing the near plane
+            CHECK(buffer.IsVisible(box3(float3(-1.f, -1.f, -1.f), float3(1.f, 1.f, 32.f))));
+            // Partially intersecting the wall
+            CHECK(buffer.IsVisible(box3(float3(-1.f, -1.f, 15.f), float3(1.f, 1.f, 25.f))));
+        }
+    }
+
+    // A wall that crosses the near plane and the sides of the screen is clipped, and still occludes
+    {
+        float3 positions[4] = { float3(-100.f, -100.f, -5.f), float3(100.f, -100.f, -5.f), float3(100.f, 100.f, 30.f), float3(-100.f, 100.f, 30.f) };
+        uint32_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+        OcclusionBuffer buffer;
+        buffer.BeginFrame(MakeViewProjection(false), false);
+        buffer.AddOccluder(positions, indices, 6, affine3::identity());
+        buffer.Rasterize();
+
+        CHECK(!buffer.IsVisible(box3(float3(-1.f, -1.f, 60.f), float3(1.f, 1.f, 62.f))));
+        CHECK(buffer.IsVisible(box3(float3(-1.f, -1.f, 2.f), float3(1.f, 1.f, 3.f))));
+    }
+
+    // An empty buffer doesn't occlude anything
+    {
+        OcclusionBuffer buffer;
+        buffer.BeginFrame(MakeViewProjection(false), false);
+        buffer.Rasterize();
+        CHECK(buffer.IsVisible(box3(float3(-1.f, -1.f, 900.f), float3(1.f, 1.f, 901.f))));
+    }
+}
+
+// Random triangles in front of the camera, as a list of positions with trivial indices.
+void MakeRandomOccluders(uint32_t numTriangles, uint32_t seed, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> centerXY(-40.f, 40.f);
+    std::uniform_real_distribution<float> centerZ(5.f, 100.f);
+    std::uniform_real_distribution<float> offset(-4.f, 4.f);
+
+    positions.clear();
+    indices.clear();
+    for (uint32_t triangle = 0; triangle < numTriangles; triangle++)
+    {
+        float3 center = float3(centerXY(rng), centerXY(rng), centerZ(rng));
+        for (int vertex = 0; vertex < 3; vertex++)
+        {
+            indices.push_back(uint32_t(positions.size()));
+            positions.push_back(center + float3(offset(rng), offset(rng), offset(rng)));
+        }
+    }
+}
+
+void test_threaded_rasterization()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeRandomOccluders(20000, 1, positions, indices);
+
+    ThreadPool threadPool(4);
+    OcclusionBuffer serialBuffer;
+    OcclusionBuffer parallelBuffer;
+
+    const float4x4 viewProjection = MakeViewProjection(false);
+    const affine3 transform = translation(float3(1.f, 0.f, 0.f));
+    const uint32_t trianglesPerOccluder = 100;
+
+    for (OcclusionBuffer* buffer : { &serialBuffer, &parallelBuffer })
+    {
+        buffer->BeginFrame(viewProjection, false);
+        for (uint32_t first = 0; first < uint32_t(indices.size()); first += trianglesPerOccluder * 3)
+            buffer->AddOccluder(positions.data(), indices.data() + first, trianglesPerOccluder * 3, transform);
+    }
+
+    serialBuffer.Rasterize(nullptr);
+    parallelBuffer.Rasterize(&threadPool);
+
+    CHECK(serialBuffer.GetStats().triangles == parallelBuffer.GetStats().triangles);
+    CHECK(serialBuffer.GetStats().binnedTriangles == parallelBuffer.GetStats().binnedTriangles);
+    for (uint32_t level = 0; level < serialBuffer.GetNumLevels(); level++)
+    {
+        const auto& a = serialBuffer.GetDepthLevel(level);
+        const auto& b = parallelBuffer.GetDepthLevel(level);
+        CHECK(a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0);
+    }
+
+    std::vector<uint8_t> image;
+    parallelBuffer.GetDebugImage(image);
+    CHECK(image.size() == size_t(parallelBuffer.GetWidth()) * parallelBuffer.GetHeight());
+}
+
+// Returns true if any full resolution pixel touched by the box's screen rectangle is farther than the box.
+bool IsVisibleReference(const OcclusionBuffer& buffer, const float4x4& viewProjection, const box3& box)
+{
+    float2 screenMin = float2(std::numeric_limits<float>::max());
+    float2 screenMax = float2(-std::numeric_limits<float>::max());
+    float maxDepth = 0.f;
+    for (int corner = 0; corner < 8; corner++)
+    {
+        float4 clip = float4(box.getCorner(corner), 1.f) * viewProjection;
+        if (clip.z < 0.f)
+            return true;
+        float2 screen = float2((clip.x / clip.w * 0.5f + 0.5f) * float(buffer.GetWidth()), (0.5f - clip.y / clip.w * 0.5f) * float(buffer.GetHeight()));
+        screenMin = min(screenMin, screen);
+        screenMax = max(screenMax, screen);
+        maxDepth = std::max(maxDepth, 1.f - clip.z / clip.w);
+    }
+
+    int x0 = std::max(int(std::floor(screenMin.x)), 0);
+    int y0 = std::max(int(std::floor(screenMin.y)), 0);
+    int x1 = std::min(int(std::ceil(screenMax.x)), int(buffer.GetWidth())) - 1;
+    int y1 = std::min(int(std::ceil(screenMax.y)), int(buffer.GetHeight())) - 1;
+    if (x1 < x0 || y1 < y0)
+        return true;
+
+    const auto& depth = buffer.GetDepthLevel(0);
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            if (depth[y * buffer.GetWidth() + x] <= maxDepth * 1.0001f)
+                return true;
+        }
+    }
+    return false;
+}
+
+void test_hierarchical_test()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeRandomOccluders(5000, 2, positions, indices);
+
+    const float4x4 viewProjection = MakeViewProjection(false);
+    OcclusionBuffer buffer;
+    buffer.BeginFrame(viewProjection, false);
+    buffer.AddOccluder(positions.data(), indices.data(), uint32_t(indices.size()), affine3::identity());
+    buffer.Rasterize();
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> centerXY(-50.f, 50.f);
+    std::uniform_real_distribution<float> centerZ(10.f, 200.f);
+    std::uniform_real_distribution<float> size(0.1f, 5.f);
+
+    // The pyramid test must never cull a box that the full resolution test finds visible
+    uint32_t occluded = 0;
+    for (int i = 0; i < 10000; i++)
+    {
+        float3 center = float3(centerXY(rng), centerXY(rng), centerZ(rng));
+        float3 extent = float3(size(rng), size(rng), size(rng));
+        box3 box(center - extent, center + extent);
+
+        bool visible = buffer.IsVisible(box);
+        if (!visible)
+        {
+            ++occluded;
+            CHECK(!IsVisibleReference(buffer, viewProjection, box));
+        }
+    }
+
+    // Make sure that the test is not trivial
+    CHECK(occluded > 100);
+}
+
+void test_occluder_selection()
+{
+    auto opaqueMaterial = std::make_shared<Material>();
+    auto transparentMaterial = std::make_shared<Material>();
+    transparentMaterial->domain = MaterialDomain::AlphaBlended;
+
+    auto makeMesh = [](const std::shared_ptr<Material>& material, float size, uint32_t numTriangles)
+    {
+        auto mesh = std::make_shared<MeshInfo>();
+        auto geometry = std::make_shared<MeshGeometry>();
+        geometry->material = material;
+        geometry->numIndices = numTriangles * 3;
+        mesh->objectSpaceBounds = box3(float3(-size), float3(size));
+        geometry->objectSpaceBounds = mesh->objectSpaceBounds;
+        mesh->geometries.push_back(geometry);
+        return mesh;
+    };
+
+    auto wall = makeMesh(opaqueMaterial, 50.f, 2);
+    auto glass = makeMesh(transparentMaterial, 50.f, 2);
+    auto detailedWall = makeMesh(opaqueMaterial, 50.f, 100000);
+    auto pebble = makeMesh(opaqueMaterial, 0.5f, 12);
+    // Small in object space, but one of its instances is scaled up to the size of the scene.
+    auto crate = makeMesh(opaqueMaterial, 1.f, 12);
+    auto manual = makeMesh(opaqueMaterial, 0.5f, 12);
+    manual->isOccluder = true;
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    graph->SetRootNode(root);
+
+    auto addInstance = [&](const std::shared_ptr<MeshInfo>& mesh, const double3& translation, double scale)
+    {
+        auto node = std::make_shared<SceneGraphNode>();
+        node->SetTranslation(translation);
+        node->SetScaling(double3(scale));
+        node->SetLeaf(std::make_shared<MeshInstance>(mesh));
+        graph->Attach(root, node);
+    };
+
+    addInstance(wall, double3(0.0), 1.0);
+    addInstance(glass, double3(100.0, 0.0, 0.0), 1.0);
+    addInstance(detailedWall, double3(-100.0, 0.0, 0.0), 1.0);
+    addInstance(pebble, double3(0.0, 0.0, 60.0), 1.0);
+    addInstance(crate, double3(0.0, 0.0, -60.0), 1.0);
+    addInstance(crate, double3(0.0, 0.0, 60.0), 40.0);
+    addInstance(manual, double3(0.0, 0.0, -60.0), 1.0);
+    graph->Refresh(0);
+
+    OccluderSelectionParams params;
+    params.minRelativeSize = 0.1f;
+    params.maxTriangles = 1000;
+
+    CHECK(SelectOccluders(*graph, params) == 2);
+    CHECK(wall->isOccluder);
+    CHECK(crate->isOccluder);
+    CHECK(!glass->isOccluder);
+    CHECK(!detailedWall->isOccluder);
+    CHECK(!pebble->isOccluder);
+    CHECK(manual->isOccluder);
+
+    // Selecting again finds no new occluders.
+    CHECK(SelectOccluders(*graph, params) == 0);
+}
+
+void benchmark_occlusion_buffer()
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    MakeRandomOccluders(100000, 4, positions, indices);
+
+    const float4x4 viewProjection = MakeViewProjection(false);
+    const uint32_t trianglesPerOccluder = 500;
+    constexpr int iterations = 10;
+
+    auto measure = [&](OcclusionBuffer& buffer, ThreadPool* threadPool)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int it = 0; it < iterations; it++)
+        {
+            buffer.BeginFrame(viewProjection, false);
+            for (uint32_t first = 0; first < uint32_t(indices.size()); first += trianglesPerOccluder * 3)
+                buffer.AddOccluder(positions.data(), indices.data() + first, trianglesPerOccluder * 3, affine3::identity());
+            buffer.Rasterize(threadPool);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    };
+
+    OcclusionBuffer buffer;
+    printf("Occlusion buffer %ux%u, %zu occluder triangles:\n", buffer.GetWidth(), buffer.GetHeight(), indices.size() / 3);
+    printf("  rasterize, serial: %.3f ms\n", measure(buffer, nullptr));
+    for (uint32_t numThreads : { 1u, 2u, 4u, 8u })
+    {
+        ThreadPool threadPool(numThreads);
+        printf("  rasterize, %u worker(s): %.3f ms\n", numThreads, measure(buffer, &threadPool));
+    }
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> centerXY(-50.f, 50.f);
+    std::uniform_real_distribution<float> centerZ(10.f, 200.f);
+    std::vector<box3> boxes;
+    for (int i = 0; i < 100000; i++)
+    {
+        float3 center = float3(centerXY(rng), centerXY(rng), centerZ(rng));
+        boxes.push_back(box3(center - float3(1.f), center + float3(1.f)));
+    }
+
+    uint32_t visible = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const box3& box : boxes)
+        visible += buffer.IsVisible(box) ? 1 : 0;
+    auto end = std::chrono::high_resolution_clock::now();
+    printf("  %zu box tests: %.3f ms, %u visible\n", boxes.size(), std::chrono::duration<double, std::milli>(end - start).count(), visible);
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_wall_occlusion();
+        test_threaded_rasterization();
+        test_hierarchical_test();
+        test_occluder_selection();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_occlusion_buffer();
+
+    return 0;
+}
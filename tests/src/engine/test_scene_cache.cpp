@@ -0,0 +1,482 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/SceneCache.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/TextureCache.h>
+#include <donut/core/vfs/VFS.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <typeinfo>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// A file system that keeps the files in memory, so that the test doesn't touch the disk.
+class MemoryFileSystem : public vfs::IFileSystem
+{
+public:
+    std::map<std::string, std::vector<uint8_t>> files;
+    std::map<std::string, uint64_t> modificationTimes; // files without an entry don't report their attributes
+    std::map<std::string, int> readCounts;
+
+    bool folderExists(const std::filesystem::path& name) override { return false; }
+
+    bool fileExists(const std::filesystem::path& name) override
+    {
+        return files.find(name.generic_string()) != files.end();
+    }
+
+    std::shared_ptr<vfs::IBlob> readFile(const std::filesystem::path& name) override
+    {
+        auto it = files.find(name.generic_string());
+        if (it == files.end())
+            return nullptr;
+
+        ++readCounts[it->first];
+        void* data = malloc(it->second.size());
+        memcpy(data, it->second.data(), it->second.size());
+        return std::make_shared<vfs::Blob>(data, it->second.size());
+    }
+
+    bool getFileAttributes(const std::filesystem::path& name, vfs::FileAttributes& attributes) override
+    {
+        auto it = files.find(name.generic_string());
+        auto time = modificationTimes.find(name.generic_string());
+        if (it == files.end() || time == modificationTimes.end())
+            return false;
+
+        attributes.size = it->second.size();
+        attributes.modificationTime = time->second;
+        return true;
+    }
+
+    bool writeFile(const std::filesystem::path& name, const void* data, size_t size) override
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        files[name.generic_string()].assign(bytes, bytes + size);
+        return true;
+    }
+
+    int enumerateFiles(const std::filesystem::path& path, const std::vector<std::string>& extensions, vfs::enumerate_callback_t callback, bool allowDuplicates) override
+    {
+        return vfs::status::NotImplemented;
+    }
+
+    int enumerateDirectories(const std::filesystem::path& path, vfs::enumerate_callback_t callback, bool allowDuplicates) override
+    {
+        return vfs::status::NotImplemented;
+    }
+};
+
+// Builds a model that looks like the output of GltfImporter: shared buffers, a static mesh, a skinned mesh with
+// its joints, a camera, a light and an animation.
+SceneImportResult BuildTestModel()
+{
+    auto buffers = std::make_shared<BufferGroup>();
+    buffers->indexData = { 0, 1, 2, 0, 2, 3, 0, 1, 2 };
+    buffers->positionData = { float3(0.f), float3(1.f, 0.f, 0.f), float3(1.f, 1.f, 0.f), float3(0.f, 1.f, 0.f), float3(0.f, 0.f, 1.f), float3(1.f, 0.f, 1.f), float3(1.f, 1.f, 1.f) };
+    buffers->normalData = { 1, 2, 3, 4, 5, 6, 7 };
+    buffers->jointData = { dm::vector<uint16_t, 4>(0, 1, 0, 0), dm::vector<uint16_t, 4>(1, 0, 0, 0), dm::vector<uint16_t, 4>(0, 0, 0, 0) };
+    buffers->weightData = { float4(0.5f, 0.5f, 0.f, 0.f), float4(1.f, 0.f, 0.f, 0.f), float4(1.f, 0.f, 0.f, 0.f) };
+
+    Meshlet meshlet;
+    meshlet.vertexCount = 4;
+    meshlet.primitiveCount = 2;
+    meshlet.center = float3(0.5f, 0.5f, 0.f);
+    meshlet.radius = 0.75f;
+    buffers->meshletData = { meshlet };
+    buffers->meshletVertexData = { 0, 1, 2, 3 };
+    buffers->meshletPrimitiveData = { 0, 1, 2, 0, 2, 3 };
+
+    auto material = std::make_shared<Material>();
+    material->name = "Red";
+    material->baseOrDiffuseColor = float3(1.f, 0.f, 0.f);
+    material->roughness = 0.25f;
+    material->domain = MaterialDomain::AlphaTested;
+    material->doubleSided = true;
+    material->hair.melanin = 0.75f;
+
+    auto staticMesh = std::make_shared<MeshInfo>();
+    staticMesh->name = "Quad";
+    staticMesh->buffers = buffers;
+    staticMesh->totalIndices = 6;
+    staticMesh->totalVertices = 4;
+    staticMesh->objectSpaceBounds = box3(float3(0.f), float3(1.f, 1.f, 0.f));
+    auto staticGeometry = std::make_shared<MeshGeometry>();
+    staticGeometry->material = material;
+    staticGeometry->numIndices = 6;
+    staticGeometry->numVertices = 4;
+    staticGeometry->numMeshlets = 1;
+    staticGeometry->objectSpaceBounds = staticMesh->objectSpaceBounds;
+    staticMesh->geometries.push_back(staticGeometry);
+
+    auto skinnedMesh = std::make_shared<MeshInfo>();
+    skinnedMesh->name = "Skinned";
+    skinnedMesh->buffers = buffers;
+    skinnedMesh->indexOffset = 6;
+    skinnedMesh->vertexOffset = 4;
+    skinnedMesh->totalIndices = 3;
+    skinnedMesh->totalVertices = 3;
+    skinnedMesh->isSkinPrototype = true;
+    skinnedMesh->objectSpaceBounds = box3(float3(0.f, 0.f, 1.f), float3(1.f));
+    auto skinnedGeometry = std::make_shared<MeshGeometry>();
+    skinnedGeometry->material = material;
+    skinnedGeometry->numIndices = 3;
+    skinnedGeometry->numVertices = 3;
+    skinnedGeometry->objectSpaceBounds = skinnedMesh->objectSpaceBounds;
+    skinnedMesh->geometries.push_back(skinnedGeometry);
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    root->SetName("model.gltf");
+
+    auto meshNode = std::make_shared<SceneGraphNode>();
+    meshNode->SetName("Mesh");
+    meshNode->SetTranslation(double3(1.0, 2.0, 3.0));
+    meshNode->SetRotation(rotationQuat(double3(0.3, 0.2, 0.1)));
+    graph->Attach(root, meshNode);
+    meshNode->SetLeaf(std::make_shared<MeshInstance>(staticMesh));
+
+    auto cameraNode = std::make_shared<SceneGraphNode>();
+    cameraNode->SetName("Camera");
+    graph->Attach(meshNode, cameraNode);
+    auto camera = std::make_shared<PerspectiveCamera>();
+    camera->verticalFov = 0.8f;
+    camera->zFar = 500.f;
+    cameraNode->SetLeaf(camera);
+
+    auto lightNode = std::make_shared<SceneGraphNode>();
+    lightNode->SetName("Light");
+    lightNode->SetScaling(double3(2.0));
+    graph->Attach(root, lightNode);
+    auto light = std::make_shared<SpotLight>();
+    light->color = float3(0.5f, 0.6f, 0.7f);
+    light->intensity = 20.f;
+    light->outerAngle = 45.f;
+    lightNode->SetLeaf(light);
+
+    auto jointNode = std::make_shared<SceneGraphNode>();
+    jointNode->SetName("Joint");
+    graph->Attach(root, jointNode);
+
+    auto skinnedNode = std::make_shared<SceneGraphNode>();
+    skinnedNode->SetName("SkinnedMesh");
+    graph->Attach(root, skinnedNode);
+
+    auto skinnedInstance = std::make_shared<SkinnedMeshInstance>(std::make_shared<SceneTypeFactory>(), skinnedMesh);
+    for (const auto& node : { meshNode, jointNode })
+    {
+        SkinnedMeshJoint joint;
+        joint.node = node;
+        joint.inverseBindMatrix = affineToHomogeneous(translation(float3(-1.f, 0.f, float(skinnedInstance->joints.size()))));
+        skinnedInstance->joints.push_back(joint);
+        if (!node->GetLeaf())
+            node->SetLeaf(std::make_shared<SkinnedMeshReference>(skinnedInstance));
+    }
+    skinnedNode->SetLeaf(skinnedInstance);
+
+    auto sampler = std::make_shared<animation::Sampler>();
+    sampler->SetInterpolationMode(animation::InterpolationMode::Linear);
+    animation::Keyframe keyframe;
+    keyframe.value = float4(0.f, 0.f, 0.f, 0.f);
+    sampler->AddKeyframe(keyframe);
+    keyframe.time = 2.f;
+    keyframe.value = float4(4.f, 2.f, 0.f, 0.f);
+    sampler->AddKeyframe(keyframe);
+
+    auto animation = std::make_shared<SceneGraphAnimation>();
+    animation->AddChannel(std::make_shared<SceneGraphAnimationChannel>(sampler, jointNode, AnimationAttribute::Translation));
+    auto animationNode = std::make_shared<SceneGraphNode>();
+    animationNode->SetName("Walk");
+    graph->Attach(root, animationNode);
+    animationNode->SetLeaf(animation);
+
+    SceneImportResult result;
+    result.rootNode = root;
+    result.sourceFiles = { "/models/model.gltf", "/models/model.bin" };
+    return result;
+}
+
+std::vector<SceneGraphNode*> FlattenModel(SceneGraphNode* root)
+{
+    std::vector<SceneGraphNode*> nodes;
+    for (SceneGraphWalker walker(root); walker; walker.Next(true))
+        nodes.push_back(walker.Get());
+    return nodes;
+}
+
+bool CompareModels(const SceneImportResult& a, const SceneImportResult& b)
+{
+    if (!a.rootNode || !b.rootNode || a.sourceFiles != b.sourceFiles)
+        return false;
+
+    std::vector<SceneGraphNode*> nodesA = FlattenModel(a.rootNode.get());
+    std::vector<SceneGraphNode*> nodesB = FlattenModel(b.rootNode.get());
+    if (nodesA.size() != nodesB.size())
+        return false;
+
+    auto nodeIndex = [](const std::vector<SceneGraphNode*>& nodes, const SceneGraphNode* node)
+    {
+        return int(std::find(nodes.begin(), nodes.end(), node) - nodes.begin());
+    };
+
+    auto compareMeshes = [](const MeshInfo& meshA, const MeshInfo& meshB)
+    {
+        if (meshA.name != meshB.name || meshA.indexOffset != meshB.indexOffset || meshA.vertexOffset != meshB.vertexOffset ||
+            meshA.totalIndices != meshB.totalIndices || meshA.totalVertices != meshB.totalVertices ||
+            meshA.isSkinPrototype != meshB.isSkinPrototype || any(meshA.objectSpaceBounds.m_mins != meshB.objectSpaceBounds.m_mins) ||
+            meshA.geometries.size() != meshB.geometries.size())
+            return false;
+
+        const BufferGroup& buffersA = *meshA.buffers;
+        const BufferGroup& buffersB = *meshB.buffers;
+        if (buffersA.indexData != buffersB.indexData || buffersA.normalData != buffersB.normalData ||
+            buffersA.positionData.size() != buffersB.positionData.size() || buffersA.weightData.size() != buffersB.weightData.size() ||
+            memcmp(buffersA.positionData.data(), buffersB.positionData.data(), buffersA.positionData.size() * sizeof(float3)) != 0 ||
+            memcmp(buffersA.weightData.data(), buffersB.weightData.data(), buffersA.weightData.size() * sizeof(float4)) != 0 ||
+            buffersA.meshletVertexData != buffersB.meshletVertexData || buffersA.meshletPrimitiveData != buffersB.meshletPrimitiveData ||
+            buffersA.meshletData.size() != buffersB.meshletData.size() ||
+            memcmp(buffersA.meshletData.data(), buffersB.meshletData.data(), buffersA.meshletData.size() * sizeof(Meshlet)) != 0)
+            return false;
+
+        for (size_t i = 0; i < meshA.geometries.size(); ++i)
+        {
+            const MeshGeometry& geometryA = *meshA.geometries[i];
+            const MeshGeometry& geometryB = *meshB.geometries[i];
+            if (geometryA.numIndices != geometryB.numIndices || geometryA.numVertices != geometryB.numVertices ||
+                geometryA.meshletOffset != geometryB.meshletOffset || geometryA.numMeshlets != geometryB.numMeshlets)
+                return false;
+
+            const Material& materialA = *geometryA.material;
+            const Material& materialB = *geometryB.material;
+            if (materialA.name != materialB.name || materialA.domain != materialB.domain || materialA.roughness != materialB.roughness ||
+                any(materialA.baseOrDiffuseColor != materialB.baseOrDiffuseColor) || materialA.doubleSided != materialB.doubleSided ||
+                materialA.hair.melanin != materialB.hair.melanin)
+                return false;
+        }
+
+        return true;
+    };
+
+    for (size_t i = 0; i < nodesA.size(); ++i)
+    {
+        const SceneGraphNode* nodeA = nodesA[i];
+        const SceneGraphNode* nodeB = nodesB[i];
+
+        if (nodeA->GetName() != nodeB->GetName() ||
+            nodeIndex(nodesA, nodeA->GetParent()) != nodeIndex(nodesB, nodeB->GetParent()) ||
+            any(nodeA->GetTranslation() != nodeB->GetTranslation()) ||
+            any(nodeA->GetRotation() != nodeB->GetRotation()) ||
+            any(nodeA->GetScaling() != nodeB->GetScaling()))
+            return false;
+
+        const auto& leafA = nodeA->GetLeaf();
+        const auto& leafB = nodeB->GetLeaf();
+        if (!leafA || !leafB)
+        {
+            if (leafA || leafB)
+                return false;
+            continue;
+        }
+
+        if (typeid(*leafA) != typeid(*leafB))
+            return false;
+
+        if (auto skinnedA = std::dynamic_pointer_cast<SkinnedMeshInstance>(leafA))
+        {
+            auto skinnedB = std::dynamic_pointer_cast<SkinnedMeshInstance>(leafB);
+            if (!compareMeshes(*skinnedA->GetPrototypeMesh(), *skinnedB->GetPrototypeMesh()) ||
+                skinnedA->joints.size() != skinnedB->joints.size())
+                return false;
+
+            for (size_t j = 0; j < skinnedA->joints.size(); ++j)
+            {
+                if (nodeIndex(nodesA, skinnedA->joints[j].node.lock().get()) != nodeIndex(nodesB, skinnedB->joints[j].node.lock().get()) ||
+                    any(skinnedA->joints[j].inverseBindMatrix.row3 != skinnedB->joints[j].inverseBindMatrix.row3))
+                    return false;
+            }
+        }
+        else if (auto meshA = std::dynamic_pointer_cast<MeshInstance>(leafA))
+        {
+            if (!compareMeshes(*meshA->GetMesh(), *std::dynamic_pointer_cast<MeshInstance>(leafB)->GetMesh()))
+                return false;
+        }
+        else if (auto cameraA = std::dynamic_pointer_cast<PerspectiveCamera>(leafA))
+        {
+            auto cameraB = std::dynamic_pointer_cast<PerspectiveCamera>(leafB);
+            if (cameraA->verticalFov != cameraB->verticalFov || cameraA->zFar != cameraB->zFar || cameraA->aspectRatio != cameraB->aspectRatio)
+                return false;
+        }
+        else if (auto lightA = std::dynamic_pointer_cast<SpotLight>(leafA))
+        {
+            auto lightB = std::dynamic_pointer_cast<SpotLight>(leafB);
+            if (any(lightA->color != lightB->color) || lightA->intensity != lightB->intensity || lightA->outerAngle != lightB->outerAngle)
+                return false;
+        }
+        else if (auto animationA = std::dynamic_pointer_cast<SceneGraphAnimation>(leafA))
+        {
+            auto animationB = std::dynamic_pointer_cast<SceneGraphAnimation>(leafB);
+            if (animationA->GetDuration() != animationB->GetDuration() ||
+                animationA->GetChannels().size() != animationB->GetChannels().size())
+                return false;
+
+            for (size_t c = 0; c < animationA->GetChannels().size(); ++c)
+            {
+                const auto& channelA = animationA->GetChannels()[c];
+                const auto& channelB = animationB->GetChannels()[c];
+                if (channelA->GetAttribute() != channelB->GetAttribute() ||
+                    nodeIndex(nodesA, channelA->GetTargetNode().get()) != nodeIndex(nodesB, channelB->GetTargetNode().get()) ||
+                    channelA->GetSampler()->GetMode() != channelB->GetSampler()->GetMode() ||
+                    any(channelA->GetSampler()->Evaluate(1.5f).value() != channelB->GetSampler()->Evaluate(1.5f).value()))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void test_round_trip()
+{
+    auto fs = std::make_shared<MemoryFileSystem>();
+    fs->files["/models/model.gltf"] = { '{', '}' };
+    fs->files["/models/model.bin"] = std::vector<uint8_t>(1001, 7);
+
+    SceneCache cache(fs, std::make_shared<SceneTypeFactory>());
+    TextureCache textureCache(nullptr, fs, nullptr);
+
+    SceneImportResult model = BuildTestModel();
+
+    SceneImportResult loaded;
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(cache.Store("/models/model.gltf", model));
+    CHECK(fs->fileExists(SceneCache::GetCacheFileName("/models/model.gltf")));
+    CHECK(cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(CompareModels(model, loaded));
+
+    // The meshes that share buffers in the source model should share them after loading.
+    if (loaded.rootNode)
+    {
+        std::vector<SceneGraphNode*> nodes = FlattenModel(loaded.rootNode.get());
+        auto meshInstance = std::dynamic_pointer_cast<MeshInstance>(nodes[1]->GetLeaf());
+        auto skinnedInstance = std::dynamic_pointer_cast<SkinnedMeshInstance>(nodes[5]->GetLeaf());
+        CHECK(meshInstance && skinnedInstance && meshInstance->GetMesh()->buffers == skinnedInstance->GetPrototypeMesh()->buffers);
+        CHECK(std::dynamic_pointer_cast<SkinnedMeshReference>(nodes[4]->GetLeaf()) != nullptr);
+    }
+}
+
+void test_invalidation()
+{
+    auto fs = std::make_shared<MemoryFileSystem>();
+    fs->files["/models/model.gltf"] = { '{', '}' };
+    fs->files["/models/model.bin"] = std::vector<uint8_t>(1001, 7);
+
+    SceneCache cache(fs, std::make_shared<SceneTypeFactory>());
+    TextureCache textureCache(nullptr, fs, nullptr);
+    SceneImportResult loaded;
+
+    CHECK(cache.Store("/models/model.gltf", BuildTestModel()));
+
+    // Same size, different contents
+    fs->files["/models/model.bin"][500] = 8;
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(!loaded.rootNode);
+
+    // Different size
+    fs->files["/models/model.bin"].resize(1000, 7);
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+
+    // Source removed
+    fs->files.erase("/models/model.bin");
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+
+    // Truncated cache file
+    fs->files["/models/model.bin"] = std::vector<uint8_t>(1001, 7);
+    CHECK(cache.Store("/models/model.gltf", BuildTestModel()));
+    CHECK(cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    auto& cacheFile = fs->files[SceneCache::GetCacheFileName("/models/model.gltf").generic_string()];
+    cacheFile.resize(cacheFile.size() - 16);
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+}
+
+void test_modification_times()
+{
+    auto fs = std::make_shared<MemoryFileSystem>();
+    fs->files["/models/model.gltf"] = { '{', '}' };
+    fs->files["/models/model.bin"] = std::vector<uint8_t>(1001, 7);
+    fs->modificationTimes["/models/model.gltf"] = 100;
+    fs->modificationTimes["/models/model.bin"] = 100;
+
+    SceneCache cache(fs, std::make_shared<SceneTypeFactory>());
+    TextureCache textureCache(nullptr, fs, nullptr);
+    SceneImportResult loaded;
+
+    CHECK(cache.Store("/models/model.gltf", BuildTestModel()));
+
+    // Unchanged size and time: the sources are not read
+    fs->readCounts.clear();
+    CHECK(cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(fs->readCounts["/models/model.bin"] == 0);
+
+    // Touched, same contents: the source is hashed and the cache is still valid
+    fs->modificationTimes["/models/model.bin"] = 200;
+    fs->readCounts.clear();
+    CHECK(cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(fs->readCounts["/models/model.bin"] == 1);
+
+    // Modified contents and time
+    fs->files["/models/model.bin"][500] = 8;
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+
+    // Different size: rejected without reading the source
+    fs->files["/models/model.bin"].resize(1000, 7);
+    fs->modificationTimes["/models/model.bin"] = 100;
+    fs->readCounts.clear();
+    CHECK(!cache.Load("/models/model.gltf", textureCache, nullptr, loaded));
+    CHECK(fs->readCounts["/models/model.bin"] == 0);
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    try
+    {
+        test_round_trip();
+        test_invalidation();
+        test_modification_times();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    return 0;
+}
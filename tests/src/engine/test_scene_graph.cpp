@@ -0,0 +1,599 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// Builds a wide hierarchy: root -> groups -> nodes -> (some) nested nodes, with mesh instances on most nodes.
+// The same seed always produces the same graph.
+std::shared_ptr<SceneGraph> BuildTestGraph(uint32_t numGroups, uint32_t nodesPerGroup, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> posDist(-100.0, 100.0);
+    std::uniform_real_distribution<float> sizeDist(0.1f, 2.f);
+
+    auto material = std::make_shared<Material>();
+    auto transparentMaterial = std::make_shared<Material>();
+    transparentMaterial->domain = MaterialDomain::AlphaBlended;
+
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+    for (int i = 0; i < 8; ++i)
+    {
+        auto mesh = std::make_shared<MeshInfo>();
+        auto geometry = std::make_shared<MeshGeometry>();
+        geometry->material = (i == 7) ? transparentMaterial : material;
+        float size = sizeDist(rng);
+        mesh->objectSpaceBounds = box3(float3(-size), float3(size));
+        geometry->objectSpaceBounds = mesh->objectSpaceBounds;
+        mesh->geometries.push_back(geometry);
+        meshes.push_back(mesh);
+    }
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    root->SetName("Root");
+    graph->SetRootNode(root);
+
+    for (uint32_t group = 0; group < numGroups; ++group)
+    {
+        auto groupNode = std::make_shared<SceneGraphNode>();
+        groupNode->SetTranslation(double3(posDist(rng), 0.0, posDist(rng)));
+        graph->Attach(root, groupNode);
+
+        for (uint32_t index = 0; index < nodesPerGroup; ++index)
+        {
+            auto node = std::make_shared<SceneGraphNode>();
+            node->SetTranslation(double3(posDist(rng), posDist(rng), posDist(rng)));
+            if (index % 3 != 0)
+                node->SetLeaf(std::make_shared<MeshInstance>(meshes[rng() % meshes.size()]));
+            graph->Attach(groupNode, node);
+
+            if (index % 5 == 0)
+            {
+                auto nested = std::make_shared<SceneGraphNode>();
+                nested->SetRotation(rotationQuat(double3(0.1 * double(index), 0.2, 0.3)));
+                nested->SetLeaf(std::make_shared<MeshInstance>(meshes[rng() % meshes.size()]));
+                graph->Attach(node, nested);
+            }
+        }
+    }
+
+    return graph;
+}
+
+// Moves a deterministic random subset of the nodes, including some of the groups.
+void AnimateTestGraph(SceneGraph& graph, uint32_t numAnimated, uint32_t seed)
+{
+    std::vector<SceneGraphNode*> nodes;
+    SceneGraphWalker walker(graph.GetRootNode().get());
+    while (walker)
+    {
+        nodes.push_back(walker.Get());
+        walker.Next(true);
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> posDist(-100.0, 100.0);
+    for (uint32_t i = 0; i < numAnimated; ++i)
+    {
+        SceneGraphNode* node = nodes[1 + rng() % (nodes.size() - 1)];
+        node->SetTranslation(double3(posDist(rng), posDist(rng), posDist(rng)));
+    }
+}
+
+template<typename T>
+bool BitwiseEqual(const T& a, const T& b)
+{
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Walks two graphs with the same structure in lockstep and compares all refresh results bit-for-bit.
+bool CompareGraphs(const SceneGraph& a, const SceneGraph& b)
+{
+    SceneGraphWalker walkerA(a.GetRootNode().get());
+    SceneGraphWalker walkerB(b.GetRootNode().get());
+    uint32_t errorCount = 0;
+    while (walkerA && walkerB)
+    {
+        bool pass = BitwiseEqual(walkerA->GetLocalToWorldTransform(), walkerB->GetLocalToWorldTransform())
+            && BitwiseEqual(walkerA->GetLocalToWorldTransformFloat(), walkerB->GetLocalToWorldTransformFloat())
+            && BitwiseEqual(walkerA->GetPrevLocalToWorldTransform(), walkerB->GetPrevLocalToWorldTransform())
+            && BitwiseEqual(walkerA->GetPrevLocalToWorldTransformFloat(), walkerB->GetPrevLocalToWorldTransformFloat())
+            && BitwiseEqual(walkerA->GetGlobalBoundingBox(), walkerB->GetGlobalBoundingBox())
+            && walkerA->GetDirtyFlags() == uint32_t(walkerB->GetDirtyFlags())
+            && walkerA->GetLeafContentFlags() == uint32_t(walkerB->GetLeafContentFlags())
+            && walkerA->GetSubgraphContentFlags() == uint32_t(walkerB->GetSubgraphContentFlags());
+
+        if (!pass)
+        {
+            ++errorCount;
+            if (errorCount < 16)
+                fprintf(stderr, "Refresh mismatch at node '%s'\n", walkerA->GetPath().generic_string().c_str());
+        }
+
+        walkerA.Next(true);
+        walkerB.Next(true);
+    }
+
+    if (walkerA || walkerB)
+    {
+        fprintf(stderr, "Graph structure mismatch\n");
+        return false;
+    }
+
+    return errorCount == 0;
+}
+
+void test_parallel_refresh()
+{
+    ThreadPool threadPool(4);
+
+    for (bool transformStore : { false, true })
+    {
+        auto serialGraph = BuildTestGraph(64, 200, 1);
+        auto parallelGraph = BuildTestGraph(64, 200, 1);
+        serialGraph->SetTransformStoreEnabled(transformStore);
+        parallelGraph->SetTransformStoreEnabled(transformStore);
+
+        for (uint32_t frame = 0; frame < 4; ++frame)
+        {
+            if (frame > 0)
+            {
+                AnimateTestGraph(*serialGraph, 100 * frame, frame);
+                AnimateTestGraph(*parallelGraph, 100 * frame, frame);
+            }
+
+            serialGraph->Refresh(frame);
+            parallelGraph->RefreshWithThreadPool(frame, &threadPool);
+
+            CHECK(CompareGraphs(*serialGraph, *parallelGraph));
+            CHECK(serialGraph->GetGeometryInstancesCount() == parallelGraph->GetGeometryInstancesCount());
+        }
+    }
+
+    // A single deep chain, which the parallel path cannot split
+    auto serialChain = std::make_shared<SceneGraph>();
+    auto parallelChain = std::make_shared<SceneGraph>();
+    for (auto& graph : { serialChain, parallelChain })
+    {
+        auto node = std::make_shared<SceneGraphNode>();
+        graph->SetRootNode(node);
+        for (int depth = 0; depth < 100; ++depth)
+        {
+            auto child = std::make_shared<SceneGraphNode>();
+            child->SetTranslation(double3(1.0, 0.0, 0.0));
+            child->SetLeaf(std::make_shared<PointLight>());
+            node = graph->Attach(node, child);
+        }
+    }
+    serialChain->Refresh(0);
+    parallelChain->RefreshWithThreadPool(0, &threadPool);
+    CHECK(CompareGraphs(*serialChain, *parallelChain));
+}
+
+void test_transform_store()
+{
+    auto graph = BuildTestGraph(8, 20, 2);
+    graph->SetTransformStoreEnabled(true);
+    graph->Refresh(0);
+
+    // The store must list every node in depth-first order with correct parents and subgraph ranges
+    const SceneGraphTransformStore& store = graph->GetTransformStore();
+    std::vector<uint32_t> path;
+    uint32_t index = 0;
+    SceneGraphWalker walker(graph->GetRootNode().get());
+    while (walker)
+    {
+        CHECK(index < store.size());
+
+        CHECK(store.nodes[index] == walker.Get());
+        CHECK(store.parentIndices[index] == (path.empty() ? -1 : int(path.back())));
+        for (uint32_t ancestor : path)
+            CHECK(store.subgraphEnds[ancestor] > index);
+        CHECK(BitwiseEqual(walker->GetLocalToWorldTransform(), store.globalTransforms[index]));
+
+        int deltaDepth = walker.Next(true);
+        if (deltaDepth > 0)
+            path.push_back(index);
+        while (deltaDepth++ < 0)
+        {
+            CHECK(store.subgraphEnds[path.back()] == index + 1);
+            path.pop_back();
+        }
+        ++index;
+    }
+    CHECK(index == store.size());
+
+    // Transforms must survive a store rebuild, and detached nodes must not reference the store
+    auto group = graph->GetRootNode()->GetChild(1)->shared_from_this();
+    auto node = group->GetChild(2)->shared_from_this();
+    dm::daffine3 nodeTransform = node->GetLocalToWorldTransform();
+    graph->Detach(graph->GetRootNode()->GetChild(0)->shared_from_this());
+    graph->Refresh(1);
+    CHECK(BitwiseEqual(node->GetLocalToWorldTransform(), nodeTransform));
+    CHECK(BitwiseEqual(node->GetPrevLocalToWorldTransform(), nodeTransform));
+
+    // Detached nodes keep their transforms, and bring them back when attached again
+    const dm::double3 translation = node->GetTranslation();
+    const dm::dquat rotation = node->GetRotation();
+    const dm::double3 scaling = node->GetScaling();
+    const dm::daffine3 localTransform = node->GetLocalToParentTransform();
+    graph->Detach(group);
+    CHECK(BitwiseEqual(node->GetLocalToWorldTransform(), nodeTransform));
+    CHECK(BitwiseEqual(node->GetLocalToParentTransform(), localTransform));
+
+    graph->Refresh(2);
+    auto newParent = graph->GetRootNode()->GetChild(0)->shared_from_this();
+    graph->Attach(newParent, group);
+    graph->Refresh(3);
+    CHECK(all(node->GetTranslation() == translation) && all(node->GetScaling() == scaling));
+    CHECK(node->GetRotation().x == rotation.x && node->GetRotation().y == rotation.y
+        && node->GetRotation().z == rotation.z && node->GetRotation().w == rotation.w);
+    CHECK(BitwiseEqual(node->GetLocalToParentTransform(), localTransform));
+    CHECK(BitwiseEqual(node->GetLocalToWorldTransform(),
+        localTransform * group->GetLocalToWorldTransform()));
+    CHECK(BitwiseEqual(group->GetLocalToWorldTransform(),
+        group->GetLocalToParentTransform() * newParent->GetLocalToWorldTransform()));
+
+    // Nodes also keep their transforms when the graph is destroyed
+    const dm::daffine3 groupTransform = group->GetLocalToWorldTransform();
+    graph.reset();
+    CHECK(BitwiseEqual(group->GetLocalToWorldTransform(), groupTransform));
+}
+
+void test_transform_store_toggle()
+{
+    // Graphs with and without the store must produce the same results, also when the store is toggled between frames
+    auto nodeGraph = BuildTestGraph(16, 50, 4);
+    auto storeGraph = BuildTestGraph(16, 50, 4);
+    storeGraph->SetTransformStoreEnabled(true);
+
+    for (uint32_t frame = 0; frame < 6; ++frame)
+    {
+        if (frame == 2 || frame == 4)
+        {
+            nodeGraph->SetTransformStoreEnabled(!nodeGraph->IsTransformStoreEnabled());
+            storeGraph->SetTransformStoreEnabled(!storeGraph->IsTransformStoreEnabled());
+        }
+
+        if (frame > 0)
+        {
+            AnimateTestGraph(*nodeGraph, 50, frame);
+            AnimateTestGraph(*storeGraph, 50, frame);
+        }
+
+        nodeGraph->Refresh(frame);
+        storeGraph->Refresh(frame);
+        CHECK(CompareGraphs(*nodeGraph, *storeGraph));
+
+        // The transform arrays are only filled when the store is enabled
+        const SceneGraphTransformStore& store = storeGraph->GetTransformStore();
+        CHECK(store.globalTransforms.size() == (storeGraph->IsTransformStoreEnabled() ? store.size() : 0));
+    }
+}
+
+void benchmark_parallel_refresh()
+{
+    constexpr uint32_t numGroups = 1000;
+    constexpr uint32_t nodesPerGroup = 500;
+    constexpr uint32_t numAnimated = 4000;
+    constexpr uint32_t numFrames = 20;
+
+    auto graph = BuildTestGraph(numGroups, nodesPerGroup, 1);
+    graph->SetTransformStoreEnabled(true);
+    graph->Refresh(0);
+
+    auto measure = [&graph](ThreadPool* threadPool)
+    {
+        double totalTime = 0.0;
+        for (uint32_t frame = 1; frame <= numFrames; ++frame)
+        {
+            AnimateTestGraph(*graph, numAnimated, frame);
+            auto start = std::chrono::high_resolution_clock::now();
+            graph->RefreshWithThreadPool(frame, threadPool);
+            auto end = std::chrono::high_resolution_clock::now();
+            totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        return totalTime / double(numFrames);
+    };
+
+    printf("SceneGraph refresh, %u nodes, %u animated per frame:\n", numGroups * nodesPerGroup, numAnimated);
+    double serialTime = measure(nullptr);
+    printf("  serial: %.3f ms\n", serialTime);
+
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        ThreadPool threadPool(numThreads);
+        double parallelTime = measure(&threadPool);
+        printf("  %u worker(s): %.3f ms (%.2fx)\n", numThreads, parallelTime, serialTime / parallelTime);
+    }
+}
+
+// A camera looking at the test graph from one side.
+frustum MakeTestFrustum(float angle)
+{
+    float4x4 projection = perspProjD3DStyle(radians(60.f), 1.5f, 0.1f, 150.f);
+    float4x4 view = affineToHomogeneous(inverse(
+        translation(float3(0.f, 10.f, 120.f)) * rotation(float3(0.f, 1.f, 0.f), angle)));
+    return frustum(view * projection, false).normalize();
+}
+
+// Compares a BVH query with testing all leaves.
+bool CheckBVHQuery(const InstanceBVH& bvh, const frustum& f)
+{
+    std::vector<uint32_t> visible;
+    InstanceBVH::QueryStats stats;
+    bvh.Query(f, visible, &stats);
+    std::sort(visible.begin(), visible.end());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t leaf = 0; leaf < bvh.GetNumLeaves(); ++leaf)
+    {
+        if (!bvh.GetLeafBounds(leaf).isempty() && f.intersectsWith(bvh.GetLeafBounds(leaf)))
+            expected.push_back(leaf);
+    }
+
+    bool pass = visible == expected && stats.leavesVisible == uint32_t(expected.size());
+    if (!pass)
+        fprintf(stderr, "BVH query returned %zu leaves, expected %zu\n", visible.size(), expected.size());
+    return pass;
+}
+
+void test_instance_bvh()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> posDist(-100.f, 100.f);
+    std::uniform_real_distribution<float> sizeDist(0.1f, 5.f);
+
+    auto randomBox = [&]()
+    {
+        float3 center(posDist(rng), posDist(rng), posDist(rng));
+        float3 size(sizeDist(rng), sizeDist(rng), sizeDist(rng));
+        return box3(center - size, center + size);
+    };
+
+    std::vector<box3> bounds;
+    for (int i = 0; i < 5000; ++i)
+        bounds.push_back(i % 50 == 0 ? box3::empty() : randomBox());
+
+    InstanceBVH bvh;
+    bvh.Build(bounds);
+
+    CHECK(bvh.Validate());
+    for (int view = 0; view < 4; ++view)
+        CHECK(CheckBVHQuery(bvh, MakeTestFrustum(radians(90.f * float(view)))));
+
+    // Small updates are reinserted, large ones refit the tree; some leaves become empty or non-empty
+    for (uint32_t numMoved : { 10u, 200u, 3000u, 5u })
+    {
+        for (uint32_t i = 0; i < numMoved; ++i)
+        {
+            uint32_t leaf = rng() % bvh.GetNumLeaves();
+            bvh.UpdateLeaf(leaf, (i % 97 == 0) ? box3::empty() : randomBox());
+        }
+
+        // Small motions within the fat boxes
+        for (uint32_t i = 0; i < numMoved; ++i)
+        {
+            uint32_t leaf = rng() % bvh.GetNumLeaves();
+            box3 box = bvh.GetLeafBounds(leaf);
+            if (!box.isempty())
+                bvh.UpdateLeaf(leaf, box.translate(box.diagonal() * 0.01f));
+        }
+
+        bvh.Commit();
+
+        CHECK(bvh.Validate());
+        for (int view = 0; view < 4; ++view)
+            CHECK(CheckBVHQuery(bvh, MakeTestFrustum(radians(90.f * float(view) + 10.f))));
+    }
+
+    InstanceBVH::Stats stats = bvh.GetStats();
+    CHECK(stats.leaves == 5000 && stats.refits + stats.rebuilds > 1 && stats.reinsertions > 0);
+
+    bvh.Clear();
+    CHECK(bvh.Validate() && bvh.GetNumLeaves() == 0 && CheckBVHQuery(bvh, MakeTestFrustum(0.f)));
+}
+
+// Compares the instance BVH of a graph with the current bounds of its mesh instances.
+bool CheckSceneInstanceBVH(const SceneGraph& graph)
+{
+    const InstanceBVH* bvh = graph.GetInstanceBVH();
+    if (!bvh || !bvh->Validate() || bvh->GetNumLeaves() != graph.GetMeshInstances().size())
+        return false;
+
+    for (const auto& instance : graph.GetMeshInstances())
+    {
+        box3 bounds = instance->GetLocalBoundingBox() * instance->GetNode()->GetLocalToWorldTransformFloat();
+        if (!BitwiseEqual(bvh->GetLeafBounds(uint32_t(instance->GetInstanceIndex())), bounds))
+            return false;
+    }
+
+    return CheckBVHQuery(*bvh, MakeTestFrustum(0.f)) && CheckBVHQuery(*bvh, MakeTestFrustum(radians(135.f)));
+}
+
+void test_scene_instance_bvh()
+{
+    auto graph = BuildTestGraph(50, 100, 3);
+    graph->SetInstanceBVHEnabled(true);
+    graph->Refresh(0);
+
+    CHECK(CheckSceneInstanceBVH(*graph));
+
+    ThreadPool threadPool(4);
+    for (uint32_t frame = 1; frame <= 6; ++frame)
+    {
+        AnimateTestGraph(*graph, frame * 20, frame);
+        if (frame % 2)
+            graph->Refresh(frame);
+        else
+            graph->RefreshWithThreadPool(frame, &threadPool);
+        CHECK(CheckSceneInstanceBVH(*graph));
+    }
+
+    // Structure changes rebuild the BVH
+    graph->Detach(graph->GetRootNode()->GetChild(0)->shared_from_this());
+    graph->Refresh(7);
+    CHECK(CheckSceneInstanceBVH(*graph));
+
+    graph->SetInstanceBVHEnabled(false);
+    CHECK(graph->GetInstanceBVH() == nullptr);
+}
+
+void test_graph_versions()
+{
+    auto graph = BuildTestGraph(4, 10, 3);
+    graph->Refresh(0);
+
+    auto checkVersions = [&graph](uint64_t structure, uint64_t content, uint64_t transform)
+    {
+        CHECK(graph->GetStructureVersion() == structure);
+        CHECK(graph->GetContentVersion() == content);
+        CHECK(graph->GetTransformVersion() == transform);
+    };
+
+    uint64_t structure = graph->GetStructureVersion();
+    uint64_t content = graph->GetContentVersion();
+    uint64_t transform = graph->GetTransformVersion();
+    CHECK(structure > 0);
+
+    // Nothing changed
+    graph->Refresh(1);
+    checkVersions(structure, content, transform);
+
+    graph->GetRootNode()->GetChild(1)->SetTranslation(double3(1.0, 2.0, 3.0));
+    graph->Refresh(2);
+    checkVersions(structure, content, ++transform);
+
+    graph->GetRootNode()->GetChild(2)->GetChild(0)->InvalidateContent();
+    graph->Refresh(3);
+    checkVersions(structure, ++content, transform);
+
+    graph->Detach(graph->GetRootNode()->GetChild(3)->shared_from_this());
+    graph->Refresh(4);
+    CHECK(graph->GetStructureVersion() > structure);
+}
+
+void benchmark_instance_bvh()
+{
+    // A flat graph with all instances under one group, like many imported models
+    auto graph = BuildTestGraph(1, 100000, 5);
+    graph->SetInstanceBVHEnabled(true);
+    graph->Refresh(0);
+
+    const frustum viewFrustum = MakeTestFrustum(radians(180.f));
+    constexpr int iterations = 20;
+
+    uint32_t walkerNodes = 0;
+    uint32_t walkerVisible = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it)
+    {
+        walkerNodes = 0;
+        walkerVisible = 0;
+        SceneGraphWalker walker(graph->GetRootNode().get());
+        while (walker)
+        {
+            ++walkerNodes;
+            bool visible = viewFrustum.intersectsWith(walker->GetGlobalBoundingBox());
+            if (visible && walker->GetLeaf() && viewFrustum.intersectsWith(walker->GetLeaf()->GetLocalBoundingBox() * walker->GetLocalToWorldTransformFloat()))
+                ++walkerVisible;
+            walker.Next(visible);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double walkerTime = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+
+    std::vector<uint32_t> visible;
+    InstanceBVH::QueryStats stats;
+    start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it)
+    {
+        visible.clear();
+        graph->GetInstanceBVH()->Query(viewFrustum, visible, &stats);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double bvhTime = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+
+    printf("Instance culling, %zu instances in a flat graph:\n", graph->GetMeshInstances().size());
+    printf("  hierarchy walk: %.3f ms, %u nodes visited, %u visible\n", walkerTime, walkerNodes, walkerVisible);
+    printf("  BVH query: %.3f ms, %u nodes visited, %u leaves tested, %u visible\n", bvhTime, stats.nodesVisited, stats.leavesTested, stats.leavesVisible);
+
+    constexpr uint32_t numFrames = 20;
+    for (uint32_t numAnimated : { 100u, 10000u })
+    {
+        double updateTime = 0.0;
+        for (uint32_t frame = 1; frame <= numFrames; ++frame)
+        {
+            AnimateTestGraph(*graph, numAnimated, frame);
+            start = std::chrono::high_resolution_clock::now();
+            graph->Refresh(frame);
+            end = std::chrono::high_resolution_clock::now();
+            updateTime += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        InstanceBVH::Stats bvhStats = graph->GetInstanceBVH()->GetStats();
+        printf("  refresh with %u moving instances: %.3f ms (%u rebuilds, %u refits, %u reinsertions so far, cost %.1f)\n",
+            numAnimated, updateTime / numFrames, bvhStats.rebuilds, bvhStats.refits, bvhStats.reinsertions, bvhStats.cost);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_parallel_refresh();
+        test_transform_store();
+        test_transform_store_toggle();
+        test_instance_bvh();
+        test_scene_instance_bvh();
+        test_graph_versions();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+    {
+        benchmark_parallel_refresh();
+        benchmark_instance_bvh();
+    }
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <donut/engine/ThreadPool.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <queue>
+
+using namespace donut;
+using namespace donut::engine;
+
+void test_add_tasks()
+{
+    ThreadPool threadPool(4);
+
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < 10000; ++i)
+        threadPool.AddTask([&counter]() { ++counter; });
+
+    // Captures that don't fit into the inline storage
+    std::array<int, 64> large;
+    large.fill(1);
+    for (int i = 0; i < 100; ++i)
+        threadPool.AddTask([&counter, large]() { counter += large[0]; });
+
+    // The legacy task interface
+    struct CounterTask : public ThreadPoolTask
+    {
+        std::atomic<int>& counter;
+        CounterTask(std::atomic<int>& c) : counter(c) { }
+        void Run() override { ++counter; }
+    };
+    threadPool.AddTask(std::make_shared<CounterTask>(counter));
+
+    // Exceptions must not break the pool
+    threadPool.AddTask([]() { throw std::runtime_error("test"); });
+
+    threadPool.WaitForTasks();
+    CHECK(counter.load() == 10101);
+}
+
+void test_nested_tasks()
+{
+    ThreadPool threadPool(4);
+
+    // Tasks adding more tasks and waiting on them from the worker threads
+    std::atomic<int> counter = 0;
+    ThreadPoolTaskGroup outer;
+    for (int i = 0; i < 16; ++i)
+    {
+        threadPool.AddTask(outer, [&threadPool, &counter]()
+        {
+            ThreadPoolTaskGroup inner;
+            for (int j = 0; j < 100; ++j)
+                threadPool.AddTask(inner, [&counter]() { ++counter; });
+            threadPool.Wait(inner);
+        });
+    }
+    threadPool.Wait(outer);
+
+    CHECK(counter.load() == 1600);
+}
+
+void test_task_groups()
+{
+    ThreadPool threadPool(2);
+
+    // A group must not wait for the tasks outside of it
+    std::atomic<bool> started = false;
+    std::atomic<bool> release = false;
+    threadPool.AddTask([&started, &release]()
+    {
+        started.store(true);
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    while (!started.load())
+        std::this_thread::yield();
+
+    ThreadPoolTaskGroup group;
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < 1000; ++i)
+        threadPool.AddTask(group, [&counter]() { ++counter; });
+
+    threadPool.Wait(group);
+    CHECK(group.IsDone() && counter.load() == 1000);
+
+    release.store(true);
+    threadPool.WaitForTasks();
+}
+
+void test_futures()
+{
+    ThreadPool threadPool(2);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures.push_back(threadPool.Submit([i]() { return i * i; }));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        threadPool.Wait(futures[i]);
+        CHECK(futures[i].get() == i * i);
+    }
+
+    auto failed = threadPool.Submit([]() -> int { throw std::runtime_error("test"); });
+    threadPool.Wait(failed);
+    bool rethrown = false;
+    try
+    {
+        failed.get();
+    }
+    catch (const std::runtime_error&)
+    {
+        rethrown = true;
+    }
+    CHECK(rethrown);
+}
+
+void test_priorities()
+{
+    ThreadPool threadPool(1);
+
+    // Keep the only worker busy while the tasks are queued
+    std::atomic<bool> started = false;
+    std::atomic<bool> release = false;
+    threadPool.AddTask([&started, &release]()
+    {
+        started.store(true);
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    while (!started.load())
+        std::this_thread::yield();
+
+    std::mutex mutex;
+    std::vector<ThreadPoolPriority> order;
+    auto record = [&mutex, &order](ThreadPoolPriority priority)
+    {
+        return [&mutex, &order, priority]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(priority);
+        };
+    };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threadPool.AddTask(record(ThreadPoolPriority::Low), ThreadPoolPriority::Low);
+        threadPool.AddTask(record(ThreadPoolPriority::Normal), ThreadPoolPriority::Normal);
+        threadPool.AddTask(record(ThreadPoolPriority::High), ThreadPoolPriority::High);
+    }
+
+    // Don't use WaitForTasks here: the waiting thread would run tasks concurrently with the worker
+    // and record them out of order
+    release.store(true);
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(mutex);
+        if (order.size() == 12)
+            break;
+    }
+    threadPool.WaitForTasks();
+
+    CHECK(order.size() == 12);
+    for (size_t i = 1; i < order.size(); ++i)
+        CHECK(order[i - 1] <= order[i]);
+}
+
+// The previous thread pool implementation, with a single locked queue of heap-allocated tasks,
+// kept here as the baseline for the benchmark.
+class LegacyThreadPool
+{
+public:
+    LegacyThreadPool(uint32_t numThreads)
+    {
+        for (uint32_t i = 0; i < numThreads; ++i)
+            m_threads.emplace_back([this]() { ThreadProc(); });
+    }
+
+    ~LegacyThreadPool()
+    {
+        WaitForTasks();
+        m_terminate.store(true);
+        m_forward.notify_all();
+        for (std::thread& thread : m_threads)
+            thread.join();
+    }
+
+    void AddTask(std::function<void()> func)
+    {
+        auto task = std::make_shared<std::function<void()>>(std::move(func));
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_tasks.push(task);
+        ++m_pendingTasks;
+        m_forward.notify_one();
+    }
+
+    void WaitForTasks()
+    {
+        while (m_pendingTasks.load() != 0)
+            std::this_thread::yield();
+    }
+
+private:
+    void ThreadProc()
+    {
+        while (!m_terminate.load())
+        {
+            std::shared_ptr<std::function<void()>> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_forward.wait(lock, [this] { return !m_tasks.empty() || m_terminate.load(); });
+                if (!m_tasks.empty())
+                {
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop();
+                }
+            }
+            if (task)
+            {
+                (*task)();
+                --m_pendingTasks;
+            }
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::queue<std::shared_ptr<std::function<void()>>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_forward;
+    std::atomic<bool> m_terminate = false;
+    std::atomic<int> m_pendingTasks = 0;
+};
+
+template<typename Pool>
+double MeasureThroughput(Pool& pool, uint32_t numTasks, uint32_t workPerTask)
+{
+    std::atomic<uint64_t> sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < numTasks; ++i)
+    {
+        pool.AddTask([&sink, i, workPerTask]()
+        {
+            uint64_t value = i;
+            for (uint32_t j = 0; j < workPerTask; ++j)
+                value = value * 6364136223846793005ull + 1442695040888963407ull;
+            sink.fetch_add(value, std::memory_order_relaxed);
+        });
+    }
+    pool.WaitForTasks();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return double(numTasks) / seconds;
+}
+
+void benchmark_thread_pool()
+{
+    const uint32_t numTasks = 200000;
+    const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    printf("ThreadPool throughput, %u tasks, million tasks per second:\n", numTasks);
+    for (uint32_t workPerTask : { 0u, 100u, 1000u })
+    {
+        for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+        {
+            double legacy, current;
+            {
+                LegacyThreadPool pool(numThreads);
+                legacy = MeasureThroughput(pool, numTasks, workPerTask);
+            }
+            {
+                ThreadPool pool(numThreads);
+                current = MeasureThroughput(pool, numTasks, workPerTask);
+            }
+            printf("  work %4u, %2u thread(s): legacy %.3f, current %.3f (%.2fx)\n",
+                workPerTask, numThreads, legacy * 1e-6, current * 1e-6, current / legacy);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    try
+    {
+        test_add_tasks();
+        test_nested_tasks();
+        test_task_groups();
+        test_futures();
+        test_priorities();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    if (benchmark)
+        benchmark_thread_pool();
+
+    return 0;
+}
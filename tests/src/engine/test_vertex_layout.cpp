@@ -0,0 +1,202 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include <donut/engine/SceneTypes.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <cmath>
+#include <random>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+
+// The strides used to lay out the vertex buffers must match the input layouts
+void test_vertex_layout_strides()
+{
+    const VertexAttribute attributes[] = {
+        VertexAttribute::Position, VertexAttribute::PrevPosition, VertexAttribute::TexCoord1,
+        VertexAttribute::TexCoord2, VertexAttribute::Normal, VertexAttribute::Tangent
+    };
+
+    for (VertexLayout layout : { VertexLayout::Full, VertexLayout::Compact })
+    {
+        for (VertexAttribute attribute : attributes)
+        {
+            const nvrhi::VertexAttributeDesc desc = GetVertexAttributeDesc(attribute, "", 0, layout);
+            CHECK(desc.elementStride == GetVertexAttributeStride(attribute, layout));
+        }
+    }
+
+    CHECK(GetVertexAttributeDesc(VertexAttribute::Position, "", 0, VertexLayout::Compact).format == nvrhi::Format::RGBA16_FLOAT);
+    CHECK(GetVertexAttributeDesc(VertexAttribute::TexCoord1, "", 0, VertexLayout::Compact).format == nvrhi::Format::RG16_FLOAT);
+
+    BufferGroup buffers;
+    const uint32_t fullSize = buffers.getVertexStride(VertexAttribute::Position) + buffers.getVertexStride(VertexAttribute::TexCoord1)
+        + buffers.getVertexStride(VertexAttribute::JointWeights);
+    buffers.vertexLayout = VertexLayout::Compact;
+    const uint32_t compactSize = buffers.getVertexStride(VertexAttribute::Position) + buffers.getVertexStride(VertexAttribute::TexCoord1)
+        + buffers.getVertexStride(VertexAttribute::JointWeights);
+
+    CHECK(fullSize == 12 + 8 + 16 && compactSize == 8 + 4 + 4);
+}
+
+void test_quantize_positions_and_texcoords()
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-100.f, 100.f);
+
+    std::vector<float3> positions;
+    std::vector<float2> texCoords;
+    for (int i = 0; i < 1000; i++)
+    {
+        positions.push_back(float3(dist(rng), dist(rng), dist(rng)));
+        texCoords.push_back(float2(dist(rng), dist(rng)) * 0.05f);
+    }
+
+    std::vector<float16_t4> quantizedPositions;
+    CHECK(QuantizePositions(positions.data(), positions.size(), quantizedPositions));
+    const std::vector<float16_t2> quantizedTexCoords = QuantizeTexCoords(texCoords.data(), texCoords.size());
+    CHECK(quantizedPositions.size() == positions.size());
+    CHECK(quantizedTexCoords.size() == texCoords.size());
+
+    // FP16 has an 11-bit significand, so the relative rounding error is at most 2^-11
+    const float tolerance = 1.f / 2048.f;
+
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        const float4 position = Float16ToFloat32x4(quantizedPositions[i]);
+        CHECK(position.w == 1.f);
+
+        for (int c = 0; c < 3; c++)
+        {
+            CHECK(fabsf(position[c] - positions[i][c]) <= fabsf(positions[i][c]) * tolerance);
+        }
+
+        const float2 texCoord = Float16ToFloat32x2(quantizedTexCoords[i]);
+        for (int c = 0; c < 2; c++)
+        {
+            CHECK(fabsf(texCoord[c] - texCoords[i][c]) <= fabsf(texCoords[i][c]) * tolerance);
+        }
+    }
+}
+
+void test_quantize_positions_out_of_range()
+{
+    std::vector<float16_t4> quantized;
+
+    // An empty mesh and a single point have nothing to lose
+    CHECK(QuantizePositions(nullptr, 0, quantized) && quantized.empty());
+    const float3 point(12.5f, -3.f, 0.25f);
+    CHECK(QuantizePositions(&point, 1, quantized) && quantized.size() == 1);
+
+    // Coordinates above the FP16 range would become infinity
+    std::vector<float3> large = { float3(0.f), float3(70000.f, 0.f, 0.f), float3(0.f, -1e6f, 0.f) };
+    CHECK(!QuantizePositions(large.data(), large.size(), quantized));
+
+    // A 1-unit mesh 10000 units away from the origin fits into the FP16 range, but the rounding step
+    // at that distance is 8 units, so the mesh would collapse
+    std::vector<float3> far;
+    for (int i = 0; i <= 10; i++)
+        far.push_back(float3(10000.f + float(i) * 0.1f, 5000.f, -8000.f));
+    CHECK(!QuantizePositions(far.data(), far.size(), quantized));
+
+    // The same mesh near the origin is fine
+    for (float3& position : far)
+        position -= float3(10000.f, 5000.f, -8000.f);
+    CHECK(QuantizePositions(far.data(), far.size(), quantized));
+
+    // A mesh that spans a large range is fine too, the error is small relative to its size
+    std::vector<float3> wide = { float3(-60000.f, 0.f, 0.f), float3(60000.f, 100.f, 1.f) };
+    CHECK(QuantizePositions(wide.data(), wide.size(), quantized));
+
+    // Non-finite inputs are never accepted
+    const float3 nan(NAN, 0.f, 0.f);
+    CHECK(!QuantizePositions(&nan, 1, quantized));
+}
+
+void test_quantize_joint_weights()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+
+    std::vector<float4> weights = {
+        float4(1.f, 0.f, 0.f, 0.f),
+        float4(0.f, 0.f, 0.f, 0.f),
+        float4(1.f / 3.f, 1.f / 3.f, 1.f / 3.f, 0.f),
+        float4(0.25f, 0.25f, 0.25f, 0.25f),
+        float4(0.5f, 0.5f, -0.1f, 0.f),    // negative weights are treated as zero
+    };
+    for (int i = 0; i < 1000; i++)
+    {
+        float4 w = float4(dist(rng), dist(rng), dist(rng), dist(rng));
+        if (i % 3 == 0)
+            w.w = 0.f;
+        weights.push_back(w / (w.x + w.y + w.z + w.w));
+    }
+
+    const std::vector<uint32_t> quantized = QuantizeJointWeights(weights.data(), weights.size());
+    CHECK(quantized.size() == weights.size());
+
+    CHECK(quantized[0] == 255);
+    CHECK(quantized[1] == 0);
+
+    for (size_t i = 2; i < weights.size(); i++)
+    {
+        const float4 expected = max(weights[i], float4(0.f)) / dot(max(weights[i], float4(0.f)), float4(1.f));
+
+        uint32_t sum = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            const uint32_t value = (quantized[i] >> (c * 8)) & 0xff;
+            sum += value;
+
+            // Zero weights must stay zero so that the skinning shader skips the joint
+            CHECK(expected[c] != 0.f || value == 0);
+
+            CHECK(fabsf(float(value) / 255.f - expected[c]) <= 1.f / 255.f);
+        }
+
+        CHECK(sum == 255);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+    donut::log::SetMinSeverity(donut::log::Severity::Warning);
+
+    try
+    {
+        test_vertex_layout_strides();
+        test_quantize_positions_and_texcoords();
+        test_quantize_positions_out_of_range();
+        test_quantize_joint_weights();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    return 0;
+}
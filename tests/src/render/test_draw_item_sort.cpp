@@ -0,0 +1,228 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/render/DrawItemSort.h>
+#include <donut/render/GeometryPasses.h>
+#include <donut/engine/SceneTypes.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+
+using namespace donut;
+using namespace donut::engine;
+using namespace donut::render;
+
+// Sorts the keys with RadixSortKeys and with std::stable_sort, and compares both the keys and the indices,
+// which also verifies that the radix sort is stable.
+static bool CompareWithStableSort(const std::vector<uint64_t>& input)
+{
+    std::vector<uint32_t> expectedIndices(input.size());
+    std::iota(expectedIndices.begin(), expectedIndices.end(), 0u);
+    std::stable_sort(expectedIndices.begin(), expectedIndices.end(), [&input](uint32_t a, uint32_t b) { return input[a] < input[b]; });
+
+    std::vector<uint64_t> keys = input;
+    std::vector<uint32_t> indices;
+    std::vector<uint64_t> scratchKeys;
+    std::vector<uint32_t> scratchIndices;
+    RadixSortKeys(keys, indices, scratchKeys, scratchIndices);
+
+    if (keys.size() != input.size() || indices != expectedIndices)
+        return false;
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] != input[expectedIndices[i]])
+            return false;
+    }
+
+    return true;
+}
+
+void test_radix_sort()
+{
+    std::mt19937_64 rng(42);
+
+    // Sizes below and above the insertion sort threshold
+    for (size_t count : { 0, 1, 2, 31, 32, 33, 1000, 20000 })
+    {
+        std::vector<uint64_t> keys(count);
+
+        // Random keys in all 8 digits
+        for (uint64_t& key : keys)
+            key = rng();
+        CHECK(CompareWithStableSort(keys));
+
+        // Few distinct values, to check stability
+        for (uint64_t& key : keys)
+            key = rng() % 7;
+        CHECK(CompareWithStableSort(keys));
+
+        // Only some digits vary, so that the other passes are skipped, including the first and the last ones
+        for (uint64_t& key : keys)
+            key = (rng() & 0x0000ff00ff000000ull) | 0x1200000000000034ull;
+        CHECK(CompareWithStableSort(keys));
+
+        // Only the highest digit varies
+        for (uint64_t& key : keys)
+            key = (rng() & 0xff00000000000000ull) | 0x0011223344556677ull;
+        CHECK(CompareWithStableSort(keys));
+
+        // All keys are equal, every pass is skipped
+        std::fill(keys.begin(), keys.end(), 0x0123456789abcdefull);
+        CHECK(CompareWithStableSort(keys));
+
+        // Already sorted and reversed
+        for (size_t i = 0; i < count; i++)
+            keys[i] = uint64_t(i) * 0x0101010101ull;
+        CHECK(CompareWithStableSort(keys));
+        std::reverse(keys.begin(), keys.end());
+        CHECK(CompareWithStableSort(keys));
+    }
+}
+
+static uint32_t FloatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+void test_make_key()
+{
+    Material material;
+    material.materialID = 0x12345; // truncated to 16 bits
+    BufferGroup buffers;
+    buffers.globalBufferGroupIndex = 0xabc;
+    MeshInfo mesh;
+    mesh.globalMeshIndex = 0x7777;
+    MeshGeometry geometry;
+    geometry.globalGeometryIndex = 0x5a;
+
+    DrawItem item{};
+    item.material = &material;
+    item.buffers = &buffers;
+    item.mesh = &mesh;
+    item.geometry = &geometry;
+    item.distanceToCamera = 2.5f;
+    item.cullMode = nvrhi::RasterCullMode::Back;
+
+    // Fields are packed from the most significant bits down
+    SortKeyLayout layout = SortKeyLayout()
+        .Add(SortKeyField::Material, 16)
+        .Add(SortKeyField::BufferGroup, 12)
+        .Add(SortKeyField::Mesh, 16)
+        .Add(SortKeyField::Geometry, 8)
+        .Add(SortKeyField::CullMode, 2);
+    CHECK(layout.GetNumFields() == 5);
+    CHECK(!layout.UsesDepth());
+    CHECK(layout.MakeKey(item) == ((0x2345ull << 48) | (0xabcull << 36) | (0x7777ull << 20) | (0x5aull << 12) | (1ull << 10)));
+
+    // Null pointers produce zero fields, the cull mode orders front, back, then none
+    DrawItem empty{};
+    empty.cullMode = nvrhi::RasterCullMode::None;
+    CHECK(layout.MakeKey(empty) == (2ull << 10));
+    empty.cullMode = nvrhi::RasterCullMode::Front;
+    CHECK(layout.MakeKey(empty) == 0);
+
+    // Depth fields keep the upper bits of the distance, inverted for back-to-front
+    SortKeyLayout frontToBack = SortKeyLayout().Add(SortKeyField::DepthFrontToBack, 16).Add(SortKeyField::Material, 16);
+    SortKeyLayout backToFront = SortKeyLayout().Add(SortKeyField::DepthBackToFront, 16).Add(SortKeyField::Material, 16);
+    const uint64_t depth = FloatBits(2.5f) >> 16;
+    CHECK(frontToBack.UsesDepth() && backToFront.UsesDepth());
+    CHECK(frontToBack.MakeKey(item) == ((depth << 48) | (0x2345ull << 32)));
+    CHECK(backToFront.MakeKey(item) == (((~depth & 0xffff) << 48) | (0x2345ull << 32)));
+
+    // Negative and NaN distances are clamped to zero
+    DrawItem behind = item;
+    behind.distanceToCamera = -1.f;
+    CHECK(frontToBack.MakeKey(behind) == (0x2345ull << 32));
+    behind.distanceToCamera = std::numeric_limits<float>::quiet_NaN();
+    CHECK(frontToBack.MakeKey(behind) == (0x2345ull << 32));
+
+    // Closer items get smaller front-to-back keys and larger back-to-front keys
+    DrawItem closer = item;
+    closer.distanceToCamera = 1.f;
+    CHECK(frontToBack.MakeKey(closer) < frontToBack.MakeKey(item));
+    CHECK(backToFront.MakeKey(closer) > backToFront.MakeKey(item));
+
+    // Fields that don't fit into 64 bits are ignored, depth fields are limited to 32 bits
+    SortKeyLayout full = SortKeyLayout()
+        .Add(SortKeyField::DepthFrontToBack, 40)
+        .Add(SortKeyField::Mesh, 32)
+        .Add(SortKeyField::Material, 1)
+        .Add(SortKeyField::Geometry, 0);
+    CHECK(full.GetNumFields() == 2);
+    CHECK(full.GetField(0).bits == 32);
+    CHECK(full.MakeKey(item) == ((uint64_t(FloatBits(2.5f)) << 32) | 0x7777ull));
+}
+
+void test_draw_item_sorter()
+{
+    std::mt19937 rng(7);
+    std::vector<Material> materials(5);
+    for (size_t i = 0; i < materials.size(); i++)
+        materials[i].materialID = int(i);
+
+    std::vector<DrawItem> items(100);
+    std::vector<const DrawItem*> sorted;
+    for (DrawItem& item : items)
+    {
+        item = DrawItem{};
+        item.material = &materials[rng() % materials.size()];
+        item.cullMode = nvrhi::RasterCullMode::Back;
+        sorted.push_back(&item);
+    }
+
+    DrawItemSorter sorter;
+    sorter.Sort(sorted.data(), sorted.size(), SortKeyLayout::Opaque());
+
+    // Sorted by material, and items with the same material keep their order in the array
+    std::vector<const DrawItem*> expected;
+    for (const DrawItem& item : items)
+        expected.push_back(&item);
+    std::stable_sort(expected.begin(), expected.end(), [](const DrawItem* a, const DrawItem* b) { return a->material->materialID < b->material->materialID; });
+
+    CHECK(sorted == expected);
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+
+    try
+    {
+        test_radix_sort();
+        test_make_key();
+        test_draw_item_sorter();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,509 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <donut/render/DrawStrategy.h>
+#include <donut/render/GeometryPasses.h>
+#include <donut/engine/SceneGraph.h>
+#include <donut/engine/SceneTypes.h>
+#include <donut/engine/ThreadPool.h>
+#include <donut/engine/View.h>
+#include <donut/core/log.h>
+#include <donut/tests/utils.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <tuple>
+
+using namespace donut;
+using namespace donut::math;
+using namespace donut::engine;
+using namespace donut::render;
+
+// Builds root -> groups -> nodes with mesh instances. Some meshes have an opaque and a transparent geometry,
+// which makes the strategies cull their geometries individually, and some materials are double-sided.
+// The same seed always produces the same graph.
+static std::shared_ptr<SceneGraph> BuildTestGraph(uint32_t numGroups, uint32_t nodesPerGroup, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> posDist(-100.0, 100.0);
+    std::uniform_real_distribution<float> sizeDist(0.5f, 4.f);
+
+    std::vector<std::shared_ptr<Material>> materials;
+    for (int i = 0; i < 6; ++i)
+    {
+        auto material = std::make_shared<Material>();
+        material->materialID = i;
+        material->domain = (i < 2) ? MaterialDomain::Opaque : (i < 4) ? MaterialDomain::AlphaTested : MaterialDomain::AlphaBlended;
+        material->doubleSided = (i % 2) != 0;
+        materials.push_back(material);
+    }
+
+    std::vector<std::shared_ptr<MeshInfo>> meshes;
+    for (int i = 0; i < 8; ++i)
+    {
+        auto mesh = std::make_shared<MeshInfo>();
+        int numGeometries = (i % 3 == 0) ? 2 : 1;
+        for (int j = 0; j < numGeometries; ++j)
+        {
+            auto geometry = std::make_shared<MeshGeometry>();
+            geometry->material = materials[(i + j * 3) % materials.size()];
+            float3 offset = float3(float(j) * 4.f, 0.f, 0.f);
+            float size = sizeDist(rng);
+            geometry->objectSpaceBounds = box3(offset - size, offset + size);
+            mesh->objectSpaceBounds |= geometry->objectSpaceBounds;
+            mesh->geometries.push_back(geometry);
+        }
+        meshes.push_back(mesh);
+    }
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    graph->SetRootNode(root);
+
+    for (uint32_t group = 0; group < numGroups; ++group)
+    {
+        auto groupNode = std::make_shared<SceneGraphNode>();
+        groupNode->SetTranslation(double3(posDist(rng), 0.0, posDist(rng)));
+        graph->Attach(root, groupNode);
+
+        for (uint32_t index = 0; index < nodesPerGroup; ++index)
+        {
+            auto node = std::make_shared<SceneGraphNode>();
+            node->SetTranslation(double3(posDist(rng), posDist(rng), posDist(rng)));
+            node->SetLeaf(std::make_shared<MeshInstance>(meshes[rng() % meshes.size()]));
+            graph->Attach(groupNode, node);
+        }
+    }
+
+    graph->Refresh(0);
+    return graph;
+}
+
+// A camera in the middle of the test graph, turned around the vertical axis.
+static PlanarView MakeTestView(float angle)
+{
+    PlanarView view;
+    view.SetViewport(nvrhi::Viewport(1280.f, 720.f));
+    view.SetMatrices(
+        inverse(translation(float3(0.f, 10.f, 0.f)) * rotation(float3(0.f, 1.f, 0.f), angle)),
+        perspProjD3DStyle(radians(60.f), 1280.f / 720.f, 0.1f, 150.f));
+    view.UpdateCache();
+    return view;
+}
+
+typedef std::tuple<const MeshInstance*, const MeshGeometry*, nvrhi::RasterCullMode> ItemKey;
+
+static std::vector<ItemKey> CollectItems(IDrawStrategy& strategy, const std::shared_ptr<SceneGraphNode>& rootNode, const IView& view)
+{
+    std::vector<ItemKey> items;
+    strategy.PrepareForView(rootNode, view);
+    while (const DrawItem* item = strategy.GetNextItem())
+        items.emplace_back(item->instance, item->geometry, item->cullMode);
+    return items;
+}
+
+static std::vector<ItemKey> Sorted(std::vector<ItemKey> items)
+{
+    std::sort(items.begin(), items.end());
+    return items;
+}
+
+void test_draw_list_cache_matches_walk()
+{
+    auto graph = BuildTestGraph(8, 40, 1);
+    const auto& root = graph->GetRootNode();
+    auto cache = std::make_shared<DrawListCache>();
+
+    for (float angle : { 0.f, 1.f, 2.5f, 4.f })
+    {
+        PlanarView view = MakeTestView(angle);
+
+        InstancedOpaqueDrawStrategy walked;
+        InstancedOpaqueDrawStrategy retained;
+        retained.SetDrawListCache(cache);
+
+        auto walkedItems = CollectItems(walked, root, view);
+        auto retainedItems = CollectItems(retained, root, view);
+        CHECK(!walkedItems.empty());
+        CHECK(Sorted(walkedItems) == Sorted(retainedItems));
+
+        // With a single chunk, the walk sorts all items at once and the orders match
+        walked.SetChunkSize(100000);
+        CHECK(CollectItems(walked, root, view) == retainedItems);
+
+        // Layouts with depth re-sort the retained items for each view
+        walked.SetSortKeyLayout(SortKeyLayout::OpaqueFrontToBack());
+        retained.SetSortKeyLayout(SortKeyLayout::OpaqueFrontToBack());
+        CHECK(Sorted(CollectItems(walked, root, view)) == Sorted(CollectItems(retained, root, view)));
+
+        for (bool separateDoubleSided : { false, true })
+        {
+            TransparentDrawStrategy walkedTransparent;
+            TransparentDrawStrategy retainedTransparent;
+            walkedTransparent.DrawDoubleSidedMaterialsSeparately = separateDoubleSided;
+            retainedTransparent.DrawDoubleSidedMaterialsSeparately = separateDoubleSided;
+            retainedTransparent.SetDrawListCache(cache);
+
+            auto walkedTransparentItems = CollectItems(walkedTransparent, root, view);
+            CHECK(!walkedTransparentItems.empty());
+            CHECK(Sorted(walkedTransparentItems) == Sorted(CollectItems(retainedTransparent, root, view)));
+        }
+    }
+}
+
+void test_draw_list_cache_rebuild()
+{
+    auto graph = BuildTestGraph(4, 10, 2);
+    const auto& root = graph->GetRootNode();
+    DrawListCache cache;
+
+    const auto* list = &cache.GetList(root, DrawListCache::ListType::Opaque);
+    const size_t numItems = list->items.size();
+    CHECK(numItems != 0);
+    CHECK(cache.GetStats().rebuilds == 1);
+
+    // Unchanged graph: the list is reused as is
+    CHECK(&cache.GetList(root, DrawListCache::ListType::Opaque) == list);
+    CHECK(cache.GetStats().rebuilds == 1);
+    CHECK(cache.GetStats().reuses == 1);
+    CHECK(cache.GetStats().boundsUpdates == 0);
+
+    // Moving a node only updates the instance bounds
+    SceneGraphNode* movedNode = nullptr;
+    size_t movedIndex = 0;
+    for (size_t child = 0; !movedNode && child < root->GetChild(0)->GetNumChildren(); ++child)
+    {
+        SceneGraphNode* node = root->GetChild(0)->GetChild(child);
+        auto instance = std::find(list->instanceNodes.begin(), list->instanceNodes.end(), node);
+        if (instance != list->instanceNodes.end())
+        {
+            movedNode = node;
+            movedIndex = instance - list->instanceNodes.begin();
+        }
+    }
+    CHECK(movedNode != nullptr);
+    movedNode->SetTranslation(movedNode->GetTranslation() + double3(10.0, 0.0, 0.0));
+    graph->Refresh(1);
+    list = &cache.GetList(root, DrawListCache::ListType::Opaque);
+    CHECK(cache.GetStats().rebuilds == 1);
+    CHECK(cache.GetStats().boundsUpdates == 1);
+    CHECK(list->instanceBounds.get(movedIndex) == movedNode->GetGlobalBoundingBox());
+
+    // Attaching a mesh instance rebuilds the list
+    auto newNode = std::make_shared<SceneGraphNode>();
+    newNode->SetLeaf(std::make_shared<MeshInstance>(list->items[0].instance->GetMesh()));
+    graph->Attach(root, newNode);
+    graph->Refresh(2);
+    list = &cache.GetList(root, DrawListCache::ListType::Opaque);
+    CHECK(cache.GetStats().rebuilds == 2);
+    CHECK(list->items.size() > numItems);
+
+    // So does moving a material to another domain
+    const_cast<Material*>(list->items[0].material)->domain = MaterialDomain::AlphaBlended;
+    list = &cache.GetList(root, DrawListCache::ListType::Opaque);
+    CHECK(cache.GetStats().rebuilds == 3);
+    for (const DrawItem& item : list->items)
+        CHECK(item.material->domain != MaterialDomain::AlphaBlended);
+
+    // Each root node and list type has its own list
+    auto group = root->GetChild(0)->shared_from_this();
+    cache.GetList(group, DrawListCache::ListType::Opaque);
+    cache.GetList(root, DrawListCache::ListType::Transparent);
+    CHECK(cache.GetListCount() == 3);
+    CHECK(cache.GetStats().rebuilds == 5);
+
+    // The list of a destroyed root node is dropped on the next rebuild
+    graph->Detach(group);
+    group.reset();
+    graph->Refresh(3);
+    CHECK(cache.GetListCount() == 3);
+    cache.GetList(root, DrawListCache::ListType::Opaque);
+    CHECK(cache.GetListCount() == 2);
+    CHECK(cache.GetStats().rebuilds == 6);
+}
+
+// Prepares the views all at once and one by one, and compares the items of each view. The single view
+// reference uses one chunk, which makes it sort all items at once like the multi-view path.
+static bool CompareMultiView(const std::shared_ptr<SceneGraphNode>& rootNode, const std::vector<PlanarView>& views,
+    const std::shared_ptr<DrawListCache>& cache, const SortKeyLayout& layout)
+{
+    InstancedOpaqueDrawStrategy multiView;
+    multiView.SetDrawListCache(cache);
+    multiView.SetSortKeyLayout(layout);
+
+    std::vector<const IView*> viewPtrs;
+    for (const PlanarView& view : views)
+        viewPtrs.push_back(&view);
+    if (!multiView.PrepareForViews(rootNode, viewPtrs.data(), uint32_t(viewPtrs.size())))
+        return false;
+
+    InstancedOpaqueDrawStrategy singleView;
+    singleView.SetDrawListCache(cache);
+    singleView.SetSortKeyLayout(layout);
+    singleView.SetChunkSize(100000);
+
+    // Select the views in reverse order to check that SelectView restarts the list
+    for (uint32_t viewIndex = uint32_t(views.size()); viewIndex-- > 0; )
+    {
+        multiView.SelectView(viewIndex);
+        std::vector<ItemKey> multiViewItems;
+        while (const DrawItem* item = multiView.GetNextItem())
+            multiViewItems.emplace_back(item->instance, item->geometry, item->cullMode);
+
+        auto singleViewItems = CollectItems(singleView, rootNode, views[viewIndex]);
+
+        // Items with equal depth keys may be in any order
+        bool sameItems = layout.UsesDepth()
+            ? Sorted(multiViewItems) == Sorted(singleViewItems)
+            : multiViewItems == singleViewItems;
+        if (!sameItems)
+            return false;
+    }
+
+    return true;
+}
+
+void test_multi_view_matches_single_view()
+{
+    auto graph = BuildTestGraph(8, 40, 3);
+    const auto& root = graph->GetRootNode();
+
+    std::vector<PlanarView> views;
+    for (int i = 0; i < 6; ++i)
+        views.push_back(MakeTestView(float(i)));
+
+    for (bool retained : { false, true })
+    {
+        auto cache = retained ? std::make_shared<DrawListCache>() : nullptr;
+        CHECK(CompareMultiView(root, views, cache, SortKeyLayout::Opaque()));
+        CHECK(CompareMultiView(root, views, cache, SortKeyLayout::OpaqueFrontToBack()));
+    }
+
+    InstancedOpaqueDrawStrategy strategy;
+    CHECK(!strategy.PrepareForViews(root, nullptr, 0));
+}
+
+// Groups in front of and behind the camera, and a group around it whose children are visible in
+// different views, so the culling mask of a parent differs from the masks of its children.
+void test_multi_view_parent_masks()
+{
+    auto material = std::make_shared<Material>();
+    auto mesh = std::make_shared<MeshInfo>();
+    auto geometry = std::make_shared<MeshGeometry>();
+    geometry->material = material;
+    geometry->objectSpaceBounds = box3(float3(-1.f), float3(1.f));
+    mesh->objectSpaceBounds = geometry->objectSpaceBounds;
+    mesh->geometries.push_back(geometry);
+
+    auto graph = std::make_shared<SceneGraph>();
+    auto root = std::make_shared<SceneGraphNode>();
+    graph->SetRootNode(root);
+
+    std::vector<std::shared_ptr<MeshInstance>> instances;
+    auto addGroup = [&](double3 groupPosition, std::initializer_list<double> childDepths)
+    {
+        auto group = std::make_shared<SceneGraphNode>();
+        group->SetTranslation(groupPosition);
+        graph->Attach(root, group);
+        for (double depth : childDepths)
+        {
+            auto node = std::make_shared<SceneGraphNode>();
+            node->SetTranslation(double3(0.0, 10.0, depth));
+            instances.push_back(std::make_shared<MeshInstance>(mesh));
+            node->SetLeaf(instances.back());
+            graph->Attach(group, node);
+        }
+    };
+
+    addGroup(double3(0.0, 0.0, 50.0), { -5.0, 0.0, 5.0 });    // instances 0-2
+    addGroup(double3(0.0, 0.0, -50.0), { -5.0, 0.0, 5.0 });   // instances 3-5
+    addGroup(double3(0.0), { 60.0, -60.0 });                  // instances 6 and 7
+    graph->Refresh(0);
+
+    std::vector<PlanarView> views = { MakeTestView(0.f), MakeTestView(PI_f) };
+    const IView* viewPtrs[] = { &views[0], &views[1] };
+
+    InstancedOpaqueDrawStrategy strategy;
+    CHECK(strategy.PrepareForViews(root, viewPtrs, 2));
+
+    std::vector<uint32_t> visibleMasks(instances.size(), 0);
+    for (uint32_t viewIndex = 0; viewIndex < 2; viewIndex++)
+    {
+        strategy.SelectView(viewIndex);
+        while (const DrawItem* item = strategy.GetNextItem())
+        {
+            for (size_t i = 0; i < instances.size(); i++)
+            {
+                if (item->instance == instances[i].get())
+                    visibleMasks[i] |= 1u << viewIndex;
+            }
+        }
+    }
+
+    // Each instance is seen by exactly one view, the front group and the first child of the last group by the same one
+    for (size_t i = 0; i < instances.size(); i++)
+        CHECK(visibleMasks[i] == 1 || visibleMasks[i] == 2);
+    CHECK(visibleMasks[0] == visibleMasks[1] && visibleMasks[1] == visibleMasks[2] && visibleMasks[2] == visibleMasks[6]);
+    CHECK(visibleMasks[3] == visibleMasks[4] && visibleMasks[4] == visibleMasks[5] && visibleMasks[5] == visibleMasks[7]);
+    CHECK(visibleMasks[0] != visibleMasks[3]);
+
+    CHECK(CompareMultiView(root, views, nullptr, SortKeyLayout::Opaque()));
+}
+
+// Identifies an item by the index of its instance in the graph and of its geometry in the mesh.
+// Includes the depth, which the parallel jobs compute independently.
+typedef std::tuple<int, uint32_t, nvrhi::RasterCullMode, float> StableItemKey;
+
+static std::vector<StableItemKey> CollectStableItems(IDrawStrategy& strategy, const std::shared_ptr<SceneGraphNode>& rootNode, const IView& view)
+{
+    std::vector<StableItemKey> items;
+    strategy.PrepareForView(rootNode, view);
+    while (const DrawItem* item = strategy.GetNextItem())
+    {
+        uint32_t geometryIndex = 0;
+        while (item->mesh->geometries[geometryIndex].get() != item->geometry)
+            ++geometryIndex;
+        items.emplace_back(item->instance->GetInstanceIndex(), geometryIndex, item->cullMode, item->distanceToCamera);
+    }
+    return items;
+}
+
+// The items of all strategies for a few views, in the order they are returned.
+static std::vector<std::vector<StableItemKey>> CollectAllItems(const std::shared_ptr<SceneGraph>& graph, ThreadPool* threadPool,
+    uint32_t instancesPerJob)
+{
+    const auto& root = graph->GetRootNode();
+    std::vector<std::vector<StableItemKey>> results;
+
+    for (float angle : { 0.f, 2.f, 4.f })
+    {
+        PlanarView view = MakeTestView(angle);
+
+        for (const SortKeyLayout& layout : { SortKeyLayout::Opaque(), SortKeyLayout::OpaqueFrontToBack() })
+        {
+            ParallelOpaqueDrawStrategy parallel(threadPool);
+            parallel.InstancesPerJob = instancesPerJob;
+            parallel.SetSortKeyLayout(layout);
+            results.push_back(CollectStableItems(parallel, root, view));
+
+            BVHOpaqueDrawStrategy bvh;
+            bvh.SetSortKeyLayout(layout);
+            results.push_back(CollectStableItems(bvh, root, view));
+        }
+
+        for (bool separateDoubleSided : { false, true })
+        {
+            ParallelTransparentDrawStrategy parallel(threadPool);
+            parallel.InstancesPerJob = instancesPerJob;
+            parallel.DrawDoubleSidedMaterialsSeparately = separateDoubleSided;
+            results.push_back(CollectStableItems(parallel, root, view));
+
+            BVHTransparentDrawStrategy bvh;
+            bvh.DrawDoubleSidedMaterialsSeparately = separateDoubleSided;
+            results.push_back(CollectStableItems(bvh, root, view));
+        }
+    }
+
+    return results;
+}
+
+static bool SameItems(std::vector<StableItemKey> a, std::vector<StableItemKey> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+void test_parallel_strategies_deterministic()
+{
+    auto graph = BuildTestGraph(8, 200, 4);
+    graph->SetInstanceBVHEnabled(true);
+    graph->Refresh(1);
+
+    // Make sure that the BVH strategies don't use their fallback
+    BVHOpaqueDrawStrategy bvh;
+    CollectItems(bvh, graph->GetRootNode(), MakeTestView(0.f));
+    CHECK(bvh.GetQueryStats().nodesVisited != 0);
+
+    // Serial reference: no thread pool
+    auto serialResults = CollectAllItems(graph, nullptr, 256);
+    CHECK(!serialResults.empty());
+
+    // The parallel and BVH strategies return the same items as the walk, each pair of results is for one view
+    const auto& root = graph->GetRootNode();
+    size_t resultIndex = 0;
+    for (float angle : { 0.f, 2.f, 4.f })
+    {
+        PlanarView view = MakeTestView(angle);
+
+        for (const SortKeyLayout& layout : { SortKeyLayout::Opaque(), SortKeyLayout::OpaqueFrontToBack() })
+        {
+            InstancedOpaqueDrawStrategy walked;
+            walked.SetSortKeyLayout(layout);
+            auto walkedItems = CollectStableItems(walked, root, view);
+            CHECK(!walkedItems.empty());
+            CHECK(SameItems(serialResults[resultIndex++], walkedItems));
+            CHECK(SameItems(serialResults[resultIndex++], walkedItems));
+        }
+
+        for (bool separateDoubleSided : { false, true })
+        {
+            TransparentDrawStrategy walked;
+            walked.DrawDoubleSidedMaterialsSeparately = separateDoubleSided;
+            auto walkedItems = CollectStableItems(walked, root, view);
+            CHECK(!walkedItems.empty());
+            CHECK(SameItems(serialResults[resultIndex++], walkedItems));
+            CHECK(SameItems(serialResults[resultIndex++], walkedItems));
+        }
+    }
+
+    // The output doesn't depend on the number of threads or the job size, including the order of the items
+    // with equal sort keys. The keys contain pointers, so this has to use the same graph.
+    for (uint32_t numThreads : { 1u, 2u, 4u, 8u })
+    {
+        ThreadPool threadPool(numThreads);
+        for (uint32_t instancesPerJob : { 1u, 7u, 256u })
+        {
+            CHECK(CollectAllItems(graph, &threadPool, instancesPerJob) == serialResults);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    donut::log::ConsoleApplicationMode();
+
+    try
+    {
+        test_draw_list_cache_matches_walk();
+        test_draw_list_cache_rebuild();
+        test_multi_view_matches_single_view();
+        test_multi_view_parent_masks();
+        test_parallel_strategies_deterministic();
+    }
+    catch (const std::runtime_error& err)
+    {
+        fprintf(stderr, "%s", err.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -38,3 +38,27 @@ foreach(test_src ${donut_engine_tests})
 
 endforeach()
 
+
+# Compile the shaders that load or store vertex data with both vertex layouts, when DXC is available.
+# The skinning shader selects the layout at runtime, the vertex shaders have a COMPACT_VERTICES permutation.
+# The regular shader build only covers the graphics APIs that are enabled, these tests cover the D3D12 path
+# independently of that.
+if (SHADERMAKE_DXC_PATH AND EXISTS "${SHADERMAKE_DXC_PATH}")
+
+    set(shader_include_dir "${CMAKE_CURRENT_SOURCE_DIR}/../include")
+    set(shader_source_dir "${CMAKE_CURRENT_SOURCE_DIR}/../shaders")
+
+    add_test(NAME "shader_skinning_cs" COMMAND "${SHADERMAKE_DXC_PATH}"
+        -T cs_6_5 -E main -D TARGET_D3D12 -I "${shader_include_dir}" "${shader_source_dir}/skinning_cs.hlsl")
+
+    foreach(shader depth_vs forward_vs gbuffer_vs)
+        foreach(entry input_assembler buffer_loads)
+            foreach(compact 0 1)
+                add_test(NAME "shader_${shader}_${entry}_compact${compact}" COMMAND "${SHADERMAKE_DXC_PATH}"
+                    -T vs_6_5 -E ${entry} -D TARGET_D3D12 -D COMPACT_VERTICES=${compact} -D MOTION_VECTORS=1
+                    -I "${shader_include_dir}" "${shader_source_dir}/passes/${shader}.hlsl")
+            endforeach()
+        endforeach()
+    endforeach()
+
+endif()
@@ -0,0 +1,260 @@
+/*
+* Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+donut_pack: creates a package for MediaFileSystem from a folder.
+
+The package is a regular ustar archive that contains all files in the folder and its subfolders, with paths
+relative to the folder. Each file is compressed with vfs::compression::compressFile unless that doesn't make
+it smaller, in which case it's stored as-is. Packages with the .pkz extension are mounted through
+a vfs::CompressionLayer, which decompresses the entries when they are read.
+
+Usage: donut_pack [options] <input folder> <output file>
+  --block-size <KB>    size of the independently compressed blocks, default 256
+  --store <ext>        store files with this extension uncompressed, can be repeated (ex. --store .png)
+  --threads <N>        number of compression threads, default is one per hardware core
+*/
+
+#include <donut/core/log.h>
+#include <donut/core/vfs/Compression.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace donut;
+namespace fs = std::filesystem;
+
+struct PackOptions
+{
+    fs::path inputPath;
+    fs::path outputPath;
+    uint32_t blockSize = vfs::compression::DefaultBlockSize;
+    uint32_t maxThreads = 0;
+    std::vector<std::string> storedExtensions;
+};
+
+static void printUsage()
+{
+    printf("Usage: donut_pack [--block-size <KB>] [--store <ext>]... [--threads <N>] <input folder> <output file>\n");
+}
+
+static bool parseCommandLine(int argc, char** argv, PackOptions& options)
+{
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--block-size" && hasValue)
+            options.blockSize = uint32_t(std::stoul(argv[++i])) * 1024;
+        else if (arg == "--store" && hasValue)
+            options.storedExtensions.push_back(argv[++i]);
+        else if (arg == "--threads" && hasValue)
+            options.maxThreads = uint32_t(std::stoul(argv[++i]));
+        else if (arg.size() > 1 && arg[0] == '-')
+        {
+            log::error("Unknown or incomplete option '%s'", arg.c_str());
+            return false;
+        }
+        else
+            positional.push_back(arg);
+    }
+
+    if (positional.size() != 2)
+        return false;
+
+    if (options.blockSize == 0 || options.blockSize > vfs::compression::MaxBlockSize)
+    {
+        log::error("Block size must be between 1 and %u KB", vfs::compression::MaxBlockSize / 1024);
+        return false;
+    }
+
+    options.inputPath = positional[0];
+    options.outputPath = positional[1];
+    return true;
+}
+
+// Fills in a ustar header for a regular file. Returns false if the name doesn't fit.
+static bool makeTarHeader(const std::string& name, uint64_t size, uint8_t header[512])
+{
+    memset(header, 0, 512);
+
+    // names longer than 100 characters are split into prefix and name at a '/'
+    std::string prefix;
+    std::string shortName = name;
+    if (name.size() > 100)
+    {
+        size_t split = name.rfind('/', 155);
+        if (split == std::string::npos || name.size() - split - 1 > 100)
+            return false;
+        prefix = name.substr(0, split);
+        shortName = name.substr(split + 1);
+    }
+
+    memcpy(header, shortName.data(), shortName.size());
+    memcpy(header + 345, prefix.data(), prefix.size());
+    snprintf(reinterpret_cast<char*>(header + 100), 8, "%07o", 0644);
+    snprintf(reinterpret_cast<char*>(header + 108), 8, "%07o", 0);
+    snprintf(reinterpret_cast<char*>(header + 116), 8, "%07o", 0);
+    snprintf(reinterpret_cast<char*>(header + 124), 12, "%011llo", (unsigned long long)size);
+    snprintf(reinterpret_cast<char*>(header + 136), 12, "%011o", 0);
+    header[156] = '0';
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+
+    // the checksum is computed with the checksum field filled with spaces
+    memset(header + 148, ' ', 8);
+    uint32_t checksum = 0;
+    for (int i = 0; i < 512; ++i)
+        checksum += header[i];
+    snprintf(reinterpret_cast<char*>(header + 148), 8, "%06o", checksum);
+
+    return true;
+}
+
+static bool readNativeFile(const fs::path& path, std::vector<uint8_t>& data)
+{
+    FILE* file = fopen(path.string().c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::error_code error;
+    data.resize(size_t(fs::file_size(path, error)));
+    bool success = !error && fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+
+    return success;
+}
+
+int main(int argc, char** argv)
+{
+    log::ConsoleApplicationMode();
+
+    PackOptions options;
+    if (!parseCommandLine(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (const auto& entry : fs::recursive_directory_iterator(options.inputPath, error))
+    {
+        if (entry.is_regular_file())
+            files.push_back(entry.path());
+    }
+
+    if (error)
+    {
+        log::error("Cannot enumerate files in '%s': %s", options.inputPath.string().c_str(), error.message().c_str());
+        return 1;
+    }
+
+    // sort the files to make the package contents deterministic
+    std::sort(files.begin(), files.end());
+
+    FILE* output = fopen(options.outputPath.string().c_str(), "wb");
+    if (!output)
+    {
+        log::error("Cannot open '%s' for writing", options.outputPath.string().c_str());
+        return 1;
+    }
+
+    const uint8_t padding[512] = {};
+    uint64_t totalInputSize = 0;
+    uint64_t totalOutputSize = 0;
+    bool success = true;
+
+    for (const fs::path& filePath : files)
+    {
+        std::string name = filePath.lexically_relative(options.inputPath).generic_string();
+
+        std::vector<uint8_t> data;
+        if (!readNativeFile(filePath, data))
+        {
+            log::error("Cannot read '%s'", filePath.string().c_str());
+            success = false;
+            break;
+        }
+
+        std::string extension = filePath.extension().string();
+        bool store = std::find(options.storedExtensions.begin(), options.storedExtensions.end(), extension) != options.storedExtensions.end();
+
+        // files that happen to look like compressed files must be wrapped, or CompressionLayer would misinterpret them
+        std::vector<uint8_t> compressed;
+        if (!store || vfs::compression::isCompressedFile(data.data(), data.size()))
+        {
+            compressed = vfs::compression::compressFile(data.data(), data.size(), options.blockSize, options.maxThreads);
+            if (compressed.size() >= data.size() && !vfs::compression::isCompressedFile(data.data(), data.size()))
+                compressed.clear();
+        }
+
+        const std::vector<uint8_t>& entryData = compressed.empty() ? data : compressed;
+
+        uint8_t header[512];
+        if (!makeTarHeader(name, entryData.size(), header))
+        {
+            log::error("File name '%s' is too long for a tar archive", name.c_str());
+            success = false;
+            break;
+        }
+
+        size_t paddingSize = (512 - entryData.size() % 512) % 512;
+        if (fwrite(header, sizeof(header), 1, output) != 1 ||
+            fwrite(entryData.data(), 1, entryData.size(), output) != entryData.size() ||
+            fwrite(padding, 1, paddingSize, output) != paddingSize)
+        {
+            log::error("Error writing to '%s'", options.outputPath.string().c_str());
+            success = false;
+            break;
+        }
+
+        totalInputSize += data.size();
+        totalOutputSize += entryData.size();
+    }
+
+    // the archive ends with two empty records
+    if (success && (fwrite(padding, sizeof(padding), 1, output) != 1 || fwrite(padding, sizeof(padding), 1, output) != 1))
+    {
+        log::error("Error writing to '%s'", options.outputPath.string().c_str());
+        success = false;
+    }
+
+    fclose(output);
+
+    if (!success)
+    {
+        fs::remove(options.outputPath, error);
+        return 1;
+    }
+
+    log::info("Packed %d files into '%s': %llu bytes -> %llu bytes", int(files.size()), options.outputPath.string().c_str(),
+        (unsigned long long)totalInputSize, (unsigned long long)totalOutputSize);
+
+    return 0;
+}